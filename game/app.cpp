@@ -5,6 +5,8 @@
 #include <render/renderer.h>
 #include <loader/loader.h>
 #include <render/Vertex.h>
+#include <render/mesh_file.h>
+#include <render/packed_vertex.h>
 
 #include <utils/LogPrint.h>
 
@@ -12,6 +14,7 @@
 #include <external/rapidjson/document.h>
 
 #include <assert.h>
+#include <float.h>
 
 struct StaticMeshModelUniform
 {
@@ -68,6 +71,23 @@ void CApp::init(CreateInfo& createInfo)
     maAnimMeshModelMatrices.resize(128);
     maStaticMeshModelMatrices.resize(128);
 
+    // the ball, the bat and the trailing balls move every frame, the light views draw them over the cached static layers
+    std::vector<uint32_t> aiDynamicMeshes =
+    {
+        maMeshModelInfo[maMeshModelInfoDB["ball"]].miStaticIndex,
+        maMeshModelInfo[maMeshModelInfoDB["bat"]].miStaticIndex,
+    };
+    for(uint32_t i = 6; i < 128; i++)
+    {
+        aiDynamicMeshes.push_back(i);
+    }
+    mCreateInfo.mpRenderer->setDynamicMeshes(aiDynamicMeshes);
+    mabDynamicMeshes.assign(128, 0);
+    for(uint32_t iMesh : aiDynamicMeshes)
+    {
+        mabDynamicMeshes[iMesh] = 1;
+    }
+
     mPitchSimulator.reset();
 
     mGameState = GAME_STATE_PITCH_WINDUP;
@@ -100,7 +120,7 @@ void CApp::init(CreateInfo& createInfo)
     bufferDesc.size = 1024;
     bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
     maBuffers["lightingUniformBuffer"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
-    mCreateInfo.mpRenderer->registerBuffer(
+    miLightingUniformBuffer = mCreateInfo.mpRenderer->registerBuffer(
         "lightingUniformBuffer",
         maBuffers["lightingUniformBuffer"]
     );
@@ -235,6 +255,110 @@ void CApp::getAnimVertexRanges(std::vector<std::pair<uint32_t, uint32_t>>& aVert
 }
 
 
+/*
+** for mesh files written before the converter packed vertices, the mesh index is in position.w
+*/
+static void packMeshVertices(
+    std::vector<Render::PackedVertex>& aPackedVertices,
+    std::vector<Render::VertexDequantization>& aDequantization,
+    Vertex const* aVertices,
+    uint32_t iNumVertices,
+    uint32_t iNumMeshes)
+{
+    std::vector<float3> aMinPositions(iNumMeshes, float3(FLT_MAX, FLT_MAX, FLT_MAX));
+    std::vector<float3> aMaxPositions(iNumMeshes, float3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        uint32_t iMesh = (uint32_t)aVertices[iVertex].mPosition.w;
+        assert(iMesh < iNumMeshes);
+        aMinPositions[iMesh] = fminf(aMinPositions[iMesh], float3(aVertices[iVertex].mPosition));
+        aMaxPositions[iMesh] = fmaxf(aMaxPositions[iMesh], float3(aVertices[iVertex].mPosition));
+    }
+
+    aDequantization.resize(iNumMeshes);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        if(aMinPositions[iMesh].x > aMaxPositions[iMesh].x)
+        {
+            aMinPositions[iMesh] = aMaxPositions[iMesh] = float3(0.0f, 0.0f, 0.0f);
+        }
+        Render::computeVertexDequantization(aDequantization[iMesh], &aMinPositions[iMesh].x, &aMaxPositions[iMesh].x);
+    }
+
+    aPackedVertices.resize(iNumVertices);
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        Vertex const& vertex = aVertices[iVertex];
+        uint32_t iMesh = (uint32_t)vertex.mPosition.w;
+        float3 normal = normalize(float3(vertex.mNormal));
+        Render::packVertex(aPackedVertices[iVertex], &vertex.mPosition.x, &vertex.mUV.x, &normal.x, iMesh, aDequantization[iMesh]);
+    }
+}
+
+/*
+** for mesh files written before the converter built meshlets, one meshlet per mesh around its extent without
+** a normal cone, cluster culling is whole mesh culling then
+*/
+void CApp::buildMeshMeshlets(
+    std::vector<Render::Meshlet>& aMeshlets,
+    std::vector<MeshTriangleRange>& aMeshletRanges,
+    MeshTriangleRange const* aTriangleRanges,
+    MeshExtent const* aMeshExtents,
+    uint32_t iNumMeshes)
+{
+    aMeshlets.clear();
+    aMeshletRanges.resize(iNumMeshes);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        aMeshletRanges[iMesh].miStart = (uint32_t)aMeshlets.size();
+
+        uint32_t iNumIndices = aTriangleRanges[iMesh].miEnd - aTriangleRanges[iMesh].miStart;
+        if(iNumIndices > 0)
+        {
+            float3 minPosition = float3(aMeshExtents[iMesh].mMinPosition);
+            float3 maxPosition = float3(aMeshExtents[iMesh].mMaxPosition);
+            float3 center = (minPosition + maxPosition) * 0.5f;
+
+            Render::Meshlet meshlet = {};
+            meshlet.mafSphere[0] = center.x;
+            meshlet.mafSphere[1] = center.y;
+            meshlet.mafSphere[2] = center.z;
+            meshlet.mafSphere[3] = length(maxPosition - center);
+            meshlet.mafConeAxis[3] = 1.0f;
+            meshlet.miMesh = iMesh;
+            meshlet.miIndexStart = aTriangleRanges[iMesh].miStart;
+            meshlet.miNumTriangles = iNumIndices / 3;
+            aMeshlets.push_back(meshlet);
+        }
+
+        aMeshletRanges[iMesh].miEnd = (uint32_t)aMeshlets.size();
+    }
+}
+
+/*
+** for mesh files without levels of detail, every level is the full mesh
+*/
+void CApp::buildMeshLods(
+    std::vector<Render::MeshLod>& aMeshLods,
+    MeshTriangleRange const* aTriangleRanges,
+    MeshTriangleRange const* aMeshletRanges,
+    uint32_t iNumMeshes)
+{
+    aMeshLods.resize(iNumMeshes * MESH_MAX_LODS);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        Render::MeshLod lod = {};
+        lod.miIndexStart = aTriangleRanges[iMesh].miStart;
+        lod.miNumIndices = aTriangleRanges[iMesh].miEnd - aTriangleRanges[iMesh].miStart;
+        lod.miMeshletStart = aMeshletRanges[iMesh].miStart;
+        lod.miMeshletEnd = aMeshletRanges[iMesh].miEnd;
+        for(uint32_t iLod = 0; iLod < MESH_MAX_LODS; iLod++)
+        {
+            aMeshLods[iMesh * MESH_MAX_LODS + iLod] = lod;
+        }
+    }
+}
+
 /*
 **
 */
@@ -248,44 +372,90 @@ void CApp::loadMeshes(
     char* acTriangleBuffer = nullptr;
     uint64_t iSize = Loader::loadFile(&acTriangleBuffer, meshModelName + "-triangles.bin");
     DEBUG_PRINTF("acTriangleBuffer = 0x%llX size: %lld\n", (uint64_t)acTriangleBuffer, iSize);
-    uint32_t const* piData = (uint32_t const*)acTriangleBuffer;
 
     maStaticMeshModelNames.push_back(meshModelName);
 
-    uint32_t iNumMeshes = *piData++;
-    uint32_t iNumTotalVertices = *piData++;
-    uint32_t iNumTotalTriangles = *piData++;
-    uint32_t iVertexSize = *piData++;
-    uint32_t iTriangleStartOffset = *piData++;
+    // chunked container, or the headerless layout from older converters
+    MeshFileSections sections;
+    bool bParsed = false;
+    if(iSize >= sizeof(uint32_t) && *((uint32_t const*)acTriangleBuffer) == MESH_FILE_SIGNATURE)
+    {
+        bParsed = parseChunkedMeshFile(sections, acTriangleBuffer, iSize);
+    }
+    else
+    {
+        bParsed = parseLegacyMeshFile(sections, acTriangleBuffer, iSize);
+    }
+    if(!bParsed)
+    {
+        DEBUG_PRINTF("!!! invalid mesh file \"%s\" !!!\n", (meshModelName + "-triangles.bin").c_str());
+        assert(0);
+        Loader::loadFileFree(acTriangleBuffer);
+        return;
+    }
+
+    uint32_t iNumMeshes = sections.miNumMeshes;
+    uint32_t iNumTotalVertices = sections.miNumVertices;
+    assert(iNumMeshes <= PACKED_VERTEX_MAX_MESHES);
+
+    // float vertices from older files are packed here
+    std::vector<Render::PackedVertex> aPackedVertices;
+    std::vector<Render::VertexDequantization> aDequantization;
+    if(sections.mpPackedVertices == nullptr)
+    {
+        packMeshVertices(
+            aPackedVertices,
+            aDequantization,
+            (Vertex const*)sections.mpVertices,
+            iNumTotalVertices,
+            iNumMeshes);
+        sections.mpPackedVertices = aPackedVertices.data();
+        sections.mpDequantization = aDequantization.data();
+    }
+
+    std::vector<Render::Meshlet> aMeshlets;
+    std::vector<MeshTriangleRange> aMeshletRanges;
+    if(sections.mpMeshlets == nullptr)
+    {
+        buildMeshMeshlets(
+            aMeshlets,
+            aMeshletRanges,
+            (MeshTriangleRange const*)sections.mpTriangleRanges,
+            (MeshExtent const*)sections.mpExtents,
+            iNumMeshes);
+    }
+    else
+    {
+        aMeshlets.assign((Render::Meshlet const*)sections.mpMeshlets, (Render::Meshlet const*)sections.mpMeshlets + sections.miNumMeshlets);
+        aMeshletRanges.assign((MeshTriangleRange const*)sections.mpMeshletRanges, (MeshTriangleRange const*)sections.mpMeshletRanges + iNumMeshes);
+    }
+
+    std::vector<Render::MeshLod> aMeshLods;
+    if(sections.mpLods == nullptr)
+    {
+        buildMeshLods(
+            aMeshLods,
+            (MeshTriangleRange const*)sections.mpTriangleRanges,
+            aMeshletRanges.data(),
+            iNumMeshes);
+    }
+    else
+    {
+        aMeshLods.assign((Render::MeshLod const*)sections.mpLods, (Render::MeshLod const*)sections.mpLods + iNumMeshes * MESH_MAX_LODS);
+    }
 
     DEBUG_PRINTF("num meshes: %d\n", iNumMeshes);
     DEBUG_PRINTF("num total vertices: %d\n", iNumTotalVertices);
 
     // triangle ranges for all the meshes
     maMeshTriangleRanges.resize(iNumMeshes);
-    memcpy(maMeshTriangleRanges.data(), piData, sizeof(MeshTriangleRange) * iNumMeshes);
-    piData += (2 * iNumMeshes);
+    memcpy(maMeshTriangleRanges.data(), sections.mpTriangleRanges, sizeof(MeshTriangleRange) * iNumMeshes);
 
     // the total mesh extent is at the very end of the list
-    MeshExtent const* pMeshExtent = (MeshExtent const*)piData;
     maMeshExtents.resize(iNumMeshes + 1);
-    memcpy(maMeshExtents.data(), pMeshExtent, sizeof(MeshExtent) * (iNumMeshes + 1));
-    pMeshExtent += (iNumMeshes + 1);
+    memcpy(maMeshExtents.data(), sections.mpExtents, sizeof(MeshExtent) * (iNumMeshes + 1));
     mTotalMeshExtent = maMeshExtents.back();
 
-    // all the mesh vertices
-    std::vector<Vertex> aTotalMeshVertices(iNumTotalVertices);
-    Vertex const* pVertices = (Vertex const*)pMeshExtent;
-    memcpy(aTotalMeshVertices.data(), pVertices, iNumTotalVertices * sizeof(Vertex));
-    pVertices += iNumTotalVertices;
-
-    // all the triangle indices
-    std::vector<uint32_t> aiTotalMeshTriangleIndices(iNumTotalTriangles * 3);
-    piData = (uint32_t const*)pVertices;
-    memcpy(aiTotalMeshTriangleIndices.data(), piData, iNumTotalTriangles * 3 * sizeof(uint32_t));
-
-    Loader::loadFileFree(acTriangleBuffer);
-
     wgpu::BufferDescriptor bufferDesc = {};
 
     std::string vertexBufferName = meshModelName + "-vertex-buffer";
@@ -297,13 +467,13 @@ void CApp::loadMeshes(
         maIndexBufferNames.push_back(indexBufferName);
     }
 
-    bufferDesc.size = iNumTotalVertices * sizeof(Vertex);
+    bufferDesc.size = iNumTotalVertices * sizeof(Render::PackedVertex);
     bufferDesc.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
     maBuffers[vertexBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[vertexBufferName].SetLabel(vertexBufferName.c_str());
     maBufferSizes[vertexBufferName] = (uint32_t)bufferDesc.size;
 
-    bufferDesc.size = aiTotalMeshTriangleIndices.size() * sizeof(uint32_t);
+    bufferDesc.size = sections.miNumTriangleIndices * sizeof(uint32_t);
     bufferDesc.usage = wgpu::BufferUsage::Index | wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
     maBuffers[indexBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[indexBufferName].SetLabel(indexBufferName.c_str());
@@ -321,10 +491,34 @@ void CApp::loadMeshes(
     maBuffers["meshExtents"].SetLabel("Train Mesh Extents");
     maBufferSizes["meshExtents"] = (uint32_t)bufferDesc.size;
 
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers[vertexBufferName], 0, aTotalMeshVertices.data(), iNumTotalVertices * sizeof(Vertex));
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers[indexBufferName], 0, aiTotalMeshTriangleIndices.data(), aiTotalMeshTriangleIndices.size() * sizeof(uint32_t));
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshTriangleIndexRanges"], 0, maMeshTriangleRanges.data(), maMeshTriangleRanges.size() * sizeof(MeshTriangleRange));
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshExtents"], 0, maMeshExtents.data(), maMeshExtents.size() * sizeof(MeshExtent));
+    bufferDesc.size = iNumMeshes * sizeof(Render::VertexDequantization);
+    bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    maBuffers["meshVertexDequantization"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
+    maBuffers["meshVertexDequantization"].SetLabel("Mesh Vertex Dequantization");
+    maBufferSizes["meshVertexDequantization"] = (uint32_t)bufferDesc.size;
+
+    bufferDesc.size = (aMeshlets.size() > 0 ? aMeshlets.size() : 1) * sizeof(Render::Meshlet);
+    bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    maBuffers["meshlets"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
+    maBuffers["meshlets"].SetLabel("Meshlets");
+    maBufferSizes["meshlets"] = (uint32_t)bufferDesc.size;
+
+    bufferDesc.size = iNumMeshes * MESH_MAX_LODS * sizeof(Render::MeshLod);
+    bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    maBuffers["meshLods"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
+    maBuffers["meshLods"].SetLabel("Mesh Levels Of Detail");
+    maBufferSizes["meshLods"] = (uint32_t)bufferDesc.size;
+
+    // sections go to the queue straight out of the loaded file
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers[vertexBufferName], 0, sections.mpPackedVertices, iNumTotalVertices * sizeof(Render::PackedVertex));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers[indexBufferName], 0, sections.mpTriangleIndices, sections.miNumTriangleIndices * sizeof(uint32_t));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshTriangleIndexRanges"], 0, sections.mpTriangleRanges, iNumMeshes * sizeof(MeshTriangleRange));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshExtents"], 0, sections.mpExtents, (iNumMeshes + 1) * sizeof(MeshExtent));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshVertexDequantization"], 0, sections.mpDequantization, iNumMeshes * sizeof(Render::VertexDequantization));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshlets"], 0, aMeshlets.data(), aMeshlets.size() * sizeof(Render::Meshlet));
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(maBuffers["meshLods"], 0, aMeshLods.data(), aMeshLods.size() * sizeof(Render::MeshLod));
+
+    Loader::loadFileFree(acTriangleBuffer);
 
     mCreateInfo.mpRenderer->registerBuffer(
         vertexBufferName,
@@ -342,6 +536,18 @@ void CApp::loadMeshes(
         "meshExtents",
         maBuffers["meshExtents"]
     );
+    mCreateInfo.mpRenderer->registerBuffer(
+        "meshVertexDequantization",
+        maBuffers["meshVertexDequantization"]
+    );
+    mCreateInfo.mpRenderer->registerBuffer(
+        "meshlets",
+        maBuffers["meshlets"]
+    );
+    mCreateInfo.mpRenderer->registerBuffer(
+        "meshLods",
+        maBuffers["meshLods"]
+    );
     
 
     char* acMaterialID = nullptr;
@@ -432,7 +638,7 @@ void CApp::loadMeshes(
         "animMeshModelMatrices",
         maBuffers["animMeshModelMatrices"]
     );
-    mCreateInfo.mpRenderer->registerBuffer(
+    miStaticMeshModelMatrixBuffer = mCreateInfo.mpRenderer->registerBuffer(
         "staticMeshModelMatrices",
         maBuffers["staticMeshModelMatrices"]
     );
@@ -496,7 +702,9 @@ void CApp::loadMeshes(
 
     // mesh culling uniform and visibility flags
     {
-        uint32_t aiUniformBufferData[] = {(uint32_t)iNumMeshes, 0};
+        // num instances, explode multiplier, cluster culling flags. the static mesh passes draw both sides of the
+        // triangles so the normal cone test stays off
+        uint32_t aiUniformBufferData[] = {(uint32_t)iNumMeshes, 0, 0};
         bufferDesc.size = 256;
         bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
         maBuffers["meshCullingUniformBuffer"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
@@ -508,7 +716,7 @@ void CApp::loadMeshes(
             aiUniformBufferData,
             sizeof(aiUniformBufferData)
         );
-        mCreateInfo.mpRenderer->registerBuffer("meshCullingUniformBuffer", maBuffers["meshCullingUniformBuffer"]);
+        miMeshCullingUniformBuffer = mCreateInfo.mpRenderer->registerBuffer("meshCullingUniformBuffer", maBuffers["meshCullingUniformBuffer"]);
 
         bufferDesc.size = iNumMeshes * sizeof(uint32_t);
         bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
@@ -516,6 +724,15 @@ void CApp::loadMeshes(
         maBuffers["culledFlags"].SetLabel("Mesh Culled Flags");
         maBufferSizes["culledFlags"] = (uint32_t)bufferDesc.size;
         mCreateInfo.mpRenderer->registerBuffer("culledFlags", maBuffers["culledFlags"]);
+
+        // occlusion culling state per instance, kept from frame to frame by the early and late culling jobs. starts
+        // zeroed so the first frame is all drawn by the late phase
+        bufferDesc.size = iNumMeshes * sizeof(uint32_t);
+        bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+        maBuffers["meshVisibility"] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
+        maBuffers["meshVisibility"].SetLabel("Mesh Visibility");
+        maBufferSizes["meshVisibility"] = (uint32_t)bufferDesc.size;
+        mCreateInfo.mpRenderer->registerBuffer("meshVisibility", maBuffers["meshVisibility"]);
     }
 
     {
@@ -621,11 +838,217 @@ void CApp::loadMeshes(
             aModelInstanceMap.data(),
             sizeof(ModelInstanceMap) * aModelInstanceMap.size()
         );
+
+        // every meshlet of every instance visible is the most draws cluster culling can emit, at the level with
+        // the most meshlets
+        uint32_t iMaxClusterDrawCalls = 0;
+        for(uint32_t i = 0; i < (uint32_t)maStaticMeshModelMatrices.size(); i++)
+        {
+            uint32_t iMaxMeshlets = 0;
+            for(uint32_t iLod = 0; iLod < MESH_MAX_LODS; iLod++)
+            {
+                Render::MeshLod const& lod = aMeshLods[aModelInstanceMap[i].miModel * MESH_MAX_LODS + iLod];
+                iMaxMeshlets = std::max(iMaxMeshlets, lod.miMeshletEnd - lod.miMeshletStart);
+            }
+            iMaxClusterDrawCalls += iMaxMeshlets;
+        }
+        mCreateInfo.mpRenderer->setMaxClusterDrawCalls(iMaxClusterDrawCalls);
+    }
+
+}
+
+
+
+/*
+**
+*/
+bool CApp::parseChunkedMeshFile(
+    MeshFileSections& sections,
+    char const* acFileData,
+    uint64_t iFileSize)
+{
+    if(iFileSize < sizeof(Render::MeshFileHeader))
+    {
+        return false;
+    }
+
+    Render::MeshFileHeader const* pHeader = (Render::MeshFileHeader const*)acFileData;
+    if(pHeader->miVersion != MESH_FILE_VERSION || pHeader->miFileSize != iFileSize)
+    {
+        DEBUG_PRINTF("!!! mesh file version %d size %lld, expected version %d size %lld !!!\n",
+            pHeader->miVersion,
+            pHeader->miFileSize,
+            MESH_FILE_VERSION,
+            iFileSize);
+        return false;
+    }
+
+    uint64_t iTableSize = sizeof(Render::MeshFileChunk) * (uint64_t)pHeader->miNumChunks;
+    Render::MeshFileChunk const* aChunks = (Render::MeshFileChunk const*)(pHeader + 1);
+    if(sizeof(Render::MeshFileHeader) + iTableSize > iFileSize ||
+        Render::computeMeshFileChecksum(aChunks, iTableSize) != pHeader->miTableChecksum)
+    {
+        DEBUG_PRINTF("!!! mesh file table of contents is corrupt !!!\n");
+        return false;
+    }
+
+    uint32_t iNumExtents = 0, iNumDequantizations = 0, iNumMeshletRanges = 0, iNumLods = 0;
+    uint32_t iNumFloatVertices = 0, iNumPackedVertices = 0;
+    for(uint32_t iChunk = 0; iChunk < pHeader->miNumChunks; iChunk++)
+    {
+        Render::MeshFileChunk const& chunk = aChunks[iChunk];
+
+        // chunks this loader doesn't use are skipped without being touched
+        void const** ppSection = nullptr;
+        uint32_t iExpectedElementSize = 0;
+        switch(chunk.miType)
+        {
+            case Render::MESH_FILE_CHUNK_TRIANGLE_RANGES:
+                ppSection = &sections.mpTriangleRanges;
+                iExpectedElementSize = (uint32_t)sizeof(MeshTriangleRange);
+                sections.miNumMeshes = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_EXTENTS:
+                ppSection = &sections.mpExtents;
+                iExpectedElementSize = (uint32_t)sizeof(MeshExtent);
+                iNumExtents = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_VERTICES:
+                ppSection = &sections.mpVertices;
+                iExpectedElementSize = (uint32_t)sizeof(Vertex);
+                iNumFloatVertices = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_INDICES:
+                ppSection = &sections.mpTriangleIndices;
+                iExpectedElementSize = (uint32_t)sizeof(uint32_t);
+                sections.miNumTriangleIndices = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_PACKED_VERTICES:
+                ppSection = &sections.mpPackedVertices;
+                iExpectedElementSize = (uint32_t)sizeof(Render::PackedVertex);
+                iNumPackedVertices = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_DEQUANTIZATION:
+                ppSection = &sections.mpDequantization;
+                iExpectedElementSize = (uint32_t)sizeof(Render::VertexDequantization);
+                iNumDequantizations = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_MESHLETS:
+                ppSection = &sections.mpMeshlets;
+                iExpectedElementSize = (uint32_t)sizeof(Render::Meshlet);
+                sections.miNumMeshlets = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_MESHLET_RANGES:
+                ppSection = &sections.mpMeshletRanges;
+                iExpectedElementSize = (uint32_t)sizeof(MeshTriangleRange);
+                iNumMeshletRanges = chunk.miNumElements;
+                break;
+            case Render::MESH_FILE_CHUNK_LODS:
+                ppSection = &sections.mpLods;
+                iExpectedElementSize = (uint32_t)sizeof(Render::MeshLod);
+                iNumLods = chunk.miNumElements;
+                break;
+            default:
+                continue;
+        }
+
+        char const* pChunkData = acFileData + chunk.miOffset;
+        if(chunk.miElementSize != iExpectedElementSize ||
+            chunk.miSize != (uint64_t)chunk.miElementSize * (uint64_t)chunk.miNumElements ||
+            chunk.miOffset + chunk.miSize > iFileSize)
+        {
+            DEBUG_PRINTF("!!! mesh file chunk %d has element size %d, expected %d !!!\n",
+                iChunk,
+                chunk.miElementSize,
+                iExpectedElementSize);
+            return false;
+        }
+
+        if(Render::computeMeshFileChecksum(pChunkData, chunk.miSize) != chunk.miChecksum)
+        {
+            DEBUG_PRINTF("!!! mesh file chunk %d checksum mismatch !!!\n", iChunk);
+            return false;
+        }
+
+        *ppSection = pChunkData;
+    }
+
+    // meshlets are optional, without a range per mesh they are built from the triangle ranges
+    if(sections.mpMeshlets == nullptr || sections.mpMeshletRanges == nullptr || iNumMeshletRanges != sections.miNumMeshes)
+    {
+        sections.mpMeshlets = sections.mpMeshletRanges = nullptr;
+        sections.miNumMeshlets = 0;
+    }
+
+    // so are the levels of detail, their meshlet ranges are into the file's meshlets
+    if(sections.mpMeshlets == nullptr || iNumLods != sections.miNumMeshes * MESH_MAX_LODS)
+    {
+        sections.mpLods = nullptr;
     }
 
+    // packed vertices need a dequantization per mesh, without one the float vertices are packed at load instead
+    bool bPackedVertices = (sections.mpPackedVertices != nullptr && sections.mpDequantization != nullptr && iNumDequantizations == sections.miNumMeshes);
+    if(bPackedVertices)
+    {
+        sections.miNumVertices = iNumPackedVertices;
+    }
+    else
+    {
+        if(sections.mpPackedVertices != nullptr)
+        {
+            DEBUG_PRINTF("!!! mesh file has packed vertices without their dequantization, using the float vertices !!!\n");
+        }
+        sections.mpPackedVertices = sections.mpDequantization = nullptr;
+        sections.miNumVertices = iNumFloatVertices;
+    }
+
+    // the last extent is the whole model
+    return (
+        sections.mpTriangleRanges != nullptr &&
+        sections.mpExtents != nullptr &&
+        (sections.mpVertices != nullptr || bPackedVertices) &&
+        sections.mpTriangleIndices != nullptr &&
+        iNumExtents == sections.miNumMeshes + 1
+    );
 }
 
+/*
+**
+*/
+bool CApp::parseLegacyMeshFile(
+    MeshFileSections& sections,
+    char const* acFileData,
+    uint64_t iFileSize)
+{
+    // num meshes, num vertices, num triangles, vertex size, triangle start offset
+    if(iFileSize < sizeof(uint32_t) * 5)
+    {
+        return false;
+    }
 
+    uint32_t const* piData = (uint32_t const*)acFileData;
+    uint32_t iNumMeshes = *piData++;
+    uint32_t iNumTotalVertices = *piData++;
+    uint32_t iNumTotalTriangles = *piData++;
+    uint32_t iVertexSize = *piData++;
+    piData++;
+
+    char const* pCurr = (char const*)piData;
+    sections.mpTriangleRanges = pCurr;
+    pCurr += sizeof(MeshTriangleRange) * iNumMeshes;
+    sections.mpExtents = pCurr;
+    pCurr += sizeof(MeshExtent) * (iNumMeshes + 1);
+    sections.mpVertices = pCurr;
+    pCurr += sizeof(Vertex) * (uint64_t)iNumTotalVertices;
+    sections.mpTriangleIndices = pCurr;
+    pCurr += sizeof(uint32_t) * 3 * (uint64_t)iNumTotalTriangles;
+
+    sections.miNumMeshes = iNumMeshes;
+    sections.miNumVertices = iNumTotalVertices;
+    sections.miNumTriangleIndices = iNumTotalTriangles * 3;
+
+    return (iVertexSize == sizeof(Vertex) && (uint64_t)(pCurr - acFileData) <= iFileSize);
+}
 
 /*
 **
@@ -682,7 +1105,7 @@ void CApp::loadAnimMeshes(std::string const& dir)
     maBuffers[uniformBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[uniformBufferName].SetLabel(uniformBufferName.c_str());
     maBufferSizes[uniformBufferName] = (uint32_t)bufferDesc.size;
-    mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
+    miAnimMeshModelUniformBuffer = mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
 
     uniformBufferName = "skinMeshUniformBuffer";
     bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
@@ -742,6 +1165,46 @@ void CApp::loadAnimMeshes(std::string const& dir)
 
 }
 
+/*
+** texture lists loadAnimation passes to loadTexturesIntoAtlas, known after loadAnimMeshes
+*/
+void CApp::getAnimTextureListNames(std::vector<std::string>& aNames) const
+{
+    for(auto const& animNameInfo : maAnimationNameInfo)
+    {
+        aNames.push_back(getAnimBaseModelName(animNameInfo.mDatabaseName));
+    }
+}
+
+/*
+** animation mesh file with the instance, without the .wad
+*/
+std::string CApp::getAnimBaseModelName(std::string const& databaseName) const
+{
+    auto iter = std::find_if(
+        maAnimFileInfo.begin(),
+        maAnimFileInfo.end(),
+        [databaseName](auto const& animFileInfo)
+        {
+            auto iter = std::find_if(
+                animFileInfo.maMeshInstanceNames.begin(),
+                animFileInfo.maMeshInstanceNames.end(),
+                [databaseName](auto& meshInstanceName)
+                {
+                    return meshInstanceName == databaseName;
+                }
+            );
+            
+            return (iter != animFileInfo.maMeshInstanceNames.end());
+        }
+    );
+    assert(iter != maAnimFileInfo.end());
+    std::string const& baseFileName = iter->mFileName;
+    auto end = baseFileName.rfind(".wad");
+
+    return baseFileName.substr(0, end);
+}
+
 /*
 **
 */
@@ -754,27 +1217,7 @@ void CApp::loadAnimation(
     for(auto& animNameInfo : maAnimationNameInfo)
     {
         std::string srcMatchingName = animNameInfo.mSrcAnimationName;
-        auto iter = std::find_if(
-            maAnimFileInfo.begin(),
-            maAnimFileInfo.end(),
-            [animNameInfo](auto const& animFileInfo)
-            {
-                auto iter = std::find_if(
-                    animFileInfo.maMeshInstanceNames.begin(),
-                    animFileInfo.maMeshInstanceNames.end(),
-                    [animNameInfo](auto& meshInstanceName)
-                    {
-                        return meshInstanceName == animNameInfo.mDatabaseName;
-                    }
-                );
-                
-                return (iter != animFileInfo.maMeshInstanceNames.end());
-            }
-        );
-        assert(iter != maAnimFileInfo.end());
-        std::string const& baseFileName = iter->mFileName;
-        auto end = baseFileName.rfind(".wad");
-        std::string baseName = baseFileName.substr(0, end);
+        std::string baseName = getAnimBaseModelName(animNameInfo.mDatabaseName);
         animNameInfo.mBaseModel = baseName;
 
         // animation frame file
@@ -1008,7 +1451,7 @@ void CApp::update()
     shadowUniformBuffer.mDecalViewProjectionMatrix = decalViewProjectionMatrix;
 
     // upload data
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
+    mCreateInfo.mpRenderer->queueBufferUpload(
         maBuffers["shadowUniformBuffer"],
         0,
         &shadowUniformBuffer,
@@ -1084,9 +1527,8 @@ void CApp::updateAnimations(float fElapsedMilliseconds)
     }
 
     // update gpu total matrix buffer
-    std::string bufferName = "total-joint-global-animation-matrices";
-    wgpu::Buffer& jointAnimTotalMatrixBuffer = mCreateInfo.mpRenderer->getBuffer(bufferName);
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
+    wgpu::Buffer& jointAnimTotalMatrixBuffer = mCreateInfo.mpRenderer->getBuffer(miTotalJointAnimationMatrixBuffer);
+    mCreateInfo.mpRenderer->queueBufferUpload(
         jointAnimTotalMatrixBuffer,
         0,
         maTotalGlobalAnimationMatrices.data(),
@@ -1107,6 +1549,8 @@ void CApp::updateAnimations(float fElapsedMilliseconds)
         mafAnimTimeMilliSeconds["batter"] = 1300.0f;
     }
 
+    // one entry per 256 bytes for the dynamic offsets, uploaded as a single block
+    std::vector<uint8_t> acAnimMeshModelUniforms(maAnimationNameInfo.size() * 256, 0);
     for(uint32_t i = 0; i < maAnimationNameInfo.size(); i++)
     {
         AnimMeshModelUniform uniformBuffer;
@@ -1120,15 +1564,16 @@ void CApp::updateAnimations(float fElapsedMilliseconds)
         );
         uniformBuffer.mExtraInfo = float4(float(i), 0.0f, 0.0f, 0.0f);
 
-        std::string animMeshModelUniformBufferName = "animMeshModelUniforms";
-        wgpu::Buffer& animMeshModelUniformBuffer = mCreateInfo.mpRenderer->getBuffer(animMeshModelUniformBufferName);
-        mCreateInfo.mpDevice->GetQueue().WriteBuffer(
-            animMeshModelUniformBuffer,
-            i * 256,
-            &uniformBuffer,
-            sizeof(AnimMeshModelUniform)
-        );
+        memcpy(acAnimMeshModelUniforms.data() + i * 256, &uniformBuffer, sizeof(AnimMeshModelUniform));
     }
+
+    wgpu::Buffer& animMeshModelUniformBuffer = mCreateInfo.mpRenderer->getBuffer(miAnimMeshModelUniformBuffer);
+    mCreateInfo.mpRenderer->queueBufferUpload(
+        animMeshModelUniformBuffer,
+        0,
+        acAnimMeshModelUniforms.data(),
+        acAnimMeshModelUniforms.size()
+    );
 }
 
 /*
@@ -1140,6 +1585,7 @@ void CApp::updateMeshModelTransforms()
         float3(0.0f, 0.2f, 0.0f),
         float3(-0.8f, -0.1f, -18.4404f)
     };
+    std::vector<uint8_t> acAnimMeshModelUniforms(maAnimationNameInfo.size() * 256, 0);
     for(uint32_t i = 0; i < maAnimationNameInfo.size(); i++)
     {
         AnimMeshModelUniform uniformBuffer;
@@ -1152,15 +1598,7 @@ void CApp::updateMeshModelTransforms()
             (float)maAnimMeshTextureAtlasInfo[i].miImageHeight
         );
         uniformBuffer.mExtraInfo = float4(float(i), 0.0f, 0.0f, 0.0f);
-
-        std::string animMeshModelUniformBufferName = "animMeshModelUniforms";
-        wgpu::Buffer& animMeshModelUniformBuffer = mCreateInfo.mpRenderer->getBuffer(animMeshModelUniformBufferName);
-        mCreateInfo.mpDevice->GetQueue().WriteBuffer(
-            animMeshModelUniformBuffer,
-            i * 256,
-            &uniformBuffer,
-            sizeof(AnimMeshModelUniform)
-        );
+        memcpy(acAnimMeshModelUniforms.data() + i * 256, &uniformBuffer, sizeof(AnimMeshModelUniform));
 
         float4x4 localBindMatrix, parentTotalMatrix, localAnimMatrix;
         getJointMatrices(
@@ -1180,6 +1618,14 @@ void CApp::updateMeshModelTransforms()
 
     }
 
+    // same range as the block from updateAnimations, replaces it in the upload ring
+    mCreateInfo.mpRenderer->queueBufferUpload(
+        mCreateInfo.mpRenderer->getBuffer(miAnimMeshModelUniformBuffer),
+        0,
+        acAnimMeshModelUniforms.data(),
+        acAnimMeshModelUniforms.size()
+    );
+
     // ball position while in windup, get the position of the throwing hand
     if(mGameState == GAME_STATE_PITCH_WINDUP)
     {
@@ -1302,21 +1748,20 @@ void CApp::updateMeshModelTransforms()
         }
     }
 
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
-        maBuffers["staticMeshModelMatrices"],
+    mCreateInfo.mpRenderer->queueBufferUpload(
+        mCreateInfo.mpRenderer->getBuffer(miStaticMeshModelMatrixBuffer),
         0,
         maStaticMeshModelMatrices.data(),
         maStaticMeshModelMatrices.size() * sizeof(float4x4)
     );
 
-    uint32_t aiUniformBufferData[] = {(uint32_t)maStaticMeshModelMatrices.size(), 0};
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
-        maBuffers["meshCullingUniformBuffer"],
+    uint32_t aiUniformBufferData[] = {(uint32_t)maStaticMeshModelMatrices.size(), 0, 0};
+    mCreateInfo.mpRenderer->queueBufferUpload(
+        mCreateInfo.mpRenderer->getBuffer(miMeshCullingUniformBuffer),
         0,
         aiUniformBufferData,
         sizeof(aiUniformBufferData)
     );
-    mCreateInfo.mpRenderer->registerBuffer("meshCullingUniformBuffer", maBuffers["meshCullingUniformBuffer"]);
 
     struct LightInfo
     {
@@ -1339,8 +1784,8 @@ void CApp::updateMeshModelTransforms()
     aLightInfo[3].mRadiance = lightRadiance;
     aLightInfo[4].mRadiance = lightRadiance;
 
-    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
-        maBuffers["lightingUniformBuffer"],
+    mCreateInfo.mpRenderer->queueBufferUpload(
+        mCreateInfo.mpRenderer->getBuffer(miLightingUniformBuffer),
         0,
         aLightInfo.data(),
         aLightInfo.size() * sizeof(LightInfo)
@@ -1649,6 +2094,39 @@ void CApp::getJointMatrices(
     localBindMatrix = maaDstLocalBindMatrices[iAnimationIndex][iJointArrayIndex];
 }
 
+/*
+**
+*/
+void CApp::resolveShadowJobs()
+{
+    Render::CRenderer* pRenderer = mCreateInfo.mpRenderer;
+    for(uint32_t i = 0; i < (uint32_t)(sizeof(maShadowCascadeJobs) / sizeof(*maShadowCascadeJobs)); i++)
+    {
+        std::string cascadeIndex = std::to_string(i);
+        maShadowCascadeJobs[i].miStatic = pRenderer->getJobHandle("Light View Static Graphics " + cascadeIndex);
+        maShadowCascadeJobs[i].miSkinMesh = pRenderer->getJobHandle("Light View Skin Mesh Graphics " + cascadeIndex);
+        maShadowCascadeJobs[i].miDynamic = pRenderer->getJobHandle("Light View Dynamic Graphics " + cascadeIndex);
+        maShadowCascadeJobs[i].miComposite = pRenderer->getJobHandle("Light View Composite Graphics " + cascadeIndex);
+    }
+
+    // the light doesn't move, the cascade centers are snapped to cells of 32 texels so a cascade and the cached layer
+    // of its static meshes only move when the camera crosses a cell. the cascades share the size of the first one's
+    // layer
+    float3 lightDirection = normalize(float3(0.3f, 1.0f, 0.0f));
+    mShadowCascadeDesc.mafLightDirection[0] = lightDirection.x;
+    mShadowCascadeDesc.mafLightDirection[1] = lightDirection.y;
+    mShadowCascadeDesc.mafLightDirection[2] = lightDirection.z;
+    mShadowCascadeDesc.miNumCascades = (uint32_t)(sizeof(maShadowCascades) / sizeof(*maShadowCascades));
+    mShadowCascadeDesc.miSnapTexels = 32;
+    mShadowCascadeDesc.miShadowMapSize = std::max(
+        pRenderer->getOutputSize(maShadowCascadeJobs[0].miStatic).x,
+        mShadowCascadeDesc.miSnapTexels * 4);
+    mShadowCascadeDesc.mfNear = 1.0f;
+    mShadowCascadeDesc.mfFar = 150.0f;
+    mShadowCascadeDesc.mfSplitLambda = 0.75f;
+    mShadowCascadeDesc.mfCasterDistance = 50.0f;
+}
+
 /*
 **
 */
@@ -1656,74 +2134,90 @@ void CApp::updateLightViewMatrices(
     ShadowUniformData& shadowUniformBuffer,
     CCamera const& camera)
 {
-    //float fFarMinusNear = camera.getFar() - camera.getNear();
-    float fFarMinusNear = 100.0f - 1.0f;
-    float fCameraFieldOfView = camera.getFieldOfView();
-    float2 afFrustumPct[] =
-    {
-        float2(0.08f, 0.125f),
-        float2(0.125f, 0.3f),
-        float2(0.3f, 1.75f),
-    };
-
     float3 cameraPosition = camera.getPosition();
-    float3 cameraLookAt = camera.getLookAt();
-    float3 cameraLookDir = normalize(cameraLookAt - cameraPosition);
-    
-    float3 lightDirection = normalize(float3(0.3f, 1.0f, 0.0f));
-    float3 up = (fabsf(lightDirection.y) >= 0.99f) ? float3(1.0f, 0.0f, 0.0f) : float3(0.0f, 1.0f, 0.0f);
-
-    uint32_t iNumCascades = (uint32_t)(sizeof(afFrustumPct) / sizeof(*afFrustumPct));
+    float3 cameraLookDir = normalize(camera.getLookAt() - cameraPosition);
+    uint32_t iNumCascades = mShadowCascadeDesc.miNumCascades;
+
+    Render::ShadowCascadeCamera cascadeCamera;
+    cascadeCamera.mafPosition[0] = cameraPosition.x;
+    cascadeCamera.mafPosition[1] = cameraPosition.y;
+    cascadeCamera.mafPosition[2] = cameraPosition.z;
+    cascadeCamera.mafLookDirection[0] = cameraLookDir.x;
+    cascadeCamera.mafLookDirection[1] = cameraLookDir.y;
+    cascadeCamera.mafLookDirection[2] = cameraLookDir.z;
+    cascadeCamera.mfFieldOfView = camera.getFieldOfView();
+    cascadeCamera.mfAspectRatio = camera.getAspectRatio();
+    cascadeCamera.mfNear = camera.getNear();
+    cascadeCamera.mfFar = camera.getFar();
+
+    Render::ShadowCascade aCascades[SHADOW_MAX_CASCADES];
+    Render::fitShadowCascades(aCascades, mShadowCascadeDesc, cascadeCamera);
+
+    // the last extent is of the whole mesh file
+    static_assert(sizeof(MeshExtent) == sizeof(float) * 8, "cullShadowCascade reads the extents as floats");
+    uint32_t iNumMeshes = (maMeshExtents.size() > 0) ? (uint32_t)maMeshExtents.size() - 1 : 0;
+    mabDynamicMeshes.resize(std::max(iNumMeshes, (uint32_t)mabDynamicMeshes.size()), 0);
+
+    uint32_t iNumTriangles = 0;
+    uint32_t iNumLayersDrawn = 0;
     for(uint32_t i = 0; i < iNumCascades; i++)
     {
-        float fNearDistance = afFrustumPct[i].x * fFarMinusNear;
-        float fFarDistance = afFrustumPct[i].y * fFarMinusNear;
-        float fSizeZ = fFarDistance - fNearDistance;
-
-        float fFrustumWidth = tanf(fCameraFieldOfView * (3.14159f / 180.0f)) * fFarDistance * 2.0f;
-        float fFrustumHeight = fFarDistance - fNearDistance;
-        float fMaxSize = maxf(fFrustumWidth, maxf(fFrustumHeight, fSizeZ));
-        float fHalfMaxSize = fMaxSize * 0.5f;
-
-        float3 frustumCascadeNear = cameraPosition + cameraLookDir * fNearDistance;
-        float3 frustumCascadeFar = cameraPosition + cameraLookDir * fFarDistance;
-        float3 frustumCascadeCenter = (frustumCascadeFar + frustumCascadeNear) * 0.5f;
+        Render::ShadowCascade const& cascade = aCascades[i];
+        shadowUniformBuffer.maLightViewProjectionMatrices[i] = float4x4(cascade.mafViewProjection);
+
+        // static meshes in the moved cascade are drawn into its layer again, the dynamic ones every frame
+        ShadowCascadeJobs const& jobs = maShadowCascadeJobs[i];
+        Render::ShadowCascade& cachedCascade = maShadowCascades[i];
+        if(!mabShadowCascadesCached[i] ||
+            cachedCascade.maiSnappedCenter[0] != cascade.maiSnappedCenter[0] ||
+            cachedCascade.maiSnappedCenter[1] != cascade.maiSnappedCenter[1] ||
+            cachedCascade.maiSnappedCenter[2] != cascade.maiSnappedCenter[2] ||
+            cachedCascade.mfSize != cascade.mfSize)
+        {
+            std::vector<uint32_t> aiMeshes(iNumMeshes);
+            aiMeshes.resize(Render::cullShadowCascade(
+                aiMeshes.data(),
+                cascade,
+                (float const*)maMeshExtents.data(),
+                iNumMeshes,
+                mabDynamicMeshes.data()));
+            maiNumShadowCascadeMeshes[i] = (uint32_t)aiMeshes.size();
+
+            mCreateInfo.mpRenderer->setJobMeshes(jobs.miStatic, aiMeshes);
+            mCreateInfo.mpRenderer->invalidateJob(jobs.miStatic);
+            cachedCascade = cascade;
+            mabShadowCascadesCached[i] = true;
+        }
 
-        float3 eyePosition = frustumCascadeCenter + lightDirection * fHalfMaxSize;
-        float3 lookAt = frustumCascadeCenter;
+        uint32_t iNumStaticTriangles = mCreateInfo.mpRenderer->getNumTriangles(jobs.miStatic);
+        iNumLayersDrawn += (iNumStaticTriangles > 0) ? 1 : 0;
+        iNumTriangles +=
+            iNumStaticTriangles +
+            mCreateInfo.mpRenderer->getNumTriangles(jobs.miSkinMesh) +
+            mCreateInfo.mpRenderer->getNumTriangles(jobs.miDynamic) +
+            mCreateInfo.mpRenderer->getNumTriangles(jobs.miComposite);
+    }
 
-        float4x4 viewMatrix = makeViewMatrix(
-            eyePosition,
-            lookAt,
-            up
-        );
-        float4x4 projectionMatrix = orthographicProjection(
-            -fHalfMaxSize,
-            fHalfMaxSize,
-            fHalfMaxSize,
-            -fHalfMaxSize,
-            fMaxSize,
-            -fMaxSize
-        );
-        //float4x4 projectionMatrix = orthographicProjection(
-        //    -5.0f,
-        //    5.0f,
-        //    5.0f,
-        //    -5.0f,
-        //    10.0f,
-        //    -10.0f
-        //);
-
-        float4x4 viewProjectionMatrix = projectionMatrix * viewMatrix;
-        shadowUniformBuffer.maLightViewProjectionMatrices[i] = viewProjectionMatrix;
-
-        //DEBUG_PRINTF("light view %d eye (%.4f, %.4f, %.4f) lookAt (%.4f, %.4f, %.4f) max size: %.4f\n",
-        //    i,
-        //    eyePosition.x, eyePosition.y, eyePosition.z,
-        //    lookAt.x, lookAt.y, lookAt.z,
-        //    fMaxSize
-        //);
-        //int iDebug = 1;
+    // counts of the last frame, the jobs of this one aren't recorded yet
+    miNumShadowTriangles = iNumTriangles;
+    miNumShadowLayersDrawn = iNumLayersDrawn;
+    if(mCreateInfo.mpRenderer->getFrameIndex() % 600 == 1)
+    {
+        DEBUG_PRINTF("frame %d shadows: %d triangles, %d of %d cascades drew their static layer\n",
+            mCreateInfo.mpRenderer->getFrameIndex() - 1,
+            miNumShadowTriangles,
+            miNumShadowLayersDrawn,
+            iNumCascades);
+        for(uint32_t i = 0; i < iNumCascades; i++)
+        {
+            DEBUG_PRINTF("    cascade %d: %.2f to %.2f, %.2f wide, %d of %d meshes\n",
+                i,
+                maShadowCascades[i].mfNearDistance,
+                maShadowCascades[i].mfFarDistance,
+                maShadowCascades[i].mfSize,
+                maiNumShadowCascadeMeshes[i],
+                iNumMeshes);
+        }
     }
 }
 
@@ -1748,7 +2242,8 @@ void CApp::loadAnimMeshDB()
     maaGlobalInverseBindMatrices.resize(maAnimFileInfo.size());
 
     uint32_t iLoadAnimMesh = 0;
-    std::vector<Vertex> aTotalVertexBuffer;
+    std::vector<Render::PackedVertex> aTotalVertexBuffer;
+    std::vector<Render::VertexDequantization> aAnimMeshDequantization;
     std::vector<uint32_t> aTotalIndexBuffer;
     std::vector<float> afTotalJointInfluenceWeights;
     std::vector<uint32_t> aiTotalJointInfluenceIndices;
@@ -1815,16 +2310,23 @@ void CApp::loadAnimMeshDB()
         vertexRange.miStart = 0;
         vertexRange.miEnd = iNumMeshPositions;
 
-        uint32_t iAnimMeshID = 0;
+        // pack over the extent of the bind pose, skin-mesh-compute.shader dequantizes with the mesh model's entry
+        float3 minPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+        float3 maxPosition = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for(uint32_t i = 0; i < iNumMeshPositions; i++)
+        {
+            minPosition = fminf(minPosition, aPositions[i]);
+            maxPosition = fmaxf(maxPosition, aPositions[i]);
+        }
+        Render::VertexDequantization dequantization;
+        Render::computeVertexDequantization(dequantization, &minPosition.x, &maxPosition.x);
+        aAnimMeshDequantization.push_back(dequantization);
 
-        // convert to vertex format
-        std::vector<Vertex> aTotalVertices(iNumMeshPositions);
+        std::vector<Render::PackedVertex> aTotalVertices(iNumMeshPositions);
         for(uint32_t i = 0; i < iNumMeshPositions; i++)
         {
-            Vertex& v = aTotalVertices[i];
-            v.mPosition = float4(aPositions[i], 1.0f);
-            v.mNormal = float4(aNormals[i], 1.0f);
-            v.mUV = float4(aTexCoords[i].x, aTexCoords[i].y, (float)iAnimMeshID, 1.0f);
+            float3 normal = normalize(aNormals[i]);
+            Render::packVertex(aTotalVertices[i], &aPositions[i].x, &aTexCoords[i].x, &normal.x, iLoadAnimMesh, dequantization);
         }
 
         //std::vector<std::vector<float4x4>> aaGlobalInverseBindMatrices(iNumAnimations);
@@ -1940,7 +2442,7 @@ void CApp::loadAnimMeshDB()
         wgpu::BufferDescriptor bufferDesc = {};
         bufferDesc.label = meshName.c_str();
         bufferDesc.mappedAtCreation = false;
-        bufferDesc.size = aTotalVertices.size() * sizeof(Vertex);
+        bufferDesc.size = aTotalVertices.size() * sizeof(Render::PackedVertex);
         bufferDesc.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage;
         wgpu::Buffer skinAnimMeshBuffer = mCreateInfo.mpDevice->CreateBuffer(
             &bufferDesc
@@ -1949,7 +2451,7 @@ void CApp::loadAnimMeshDB()
             skinAnimMeshBuffer,
             0,
             aTotalVertices.data(),
-            aTotalVertices.size() * sizeof(Vertex));
+            aTotalVertices.size() * sizeof(Render::PackedVertex));
         mCreateInfo.mpRenderer->registerBuffer(meshName, skinAnimMeshBuffer);
 
         gpuBuffers.mVertexBuffer = skinAnimMeshBuffer;
@@ -2126,9 +2628,9 @@ void CApp::loadAnimMeshDB()
             uint32_t iLastVertexBufferSize = (uint32_t)aTotalVertexBuffer.size();
             aTotalVertexBuffer.resize(iLastVertexBufferSize + aTotalVertices.size());
             memcpy(
-                (char*)aTotalVertexBuffer.data() + iLastVertexBufferSize * sizeof(Vertex),
+                (char*)aTotalVertexBuffer.data() + iLastVertexBufferSize * sizeof(Render::PackedVertex),
                 aTotalVertices.data(),
-                aTotalVertices.size() * sizeof(Vertex)
+                aTotalVertices.size() * sizeof(Render::PackedVertex)
             );
             
             uint32_t iLastIndexBufferSize = (uint32_t)aTotalIndexBuffer.size();
@@ -2213,7 +2715,7 @@ void CApp::loadAnimMeshDB()
     std::string uniformBufferName = "total-anim-mesh-vertex-buffer";
     wgpu::BufferDescriptor bufferDesc = {};
     bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex;
-    bufferDesc.size = aTotalVertexBuffer.size() * sizeof(Vertex);
+    bufferDesc.size = aTotalVertexBuffer.size() * sizeof(Render::PackedVertex);
     maBuffers[uniformBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[uniformBufferName].SetLabel(uniformBufferName.c_str());
     maBufferSizes[uniformBufferName] = (uint32_t)bufferDesc.size;
@@ -2222,7 +2724,7 @@ void CApp::loadAnimMeshDB()
         maBuffers[uniformBufferName],
         0,
         aTotalVertexBuffer.data(),
-        aTotalVertexBuffer.size() * sizeof(Vertex)
+        aTotalVertexBuffer.size() * sizeof(Render::PackedVertex)
     );
     maTotalAnimMeshVertexBufferNames.resize(maAnimationNameInfo.size());
     for(uint32_t iMesh = 0; iMesh < maAnimationNameInfo.size(); iMesh++)
@@ -2230,6 +2732,21 @@ void CApp::loadAnimMeshDB()
         maTotalAnimMeshVertexBufferNames[iMesh] = uniformBufferName;
     }
 
+    // dequantization of every anim mesh model's packed vertices
+    uniformBufferName = "anim-mesh-vertex-dequantization";
+    bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+    bufferDesc.size = aAnimMeshDequantization.size() * sizeof(Render::VertexDequantization);
+    maBuffers[uniformBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
+    maBuffers[uniformBufferName].SetLabel(uniformBufferName.c_str());
+    maBufferSizes[uniformBufferName] = (uint32_t)bufferDesc.size;
+    mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
+    mCreateInfo.mpDevice->GetQueue().WriteBuffer(
+        maBuffers[uniformBufferName],
+        0,
+        aAnimMeshDequantization.data(),
+        aAnimMeshDequantization.size() * sizeof(Render::VertexDequantization)
+    );
+
     // total index buffer
     uniformBufferName = "total-anim-mesh-index-buffer";
     bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Index;
@@ -2317,7 +2834,7 @@ void CApp::loadAnimMeshDB()
     maBuffers[uniformBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[uniformBufferName].SetLabel(uniformBufferName.c_str());
     maBufferSizes[uniformBufferName] = (uint32_t)bufferDesc.size;
-    mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
+    miTotalJointAnimationMatrixBuffer = mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
 
     // total joint matrix start index
     uniformBufferName = "total-joint-matrix-start-indices";
@@ -2399,6 +2916,6 @@ void CApp::loadAnimMeshDB()
     maBuffers[uniformBufferName] = mCreateInfo.mpDevice->CreateBuffer(&bufferDesc);
     maBuffers[uniformBufferName].SetLabel(uniformBufferName.c_str());
     maBufferSizes[uniformBufferName] = (uint32_t)bufferDesc.size;
-    mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
+    miAnimMeshModelUniformBuffer = mCreateInfo.mpRenderer->registerBuffer(uniformBufferName, maBuffers[uniformBufferName]);
 
 }
\ No newline at end of file
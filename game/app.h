@@ -8,6 +8,9 @@
 #include <game/pitch_simulator.h>
 #include <game/batted_ball_simulator.h>
 #include <render/camera.h>
+#include <render/meshlet.h>
+#include <render/mesh_lod.h>
+#include <render/shadow_cascades.h>
 
 #include <chrono>
 #include <vector>
@@ -73,6 +76,12 @@ public:
     void loadAnimation(
         std::string const& dir);
 
+    void getAnimTextureListNames(std::vector<std::string>& aNames) const;
+
+    // handles of the light view jobs and the cascade descriptor with their shadow map size, once the renderer has
+    // created its jobs
+    void resolveShadowJobs();
+
     void update();
 
     void verify0(
@@ -107,6 +116,8 @@ protected:
         float fTime,
         uint32_t iStack);
 
+    std::string getAnimBaseModelName(std::string const& databaseName) const;
+
     void updateMeshModelTransforms();
     void updateBall(float fCurrTimeMilliSeconds);
 
@@ -161,6 +172,47 @@ protected:
         float4  mMaxPosition;
     };
 
+    // sections of a loaded <mesh>-triangles.bin, pointing into the file data
+    struct MeshFileSections
+    {
+        void const*     mpTriangleRanges = nullptr;
+        void const*     mpExtents = nullptr;
+        void const*     mpVertices = nullptr;
+        void const*     mpPackedVertices = nullptr;
+        void const*     mpDequantization = nullptr;
+        void const*     mpTriangleIndices = nullptr;
+        void const*     mpMeshlets = nullptr;
+        void const*     mpMeshletRanges = nullptr;
+        void const*     mpLods = nullptr;
+        uint32_t        miNumMeshes = 0;
+        uint32_t        miNumMeshlets = 0;
+        uint32_t        miNumVertices = 0;
+        uint32_t        miNumTriangleIndices = 0;
+    };
+
+    static bool parseChunkedMeshFile(
+        MeshFileSections& sections,
+        char const* acFileData,
+        uint64_t iFileSize);
+
+    static bool parseLegacyMeshFile(
+        MeshFileSections& sections,
+        char const* acFileData,
+        uint64_t iFileSize);
+
+    static void buildMeshMeshlets(
+        std::vector<Render::Meshlet>& aMeshlets,
+        std::vector<MeshTriangleRange>& aMeshletRanges,
+        MeshTriangleRange const* aTriangleRanges,
+        MeshExtent const* aMeshExtents,
+        uint32_t iNumMeshes);
+
+    static void buildMeshLods(
+        std::vector<Render::MeshLod>& aMeshLods,
+        MeshTriangleRange const* aTriangleRanges,
+        MeshTriangleRange const* aMeshletRanges,
+        uint32_t iNumMeshes);
+
     struct ObjectInfo
     {
         uint32_t                            miAnimIndex = UINT32_MAX;
@@ -207,6 +259,13 @@ protected:
     std::map<std::string, wgpu::Buffer>     maBuffers;
     std::map<std::string, uint32_t>         maBufferSizes;
 
+    // renderer handles of the buffers uploaded every frame
+    Render::CRenderer::BufferHandle         miLightingUniformBuffer = Render::CRenderer::kInvalidBufferHandle;
+    Render::CRenderer::BufferHandle         miStaticMeshModelMatrixBuffer = Render::CRenderer::kInvalidBufferHandle;
+    Render::CRenderer::BufferHandle         miMeshCullingUniformBuffer = Render::CRenderer::kInvalidBufferHandle;
+    Render::CRenderer::BufferHandle         miAnimMeshModelUniformBuffer = Render::CRenderer::kInvalidBufferHandle;
+    Render::CRenderer::BufferHandle         miTotalJointAnimationMatrixBuffer = Render::CRenderer::kInvalidBufferHandle;
+
     CreateInfo                              mCreateInfo;
 
     float3                                              mBallPosition;
@@ -246,6 +305,29 @@ protected:
 
     std::map<std::string, float>                        mafAnimTimeMilliSeconds;
 
+    // light view cascades the cached static layers were drawn with and the static meshes culled to them
+    Render::ShadowCascade                               maShadowCascades[3];
+    bool                                                mabShadowCascadesCached[3] = {false, false, false};
+    uint32_t                                            maiNumShadowCascadeMeshes[3] = {0, 0, 0};
+    std::vector<uint8_t>                                mabDynamicMeshes;
+
+    // light view jobs of each cascade, the frame doesn't look them up by name
+    struct ShadowCascadeJobs
+    {
+        Render::CRenderer::JobHandle                    miStatic = Render::CRenderer::kInvalidJobHandle;
+        Render::CRenderer::JobHandle                    miSkinMesh = Render::CRenderer::kInvalidJobHandle;
+        Render::CRenderer::JobHandle                    miDynamic = Render::CRenderer::kInvalidJobHandle;
+        Render::CRenderer::JobHandle                    miComposite = Render::CRenderer::kInvalidJobHandle;
+    };
+    ShadowCascadeJobs                                   maShadowCascadeJobs[3];
+
+    // what the cascades are fit with besides the camera, set with the jobs
+    Render::ShadowCascadeDescriptor                     mShadowCascadeDesc = {};
+
+    // light view jobs of the last frame
+    uint32_t                                            miNumShadowTriangles = 0;
+    uint32_t                                            miNumShadowLayersDrawn = 0;
+
     float                                               mfStartBallSimulationMilliSeconds;
 
     std::vector<std::string>                            maVertexBufferNames;
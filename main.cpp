@@ -9,13 +9,13 @@
 
 #include <render/camera.h>
 #include <render/renderer.h>
+#include <render/dynamic_resolution.h>
 
 #include <utils/LogPrint.h>
 
 //#define TINYEXR_IMPLEMENTATION
 //#include <tinyexr/tinyexr.h>
 
-#include <utils/halton.h>
 #include <utils/blue_noise.h>
 
 #include <math/quaternion.h>
@@ -56,6 +56,12 @@ wgpu::Sampler gSampler;
 wgpu::BindGroup gBindGroup;
 wgpu::BindGroupLayout gBindGroupLayout;
 float4x4                                gPrevViewProjectionMatrix;
+float4x4                                gPrevJitteredViewProjectionMatrix;
+
+// render scale of the g-buffer and lighting jobs from the gpu time, R switches it off and on
+bool                                    gbDynamicResolution = true;
+Render::DynamicResolutionDescriptor     gDynamicResolutionDesc;
+Render::DynamicResolutionState          gDynamicResolutionState;
 
 CApp            gApp;
 
@@ -84,7 +90,6 @@ float gfLastAnimTimeMilliseconds = 0.0f;
 
 std::vector<int32_t> aiHiddenMeshes;
 std::vector<uint32_t> aiVisibilityFlags;
-std::vector<float2> gaHaltonSequence;
 std::vector<float2> gaBlueNoise;
 
 std::vector<std::vector<Joint>> aaJoints;
@@ -308,10 +313,27 @@ void render()
     cameraInfo.mProjectionJitter = float2(0.0f, 0.0f);
     cameraInfo.mUp = float3(0.0f, 1.0f, 0.0f);
 
-    cameraInfo.mProjectionJitter = float2(
-        gaHaltonSequence[gRenderer.getFrameIndex() % 64].x * 0.5f,
-        gaHaltonSequence[gRenderer.getFrameIndex() % 64].y * 0.5f
-    );
+    // the scale of this frame and the jitter in its render pixels
+    float fGPUMilliseconds = gRenderer.getGPUMilliseconds();
+    float fRenderScale = gDynamicResolutionDesc.mfMaxScale;
+    if(gbDynamicResolution)
+    {
+        fRenderScale = Render::updateDynamicResolution(
+            gDynamicResolutionState,
+            gDynamicResolutionDesc,
+            (fGPUMilliseconds > 0.0f) ? fGPUMilliseconds : fElapsedMilliseconds);
+    }
+    gRenderer.setRenderScale(fRenderScale);
+
+    uint2 renderSize = gRenderer.getRenderSize();
+    float afJitter[2];
+    Render::getJitterOffset(
+        afJitter,
+        gRenderer.getFrameIndex(),
+        Render::getJitterPhaseCount(fRenderScale),
+        renderSize.x,
+        renderSize.y);
+    cameraInfo.mProjectionJitter = float2(afJitter[0], afJitter[1]);
 
     gCamera.setLookAt(gCameraLookAt);
     gCamera.setPosition(gCameraPosition);
@@ -339,11 +361,15 @@ void render()
     drawDesc.mpProjectionMatrix = &gCamera.getProjectionMatrix();
     drawDesc.mpViewProjectionMatrix = &gCamera.getViewProjectionMatrix();
     drawDesc.mpPrevViewProjectionMatrix = &gPrevViewProjectionMatrix;
+    drawDesc.mpJitteredViewProjectionMatrix = &gCamera.getJitterViewProjectionMatrix();
+    drawDesc.mpPrevJitteredViewProjectionMatrix = &gPrevJitteredViewProjectionMatrix;
+    drawDesc.mJitter = cameraInfo.mProjectionJitter;
     drawDesc.mpCameraPosition = &gCamera.getPosition();
     drawDesc.mpCameraLookAt = &gCamera.getLookAt();
     gRenderer.draw(drawDesc);
 
     gPrevViewProjectionMatrix = gCamera.getViewProjectionMatrix();
+    gPrevJitteredViewProjectionMatrix = gCamera.getJitterViewProjectionMatrix();
 
     wgpu::SurfaceTexture surfaceTexture;
     surface.GetCurrentTexture(&surfaceTexture);
@@ -393,6 +419,11 @@ void initGraphics()
     desc.mMeshFilePath = "";
     //desc.mRenderJobPipelineFilePath = "render-jobs.json";
     desc.mRenderJobPipelineFilePath = "test-skin-render-jobs.json";
+    desc.mCompiledRenderJobsFilePath = "test-skin-render-jobs.rjb";
+    desc.mCookedTextureAtlasFilePath = "total-texture-atlas.atl";
+    desc.mCookedCompressedTextureAtlasFilePath = "total-texture-atlas-bc7.atl";
+    desc.maTextureListNames.push_back(gApp.maStaticMeshModelNames[0]);
+    gApp.getAnimTextureListNames(desc.maTextureListNames);
     desc.mpSampler = &gSampler;
     gRenderer.setup(desc);
     
@@ -414,12 +445,9 @@ void start()
         return;
     }
 
-    // halton sequence for camera jitters
-    gaHaltonSequence.resize(64);
-    for(uint32_t i = 0; i < 64; i++)
-    {
-        gaHaltonSequence[i] = Utils::get_jitter_offset(i, 1024, 1024);
-    }
+    // room under the 60 hz interval for the submit to done time to vary
+    gDynamicResolutionDesc.mfTargetMilliseconds = 14.0f;
+    Render::resetDynamicResolution(gDynamicResolutionState, gDynamicResolutionDesc);
 
     // blue noise 
     uint32_t iBlueNoiseSize = 32;
@@ -514,6 +542,16 @@ void start()
                 break;
             }
 
+            case GLFW_KEY_R:
+            {
+                // full resolution or the dynamic render scale
+                gbDynamicResolution = !gbDynamicResolution;
+                Render::resetDynamicResolution(gDynamicResolutionState, gDynamicResolutionDesc);
+                DEBUG_PRINTF("dynamic resolution %s\n", gbDynamicResolution ? "on" : "off");
+
+                break;
+            }
+
         }
 
         float3 viewDir = normalize(gCameraLookAt - gCameraPosition);
@@ -625,6 +663,7 @@ void start()
     );
 
     initGraphics();
+    gApp.resolveShadowJobs();
 
     gRenderer.loadTexturesIntoAtlas(
         gApp.maStaticMeshModelNames[0],
@@ -758,11 +797,17 @@ int main()
         printf("waiting...\n");
     }
 
-    wgpu::FeatureName aFeatureNames[] =
+    std::vector<wgpu::FeatureName> aFeatureNames =
     {
         wgpu::FeatureName::IndirectFirstInstance
     };
 
+    // cooked texture atlas is block compressed when this is available
+    if(adapter.HasFeature(wgpu::FeatureName::TextureCompressionBC))
+    {
+        aFeatureNames.push_back(wgpu::FeatureName::TextureCompressionBC);
+    }
+
     static bool bGotDevice;
     bGotDevice = false;
     wgpu::RequiredLimits requiredLimits = {};
@@ -771,8 +816,8 @@ int main()
     requiredLimits.limits.maxColorAttachmentBytesPerSample = 64;
     wgpu::DeviceDescriptor deviceDesc = {};
     deviceDesc.requiredLimits = &requiredLimits;
-    deviceDesc.requiredFeatures = aFeatureNames;
-    deviceDesc.requiredFeatureCount = sizeof(aFeatureNames) / sizeof(*aFeatureNames);
+    deviceDesc.requiredFeatures = aFeatureNames.data();
+    deviceDesc.requiredFeatureCount = aFeatureNames.size();
     adapter.RequestDevice(
         &deviceDesc,
         [](WGPURequestDeviceStatus status,
@@ -842,13 +887,25 @@ int main()
         "allow_unsafe_apis",
         "disable_symbol_renaming"
     };
-    wgpu::FeatureName aFeatureNames[] =
+    std::vector<wgpu::FeatureName> aFeatureNames =
     {
     #if defined(_MSC_VER)
         wgpu::FeatureName::MultiDrawIndirect,
     #endif // _MSC_VER
         wgpu::FeatureName::IndirectFirstInstance
     };
+
+    // cooked texture atlas is block compressed when this is available
+    if(adapter.HasFeature(wgpu::FeatureName::TextureCompressionBC))
+    {
+        aFeatureNames.push_back(wgpu::FeatureName::TextureCompressionBC);
+    }
+
+    // render jobs are recorded on several threads when the device can lock itself
+    if(adapter.HasFeature(wgpu::FeatureName::ImplicitDeviceSynchronization))
+    {
+        aFeatureNames.push_back(wgpu::FeatureName::ImplicitDeviceSynchronization);
+    }
     wgpu::Limits requireLimits = {};
     requireLimits.maxBufferSize = 1000000000;
     requireLimits.maxStorageBufferBindingSize = 1000000000;
@@ -860,8 +917,8 @@ int main()
     toggleDesc.enabledToggleCount = sizeof(aszToggleNames) / sizeof(*aszToggleNames);
     wgpu::DeviceDescriptor deviceDesc = {};
     deviceDesc.nextInChain = &toggleDesc;
-    deviceDesc.requiredFeatures = aFeatureNames;
-    deviceDesc.requiredFeatureCount = sizeof(aFeatureNames) / sizeof(*aFeatureNames);
+    deviceDesc.requiredFeatures = aFeatureNames.data();
+    deviceDesc.requiredFeatureCount = aFeatureNames.size();
     deviceDesc.requiredLimits = &requireLimits;
 
     DEBUG_PRINTF("!!! num feature names: %d !!!\n", deviceDesc.requiredFeatureCount);
@@ -51,14 +51,13 @@ void CCamera::update(CameraUpdateInfo& info)
         mProjectionMatrix = orthographicProjection(fLeft, fRight, fTop, fBottom, fFarMinusNear * 0.5f, -fFarMinusNear * 0.5f);
     }
 
+    // the jitter moves the clip space position by jitter * w, the same offset in ndc at every depth
     float4x4 jitterMatrix = translate(info.mProjectionJitter.x, info.mProjectionJitter.y, 0.0f);
-    mJitterProjectionMatrix = mProjectionMatrix * jitterMatrix;
+    mJitterProjectionMatrix = jitterMatrix * mProjectionMatrix;
 
     mViewProjectionMatrix = mProjectionMatrix * mViewMatrix;
     mJitterViewProjectionMatrix = mJitterProjectionMatrix * mViewMatrix;
 
-mViewProjectionMatrix = mJitterViewProjectionMatrix;
-
     float fAspectRatio = 1.0f;
     float fTan = (float)tan(info.mfFieldOfView * 0.25f);
     float fNearHeight = mfNear * fTan;
@@ -54,6 +54,7 @@ public:
     inline float getFar() const { return mfFar; }
     inline float getNear() const { return mfNear; }
     inline float getFieldOfView() const { return mUpdateInfo.mfFieldOfView; }
+    inline float getAspectRatio() const { return mUpdateInfo.mfViewWidth / mUpdateInfo.mfViewHeight; }
 
     void setLookAt(vec3 const& lookAt) { mLookAt = lookAt; mbDebug = true; }
     void setPosition(vec3 const& position) { mPosition = position; mbDebug = true; }
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+** hierarchical z for the occlusion culling, built by depth-pyramid-compute.shader from the depth of the early
+** deferred pass and read by the late culling jobs
+**
+** the levels are packed one after the other in a float buffer, level 0 is DEPTH_PYRAMID_WIDTH x
+** DEPTH_PYRAMID_HEIGHT over the whole screen whatever its size, every texel is the farthest depth of the pixels it
+** touches and every level halves the one before. a box is occluded when its closest depth is behind the farthest
+** depth of all the texels under its screen rectangle, taken at the finest level where the rectangle spans at most
+** DEPTH_PYRAMID_MAX_FOOTPRINT texels a side. rectangles too big for the coarsest level are never occluded
+**
+** the functions below are the reference for the shaders, matrices are row major with column vectors like
+** computeFrustumPlanes in meshlet.h
+*/
+
+#define DEPTH_PYRAMID_WIDTH                 512
+#define DEPTH_PYRAMID_HEIGHT                256
+#define DEPTH_PYRAMID_NUM_LEVELS            5
+#define DEPTH_PYRAMID_MAX_FOOTPRINT         4
+
+namespace Render
+{
+    /*
+    ** in floats, level DEPTH_PYRAMID_NUM_LEVELS is the size of the whole pyramid
+    */
+    inline uint32_t getDepthPyramidLevelOffset(uint32_t iLevel)
+    {
+        uint32_t iOffset = 0;
+        for(uint32_t i = 0; i < iLevel; i++)
+        {
+            iOffset += (DEPTH_PYRAMID_WIDTH >> i) * (DEPTH_PYRAMID_HEIGHT >> i);
+        }
+
+        return iOffset;
+    }
+
+    /*
+    ** pafDepth is iWidth x iHeight, rows from the top of the screen
+    */
+    inline void buildDepthPyramid(
+        float* pafPyramid,
+        float const* pafDepth,
+        uint32_t iWidth,
+        uint32_t iHeight)
+    {
+        // level 0 texels take every pixel they overlap
+        for(uint32_t iY = 0; iY < DEPTH_PYRAMID_HEIGHT; iY++)
+        {
+            uint32_t iStartY = (iY * iHeight) / DEPTH_PYRAMID_HEIGHT;
+            uint32_t iEndY = ((iY + 1) * iHeight + DEPTH_PYRAMID_HEIGHT - 1) / DEPTH_PYRAMID_HEIGHT;
+            iEndY = (iEndY > iStartY + 1) ? iEndY : iStartY + 1;
+            iEndY = (iEndY < iHeight) ? iEndY : iHeight;
+            for(uint32_t iX = 0; iX < DEPTH_PYRAMID_WIDTH; iX++)
+            {
+                uint32_t iStartX = (iX * iWidth) / DEPTH_PYRAMID_WIDTH;
+                uint32_t iEndX = ((iX + 1) * iWidth + DEPTH_PYRAMID_WIDTH - 1) / DEPTH_PYRAMID_WIDTH;
+                iEndX = (iEndX > iStartX + 1) ? iEndX : iStartX + 1;
+                iEndX = (iEndX < iWidth) ? iEndX : iWidth;
+
+                float fMaxDepth = 0.0f;
+                for(uint32_t iPixelY = iStartY; iPixelY < iEndY; iPixelY++)
+                {
+                    for(uint32_t iPixelX = iStartX; iPixelX < iEndX; iPixelX++)
+                    {
+                        float fDepth = pafDepth[iPixelY * iWidth + iPixelX];
+                        fMaxDepth = (fDepth > fMaxDepth) ? fDepth : fMaxDepth;
+                    }
+                }
+
+                pafPyramid[iY * DEPTH_PYRAMID_WIDTH + iX] = fMaxDepth;
+            }
+        }
+
+        for(uint32_t iLevel = 1; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+        {
+            float const* pafPrevLevel = pafPyramid + getDepthPyramidLevelOffset(iLevel - 1);
+            float* pafLevel = pafPyramid + getDepthPyramidLevelOffset(iLevel);
+            uint32_t iPrevLevelWidth = DEPTH_PYRAMID_WIDTH >> (iLevel - 1);
+            uint32_t iLevelWidth = DEPTH_PYRAMID_WIDTH >> iLevel;
+            uint32_t iLevelHeight = DEPTH_PYRAMID_HEIGHT >> iLevel;
+            for(uint32_t iY = 0; iY < iLevelHeight; iY++)
+            {
+                for(uint32_t iX = 0; iX < iLevelWidth; iX++)
+                {
+                    float const* pfPrev = pafPrevLevel + iY * 2 * iPrevLevelWidth + iX * 2;
+                    float fMaxDepth = (pfPrev[0] > pfPrev[1]) ? pfPrev[0] : pfPrev[1];
+                    fMaxDepth = (pfPrev[iPrevLevelWidth] > fMaxDepth) ? pfPrev[iPrevLevelWidth] : fMaxDepth;
+                    fMaxDepth = (pfPrev[iPrevLevelWidth + 1] > fMaxDepth) ? pfPrev[iPrevLevelWidth + 1] : fMaxDepth;
+                    pafLevel[iY * iLevelWidth + iX] = fMaxDepth;
+                }
+            }
+        }
+    }
+
+    /*
+    ** world space box, boxes crossing the near plane or off the screen are left to the frustum test
+    */
+    inline bool isBoxOccluded(
+        float const* pafPyramid,
+        float const* pfMinPosition,
+        float const* pfMaxPosition,
+        float const* pafViewProjection)
+    {
+        float afMinUVZ[3] = {1.0e30f, 1.0e30f, 1.0e30f};
+        float afMaxUV[2] = {-1.0e30f, -1.0e30f};
+        for(uint32_t iCorner = 0; iCorner < 8; iCorner++)
+        {
+            float afCorner[4] =
+            {
+                (iCorner & 1) ? pfMaxPosition[0] : pfMinPosition[0],
+                (iCorner & 2) ? pfMaxPosition[1] : pfMinPosition[1],
+                (iCorner & 4) ? pfMaxPosition[2] : pfMinPosition[2],
+                1.0f,
+            };
+
+            float afClipSpace[4];
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                float const* pafRow = pafViewProjection + i * 4;
+                afClipSpace[i] = pafRow[0] * afCorner[0] + pafRow[1] * afCorner[1] + pafRow[2] * afCorner[2] + pafRow[3];
+            }
+
+            if(afClipSpace[3] <= 1.0e-5f)
+            {
+                return false;
+            }
+
+            float afUVZ[3] =
+            {
+                (afClipSpace[0] / afClipSpace[3]) * 0.5f + 0.5f,
+                0.5f - (afClipSpace[1] / afClipSpace[3]) * 0.5f,
+                afClipSpace[2] / afClipSpace[3],
+            };
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                afMinUVZ[i] = (afUVZ[i] < afMinUVZ[i]) ? afUVZ[i] : afMinUVZ[i];
+            }
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                afMaxUV[i] = (afUVZ[i] > afMaxUV[i]) ? afUVZ[i] : afMaxUV[i];
+            }
+        }
+
+        if(afMinUVZ[2] <= 0.0f || afMaxUV[0] < 0.0f || afMaxUV[1] < 0.0f || afMinUVZ[0] > 1.0f || afMinUVZ[1] > 1.0f)
+        {
+            return false;
+        }
+
+        uint32_t const aiSize[2] = {DEPTH_PYRAMID_WIDTH, DEPTH_PYRAMID_HEIGHT};
+        uint32_t aiMinTexel[2], aiMaxTexel[2];
+        for(uint32_t i = 0; i < 2; i++)
+        {
+            float fMin = (afMinUVZ[i] > 0.0f) ? afMinUVZ[i] : 0.0f;
+            float fMax = (afMaxUV[i] < 1.0f) ? afMaxUV[i] : 1.0f;
+            aiMinTexel[i] = (uint32_t)(fMin * (float)aiSize[i]);
+            aiMaxTexel[i] = (uint32_t)(fMax * (float)aiSize[i]);
+            aiMinTexel[i] = (aiMinTexel[i] < aiSize[i] - 1) ? aiMinTexel[i] : aiSize[i] - 1;
+            aiMaxTexel[i] = (aiMaxTexel[i] < aiSize[i] - 1) ? aiMaxTexel[i] : aiSize[i] - 1;
+        }
+
+        for(uint32_t iLevel = 0; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+        {
+            uint32_t iMinX = aiMinTexel[0] >> iLevel, iMaxX = aiMaxTexel[0] >> iLevel;
+            uint32_t iMinY = aiMinTexel[1] >> iLevel, iMaxY = aiMaxTexel[1] >> iLevel;
+            if(iMaxX - iMinX >= DEPTH_PYRAMID_MAX_FOOTPRINT || iMaxY - iMinY >= DEPTH_PYRAMID_MAX_FOOTPRINT)
+            {
+                continue;
+            }
+
+            float const* pafLevel = pafPyramid + getDepthPyramidLevelOffset(iLevel);
+            uint32_t iLevelWidth = DEPTH_PYRAMID_WIDTH >> iLevel;
+            float fMaxDepth = 0.0f;
+            for(uint32_t iY = iMinY; iY <= iMaxY; iY++)
+            {
+                for(uint32_t iX = iMinX; iX <= iMaxX; iX++)
+                {
+                    float fDepth = pafLevel[iY * iLevelWidth + iX];
+                    fMaxDepth = (fDepth > fMaxDepth) ? fDepth : fMaxDepth;
+                }
+            }
+
+            return (afMinUVZ[2] > fMaxDepth);
+        }
+
+        return false;
+    }
+
+}   // Render
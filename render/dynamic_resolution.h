@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+** dynamic resolution, the jobs flagged "Dynamic Resolution" in the job list render into the top left render scale
+** part of their outputs and the taa job reconstructs the output resolution from them
+**
+** the scale follows the frame time: an average of the frame times is kept, over mfUpperThreshold of the target the
+** scale drops to where the resolution dependent time is expected to fit (it goes with the pixel count, the square of
+** the scale), under mfLowerThreshold it goes up a step. the scale is a multiple of mfScaleStep and waits
+** miSettleFrames after a change, the average starts over from the expected time at the new scale
+**
+** the camera is jittered by the halton (2, 3) sequence in the render target's pixels, like Utils::get_jitter_offset,
+** with more phases at lower scales so every output pixel still gets samples. index 0 of the sequence is skipped, it's
+** the pixel's corner
+**
+** the functions below are the reference the tools check
+*/
+
+#define DYNAMIC_RESOLUTION_MIN_JITTER_PHASES    8
+#define DYNAMIC_RESOLUTION_MAX_JITTER_PHASES    64
+
+namespace Render
+{
+    struct DynamicResolutionDescriptor
+    {
+        float               mfTargetMilliseconds = 16.6667f;
+        float               mfMinScale = 0.5f;
+        float               mfMaxScale = 1.0f;
+        float               mfScaleStep = 0.0625f;
+        float               mfLowerThreshold = 0.8f;        // of the target
+        float               mfUpperThreshold = 1.05f;
+        float               mfSmoothing = 0.1f;             // weight of a frame in the average
+        uint32_t            miSettleFrames = 30;
+    };
+
+    struct DynamicResolutionState
+    {
+        float               mfScale = 1.0f;
+        float               mfAverageMilliseconds = 0.0f;
+        uint32_t            miFramesSinceChange = 0;
+        uint32_t            miNumChanges = 0;
+    };
+
+    /*
+    **
+    */
+    inline void resetDynamicResolution(
+        DynamicResolutionState& state,
+        DynamicResolutionDescriptor const& desc)
+    {
+        state.mfScale = desc.mfMaxScale;
+        state.mfAverageMilliseconds = desc.mfTargetMilliseconds;
+        state.miFramesSinceChange = 0;
+        state.miNumChanges = 0;
+    }
+
+    /*
+    ** fScale rounded down to a step between the minimum and the maximum scale
+    */
+    inline float quantizeRenderScale(
+        float fScale,
+        DynamicResolutionDescriptor const& desc)
+    {
+        float fQuantized = floorf(fScale / desc.mfScaleStep + 1.0e-3f) * desc.mfScaleStep;
+        fQuantized = (fQuantized < desc.mfMaxScale) ? fQuantized : desc.mfMaxScale;
+        return (fQuantized > desc.mfMinScale) ? fQuantized : desc.mfMinScale;
+    }
+
+    /*
+    ** returns the scale of the next frame
+    */
+    inline float updateDynamicResolution(
+        DynamicResolutionState& state,
+        DynamicResolutionDescriptor const& desc,
+        float fFrameMilliseconds)
+    {
+        state.mfAverageMilliseconds += (fFrameMilliseconds - state.mfAverageMilliseconds) * desc.mfSmoothing;
+        if(++state.miFramesSinceChange < desc.miSettleFrames)
+        {
+            return state.mfScale;
+        }
+
+        float fScale = state.mfScale;
+        if(state.mfAverageMilliseconds > desc.mfTargetMilliseconds * desc.mfUpperThreshold)
+        {
+            fScale = quantizeRenderScale(fScale * sqrtf(desc.mfTargetMilliseconds / state.mfAverageMilliseconds), desc);
+            fScale = (fScale < state.mfScale) ? fScale : quantizeRenderScale(state.mfScale - desc.mfScaleStep, desc);
+        }
+        else if(state.mfAverageMilliseconds < desc.mfTargetMilliseconds * desc.mfLowerThreshold)
+        {
+            fScale = quantizeRenderScale(state.mfScale + desc.mfScaleStep, desc);
+        }
+
+        if(fScale != state.mfScale)
+        {
+            float fPixelRatio = (fScale * fScale) / (state.mfScale * state.mfScale);
+            state.mfAverageMilliseconds *= fPixelRatio;
+            state.mfScale = fScale;
+            state.miFramesSinceChange = 0;
+            ++state.miNumChanges;
+        }
+
+        return state.mfScale;
+    }
+
+    /*
+    ** of an output of iWidth x iHeight, at least a pixel
+    */
+    inline void getRenderSize(
+        uint32_t* piRenderSize,
+        uint32_t iWidth,
+        uint32_t iHeight,
+        float fScale)
+    {
+        uint32_t iRenderWidth = (uint32_t)((float)iWidth * fScale + 0.5f);
+        uint32_t iRenderHeight = (uint32_t)((float)iHeight * fScale + 0.5f);
+        piRenderSize[0] = (iRenderWidth < iWidth) ? ((iRenderWidth > 0) ? iRenderWidth : 1) : iWidth;
+        piRenderSize[1] = (iRenderHeight < iHeight) ? ((iRenderHeight > 0) ? iRenderHeight : 1) : iHeight;
+    }
+
+    /*
+    ** 8 phases at full resolution and 8 over the square of the scale below, the number of render pixels an output
+    ** pixel is covered by
+    */
+    inline uint32_t getJitterPhaseCount(float fScale)
+    {
+        uint32_t iNumPhases = (uint32_t)ceilf((float)DYNAMIC_RESOLUTION_MIN_JITTER_PHASES / (fScale * fScale) - 1.0e-3f);
+        iNumPhases = (iNumPhases > DYNAMIC_RESOLUTION_MIN_JITTER_PHASES) ? iNumPhases : DYNAMIC_RESOLUTION_MIN_JITTER_PHASES;
+        return (iNumPhases < DYNAMIC_RESOLUTION_MAX_JITTER_PHASES) ? iNumPhases : DYNAMIC_RESOLUTION_MAX_JITTER_PHASES;
+    }
+
+    /*
+    ** radical inverse of iIndex in iBase
+    */
+    inline float getHaltonSample(
+        uint32_t iIndex,
+        uint32_t iBase)
+    {
+        float fFraction = 1.0f;
+        float fResult = 0.0f;
+        while(iIndex > 0)
+        {
+            fFraction /= (float)iBase;
+            fResult += fFraction * (float)(iIndex % iBase);
+            iIndex /= iBase;
+        }
+
+        return fResult;
+    }
+
+    /*
+    ** clip space offset of the projection, within half a render pixel of the pixel center
+    */
+    inline void getJitterOffset(
+        float* pfJitter,
+        uint32_t iFrame,
+        uint32_t iNumPhases,
+        uint32_t iRenderWidth,
+        uint32_t iRenderHeight)
+    {
+        uint32_t iIndex = (iFrame % iNumPhases) + 1;
+        pfJitter[0] = (getHaltonSample(iIndex, 2) - 0.5f) * 2.0f / (float)iRenderWidth;
+        pfJitter[1] = (getHaltonSample(iIndex, 3) - 0.5f) * 2.0f / (float)iRenderHeight;
+    }
+
+}   // Render
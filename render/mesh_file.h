@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+** chunked mesh container, written by tools/obj_2_binary as <mesh>-triangles.bin and read by CApp::loadMeshes
+**
+** MeshFileHeader
+** MeshFileChunk[miNumChunks]   table of contents
+** chunk data, each chunk at an offset aligned to its miAlignment, zero padded up to the next one
+**
+** chunks that go to the gpu as is (vertices, indices) are 256 byte aligned so they can be uploaded with WriteBuffer
+** straight out of the loaded file, everything else is 16 byte aligned. readers skip chunk types they don't know,
+** new chunks can be added without bumping the version. files without the signature are the legacy layout:
+** 5 uint32 header, triangle ranges, extents, vertices and indices back to back
+*/
+
+#define MESH_FILE_FOURCC(A, B, C, D)        ((uint32_t)(A) | ((uint32_t)(B) << 8) | ((uint32_t)(C) << 16) | ((uint32_t)(D) << 24))
+
+#define MESH_FILE_SIGNATURE                 MESH_FILE_FOURCC('M', 'E', 'S', 'H')
+#define MESH_FILE_VERSION                   1
+#define MESH_FILE_CHUNK_ALIGNMENT           16
+#define MESH_FILE_GPU_CHUNK_ALIGNMENT       256
+
+namespace Render
+{
+    enum MeshFileChunkType : uint32_t
+    {
+        MESH_FILE_CHUNK_TRIANGLE_RANGES     = MESH_FILE_FOURCC('R', 'N', 'G', 'E'),     // uint2 [start, end) into the indices per mesh
+        MESH_FILE_CHUNK_EXTENTS             = MESH_FILE_FOURCC('E', 'X', 'T', 'N'),     // min/max float4 per mesh, the last one is the whole model
+        MESH_FILE_CHUNK_VERTICES            = MESH_FILE_FOURCC('V', 'E', 'R', 'T'),     // position, uv, normal float4 per vertex
+        MESH_FILE_CHUNK_INDICES             = MESH_FILE_FOURCC('I', 'N', 'D', 'X'),     // uint32 triangle indices of all the meshes
+        MESH_FILE_CHUNK_PACKED_VERTICES     = MESH_FILE_FOURCC('P', 'V', 'T', 'X'),     // PackedVertex per vertex, replaces VERT
+        MESH_FILE_CHUNK_DEQUANTIZATION      = MESH_FILE_FOURCC('D', 'Q', 'N', 'T'),     // VertexDequantization per mesh for PVTX
+        MESH_FILE_CHUNK_MESHLETS            = MESH_FILE_FOURCC('M', 'L', 'E', 'T'),     // Meshlet, each mesh's in the order of its triangles
+        MESH_FILE_CHUNK_MESHLET_RANGES      = MESH_FILE_FOURCC('M', 'L', 'R', 'G'),     // uint2 [start, end) into the meshlets per mesh
+        MESH_FILE_CHUNK_LODS                = MESH_FILE_FOURCC('L', 'O', 'D', 'S'),     // MESH_MAX_LODS MeshLod per mesh, see mesh_lod.h
+    };
+
+    struct MeshFileHeader
+    {
+        uint32_t            miSignature;
+        uint32_t            miVersion;
+        uint32_t            miNumChunks;
+        uint32_t            miTableChecksum;        // over the MeshFileChunk table
+        uint64_t            miFileSize;
+    };
+
+    struct MeshFileChunk
+    {
+        uint32_t            miType;
+        uint32_t            miAlignment;
+        uint32_t            miElementSize;
+        uint32_t            miNumElements;
+        uint64_t            miOffset;               // from the start of the file
+        uint64_t            miSize;                 // miElementSize * miNumElements, without the padding
+        uint32_t            miChecksum;
+        uint32_t            miPadding;
+    };
+
+    /*
+    ** fnv-1a over 4 byte words with a fold of the high bits, then the remaining bytes
+    */
+    inline uint32_t computeMeshFileChecksum(
+        void const* pData,
+        uint64_t iSize)
+    {
+        uint8_t const* pacData = (uint8_t const*)pData;
+        uint32_t iHash = 0x811c9dc5u;
+        uint64_t iNumWords = iSize / sizeof(uint32_t);
+        for(uint64_t i = 0; i < iNumWords; i++)
+        {
+            uint32_t iWord = 0;
+            memcpy(&iWord, pacData + i * sizeof(uint32_t), sizeof(uint32_t));
+            iHash = (iHash ^ iWord) * 0x01000193u;
+            iHash ^= (iHash >> 16);
+        }
+
+        for(uint64_t i = iNumWords * sizeof(uint32_t); i < iSize; i++)
+        {
+            iHash = (iHash ^ (uint32_t)pacData[i]) * 0x01000193u;
+        }
+
+        return iHash;
+    }
+
+}   // Render
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+** levels of detail of the static meshes, written by tools/obj_2_binary in the LODS chunk, MESH_MAX_LODS entries per
+** mesh from the full mesh to the coarsest one. coarser levels are simplified index lists over the same vertices,
+** their indices go after the full meshes' in the INDX chunk and their meshlets after the full meshes' in MLET.
+** meshes with fewer levels repeat their last one
+**
+** mfError is the simplifier's error in model space units, the largest distance a surface moved. the culling shaders
+** pick the coarsest level whose error projects to at most MESH_LOD_PIXEL_ERROR pixels, selectMeshLod is the reference
+*/
+
+#define MESH_MAX_LODS                       4
+#define MESH_LOD_PIXEL_ERROR                1.0f
+
+namespace Render
+{
+    struct MeshLod
+    {
+        uint32_t            miIndexStart;           // into the INDX chunk
+        uint32_t            miNumIndices;
+        uint32_t            miMeshletStart;         // [start, end) into the MLET chunk
+        uint32_t            miMeshletEnd;
+        float               mfError;
+        uint32_t            maiPadding[3];
+    };
+
+    static_assert(sizeof(MeshLod) == 32, "MeshLod is read as an array by the culling shaders");
+
+    /*
+    ** fProjectionScale: pixels per unit at distance 1, half the screen height times the projection's y scale.
+    ** fDistance is from the camera to the closest point of the instance's bounding sphere
+    */
+    inline uint32_t selectMeshLod(
+        MeshLod const* aLods,
+        float fDistance,
+        float fScale,
+        float fProjectionScale,
+        float fMaxPixelError = MESH_LOD_PIXEL_ERROR)
+    {
+        fDistance = (fDistance > 1.0e-4f) ? fDistance : 1.0e-4f;
+        float fPixelsPerUnit = fScale * fProjectionScale / fDistance;
+
+        uint32_t iLod = 0;
+        for(uint32_t i = 1; i < MESH_MAX_LODS; i++)
+        {
+            if(aLods[i].mfError * fPixelsPerUnit <= fMaxPixelError)
+            {
+                iLod = i;
+            }
+        }
+
+        return iLod;
+    }
+
+}   // Render
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+** clusters of the static meshes, written by tools/obj_2_binary in the MLET chunk and culled by
+** cluster-culling-compute.shader
+**
+** a meshlet is a contiguous run of at most MESHLET_MAX_TRIANGLES of its mesh's triangles in the INDX chunk,
+** referencing at most MESHLET_MAX_VERTICES vertices, so a visible meshlet is drawn straight out of the mesh's
+** index buffer. bounds are in model space: a sphere around the vertices and a cone around the triangle normals
+** with its apex behind every triangle. all of a meshlet's triangles face away from a camera at p when
+** dot(normalize(apex - p), axis) >= cutoff, a cutoff of 1 or more never culls
+**
+** the tests below are the reference for the shader, planes are the ones mesh-culling-compute.shader uses
+*/
+
+#define MESHLET_MAX_VERTICES                64
+#define MESHLET_MAX_TRIANGLES               124
+#define MESHLET_NUM_FRUSTUM_PLANES          5
+
+namespace Render
+{
+    struct Meshlet
+    {
+        float               mafSphere[4];           // center, radius
+        float               mafConeApex[4];         // w unused
+        float               mafConeAxis[4];         // axis, cutoff in w
+        uint32_t            miMesh;
+        uint32_t            miIndexStart;           // into the INDX chunk
+        uint32_t            miNumTriangles;
+        uint32_t            miNumVertices;
+    };
+
+    static_assert(sizeof(Meshlet) == 64, "Meshlet is read as an array by cluster-culling-compute.shader");
+
+    /*
+    ** left, right, bottom, top and near from the rows of a column vector view projection matrix, normalized
+    */
+    inline void computeFrustumPlanes(
+        float (*pafPlanes)[4],
+        float const* pafViewProjection)
+    {
+        float const* pafLastRow = pafViewProjection + 12;
+        for(uint32_t iPlane = 0; iPlane < MESHLET_NUM_FRUSTUM_PLANES; iPlane++)
+        {
+            float const* pafRow = pafViewProjection + (iPlane >> 1) * 4;
+            float fMult = (iPlane & 1) ? -1.0f : 1.0f;
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                pafPlanes[iPlane][i] = pafRow[i] * fMult + pafLastRow[i];
+            }
+
+            float fLength = sqrtf(pafPlanes[iPlane][0] * pafPlanes[iPlane][0] + pafPlanes[iPlane][1] * pafPlanes[iPlane][1] + pafPlanes[iPlane][2] * pafPlanes[iPlane][2]);
+            float fOneOverLength = 1.0f / (fLength + 0.00001f);
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                pafPlanes[iPlane][i] *= fOneOverLength;
+            }
+        }
+    }
+
+    /*
+    ** sphere entirely behind one of the planes
+    */
+    inline bool isSphereOutsideFrustum(
+        float const* pfSphere,
+        float const (*pafPlanes)[4])
+    {
+        for(uint32_t iPlane = 0; iPlane < MESHLET_NUM_FRUSTUM_PLANES; iPlane++)
+        {
+            float fDistance = pafPlanes[iPlane][0] * pfSphere[0] + pafPlanes[iPlane][1] * pfSphere[1] + pafPlanes[iPlane][2] * pfSphere[2] + pafPlanes[iPlane][3];
+            if(fDistance < -pfSphere[3])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+    **
+    */
+    inline bool isMeshletBackFacing(
+        Meshlet const& meshlet,
+        float const* pfCameraPosition)
+    {
+        float fCutoff = meshlet.mafConeAxis[3];
+        if(fCutoff >= 1.0f)
+        {
+            return false;
+        }
+
+        float afDirection[3] =
+        {
+            meshlet.mafConeApex[0] - pfCameraPosition[0],
+            meshlet.mafConeApex[1] - pfCameraPosition[1],
+            meshlet.mafConeApex[2] - pfCameraPosition[2],
+        };
+        float fLength = sqrtf(afDirection[0] * afDirection[0] + afDirection[1] * afDirection[1] + afDirection[2] * afDirection[2]);
+        float fDP = afDirection[0] * meshlet.mafConeAxis[0] + afDirection[1] * meshlet.mafConeAxis[1] + afDirection[2] * meshlet.mafConeAxis[2];
+
+        return (fDP >= fCutoff * fLength);
+    }
+
+    /*
+    ** bCullBackFacing only for passes that cull back faces, the cone says nothing about double sided triangles
+    */
+    inline bool cullMeshlet(
+        Meshlet const& meshlet,
+        float const (*pafPlanes)[4],
+        float const* pfCameraPosition,
+        bool bCullBackFacing)
+    {
+        if(isSphereOutsideFrustum(meshlet.mafSphere, pafPlanes))
+        {
+            return true;
+        }
+
+        return (bCullBackFacing && isMeshletBackFacing(meshlet, pfCameraPosition));
+    }
+
+}   // Render
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/*
+** 16 byte vertex for the static and skinned mesh vertex buffers, replaces the 48 byte Vertex on the gpu
+**
+** position     uint16 x 3, quantized over the mesh extent, dequantized with the mesh's VertexDequantization
+** mesh index   uint16, what Vertex kept in position.w and uv.z
+** uv           half float x 2
+** normal       octahedral, snorm16 x 2
+**
+** the skin mesh compute shader reads PackedVertex and writes SkinnedVertex, positions stay float there because
+** the animated positions have no fixed extent. encode and decode are plain functions without gpu dependencies,
+** the shaders decode the same way. the error bounds hold for every vertex that goes through packVertex and
+** unpackVertex: position per axis, distance between the unit normals, uv per component
+*/
+
+#define PACKED_VERTEX_POSITION_STEPS            65535.0f
+#define PACKED_VERTEX_SNORM_STEPS               32767.0f
+#define PACKED_VERTEX_MAX_MESHES                65536
+#define PACKED_VERTEX_HALF_MAX                  65504.0f
+#define PACKED_VERTEX_NORMAL_ERROR_BOUND        1.0e-4f
+
+namespace Render
+{
+    struct PackedVertex
+    {
+        uint16_t            maiPosition[3];
+        uint16_t            miMesh;
+        uint16_t            maiTexCoord[2];
+        int16_t             maiNormal[2];
+    };
+
+    // position = offset + quantized * scale, one per mesh
+    struct VertexDequantization
+    {
+        float               mafOffset[4];
+        float               mafScale[4];
+    };
+
+    // output of skin-mesh-compute.shader
+    struct SkinnedVertex
+    {
+        float               mafPosition[3];
+        int16_t             maiNormal[2];
+        uint16_t            maiTexCoord[2];
+    };
+
+    static_assert(sizeof(PackedVertex) == 16, "PackedVertex has to match the vertex layout in the render jobs");
+    static_assert(sizeof(VertexDequantization) == 32, "VertexDequantization is read as an array by the shaders");
+    static_assert(sizeof(SkinnedVertex) == 20, "SkinnedVertex has to match the vertex layout in the render jobs");
+
+    /*
+    **
+    */
+    inline void computeVertexDequantization(
+        VertexDequantization& dequantization,
+        float const* pfMinPosition,
+        float const* pfMaxPosition)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            dequantization.mafOffset[i] = pfMinPosition[i];
+            dequantization.mafScale[i] = (pfMaxPosition[i] > pfMinPosition[i]) ? (pfMaxPosition[i] - pfMinPosition[i]) / PACKED_VERTEX_POSITION_STEPS : 0.0f;
+        }
+        dequantization.mafOffset[3] = 0.0f;
+        dequantization.mafScale[3] = 0.0f;
+    }
+
+    /*
+    ** round to nearest even, out of range values clamp to the largest half
+    */
+    inline uint16_t floatToHalf(float fValue)
+    {
+        if(fValue != fValue)
+        {
+            return 0x7e00;
+        }
+        fValue = (fValue > PACKED_VERTEX_HALF_MAX) ? PACKED_VERTEX_HALF_MAX : ((fValue < -PACKED_VERTEX_HALF_MAX) ? -PACKED_VERTEX_HALF_MAX : fValue);
+
+        uint32_t iBits = 0;
+        memcpy(&iBits, &fValue, sizeof(float));
+        uint32_t iSign = (iBits >> 16) & 0x8000;
+        int32_t iExponent = (int32_t)((iBits >> 23) & 0xff) - 127 + 15;
+        uint32_t iMantissa = iBits & 0x7fffff;
+
+        if(iExponent <= 0)
+        {
+            // subnormal half, anything below half of the smallest one is 0
+            if(iExponent < -10)
+            {
+                return (uint16_t)iSign;
+            }
+
+            iMantissa |= 0x800000;
+            uint32_t iShift = (uint32_t)(14 - iExponent);
+            uint32_t iHalf = iMantissa >> iShift;
+            uint32_t iRemainder = iMantissa & ((1u << iShift) - 1);
+            uint32_t iHalfway = 1u << (iShift - 1);
+            if(iRemainder > iHalfway || (iRemainder == iHalfway && (iHalf & 1)))
+            {
+                ++iHalf;
+            }
+
+            return (uint16_t)(iSign | iHalf);
+        }
+
+        // a carry out of the mantissa bumps the exponent, which is the correctly rounded result
+        uint32_t iHalf = iSign | ((uint32_t)iExponent << 10) | (iMantissa >> 13);
+        uint32_t iRemainder = iMantissa & 0x1fff;
+        if(iRemainder > 0x1000 || (iRemainder == 0x1000 && (iHalf & 1)))
+        {
+            ++iHalf;
+        }
+
+        return (uint16_t)iHalf;
+    }
+
+    /*
+    **
+    */
+    inline float halfToFloat(uint16_t iHalf)
+    {
+        uint32_t iSign = ((uint32_t)iHalf & 0x8000) << 16;
+        uint32_t iExponent = ((uint32_t)iHalf >> 10) & 0x1f;
+        uint32_t iMantissa = (uint32_t)iHalf & 0x3ff;
+
+        uint32_t iBits = 0;
+        if(iExponent == 0)
+        {
+            float fValue = (float)iMantissa * (1.0f / 16777216.0f);
+            return iSign ? -fValue : fValue;
+        }
+        else if(iExponent == 31)
+        {
+            iBits = iSign | 0x7f800000 | (iMantissa << 13);
+        }
+        else
+        {
+            iBits = iSign | ((iExponent + 112) << 23) | (iMantissa << 13);
+        }
+
+        float fValue = 0.0f;
+        memcpy(&fValue, &iBits, sizeof(float));
+        return fValue;
+    }
+
+    /*
+    **
+    */
+    inline int16_t floatToSnorm16(float fValue)
+    {
+        fValue = (fValue > 1.0f) ? 1.0f : ((fValue < -1.0f) ? -1.0f : fValue);
+        return (int16_t)lroundf(fValue * PACKED_VERTEX_SNORM_STEPS);
+    }
+
+    /*
+    ** same as webgpu's snorm16 vertex format
+    */
+    inline float snorm16ToFloat(int16_t iValue)
+    {
+        float fValue = (float)iValue / PACKED_VERTEX_SNORM_STEPS;
+        return (fValue < -1.0f) ? -1.0f : fValue;
+    }
+
+    /*
+    ** project onto the octahedron, fold the lower half over the diagonals
+    */
+    inline void encodeOctahedralNormal(
+        int16_t* paiEncoded,
+        float const* pfNormal)
+    {
+        float fL1 = fabsf(pfNormal[0]) + fabsf(pfNormal[1]) + fabsf(pfNormal[2]);
+        if(fL1 <= 0.0f)
+        {
+            paiEncoded[0] = paiEncoded[1] = 0;
+            return;
+        }
+
+        float fU = pfNormal[0] / fL1;
+        float fV = pfNormal[1] / fL1;
+        if(pfNormal[2] < 0.0f)
+        {
+            float fFoldedU = (1.0f - fabsf(fV)) * ((fU >= 0.0f) ? 1.0f : -1.0f);
+            float fFoldedV = (1.0f - fabsf(fU)) * ((fV >= 0.0f) ? 1.0f : -1.0f);
+            fU = fFoldedU;
+            fV = fFoldedV;
+        }
+
+        paiEncoded[0] = floatToSnorm16(fU);
+        paiEncoded[1] = floatToSnorm16(fV);
+    }
+
+    /*
+    ** matches decodeOctahedralNormal in the shaders
+    */
+    inline void decodeOctahedralNormal(
+        float* pfNormal,
+        int16_t const* paiEncoded)
+    {
+        float fX = snorm16ToFloat(paiEncoded[0]);
+        float fY = snorm16ToFloat(paiEncoded[1]);
+        float fZ = 1.0f - fabsf(fX) - fabsf(fY);
+        float fT = (-fZ > 0.0f) ? -fZ : 0.0f;
+        fX += (fX >= 0.0f) ? -fT : fT;
+        fY += (fY >= 0.0f) ? -fT : fT;
+
+        float fLength = sqrtf(fX * fX + fY * fY + fZ * fZ);
+        pfNormal[0] = fX / fLength;
+        pfNormal[1] = fY / fLength;
+        pfNormal[2] = fZ / fLength;
+    }
+
+    /*
+    **
+    */
+    inline void packVertex(
+        PackedVertex& vertex,
+        float const* pfPosition,
+        float const* pfTexCoord,
+        float const* pfNormal,
+        uint32_t iMesh,
+        VertexDequantization const& dequantization)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            float fQuantized = 0.0f;
+            if(dequantization.mafScale[i] > 0.0f)
+            {
+                fQuantized = (pfPosition[i] - dequantization.mafOffset[i]) / dequantization.mafScale[i];
+                fQuantized = (fQuantized < 0.0f) ? 0.0f : ((fQuantized > PACKED_VERTEX_POSITION_STEPS) ? PACKED_VERTEX_POSITION_STEPS : fQuantized);
+            }
+            vertex.maiPosition[i] = (uint16_t)lroundf(fQuantized);
+        }
+
+        vertex.miMesh = (uint16_t)iMesh;
+        vertex.maiTexCoord[0] = floatToHalf(pfTexCoord[0]);
+        vertex.maiTexCoord[1] = floatToHalf(pfTexCoord[1]);
+        encodeOctahedralNormal(vertex.maiNormal, pfNormal);
+    }
+
+    /*
+    **
+    */
+    inline void unpackVertex(
+        float* pfPosition,
+        float* pfTexCoord,
+        float* pfNormal,
+        uint32_t& iMesh,
+        PackedVertex const& vertex,
+        VertexDequantization const& dequantization)
+    {
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            pfPosition[i] = dequantization.mafOffset[i] + (float)vertex.maiPosition[i] * dequantization.mafScale[i];
+        }
+
+        iMesh = vertex.miMesh;
+        pfTexCoord[0] = halfToFloat(vertex.maiTexCoord[0]);
+        pfTexCoord[1] = halfToFloat(vertex.maiTexCoord[1]);
+        decodeOctahedralNormal(pfNormal, vertex.maiNormal);
+    }
+
+    /*
+    ** half a quantization step, plus the float rounding of offset + quantized * scale
+    */
+    inline float getPackedPositionErrorBound(
+        VertexDequantization const& dequantization,
+        uint32_t iAxis)
+    {
+        float fMagnitude = fabsf(dequantization.mafOffset[iAxis]) + dequantization.mafScale[iAxis] * PACKED_VERTEX_POSITION_STEPS;
+        return dequantization.mafScale[iAxis] * 0.5f + fMagnitude * 4.0f * 1.1920929e-7f;
+    }
+
+    /*
+    ** half of the spacing between halfs around the value, uvs past the half range are clamped
+    */
+    inline float getPackedTexCoordErrorBound(float fTexCoord)
+    {
+        float fMagnitude = fabsf(fTexCoord);
+        if(fMagnitude > PACKED_VERTEX_HALF_MAX)
+        {
+            return fMagnitude - PACKED_VERTEX_HALF_MAX;
+        }
+
+        return fMagnitude * (1.0f / 2048.0f) + (1.0f / 33554432.0f);
+    }
+
+}   // Render
@@ -0,0 +1,761 @@
+#include <render/pipeline_cache.h>
+
+#include <utils/LogPrint.h>
+
+#include <assert.h>
+#include <string.h>
+#include <type_traits>
+
+namespace Render
+{
+    /*
+    ** fnv-1a over 8 byte words with a fold of the high bits, then the remaining bytes
+    */
+    static uint64_t hashBytes(
+        void const* pData,
+        uint64_t iSize,
+        uint64_t iHash)
+    {
+        uint8_t const* pacData = (uint8_t const*)pData;
+        uint64_t iNumWords = iSize / sizeof(uint64_t);
+        for(uint64_t i = 0; i < iNumWords; i++)
+        {
+            uint64_t iWord = 0;
+            memcpy(&iWord, pacData + i * sizeof(uint64_t), sizeof(uint64_t));
+            iHash = (iHash ^ iWord) * 0x100000001b3ull;
+            iHash ^= (iHash >> 32);
+        }
+
+        for(uint64_t i = iNumWords * sizeof(uint64_t); i < iSize; i++)
+        {
+            iHash = (iHash ^ (uint64_t)pacData[i]) * 0x100000001b3ull;
+        }
+
+        return iHash;
+    }
+
+    /*
+    ** field by field so padding between the fields doesn't go in the key, enums and bools as their value
+    */
+    template<typename T>
+    static void addValue(
+        std::vector<uint8_t>& aKey,
+        T const& value)
+    {
+        uint64_t iValue = 0;
+        if constexpr(std::is_floating_point_v<T>)
+        {
+            memcpy(&iValue, &value, sizeof(T));
+        }
+        else if constexpr(std::is_pointer_v<T>)
+        {
+            iValue = (uint64_t)(uintptr_t)value;
+        }
+        else if constexpr(std::is_enum_v<T> || std::is_integral_v<T>)
+        {
+            iValue = static_cast<uint64_t>(value);
+        }
+        else
+        {
+            // wgpu::Bool
+            iValue = (bool)value ? 1 : 0;
+        }
+
+        uint8_t const* pacValue = (uint8_t const*)&iValue;
+        aKey.insert(aKey.end(), pacValue, pacValue + sizeof(iValue));
+    }
+
+    /*
+    ** entry points are c strings on the web and string views natively. the length goes first so the strings and the
+    ** fields after them can't run into each other
+    */
+    template<typename T>
+    static void addString(
+        std::vector<uint8_t>& aKey,
+        T const& str)
+    {
+        char const* szString = nullptr;
+        uint64_t iLength = 0;
+        if constexpr(std::is_convertible_v<T, char const*>)
+        {
+            szString = str;
+            iLength = (szString != nullptr) ? strlen(szString) : 0;
+        }
+        else
+        {
+            szString = str.data;
+            iLength = (szString == nullptr) ? 0 : (str.length == SIZE_MAX) ? strlen(szString) : str.length;
+        }
+
+        addValue(aKey, szString != nullptr);
+        addValue(aKey, iLength);
+        aKey.insert(aKey.end(), (uint8_t const*)szString, (uint8_t const*)szString + iLength);
+    }
+
+    static uint64_t const kiHashSeed = 0xcbf29ce484222325ull;
+
+    /*
+    **
+    */
+    wgpu::ShaderModule CPipelineCache::getShaderModule(
+        wgpu::Device& device,
+        char const* szCode,
+        std::string const& label)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::ShaderModule];
+        ++stats.miNumRequested;
+
+        // modules with the same hash share the bucket, the source picks the one
+        uint64_t iKey = hashBytes(szCode, strlen(szCode), kiHashSeed);
+        std::vector<ShaderModule>& aBucket = maShaderModules[iKey];
+        for(auto const& entry : aBucket)
+        {
+            if(entry.mCode == szCode)
+            {
+                return entry.mShaderModule;
+            }
+        }
+        if(aBucket.size() > 0)
+        {
+            DEBUG_PRINTF("!!! shader module \"%s\" has the hash of another module's source, keeping both !!!\n",
+                label.c_str());
+        }
+
+        wgpu::ShaderModuleWGSLDescriptor wgslDesc = {};
+        wgslDesc.code = szCode;
+        wgpu::ShaderModuleDescriptor shaderModuleDescriptor
+        {
+            .nextInChain = &wgslDesc
+        };
+        wgpu::ShaderModule shaderModule = device.CreateShaderModule(&shaderModuleDescriptor);
+        shaderModule.SetLabel(label.c_str());
+        ++stats.miNumCreated;
+
+        aBucket.push_back({szCode, shaderModule});
+        return shaderModule;
+    }
+
+    /*
+    **
+    */
+    wgpu::BindGroupLayout CPipelineCache::getBindGroupLayout(
+        wgpu::Device& device,
+        std::vector<wgpu::BindGroupLayoutEntry> const& aEntries,
+        std::string const& label)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::BindGroupLayout];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addValue(aKey, aEntries.size());
+        for(auto const& entry : aEntries)
+        {
+            addValue(aKey, entry.binding);
+            addValue(aKey, entry.visibility);
+            addValue(aKey, entry.buffer.type);
+            addValue(aKey, entry.buffer.hasDynamicOffset);
+            addValue(aKey, entry.buffer.minBindingSize);
+            addValue(aKey, entry.sampler.type);
+            addValue(aKey, entry.texture.sampleType);
+            addValue(aKey, entry.texture.viewDimension);
+            addValue(aKey, entry.texture.multisampled);
+            addValue(aKey, entry.storageTexture.access);
+            addValue(aKey, entry.storageTexture.format);
+            addValue(aKey, entry.storageTexture.viewDimension);
+        }
+
+        std::vector<BindGroupLayout>& aBucket = maBindGroupLayouts[hashBytes(aKey.data(), aKey.size(), kiHashSeed)];
+        for(auto const& entry : aBucket)
+        {
+            if(entry.maKey == aKey)
+            {
+                return entry.mBindGroupLayout;
+            }
+        }
+        if(aBucket.size() > 0)
+        {
+            DEBUG_PRINTF("!!! bind group layout \"%s\" has the hash of another layout, keeping both !!!\n",
+                label.c_str());
+        }
+
+        wgpu::BindGroupLayoutDescriptor groupLayoutDesc = {};
+        groupLayoutDesc.entryCount = (uint32_t)aEntries.size();
+        groupLayoutDesc.entries = aEntries.data();
+        wgpu::BindGroupLayout bindGroupLayout = device.CreateBindGroupLayout(&groupLayoutDesc);
+        bindGroupLayout.SetLabel(label.c_str());
+        ++stats.miNumCreated;
+
+        aBucket.push_back({std::move(aKey), bindGroupLayout});
+        return bindGroupLayout;
+    }
+
+    /*
+    **
+    */
+    wgpu::PipelineLayout CPipelineCache::getPipelineLayout(
+        wgpu::Device& device,
+        std::vector<wgpu::BindGroupLayout> const& aBindGroupLayouts)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::PipelineLayout];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addValue(aKey, aBindGroupLayouts.size());
+        for(auto const& bindGroupLayout : aBindGroupLayouts)
+        {
+            addValue(aKey, bindGroupLayout.Get());
+        }
+
+        std::vector<PipelineLayout>& aBucket = maPipelineLayouts[hashBytes(aKey.data(), aKey.size(), kiHashSeed)];
+        for(auto const& entry : aBucket)
+        {
+            if(entry.maKey == aKey)
+            {
+                return entry.mPipelineLayout;
+            }
+        }
+        if(aBucket.size() > 0)
+        {
+            DEBUG_PRINTF("!!! pipeline layout has the hash of another layout, keeping both !!!\n");
+        }
+
+        wgpu::PipelineLayoutDescriptor layoutDesc = {};
+        layoutDesc.bindGroupLayoutCount = (uint32_t)aBindGroupLayouts.size();
+        layoutDesc.bindGroupLayouts = aBindGroupLayouts.data();
+        wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&layoutDesc);
+        ++stats.miNumCreated;
+
+        aBucket.push_back({std::move(aKey), pipelineLayout});
+        return pipelineLayout;
+    }
+
+    /*
+    ** override constants of a stage, in the order the job lists them
+    */
+    static void addConstants(
+        std::vector<uint8_t>& aKey,
+        wgpu::ConstantEntry const* aConstants,
+        size_t iNumConstants)
+    {
+        addValue(aKey, iNumConstants);
+        for(uint32_t iConstant = 0; iConstant < (uint32_t)iNumConstants; iConstant++)
+        {
+            addString(aKey, aConstants[iConstant].key);
+            addValue(aKey, aConstants[iConstant].value);
+        }
+    }
+
+    /*
+    **
+    */
+    static void addPipeline(
+        std::vector<uint8_t>& aKey,
+        wgpu::RenderPipelineDescriptor const& desc)
+    {
+        addValue(aKey, desc.layout.Get());
+
+        // vertex stage and layout
+        addValue(aKey, desc.vertex.module.Get());
+        addString(aKey, desc.vertex.entryPoint);
+        addConstants(aKey, desc.vertex.constants, desc.vertex.constantCount);
+        addValue(aKey, desc.vertex.bufferCount);
+        for(uint32_t iBuffer = 0; iBuffer < (uint32_t)desc.vertex.bufferCount; iBuffer++)
+        {
+            wgpu::VertexBufferLayout const& bufferLayout = desc.vertex.buffers[iBuffer];
+            addValue(aKey, bufferLayout.arrayStride);
+            addValue(aKey, bufferLayout.stepMode);
+            addValue(aKey, bufferLayout.attributeCount);
+            for(uint32_t iAttribute = 0; iAttribute < (uint32_t)bufferLayout.attributeCount; iAttribute++)
+            {
+                addValue(aKey, bufferLayout.attributes[iAttribute].format);
+                addValue(aKey, bufferLayout.attributes[iAttribute].offset);
+                addValue(aKey, bufferLayout.attributes[iAttribute].shaderLocation);
+            }
+        }
+
+        // fragment stage and targets
+        addValue(aKey, desc.fragment != nullptr);
+        if(desc.fragment != nullptr)
+        {
+            addValue(aKey, desc.fragment->module.Get());
+            addString(aKey, desc.fragment->entryPoint);
+            addConstants(aKey, desc.fragment->constants, desc.fragment->constantCount);
+            addValue(aKey, desc.fragment->targetCount);
+            for(uint32_t iTarget = 0; iTarget < (uint32_t)desc.fragment->targetCount; iTarget++)
+            {
+                wgpu::ColorTargetState const& target = desc.fragment->targets[iTarget];
+                addValue(aKey, target.format);
+                addValue(aKey, target.writeMask);
+                addValue(aKey, target.blend != nullptr);
+                if(target.blend != nullptr)
+                {
+                    addValue(aKey, target.blend->color.srcFactor);
+                    addValue(aKey, target.blend->color.dstFactor);
+                    addValue(aKey, target.blend->color.operation);
+                    addValue(aKey, target.blend->alpha.srcFactor);
+                    addValue(aKey, target.blend->alpha.dstFactor);
+                    addValue(aKey, target.blend->alpha.operation);
+                }
+            }
+        }
+
+        addValue(aKey, desc.primitive.topology);
+        addValue(aKey, desc.primitive.stripIndexFormat);
+        addValue(aKey, desc.primitive.frontFace);
+        addValue(aKey, desc.primitive.cullMode);
+
+        addValue(aKey, desc.depthStencil != nullptr);
+        if(desc.depthStencil != nullptr)
+        {
+            wgpu::DepthStencilState const& depthStencil = *desc.depthStencil;
+            addValue(aKey, depthStencil.format);
+            addValue(aKey, depthStencil.depthWriteEnabled);
+            addValue(aKey, depthStencil.depthCompare);
+            for(wgpu::StencilFaceState const* pFace : {&depthStencil.stencilFront, &depthStencil.stencilBack})
+            {
+                addValue(aKey, pFace->compare);
+                addValue(aKey, pFace->failOp);
+                addValue(aKey, pFace->depthFailOp);
+                addValue(aKey, pFace->passOp);
+            }
+            addValue(aKey, depthStencil.stencilReadMask);
+            addValue(aKey, depthStencil.stencilWriteMask);
+            addValue(aKey, depthStencil.depthBias);
+            addValue(aKey, depthStencil.depthBiasSlopeScale);
+            addValue(aKey, depthStencil.depthBiasClamp);
+        }
+
+        addValue(aKey, desc.multisample.count);
+        addValue(aKey, desc.multisample.mask);
+        addValue(aKey, desc.multisample.alphaToCoverageEnabled);
+    }
+
+    /*
+    **
+    */
+    static void addPipeline(
+        std::vector<uint8_t>& aKey,
+        wgpu::ComputePipelineDescriptor const& desc)
+    {
+        addValue(aKey, desc.layout.Get());
+        addValue(aKey, desc.compute.module.Get());
+        addString(aKey, desc.compute.entryPoint);
+        addConstants(aKey, desc.compute.constants, desc.compute.constantCount);
+    }
+
+    /*
+    ** label of the pipeline for the errors of its async compile, a c string on the web and a string view natively
+    */
+    template<typename T>
+    static std::string getLabel(T const& label)
+    {
+        if constexpr(std::is_convertible_v<T, char const*>)
+        {
+            char const* szLabel = label;
+            return (szLabel != nullptr) ? szLabel : "";
+        }
+        else
+        {
+            if(label.data == nullptr)
+            {
+                return "";
+            }
+            return (label.length == SIZE_MAX) ? std::string(label.data) : std::string(label.data, label.length);
+        }
+    }
+
+    /*
+    ** hands the pipeline to the jobs waiting on it
+    */
+    template<typename T>
+    void CPipelineCache::Pipeline<T>::setReady(T const& pipeline)
+    {
+        mPipeline = pipeline;
+        mbReady = true;
+        mbFailed = false;
+        if(mpiNumPending != nullptr)
+        {
+            --(*mpiNumPending);
+            mpiNumPending = nullptr;
+        }
+
+        for(auto const& waiter : maWaiters)
+        {
+            (*waiter.first)(mPipeline, waiter.second);
+        }
+        maWaiters.clear();
+    }
+
+    /*
+    ** the jobs waiting on it get a null pipeline. the next request of the descriptor creates it synchronously
+    */
+    template<typename T>
+    void CPipelineCache::Pipeline<T>::setFailed()
+    {
+        // a synchronous request of the descriptor made it while it was compiling
+        if(mbReady)
+        {
+            return;
+        }
+
+        mbFailed = true;
+        if(mpiNumPending != nullptr)
+        {
+            --(*mpiNumPending);
+            mpiNumPending = nullptr;
+        }
+
+        for(auto const& waiter : maWaiters)
+        {
+            (*waiter.first)(T(), waiter.second);
+        }
+        maWaiters.clear();
+    }
+
+    /*
+    ** callback of the async compile. an entry the cache let go of while it was compiling is deleted here, the
+    ** instance also calls back with an error status when it goes away after the cache
+    */
+    template<typename T>
+    void CPipelineCache::Pipeline<T>::onCompiled(
+        Pipeline<T>* pEntry,
+        bool bSuccess,
+        T const& pipeline,
+        uint32_t iStatus,
+        char const* szMessage)
+    {
+        pEntry->mbCompiling = false;
+        if(pEntry->mbOrphaned)
+        {
+            delete pEntry;
+            return;
+        }
+
+        if(!bSuccess)
+        {
+            DEBUG_PRINTF("!!! error %d creating pipeline \"%s\" -- message: \"%s\" !!!\n",
+                iStatus,
+                pEntry->mLabel.c_str(),
+                (szMessage != nullptr) ? szMessage : "");
+            pEntry->setFailed();
+            return;
+        }
+
+        pEntry->setReady(pipeline);
+    }
+
+    /*
+    ** the async compiles still going keep their entries, their callbacks delete them
+    */
+    template<typename T>
+    static void releaseCompilingPipelines(
+        std::unordered_map<uint64_t, std::vector<std::unique_ptr<T>>>& aPipelines)
+    {
+        for(auto& bucket : aPipelines)
+        {
+            for(auto& pEntry : bucket.second)
+            {
+                if(pEntry->mbCompiling)
+                {
+                    pEntry->mbOrphaned = true;
+                    pEntry->mpiNumPending = nullptr;
+                    pEntry->maWaiters.clear();
+                    pEntry.release();
+                }
+            }
+        }
+    }
+
+    /*
+    **
+    */
+    CPipelineCache::~CPipelineCache()
+    {
+        releaseCompilingPipelines(maRenderPipelines);
+        releaseCompilingPipelines(maComputePipelines);
+    }
+
+    /*
+    **
+    */
+    void CPipelineCache::clear()
+    {
+        assert(miNumPendingPipelines == 0);
+
+        releaseCompilingPipelines(maRenderPipelines);
+        releaseCompilingPipelines(maComputePipelines);
+        maShaderModules.clear();
+        maBindGroupLayouts.clear();
+        maPipelineLayouts.clear();
+        maRenderPipelines.clear();
+        maComputePipelines.clear();
+        miNumPendingPipelines = 0;
+        for(auto& stats : maStats)
+        {
+            stats = Stats();
+        }
+    }
+
+    /*
+    ** the entry of the pipeline with the key, a new one with the key moved into it when there isn't one. pipelines
+    ** with the same hash share the bucket, the key picks the one
+    */
+    template<typename T>
+    CPipelineCache::Pipeline<T>* CPipelineCache::findPipeline(
+        PipelineBuckets<T>& aPipelines,
+        std::vector<uint8_t>& aKey,
+        bool& bAdded)
+    {
+        uint64_t iHash = hashBytes(aKey.data(), aKey.size(), kiHashSeed);
+        std::vector<std::unique_ptr<Pipeline<T>>>& aBucket = aPipelines[iHash];
+        for(auto const& pEntry : aBucket)
+        {
+            if(pEntry->maKey == aKey)
+            {
+                bAdded = false;
+                return pEntry.get();
+            }
+        }
+        if(aBucket.size() > 0)
+        {
+            DEBUG_PRINTF("!!! pipeline has the hash of another pipeline, keeping both !!!\n");
+        }
+
+        aBucket.push_back(std::make_unique<Pipeline<T>>());
+        aBucket.back()->maKey = std::move(aKey);
+        bAdded = true;
+        return aBucket.back().get();
+    }
+
+    /*
+    ** the jobs still waiting on an async pipeline of the same descriptor get this one
+    */
+    wgpu::RenderPipeline CPipelineCache::getRenderPipeline(
+        wgpu::Device& device,
+        wgpu::RenderPipelineDescriptor const& desc)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::RenderPipeline];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addPipeline(aKey, desc);
+        bool bAdded = false;
+        Pipeline<wgpu::RenderPipeline>* pEntry = findPipeline(maRenderPipelines, aKey, bAdded);
+        if(!pEntry->mbReady)
+        {
+            pEntry->setReady(device.CreateRenderPipeline(&desc));
+            ++stats.miNumCreated;
+        }
+
+        return pEntry->mPipeline;
+    }
+
+    /*
+    **
+    */
+    wgpu::ComputePipeline CPipelineCache::getComputePipeline(
+        wgpu::Device& device,
+        wgpu::ComputePipelineDescriptor const& desc)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::ComputePipeline];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addPipeline(aKey, desc);
+        bool bAdded = false;
+        Pipeline<wgpu::ComputePipeline>* pEntry = findPipeline(maComputePipelines, aKey, bAdded);
+        if(!pEntry->mbReady)
+        {
+            pEntry->setReady(device.CreateComputePipeline(&desc));
+            ++stats.miNumCreated;
+        }
+
+        return pEntry->mPipeline;
+    }
+
+    /*
+    ** the first request of a descriptor starts compiling it, the others wait on it
+    */
+    void CPipelineCache::createRenderPipelineAsync(
+        wgpu::Device& device,
+        wgpu::RenderPipelineDescriptor const& desc,
+        RenderPipelineReadyFunction pfnReady,
+        void* pUserData)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::RenderPipeline];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addPipeline(aKey, desc);
+        bool bAdded = false;
+        Pipeline<wgpu::RenderPipeline>* pEntry = findPipeline(maRenderPipelines, aKey, bAdded);
+        if(!bAdded)
+        {
+            if(pEntry->mbFailed)
+            {
+                pEntry->setReady(device.CreateRenderPipeline(&desc));
+                ++stats.miNumCreated;
+            }
+
+            if(pEntry->mbReady)
+            {
+                (*pfnReady)(pEntry->mPipeline, pUserData);
+            }
+            else
+            {
+                pEntry->maWaiters.push_back(std::make_pair(pfnReady, pUserData));
+            }
+            return;
+        }
+
+        pEntry->mLabel = getLabel(desc.label);
+        pEntry->mbCompiling = true;
+        pEntry->maWaiters.push_back(std::make_pair(pfnReady, pUserData));
+        pEntry->mpiNumPending = &miNumPendingPipelines;
+        ++miNumPendingPipelines;
+        ++stats.miNumCreated;
+
+#if defined(__EMSCRIPTEN__)
+        device.CreateRenderPipelineAsync(
+            &desc,
+            [](WGPUCreatePipelineAsyncStatus status,
+                WGPURenderPipeline pipeline,
+                char const* message,
+                void* pUserData)
+            {
+                Pipeline<wgpu::RenderPipeline>::onCompiled(
+                    (Pipeline<wgpu::RenderPipeline>*)pUserData,
+                    status == WGPUCreatePipelineAsyncStatus_Success,
+                    wgpu::RenderPipeline::Acquire(pipeline),
+                    (uint32_t)status,
+                    message);
+            },
+            pEntry);
+#else
+        device.CreateRenderPipelineAsync(
+            &desc,
+            wgpu::CallbackMode::AllowProcessEvents,
+            [](wgpu::CreatePipelineAsyncStatus status,
+                wgpu::RenderPipeline pipeline,
+                wgpu::StringView message,
+                Pipeline<wgpu::RenderPipeline>* pEntry)
+            {
+                Pipeline<wgpu::RenderPipeline>::onCompiled(
+                    pEntry,
+                    status == wgpu::CreatePipelineAsyncStatus::Success,
+                    pipeline,
+                    (uint32_t)status,
+                    getLabel(message).c_str());
+            },
+            pEntry);
+#endif // __EMSCRIPTEN__
+    }
+
+    /*
+    **
+    */
+    void CPipelineCache::createComputePipelineAsync(
+        wgpu::Device& device,
+        wgpu::ComputePipelineDescriptor const& desc,
+        ComputePipelineReadyFunction pfnReady,
+        void* pUserData)
+    {
+        Stats& stats = maStats[(uint32_t)ObjectType::ComputePipeline];
+        ++stats.miNumRequested;
+
+        std::vector<uint8_t> aKey;
+        addPipeline(aKey, desc);
+        bool bAdded = false;
+        Pipeline<wgpu::ComputePipeline>* pEntry = findPipeline(maComputePipelines, aKey, bAdded);
+        if(!bAdded)
+        {
+            if(pEntry->mbFailed)
+            {
+                pEntry->setReady(device.CreateComputePipeline(&desc));
+                ++stats.miNumCreated;
+            }
+
+            if(pEntry->mbReady)
+            {
+                (*pfnReady)(pEntry->mPipeline, pUserData);
+            }
+            else
+            {
+                pEntry->maWaiters.push_back(std::make_pair(pfnReady, pUserData));
+            }
+            return;
+        }
+
+        pEntry->mLabel = getLabel(desc.label);
+        pEntry->mbCompiling = true;
+        pEntry->maWaiters.push_back(std::make_pair(pfnReady, pUserData));
+        pEntry->mpiNumPending = &miNumPendingPipelines;
+        ++miNumPendingPipelines;
+        ++stats.miNumCreated;
+
+#if defined(__EMSCRIPTEN__)
+        device.CreateComputePipelineAsync(
+            &desc,
+            [](WGPUCreatePipelineAsyncStatus status,
+                WGPUComputePipeline pipeline,
+                char const* message,
+                void* pUserData)
+            {
+                Pipeline<wgpu::ComputePipeline>::onCompiled(
+                    (Pipeline<wgpu::ComputePipeline>*)pUserData,
+                    status == WGPUCreatePipelineAsyncStatus_Success,
+                    wgpu::ComputePipeline::Acquire(pipeline),
+                    (uint32_t)status,
+                    message);
+            },
+            pEntry);
+#else
+        device.CreateComputePipelineAsync(
+            &desc,
+            wgpu::CallbackMode::AllowProcessEvents,
+            [](wgpu::CreatePipelineAsyncStatus status,
+                wgpu::ComputePipeline pipeline,
+                wgpu::StringView message,
+                Pipeline<wgpu::ComputePipeline>* pEntry)
+            {
+                Pipeline<wgpu::ComputePipeline>::onCompiled(
+                    pEntry,
+                    status == wgpu::CreatePipelineAsyncStatus::Success,
+                    pipeline,
+                    (uint32_t)status,
+                    getLabel(message).c_str());
+            },
+            pEntry);
+#endif // __EMSCRIPTEN__
+    }
+
+    /*
+    **
+    */
+    void CPipelineCache::print() const
+    {
+        static char const* saszObjectTypes[] =
+        {
+            "shader modules",
+            "bind group layouts",
+            "pipeline layouts",
+            "render pipelines",
+            "compute pipelines",
+        };
+
+        uint32_t iNumRequested = 0, iNumCreated = 0;
+        for(uint32_t iType = 0; iType < (uint32_t)ObjectType::NumObjectTypes; iType++)
+        {
+            DEBUG_PRINTF("%s: %d without the cache, %d created\n",
+                saszObjectTypes[iType],
+                maStats[iType].miNumRequested,
+                maStats[iType].miNumCreated);
+            iNumRequested += maStats[iType].miNumRequested;
+            iNumCreated += maStats[iType].miNumCreated;
+        }
+        DEBUG_PRINTF("pipeline objects: %d without the cache, %d created\n",
+            iNumRequested,
+            iNumCreated);
+    }
+
+}   // Render
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** shader modules, bind group layouts, pipeline layouts and pipelines by a hash of their descriptors. jobs with the
+    ** same shader and bindings, like the light view cascades, get the same objects, and the cache outlives the jobs so
+    ** creating them again only creates what changed
+    **
+    ** the objects a descriptor points to are hashed by their handle. the modules and layouts come from the cache too,
+    ** so the same handle is the same descriptor
+    **
+    ** a hit is checked before it's handed out so a hash collision can't give a job another job's object. modules keep
+    ** their WGSL source, layouts and pipelines the bytes of the fields that were hashed, and the objects with the same
+    ** hash share a bucket
+    **
+    ** pipelines created asynchronously call back every job waiting on them once they're compiled, natively from
+    ** wgpu::Instance::ProcessEvents() and on the web from the browser's event loop. it isn't cleared while jobs are
+    ** waiting. a compile that fails calls them back with a null pipeline and the next request of the descriptor
+    ** creates it synchronously. the entries still compiling when the cache is cleared or goes away are left to their
+    ** callbacks
+    */
+    class CPipelineCache
+    {
+    public:
+        enum class ObjectType
+        {
+            ShaderModule,
+            BindGroupLayout,
+            PipelineLayout,
+            RenderPipeline,
+            ComputePipeline,
+
+            NumObjectTypes,
+        };
+
+        typedef void (*RenderPipelineReadyFunction)(wgpu::RenderPipeline const& pipeline, void* pUserData);
+        typedef void (*ComputePipelineReadyFunction)(wgpu::ComputePipeline const& pipeline, void* pUserData);
+
+        struct Stats
+        {
+            uint32_t            miNumRequested = 0;         // objects the jobs would have created on their own
+            uint32_t            miNumCreated = 0;
+        };
+
+    public:
+        CPipelineCache() = default;
+        virtual ~CPipelineCache();
+
+        void clear();
+
+        // label goes to the first job's object
+        wgpu::ShaderModule getShaderModule(
+            wgpu::Device& device,
+            char const* szCode,
+            std::string const& label);
+
+        wgpu::BindGroupLayout getBindGroupLayout(
+            wgpu::Device& device,
+            std::vector<wgpu::BindGroupLayoutEntry> const& aEntries,
+            std::string const& label);
+
+        wgpu::PipelineLayout getPipelineLayout(
+            wgpu::Device& device,
+            std::vector<wgpu::BindGroupLayout> const& aBindGroupLayouts);
+
+        wgpu::RenderPipeline getRenderPipeline(
+            wgpu::Device& device,
+            wgpu::RenderPipelineDescriptor const& desc);
+
+        wgpu::ComputePipeline getComputePipeline(
+            wgpu::Device& device,
+            wgpu::ComputePipelineDescriptor const& desc);
+
+        // pfnReady is called once the pipeline is compiled, right away when the cache already has it, and with a null
+        // pipeline when compiling it fails
+        void createRenderPipelineAsync(
+            wgpu::Device& device,
+            wgpu::RenderPipelineDescriptor const& desc,
+            RenderPipelineReadyFunction pfnReady,
+            void* pUserData);
+
+        void createComputePipelineAsync(
+            wgpu::Device& device,
+            wgpu::ComputePipelineDescriptor const& desc,
+            ComputePipelineReadyFunction pfnReady,
+            void* pUserData);
+
+        inline uint32_t getNumPendingPipelines() const
+        {
+            return miNumPendingPipelines;
+        }
+
+        void print() const;
+
+        inline Stats const& getStats(ObjectType type) const
+        {
+            return maStats[(uint32_t)type];
+        }
+
+    protected:
+        // compiled, or being compiled with the jobs waiting on it
+        template<typename T>
+        struct Pipeline
+        {
+            T                                                   mPipeline;
+            bool                                                mbReady = false;
+            bool                                                mbFailed = false;       // the async compile failed
+            bool                                                mbCompiling = false;    // its callback hasn't come
+            bool                                                mbOrphaned = false;     // its callback deletes it
+            std::vector<std::pair<void (*)(T const&, void*), void*>>    maWaiters;
+            uint32_t*                                           mpiNumPending = nullptr;
+            std::string                                         mLabel;
+            std::vector<uint8_t>                                maKey;
+
+            void setReady(T const& pipeline);
+            void setFailed();
+
+            static void onCompiled(
+                Pipeline<T>* pEntry,
+                bool bSuccess,
+                T const& pipeline,
+                uint32_t iStatus,
+                char const* szMessage);
+        };
+
+        struct ShaderModule
+        {
+            std::string                                         mCode;
+            wgpu::ShaderModule                                  mShaderModule;
+        };
+
+        struct BindGroupLayout
+        {
+            std::vector<uint8_t>                                maKey;
+            wgpu::BindGroupLayout                               mBindGroupLayout;
+        };
+
+        struct PipelineLayout
+        {
+            std::vector<uint8_t>                                maKey;
+            wgpu::PipelineLayout                                mPipelineLayout;
+        };
+
+        template<typename T>
+        using PipelineBuckets = std::unordered_map<uint64_t, std::vector<std::unique_ptr<Pipeline<T>>>>;
+
+        template<typename T>
+        Pipeline<T>* findPipeline(
+            PipelineBuckets<T>& aPipelines,
+            std::vector<uint8_t>& aKey,
+            bool& bAdded);
+
+    protected:
+        Stats                                                   maStats[(uint32_t)ObjectType::NumObjectTypes];
+        uint32_t                                                miNumPendingPipelines = 0;
+
+        std::unordered_map<uint64_t, std::vector<ShaderModule>>    maShaderModules;
+        std::unordered_map<uint64_t, std::vector<BindGroupLayout>> maBindGroupLayouts;
+        std::unordered_map<uint64_t, std::vector<PipelineLayout>>  maPipelineLayouts;
+        PipelineBuckets<wgpu::RenderPipeline>                   maRenderPipelines;
+        PipelineBuckets<wgpu::ComputePipeline>                  maComputePipelines;
+    };
+
+}   // Render
@@ -0,0 +1,177 @@
+#include <render/record_scheduler.h>
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace Render
+{
+    /*
+    **
+    */
+    CRecordScheduler::~CRecordScheduler()
+    {
+        shutdown();
+    }
+
+    /*
+    **
+    */
+    void CRecordScheduler::setup(uint32_t iNumThreads)
+    {
+        shutdown();
+
+        mbQuit = false;
+        for(uint32_t iThread = 1; iThread < iNumThreads; iThread++)
+        {
+            maThreads.emplace_back(
+                [this]()
+                {
+                    workerLoop();
+                });
+        }
+    }
+
+    /*
+    **
+    */
+    void CRecordScheduler::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mbQuit = true;
+        }
+        mWakeUp.notify_all();
+
+        for(auto& thread : maThreads)
+        {
+            thread.join();
+        }
+        maThreads.clear();
+    }
+
+    /*
+    ** cut after the job that takes the running cost past the next share of the total
+    */
+    std::vector<CRecordScheduler::Chunk> const& CRecordScheduler::split(std::vector<uint64_t> const& aiJobCosts)
+    {
+        maChunks.clear();
+
+        uint32_t iNumJobs = (uint32_t)aiJobCosts.size();
+        uint32_t iNumChunks = std::min(getNumThreads(), iNumJobs);
+        if(iNumChunks == 0)
+        {
+            return maChunks;
+        }
+
+        uint64_t iTotalCost = 0;
+        for(uint64_t iCost : aiJobCosts)
+        {
+            iTotalCost += std::max(iCost, (uint64_t)1);
+        }
+
+        Chunk chunk;
+        uint64_t iRunningCost = 0;
+        for(uint32_t iJob = 0; iJob < iNumJobs; iJob++)
+        {
+            uint64_t iCost = std::max(aiJobCosts[iJob], (uint64_t)1);
+            ++chunk.miNumJobs;
+            chunk.miCost += iCost;
+            iRunningCost += iCost;
+
+            // enough jobs left for a job per remaining chunk
+            uint32_t iNumJobsLeft = iNumJobs - iJob - 1;
+            uint32_t iNumChunksLeft = iNumChunks - (uint32_t)maChunks.size() - 1;
+            bool bShareDone = (iRunningCost * iNumChunks >= iTotalCost * (maChunks.size() + 1));
+            if(iNumChunksLeft > 0 && (bShareDone || iNumJobsLeft == iNumChunksLeft))
+            {
+                maChunks.push_back(chunk);
+                chunk = Chunk();
+                chunk.miFirstJob = iJob + 1;
+            }
+        }
+        maChunks.push_back(chunk);
+
+        return maChunks;
+    }
+
+    /*
+    **
+    */
+    void CRecordScheduler::record(
+        RecordFunction pfnRecord,
+        void* pUserData)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mpfnRecord = pfnRecord;
+            mpUserData = pUserData;
+            miNextChunk = 0;
+            miNumFinishedWorkers = 0;
+            ++miGeneration;
+        }
+        mWakeUp.notify_all();
+
+        recordChunks();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mFinished.wait(
+            lock,
+            [&]()
+            {
+                return (miNumFinishedWorkers == (uint32_t)maThreads.size());
+            });
+    }
+
+    /*
+    **
+    */
+    void CRecordScheduler::workerLoop()
+    {
+        uint64_t iGeneration = 0;
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWakeUp.wait(
+                    lock,
+                    [&]()
+                    {
+                        return (mbQuit || miGeneration != iGeneration);
+                    });
+                if(mbQuit)
+                {
+                    return;
+                }
+                iGeneration = miGeneration;
+            }
+
+            recordChunks();
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                ++miNumFinishedWorkers;
+            }
+            mFinished.notify_all();
+        }
+    }
+
+    /*
+    ** next unrecorded chunk until there are none
+    */
+    void CRecordScheduler::recordChunks()
+    {
+        for(;;)
+        {
+            uint32_t iChunk = miNextChunk.fetch_add(1);
+            if(iChunk >= (uint32_t)maChunks.size())
+            {
+                break;
+            }
+
+            Chunk const& chunk = maChunks[iChunk];
+            (*mpfnRecord)(iChunk, chunk.miFirstJob, chunk.miNumJobs, mpUserData);
+        }
+    }
+
+}   // Render
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** records the jobs of a frame on several threads. the jobs are split into contiguous chunks of the scheduled
+    ** order, each chunk goes into its own encoder and the command buffers are submitted in chunk order, so the gpu
+    ** sees the same order as recording on one thread. recording a job doesn't depend on recording another, only the
+    ** submission order does
+    **
+    ** no gpu objects, the record function is given the chunk and creates its encoder, the dry run tool records into
+    ** a mock one
+    */
+    class CRecordScheduler
+    {
+    public:
+        // records the jobs [iFirstJob, iFirstJob + iNumJobs) of the frame for chunk iChunk, called on any thread
+        typedef void (*RecordFunction)(
+            uint32_t iChunk,
+            uint32_t iFirstJob,
+            uint32_t iNumJobs,
+            void* pUserData);
+
+        struct Chunk
+        {
+            uint32_t            miFirstJob = 0;
+            uint32_t            miNumJobs = 0;
+            uint64_t            miCost = 0;
+        };
+
+    public:
+        CRecordScheduler() = default;
+        virtual ~CRecordScheduler();
+
+        // iNumThreads - 1 workers, the thread calling record() records too
+        void setup(uint32_t iNumThreads);
+        void shutdown();
+
+        // at most one chunk per thread with about the same cost each, costs are in the jobs' order
+        std::vector<Chunk> const& split(std::vector<uint64_t> const& aiJobCosts);
+
+        // returns after every chunk of the last split() is recorded
+        void record(
+            RecordFunction pfnRecord,
+            void* pUserData);
+
+        inline uint32_t getNumThreads() const
+        {
+            return (uint32_t)maThreads.size() + 1;
+        }
+
+        inline std::vector<Chunk> const& getChunks() const
+        {
+            return maChunks;
+        }
+
+    protected:
+        void workerLoop();
+        void recordChunks();
+
+    protected:
+        std::vector<Chunk>                  maChunks;
+        std::vector<std::thread>            maThreads;
+
+        std::mutex                          mMutex;
+        std::condition_variable             mWakeUp;
+        std::condition_variable             mFinished;
+
+        // every worker goes through every record() once, none is left running into the next split()
+        uint64_t                            miGeneration = 0;
+        uint32_t                            miNumFinishedWorkers = 0;
+        bool                                mbQuit = false;
+
+        std::atomic<uint32_t>               miNextChunk = 0;
+        RecordFunction                      mpfnRecord = nullptr;
+        void*                               mpUserData = nullptr;
+    };
+
+}   // Render
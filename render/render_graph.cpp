@@ -0,0 +1,656 @@
+#include <render/render_graph.h>
+#include <render/transient_allocator.h>
+
+#include <utils/LogPrint.h>
+
+#include <assert.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace Render
+{
+    /*
+    ** passes that write the depth texture, the other graphics passes only have it attached
+    */
+    static bool isMeshPass(std::string const& passType)
+    {
+        return (passType == "Draw Meshes" || passType == "Draw Animated Meshes" || passType == "Draw Static Meshes" ||
+            passType == "Draw Dynamic Meshes" || passType == "Depth Prepass");
+    }
+
+    /*
+    **
+    */
+    static void addUnique(
+        std::vector<std::string>& aKeys,
+        std::string const& key)
+    {
+        if(std::find(aKeys.begin(), aKeys.end(), key) == aKeys.end())
+        {
+            aKeys.push_back(key);
+        }
+    }
+
+    /*
+    **
+    */
+    bool CRenderGraph::compile(
+        char const* acJobList,
+        LoadFileFunction pfnLoadFile,
+        void* pUserData)
+    {
+        CRenderJobDescriptions descriptions;
+        if(!descriptions.compile(acJobList, pfnLoadFile, pUserData))
+        {
+            maJobs.clear();
+            maiSchedule.clear();
+            maErrors = descriptions.getErrors();
+            return false;
+        }
+
+        return compile(descriptions);
+    }
+
+    /*
+    **
+    */
+    bool CRenderGraph::compile(CRenderJobDescriptions const& descriptions)
+    {
+        maJobs.clear();
+        maiSchedule.clear();
+        maErrors.clear();
+        maaAttachments.clear();
+        maaShaderResources.clear();
+        maResources.clear();
+
+        addJobs(descriptions);
+
+        linkResources();
+        if(maErrors.size() > 0)
+        {
+            return false;
+        }
+
+        cullJobs();
+        if(maErrors.size() > 0)
+        {
+            return false;
+        }
+
+        return schedule();
+    }
+
+    /*
+    **
+    */
+    std::string CRenderGraph::getCullingJobName(
+        std::string const& culling,
+        Render::OcclusionPhase occlusionPhase)
+    {
+        static char const* saszPhaseNames[] = {"", " Early", " Late"};
+        return culling + " Culling" + saszPhaseNames[(uint32_t)occlusionPhase] + " Compute";
+    }
+
+    /*
+    ** the jobs of the descriptions in their order, with the external shader resources they read and write
+    */
+    void CRenderGraph::addJobs(CRenderJobDescriptions const& descriptions)
+    {
+        mOutputJob = descriptions.getOutputJob();
+        mOutputAttachment = descriptions.getOutputAttachment();
+
+        for(CRenderJobDescriptions::Job const& jobDesc : descriptions.getJobs())
+        {
+            Job& job = maJobs.emplace_back();
+            job.mName = jobDesc.mName;
+            job.mPipeline = jobDesc.mPipeline;
+            job.mType = jobDesc.mType;
+            job.mPassType = jobDesc.mPassType;
+            job.mOcclusionPhase = jobDesc.mOcclusionPhase;
+            job.miListIndex = jobDesc.miListIndex;
+            job.miNumFrames = jobDesc.miNumFrames;
+            job.mResolutionMode = jobDesc.mResolutionMode;
+            job.mbKeep = jobDesc.mbKeep;
+
+            std::vector<ShaderResource> aShaderResources;
+            for(CRenderJobDescriptions::ShaderResource const& resourceDesc : jobDesc.maShaderResources)
+            {
+                if(!resourceDesc.mbExternal)
+                {
+                    continue;
+                }
+
+                ShaderResource shaderResource;
+                shaderResource.mName = resourceDesc.mName;
+                shaderResource.mbWrite = (resourceDesc.mUsage == "read_write_storage" || resourceDesc.mUsage == "write_only_storage");
+                aShaderResources.push_back(shaderResource);
+            }
+
+            maaAttachments.push_back(jobDesc.maAttachments);
+            maaShaderResources.push_back(aShaderResources);
+        }
+    }
+
+    /*
+    **
+    */
+    int32_t CRenderGraph::findJob(std::string const& jobName) const
+    {
+        for(uint32_t iJob = 0; iJob < (uint32_t)maJobs.size(); iJob++)
+        {
+            if(maJobs[iJob].mName == jobName)
+            {
+                return (int32_t)iJob;
+            }
+        }
+
+        return -1;
+    }
+
+    /*
+    ** what CRenderJob puts in mOutputImageAttachments and mOutputBufferAttachments
+    */
+    bool CRenderGraph::hasOutput(
+        uint32_t iJob,
+        std::string const& attachmentName) const
+    {
+        if(maJobs[iJob].mType == Render::JobType::Graphics && attachmentName == "Depth-Texture")
+        {
+            return true;
+        }
+
+        for(auto const& attachment : maaAttachments[iJob])
+        {
+            if(attachment.mName != attachmentName)
+            {
+                continue;
+            }
+
+            bool bOwnOutput = ((attachment.mType == "TextureOutput" || attachment.mType == "BufferOutput") &&
+                (attachment.mParentJob.empty() || maJobs[iJob].mType == Render::JobType::Copy));
+            if(bOwnOutput || attachment.mType == "TextureInputOutput")
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+    ** TextureInputOutput attachments and the depth texture of a job with them are the parent's, follow the chain to
+    ** the job that created them
+    */
+    std::string CRenderGraph::getResourceKey(
+        std::string const& jobName,
+        std::string const& attachmentName,
+        uint32_t iDepth) const
+    {
+        int32_t iJob = findJob(jobName);
+        if(iJob >= 0 && iDepth < (uint32_t)maJobs.size())
+        {
+            for(auto const& attachment : maaAttachments[iJob])
+            {
+                if(attachment.mType != "TextureInputOutput")
+                {
+                    continue;
+                }
+
+                if(attachment.mName == attachmentName || attachmentName == "Depth-Texture")
+                {
+                    return getResourceKey(attachment.mParentJob, attachmentName, iDepth + 1);
+                }
+            }
+        }
+
+        return jobName + "/" + attachmentName;
+    }
+
+    /*
+    ** one dependency per job and type, the first resource is kept for the dry run
+    */
+    void CRenderGraph::addDependency(
+        uint32_t iJob,
+        uint32_t iBeforeJob,
+        DependencyType type,
+        std::string const& resource)
+    {
+        if(iJob == iBeforeJob)
+        {
+            return;
+        }
+
+        std::vector<Dependency>& aDependencies = maJobs[iJob].maDependencies;
+        auto iter = std::find_if(
+            aDependencies.begin(),
+            aDependencies.end(),
+            [&](Dependency const& check)
+            {
+                return (check.miJob == iBeforeJob && check.mType == type);
+            });
+        if(iter == aDependencies.end())
+        {
+            aDependencies.push_back({iBeforeJob, type, resource});
+        }
+    }
+
+    /*
+    ** reads and writes of every job, then the dependencies from walking them in the listed order
+    */
+    void CRenderGraph::linkResources()
+    {
+        for(uint32_t iJob = 0; iJob < (uint32_t)maJobs.size(); iJob++)
+        {
+            Job& job = maJobs[iJob];
+            for(auto const& attachment : maaAttachments[iJob])
+            {
+                bool bCopy = (job.mType == Render::JobType::Copy && !attachment.mParentJob.empty());
+                bool bRead = (attachment.mType == "TextureInput" || attachment.mType == "BufferInput" ||
+                    attachment.mType == "VertexBufferInput" || attachment.mType == "TextureInputOutput" || bCopy);
+                if(bRead)
+                {
+                    std::string const& parentName = bCopy ? attachment.mParentName : attachment.mName;
+                    int32_t iParentJob = findJob(attachment.mParentJob);
+                    if(iParentJob < 0)
+                    {
+                        maErrors.push_back("\"" + job.mName + "\": \"" + attachment.mName + "\" is from \"" +
+                            attachment.mParentJob + "\", which isn't in the job list");
+                        continue;
+                    }
+                    if(!hasOutput((uint32_t)iParentJob, parentName))
+                    {
+                        maErrors.push_back("\"" + job.mName + "\": \"" + attachment.mParentJob + "\" has no \"" +
+                            parentName + "\"");
+                        continue;
+                    }
+
+                    addUnique(job.maReads, getResourceKey(attachment.mParentJob, parentName));
+                }
+
+                if(attachment.mType == "TextureInputOutput")
+                {
+                    addUnique(job.maWrites, getResourceKey(attachment.mParentJob, attachment.mName));
+                }
+                else if(attachment.mType == "TextureOutput" || attachment.mType == "BufferOutput")
+                {
+                    addUnique(job.maWrites, job.mName + "/" + attachment.mName);
+                }
+            }
+
+            if(job.mType == Render::JobType::Graphics && isMeshPass(job.mPassType))
+            {
+                addUnique(job.maWrites, getResourceKey(job.mName, "Depth-Texture"));
+            }
+
+            // indirect draws, same choice of culling job as CRenderer::getCullingJob
+            if(job.mPassType == "Draw Meshes")
+            {
+                std::pair<char const*, char const*> aCullingOutputs[] =
+                {
+                    {"Mesh", "Draw Calls"},
+                    {"Cluster", "Cluster Draw Calls"},
+                };
+                for(auto const& cullingOutput : aCullingOutputs)
+                {
+                    std::string cullingJobName = getCullingJobName(cullingOutput.first, job.mOcclusionPhase);
+                    if(findJob(cullingJobName) < 0 && job.mOcclusionPhase == Render::OcclusionPhase::Early)
+                    {
+                        cullingJobName = getCullingJobName(cullingOutput.first, Render::OcclusionPhase::None);
+                    }
+
+                    if(findJob(cullingJobName) >= 0)
+                    {
+                        addUnique(job.maReads, cullingJobName + "/" + cullingOutput.second);
+                    }
+                }
+            }
+
+            for(auto const& shaderResource : maaShaderResources[iJob])
+            {
+                addUnique(job.maReads, "external/" + shaderResource.mName);
+                if(shaderResource.mbWrite)
+                {
+                    addUnique(job.maWrites, "external/" + shaderResource.mName);
+                }
+            }
+        }
+
+        if(maErrors.size() > 0)
+        {
+            return;
+        }
+
+        // reads before writes within a job, an in place write reads the previous version
+        for(uint32_t iJob = 0; iJob < (uint32_t)maJobs.size(); iJob++)
+        {
+            Job& job = maJobs[iJob];
+            for(auto const& resource : job.maReads)
+            {
+                ResourceState& state = maResources[resource];
+                if(state.miLastWriter >= 0)
+                {
+                    addDependency(iJob, (uint32_t)state.miLastWriter, DependencyType::Read, resource);
+                    job.maInputs.push_back({(uint32_t)state.miLastWriter, DependencyType::Read, resource});
+                }
+                else
+                {
+                    state.maiReadsBeforeFirstWrite.push_back(iJob);
+                }
+                state.maiReadsSinceWrite.push_back(iJob);
+            }
+
+            for(auto const& resource : job.maWrites)
+            {
+                ResourceState& state = maResources[resource];
+                if(state.miLastWriter >= 0)
+                {
+                    addDependency(iJob, (uint32_t)state.miLastWriter, DependencyType::Overwrite, resource);
+                }
+                for(uint32_t iReadJob : state.maiReadsSinceWrite)
+                {
+                    addDependency(iJob, iReadJob, DependencyType::Overwrite, resource);
+                }
+
+                state.maiReadsSinceWrite.clear();
+                state.miLastWriter = (int32_t)iJob;
+                if(state.miFirstWriter < 0)
+                {
+                    state.miFirstWriter = (int32_t)iJob;
+                }
+            }
+        }
+
+        // reads before the first write get what the last write left last frame, the first write waits for them.
+        // resources nobody writes are the app's
+        for(auto const& resource : maResources)
+        {
+            ResourceState const& state = resource.second;
+            if(state.miLastWriter < 0)
+            {
+                continue;
+            }
+
+            for(uint32_t iReadJob : state.maiReadsBeforeFirstWrite)
+            {
+                maJobs[iReadJob].maInputs.push_back({(uint32_t)state.miLastWriter, DependencyType::PreviousFrame, resource.first});
+                addDependency((uint32_t)state.miFirstWriter, iReadJob, DependencyType::Overwrite, resource.first);
+            }
+        }
+    }
+
+    /*
+    ** live jobs are the output job, the kept ones, and everything they read from this frame or the previous one
+    */
+    void CRenderGraph::cullJobs()
+    {
+        int32_t iOutputJob = findJob(mOutputJob);
+        if(iOutputJob < 0 || !hasOutput((uint32_t)iOutputJob, mOutputAttachment))
+        {
+            maErrors.push_back("output \"" + mOutputAttachment + "\" of \"" + mOutputJob + "\" isn't in the job list");
+            return;
+        }
+
+        std::vector<uint32_t> aiLiveJobs;
+        for(uint32_t iJob = 0; iJob < (uint32_t)maJobs.size(); iJob++)
+        {
+            if(maJobs[iJob].mbKeep || iJob == (uint32_t)iOutputJob)
+            {
+                maJobs[iJob].mbLive = true;
+                aiLiveJobs.push_back(iJob);
+            }
+        }
+
+        while(aiLiveJobs.size() > 0)
+        {
+            uint32_t iJob = aiLiveJobs.back();
+            aiLiveJobs.pop_back();
+            for(auto const& input : maJobs[iJob].maInputs)
+            {
+                if(!maJobs[input.miJob].mbLive)
+                {
+                    maJobs[input.miJob].mbLive = true;
+                    aiLiveJobs.push_back(input.miJob);
+                }
+            }
+        }
+    }
+
+    /*
+    ** kahn's algorithm over the live jobs, the ready job listed first goes next
+    */
+    bool CRenderGraph::schedule()
+    {
+        uint32_t iNumJobs = (uint32_t)maJobs.size();
+        std::vector<uint32_t> aiNumWaits(iNumJobs, 0);
+        std::vector<std::vector<uint32_t>> aaiDependents(iNumJobs);
+        for(uint32_t iJob = 0; iJob < iNumJobs; iJob++)
+        {
+            if(!maJobs[iJob].mbLive)
+            {
+                continue;
+            }
+
+            for(auto const& dependency : maJobs[iJob].maDependencies)
+            {
+                if(maJobs[dependency.miJob].mbLive)
+                {
+                    aaiDependents[dependency.miJob].push_back(iJob);
+                    ++aiNumWaits[iJob];
+                }
+            }
+        }
+
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> readyJobs;
+        uint32_t iNumLiveJobs = 0;
+        for(uint32_t iJob = 0; iJob < iNumJobs; iJob++)
+        {
+            if(maJobs[iJob].mbLive)
+            {
+                ++iNumLiveJobs;
+                if(aiNumWaits[iJob] == 0)
+                {
+                    readyJobs.push(iJob);
+                }
+            }
+        }
+
+        while(!readyJobs.empty())
+        {
+            uint32_t iJob = readyJobs.top();
+            readyJobs.pop();
+            maiSchedule.push_back(iJob);
+            for(uint32_t iDependent : aaiDependents[iJob])
+            {
+                if(--aiNumWaits[iDependent] == 0)
+                {
+                    readyJobs.push(iDependent);
+                }
+            }
+        }
+
+        if(maiSchedule.size() != iNumLiveJobs)
+        {
+            std::string cycle = "cycle between";
+            for(uint32_t iJob = 0; iJob < iNumJobs; iJob++)
+            {
+                if(maJobs[iJob].mbLive && aiNumWaits[iJob] > 0)
+                {
+                    cycle += " \"" + maJobs[iJob].mName + "\"";
+                }
+            }
+            maErrors.push_back(cycle);
+            return false;
+        }
+
+        return true;
+    }
+
+    /*
+    ** the textures CRenderJob::createWithOnlyOutputAttachments creates and the buffers of the non copy jobs. a
+    ** resource is persistent when it's read before its first write (last frame's), drawn to the swap chain, written by a
+    ** job that stops running after its first frames or only shades some of its pixels each frame, or the copy of a copy
+    ** job
+    */
+    void CRenderGraph::addTransientResources(
+        CTransientAllocator& allocator,
+        uint32_t iScreenWidth,
+        uint32_t iScreenHeight) const
+    {
+        struct Lifetime
+        {
+            uint32_t        miFirstUse = UINT32_MAX;
+            uint32_t        miLastUse = 0;
+            bool            mbPersistent = false;
+        };
+
+        std::map<std::string, Lifetime> aLifetimes;
+        for(uint32_t iPosition = 0; iPosition < (uint32_t)maiSchedule.size(); iPosition++)
+        {
+            Job const& job = maJobs[maiSchedule[iPosition]];
+            for(auto const& resource : job.maWrites)
+            {
+                Lifetime& lifetime = aLifetimes[resource];
+                lifetime.miFirstUse = std::min(lifetime.miFirstUse, iPosition);
+                lifetime.miLastUse = std::max(lifetime.miLastUse, iPosition);
+                lifetime.mbPersistent = (lifetime.mbPersistent || job.miNumFrames > 0 || job.mResolutionMode != Render::ResolutionMode::Full);
+            }
+            for(auto const& resource : job.maReads)
+            {
+                Lifetime& lifetime = aLifetimes[resource];
+                lifetime.miLastUse = std::max(lifetime.miLastUse, iPosition);
+            }
+        }
+
+        for(auto const& resource : maResources)
+        {
+            for(uint32_t iReadJob : resource.second.maiReadsBeforeFirstWrite)
+            {
+                if(maJobs[iReadJob].mbLive)
+                {
+                    aLifetimes[resource.first].mbPersistent = true;
+                }
+            }
+        }
+        aLifetimes[getResourceKey(mOutputJob, mOutputAttachment)].mbPersistent = true;
+
+        static std::map<std::string, uint32_t> const saiTexelSizes =
+        {
+            {"rgba32float", 16},
+            {"rgba16float", 8},
+            {"rg32float", 8},
+            {"rg16float", 4},
+            {"r32float", 4},
+        };
+
+        for(uint32_t iJob : maiSchedule)
+        {
+            Job const& job = maJobs[iJob];
+            bool bCopy = (job.mType == Render::JobType::Copy);
+            for(auto const& attachment : maaAttachments[iJob])
+            {
+                bool bTexture = (attachment.mType == "TextureOutput");
+                bool bBuffer = (attachment.mType == "BufferOutput" && !bCopy);
+                if(!bTexture && !bBuffer)
+                {
+                    continue;
+                }
+
+                CTransientAllocator::Resource resource;
+                resource.mName = job.mName + "/" + attachment.mName;
+                if(bTexture)
+                {
+                    // formats CRenderJob doesn't know are created as rgba32float
+                    std::string format = attachment.mFormat;
+                    auto texelSize = saiTexelSizes.find(format);
+                    if(texelSize == saiTexelSizes.end())
+                    {
+                        format = "rgba32float";
+                        texelSize = saiTexelSizes.find(format);
+                    }
+                    uint32_t aiSize[2];
+                    Render::getTargetSize(aiSize, iScreenWidth, iScreenHeight, attachment.mfScaleWidth, attachment.mfScaleHeight);
+                    resource.miNumBytes = (uint64_t)aiSize[0] * (uint64_t)aiSize[1] * (uint64_t)texelSize->second;
+                    resource.mDescription = format + " " + std::to_string(aiSize[0]) + "x" + std::to_string(aiSize[1]) +
+                        (bCopy ? " copy" : "");
+                }
+                else
+                {
+                    resource.miNumBytes = attachment.miSize;
+                    resource.mDescription = "buffer " + std::to_string(attachment.miSize) + " " + attachment.mUsage;
+                }
+
+                Lifetime const& lifetime = aLifetimes[resource.mName];
+                resource.miFirstUse = (lifetime.miFirstUse == UINT32_MAX) ? lifetime.miLastUse : lifetime.miFirstUse;
+                resource.miLastUse = lifetime.miLastUse;
+                resource.mbPersistent = (lifetime.mbPersistent || bCopy ||
+                    (bTexture && attachment.mTransient == "False") ||
+                    (bBuffer && attachment.mTransient != "True"));
+
+                allocator.addResource(resource);
+            }
+        }
+    }
+
+    /*
+    **
+    */
+    void CRenderGraph::print() const
+    {
+        static char const* saszDependencyTypes[] = {"reads", "last frame", "overwrites"};
+
+        for(auto const& error : maErrors)
+        {
+            DEBUG_PRINTF("error: %s\n", error.c_str());
+        }
+        if(maErrors.size() > 0)
+        {
+            return;
+        }
+
+        DEBUG_PRINTF("%d jobs, %d scheduled, %d culled, output \"%s\" of \"%s\"\n",
+            (uint32_t)maJobs.size(),
+            (uint32_t)maiSchedule.size(),
+            (uint32_t)(maJobs.size() - std::count_if(maJobs.begin(), maJobs.end(), [](Job const& job) { return job.mbLive; })),
+            mOutputAttachment.c_str(),
+            mOutputJob.c_str());
+
+        for(uint32_t i = 0; i < (uint32_t)maiSchedule.size(); i++)
+        {
+            Job const& job = maJobs[maiSchedule[i]];
+            DEBUG_PRINTF("%3d %s (%s)\n", i, job.mName.c_str(), job.mPassType.c_str());
+            for(auto const& dependency : job.maDependencies)
+            {
+                if(!maJobs[dependency.miJob].mbLive || dependency.mType == DependencyType::PreviousFrame)
+                {
+                    continue;
+                }
+
+                DEBUG_PRINTF("        after \"%s\", %s \"%s\"\n",
+                    maJobs[dependency.miJob].mName.c_str(),
+                    saszDependencyTypes[(uint32_t)dependency.mType],
+                    dependency.mResource.c_str());
+            }
+            for(auto const& input : job.maInputs)
+            {
+                if(input.mType == DependencyType::PreviousFrame)
+                {
+                    DEBUG_PRINTF("        %s \"%s\" of \"%s\"\n",
+                        saszDependencyTypes[(uint32_t)input.mType],
+                        input.mResource.c_str(),
+                        maJobs[input.miJob].mName.c_str());
+                }
+            }
+        }
+
+        for(auto const& job : maJobs)
+        {
+            if(!job.mbLive)
+            {
+                DEBUG_PRINTF("culled %s, nothing reads its outputs\n", job.mName.c_str());
+            }
+        }
+    }
+
+}   // Render
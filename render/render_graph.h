@@ -0,0 +1,185 @@
+#pragma once
+
+#include <render/render_utils.h>
+#include <render/render_job_descriptions.h>
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Render
+{
+    class CTransientAllocator;
+
+    /*
+    ** dependency graph of a render job list, compiled from the attachments of the jobs' pipeline files before any
+    ** job is created. no gpu objects, so the dry run tool can compile a job list on its own
+    **
+    ** resources    the attachments a job writes (TextureOutput, BufferOutput, TextureInputOutput in place of its
+    **              parent's, the depth texture of the mesh passes, the copies of the copy jobs), the indirect draws of
+    **              the culling jobs a mesh pass draws from, and the external shader resources. external
+    **              read_write_storage buffers count as written
+    ** reads        a read sees the last write listed before it, a read listed before the first write of a resource is
+    **              a read of the previous frame's value (the copy jobs' outputs, the depth pyramid in the early culling
+    **              jobs). the writers of a resource keep their listed order and wait for the reads before them
+    ** culling      jobs no live job reads from, this frame or the next, are dropped. the job drawn to the swap chain,
+    **              "Output Job" in the job list, and jobs with "Keep" are live
+    ** schedule     the live jobs in topological order, ties go to the listed order
+    ** transients   texture outputs only used between their first write and last read in a frame can share memory,
+    **              "Transient": "False" on an attachment keeps it to itself. buffers are often counters and indirect
+    **              draws the renderer clears or reads outside the jobs, they only share with "Transient": "True"
+    */
+    class CRenderGraph
+    {
+    public:
+        // pipeline file of a job, filePath is the "Pipeline" value of the job list
+        typedef CRenderJobDescriptions::LoadFileFunction LoadFileFunction;
+
+        enum class DependencyType
+        {
+            Read,               // reads what the job wrote this frame
+            PreviousFrame,      // reads what the job wrote last frame
+            Overwrite,          // writes over what the job wrote or read
+        };
+
+        struct Dependency
+        {
+            uint32_t            miJob;
+            DependencyType      mType;
+            std::string         mResource;
+        };
+
+        struct Job
+        {
+            std::string                 mName;
+            std::string                 mPipeline;
+            Render::JobType             mType = Render::JobType::Graphics;
+            std::string                 mPassType;
+            Render::OcclusionPhase      mOcclusionPhase = Render::OcclusionPhase::None;
+            uint32_t                    miListIndex = 0;            // in the job list's "Jobs", disabled ones included
+            uint32_t                    miNumFrames = 0;            // "Frames", only runs for the first frames
+            Render::ResolutionMode      mResolutionMode = Render::ResolutionMode::Full;    // sparse modes keep their outputs
+            bool                        mbKeep = false;
+            bool                        mbLive = false;
+
+            // jobs that run before this one, and the jobs whose writes it reads this frame or the previous one
+            std::vector<Dependency>     maDependencies;
+            std::vector<Dependency>     maInputs;
+
+            // resource keys, "<job>/<attachment>" with in place writes going to the first job of the chain, or
+            // "external/<name>"
+            std::vector<std::string>    maReads;
+            std::vector<std::string>    maWrites;
+        };
+
+    public:
+        CRenderGraph() = default;
+        virtual ~CRenderGraph() = default;
+
+        // false with getErrors() on a bad job list, missing parent job or attachment, or a cycle
+        bool compile(
+            char const* acJobList,
+            LoadFileFunction pfnLoadFile,
+            void* pUserData);
+
+        // of a job list that's already parsed or read from its compiled file
+        bool compile(CRenderJobDescriptions const& descriptions);
+
+        // the schedule with what every job waits for and reads from the previous frame, then the culled jobs
+        void print() const;
+
+        // same order as CRenderJobDescriptions::getJobs()
+        inline std::vector<Job> const& getJobs() const
+        {
+            return maJobs;
+        }
+
+        // indices into getJobs()
+        inline std::vector<uint32_t> const& getSchedule() const
+        {
+            return maiSchedule;
+        }
+
+        inline std::vector<std::string> const& getErrors() const
+        {
+            return maErrors;
+        }
+
+        inline std::string const& getOutputJob() const
+        {
+            return mOutputJob;
+        }
+
+        inline std::string const& getOutputAttachment() const
+        {
+            return mOutputAttachment;
+        }
+
+        // outputs of the scheduled jobs with their lifetimes over the schedule, sized for the screen
+        void addTransientResources(
+            CTransientAllocator& allocator,
+            uint32_t iScreenWidth,
+            uint32_t iScreenHeight) const;
+
+        // "Mesh" or "Cluster" culling job a mesh pass of the phase draws from
+        static std::string getCullingJobName(
+            std::string const& culling,
+            Render::OcclusionPhase occlusionPhase);
+
+    protected:
+        typedef CRenderJobDescriptions::Attachment Attachment;
+
+        struct ShaderResource
+        {
+            std::string                 mName;
+            bool                        mbWrite = false;
+        };
+
+        struct ResourceState
+        {
+            int32_t                     miFirstWriter = -1;
+            int32_t                     miLastWriter = -1;
+            std::vector<uint32_t>       maiReadsSinceWrite;
+            std::vector<uint32_t>       maiReadsBeforeFirstWrite;
+        };
+
+        void addJobs(CRenderJobDescriptions const& descriptions);
+
+        std::string getResourceKey(
+            std::string const& jobName,
+            std::string const& attachmentName,
+            uint32_t iDepth = 0) const;
+
+        int32_t findJob(std::string const& jobName) const;
+
+        bool hasOutput(
+            uint32_t iJob,
+            std::string const& attachmentName) const;
+
+        void addDependency(
+            uint32_t iJob,
+            uint32_t iBeforeJob,
+            DependencyType type,
+            std::string const& resource);
+
+        void linkResources();
+        void cullJobs();
+        bool schedule();
+
+    protected:
+        std::vector<Job>                        maJobs;
+        std::vector<uint32_t>                   maiSchedule;
+        std::vector<std::string>                maErrors;
+
+        std::string                             mOutputJob;
+        std::string                             mOutputAttachment;
+
+        // attachments and external shader resources of the jobs' pipeline files
+        std::vector<std::vector<Attachment>>            maaAttachments;
+        std::vector<std::vector<ShaderResource>>        maaShaderResources;
+
+        std::map<std::string, ResourceState>            maResources;
+    };
+
+}   // Render
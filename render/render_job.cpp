@@ -1,12 +1,94 @@
 #include <render/render_job.h>
-#include <rapidjson/document.h>
-#include <loader/loader.h>
 #include <utils/LogPrint.h>
 
+#include <string.h>
+
 #include <sstream>
 
 namespace Render
 {
+    struct VertexFormatInfo
+    {
+        char const*             mszName;
+        wgpu::VertexFormat      mFormat;
+        uint32_t                miSize;
+    };
+
+    static VertexFormatInfo const saVertexFormats[] =
+    {
+        {"Vec4", wgpu::VertexFormat::Float32x4, 16},
+        {"Vec3", wgpu::VertexFormat::Float32x3, 12},
+        {"Vec2", wgpu::VertexFormat::Float32x2, 8},
+        {"Float32x3", wgpu::VertexFormat::Float32x3, 12},
+        {"Uint16x4", wgpu::VertexFormat::Uint16x4, 8},
+        {"Float16x2", wgpu::VertexFormat::Float16x2, 4},
+        {"Snorm16x2", wgpu::VertexFormat::Snorm16x2, 4},
+    };
+
+    /*
+    ** attributes of the job's "VertexFormat" list at consecutive shader locations, returns the stride. jobs without
+    ** the list get the 3 x float4 Vertex layout
+    */
+    static uint32_t getVertexAttributes(
+        std::vector<wgpu::VertexAttribute>& aVertexAttributes,
+        Render::CRenderJobDescriptions::Job const& jobDesc)
+    {
+        std::vector<std::string> aFormatNames = {"Vec4", "Vec4", "Vec4"};
+        if(jobDesc.maVertexFormats.size() > 0)
+        {
+            aFormatNames = jobDesc.maVertexFormats;
+        }
+
+        uint32_t iOffset = 0;
+        aVertexAttributes.clear();
+        for(std::string const& formatName : aFormatNames)
+        {
+            VertexFormatInfo const* pFormatInfo = nullptr;
+            for(VertexFormatInfo const& formatInfo : saVertexFormats)
+            {
+                if(formatName == formatInfo.mszName)
+                {
+                    pFormatInfo = &formatInfo;
+                    break;
+                }
+            }
+
+            if(pFormatInfo == nullptr)
+            {
+                DEBUG_PRINTF("!!! unknown vertex format \"%s\" !!!\n", formatName.c_str());
+                assert(!"unknown vertex format");
+                continue;
+            }
+
+            wgpu::VertexAttribute attrib = {};
+            attrib.format = pFormatInfo->mFormat;
+            attrib.offset = iOffset;
+            attrib.shaderLocation = (uint32_t)aVertexAttributes.size();
+            aVertexAttributes.push_back(attrib);
+
+            iOffset += pFormatInfo->miSize;
+        }
+
+        return iOffset;
+    }
+
+    /*
+    ** the job's "Constants" for the wgsl override constants of every stage, the keys point into the description
+    */
+    static void getShaderConstants(
+        std::vector<wgpu::ConstantEntry>& aConstants,
+        Render::CRenderJobDescriptions::Job const& jobDesc)
+    {
+        aConstants.clear();
+        for(auto const& constant : jobDesc.maConstants)
+        {
+            wgpu::ConstantEntry constantEntry = {};
+            constantEntry.key = constant.first.c_str();
+            constantEntry.value = constant.second;
+            aConstants.push_back(constantEntry);
+        }
+    }
+
     /*
     **
     */
@@ -21,35 +103,27 @@ namespace Render
             return;
         }
 
-        char* acFileContent = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContent,
-            createInfo.mPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
+        assert(createInfo.mpJobDescription != nullptr);
+        Render::CRenderJobDescriptions::Job const& jobDesc = *createInfo.mpJobDescription;
 
-        rapidjson::Document doc;
+        // the pixels a sparse mode doesn't shade this frame keep the ones of the frames before
+        if(jobDesc.mResolutionMode != Render::ResolutionMode::Full)
         {
-            doc.Parse(acFileContent);
-            Loader::loadFileFree(acFileContent);
-            DEBUG_PRINTF("parse json \"%s\"\n", createInfo.mPipelineFilePath.c_str());
-
+            mLoadOp = wgpu::LoadOp::Load;
         }
 
         std::vector< wgpu::ColorTargetState> aTargetStates;
         uint32_t iNumOutputAttachments = 0;
-        auto const& attachments = doc["Attachments"].GetArray();
-        for(auto const& attachment : attachments)
+        for(auto const& attachment : jobDesc.maAttachments)
         {
-            std::string attachmentName = attachment["Name"].GetString();
-            std::string attachmentType = attachment["Type"].GetString();
+            std::string const& attachmentName = attachment.mName;
+            std::string const& attachmentType = attachment.mType;
 
             std::vector<wgpu::TextureFormat> aViewFormats;
             wgpu::ColorTargetState colorTargetState = {};
             if(attachmentType == "TextureOutput")
             {
-                std::string attachmentFormat = attachment["Format"].GetString();
+                std::string const& attachmentFormat = attachment.mFormat;
 
                 wgpu::TextureFormat format = wgpu::TextureFormat::RGBA32Float;
                 if(attachmentFormat == "rgba16float")
@@ -70,24 +144,16 @@ namespace Render
                 }
                 aViewFormats.push_back(format);
 
-                float fScaleX = 1.0f, fScaleY = 1.0f;
-                if(attachment.HasMember("ScaleWidth"))
-                {
-                    fScaleX = attachment["ScaleWidth"].GetFloat();
-                }
-
-                if(attachment.HasMember("ScaleHeight"))
-                {
-                    fScaleY = attachment["ScaleHeight"].GetFloat();
-                }
+                uint32_t aiTargetSize[2];
+                Render::getTargetSize(aiTargetSize, createInfo.miScreenWidth, createInfo.miScreenHeight, attachment.mfScaleWidth, attachment.mfScaleHeight);
 
                 // create texture
                 wgpu::TextureDescriptor textureDescriptor = {};
                 textureDescriptor.format = format;
                 textureDescriptor.label = attachmentName.c_str();
                 textureDescriptor.dimension = wgpu::TextureDimension::e2D;
-                textureDescriptor.size.width = uint32_t((float)createInfo.miScreenWidth * fScaleX);
-                textureDescriptor.size.height = uint32_t((float)createInfo.miScreenHeight * fScaleY);
+                textureDescriptor.size.width = aiTargetSize[0];
+                textureDescriptor.size.height = aiTargetSize[1];
                 textureDescriptor.size.depthOrArrayLayers = 1;
                 textureDescriptor.mipLevelCount = 1;
                 textureDescriptor.sampleCount = 1;
@@ -103,9 +169,20 @@ namespace Render
                     textureDescriptor.usage |= wgpu::TextureUsage::CopyDst;
                 }
 
-                mOutputImageAttachments[attachmentName] = createInfo.mpDevice->CreateTexture(&textureDescriptor);
-
-                mOutputImageAttachments[attachmentName].SetLabel(std::string(mName + "-" + attachmentName).c_str());
+                int32_t iSlot = (createInfo.mpTransientAllocator != nullptr) ? createInfo.mpTransientAllocator->getSlot(mName + "/" + attachmentName) : -1;
+                if(iSlot >= 0 && (*createInfo.mpaTransientTextures)[iSlot] != nullptr)
+                {
+                    mOutputImageAttachments[attachmentName] = (*createInfo.mpaTransientTextures)[iSlot];
+                }
+                else
+                {
+                    mOutputImageAttachments[attachmentName] = createInfo.mpDevice->CreateTexture(&textureDescriptor);
+                    mOutputImageAttachments[attachmentName].SetLabel(std::string(mName + "-" + attachmentName).c_str());
+                    if(iSlot >= 0)
+                    {
+                        (*createInfo.mpaTransientTextures)[iSlot] = mOutputImageAttachments[attachmentName];
+                    }
+                }
 
                 // save format
                 wgpu::ColorTargetState targetState = {};
@@ -136,12 +213,8 @@ namespace Render
                     continue;
                 }
 
-                std::string usage = "";
-                uint32_t iSize = attachment["Size"].GetUint();
-                if(attachment.HasMember("Usage"))
-                {
-                    usage = attachment["Usage"].GetString();
-                }
+                std::string const& usage = attachment.mUsage;
+                uint32_t iSize = attachment.miSize;
 
                 wgpu::BufferDescriptor bufferDesc = {};
                 bufferDesc.size = iSize;
@@ -157,9 +230,21 @@ namespace Render
                     bufferDesc.usage |= wgpu::BufferUsage::Vertex;
                 }
 
-                mOutputBufferAttachments[attachmentName] = createInfo.mpDevice->CreateBuffer(&bufferDesc);
+                int32_t iSlot = (createInfo.mpTransientAllocator != nullptr) ? createInfo.mpTransientAllocator->getSlot(mName + "/" + attachmentName) : -1;
+                if(iSlot >= 0 && (*createInfo.mpaTransientBuffers)[iSlot] != nullptr)
+                {
+                    mOutputBufferAttachments[attachmentName] = (*createInfo.mpaTransientBuffers)[iSlot];
+                }
+                else
+                {
+                    mOutputBufferAttachments[attachmentName] = createInfo.mpDevice->CreateBuffer(&bufferDesc);
+                    mOutputBufferAttachments[attachmentName].SetLabel(attachmentName.c_str());
+                    if(iSlot >= 0)
+                    {
+                        (*createInfo.mpaTransientBuffers)[iSlot] = mOutputBufferAttachments[attachmentName];
+                    }
+                }
                 mAttachmentOrder.push_back(std::make_pair(attachmentName, std::make_pair(attachmentType, "r32float")));
-                mOutputBufferAttachments[attachmentName].SetLabel(attachmentName.c_str());
             }
             else if(attachmentType == "TextureInput")
             {
@@ -176,116 +261,90 @@ namespace Render
             return;
         }
 
-        if(doc.HasMember("ShaderResources"))
+        for(auto const& shaderResource : jobDesc.maShaderResources)
         {
-            auto const& aShaderResources = doc["ShaderResources"].GetArray();
-            for(auto const& shaderResource : aShaderResources)
-            {
-                std::map<std::string, std::string> uniformInfo;
-                uniformInfo["name"] = shaderResource["name"].GetString();
-                uniformInfo["type"] = shaderResource["type"].GetString();
-                uniformInfo["usage"] = shaderResource["usage"].GetString();
-                uniformInfo["sample"] = "float";
-                if(shaderResource.HasMember("sample"))
-                {
-                    uniformInfo["sample"] = shaderResource["sample"].GetString();
-                }
+            std::map<std::string, std::string> uniformInfo;
+            uniformInfo["name"] = shaderResource.mName;
+            uniformInfo["type"] = shaderResource.mType;
+            uniformInfo["usage"] = shaderResource.mUsage;
+            uniformInfo["sample"] = shaderResource.mSample;
 
-                if(uniformInfo["type"] == "buffer")
+            if(uniformInfo["type"] == "buffer")
+            {
+                uint32_t iSize = 0;
+                if(shaderResource.mbSize || shaderResource.mbExternal == false)
                 {
-                    uint32_t iSize = 0;
-                    if(shaderResource.HasMember("size") || shaderResource.HasMember("external") == false)
-                    {
-                        iSize = shaderResource["size"].GetUint();
-
-                        std::string shaderStage = shaderResource["shader_stage"].GetString();
+                    iSize = shaderResource.miSize;
 
-                        wgpu::BufferDescriptor bufferDesc = {};
-                        bufferDesc.label = uniformInfo["name"].c_str();
-                        bufferDesc.size = iSize;
-                        if(uniformInfo["usage"] == "read_only_storage")
-                        {
-                            bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
-                        }
-                        else if(uniformInfo["usage"] == "uniform")
-                        {
-                            bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
-                        }
-                        else if(uniformInfo["usage"] == "read_write_storage")
-                        {
-                            bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
-                        }
-                        else if(uniformInfo["usage"] == "write_only_storage")
-                        {
-                            bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
-                        }
-                        else if(uniformInfo["usage"] == "constant_buffer")
-                        {
-                            bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
-                        }
+                    std::string const& shaderStage = shaderResource.mShaderStage;
 
-                        mUniformBuffers[uniformInfo["name"]] = createInfo.mpDevice->CreateBuffer(&bufferDesc);
+                    wgpu::BufferDescriptor bufferDesc = {};
+                    bufferDesc.label = uniformInfo["name"].c_str();
+                    bufferDesc.size = iSize;
+                    if(uniformInfo["usage"] == "read_only_storage")
+                    {
+                        bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+                    }
+                    else if(uniformInfo["usage"] == "uniform")
+                    {
+                        bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
+                    }
+                    else if(uniformInfo["usage"] == "read_write_storage")
+                    {
+                        bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
+                    }
+                    else if(uniformInfo["usage"] == "write_only_storage")
+                    {
+                        bufferDesc.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
+                    }
+                    else if(uniformInfo["usage"] == "constant_buffer")
+                    {
+                        bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc;
+                    }
 
-                        std::vector<char> acData(iSize);
-                        char* pcData = acData.data();
-                        if(uniformInfo["usage"] == "constant_buffer")
-                        {
-                            auto dataObjectArray = shaderResource["data"].GetArray();
-                            for(auto& dataObject : dataObjectArray)
-                            {
-                                auto typeStr = std::string(dataObject["type"].GetString());
-                                if(typeStr == "float")
-                                {
-                                    float fValue = dataObject["value"].GetFloat();
-
-                                    float* pfData = (float*)pcData;
-                                    *pfData++ = fValue;
-                                    pcData = (char*)pfData;
-                                }
-                                else if(typeStr == "int")
-                                {
-                                    int32_t iValue = dataObject["value"].GetInt();
-                                    int32_t* piData = (int32_t*)pcData;
-                                    *piData++ = iValue;
-                                    pcData = (char*)piData;
-                                }
-                            }
-                        }
+                    mUniformBuffers[uniformInfo["name"]] = createInfo.mpDevice->CreateBuffer(&bufferDesc);
 
-                        createInfo.mpDevice->GetQueue().WriteBuffer(
-                            mUniformBuffers[uniformInfo["name"]],
-                            0,
-                            acData.data(),
-                            iSize
-                        );
-                    }
-                    else
+                    // constant buffer data is packed in the description
+                    std::vector<char> acData(iSize);
+                    if(uniformInfo["usage"] == "constant_buffer")
                     {
-                        uint32_t iBufferSize = 0;
-                        mUniformBuffers[uniformInfo["name"]] = createInfo.mpfnGetBuffer(iBufferSize, uniformInfo["name"], createInfo.mpUserData);
+                        assert(shaderResource.macData.size() <= iSize);
+                        memcpy(acData.data(), shaderResource.macData.data(), shaderResource.macData.size());
                     }
+
+                    createInfo.mpDevice->GetQueue().WriteBuffer(
+                        mUniformBuffers[uniformInfo["name"]],
+                        0,
+                        acData.data(),
+                        iSize
+                    );
                 }
-                else if(uniformInfo["type"] == "texture")
+                else
                 {
-                    std::string shaderStage = shaderResource["shader_stage"].GetString();
-                    bool bExternalTexture = false;
-                    if(shaderResource.HasMember("external"))
-                    {
-                        mUniformTextures[uniformInfo["name"]] = createInfo.mpfnGetTexture(uniformInfo["name"], createInfo.mpUserData);
-                    }
+                    uint32_t iBufferSize = 0;
+                    mUniformBuffers[uniformInfo["name"]] = createInfo.mpfnGetBuffer(iBufferSize, uniformInfo["name"], createInfo.mpUserData);
+                }
+            }
+            else if(uniformInfo["type"] == "texture")
+            {
+                std::string const& shaderStage = shaderResource.mShaderStage;
+                bool bExternalTexture = false;
+                if(shaderResource.mbExternal)
+                {
+                    mUniformTextures[uniformInfo["name"]] = createInfo.mpfnGetTexture(uniformInfo["name"], createInfo.mpUserData);
                 }
+            }
 
-                mUniformOrder.push_back(uniformInfo);
+            mUniformOrder.push_back(uniformInfo);
 
-            }   // for shader
-        }
+        }   // for shader
 
-        if(doc.HasMember("DepthStencilState"))
+        if(jobDesc.mbDepthStencilState)
         {
-            bool bDepthEnable = (std::string(doc["DepthStencilState"]["DepthEnable"].GetString()) == "True");
-            std::string depthWriteMask = doc["DepthStencilState"]["DepthWriteMask"].GetString();
-            std::string depthFunc = doc["DepthStencilState"]["DepthFunc"].GetString();
-            bool bStencil = (std::string(doc["DepthStencilState"]["StencilEnable"].GetString()) == "True");
+            bool bDepthEnable = jobDesc.mbDepthEnable;
+            std::string const& depthWriteMask = jobDesc.mDepthWriteMask;
+            std::string const& depthFunc = jobDesc.mDepthFunc;
+            bool bStencil = jobDesc.mbStencilEnable;
 
             mDepthStencilState.depthWriteEnabled = (depthWriteMask == "One");
 
@@ -334,10 +393,10 @@ namespace Render
         }
 
         mFrontFace = wgpu::FrontFace::CCW;
-        if(doc.HasMember("RasterState"))
+        if(jobDesc.mbRasterState)
         {
-            std::string cullMode = doc["RasterState"]["CullMode"].GetString();
-            std::string frontFace = doc["RasterState"]["FrontFace"].GetString();
+            std::string const& cullMode = jobDesc.mCullMode;
+            std::string const& frontFace = jobDesc.mFrontFace;
 
             if(cullMode == "None")
             {
@@ -361,22 +420,14 @@ namespace Render
                 mFrontFace = wgpu::FrontFace::CW;
             }
 
-            if(doc["RasterState"].HasMember("LoadOp"))
+            if(jobDesc.mLoadOp == "Load")
             {
-                std::string loadOp = doc["RasterState"]["LoadOp"].GetString();
-                if(loadOp == "Load")
-                {
-                    mLoadOp = wgpu::LoadOp::Load;
-                }
+                mLoadOp = wgpu::LoadOp::Load;
             }
 
-            if(doc["RasterState"].HasMember("StoreOp"))
+            if(jobDesc.mStoreOp == "Discard")
             {
-                std::string storeOp = doc["RasterState"]["StoreOp"].GetString();
-                if(storeOp == "Discard")
-                {
-                    mStoreOp = wgpu::StoreOp::Discard;
-                }
+                mStoreOp = wgpu::StoreOp::Discard;
             }
         }
     }
@@ -386,34 +437,23 @@ namespace Render
     */
     void CRenderJob::setCopyAttachments(CreateInfo& createInfo)
     {
-        char* acFileContent = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContent,
-            createInfo.mPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
-
-        rapidjson::Document doc;
-        {
-            doc.Parse(acFileContent);
-            Loader::loadFileFree(acFileContent);
+        // copies don't have a pipeline to wait on
+        mbPipelineReady = true;
 
-            DEBUG_PRINTF("parse json \"%s\"\n", createInfo.mPipelineFilePath.c_str());
-        }
+        assert(createInfo.mpJobDescription != nullptr);
+        Render::CRenderJobDescriptions::Job const& jobDesc = *createInfo.mpJobDescription;
 
         std::vector<Render::CRenderJob*>& apRenderJobs = *(createInfo.mpaRenderJobs);
 
-        auto const& attachments = doc["Attachments"].GetArray();
-        for(auto const& attachment : attachments)
+        for(auto const& attachment : jobDesc.maAttachments)
         {
-            std::string attachmentName = attachment["Name"].GetString();
-            std::string attachmentType = attachment["Type"].GetString();
+            std::string const& attachmentName = attachment.mName;
+            std::string const& attachmentType = attachment.mType;
 
             if(attachmentType == "TextureOutput")
             {
-                std::string parentJobName = attachment["ParentJobName"].GetString();
-                std::string parentName = attachment["ParentName"].GetString();
+                std::string const& parentJobName = attachment.mParentJob;
+                std::string const& parentName = attachment.mParentName;
 
                 // get parent render job
                 auto iter = std::find_if(
@@ -461,8 +501,8 @@ namespace Render
             }
             else if(attachmentType == "BufferOutput")
             {
-                std::string parentJobName = attachment["ParentJobName"].GetString();
-                std::string parentName = attachment["ParentName"].GetString();
+                std::string const& parentJobName = attachment.mParentJob;
+                std::string const& parentName = attachment.mParentName;
 
                 // get parent render job
                 auto iter = std::find_if(
@@ -508,24 +548,8 @@ namespace Render
         mType = createInfo.mJobType;
         mPassType = createInfo.mPassType;
 
-        char* acFileContent = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContent,
-            createInfo.mPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
-
-        rapidjson::Document doc;
-        {
-            doc.Parse(acFileContent);
-            Loader::loadFileFree(acFileContent);
-
-            DEBUG_PRINTF("%s : %d parse json \"%s\"\n",
-                __FILE__,
-                __LINE__,
-                createInfo.mPipelineFilePath.c_str());
-        }
+        assert(createInfo.mpJobDescription != nullptr);
+        Render::CRenderJobDescriptions::Job const& jobDesc = *createInfo.mpJobDescription;
 
         // fill out input attachments 
         // fill out input attachments 
@@ -533,18 +557,13 @@ namespace Render
         Render::CRenderJob* pParentJob = nullptr;
         std::vector< wgpu::ColorTargetState> aTargetStates;
         uint32_t iNumOutputAttachments = 0;
-        auto const& attachments = doc["Attachments"].GetArray();
-        for(auto const& attachment : attachments)
+        for(auto const& attachment : jobDesc.maAttachments)
         {
-            std::string attachmentType = attachment["Type"].GetString();
+            std::string const& attachmentType = attachment.mType;
 
             if(mType == Render::JobType::Graphics)
             {
-                std::string attachmentFormat = "";
-                if(attachment.HasMember("Format"))
-                {
-                    attachmentFormat = attachment["Format"].GetString();
-                }
+                std::string const& attachmentFormat = attachment.mFormat;
 
                 wgpu::TextureFormat format = wgpu::TextureFormat::RGBA32Float;
                 if(attachmentFormat == "rgba16float")
@@ -570,8 +589,8 @@ namespace Render
             wgpu::ColorTargetState colorTargetState = {};
             if(attachmentType == "TextureInput" || attachmentType == "TextureInputOutput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
 
                 for(auto& renderJob : aRenderJobs)
                 {
@@ -635,8 +654,8 @@ namespace Render
             }   // if attachment type == Texture input
             else if(attachmentType == "VertexBufferInput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
 
                 auto renderJobIter = std::find_if(
                     aRenderJobs.begin(),
@@ -662,8 +681,8 @@ namespace Render
             }
             else if(attachmentType == "BufferInput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
 
                 auto renderJobIter = std::find_if(
                     aRenderJobs.begin(),
@@ -703,40 +722,22 @@ namespace Render
         mName = createInfo.mName;
         mType = createInfo.mJobType;
         mPassType = createInfo.mPassType;
+        mbPipelineReady = false;
 
-        char* acFileContent = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContent,
-            createInfo.mPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
-
-        rapidjson::Document doc;
-        {
-            doc.Parse(acFileContent);
-            Loader::loadFileFree(acFileContent);
-
-            DEBUG_PRINTF("%s : %d parse json \"%s\"\n",
-                __FILE__,
-                __LINE__,
-                createInfo.mPipelineFilePath.c_str());
-        }
+        assert(createInfo.mpJobDescription != nullptr);
+        Render::CRenderJobDescriptions::Job const& jobDesc = *createInfo.mpJobDescription;
 
         // check for TextureInputOutput
         bool bHasInputOutputAttachment = false;
         CRenderJob* pParentJob = nullptr;
         std::vector<CRenderJob*>& aRenderJobs = *createInfo.mpaRenderJobs;
-        auto const& attachments = doc["Attachments"].GetArray();
-        for(auto const& attachment : attachments)
+        for(auto const& attachment : jobDesc.maAttachments)
         {
-            std::string attachmentName = attachment["Name"].GetString();
-            std::string attachmentParentJobName = "";
-            if(attachment.HasMember("ParentJobName"))
+            std::string const& attachmentName = attachment.mName;
+            std::string const& attachmentParentJobName = attachment.mParentJob;
+            if(attachmentParentJobName.length() > 0)
             {
-                attachmentParentJobName = attachment["ParentJobName"].GetString();
-
-                std::string attachmentType = attachment["Type"].GetString();
+                std::string const& attachmentType = attachment.mType;
                 auto iter = std::find_if(
                     aRenderJobs.begin(),
                     aRenderJobs.end(),
@@ -755,46 +756,38 @@ namespace Render
             }
         }
         
-        // shader code
-        wgpu::ShaderModuleWGSLDescriptor wgslDesc = {};
-        std::string shaderPath = std::string("shaders/") + doc["Shader"].GetString();
+        // shader code with the job's defines, jobs with the same variant share the module
+        std::string shaderPath = jobDesc.mShader;
 #if defined(__EMSCRIPTEN__)
-        if(doc.HasMember("Emscripten Shader"))
+        if(jobDesc.mEmscriptenShader.length() > 0)
         {
-            shaderPath = std::string("shaders/") + doc["Emscripten Shader"].GetString();
+            shaderPath = jobDesc.mEmscriptenShader;
             printf("!!! USE EMSCRIPTEN SHADER !!!\n");
         }
 #endif // __EMSCRIPTEN__
-        
-        char* acShaderFileContent = nullptr;
-        iDataSize = Loader::loadFile(
-            &acShaderFileContent,
-            shaderPath,
-            true
-        );
-        assert(iDataSize > 0);
-        wgslDesc.code = acShaderFileContent;
-
-        //printf("shader content: %s\n", acShaderFileContent);
-
-//#else 
-//        std::vector<char> acShaderFileContent;
-//        Loader::loadFile(
-//            acShaderFileContent,
-//            shaderPath,
-//            true
-//        );
-//        wgslDesc.code = acShaderFileContent.data();
-//#endif // __EMSCRIPTEN__
 
-        wgpu::ShaderModuleDescriptor shaderModuleDescriptor
+        assert(createInfo.mpShaderPreprocessor != nullptr);
+        std::string const* pShaderCode = createInfo.mpShaderPreprocessor->preprocess(
+            shaderPath,
+            jobDesc.maDefines);
+        if(pShaderCode == nullptr)
         {
-            .nextInChain = &wgslDesc
-        };
-        wgpu::ShaderModule shaderModule = createInfo.mpDevice->CreateShaderModule(&shaderModuleDescriptor);
-        shaderModule.SetLabel(std::string(mName + " Shader Module").c_str());
+            for(auto const& error : createInfo.mpShaderPreprocessor->getErrors())
+            {
+                DEBUG_PRINTF("!!! %s !!!\n", error.c_str());
+            }
+            assert(!"can't preprocess shader");
+        }
 
-        Loader::loadFileFree(acShaderFileContent);
+        assert(createInfo.mpPipelineCache != nullptr);
+        wgpu::ShaderModule shaderModule = createInfo.mpPipelineCache->getShaderModule(
+            *createInfo.mpDevice,
+            pShaderCode->c_str(),
+            mName + " Shader Module");
+
+        // override constants, the specialized pipeline drops the branches on them
+        std::vector<wgpu::ConstantEntry> aConstants;
+        getShaderConstants(aConstants, jobDesc);
 
         wgpu::BlendState blendState = {};
         blendState.color.srcFactor = wgpu::BlendFactor::SrcAlpha;
@@ -828,7 +821,6 @@ namespace Render
         wgpu::VertexState vertexState = {};
         wgpu::VertexBufferLayout vertexBufferLayout = {};
         std::vector<wgpu::VertexAttribute> aVertexAttributes;
-        wgpu::VertexAttribute attrib = {};
 
         if(mType == Render::JobType::Graphics)
         {
@@ -836,27 +828,20 @@ namespace Render
             fragmentState.targetCount = (uint32_t)mOutputImageAttachments.size();
             fragmentState.targets = aColorTargetState.data();
             fragmentState.entryPoint = "fs_main";
-
-            attrib.format = wgpu::VertexFormat::Float32x4;
-            attrib.offset = 0;
-            attrib.shaderLocation = 0;
-            aVertexAttributes.push_back(attrib);
-            attrib.offset = sizeof(float4);
-            attrib.shaderLocation = 1;
-            aVertexAttributes.push_back(attrib);
-            attrib.offset = sizeof(float4) * 2;
-            attrib.shaderLocation = 2;
-            aVertexAttributes.push_back(attrib);
+            fragmentState.constants = aConstants.data();
+            fragmentState.constantCount = aConstants.size();
 
             // vertex layout
-            vertexBufferLayout.attributeCount = 3;
-            vertexBufferLayout.arrayStride = sizeof(float4) * 3;
+            vertexBufferLayout.arrayStride = getVertexAttributes(aVertexAttributes, jobDesc);
+            vertexBufferLayout.attributeCount = (uint32_t)aVertexAttributes.size();
             vertexBufferLayout.attributes = aVertexAttributes.data();
             vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
 
             // vertex shader
             vertexState.module = shaderModule;
             vertexState.entryPoint = "vs_main";
+            vertexState.constants = aConstants.data();
+            vertexState.constantCount = aConstants.size();
             vertexState.buffers = &vertexBufferLayout;
             vertexState.bufferCount = 1;
         }
@@ -1108,7 +1093,8 @@ namespace Render
 
         // uniforms for different meshes
         if(mType == Render::JobType::Graphics &&
-            (mPassType == Render::PassType::DrawMeshes || mPassType == Render::PassType::DrawAnimatedMesh))
+            (mPassType == Render::PassType::DrawMeshes || mPassType == Render::PassType::DrawAnimatedMesh ||
+            mPassType == Render::PassType::DrawStaticMeshes || mPassType == Render::PassType::DrawDynamicMeshes))
         {
             aaBindGroupLayoutEntries.resize(3);
             aaBindingGroupEntries.resize(3);
@@ -1146,18 +1132,16 @@ namespace Render
             );
         }
 
-        // bind group layouts
+        // bind group layouts, shared with the jobs that have the same bindings
         std::vector<wgpu::BindGroupLayout> aBindGroupLayout(aaBindGroupLayoutEntries.size());
         for(uint32_t iGroup = 0; iGroup < aaBindingGroupEntries.size(); iGroup++)
         {
-            wgpu::BindGroupLayoutDescriptor groupLayoutDesc = {};
-            groupLayoutDesc.entryCount = (uint32_t)aaBindGroupLayoutEntries[iGroup].size();
-            groupLayoutDesc.entries = aaBindGroupLayoutEntries[iGroup].data();
-            aBindGroupLayout[iGroup] = createInfo.mpDevice->CreateBindGroupLayout(&groupLayoutDesc);
-
             std::ostringstream oss;
             oss << mName << " Bind Group Layout " << iGroup;
-            aBindGroupLayout[iGroup].SetLabel(oss.str().c_str());
+            aBindGroupLayout[iGroup] = createInfo.mpPipelineCache->getBindGroupLayout(
+                *createInfo.mpDevice,
+                aaBindGroupLayoutEntries[iGroup],
+                oss.str());
         }
 
         // bind group
@@ -1177,10 +1161,9 @@ namespace Render
         }
 
         // pipeline layout
-        wgpu::PipelineLayoutDescriptor layoutDesc = {};
-        layoutDesc.bindGroupLayoutCount = (uint32_t)aBindGroupLayout.size();
-        layoutDesc.bindGroupLayouts = aBindGroupLayout.data();
-        wgpu::PipelineLayout pipelineLayout = createInfo.mpDevice->CreatePipelineLayout(&layoutDesc);
+        wgpu::PipelineLayout pipelineLayout = createInfo.mpPipelineCache->getPipelineLayout(
+            *createInfo.mpDevice,
+            aBindGroupLayout);
 
         // pipeine descriptor
         std::string pipelineName = mName + " Pipeline";
@@ -1197,8 +1180,33 @@ namespace Render
             pipelineDescriptor.depthStencil = &mDepthStencilState;
             pipelineDescriptor.layout = pipelineLayout;
             mDepthStencilState.format = wgpu::TextureFormat::Depth32Float;
-            mRenderPipeline = createInfo.mpDevice->CreateRenderPipeline(&pipelineDescriptor);
-            mRenderPipeline.SetLabel(pipelineDescriptor.label);
+            if(createInfo.mbAsyncPipelines)
+            {
+                createInfo.mpPipelineCache->createRenderPipelineAsync(
+                    *createInfo.mpDevice,
+                    pipelineDescriptor,
+                    [](wgpu::RenderPipeline const& pipeline, void* pUserData)
+                    {
+                        // failed to compile, the job stays skipped
+                        CRenderJob* pRenderJob = (CRenderJob*)pUserData;
+                        if(pipeline == nullptr)
+                        {
+                            DEBUG_PRINTF("!!! no render pipeline for \"%s\", skipping it !!!\n",
+                                pRenderJob->mName.c_str());
+                            return;
+                        }
+                        pRenderJob->mRenderPipeline = pipeline;
+                        pRenderJob->mbPipelineReady = true;
+                    },
+                    this);
+            }
+            else
+            {
+                mRenderPipeline = createInfo.mpPipelineCache->getRenderPipeline(
+                    *createInfo.mpDevice,
+                    pipelineDescriptor);
+                mbPipelineReady = true;
+            }
 
             // depth texture
             mDepthStencilViewFormat = wgpu::TextureFormat::Depth32Float;
@@ -1248,22 +1256,48 @@ namespace Render
             wgpu::ProgrammableStageDescriptor computeDesc = {};
             computeDesc.module = shaderModule;
             computeDesc.entryPoint = "cs_main";
-            computeDesc.constants = nullptr;
-            computeDesc.constantCount = 0;
+            computeDesc.constants = aConstants.data();
+            computeDesc.constantCount = aConstants.size();
 #else 
             wgpu::ComputeState computeDesc = {};
             computeDesc.module = shaderModule;
             computeDesc.entryPoint = "cs_main";
-            computeDesc.constants = nullptr;
-            computeDesc.constantCount = 0;
+            computeDesc.constants = aConstants.data();
+            computeDesc.constantCount = aConstants.size();
 #endif // __EMSCRIPTEN__
 
+            std::string pipelineName = mName + " Compute Pipeline";
             wgpu::ComputePipelineDescriptor pipelineDescriptor = {};
             pipelineDescriptor.compute = computeDesc;
             pipelineDescriptor.layout = pipelineLayout;
-            mComputePipeline = createInfo.mpDevice->CreateComputePipeline(&pipelineDescriptor);
-            std::string pipelineName = mName + " Compute Pipeline";
-            mComputePipeline.SetLabel(pipelineName.c_str());
+            pipelineDescriptor.label = pipelineName.c_str();
+            if(createInfo.mbAsyncPipelines)
+            {
+                createInfo.mpPipelineCache->createComputePipelineAsync(
+                    *createInfo.mpDevice,
+                    pipelineDescriptor,
+                    [](wgpu::ComputePipeline const& pipeline, void* pUserData)
+                    {
+                        // failed to compile, the job stays skipped
+                        CRenderJob* pRenderJob = (CRenderJob*)pUserData;
+                        if(pipeline == nullptr)
+                        {
+                            DEBUG_PRINTF("!!! no compute pipeline for \"%s\", skipping it !!!\n",
+                                pRenderJob->mName.c_str());
+                            return;
+                        }
+                        pRenderJob->mComputePipeline = pipeline;
+                        pRenderJob->mbPipelineReady = true;
+                    },
+                    this);
+            }
+            else
+            {
+                mComputePipeline = createInfo.mpPipelineCache->getComputePipeline(
+                    *createInfo.mpDevice,
+                    pipelineDescriptor);
+                mbPipelineReady = true;
+            }
 
             printf("create pipeline: \"%s\"\n", pipelineName.c_str());
         }
@@ -1282,56 +1316,26 @@ namespace Render
         mType = createInfo.mJobType;
         mPassType = createInfo.mPassType;
 
-        char* acFileContent = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContent,
-            createInfo.mPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
+        assert(createInfo.mpJobDescription != nullptr);
+        Render::CRenderJobDescriptions::Job const& jobDesc = *createInfo.mpJobDescription;
 
-        rapidjson::Document doc;
-        {
-            doc.Parse(acFileContent);
-            Loader::loadFileFree(acFileContent);
-
-            DEBUG_PRINTF("%s : %d parse json \"%s\"\n",
-                __FILE__,
-                __LINE__,
-                createInfo.mPipelineFilePath.c_str());
-        }
-
-        // shader code
+        // shader code, the shaders include their shared structs
         wgpu::ShaderModuleWGSLDescriptor wgslDesc = {};
-        std::string shaderPath = std::string("shaders/") + doc["Shader"].GetString();
+        std::string shaderPath = jobDesc.mShader;
 #if defined(__EMSCRIPTEN__)
-        if(doc.HasMember("Emscripten Shader"))
+        if(jobDesc.mEmscriptenShader.length() > 0)
         {
-            shaderPath = std::string("shaders/") + doc["Emscripten Shader"].GetString();
+            shaderPath = jobDesc.mEmscriptenShader;
             printf("!!! USE EMSCRIPTEN SHADER !!!\n");
         }
 #endif // __EMSCRIPTEN__
 
-        char* acShaderFileContent = nullptr;
-        iDataSize = Loader::loadFile(
-            &acShaderFileContent,
+        assert(createInfo.mpShaderPreprocessor != nullptr);
+        std::string const* pShaderCode = createInfo.mpShaderPreprocessor->preprocess(
             shaderPath,
-            true
-        );
-        assert(iDataSize > 0);
-        wgslDesc.code = acShaderFileContent;
-
-        //printf("shader content: %s\n", acShaderFileContent);
-
-//#else 
-//        std::vector<char> acShaderFileContent;
-//        Loader::loadFile(
-//            acShaderFileContent,
-//            shaderPath,
-//            true
-//        );
-//        wgslDesc.code = acShaderFileContent.data();
-//#endif // __EMSCRIPTEN__
+            jobDesc.maDefines);
+        assert(pShaderCode != nullptr);
+        wgslDesc.code = pShaderCode->c_str();
 
         wgpu::ShaderModuleDescriptor shaderModuleDescriptor
         {
@@ -1340,26 +1344,19 @@ namespace Render
         wgpu::ShaderModule shaderModule = createInfo.mpDevice->CreateShaderModule(&shaderModuleDescriptor);
         shaderModule.SetLabel(std::string(mName + " Shader Module").c_str());
 
-        Loader::loadFileFree(acShaderFileContent);
-
         // fill out input attachments 
         // fill out input attachments 
         bool bHasInputOutputAttachment = false;
         Render::CRenderJob* pParentJob = nullptr;
         std::vector< wgpu::ColorTargetState> aTargetStates;
         uint32_t iNumOutputAttachments = 0;
-        auto const& attachments = doc["Attachments"].GetArray();
-        for(auto const& attachment : attachments)
+        for(auto const& attachment : jobDesc.maAttachments)
         {
-            std::string attachmentType = attachment["Type"].GetString();
+            std::string const& attachmentType = attachment.mType;
 
             if(mType == Render::JobType::Graphics)
             {
-                std::string attachmentFormat = "";
-                if(attachment.HasMember("Format"))
-                {
-                    attachmentFormat = attachment["Format"].GetString();
-                }
+                std::string const& attachmentFormat = attachment.mFormat;
 
                 wgpu::TextureFormat format = wgpu::TextureFormat::RGBA32Float;
                 if(attachmentFormat == "rgba16float")
@@ -1387,8 +1384,8 @@ namespace Render
             wgpu::ColorTargetState colorTargetState = {};
             if(attachmentType == "TextureInput" || attachmentType == "TextureInputOutput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
 
                 for(auto& renderJob : aRenderJobs)
                 {
@@ -1457,8 +1454,8 @@ namespace Render
             }   // if attachment type == Texture input
             else if(attachmentType == "VertexBufferInput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
 
                 auto renderJobIter = std::find_if(
                     aRenderJobs.begin(),
@@ -1484,8 +1481,8 @@ namespace Render
             }
             else if(attachmentType == "BufferInput")
             {
-                std::string attachmentName = attachment["Name"].GetString();
-                std::string attachmentParentJobName = attachment["ParentJobName"].GetString();
+                std::string const& attachmentName = attachment.mName;
+                std::string const& attachmentParentJobName = attachment.mParentJob;
                 
                 auto renderJobIter = std::find_if(
                     aRenderJobs.begin(),
@@ -1549,7 +1546,6 @@ namespace Render
         wgpu::VertexState vertexState = {};
         wgpu::VertexBufferLayout vertexBufferLayout = {};
         std::vector<wgpu::VertexAttribute> aVertexAttributes;
-        wgpu::VertexAttribute attrib = {};
 
         if(mType == Render::JobType::Graphics)
         {
@@ -1558,20 +1554,9 @@ namespace Render
             fragmentState.targets = aColorTargetState.data();
             fragmentState.entryPoint = "fs_main";
 
-            attrib.format = wgpu::VertexFormat::Float32x4;
-            attrib.offset = 0;
-            attrib.shaderLocation = 0;
-            aVertexAttributes.push_back(attrib);
-            attrib.offset = sizeof(float4);
-            attrib.shaderLocation = 1;
-            aVertexAttributes.push_back(attrib);
-            attrib.offset = sizeof(float4) * 2;
-            attrib.shaderLocation = 2;
-            aVertexAttributes.push_back(attrib);
-
             // vertex layout
-            vertexBufferLayout.attributeCount = 3;
-            vertexBufferLayout.arrayStride = sizeof(float4) * 3;
+            vertexBufferLayout.arrayStride = getVertexAttributes(aVertexAttributes, jobDesc);
+            vertexBufferLayout.attributeCount = (uint32_t)aVertexAttributes.size();
             vertexBufferLayout.attributes = aVertexAttributes.data();
             vertexBufferLayout.stepMode = wgpu::VertexStepMode::Vertex;
 
@@ -1826,7 +1811,8 @@ namespace Render
 
         // uniforms for different meshes
         if(mType == Render::JobType::Graphics &&
-            (mPassType == Render::PassType::DrawMeshes || mPassType == Render::PassType::DrawAnimatedMesh))
+            (mPassType == Render::PassType::DrawMeshes || mPassType == Render::PassType::DrawAnimatedMesh ||
+            mPassType == Render::PassType::DrawStaticMeshes || mPassType == Render::PassType::DrawDynamicMeshes))
         {
             aaBindGroupLayoutEntries.resize(3);
             aaBindingGroupEntries.resize(3);
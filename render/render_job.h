@@ -3,6 +3,10 @@
 #include <webgpu/webgpu_cpp.h>
 #include <math/vec.h>
 #include <render/render_utils.h>
+#include <render/pipeline_cache.h>
+#include <render/render_job_descriptions.h>
+#include <render/shader_preprocessor.h>
+#include <render/transient_allocator.h>
 
 #include <map>
 #include <string>
@@ -30,7 +34,8 @@ namespace Render
 
 			wgpu::SurfaceTexture* mpSwapChain;
 
-			std::string											mPipelineFilePath;
+			// the job list entry and pipeline file of the job
+			Render::CRenderJobDescriptions::Job const* mpJobDescription = nullptr;
 			Render::JobType											mJobType;
 			Render::PassType										mPassType;
 
@@ -42,6 +47,20 @@ namespace Render
 
 			wgpu::TextureView* mpTotalDiffuseTextureView = nullptr;
 			wgpu::Texture* mpDrawTextOutputAttachment = nullptr;
+
+			// outputs in the same slot share a texture or buffer, the first job with the slot creates it
+			Render::CTransientAllocator const* mpTransientAllocator = nullptr;
+			std::vector<wgpu::Texture>* mpaTransientTextures = nullptr;
+			std::vector<wgpu::Buffer>* mpaTransientBuffers = nullptr;
+
+			// shader modules, layouts and pipelines shared between jobs
+			Render::CPipelineCache* mpPipelineCache = nullptr;
+
+			// expands the shaders' includes and the job's "Defines"
+			Render::CShaderPreprocessor* mpShaderPreprocessor = nullptr;
+
+			// pipelines compile in the background, the job runs once its pipeline is ready
+			bool												mbAsyncPipelines = false;
 		};
 	public:
 		CRenderJob() = default;
@@ -75,6 +94,7 @@ namespace Render
 		std::vector<wgpu::RenderPassColorAttachment>									maOutputAttachments;
 
 		std::string												mName;
+		std::string												mPassLabel;
 		Render::JobType											mType;
 		Render::PassType										mPassType;
 
@@ -99,6 +119,27 @@ namespace Render
 		wgpu::Buffer*											mpInputVertexBuffer = nullptr;
 
 		bool													mbEnabled = true;
+
+		// "Frames" of the job list, only runs for that many frames when set
+		uint32_t												miNumFrames = 0;
+		uint32_t												miNumFramesRun = 0;
+
+		// "Dynamic Resolution" of the job list, draws to the render size part of its outputs
+		bool													mbDynamicResolution = false;
+
+		// skipped while its pipeline is compiling or a job it reads from this frame is skipped
+		bool													mbPipelineReady = false;
+		bool													mbSkipped = false;
+		std::vector<CRenderJob*>								mapReadJobs;
+
+		// of the direct draws the last frame, 0 when it didn't run
+		uint32_t												miNumTriangles = 0;
+
+		// meshes a "Draw Static Meshes" or "Draw Dynamic Meshes" pass draws of its set, all of them without a list
+		std::vector<uint32_t>									maiDrawMeshes;
+		bool													mbDrawMeshList = false;
+
+		Render::OcclusionPhase									mOcclusionPhase = Render::OcclusionPhase::None;
 	};
 
 }	// Render
\ No newline at end of file
@@ -0,0 +1,888 @@
+#include <render/render_job_descriptions.h>
+#include <render/render_job_file.h>
+
+#include <rapidjson/document.h>
+#include <utils/LogPrint.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <map>
+
+namespace Render
+{
+    /*
+    ** fnv-1a
+    */
+    static uint64_t hashText(
+        std::string const& text,
+        uint64_t iHash)
+    {
+        for(char c : text)
+        {
+            iHash = (iHash ^ (uint64_t)(uint8_t)c) * 1099511628211ull;
+        }
+
+        return iHash;
+    }
+
+    /*
+    ** string member, false when it's there but isn't a string or it's required and not there. the number getters
+    ** work the same
+    */
+    static bool getString(
+        std::string& value,
+        rapidjson::Value const& object,
+        char const* szKey,
+        bool bRequired)
+    {
+        if(!object.IsObject() || !object.HasMember(szKey))
+        {
+            return !bRequired;
+        }
+
+        if(!object[szKey].IsString())
+        {
+            return false;
+        }
+
+        value = object[szKey].GetString();
+        return true;
+    }
+
+    /*
+    **
+    */
+    static bool getUint(
+        uint32_t& iValue,
+        rapidjson::Value const& object,
+        char const* szKey,
+        bool bRequired)
+    {
+        if(!object.IsObject() || !object.HasMember(szKey))
+        {
+            return !bRequired;
+        }
+
+        if(!object[szKey].IsUint())
+        {
+            return false;
+        }
+
+        iValue = object[szKey].GetUint();
+        return true;
+    }
+
+    /*
+    **
+    */
+    static bool getFloat(
+        float& fValue,
+        rapidjson::Value const& object,
+        char const* szKey)
+    {
+        if(!object.IsObject() || !object.HasMember(szKey))
+        {
+            return true;
+        }
+
+        if(!object[szKey].IsNumber())
+        {
+            return false;
+        }
+
+        fValue = object[szKey].GetFloat();
+        return true;
+    }
+
+    /*
+    **
+    */
+    void CRenderJobDescriptions::clear()
+    {
+        maJobs.clear();
+        maErrors.clear();
+        mOutputJob.clear();
+        mOutputAttachment.clear();
+        miSourceHash = 0;
+    }
+
+    /*
+    **
+    */
+    int32_t CRenderJobDescriptions::findJob(std::string const& jobName) const
+    {
+        for(uint32_t iJob = 0; iJob < (uint32_t)maJobs.size(); iJob++)
+        {
+            if(maJobs[iJob].mName == jobName)
+            {
+                return (int32_t)iJob;
+            }
+        }
+
+        return -1;
+    }
+
+    /*
+    ** same fields and defaults the renderer and CRenderJob took from the json
+    */
+    bool CRenderJobDescriptions::compile(
+        char const* acJobList,
+        LoadFileFunction pfnLoadFile,
+        void* pUserData)
+    {
+        clear();
+
+        rapidjson::Document doc;
+        doc.Parse(acJobList);
+        if(doc.HasParseError() || !doc.IsObject() || !doc.HasMember("Jobs") || !doc["Jobs"].IsArray())
+        {
+            maErrors.push_back("job list is not valid json with \"Jobs\"");
+            return false;
+        }
+
+        miSourceHash = hashText(acJobList, 14695981039346656037ull);
+
+        mOutputJob = "TAA Graphics";
+        mOutputAttachment = "TAA Output";
+        if(!getString(mOutputJob, doc, "Output Job", false) || !getString(mOutputAttachment, doc, "Output Attachment", false))
+        {
+            maErrors.push_back("\"Output Job\" and \"Output Attachment\" need to be strings");
+        }
+
+        // jobs can share a pipeline file, it is loaded once
+        std::map<std::string, std::string> aPipelineFiles;
+
+        auto const& jobs = doc["Jobs"].GetArray();
+        for(uint32_t iListIndex = 0; iListIndex < jobs.Size(); iListIndex++)
+        {
+            auto const& jobDesc = jobs[iListIndex];
+
+            std::string disable;
+            if(getString(disable, jobDesc, "Disable", false) && disable == "True")
+            {
+                continue;
+            }
+
+            Job job;
+            job.miListIndex = iListIndex;
+
+            std::string jobType;
+            if(!getString(job.mName, jobDesc, "Name", true) ||
+               !getString(jobType, jobDesc, "Type", true) ||
+               !getString(job.mPassType, jobDesc, "PassType", true) ||
+               !getString(job.mPipeline, jobDesc, "Pipeline", true))
+            {
+                maErrors.push_back("job " + std::to_string(iListIndex) + " needs \"Name\", \"Type\", \"PassType\" and \"Pipeline\"");
+                continue;
+            }
+
+            if(jobType == "Compute")
+            {
+                job.mType = Render::JobType::Compute;
+            }
+            else if(jobType == "Copy")
+            {
+                job.mType = Render::JobType::Copy;
+            }
+
+            std::string occlusionPhase;
+            getString(occlusionPhase, jobDesc, "Occlusion Phase", false);
+            if(occlusionPhase == "Early")
+            {
+                job.mOcclusionPhase = Render::OcclusionPhase::Early;
+            }
+            else if(occlusionPhase == "Late")
+            {
+                job.mOcclusionPhase = Render::OcclusionPhase::Late;
+            }
+
+            std::string keep;
+            getString(keep, jobDesc, "Keep", false);
+            job.mbKeep = (keep == "True");
+
+            std::string dynamicResolution;
+            getString(dynamicResolution, jobDesc, "Dynamic Resolution", false);
+            job.mbDynamicResolution = (dynamicResolution == "True");
+
+            if(!getUint(job.miNumFrames, jobDesc, "Frames", false))
+            {
+                maErrors.push_back("\"" + job.mName + "\": \"Frames\" needs to be a number");
+            }
+
+            if(job.mType == Render::JobType::Compute && jobDesc.HasMember("Dispatch"))
+            {
+                auto const& dispatch = jobDesc["Dispatch"];
+                if(!dispatch.IsArray() || dispatch.Size() != 3 || !dispatch[0].IsUint() || !dispatch[1].IsUint() || !dispatch[2].IsUint())
+                {
+                    maErrors.push_back("\"" + job.mName + "\": \"Dispatch\" needs to be 3 numbers");
+                }
+                else
+                {
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        job.maiDispatch[i] = dispatch[i].GetUint();
+                    }
+                }
+            }
+
+            if(findJob(job.mName) >= 0)
+            {
+                maErrors.push_back("\"" + job.mName + "\" is listed twice");
+                continue;
+            }
+
+            auto fileIter = aPipelineFiles.find(job.mPipeline);
+            if(fileIter == aPipelineFiles.end())
+            {
+                std::string pipelineFile;
+                if(!(*pfnLoadFile)(pipelineFile, job.mPipeline, pUserData))
+                {
+                    maErrors.push_back("\"" + job.mName + "\": can't load \"" + job.mPipeline + "\"");
+                    continue;
+                }
+                fileIter = aPipelineFiles.insert(std::make_pair(job.mPipeline, pipelineFile)).first;
+            }
+
+            if(!parsePipeline(job, fileIter->second.c_str()))
+            {
+                continue;
+            }
+
+            miSourceHash = hashText(job.mPipeline, miSourceHash);
+            miSourceHash = hashText(fileIter->second, miSourceHash);
+
+            maJobs.push_back(job);
+        }
+
+        // parents only once every job is in
+        for(Job& job : maJobs)
+        {
+            for(Attachment& attachment : job.maAttachments)
+            {
+                if(attachment.mParentJob.length() > 0)
+                {
+                    attachment.miParentJob = findJob(attachment.mParentJob);
+                }
+            }
+        }
+
+        return (maErrors.size() == 0);
+    }
+
+    /*
+    **
+    */
+    bool CRenderJobDescriptions::parsePipeline(
+        Job& job,
+        char const* acPipeline)
+    {
+        uint32_t iNumErrors = (uint32_t)maErrors.size();
+        auto addError = [&](std::string const& error)
+        {
+            maErrors.push_back("\"" + job.mName + "\": \"" + job.mPipeline + "\" " + error);
+        };
+
+        rapidjson::Document doc;
+        doc.Parse(acPipeline);
+        if(doc.HasParseError() || !doc.IsObject())
+        {
+            addError("is not valid json");
+            return false;
+        }
+
+        if(!doc.HasMember("Attachments") || !doc["Attachments"].IsArray())
+        {
+            addError("has no \"Attachments\"");
+            return false;
+        }
+
+        bool bCopy = (job.mType == Render::JobType::Copy);
+        for(auto const& attachmentDesc : doc["Attachments"].GetArray())
+        {
+            Attachment attachment;
+            if(!getString(attachment.mName, attachmentDesc, "Name", true) || !getString(attachment.mType, attachmentDesc, "Type", true))
+            {
+                addError("has an attachment without \"Name\" and \"Type\"");
+                continue;
+            }
+
+            bool bOutput = (attachment.mType == "TextureOutput" || attachment.mType == "BufferOutput");
+            bool bValid = (
+                getString(attachment.mParentJob, attachmentDesc, "ParentJobName", !bOutput || bCopy) &&
+                getString(attachment.mParentName, attachmentDesc, "ParentName", bOutput && bCopy) &&
+                getString(attachment.mFormat, attachmentDesc, "Format", attachment.mType == "TextureOutput" && !bCopy) &&
+                getString(attachment.mUsage, attachmentDesc, "Usage", false) &&
+                getString(attachment.mTransient, attachmentDesc, "Transient", false) &&
+                getFloat(attachment.mfScaleWidth, attachmentDesc, "ScaleWidth") &&
+                getFloat(attachment.mfScaleHeight, attachmentDesc, "ScaleHeight") &&
+                getUint(attachment.miSize, attachmentDesc, "Size", attachment.mType == "BufferOutput" && !bCopy)
+            );
+            if(!bValid)
+            {
+                addError("is missing fields of \"" + attachment.mName + "\" or has the wrong types");
+                continue;
+            }
+
+            job.maAttachments.push_back(attachment);
+        }
+
+        if(bCopy)
+        {
+            return ((uint32_t)maErrors.size() == iNumErrors);
+        }
+
+        if(!getString(job.mShader, doc, "Shader", true) || !getString(job.mEmscriptenShader, doc, "Emscripten Shader", false))
+        {
+            addError("has no \"Shader\"");
+        }
+
+        // numbers as their text and bools as 1 or 0
+        if(doc.HasMember("Defines") && doc["Defines"].IsObject())
+        {
+            for(auto const& define : doc["Defines"].GetObject())
+            {
+                std::string value;
+                if(define.value.IsString())
+                {
+                    value = define.value.GetString();
+                }
+                else if(define.value.IsBool())
+                {
+                    value = define.value.GetBool() ? "1" : "0";
+                }
+                else if(define.value.IsInt64())
+                {
+                    value = std::to_string(define.value.GetInt64());
+                }
+                else if(define.value.IsNumber())
+                {
+                    value = std::to_string(define.value.GetDouble());
+                }
+                else
+                {
+                    addError("define \"" + std::string(define.name.GetString()) + "\" isn't a string, number or bool");
+                    continue;
+                }
+
+                job.maDefines.push_back(std::make_pair(std::string(define.name.GetString()), value));
+            }
+        }
+
+        if(doc.HasMember("Constants") && doc["Constants"].IsObject())
+        {
+            for(auto const& constant : doc["Constants"].GetObject())
+            {
+                if(constant.value.IsBool())
+                {
+                    job.maConstants.push_back(std::make_pair(std::string(constant.name.GetString()), constant.value.GetBool() ? 1.0 : 0.0));
+                }
+                else if(constant.value.IsNumber())
+                {
+                    job.maConstants.push_back(std::make_pair(std::string(constant.name.GetString()), constant.value.GetDouble()));
+                }
+                else
+                {
+                    addError("constant \"" + std::string(constant.name.GetString()) + "\" isn't a number or bool");
+                }
+            }
+        }
+
+        std::string resolutionMode = "Full";
+        if(!getFloat(job.mfResolutionScale, doc, "Resolution Scale") || !(job.mfResolutionScale > 0.0f && job.mfResolutionScale <= 1.0f))
+        {
+            addError("\"Resolution Scale\" needs to be a number over 0 and up to 1");
+        }
+        if(!getString(resolutionMode, doc, "Resolution Mode", false) || !Render::getResolutionMode(job.mResolutionMode, resolutionMode.c_str()))
+        {
+            addError("\"Resolution Mode\" needs to be \"Full\", \"Checkerboard\" or \"Interleaved\"");
+        }
+        if(!getUint(job.miInterleaveSize, doc, "Interleave Size", false) || !Render::isValidInterleaveSize(job.miInterleaveSize))
+        {
+            addError("\"Interleave Size\" needs to be 2 or 4");
+        }
+
+        for(Attachment& attachment : job.maAttachments)
+        {
+            if(attachment.mType == "TextureOutput")
+            {
+                attachment.mfScaleWidth *= job.mfResolutionScale;
+                attachment.mfScaleHeight *= job.mfResolutionScale;
+            }
+        }
+
+        if(job.mResolutionMode != Render::ResolutionMode::Full)
+        {
+            for(auto const& constant : job.maConstants)
+            {
+                if(constant.first == "RESOLUTION_MODE" || constant.first == "RESOLUTION_INTERLEAVE")
+                {
+                    addError("sets \"" + constant.first + "\" with a \"Resolution Mode\"");
+                }
+            }
+            job.maConstants.push_back(std::make_pair(std::string("RESOLUTION_MODE"), (double)job.mResolutionMode));
+            job.maConstants.push_back(std::make_pair(std::string("RESOLUTION_INTERLEAVE"), (double)job.miInterleaveSize));
+        }
+
+        if(doc.HasMember("VertexFormat") && doc["VertexFormat"].IsArray())
+        {
+            for(auto const& format : doc["VertexFormat"].GetArray())
+            {
+                if(!format.IsString())
+                {
+                    addError("has a vertex format that isn't a string");
+                    continue;
+                }
+                job.maVertexFormats.push_back(format.GetString());
+            }
+        }
+
+        if(doc.HasMember("ShaderResources") && doc["ShaderResources"].IsArray())
+        {
+            for(auto const& resourceDesc : doc["ShaderResources"].GetArray())
+            {
+                ShaderResource shaderResource;
+                if(!resourceDesc.IsObject() ||
+                   !getString(shaderResource.mName, resourceDesc, "name", true) ||
+                   !getString(shaderResource.mType, resourceDesc, "type", true) ||
+                   !getString(shaderResource.mUsage, resourceDesc, "usage", true) ||
+                   !getString(shaderResource.mSample, resourceDesc, "sample", false))
+                {
+                    addError("has a shader resource without \"name\", \"type\" and \"usage\"");
+                    continue;
+                }
+                shaderResource.mbExternal = resourceDesc.HasMember("external");
+                shaderResource.mbSize = resourceDesc.HasMember("size");
+
+                // buffers the job creates itself
+                bool bOwnBuffer = (shaderResource.mType == "buffer" && (shaderResource.mbSize || !shaderResource.mbExternal));
+                if(!getUint(shaderResource.miSize, resourceDesc, "size", bOwnBuffer) ||
+                   !getString(shaderResource.mShaderStage, resourceDesc, "shader_stage", bOwnBuffer || shaderResource.mType == "texture"))
+                {
+                    addError("shader resource \"" + shaderResource.mName + "\" needs \"size\" and \"shader_stage\"");
+                    continue;
+                }
+
+                if(bOwnBuffer && shaderResource.mUsage == "constant_buffer")
+                {
+                    if(!resourceDesc.HasMember("data") || !resourceDesc["data"].IsArray())
+                    {
+                        addError("constant buffer \"" + shaderResource.mName + "\" has no \"data\"");
+                        continue;
+                    }
+
+                    for(auto const& dataObject : resourceDesc["data"].GetArray())
+                    {
+                        std::string type;
+                        getString(type, dataObject, "type", true);
+                        if(!dataObject.HasMember("value") || !dataObject["value"].IsNumber())
+                        {
+                            addError("constant buffer \"" + shaderResource.mName + "\" has data without a \"value\"");
+                            break;
+                        }
+
+                        uint8_t acValue[4];
+                        if(type == "float")
+                        {
+                            float fValue = dataObject["value"].GetFloat();
+                            memcpy(acValue, &fValue, sizeof(acValue));
+                        }
+                        else if(type == "int")
+                        {
+                            int32_t iValue = dataObject["value"].GetInt();
+                            memcpy(acValue, &iValue, sizeof(acValue));
+                        }
+                        else
+                        {
+                            continue;
+                        }
+                        shaderResource.macData.insert(shaderResource.macData.end(), acValue, acValue + sizeof(acValue));
+                    }
+
+                    if((uint32_t)shaderResource.macData.size() > shaderResource.miSize)
+                    {
+                        addError("constant buffer \"" + shaderResource.mName + "\" has more data than its size");
+                    }
+                }
+
+                job.maShaderResources.push_back(shaderResource);
+            }
+        }
+
+        if(doc.HasMember("DepthStencilState"))
+        {
+            auto const& depthStencilState = doc["DepthStencilState"];
+            std::string depthEnable, stencilEnable;
+            if(!getString(depthEnable, depthStencilState, "DepthEnable", true) ||
+               !getString(job.mDepthWriteMask, depthStencilState, "DepthWriteMask", true) ||
+               !getString(job.mDepthFunc, depthStencilState, "DepthFunc", true) ||
+               !getString(stencilEnable, depthStencilState, "StencilEnable", true))
+            {
+                addError("\"DepthStencilState\" needs \"DepthEnable\", \"DepthWriteMask\", \"DepthFunc\" and \"StencilEnable\"");
+            }
+            job.mbDepthStencilState = true;
+            job.mbDepthEnable = (depthEnable == "True");
+            job.mbStencilEnable = (stencilEnable == "True");
+        }
+
+        if(doc.HasMember("RasterState"))
+        {
+            auto const& rasterState = doc["RasterState"];
+            if(!getString(job.mCullMode, rasterState, "CullMode", true) ||
+               !getString(job.mFrontFace, rasterState, "FrontFace", true) ||
+               !getString(job.mLoadOp, rasterState, "LoadOp", false) ||
+               !getString(job.mStoreOp, rasterState, "StoreOp", false))
+            {
+                addError("\"RasterState\" needs \"CullMode\" and \"FrontFace\"");
+            }
+            job.mbRasterState = true;
+        }
+
+        return ((uint32_t)maErrors.size() == iNumErrors);
+    }
+
+    /*
+    **
+    */
+    void CRenderJobDescriptions::write(std::vector<uint8_t>& acData) const
+    {
+        // strings once each, offset 0 is the empty string
+        std::vector<char> acStrings(1, '\0');
+        std::map<std::string, uint32_t> aStringOffsets;
+        aStringOffsets[""] = 0;
+        auto addString = [&](std::string const& value)
+        {
+            auto iter = aStringOffsets.find(value);
+            if(iter != aStringOffsets.end())
+            {
+                return iter->second;
+            }
+
+            uint32_t iOffset = (uint32_t)acStrings.size();
+            acStrings.insert(acStrings.end(), value.c_str(), value.c_str() + value.length() + 1);
+            aStringOffsets[value] = iOffset;
+
+            return iOffset;
+        };
+
+        std::vector<RenderJobFileJob> aJobs;
+        std::vector<RenderJobFileAttachment> aAttachments;
+        std::vector<RenderJobFileShaderResource> aShaderResources;
+        std::vector<RenderJobFileDefine> aDefines;
+        std::vector<RenderJobFileConstant> aConstants;
+        std::vector<uint32_t> aiVertexFormats;
+        std::vector<uint8_t> acResourceData;
+        for(Job const& job : maJobs)
+        {
+            RenderJobFileJob fileJob = {};
+            fileJob.miName = addString(job.mName);
+            fileJob.miPipeline = addString(job.mPipeline);
+            fileJob.miPassType = addString(job.mPassType);
+            fileJob.miType = (uint32_t)job.mType;
+            fileJob.miOcclusionPhase = (uint32_t)job.mOcclusionPhase;
+            fileJob.miListIndex = job.miListIndex;
+            fileJob.miNumFrames = job.miNumFrames;
+            fileJob.miFlags =
+                (job.mbKeep ? RENDER_JOB_FLAG_KEEP : 0) |
+                (job.mbDynamicResolution ? RENDER_JOB_FLAG_DYNAMIC_RESOLUTION : 0) |
+                (job.mbDepthStencilState ? RENDER_JOB_FLAG_DEPTH_STENCIL_STATE : 0) |
+                (job.mbDepthEnable ? RENDER_JOB_FLAG_DEPTH_ENABLE : 0) |
+                (job.mbStencilEnable ? RENDER_JOB_FLAG_STENCIL_ENABLE : 0) |
+                (job.mbRasterState ? RENDER_JOB_FLAG_RASTER_STATE : 0);
+            memcpy(fileJob.maiDispatch, job.maiDispatch, sizeof(fileJob.maiDispatch));
+            fileJob.mfResolutionScale = job.mfResolutionScale;
+            fileJob.miResolutionMode = (uint32_t)job.mResolutionMode;
+            fileJob.miInterleaveSize = job.miInterleaveSize;
+
+            fileJob.miShader = addString(job.mShader);
+            fileJob.miEmscriptenShader = addString(job.mEmscriptenShader);
+            fileJob.miDepthWriteMask = addString(job.mDepthWriteMask);
+            fileJob.miDepthFunc = addString(job.mDepthFunc);
+            fileJob.miCullMode = addString(job.mCullMode);
+            fileJob.miFrontFace = addString(job.mFrontFace);
+            fileJob.miLoadOp = addString(job.mLoadOp);
+            fileJob.miStoreOp = addString(job.mStoreOp);
+
+            fileJob.miFirstAttachment = (uint32_t)aAttachments.size();
+            fileJob.miNumAttachments = (uint32_t)job.maAttachments.size();
+            for(Attachment const& attachment : job.maAttachments)
+            {
+                RenderJobFileAttachment fileAttachment = {};
+                fileAttachment.miName = addString(attachment.mName);
+                fileAttachment.miType = addString(attachment.mType);
+                fileAttachment.miParentJobName = addString(attachment.mParentJob);
+                fileAttachment.miParentName = addString(attachment.mParentName);
+                fileAttachment.miFormat = addString(attachment.mFormat);
+                fileAttachment.miUsage = addString(attachment.mUsage);
+                fileAttachment.miTransient = addString(attachment.mTransient);
+                fileAttachment.mfScaleWidth = attachment.mfScaleWidth;
+                fileAttachment.mfScaleHeight = attachment.mfScaleHeight;
+                fileAttachment.miSize = attachment.miSize;
+                fileAttachment.miParentJob = attachment.miParentJob;
+                aAttachments.push_back(fileAttachment);
+            }
+
+            fileJob.miFirstShaderResource = (uint32_t)aShaderResources.size();
+            fileJob.miNumShaderResources = (uint32_t)job.maShaderResources.size();
+            for(ShaderResource const& shaderResource : job.maShaderResources)
+            {
+                RenderJobFileShaderResource fileShaderResource = {};
+                fileShaderResource.miName = addString(shaderResource.mName);
+                fileShaderResource.miType = addString(shaderResource.mType);
+                fileShaderResource.miUsage = addString(shaderResource.mUsage);
+                fileShaderResource.miSample = addString(shaderResource.mSample);
+                fileShaderResource.miShaderStage = addString(shaderResource.mShaderStage);
+                fileShaderResource.miSize = shaderResource.miSize;
+                fileShaderResource.miFlags =
+                    (shaderResource.mbSize ? RENDER_JOB_RESOURCE_FLAG_SIZE : 0) |
+                    (shaderResource.mbExternal ? RENDER_JOB_RESOURCE_FLAG_EXTERNAL : 0);
+                fileShaderResource.miDataOffset = (uint32_t)acResourceData.size();
+                fileShaderResource.miDataSize = (uint32_t)shaderResource.macData.size();
+                acResourceData.insert(acResourceData.end(), shaderResource.macData.begin(), shaderResource.macData.end());
+                aShaderResources.push_back(fileShaderResource);
+            }
+
+            fileJob.miFirstDefine = (uint32_t)aDefines.size();
+            fileJob.miNumDefines = (uint32_t)job.maDefines.size();
+            for(auto const& define : job.maDefines)
+            {
+                aDefines.push_back({addString(define.first), addString(define.second)});
+            }
+
+            fileJob.miFirstConstant = (uint32_t)aConstants.size();
+            fileJob.miNumConstants = (uint32_t)job.maConstants.size();
+            for(auto const& constant : job.maConstants)
+            {
+                aConstants.push_back({addString(constant.first), 0, constant.second});
+            }
+
+            fileJob.miFirstVertexFormat = (uint32_t)aiVertexFormats.size();
+            fileJob.miNumVertexFormats = (uint32_t)job.maVertexFormats.size();
+            for(std::string const& vertexFormat : job.maVertexFormats)
+            {
+                aiVertexFormats.push_back(addString(vertexFormat));
+            }
+
+            aJobs.push_back(fileJob);
+        }
+
+        RenderJobFileHeader header = {};
+        header.miSignature = RENDER_JOB_FILE_SIGNATURE;
+        header.miVersion = RENDER_JOB_FILE_VERSION;
+        header.miSourceHash = miSourceHash;
+        header.miOutputJob = addString(mOutputJob);
+        header.miOutputAttachment = addString(mOutputAttachment);
+        header.miNumJobs = (uint32_t)aJobs.size();
+        header.miNumAttachments = (uint32_t)aAttachments.size();
+        header.miNumShaderResources = (uint32_t)aShaderResources.size();
+        header.miNumDefines = (uint32_t)aDefines.size();
+        header.miNumConstants = (uint32_t)aConstants.size();
+        header.miNumVertexFormats = (uint32_t)aiVertexFormats.size();
+        header.miDataSize = (uint32_t)acResourceData.size();
+        header.miStringSize = (uint32_t)acStrings.size();
+
+        acData.clear();
+        auto append = [&](void const* pData, size_t iSize)
+        {
+            acData.insert(acData.end(), (uint8_t const*)pData, (uint8_t const*)pData + iSize);
+        };
+        append(&header, sizeof(header));
+        append(aJobs.data(), aJobs.size() * sizeof(RenderJobFileJob));
+        append(aAttachments.data(), aAttachments.size() * sizeof(RenderJobFileAttachment));
+        append(aShaderResources.data(), aShaderResources.size() * sizeof(RenderJobFileShaderResource));
+        append(aDefines.data(), aDefines.size() * sizeof(RenderJobFileDefine));
+        append(aConstants.data(), aConstants.size() * sizeof(RenderJobFileConstant));
+        append(aiVertexFormats.data(), aiVertexFormats.size() * sizeof(uint32_t));
+        append(acResourceData.data(), acResourceData.size());
+        append(acStrings.data(), acStrings.size());
+    }
+
+    /*
+    ** the tables aren't aligned, records are copied out of the blob
+    */
+    bool CRenderJobDescriptions::read(
+        void const* pData,
+        uint64_t iDataSize)
+    {
+        clear();
+
+        RenderJobFileHeader header = {};
+        if(pData == nullptr || iDataSize < sizeof(header))
+        {
+            maErrors.push_back("compiled job list is too small");
+            return false;
+        }
+        memcpy(&header, pData, sizeof(header));
+        if(header.miSignature != RENDER_JOB_FILE_SIGNATURE || header.miVersion != RENDER_JOB_FILE_VERSION)
+        {
+            maErrors.push_back("not a compiled job list of version " + std::to_string(RENDER_JOB_FILE_VERSION));
+            return false;
+        }
+
+        uint64_t iJobsOffset = sizeof(header);
+        uint64_t iAttachmentsOffset = iJobsOffset + (uint64_t)header.miNumJobs * sizeof(RenderJobFileJob);
+        uint64_t iShaderResourcesOffset = iAttachmentsOffset + (uint64_t)header.miNumAttachments * sizeof(RenderJobFileAttachment);
+        uint64_t iDefinesOffset = iShaderResourcesOffset + (uint64_t)header.miNumShaderResources * sizeof(RenderJobFileShaderResource);
+        uint64_t iConstantsOffset = iDefinesOffset + (uint64_t)header.miNumDefines * sizeof(RenderJobFileDefine);
+        uint64_t iVertexFormatsOffset = iConstantsOffset + (uint64_t)header.miNumConstants * sizeof(RenderJobFileConstant);
+        uint64_t iResourceDataOffset = iVertexFormatsOffset + (uint64_t)header.miNumVertexFormats * sizeof(uint32_t);
+        uint64_t iStringsOffset = iResourceDataOffset + (uint64_t)header.miDataSize;
+        uint64_t iEnd = iStringsOffset + (uint64_t)header.miStringSize;
+
+        // the loader may pad the file with a terminating zero
+        uint8_t const* acData = (uint8_t const*)pData;
+        char const* acStrings = (char const*)(acData + iStringsOffset);
+        if(iEnd > iDataSize || header.miStringSize == 0 || acStrings[header.miStringSize - 1] != '\0')
+        {
+            maErrors.push_back("compiled job list is cut off");
+            return false;
+        }
+
+        // every string field ends inside the string table
+        bool bValid = true;
+        auto readString = [&](uint32_t iOffset)
+        {
+            if(iOffset >= header.miStringSize)
+            {
+                bValid = false;
+                return std::string();
+            }
+            return std::string(acStrings + iOffset);
+        };
+        auto checkRange = [&](uint32_t iFirst, uint32_t iCount, uint32_t iTotal)
+        {
+            bValid = bValid && ((uint64_t)iFirst + (uint64_t)iCount <= (uint64_t)iTotal);
+            return bValid;
+        };
+
+        mOutputJob = readString(header.miOutputJob);
+        mOutputAttachment = readString(header.miOutputAttachment);
+        miSourceHash = header.miSourceHash;
+
+        maJobs.resize(header.miNumJobs);
+        for(uint32_t iJob = 0; bValid && iJob < header.miNumJobs; iJob++)
+        {
+            RenderJobFileJob fileJob;
+            memcpy(&fileJob, acData + iJobsOffset + iJob * sizeof(RenderJobFileJob), sizeof(fileJob));
+
+            Job& job = maJobs[iJob];
+            job.mName = readString(fileJob.miName);
+            job.mPipeline = readString(fileJob.miPipeline);
+            job.mPassType = readString(fileJob.miPassType);
+            bValid = bValid && (fileJob.miType <= (uint32_t)Render::JobType::Copy) && (fileJob.miOcclusionPhase <= (uint32_t)Render::OcclusionPhase::Late);
+            job.mType = (Render::JobType)fileJob.miType;
+            job.mOcclusionPhase = (Render::OcclusionPhase)fileJob.miOcclusionPhase;
+            job.miListIndex = fileJob.miListIndex;
+            job.miNumFrames = fileJob.miNumFrames;
+            job.mbKeep = ((fileJob.miFlags & RENDER_JOB_FLAG_KEEP) != 0);
+            job.mbDynamicResolution = ((fileJob.miFlags & RENDER_JOB_FLAG_DYNAMIC_RESOLUTION) != 0);
+            memcpy(job.maiDispatch, fileJob.maiDispatch, sizeof(job.maiDispatch));
+            bValid = bValid && (fileJob.miResolutionMode <= (uint32_t)Render::ResolutionMode::Interleaved) && Render::isValidInterleaveSize(fileJob.miInterleaveSize);
+            job.mfResolutionScale = fileJob.mfResolutionScale;
+            job.mResolutionMode = (Render::ResolutionMode)fileJob.miResolutionMode;
+            job.miInterleaveSize = fileJob.miInterleaveSize;
+
+            job.mShader = readString(fileJob.miShader);
+            job.mEmscriptenShader = readString(fileJob.miEmscriptenShader);
+            job.mbDepthStencilState = ((fileJob.miFlags & RENDER_JOB_FLAG_DEPTH_STENCIL_STATE) != 0);
+            job.mbDepthEnable = ((fileJob.miFlags & RENDER_JOB_FLAG_DEPTH_ENABLE) != 0);
+            job.mbStencilEnable = ((fileJob.miFlags & RENDER_JOB_FLAG_STENCIL_ENABLE) != 0);
+            job.mDepthWriteMask = readString(fileJob.miDepthWriteMask);
+            job.mDepthFunc = readString(fileJob.miDepthFunc);
+            job.mbRasterState = ((fileJob.miFlags & RENDER_JOB_FLAG_RASTER_STATE) != 0);
+            job.mCullMode = readString(fileJob.miCullMode);
+            job.mFrontFace = readString(fileJob.miFrontFace);
+            job.mLoadOp = readString(fileJob.miLoadOp);
+            job.mStoreOp = readString(fileJob.miStoreOp);
+
+            if(checkRange(fileJob.miFirstAttachment, fileJob.miNumAttachments, header.miNumAttachments))
+            {
+                job.maAttachments.resize(fileJob.miNumAttachments);
+                for(uint32_t i = 0; i < fileJob.miNumAttachments; i++)
+                {
+                    RenderJobFileAttachment fileAttachment;
+                    memcpy(&fileAttachment, acData + iAttachmentsOffset + (fileJob.miFirstAttachment + i) * sizeof(RenderJobFileAttachment), sizeof(fileAttachment));
+
+                    Attachment& attachment = job.maAttachments[i];
+                    attachment.mName = readString(fileAttachment.miName);
+                    attachment.mType = readString(fileAttachment.miType);
+                    attachment.mParentJob = readString(fileAttachment.miParentJobName);
+                    attachment.mParentName = readString(fileAttachment.miParentName);
+                    attachment.mFormat = readString(fileAttachment.miFormat);
+                    attachment.mUsage = readString(fileAttachment.miUsage);
+                    attachment.mTransient = readString(fileAttachment.miTransient);
+                    attachment.mfScaleWidth = fileAttachment.mfScaleWidth;
+                    attachment.mfScaleHeight = fileAttachment.mfScaleHeight;
+                    attachment.miSize = fileAttachment.miSize;
+                    attachment.miParentJob = fileAttachment.miParentJob;
+                    bValid = bValid && (attachment.miParentJob >= -1 && attachment.miParentJob < (int32_t)header.miNumJobs);
+                }
+            }
+
+            if(checkRange(fileJob.miFirstShaderResource, fileJob.miNumShaderResources, header.miNumShaderResources))
+            {
+                job.maShaderResources.resize(fileJob.miNumShaderResources);
+                for(uint32_t i = 0; i < fileJob.miNumShaderResources; i++)
+                {
+                    RenderJobFileShaderResource fileShaderResource;
+                    memcpy(&fileShaderResource, acData + iShaderResourcesOffset + (fileJob.miFirstShaderResource + i) * sizeof(RenderJobFileShaderResource), sizeof(fileShaderResource));
+
+                    ShaderResource& shaderResource = job.maShaderResources[i];
+                    shaderResource.mName = readString(fileShaderResource.miName);
+                    shaderResource.mType = readString(fileShaderResource.miType);
+                    shaderResource.mUsage = readString(fileShaderResource.miUsage);
+                    shaderResource.mSample = readString(fileShaderResource.miSample);
+                    shaderResource.mShaderStage = readString(fileShaderResource.miShaderStage);
+                    shaderResource.miSize = fileShaderResource.miSize;
+                    shaderResource.mbSize = ((fileShaderResource.miFlags & RENDER_JOB_RESOURCE_FLAG_SIZE) != 0);
+                    shaderResource.mbExternal = ((fileShaderResource.miFlags & RENDER_JOB_RESOURCE_FLAG_EXTERNAL) != 0);
+                    if(checkRange(fileShaderResource.miDataOffset, fileShaderResource.miDataSize, header.miDataSize))
+                    {
+                        uint8_t const* pResourceData = acData + iResourceDataOffset + fileShaderResource.miDataOffset;
+                        shaderResource.macData.assign(pResourceData, pResourceData + fileShaderResource.miDataSize);
+                    }
+                }
+            }
+
+            if(checkRange(fileJob.miFirstDefine, fileJob.miNumDefines, header.miNumDefines))
+            {
+                for(uint32_t i = 0; i < fileJob.miNumDefines; i++)
+                {
+                    RenderJobFileDefine fileDefine;
+                    memcpy(&fileDefine, acData + iDefinesOffset + (fileJob.miFirstDefine + i) * sizeof(RenderJobFileDefine), sizeof(fileDefine));
+                    job.maDefines.push_back(std::make_pair(readString(fileDefine.miName), readString(fileDefine.miValue)));
+                }
+            }
+
+            if(checkRange(fileJob.miFirstConstant, fileJob.miNumConstants, header.miNumConstants))
+            {
+                for(uint32_t i = 0; i < fileJob.miNumConstants; i++)
+                {
+                    RenderJobFileConstant fileConstant;
+                    memcpy(&fileConstant, acData + iConstantsOffset + (fileJob.miFirstConstant + i) * sizeof(RenderJobFileConstant), sizeof(fileConstant));
+                    job.maConstants.push_back(std::make_pair(readString(fileConstant.miName), fileConstant.mfValue));
+                }
+            }
+
+            if(checkRange(fileJob.miFirstVertexFormat, fileJob.miNumVertexFormats, header.miNumVertexFormats))
+            {
+                for(uint32_t i = 0; i < fileJob.miNumVertexFormats; i++)
+                {
+                    uint32_t iVertexFormat;
+                    memcpy(&iVertexFormat, acData + iVertexFormatsOffset + (fileJob.miFirstVertexFormat + i) * sizeof(uint32_t), sizeof(iVertexFormat));
+                    job.maVertexFormats.push_back(readString(iVertexFormat));
+                }
+            }
+        }
+
+        if(!bValid)
+        {
+            clear();
+            maErrors.push_back("compiled job list has a string or record out of range");
+            return false;
+        }
+
+        return true;
+    }
+
+}   // Render
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <render/render_utils.h>
+#include <render/resolution_mode.h>
+#include <render/shader_preprocessor.h>
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** the job list and the pipeline files of its jobs as plain records, parsed from the json once or read from the
+    ** compiled job list in one go. the render graph and CRenderJob only look at these, so the start up doesn't load
+    ** and parse a pipeline file for every step of creating a job
+    **
+    ** compile      parses the job list and every pipeline file it names and checks the fields the jobs need. the
+    **              parent jobs of the attachments are resolved to job indices, -1 for a job that isn't listed, the
+    **              render graph reports those. constant buffer data is packed to bytes and defines are made text like
+    **              the shader preprocessor takes them. the resolution of the pipeline file is checked and applied,
+    **              see resolution_mode.h
+    ** write, read  the records as a render_job_file.h blob, read checks the sizes and indices before copying
+    **              anything out, a blob that doesn't check out is an error and the caller goes back to the json
+    **
+    ** no gpu objects, the dry run tool compiles the job list and writes the blob
+    */
+    class CRenderJobDescriptions
+    {
+    public:
+        // pipeline file of a job, filePath is the "Pipeline" value of the job list
+        typedef bool (*LoadFileFunction)(std::string& content, std::string const& filePath, void* pUserData);
+
+        struct Attachment
+        {
+            std::string                 mName;
+            std::string                 mType;
+            std::string                 mParentJob;
+            std::string                 mParentName;            // copy jobs
+            std::string                 mFormat;
+            std::string                 mUsage;
+            std::string                 mTransient;
+            float                       mfScaleWidth = 1.0f;
+            float                       mfScaleHeight = 1.0f;
+            uint32_t                    miSize = 0;             // buffers
+            int32_t                     miParentJob = -1;       // mParentJob in getJobs()
+        };
+
+        struct ShaderResource
+        {
+            std::string                 mName;
+            std::string                 mType;
+            std::string                 mUsage;
+            std::string                 mSample = "float";
+            std::string                 mShaderStage;
+            uint32_t                    miSize = 0;
+            bool                        mbSize = false;
+            bool                        mbExternal = false;
+            std::vector<uint8_t>        macData;                // "data" of a constant_buffer
+        };
+
+        struct Job
+        {
+            // job list
+            std::string                 mName;
+            std::string                 mPipeline;
+            std::string                 mPassType;
+            Render::JobType             mType = Render::JobType::Graphics;
+            Render::OcclusionPhase      mOcclusionPhase = Render::OcclusionPhase::None;
+            uint32_t                    miListIndex = 0;        // in the job list's "Jobs", disabled ones included
+            uint32_t                    miNumFrames = 0;
+            bool                        mbKeep = false;
+            bool                        mbDynamicResolution = false;    // draws at the renderer's render scale
+            uint32_t                    maiDispatch[3] = {1, 1, 1};
+
+            // pipeline file
+            std::string                 mShader;
+            std::string                 mEmscriptenShader;
+            Render::CShaderPreprocessor::Defines                maDefines;
+            std::vector<std::pair<std::string, double>>         maConstants;
+            std::vector<std::string>    maVertexFormats;        // empty for the default layout
+            std::vector<Attachment>     maAttachments;
+            std::vector<ShaderResource> maShaderResources;
+
+            // "Resolution Scale" is in the scales of the texture outputs already, the sparse modes add their constants
+            float                       mfResolutionScale = 1.0f;
+            Render::ResolutionMode      mResolutionMode = Render::ResolutionMode::Full;
+            uint32_t                    miInterleaveSize = 2;
+
+            bool                        mbDepthStencilState = false;
+            bool                        mbDepthEnable = false;
+            bool                        mbStencilEnable = false;
+            std::string                 mDepthWriteMask;
+            std::string                 mDepthFunc;
+
+            bool                        mbRasterState = false;
+            std::string                 mCullMode;
+            std::string                 mFrontFace;
+            std::string                 mLoadOp;
+            std::string                 mStoreOp;
+        };
+
+    public:
+        CRenderJobDescriptions() = default;
+        virtual ~CRenderJobDescriptions() = default;
+
+        // false with getErrors() on bad json, a missing pipeline file or field, or a job listed twice
+        bool compile(
+            char const* acJobList,
+            LoadFileFunction pfnLoadFile,
+            void* pUserData);
+
+        void write(std::vector<uint8_t>& acData) const;
+
+        // false with getErrors() when the blob isn't a compiled job list of this version or doesn't check out
+        bool read(
+            void const* pData,
+            uint64_t iDataSize);
+
+        int32_t findJob(std::string const& jobName) const;
+
+        inline std::vector<Job> const& getJobs() const
+        {
+            return maJobs;
+        }
+
+        inline std::vector<std::string> const& getErrors() const
+        {
+            return maErrors;
+        }
+
+        inline std::string const& getOutputJob() const
+        {
+            return mOutputJob;
+        }
+
+        inline std::string const& getOutputAttachment() const
+        {
+            return mOutputAttachment;
+        }
+
+        // of the job list and pipeline files, a compiled job list with another hash is out of date
+        inline uint64_t getSourceHash() const
+        {
+            return miSourceHash;
+        }
+
+    protected:
+        void clear();
+
+        bool parsePipeline(
+            Job& job,
+            char const* acPipeline);
+
+    protected:
+        std::vector<Job>                        maJobs;
+        std::vector<std::string>                maErrors;
+
+        std::string                             mOutputJob;
+        std::string                             mOutputAttachment;
+        uint64_t                                miSourceHash = 0;
+    };
+
+}   // Render
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+** compiled render job list, written by tools/render_graph_compiler --cache and read by
+** CRenderJobDescriptions::read
+**
+** RenderJobFileHeader
+** RenderJobFileJob[miNumJobs]
+** RenderJobFileAttachment[miNumAttachments]
+** RenderJobFileShaderResource[miNumShaderResources]
+** RenderJobFileDefine[miNumDefines]
+** RenderJobFileConstant[miNumConstants]
+** uint32_t[miNumVertexFormats], strings of the vertex formats
+** uint8_t[miDataSize], constant buffer data of the shader resources
+** char[miStringSize], zero terminated strings, the string fields are offsets into them
+**
+** the jobs keep their order in the job list without the disabled ones, the records of a job are consecutive in their
+** tables. miSourceHash is of the job list and pipeline files it was compiled from
+*/
+
+#define RENDER_JOB_FILE_SIGNATURE           (('R') | ('J' << 8) | ('O' << 16) | ('B' << 24))
+#define RENDER_JOB_FILE_VERSION             2
+
+namespace Render
+{
+    enum RenderJobFileFlags
+    {
+        RENDER_JOB_FLAG_KEEP                = (1 << 0),
+        RENDER_JOB_FLAG_DEPTH_STENCIL_STATE = (1 << 1),
+        RENDER_JOB_FLAG_DEPTH_ENABLE        = (1 << 2),
+        RENDER_JOB_FLAG_STENCIL_ENABLE      = (1 << 3),
+        RENDER_JOB_FLAG_RASTER_STATE        = (1 << 4),
+        RENDER_JOB_FLAG_DYNAMIC_RESOLUTION  = (1 << 5),
+    };
+
+    enum RenderJobFileResourceFlags
+    {
+        RENDER_JOB_RESOURCE_FLAG_SIZE       = (1 << 0),
+        RENDER_JOB_RESOURCE_FLAG_EXTERNAL   = (1 << 1),
+    };
+
+    struct RenderJobFileHeader
+    {
+        uint32_t            miSignature;
+        uint32_t            miVersion;
+        uint64_t            miSourceHash;
+
+        uint32_t            miNumJobs;
+        uint32_t            miNumAttachments;
+        uint32_t            miNumShaderResources;
+        uint32_t            miNumDefines;
+        uint32_t            miNumConstants;
+        uint32_t            miNumVertexFormats;
+        uint32_t            miDataSize;
+        uint32_t            miStringSize;
+
+        uint32_t            miOutputJob;
+        uint32_t            miOutputAttachment;
+    };
+
+    struct RenderJobFileJob
+    {
+        uint32_t            miName;
+        uint32_t            miPipeline;
+        uint32_t            miPassType;
+        uint32_t            miType;
+        uint32_t            miOcclusionPhase;
+        uint32_t            miListIndex;
+        uint32_t            miNumFrames;
+        uint32_t            miFlags;
+        uint32_t            maiDispatch[3];
+        float               mfResolutionScale;
+        uint32_t            miResolutionMode;
+        uint32_t            miInterleaveSize;
+
+        uint32_t            miShader;
+        uint32_t            miEmscriptenShader;
+        uint32_t            miDepthWriteMask;
+        uint32_t            miDepthFunc;
+        uint32_t            miCullMode;
+        uint32_t            miFrontFace;
+        uint32_t            miLoadOp;
+        uint32_t            miStoreOp;
+
+        uint32_t            miFirstAttachment;
+        uint32_t            miNumAttachments;
+        uint32_t            miFirstShaderResource;
+        uint32_t            miNumShaderResources;
+        uint32_t            miFirstDefine;
+        uint32_t            miNumDefines;
+        uint32_t            miFirstConstant;
+        uint32_t            miNumConstants;
+        uint32_t            miFirstVertexFormat;
+        uint32_t            miNumVertexFormats;
+    };
+
+    struct RenderJobFileAttachment
+    {
+        uint32_t            miName;
+        uint32_t            miType;
+        uint32_t            miParentJobName;
+        uint32_t            miParentName;
+        uint32_t            miFormat;
+        uint32_t            miUsage;
+        uint32_t            miTransient;
+        float               mfScaleWidth;
+        float               mfScaleHeight;
+        uint32_t            miSize;
+        int32_t             miParentJob;
+    };
+
+    struct RenderJobFileShaderResource
+    {
+        uint32_t            miName;
+        uint32_t            miType;
+        uint32_t            miUsage;
+        uint32_t            miSample;
+        uint32_t            miShaderStage;
+        uint32_t            miSize;
+        uint32_t            miFlags;
+        uint32_t            miDataOffset;
+        uint32_t            miDataSize;
+    };
+
+    struct RenderJobFileDefine
+    {
+        uint32_t            miName;
+        uint32_t            miValue;
+    };
+
+    struct RenderJobFileConstant
+    {
+        uint32_t            miName;
+        uint32_t            miPadding;
+        double              mfValue;
+    };
+
+}   // Render
@@ -14,10 +14,20 @@ namespace Render
 		Compute,
 		DrawMeshes,
 		DrawAnimatedMesh,
+		DrawStaticMeshes,		// the static meshes the app doesn't move, whole and without the culling jobs
+		DrawDynamicMeshes,		// the ones it moves every frame
 		FullTriangle,
 		Copy,
 		SwapChain,
 		DepthPrepass,
 	};
 
+	// which culling jobs' draws a mesh pass takes, early and late are the two halves of the occlusion culling
+	enum class OcclusionPhase
+	{
+		None,
+		Early,
+		Late,
+	};
+
 }   // Render
\ No newline at end of file
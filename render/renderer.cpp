@@ -1,16 +1,20 @@
 #include <render/renderer.h>
+#include <render/render_graph.h>
+#include <render/texture_atlas_file.h>
+#include <render/dynamic_resolution.h>
 
 #include <curl/curl.h>
 
-#include <rapidjson/document.h>
 #include <math/vec.h>
 #include <math/mat4.h>
 #include <loader/loader.h>
 #include <assert.h>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #if defined(__EMSCRIPTEN__)
@@ -60,6 +64,13 @@ struct DefaultUniformData
     float4 mLightDirection;
 
     float4x4 mInverseViewProjectionMatrix;
+
+    // render size over the output size of this frame and the last, the "Dynamic Resolution" jobs draw to that part
+    // of their outputs
+    float4 mRenderScale;
+
+    // clip space offset of the jittered matrices, this frame and the last
+    float4 mJitter;
 };
 
 // Callback function to write data to file
@@ -104,6 +115,7 @@ namespace Render
     */
     void CRenderer::setup(CreateDescriptor& desc)
     {
+        mSetupStartTime = std::chrono::high_resolution_clock::now();
         mCreateDesc = desc;
 
         mpDevice = desc.mpDevice;
@@ -116,6 +128,7 @@ namespace Render
         bufferDesc.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst;
         maBuffers["default-uniform-buffer"] = device.CreateBuffer(&bufferDesc);
         maBuffers["default-uniform-buffer"].SetLabel("Default Uniform Buffer");
+        miDefaultUniformBuffer = maBuffers.getHandle("default-uniform-buffer");
         maBufferSizes["default-uniform-buffer"] = (uint32_t)bufferDesc.size;
 
         // full screen triangle
@@ -136,6 +149,7 @@ namespace Render
         bufferDesc.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst; 
         maBuffers["full-screen-triangle-vertex-buffer"] = device.CreateBuffer(&bufferDesc);
         maBuffers["full-screen-triangle-vertex-buffer"].SetLabel("Full Screen Triangle Vertex Buffer");
+        miFullScreenTriangleVertexBuffer = maBuffers.getHandle("full-screen-triangle-vertex-buffer");
         maBufferSizes["full-screen-triangle-vertex-buffer"] = (uint32_t)bufferDesc.size;
         device.GetQueue().WriteBuffer(
             maBuffers["full-screen-triangle-vertex-buffer"], 
@@ -148,6 +162,7 @@ namespace Render
         bufferDesc.usage = wgpu::BufferUsage::Index | wgpu::BufferUsage::CopyDst; 
         maBuffers["full-screen-triangle-index-buffer"] = device.CreateBuffer(&bufferDesc);
         maBuffers["full-screen-triangle-index-buffer"].SetLabel("Full Screen Triangle Index Buffer");
+        miFullScreenTriangleIndexBuffer = maBuffers.getHandle("full-screen-triangle-index-buffer");
         maBufferSizes["full-screen-triangle-index-buffer"] = (uint32_t)bufferDesc.size;
         device.GetQueue().WriteBuffer(
             maBuffers["full-screen-triangle-index-buffer"], 
@@ -235,8 +250,54 @@ namespace Render
         miAtlasImageHeight = 8192;
         createTextureAtlas();
 
+        // block compressed atlas when the device can sample it, uncompressed one otherwise
+        bool bCookedAtlasLoaded = false;
+        if(desc.mCookedCompressedTextureAtlasFilePath.length() > 0 && mpDevice->HasFeature(wgpu::FeatureName::TextureCompressionBC))
+        {
+            bCookedAtlasLoaded = loadCookedTextureAtlas(desc.mCookedCompressedTextureAtlasFilePath);
+
+            // nothing can be shelf packed into a block compressed atlas and the render jobs bind the atlas below, a
+            // texture list it doesn't have sends every list to the uncompressed atlas
+            auto missingTextureList = std::find_if(
+                desc.maTextureListNames.begin(),
+                desc.maTextureListNames.end(),
+                [&](std::string const& textureListName)
+                {
+                    return maCookedTextureAtlasSections.find(textureListName) == maCookedTextureAtlasSections.end();
+                });
+            if(bCookedAtlasLoaded && missingTextureList != desc.maTextureListNames.end())
+            {
+                DEBUG_PRINTF("!!! \"%s\" is not in the compressed cooked atlas \"%s\", using the uncompressed atlas, re-run texture_atlas_baker --bc7 with its texture list !!!\n",
+                    missingTextureList->c_str(),
+                    desc.mCookedCompressedTextureAtlasFilePath.c_str());
+
+                maCookedTextureAtlasSections.clear();
+                createTextureAtlas();
+                miAtlasShelfX = 0;
+                miAtlasShelfY = 0;
+                miAtlasShelfHeight = 0;
+                bCookedAtlasLoaded = false;
+            }
+        }
+        if(!bCookedAtlasLoaded && desc.mCookedTextureAtlasFilePath.length() > 0)
+        {
+            loadCookedTextureAtlas(desc.mCookedTextureAtlasFilePath);
+        }
+
         createRenderJobs(desc);
 
+        // encoders on other threads need a device that locks itself, the web has one thread for webgpu
+        maiJobRecordCosts.assign(maOrderedRenderJobs.size(), 1);
+#if !defined(__EMSCRIPTEN__)
+        if(mpDevice->HasFeature(wgpu::FeatureName::ImplicitDeviceSynchronization))
+        {
+            uint32_t iNumRecordThreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), 4u);
+            mRecordScheduler.setup(iNumRecordThreads);
+            mRecordingMode = RecordingMode::ParallelChunks;
+            DEBUG_PRINTF("recording render jobs on %d threads\n", iNumRecordThreads);
+        }
+#endif // __EMSCRIPTEN__
+
 #if 0
         struct UniformData
         {
@@ -280,18 +341,360 @@ namespace Render
         mpInstance = desc.mpInstance;
     }
 
+    /*
+    ** meshlet draws when the job list has cluster culling and the app gave it meshlets. the frustum only job is culled
+    ** from the graph when no pass draws from it. the draws need multi draw to stop at the count the culling wrote,
+    ** without it the mesh culling jobs draw whole meshes instead
+    */
+    bool CRenderer::isClusterCullingEnabled()
+    {
+#if defined(__EMSCRIPTEN__) || !defined(_MSC_VER)
+        return false;
+#endif // __EMSCRIPTEN__
+
+        for(CullingJob const& cullingJob : maCullingJobs[(uint32_t)CullingType::Cluster])
+        {
+            if(cullingJob.mpRenderJob != nullptr && cullingJob.mpRenderJob->mbEnabled)
+            {
+                return (miMaxClusterDrawCalls > 0);
+            }
+        }
+
+        return false;
+    }
+
+    /*
+    ** most draws the multi draw reads, at most what the draw call buffer holds
+    */
+    uint32_t CRenderer::getNumClusterDrawCalls(CullingJob const& cullingJob)
+    {
+        return std::min(miMaxClusterDrawCalls, (uint32_t)(cullingJob.mpDrawCalls->GetSize() / (5 * sizeof(uint32_t))));
+    }
+
+    /*
+    ** "Mesh" or "Cluster" culling job a mesh pass of the occlusion phase draws from. job lists without the early and
+    ** late jobs have the early pass draw everything in the frustum and the late one nothing
+    */
+    CRenderer::CullingJob const* CRenderer::getCullingJob(
+        CullingType culling,
+        Render::OcclusionPhase occlusionPhase)
+    {
+        CullingJob const& cullingJob = maCullingJobs[(uint32_t)culling][(uint32_t)occlusionPhase];
+        if(cullingJob.mpRenderJob != nullptr && cullingJob.mpRenderJob->mbEnabled)
+        {
+            return &cullingJob;
+        }
+
+        if(occlusionPhase == Render::OcclusionPhase::Early)
+        {
+            return getCullingJob(culling, Render::OcclusionPhase::None);
+        }
+
+        return nullptr;
+    }
+
+    /*
+    ** culling jobs and their draw call buffers, looked up once the jobs are created
+    */
+    void CRenderer::resolveCullingJobs()
+    {
+        static char const* saszCullingNames[] = {"Mesh", "Cluster"};
+        static char const* saszDrawCallNames[] = {"Draw Calls", "Cluster Draw Calls"};
+        static char const* saszNumDrawCallNames[] = {"Num Draw Calls", "Num Cluster Draw Calls"};
+        for(uint32_t iCulling = 0; iCulling < 2; iCulling++)
+        {
+            for(uint32_t iPhase = 0; iPhase < 3; iPhase++)
+            {
+                CullingJob& cullingJob = maCullingJobs[iCulling][iPhase];
+                cullingJob = CullingJob();
+
+                auto iter = maRenderJobs.find(Render::CRenderGraph::getCullingJobName(saszCullingNames[iCulling], (Render::OcclusionPhase)iPhase));
+                if(iter == maRenderJobs.end())
+                {
+                    continue;
+                }
+
+                Render::CRenderJob* pRenderJob = iter->second.get();
+                auto drawCalls = pRenderJob->mOutputBufferAttachments.find(saszDrawCallNames[iCulling]);
+                auto numDrawCalls = pRenderJob->mOutputBufferAttachments.find(saszNumDrawCallNames[iCulling]);
+                assert(drawCalls != pRenderJob->mOutputBufferAttachments.end());
+                cullingJob.mpRenderJob = pRenderJob;
+                cullingJob.mpDrawCalls = &drawCalls->second;
+                cullingJob.mpNumDrawCalls = (numDrawCalls != pRenderJob->mOutputBufferAttachments.end()) ? &numDrawCalls->second : nullptr;
+            }
+        }
+
+#if defined(__EMSCRIPTEN__) || !defined(_MSC_VER)
+        // one draw call per slot of the sum of every instance's meshlets is more than the whole meshes, the cluster
+        // culling jobs don't run without multi draw
+        for(CullingJob const& cullingJob : maCullingJobs[(uint32_t)CullingType::Cluster])
+        {
+            if(cullingJob.mpRenderJob != nullptr)
+            {
+                cullingJob.mpRenderJob->mbEnabled = false;
+            }
+        }
+#endif // __EMSCRIPTEN__
+    }
+
+    /*
+    ** buffers of the app's meshes from their names, the app registers them before the first draw
+    */
+    void CRenderer::resolveMeshBuffers()
+    {
+        std::vector<std::string> aBufferNames;
+        std::pair<void(*)(std::vector<std::string>&), std::vector<BufferHandle>*> aBufferLists[] =
+        {
+            {mpfnGetVertexBufferNames, &maMeshVertexBuffers},
+            {mpfnGetIndexBufferNames, &maMeshIndexBuffers},
+            {mpfnGetAnimVertexBufferNames, &maAnimMeshVertexBuffers},
+            {mpfnGetAnimIndexBufferNames, &maAnimMeshIndexBuffers},
+        };
+        for(auto& bufferList : aBufferLists)
+        {
+            bufferList.second->clear();
+            if(bufferList.first == nullptr)
+            {
+                continue;
+            }
+
+            aBufferNames.clear();
+            (*bufferList.first)(aBufferNames);
+            for(auto const& bufferName : aBufferNames)
+            {
+                BufferHandle handle = maBuffers.getHandle(bufferName);
+                assert(handle != kInvalidBufferHandle);
+                bufferList.second->push_back(handle);
+            }
+        }
+
+        mbMeshBuffersResolved = true;
+    }
+
+    /*
+    ** the app's index and vertex ranges for this frame, asked for on the main thread before any job records. the
+    ** recording threads only read the copies, the app's state isn't theirs to touch
+    */
+    void CRenderer::resolveMeshRanges()
+    {
+        std::pair<void(*)(std::vector<std::pair<uint32_t, uint32_t>>&), std::vector<std::pair<uint32_t, uint32_t>>*> aRangeLists[] =
+        {
+            {mpfnGetIndexRanges, &maMeshIndexRanges},
+            {mpfnGetAnimIndexRanges, &maAnimMeshIndexRanges},
+            {mpfnGetAnimVertexRanges, &maAnimMeshVertexRanges},
+        };
+        for(auto& rangeList : aRangeLists)
+        {
+            rangeList.second->clear();
+            if(rangeList.first != nullptr)
+            {
+                (*rangeList.first)(*rangeList.second);
+            }
+        }
+    }
+
+    /*
+    ** draws of the cluster culling job, each is a run of visible meshlets of one instance in the shared index
+    ** buffer. the count is only known on the gpu, the multi draw reads it
+    */
+    void CRenderer::drawClusters(
+        wgpu::RenderPassEncoder& renderPassEncoder,
+        Render::CRenderJob* pRenderJob)
+    {
+        CullingJob const* pCullingJob = getCullingJob(CullingType::Cluster, pRenderJob->mOcclusionPhase);
+        if(pCullingJob == nullptr)
+        {
+            return;
+        }
+
+        renderPassEncoder.SetVertexBuffer(
+            0,
+            maBuffers.get(maMeshVertexBuffers[0])
+        );
+        renderPassEncoder.SetIndexBuffer(
+            maBuffers.get(maMeshIndexBuffers[0]),
+            wgpu::IndexFormat::Uint32
+        );
+
+        // the shaders take the instance from the draw, not from the per mesh uniform
+        uint32_t iOffset = 0;
+        renderPassEncoder.SetBindGroup(
+            2,
+            pRenderJob->maBindGroups[2],
+            1,
+            &iOffset);
+
+#if defined(__EMSCRIPTEN__) || !defined(_MSC_VER)
+        // isClusterCullingEnabled() is false without multi draw
+        assert(!"cluster culling draws without multi draw");
+#else
+        renderPassEncoder.MultiDrawIndexedIndirect(
+            *pCullingJob->mpDrawCalls,
+            0,
+            getNumClusterDrawCalls(*pCullingJob),
+            *pCullingJob->mpNumDrawCalls,
+            0
+        );
+#endif // __EMSCRIPTEN__
+    }
+
+    /*
+    ** whole static meshes the app moves or doesn't move, for the views the culling jobs don't cull for like the light
+    ** views, only the ones in the job's mesh list when it has one. returns the number of triangles
+    */
+    uint32_t CRenderer::drawMeshSet(
+        wgpu::RenderPassEncoder& renderPassEncoder,
+        Render::CRenderJob* pRenderJob,
+        bool bDynamicMeshes)
+    {
+        assert(mpfnGetIndexRanges != nullptr);
+
+        std::vector<std::pair<uint32_t, uint32_t>> const& aiMeshIndexRanges = maMeshIndexRanges;
+
+        uint32_t iNumTriangles = 0;
+        uint32_t iNumMeshes = pRenderJob->mbDrawMeshList ? (uint32_t)pRenderJob->maiDrawMeshes.size() : (uint32_t)maMeshVertexBuffers.size();
+        for(uint32_t i = 0; i < iNumMeshes; i++)
+        {
+            uint32_t iMesh = pRenderJob->mbDrawMeshList ? pRenderJob->maiDrawMeshes[i] : i;
+            if(iMesh >= (uint32_t)maMeshVertexBuffers.size())
+            {
+                continue;
+            }
+
+            bool bDynamic = (iMesh < (uint32_t)mabDynamicMeshes.size() && mabDynamicMeshes[iMesh]);
+            if(bDynamic != bDynamicMeshes)
+            {
+                continue;
+            }
+
+            // dynamic bind group for individual meshes
+            uint32_t iMeshUniformDataOffset = iMesh * 256;
+            renderPassEncoder.SetBindGroup(
+                2,
+                pRenderJob->maBindGroups[2],
+                1,
+                &iMeshUniformDataOffset
+            );
+
+            renderPassEncoder.SetVertexBuffer(
+                0,
+                maBuffers.get(maMeshVertexBuffers[iMesh])
+            );
+            renderPassEncoder.SetIndexBuffer(
+                maBuffers.get(maMeshIndexBuffers[iMesh]),
+                wgpu::IndexFormat::Uint32
+            );
+            uint32_t iIndexCount = aiMeshIndexRanges[iMesh].second - aiMeshIndexRanges[iMesh].first;
+            renderPassEncoder.DrawIndexed(
+                iIndexCount,
+                1,
+                aiMeshIndexRanges[iMesh].first,
+                0,
+                iMesh
+            );
+            iNumTriangles += iIndexCount / 3;
+        }
+
+        return iNumTriangles;
+    }
+
+    /*
+    **
+    */
+    void CRenderer::setDynamicMeshes(std::vector<uint32_t> const& aiMeshes)
+    {
+        mabDynamicMeshes.clear();
+        for(uint32_t iMesh : aiMeshes)
+        {
+            if(iMesh >= (uint32_t)mabDynamicMeshes.size())
+            {
+                mabDynamicMeshes.resize(iMesh + 1, false);
+            }
+            mabDynamicMeshes[iMesh] = true;
+        }
+    }
+
+    /*
+    **
+    */
+    void CRenderer::setJobMeshes(
+        JobHandle job,
+        std::vector<uint32_t> const& aiMeshes)
+    {
+        Render::CRenderJob* pRenderJob = getJob(job);
+        if(pRenderJob == nullptr)
+        {
+            return;
+        }
+
+        pRenderJob->maiDrawMeshes = aiMeshes;
+        pRenderJob->mbDrawMeshList = true;
+    }
+
+    /*
+    **
+    */
+    void CRenderer::invalidateJob(JobHandle job)
+    {
+        Render::CRenderJob* pRenderJob = getJob(job);
+        if(pRenderJob == nullptr)
+        {
+            return;
+        }
+
+        assert(pRenderJob->miNumFrames > 0);
+        pRenderJob->miNumFramesRun = 0;
+        pRenderJob->mbEnabled = true;
+    }
+
+    /*
+    **
+    */
+    uint32_t CRenderer::getNumTriangles(JobHandle job)
+    {
+        Render::CRenderJob* pRenderJob = getJob(job);
+        return (pRenderJob != nullptr) ? pRenderJob->miNumTriangles : 0;
+    }
+
+    /*
+    **
+    */
+    uint2 CRenderer::getOutputSize(JobHandle job)
+    {
+        Render::CRenderJob* pRenderJob = getJob(job);
+        if(pRenderJob == nullptr || pRenderJob->mOutputImageAttachments.empty())
+        {
+            return uint2(0, 0);
+        }
+
+        wgpu::Texture const& texture = pRenderJob->mOutputImageAttachments.begin()->second;
+        return uint2(texture.GetWidth(), texture.GetHeight());
+    }
+
+    /*
+    **
+    */
+    uint2 CRenderer::getRenderSize()
+    {
+        uint32_t aiRenderSize[2];
+        Render::getRenderSize(aiRenderSize, mCreateDesc.miScreenWidth, mCreateDesc.miScreenHeight, mfRenderScale);
+        return uint2(aiRenderSize[0], aiRenderSize[1]);
+    }
+
     /*
     **
     */
     void CRenderer::draw(DrawUpdateDescriptor& desc)
     {
+        auto frameStartTime = std::chrono::high_resolution_clock::now();
+
         DefaultUniformData defaultUniformData;
         defaultUniformData.mViewMatrix = *desc.mpViewMatrix;
         defaultUniformData.mProjectionMatrix = *desc.mpProjectionMatrix;
         defaultUniformData.mViewProjectionMatrix = *desc.mpViewProjectionMatrix;
         defaultUniformData.mPrevViewProjectionMatrix = *desc.mpPrevViewProjectionMatrix;
-        defaultUniformData.mJitteredViewProjectionMatrix = *desc.mpViewProjectionMatrix;
-        defaultUniformData.mPrevJitteredViewProjectionMatrix = *desc.mpPrevViewProjectionMatrix;
+        defaultUniformData.mJitteredViewProjectionMatrix = (desc.mpJitteredViewProjectionMatrix != nullptr) ? *desc.mpJitteredViewProjectionMatrix : *desc.mpViewProjectionMatrix;
+        defaultUniformData.mPrevJitteredViewProjectionMatrix = (desc.mpPrevJitteredViewProjectionMatrix != nullptr) ? *desc.mpPrevJitteredViewProjectionMatrix : *desc.mpPrevViewProjectionMatrix;
         defaultUniformData.miScreenWidth = (int32_t)mCreateDesc.miScreenWidth;
         defaultUniformData.miScreenHeight = (int32_t)mCreateDesc.miScreenHeight;
         defaultUniformData.miFrame = miFrame;
@@ -304,9 +707,19 @@ namespace Render
 
         defaultUniformData.mInverseViewProjectionMatrix = invert(*desc.mpViewProjectionMatrix);
 
+        // the exact ratio of the rounded render size, the shaders take the size back from it
+        uint2 renderSize = getRenderSize();
+        float2 renderScale = float2(
+            (float)renderSize.x / (float)mCreateDesc.miScreenWidth,
+            (float)renderSize.y / (float)mCreateDesc.miScreenHeight);
+        defaultUniformData.mRenderScale = float4(renderScale.x, renderScale.y, mPrevRenderScale.x, mPrevRenderScale.y);
+        defaultUniformData.mJitter = float4(desc.mJitter.x, desc.mJitter.y, mPrevJitter.x, mPrevJitter.y);
+        mPrevRenderScale = renderScale;
+        mPrevJitter = desc.mJitter;
+
         // update default uniform buffer
-        mpDevice->GetQueue().WriteBuffer(
-            maBuffers["default-uniform-buffer"],
+        queueBufferUpload(
+            maBuffers.get(miDefaultUniformBuffer),
             0,
             &defaultUniformData,
             sizeof(defaultUniformData)
@@ -390,404 +803,664 @@ namespace Render
 
         // clear number of draw calls
         char acClearData[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-        if(maRenderJobs.find("Mesh Culling Compute") != maRenderJobs.end())
+        CullingJob const& meshCullingJob = maCullingJobs[(uint32_t)CullingType::Mesh][(uint32_t)Render::OcclusionPhase::None];
+        if(meshCullingJob.mpRenderJob != nullptr)
         {
-            mpDevice->GetQueue().WriteBuffer(
-                maRenderJobs["Mesh Culling Compute"]->mOutputBufferAttachments["Draw Calls"],
+            queueBufferUpload(
+                *meshCullingJob.mpDrawCalls,
                 0,
                 acClearData,
                 sizeof(acClearData)
             );
         }
 
-        if(miFrame > 2)
+#if !defined(__EMSCRIPTEN__)
+        // pipelines that finished compiling hand themselves to their jobs
+        if(mPipelineCache.getNumPendingPipelines() > 0)
         {
-            auto iter = std::find_if(
-                maRenderJobs.begin(),
-                maRenderJobs.end(),
-                [](auto& renderJob)
-                {
-                    return (renderJob.first == "Sky Convolution Graphics");
-                }
-            );
-            if(iter != maRenderJobs.end())
+            mpInstance->ProcessEvents();
+        }
+#endif // __EMSCRIPTEN__
+
+        // jobs wait for their pipelines and for the jobs they read from, jobs that only run for the first frames, like
+        // the sky that doesn't change, stop after running them
+        uint32_t iNumSkippedJobs = 0;
+        for(Render::CRenderJob* pRenderJob : mapOrderedRenderJobs)
+        {
+            if(pRenderJob->miNumFrames > 0 && pRenderJob->miNumFramesRun >= pRenderJob->miNumFrames)
             {
-                iter->second->mbEnabled = false;
+                pRenderJob->mbEnabled = false;
             }
 
-            iter = std::find_if(
-                maRenderJobs.begin(),
-                maRenderJobs.end(),
-                [](auto& renderJob)
-                {
-                    return (renderJob.first == "Atmosphere Graphics");
-                }
-            );
-            if(iter != maRenderJobs.end())
+            pRenderJob->miNumTriangles = 0;
+            pRenderJob->mbSkipped = !pRenderJob->mbPipelineReady;
+            for(Render::CRenderJob* pReadJob : pRenderJob->mapReadJobs)
+            {
+                pRenderJob->mbSkipped = (pRenderJob->mbSkipped || pReadJob->mbSkipped);
+            }
+
+            if(pRenderJob->mbSkipped)
             {
-                iter->second->mbEnabled = false;
+                ++iNumSkippedJobs;
+            }
+            else if(pRenderJob->mbEnabled)
+            {
+                ++pRenderJob->miNumFramesRun;
             }
         }
 
-        // add commands from the render jobs
+        if(!mbMeshBuffersResolved)
+        {
+            resolveMeshBuffers();
+        }
+        resolveMeshRanges();
+
+        mFrameRecordStats = {};
+
+        // the whole frame goes in one encoder, or one encoder per job to compare with
         std::vector<wgpu::CommandBuffer> aCommandBuffer;
-        for(auto const& renderJobName : maOrderedRenderJobs)
+        wgpu::CommandEncoderDescriptor frameCommandEncoderDesc = {};
+        wgpu::CommandEncoder frameCommandEncoder = mpDevice->CreateCommandEncoder(&frameCommandEncoderDesc);
+        frameCommandEncoder.SetLabel("Frame Command Encoder");
+        ++mFrameRecordStats.miNumEncoders;
+
+        // this frame's buffer updates go first
+        flushUploads(frameCommandEncoder);
+        if(mRecordingMode != RecordingMode::SingleEncoder)
         {
-            Render::CRenderJob* pRenderJob = maRenderJobs[renderJobName].get();
-            if(pRenderJob->mbEnabled == false)
+            aCommandBuffer.push_back(frameCommandEncoder.Finish());
+            frameCommandEncoder = mpDevice->CreateCommandEncoder(&frameCommandEncoderDesc);
+            ++mFrameRecordStats.miNumEncoders;
+        }
+
+        // add commands from the render jobs
+        maiFrameRecordJobs.clear();
+        for(uint32_t iJob = 0; iJob < (uint32_t)maOrderedRenderJobs.size(); iJob++)
+        {
+            Render::CRenderJob* pRenderJob = mapOrderedRenderJobs[iJob];
+            if(pRenderJob->mbEnabled == false || pRenderJob->mbSkipped)
             {
                 continue;
             }
 
-            wgpu::CommandEncoderDescriptor commandEncoderDesc = {};
-            wgpu::CommandEncoder commandEncoder = mpDevice->CreateCommandEncoder(&commandEncoderDesc);
-            if(pRenderJob->mType == Render::JobType::Graphics)
+            if(mRecordingMode == RecordingMode::ParallelChunks)
+            {
+                maiFrameRecordJobs.push_back(iJob);
+            }
+            else if(mRecordingMode == RecordingMode::EncoderPerJob)
+            {
+                wgpu::CommandEncoderDescriptor commandEncoderDesc = {};
+                wgpu::CommandEncoder commandEncoder = mpDevice->CreateCommandEncoder(&commandEncoderDesc);
+                ++mFrameRecordStats.miNumEncoders;
+
+                mFrameRecordStats.miNumPasses += encodeRenderJob(commandEncoder, pRenderJob);
+
+                aCommandBuffer.push_back(commandEncoder.Finish());
+            }
+            else
             {
-                uint32_t iOutputAttachmentWidth = pRenderJob->mOutputImageAttachments.begin()->second.GetWidth();
-                uint32_t iOutputAttachmentHeight = pRenderJob->mOutputImageAttachments.begin()->second.GetHeight();
+                mFrameRecordStats.miNumPasses += encodeRenderJob(frameCommandEncoder, pRenderJob);
+            }
 
-                wgpu::RenderPassDescriptor renderPassDesc = {};
-                renderPassDesc.colorAttachmentCount = pRenderJob->maOutputAttachments.size();
-                renderPassDesc.colorAttachments = pRenderJob->maOutputAttachments.data();
-                renderPassDesc.depthStencilAttachment = &pRenderJob->mDepthStencilAttachment;
-                wgpu::RenderPassEncoder renderPassEncoder = commandEncoder.BeginRenderPass(&renderPassDesc);
-                std::string renderPassEncoderName = pRenderJob->mName + " Render Pass Encoder";
-                renderPassEncoder.SetLabel(renderPassEncoderName.c_str());
+        }   // for all render jobs
 
-                renderPassEncoder.PushDebugGroup(pRenderJob->mName.c_str());
+        if(mRecordingMode == RecordingMode::ParallelChunks)
+        {
+            // chunks of about the same recording time as last frame, submitted in the jobs' order
+            std::vector<uint64_t> aiCosts;
+            for(uint32_t iJob : maiFrameRecordJobs)
+            {
+                aiCosts.push_back(maiJobRecordCosts[iJob]);
+            }
+            uint32_t iNumChunks = (uint32_t)mRecordScheduler.split(aiCosts).size();
+            maChunkCommandBuffers.assign(iNumChunks, wgpu::CommandBuffer());
+            maiChunkNumPasses.assign(iNumChunks, 0);
 
-                // bind broup, pipeline, index buffer, vertex buffer, scissor rect, viewport, and draw
-                for(uint32_t iGroup = 0; iGroup < 2; iGroup++)
+            mRecordScheduler.record(
+                [](uint32_t iChunk, uint32_t iFirstJob, uint32_t iNumJobs, void* pUserData)
                 {
-                    renderPassEncoder.SetBindGroup(
-                        iGroup,
-                        pRenderJob->maBindGroups[iGroup]);
-                }
+                    CRenderer* pRenderer = (CRenderer*)pUserData;
+                    pRenderer->recordChunk(iChunk, iFirstJob, iNumJobs);
+                },
+                this);
 
-                renderPassEncoder.SetPipeline(pRenderJob->mRenderPipeline);
-                
-                renderPassEncoder.SetScissorRect(
-                    0,
-                    0,
-                    iOutputAttachmentWidth,
-                    iOutputAttachmentHeight);
-                renderPassEncoder.SetViewport(
-                    0,
-                    0,
-                    (float)iOutputAttachmentWidth,
-                    (float)iOutputAttachmentHeight,
-                    0.0f,
-                    1.0f);
-                
-                if(pRenderJob->mPassType == Render::PassType::DrawMeshes)
+            for(uint32_t iChunk = 0; iChunk < iNumChunks; iChunk++)
+            {
+                aCommandBuffer.push_back(maChunkCommandBuffers[iChunk]);
+                mFrameRecordStats.miNumPasses += maiChunkNumPasses[iChunk];
+            }
+            mFrameRecordStats.miNumEncoders += iNumChunks;
+        }
+
+        for(Render::CRenderJob* pRenderJob : mapOrderedRenderJobs)
+        {
+            mFrameRecordStats.miNumTriangles += pRenderJob->miNumTriangles;
+        }
+
+        // get selection info from shader via read back buffer
+        if(mbWaitingForMeshSelection && maRenderJobs.find(mCaptureImageJobName) != maRenderJobs.end())
+        {
+            frameCommandEncoder.CopyBufferToBuffer(
+                maRenderJobs[mCaptureImageJobName]->mUniformBuffers[mCaptureUniformBufferName],
+                0,
+                mOutputImageBuffer,
+                0,
+                64
+            );
+
+            printf("copy selection buffer\n");
+            mbSelectedBufferCopied = true;
+        }
+        aCommandBuffer.push_back(frameCommandEncoder.Finish());
+
+        // submit all the job commands
+        mpDevice->GetQueue().Submit(
+            (uint32_t)aCommandBuffer.size(), 
+            aCommandBuffer.data());
+        ++mFrameRecordStats.miNumSubmits;
+        mFrameRecordStats.miNumCommandBuffers = (uint32_t)aCommandBuffer.size();
+        auto frameEndTime = std::chrono::high_resolution_clock::now();
+
+        if(!mbTimingGPU)
+        {
+            mbTimingGPU = true;
+            mGPUSubmitTime = frameEndTime;
+#if defined(__EMSCRIPTEN__)
+            mpDevice->GetQueue().OnSubmittedWorkDone(
+                [](WGPUQueueWorkDoneStatus status,
+                    void* pUserData)
+                {
+                    CRenderer* pRenderer = (CRenderer*)pUserData;
+                    auto doneTime = std::chrono::high_resolution_clock::now();
+                    pRenderer->mfGPUMilliseconds = float(std::chrono::duration_cast<std::chrono::microseconds>(doneTime - pRenderer->mGPUSubmitTime).count()) * 0.001f;
+                    pRenderer->mbTimingGPU = false;
+                },
+                this);
+#else
+            // comes back in the instance's ProcessEvents of a later frame
+            mpDevice->GetQueue().OnSubmittedWorkDone(
+                wgpu::CallbackMode::AllowProcessEvents,
+                [](wgpu::QueueWorkDoneStatus status,
+                    CRenderer* pRenderer)
                 {
-                    if(maRenderJobs.find("Mesh Culling Compute") == maRenderJobs.end())
+                    auto doneTime = std::chrono::high_resolution_clock::now();
+                    if(status == wgpu::QueueWorkDoneStatus::Success)
                     {
-                        assert(mpfnGetVertexBufferNames != nullptr);
-                        assert(mpfnGetIndexBufferNames != nullptr);
-                        assert(mpfnIndexCounts != nullptr);
-
-                        std::vector<std::string> aMeshVertexBufferNames;
-                        (*mpfnGetVertexBufferNames)(
-                            aMeshVertexBufferNames
-                            );
-
-                        std::vector<std::string> aMeshIndexBufferNames;
-                        (*mpfnGetIndexBufferNames)(
-                            aMeshIndexBufferNames
-                            );
-
-                        std::vector<uint32_t> aiMeshIndexCounts;
-                        (*mpfnIndexCounts)(
-                            aiMeshIndexCounts
-                            );
-
-                        std::vector<std::pair<uint32_t, uint32_t>> aiMeshIndexRanges;
-                        (*mpfnGetIndexRanges)(
-                            aiMeshIndexRanges
-                        );
-
-                        for(uint32_t iMesh = 0; iMesh < aMeshVertexBufferNames.size(); iMesh++)
-                        {
-                            // dynamic bind group for individual meshes
-                            uint32_t iMeshUniformDataOffset = iMesh * 256;
-                            renderPassEncoder.SetBindGroup(
-                                2,
-                                pRenderJob->maBindGroups[2],
-                                1,
-                                &iMeshUniformDataOffset
-                            );
-
-                            renderPassEncoder.SetVertexBuffer(
-                                0,
-                                maBuffers[aMeshVertexBufferNames[iMesh]]
-                            );
-                            renderPassEncoder.SetIndexBuffer(
-                                maBuffers[aMeshIndexBufferNames[iMesh]],
-                                wgpu::IndexFormat::Uint32
-                            );
-                            uint32_t iIndexCount = aiMeshIndexRanges[iMesh].second - aiMeshIndexRanges[iMesh].first;
-                            renderPassEncoder.DrawIndexed(
-                                iIndexCount,
-                                1,
-                                aiMeshIndexRanges[iMesh].first,
-                                0,
-                                iMesh
-                            );
-                        }
+                        pRenderer->mfGPUMilliseconds = float(std::chrono::duration_cast<std::chrono::microseconds>(doneTime - pRenderer->mGPUSubmitTime).count()) * 0.001f;
                     }
-                    else
+                    pRenderer->mbTimingGPU = false;
+                },
+                this);
+#endif // __EMSCRIPTEN__
+        }
+        mFrameRecordStats.miCPUMicroseconds = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(frameEndTime - frameStartTime).count();
+        mLastRecordStats = mFrameRecordStats;
+
+        if(miFrame % 600 == 0)
+        {
+            DEBUG_PRINTF("frame %d recording: %d encoders, %d passes, %d command buffers, %d submits, %d triangles, %.3f ms cpu\n",
+                miFrame,
+                mLastRecordStats.miNumEncoders,
+                mLastRecordStats.miNumPasses,
+                mLastRecordStats.miNumCommandBuffers,
+                mLastRecordStats.miNumSubmits,
+                mLastRecordStats.miNumTriangles,
+                (float)mLastRecordStats.miCPUMicroseconds * 0.001f);
+            DEBUG_PRINTF("frame %d render scale %.4f, %d x %d, %.3f ms gpu\n",
+                miFrame,
+                mfRenderScale,
+                renderSize.x,
+                renderSize.y,
+                mfGPUMilliseconds);
+        }
+
+        if(miFrame == 0 || (iNumSkippedJobs == 0 && !mbAllJobsReady))
+        {
+            float fMilliseconds = float(std::chrono::duration_cast<std::chrono::microseconds>(frameEndTime - mSetupStartTime).count()) * 0.001f;
+            DEBUG_PRINTF("frame %d submitted %.2f ms after setup, %d of %d jobs waiting for pipelines\n",
+                miFrame,
+                fMilliseconds,
+                iNumSkippedJobs,
+                (uint32_t)mapOrderedRenderJobs.size());
+            mbAllJobsReady = (iNumSkippedJobs == 0);
+        }
+
+        ++miFrame;
+
+    }
+
+    /*
+    ** chunk of the frame's enabled jobs on a recording thread, the time each job takes splits the next frame
+    */
+    void CRenderer::recordChunk(
+        uint32_t iChunk,
+        uint32_t iFirstJob,
+        uint32_t iNumJobs)
+    {
+        wgpu::CommandEncoderDescriptor commandEncoderDesc = {};
+        wgpu::CommandEncoder commandEncoder = mpDevice->CreateCommandEncoder(&commandEncoderDesc);
+
+        for(uint32_t i = iFirstJob; i < iFirstJob + iNumJobs; i++)
+        {
+            uint32_t iJob = maiFrameRecordJobs[i];
+            Render::CRenderJob* pRenderJob = mapOrderedRenderJobs[iJob];
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            maiChunkNumPasses[iChunk] += encodeRenderJob(commandEncoder, pRenderJob);
+            auto endTime = std::chrono::high_resolution_clock::now();
+
+            maiJobRecordCosts[iJob] = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+        }
+
+        maChunkCommandBuffers[iChunk] = commandEncoder.Finish();
+    }
+
+    /*
+    ** commands of one job, returns the number of render and compute passes
+    */
+    uint32_t CRenderer::encodeRenderJob(
+        wgpu::CommandEncoder& commandEncoder,
+        Render::CRenderJob* pRenderJob)
+    {
+        uint32_t iNumPasses = 0;
+        if(pRenderJob->mType == Render::JobType::Graphics)
+        {
+            uint32_t iNumTriangles = 0;
+            uint32_t iOutputAttachmentWidth = pRenderJob->mOutputImageAttachments.begin()->second.GetWidth();
+            uint32_t iOutputAttachmentHeight = pRenderJob->mOutputImageAttachments.begin()->second.GetHeight();
+            if(pRenderJob->mbDynamicResolution)
+            {
+                uint32_t aiRenderSize[2];
+                Render::getRenderSize(aiRenderSize, iOutputAttachmentWidth, iOutputAttachmentHeight, mfRenderScale);
+                iOutputAttachmentWidth = aiRenderSize[0];
+                iOutputAttachmentHeight = aiRenderSize[1];
+            }
+
+            wgpu::RenderPassDescriptor renderPassDesc = {};
+            renderPassDesc.colorAttachmentCount = pRenderJob->maOutputAttachments.size();
+            renderPassDesc.colorAttachments = pRenderJob->maOutputAttachments.data();
+            renderPassDesc.depthStencilAttachment = &pRenderJob->mDepthStencilAttachment;
+            wgpu::RenderPassEncoder renderPassEncoder = commandEncoder.BeginRenderPass(&renderPassDesc);
+            ++iNumPasses;
+            renderPassEncoder.SetLabel(pRenderJob->mPassLabel.c_str());
+
+            renderPassEncoder.PushDebugGroup(pRenderJob->mName.c_str());
+
+            // bind broup, pipeline, index buffer, vertex buffer, scissor rect, viewport, and draw
+            for(uint32_t iGroup = 0; iGroup < 2; iGroup++)
+            {
+                renderPassEncoder.SetBindGroup(
+                    iGroup,
+                    pRenderJob->maBindGroups[iGroup]);
+            }
+
+            renderPassEncoder.SetPipeline(pRenderJob->mRenderPipeline);
+            
+            renderPassEncoder.SetScissorRect(
+                0,
+                0,
+                iOutputAttachmentWidth,
+                iOutputAttachmentHeight);
+            renderPassEncoder.SetViewport(
+                0,
+                0,
+                (float)iOutputAttachmentWidth,
+                (float)iOutputAttachmentHeight,
+                0.0f,
+                1.0f);
+            
+            if(pRenderJob->mPassType == Render::PassType::DrawMeshes)
+            {
+                if(isClusterCullingEnabled())
+                {
+                    drawClusters(renderPassEncoder, pRenderJob);
+                }
+                else if(maCullingJobs[(uint32_t)CullingType::Mesh][(uint32_t)Render::OcclusionPhase::None].mpRenderJob == nullptr)
+                {
+                    // without culling the early pass draws every mesh and the late one nothing
+                    assert(pRenderJob->mOcclusionPhase != Render::OcclusionPhase::Late);
+
+                    assert(mpfnGetVertexBufferNames != nullptr);
+                    assert(mpfnGetIndexBufferNames != nullptr);
+
+                    std::vector<std::pair<uint32_t, uint32_t>> const& aiMeshIndexRanges = maMeshIndexRanges;
+
+                    for(uint32_t iMesh = 0; iMesh < (uint32_t)maMeshVertexBuffers.size(); iMesh++)
                     {
-                        std::vector<std::string> aMeshVertexBufferNames;
-                        (*mpfnGetVertexBufferNames)(
-                            aMeshVertexBufferNames
-                            );
-
-                        std::vector<std::string> aMeshIndexBufferNames;
-                        (*mpfnGetIndexBufferNames)(
-                            aMeshIndexBufferNames
+                        // dynamic bind group for individual meshes
+                        uint32_t iMeshUniformDataOffset = iMesh * 256;
+                        renderPassEncoder.SetBindGroup(
+                            2,
+                            pRenderJob->maBindGroups[2],
+                            1,
+                            &iMeshUniformDataOffset
                         );
 
                         renderPassEncoder.SetVertexBuffer(
                             0,
-                            maBuffers[aMeshVertexBufferNames[0]]
+                            maBuffers.get(maMeshVertexBuffers[iMesh])
                         );
                         renderPassEncoder.SetIndexBuffer(
-                            maBuffers[aMeshIndexBufferNames[0]],
+                            maBuffers.get(maMeshIndexBuffers[iMesh]),
                             wgpu::IndexFormat::Uint32
                         );
-
-#if defined(__EMSCRIPTEN__) || !defined(_MSC_VER)
-                        for(uint32_t iMesh = 0; iMesh < 128; iMesh++)
-                        {
-                            // dynamic bind group for individual meshes
-                            uint32_t iOffset = iMesh * 256;
-                            renderPassEncoder.SetBindGroup(
-                                2,
-                                pRenderJob->maBindGroups[2],
-                                1,
-                                &iOffset
-                            );
-
-                            renderPassEncoder.DrawIndexedIndirect(
-                                maRenderJobs["Mesh Culling Compute"]->mOutputBufferAttachments["Draw Calls"],
-                                iMesh * 5 * sizeof(uint32_t)
-                            );
-                        }
-
-#else
-                        for(uint32_t iMesh = 0; iMesh < 128; iMesh++)
-                        {
-                            // dynamic bind group for individual meshes
-                            uint32_t iOffset = iMesh * 256;
-                            renderPassEncoder.SetBindGroup(
-                                2,
-                                pRenderJob->maBindGroups[2],
-                                1,
-                                &iOffset);
-                        }
-
-                        renderPassEncoder.MultiDrawIndexedIndirect(
-                            maRenderJobs["Mesh Culling Compute"]->mOutputBufferAttachments["Draw Calls"],
+                        uint32_t iIndexCount = aiMeshIndexRanges[iMesh].second - aiMeshIndexRanges[iMesh].first;
+                        renderPassEncoder.DrawIndexed(
+                            iIndexCount,
+                            1,
+                            aiMeshIndexRanges[iMesh].first,
                             0,
-                            128,
-                            maRenderJobs["Mesh Culling Compute"]->mOutputBufferAttachments["Num Draw Calls"],
-                            0
+                            iMesh
                         );
-#endif // __EMSCRIPTEN__
+                        iNumTriangles += iIndexCount / 3;
                     }
                 }
-                else if(pRenderJob->mPassType == Render::PassType::FullTriangle)
+                else if(getCullingJob(CullingType::Mesh, pRenderJob->mOcclusionPhase) != nullptr)
                 {
-                    renderPassEncoder.SetIndexBuffer(
-                        maBuffers["full-screen-triangle-index-buffer"],
-                        wgpu::IndexFormat::Uint32
-                    );
+                    CullingJob const* pMeshCullingJob = getCullingJob(CullingType::Mesh, pRenderJob->mOcclusionPhase);
+
                     renderPassEncoder.SetVertexBuffer(
                         0,
-                        maBuffers["full-screen-triangle-vertex-buffer"]
+                        maBuffers.get(maMeshVertexBuffers[0])
+                    );
+                    renderPassEncoder.SetIndexBuffer(
+                        maBuffers.get(maMeshIndexBuffers[0]),
+                        wgpu::IndexFormat::Uint32
                     );
 
-                    renderPassEncoder.Draw(3);
-                }
-                else if(pRenderJob->mPassType == Render::PassType::DrawAnimatedMesh)
-                {
-                    std::vector<std::string> aAnimVertexBufferNames;
-                    std::vector<std::string> aAnimIndexBufferNames;
-                    std::vector<std::pair<uint32_t, uint32_t>> aAnimIndexRanges;
-                    std::vector<std::pair<uint32_t, uint32_t>> aAnimVertexRanges;
-
-                    mpfnGetAnimVertexBufferNames(aAnimVertexBufferNames);
-                    mpfnGetAnimIndexBufferNames(aAnimIndexBufferNames);
-                    mpfnGetAnimIndexRanges(aAnimIndexRanges);
-                    mpfnGetAnimVertexRanges(aAnimVertexRanges);
-
-                    for(uint32_t iMesh = 0; iMesh < aAnimVertexBufferNames.size(); iMesh++)
+#if defined(__EMSCRIPTEN__) || !defined(_MSC_VER)
+                    for(uint32_t iMesh = 0; iMesh < 128; iMesh++)
                     {
+                        // dynamic bind group for individual meshes
                         uint32_t iOffset = iMesh * 256;
+                        renderPassEncoder.SetBindGroup(
+                            2,
+                            pRenderJob->maBindGroups[2],
+                            1,
+                            &iOffset
+                        );
 
+                        renderPassEncoder.DrawIndexedIndirect(
+                            *pMeshCullingJob->mpDrawCalls,
+                            iMesh * 5 * sizeof(uint32_t)
+                        );
+                    }
+
+#else
+                    for(uint32_t iMesh = 0; iMesh < 128; iMesh++)
+                    {
                         // dynamic bind group for individual meshes
+                        uint32_t iOffset = iMesh * 256;
                         renderPassEncoder.SetBindGroup(
                             2,
                             pRenderJob->maBindGroups[2],
                             1,
                             &iOffset);
+                    }
 
-                        std::string const& vertexBufferName = aAnimVertexBufferNames[iMesh];
-                        std::string const& indexBufferName = aAnimIndexBufferNames[iMesh];
+                    renderPassEncoder.MultiDrawIndexedIndirect(
+                        *pMeshCullingJob->mpDrawCalls,
+                        0,
+                        128,
+                        *pMeshCullingJob->mpNumDrawCalls,
+                        0
+                    );
+#endif // __EMSCRIPTEN__
+                }
+            }
+            else if(pRenderJob->mPassType == Render::PassType::FullTriangle)
+            {
+                renderPassEncoder.SetIndexBuffer(
+                    maBuffers.get(miFullScreenTriangleIndexBuffer),
+                    wgpu::IndexFormat::Uint32
+                );
+                renderPassEncoder.SetVertexBuffer(
+                    0,
+                    maBuffers.get(miFullScreenTriangleVertexBuffer)
+                );
 
-                        uint32_t iNumIndices = aAnimIndexRanges[iMesh].second - aAnimIndexRanges[iMesh].first;
-                        uint32_t iIndexOffset = aAnimIndexRanges[iMesh].first;
-                        uint32_t iNumVertices = aAnimVertexRanges[iMesh].second - aAnimVertexRanges[iMesh].first;
-                        uint32_t iVertexOffset = aAnimVertexRanges[iMesh].first;
+                renderPassEncoder.Draw(3);
+                iNumTriangles += 1;
+            }
+            else if(pRenderJob->mPassType == Render::PassType::DrawAnimatedMesh)
+            {
+                std::vector<std::pair<uint32_t, uint32_t>> const& aAnimIndexRanges = maAnimMeshIndexRanges;
+                std::vector<std::pair<uint32_t, uint32_t>> const& aAnimVertexRanges = maAnimMeshVertexRanges;
 
+                for(uint32_t iMesh = 0; iMesh < (uint32_t)maAnimMeshVertexBuffers.size(); iMesh++)
+                {
+                    uint32_t iOffset = iMesh * 256;
 
-                        uint32_t iVertexBufferOffset = (pRenderJob->mpInputVertexBuffer != nullptr) ? iMesh * iNumVertices : 0;
-                        renderPassEncoder.SetVertexBuffer(
-                            0,
-                            (pRenderJob->mpInputVertexBuffer != nullptr) ? *pRenderJob->mpInputVertexBuffer : maBuffers[vertexBufferName],
-                            0
-                        );
+                    // dynamic bind group for individual meshes
+                    renderPassEncoder.SetBindGroup(
+                        2,
+                        pRenderJob->maBindGroups[2],
+                        1,
+                        &iOffset);
 
-                        renderPassEncoder.SetIndexBuffer(
-                            maBuffers[indexBufferName],
-                            wgpu::IndexFormat::Uint32
-                        );
+                    uint32_t iNumIndices = aAnimIndexRanges[iMesh].second - aAnimIndexRanges[iMesh].first;
+                    uint32_t iIndexOffset = aAnimIndexRanges[iMesh].first;
+                    uint32_t iNumVertices = aAnimVertexRanges[iMesh].second - aAnimVertexRanges[iMesh].first;
+                    uint32_t iVertexOffset = aAnimVertexRanges[iMesh].first;
 
-                        renderPassEncoder.DrawIndexed(
-                            iNumIndices,
-                            1,
-                            iIndexOffset,
-                            iVertexOffset,
-                            iMesh
-                        );
 
-                    }
+                    uint32_t iVertexBufferOffset = (pRenderJob->mpInputVertexBuffer != nullptr) ? iMesh * iNumVertices : 0;
+                    renderPassEncoder.SetVertexBuffer(
+                        0,
+                        (pRenderJob->mpInputVertexBuffer != nullptr) ? *pRenderJob->mpInputVertexBuffer : maBuffers.get(maAnimMeshVertexBuffers[iMesh]),
+                        0
+                    );
+
+                    renderPassEncoder.SetIndexBuffer(
+                        maBuffers.get(maAnimMeshIndexBuffers[iMesh]),
+                        wgpu::IndexFormat::Uint32
+                    );
+
+                    renderPassEncoder.DrawIndexed(
+                        iNumIndices,
+                        1,
+                        iIndexOffset,
+                        iVertexOffset,
+                        iMesh
+                    );
+                    iNumTriangles += iNumIndices / 3;
+
                 }
+            }
+            else if(pRenderJob->mPassType == Render::PassType::DrawStaticMeshes ||
+                pRenderJob->mPassType == Render::PassType::DrawDynamicMeshes)
+            {
+                iNumTriangles += drawMeshSet(
+                    renderPassEncoder,
+                    pRenderJob,
+                    pRenderJob->mPassType == Render::PassType::DrawDynamicMeshes);
+            }
 
-                renderPassEncoder.PopDebugGroup();
-                renderPassEncoder.End();
+            renderPassEncoder.PopDebugGroup();
+            renderPassEncoder.End();
+            pRenderJob->miNumTriangles = iNumTriangles;
 
 
-            }
-            else if(pRenderJob->mType == Render::JobType::Compute)
+        }
+        else if(pRenderJob->mType == Render::JobType::Compute)
+        {
+            // compacted draws start over every frame, the multi draw stops at the count
+            for(CullingJob const& cullingJob : maCullingJobs[(uint32_t)CullingType::Cluster])
             {
-                wgpu::ComputePassDescriptor computePassDesc = {};
-                wgpu::ComputePassEncoder computePassEncoder = commandEncoder.BeginComputePass(&computePassDesc);
-                std::string renderEncoderName = pRenderJob->mName + " Render Encoder";
-                computePassEncoder.SetLabel(renderEncoderName.c_str());
-                computePassEncoder.PushDebugGroup(pRenderJob->mName.c_str());
-
-                // bind broup, pipeline, index buffer, vertex buffer, scissor rect, viewport, and draw
-                for(uint32_t iGroup = 0; iGroup < (uint32_t)pRenderJob->maBindGroups.size(); iGroup++)
+                if(cullingJob.mpRenderJob == pRenderJob)
                 {
-                    computePassEncoder.SetBindGroup(
-                        iGroup,
-                        pRenderJob->maBindGroups[iGroup]);
+                    commandEncoder.ClearBuffer(*cullingJob.mpNumDrawCalls, 0, cullingJob.mpNumDrawCalls->GetSize());
                 }
-                computePassEncoder.SetPipeline(pRenderJob->mComputePipeline);
-                computePassEncoder.DispatchWorkgroups(
-                    pRenderJob->mDispatchSize.x,
-                    pRenderJob->mDispatchSize.y,
-                    pRenderJob->mDispatchSize.z);
-                
-                computePassEncoder.PopDebugGroup();
-                computePassEncoder.End();
             }
-            else if(pRenderJob->mType == Render::JobType::Copy)
+
+            wgpu::ComputePassDescriptor computePassDesc = {};
+            wgpu::ComputePassEncoder computePassEncoder = commandEncoder.BeginComputePass(&computePassDesc);
+            ++iNumPasses;
+            computePassEncoder.SetLabel(pRenderJob->mPassLabel.c_str());
+            computePassEncoder.PushDebugGroup(pRenderJob->mName.c_str());
+
+            // bind broup, pipeline, index buffer, vertex buffer, scissor rect, viewport, and draw
+            for(uint32_t iGroup = 0; iGroup < (uint32_t)pRenderJob->maBindGroups.size(); iGroup++)
+            {
+                computePassEncoder.SetBindGroup(
+                    iGroup,
+                    pRenderJob->maBindGroups[iGroup]);
+            }
+            computePassEncoder.SetPipeline(pRenderJob->mComputePipeline);
+            computePassEncoder.DispatchWorkgroups(
+                pRenderJob->mDispatchSize.x,
+                pRenderJob->mDispatchSize.y,
+                pRenderJob->mDispatchSize.z);
+            
+            computePassEncoder.PopDebugGroup();
+            computePassEncoder.End();
+        }
+        else if(pRenderJob->mType == Render::JobType::Copy)
+        {
+            commandEncoder.PushDebugGroup(pRenderJob->mName.c_str());
+            for(auto const& keyValue : pRenderJob->mInputImageAttachments)
             {
-                commandEncoder.PushDebugGroup(pRenderJob->mName.c_str());
-                for(auto const& keyValue : pRenderJob->mInputImageAttachments)
-                {
 #if defined(__EMSCRIPTEN__)
-                    wgpu::ImageCopyTexture srcInfo = {};
-                    srcInfo.texture = *keyValue.second;
-                    srcInfo.aspect = wgpu::TextureAspect::All;
-                    srcInfo.mipLevel = 0;
-                    srcInfo.origin.x = 0;
-                    srcInfo.origin.y = 0;
-                    srcInfo.origin.z = 0;
-
-                    wgpu::ImageCopyTexture dstInfo = {};
-                    dstInfo.texture = pRenderJob->mOutputImageAttachments[keyValue.first];
-                    dstInfo.aspect = wgpu::TextureAspect::All;
-                    dstInfo.mipLevel = 0;
-                    dstInfo.origin.x = 0;
-                    dstInfo.origin.y = 0;
-                    dstInfo.origin.z = 0;
+                wgpu::ImageCopyTexture srcInfo = {};
+                srcInfo.texture = *keyValue.second;
+                srcInfo.aspect = wgpu::TextureAspect::All;
+                srcInfo.mipLevel = 0;
+                srcInfo.origin.x = 0;
+                srcInfo.origin.y = 0;
+                srcInfo.origin.z = 0;
+
+                wgpu::ImageCopyTexture dstInfo = {};
+                dstInfo.texture = pRenderJob->mOutputImageAttachments[keyValue.first];
+                dstInfo.aspect = wgpu::TextureAspect::All;
+                dstInfo.mipLevel = 0;
+                dstInfo.origin.x = 0;
+                dstInfo.origin.y = 0;
+                dstInfo.origin.z = 0;
 
 #else 
-                    wgpu::TexelCopyTextureInfo srcInfo = {};
-                    srcInfo.texture = *keyValue.second;
-                    srcInfo.aspect = wgpu::TextureAspect::All;
-                    srcInfo.mipLevel = 0;
-                    srcInfo.origin.x = 0;
-                    srcInfo.origin.y = 0;
-                    srcInfo.origin.z = 0;
-
-                    wgpu::TexelCopyTextureInfo dstInfo = {};
-                    dstInfo.texture = pRenderJob->mOutputImageAttachments[keyValue.first];
-                    dstInfo.aspect = wgpu::TextureAspect::All;
-                    dstInfo.mipLevel = 0;
-                    dstInfo.origin.x = 0;
-                    dstInfo.origin.y = 0;
-                    dstInfo.origin.z = 0;
+                wgpu::TexelCopyTextureInfo srcInfo = {};
+                srcInfo.texture = *keyValue.second;
+                srcInfo.aspect = wgpu::TextureAspect::All;
+                srcInfo.mipLevel = 0;
+                srcInfo.origin.x = 0;
+                srcInfo.origin.y = 0;
+                srcInfo.origin.z = 0;
+
+                wgpu::TexelCopyTextureInfo dstInfo = {};
+                dstInfo.texture = pRenderJob->mOutputImageAttachments[keyValue.first];
+                dstInfo.aspect = wgpu::TextureAspect::All;
+                dstInfo.mipLevel = 0;
+                dstInfo.origin.x = 0;
+                dstInfo.origin.y = 0;
+                dstInfo.origin.z = 0;
 #endif // __EMSCRIPTEN__
-                    
-                    wgpu::Extent3D copySize = {};
-                    copySize.depthOrArrayLayers = 1;
-                    copySize.width = srcInfo.texture.GetWidth();
-                    copySize.height = srcInfo.texture.GetHeight();
-                    commandEncoder.CopyTextureToTexture(&srcInfo, &dstInfo, &copySize);
-                }
                 
-                for(auto& keyValue : pRenderJob->mInputBufferAttachments)
-                {
-                    assert(pRenderJob->mOutputBufferAttachments[keyValue.first] != nullptr);
-                    commandEncoder.CopyBufferToBuffer(
-                        *keyValue.second,
-                        0,
-                        pRenderJob->mOutputBufferAttachments[keyValue.first],
-                        0,
-                        keyValue.second->GetSize()
-                    );
-                }
-                commandEncoder.PopDebugGroup();
+                wgpu::Extent3D copySize = {};
+                copySize.depthOrArrayLayers = 1;
+                copySize.width = srcInfo.texture.GetWidth();
+                copySize.height = srcInfo.texture.GetHeight();
+                commandEncoder.CopyTextureToTexture(&srcInfo, &dstInfo, &copySize);
+            }
+            
+            for(auto& keyValue : pRenderJob->mInputBufferAttachments)
+            {
+                assert(pRenderJob->mOutputBufferAttachments[keyValue.first] != nullptr);
+                commandEncoder.CopyBufferToBuffer(
+                    *keyValue.second,
+                    0,
+                    pRenderJob->mOutputBufferAttachments[keyValue.first],
+                    0,
+                    keyValue.second->GetSize()
+                );
             }
+            commandEncoder.PopDebugGroup();
+        }
 
-            wgpu::CommandBuffer commandBuffer = commandEncoder.Finish();
-            aCommandBuffer.push_back(commandBuffer);
+        return iNumPasses;
+    }
 
-        }   // for all render jobs
+    /*
+    **
+    */
+    void CRenderer::queueBufferUpload(
+        wgpu::Buffer const& buffer,
+        uint64_t iOffset,
+        void const* pData,
+        uint64_t iSize)
+    {
+        // handful of destinations per frame, linear search is fine
+        uint32_t iDestination = 0;
+        for(iDestination = 0; iDestination < (uint32_t)maUploadDestinations.size(); iDestination++)
+        {
+            if(maUploadDestinations[iDestination].Get() == buffer.Get())
+            {
+                break;
+            }
+        }
+        if(iDestination >= (uint32_t)maUploadDestinations.size())
+        {
+            maUploadDestinations.push_back(buffer);
+        }
 
-        // get selection info from shader via read back buffer
-        if(mbWaitingForMeshSelection && maRenderJobs.find(mCaptureImageJobName) != maRenderJobs.end())
+        mUploadRing.write(
+            iDestination,
+            iOffset,
+            pData,
+            iSize);
+    }
+
+    /*
+    **
+    */
+    void CRenderer::flushUploads(wgpu::CommandEncoder& commandEncoder)
+    {
+        mLastUploadStats = mUploadRing.getFrameStats();
+
+        uint64_t iStagingSize = mUploadRing.getStagingSize();
+        if(iStagingSize > 0)
         {
-            wgpu::CommandEncoderDescriptor commandEncoderDesc = {};
-            wgpu::CommandEncoder commandEncoder = mpDevice->CreateCommandEncoder(&commandEncoderDesc);
+            // grow in 64k steps, sized for the largest frame so far
+            if(mUploadBuffer == nullptr || mUploadBuffer.GetSize() < iStagingSize)
+            {
+                wgpu::BufferDescriptor bufferDesc = {};
+                bufferDesc.size = ((iStagingSize + 65535) / 65536) * 65536;
+                bufferDesc.usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst;
+                mUploadBuffer = mpDevice->CreateBuffer(&bufferDesc);
+                mUploadBuffer.SetLabel("Upload Ring Buffer");
+            }
 
-            commandEncoder.CopyBufferToBuffer(
-                maRenderJobs[mCaptureImageJobName]->mUniformBuffers[mCaptureUniformBufferName],
-                0,
-                mOutputImageBuffer,
+            // one upload for the whole frame, then copies out to the destinations
+            mpDevice->GetQueue().WriteBuffer(
+                mUploadBuffer,
                 0,
-                64
-            );
+                mUploadRing.getStagingData(),
+                iStagingSize);
 
-            wgpu::CommandBuffer commandBuffer = commandEncoder.Finish();
-            aCommandBuffer.push_back(commandBuffer);
-
-            printf("copy selection buffer\n");
-            mbSelectedBufferCopied = true;
+            commandEncoder.PushDebugGroup("Upload Ring");
+            for(auto const& region : mUploadRing.getCopyRegions())
+            {
+                commandEncoder.CopyBufferToBuffer(
+                    mUploadBuffer,
+                    region.miStagingOffset,
+                    maUploadDestinations[region.miDestination],
+                    region.miDestOffset,
+                    region.miSize);
+            }
+            commandEncoder.PopDebugGroup();
         }
 
-        // submit all the job commands
-        mpDevice->GetQueue().Submit(
-            (uint32_t)aCommandBuffer.size(), 
-            aCommandBuffer.data());
-
-        ++miFrame;
+        if(miFrame % 600 == 0)
+        {
+            DEBUG_PRINTF("frame %d uploads: %d writes %lld bytes -> 1 upload %lld bytes, %d copies\n",
+                miFrame,
+                mLastUploadStats.miNumWrites,
+                mLastUploadStats.miNumWrittenBytes,
+                mLastUploadStats.miNumUploadedBytes,
+                mLastUploadStats.miNumCopies);
+        }
 
+        mUploadRing.beginFrame();
+        maUploadDestinations.clear();
     }
 
     /*
@@ -795,21 +1468,120 @@ namespace Render
     */
     void CRenderer::createRenderJobs(CreateDescriptor& desc)
     {
-        char* acFileContentBuffer = nullptr;
-        uint32_t iDataSize = Loader::loadFile(
-            &acFileContentBuffer,
-            "render-jobs/" + desc.mRenderJobPipelineFilePath,
-            true
-        );
-        assert(iDataSize > 0);
+        // the compiled job list is one read without parsing json, the json job list and its pipeline files when
+        // there isn't one or it doesn't check out
+        auto startTime = std::chrono::high_resolution_clock::now();
+        Render::CRenderJobDescriptions jobDescriptions;
+        bool bDescriptionsLoaded = false;
+        if(desc.mCompiledRenderJobsFilePath.length() > 0)
+        {
+            char* acCompiledFile = nullptr;
+            uint32_t iCompiledFileSize = Loader::loadFile(
+                &acCompiledFile,
+                "render-jobs/" + desc.mCompiledRenderJobsFilePath);
+            bDescriptionsLoaded = jobDescriptions.read(acCompiledFile, iCompiledFileSize);
+            Loader::loadFileFree(acCompiledFile);
+            if(!bDescriptionsLoaded)
+            {
+                DEBUG_PRINTF("!!! can\'t use compiled job list \"%s\": %s !!!\n",
+                    desc.mCompiledRenderJobsFilePath.c_str(),
+                    jobDescriptions.getErrors().back().c_str());
+            }
+        }
+
+        if(!bDescriptionsLoaded)
+        {
+            char* acFileContentBuffer = nullptr;
+            uint32_t iDataSize = Loader::loadFile(
+                &acFileContentBuffer,
+                "render-jobs/" + desc.mRenderJobPipelineFilePath,
+                true
+            );
+            assert(iDataSize > 0);
+
+            bDescriptionsLoaded = jobDescriptions.compile(
+                acFileContentBuffer,
+                [](std::string& content, std::string const& filePath, void* pUserData)
+                {
+                    char* acPipelineFile = nullptr;
+                    uint32_t iPipelineFileSize = Loader::loadFile(&acPipelineFile, "render-jobs/" + filePath, true);
+                    if(iPipelineFileSize == 0)
+                    {
+                        return false;
+                    }
+                    content = acPipelineFile;
+                    Loader::loadFileFree(acPipelineFile);
+
+                    return true;
+                },
+                nullptr);
+            Loader::loadFileFree(acFileContentBuffer);
+
+            for(auto const& error : jobDescriptions.getErrors())
+            {
+                DEBUG_PRINTF("!!! %s !!!\n", error.c_str());
+            }
+            assert(bDescriptionsLoaded);
+        }
+        DEBUG_PRINTF("%d render job descriptions in %.2f ms\n",
+            (uint32_t)jobDescriptions.getJobs().size(),
+            float(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count()) * 0.001f);
+
+        // jobs go in the compiled order without the culled ones, the listed order if the job list doesn't compile
+        Render::CRenderGraph renderGraph;
+        bool bCompiled = renderGraph.compile(jobDescriptions);
+        if(!bCompiled)
+        {
+            DEBUG_PRINTF("!!! render graph of \"%s\" doesn't compile !!!\n", desc.mRenderJobPipelineFilePath.c_str());
+            renderGraph.print();
+            assert(0);
+        }
+        mOutputJobName = jobDescriptions.getOutputJob();
+        mOutputAttachmentName = jobDescriptions.getOutputAttachment();
+
+        // outputs not needed past their last read in a frame share textures and buffers
+        mTransientAllocator.clear();
+        if(bCompiled)
+        {
+            renderGraph.addTransientResources(mTransientAllocator, desc.miScreenWidth, desc.miScreenHeight);
+            mTransientAllocator.allocate();
+            DEBUG_PRINTF("render job outputs %.2f MB, %.2f MB with aliasing\n",
+                (double)mTransientAllocator.getNumUnaliasedBytes() / (1024.0 * 1024.0),
+                (double)mTransientAllocator.getNumAliasedBytes() / (1024.0 * 1024.0));
+        }
+        maTransientTextures.assign(mTransientAllocator.getSlots().size(), wgpu::Texture());
+        maTransientBuffers.assign(mTransientAllocator.getSlots().size(), wgpu::Buffer());
+
+        // shader variants of the jobs, the files are read once for every variant that includes them
+        mShaderPreprocessor.setup(
+            [](std::string& content, std::string const& filePath, void* pUserData)
+            {
+                char* acShaderFile = nullptr;
+                uint32_t iShaderFileSize = Loader::loadFile(&acShaderFile, "shaders/" + filePath, true);
+                if(iShaderFileSize == 0)
+                {
+                    return false;
+                }
+                content = acShaderFile;
+                Loader::loadFileFree(acShaderFile);
+
+                return true;
+            },
+            nullptr);
 
         Render::CRenderJob::CreateInfo createInfo = {};
         createInfo.miScreenWidth = desc.miScreenWidth;
         createInfo.miScreenHeight = desc.miScreenHeight;
+        createInfo.mpTransientAllocator = &mTransientAllocator;
+        createInfo.mpPipelineCache = &mPipelineCache;
+        createInfo.mpShaderPreprocessor = &mShaderPreprocessor;
+        createInfo.mbAsyncPipelines = desc.mbAsyncPipelines;
+        createInfo.mpaTransientTextures = &maTransientTextures;
+        createInfo.mpaTransientBuffers = &maTransientBuffers;
         createInfo.mpfnGetBuffer = [](uint32_t& iBufferSize, std::string const& bufferName, void* pUserData)
         {
             Render::CRenderer* pRenderer = (Render::CRenderer*)pUserData;
-            assert(pRenderer->maBuffers.find(bufferName) != pRenderer->maBuffers.end());
+            assert(pRenderer->maBuffers.contains(bufferName));
             
             iBufferSize = pRenderer->maBufferSizes[bufferName];
             return pRenderer->maBuffers[bufferName];
@@ -824,41 +1596,33 @@ namespace Render
             return pRenderer->maTextures[textureName];
         };
 
-        rapidjson::Document doc;
-        {
-            doc.Parse(acFileContentBuffer);
-            Loader::loadFileFree(acFileContentBuffer);
-        }
-
         std::vector<std::string> aRenderJobNames;
-        std::vector<std::string> aShaderModuleFilePath;
+        std::vector<Render::CRenderJobDescriptions::Job const*> apJobDescriptions;
 
-        auto const& jobs = doc["Jobs"].GetArray();
-        for(auto const& job : jobs)
+        // the graph's job indices are the descriptions'
+        std::vector<uint32_t> aiJobs;
+        if(bCompiled)
+        {
+            aiJobs = renderGraph.getSchedule();
+        }
+        else
         {
-            if(job.HasMember("Disable"))
+            for(uint32_t iJob = 0; iJob < (uint32_t)jobDescriptions.getJobs().size(); iJob++)
             {
-                if(std::string(job["Disable"].GetString()) == "True")
-                {
-                    continue;
-                }
+                aiJobs.push_back(iJob);
             }
+        }
 
-            createInfo.mName = job["Name"].GetString();
-            std::string jobType = job["Type"].GetString();
-            createInfo.mJobType = Render::JobType::Graphics;
-            if(jobType == "Compute")
-            {
-                createInfo.mJobType = Render::JobType::Compute;
-            }
-            else if(jobType == "Copy")
-            {
-                createInfo.mJobType = Render::JobType::Copy;
-            }
+        for(uint32_t iJob : aiJobs)
+        {
+            Render::CRenderJobDescriptions::Job const& job = jobDescriptions.getJobs()[iJob];
+
+            createInfo.mName = job.mName;
+            createInfo.mJobType = job.mType;
 
             maOrderedRenderJobs.push_back(createInfo.mName);
 
-            std::string passStr = job["PassType"].GetString();
+            std::string const& passStr = job.mPassType;
             if(passStr == "Compute")
             {
                 createInfo.mPassType = Render::PassType::Compute;
@@ -871,6 +1635,14 @@ namespace Render
             {
                 createInfo.mPassType = Render::PassType::DrawAnimatedMesh;
             }
+            else if(passStr == "Draw Static Meshes")
+            {
+                createInfo.mPassType = Render::PassType::DrawStaticMeshes;
+            }
+            else if(passStr == "Draw Dynamic Meshes")
+            {
+                createInfo.mPassType = Render::PassType::DrawDynamicMeshes;
+            }
             else if(passStr == "Full Triangle")
             {
                 createInfo.mPassType = Render::PassType::FullTriangle;
@@ -887,33 +1659,24 @@ namespace Render
             {
                 createInfo.mPassType = Render::PassType::DepthPrepass;
             }
-            else if(passStr == "Copy")
-            {
-                createInfo.mPassType = Render::PassType::Copy;
-            }
 
             createInfo.mpDevice = mpDevice;
-
-            std::string pipelineFilePath = std::string("render-jobs/") + job["Pipeline"].GetString();
-            createInfo.mPipelineFilePath = pipelineFilePath;
-
+            createInfo.mpJobDescription = &job;
             createInfo.mpSampler = desc.mpSampler;
 
-            aShaderModuleFilePath.push_back(pipelineFilePath);
+            apJobDescriptions.push_back(&job);
 
             maRenderJobs[createInfo.mName] = std::make_unique<Render::CRenderJob>();
             maRenderJobs[createInfo.mName]->createWithOnlyOutputAttachments(createInfo);
-            
-            if(jobType == "Compute")
+            maRenderJobs[createInfo.mName]->mPassLabel = createInfo.mName + ((job.mType == Render::JobType::Compute) ? " Render Encoder" : " Render Pass Encoder");
+
+            if(job.mType == Render::JobType::Compute)
             {
-                if(job.HasMember("Dispatch"))
-                {
-                    auto dispatchArray = job["Dispatch"].GetArray();
-                    maRenderJobs[createInfo.mName]->mDispatchSize.x = dispatchArray[0].GetUint();
-                    maRenderJobs[createInfo.mName]->mDispatchSize.y = dispatchArray[1].GetUint();
-                    maRenderJobs[createInfo.mName]->mDispatchSize.z = dispatchArray[2].GetUint();
-                }
+                maRenderJobs[createInfo.mName]->mDispatchSize = uint3(job.maiDispatch[0], job.maiDispatch[1], job.maiDispatch[2]);
             }
+            maRenderJobs[createInfo.mName]->miNumFrames = job.miNumFrames;
+            maRenderJobs[createInfo.mName]->mbDynamicResolution = job.mbDynamicResolution;
+            maRenderJobs[createInfo.mName]->mOcclusionPhase = job.mOcclusionPhase;
 
             aRenderJobNames.push_back(createInfo.mName);
         }
@@ -933,7 +1696,7 @@ namespace Render
             createInfo.mName = renderJobName;
             createInfo.mJobType = maRenderJobs[renderJobName]->mType;
             createInfo.mPassType = maRenderJobs[renderJobName]->mPassType;
-            createInfo.mPipelineFilePath = aShaderModuleFilePath[iIndex];
+            createInfo.mpJobDescription = apJobDescriptions[iIndex];
 
             if(maRenderJobs[renderJobName]->mType == Render::JobType::Copy)
             {
@@ -962,7 +1725,7 @@ namespace Render
             createInfo.mName = renderJobName;
             createInfo.mJobType = maRenderJobs[renderJobName]->mType;
             createInfo.mPassType = maRenderJobs[renderJobName]->mPassType;
-            createInfo.mPipelineFilePath = aShaderModuleFilePath[iIndex];
+            createInfo.mpJobDescription = apJobDescriptions[iIndex];
 
             if(createInfo.mJobType == Render::JobType::Copy)
             {
@@ -971,16 +1734,22 @@ namespace Render
             iIndex += 1;
         }
 
-        // link deferred input attachments
+        // link deferred input attachments, just before the job's pipeline since the depth textures of the graphics
+        // jobs are only there once their own pipelines are created
+        iIndex = 0;
+        for(auto const& renderJobName : aRenderJobNames)
         {
             for(auto& aAttachmentInfo : aaDeferredAttachments)
             {
                 for(auto& attachmentInfo : aAttachmentInfo)
                 {
                     std::string const& attachmentName = std::get<0>(attachmentInfo);
-                    std::string const& renderJobName = std::get<1>(attachmentInfo);
                     std::string const& parentRenderJobName = std::get<2>(attachmentInfo);
                     std::string const& type = std::get<3>(attachmentInfo);
+                    if(std::get<1>(attachmentInfo) != renderJobName)
+                    {
+                        continue;
+                    }
 
                     if(type == "buffer")
                     {
@@ -996,15 +1765,11 @@ namespace Render
                     }
                 }
             }
-        }
 
-        iIndex = 0;
-        for(auto const& renderJobName : aRenderJobNames)
-        {
             createInfo.mName = renderJobName;
             createInfo.mJobType = maRenderJobs[renderJobName]->mType;
             createInfo.mPassType = maRenderJobs[renderJobName]->mPassType;
-            createInfo.mPipelineFilePath = aShaderModuleFilePath[iIndex];
+            createInfo.mpJobDescription = apJobDescriptions[iIndex];
 
             if(createInfo.mJobType != Render::JobType::Copy)
             {
@@ -1013,7 +1778,57 @@ namespace Render
 
             ++iIndex;
         }
+        mShaderPreprocessor.print();
+        mPipelineCache.print();
+        DEBUG_PRINTF("render jobs created %.2f ms after setup, %d pipelines compiling\n",
+            float(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - mSetupStartTime).count()) * 0.001f,
+            mPipelineCache.getNumPendingPipelines());
+
+        // the frame goes through these instead of looking up names
+        mapOrderedRenderJobs.clear();
+        for(auto const& renderJobName : maOrderedRenderJobs)
+        {
+            mapOrderedRenderJobs.push_back(maRenderJobs[renderJobName].get());
+        }
+
+        // the app's handles see the jobs created this time, the jobs that are gone are null
+        for(uint32_t iJob = 0; iJob < maJobs.size(); iJob++)
+        {
+            maJobs.get(iJob) = nullptr;
+        }
+        for(auto const& renderJob : maRenderJobs)
+        {
+            maJobs[renderJob.first] = renderJob.second.get();
+        }
+        resolveCullingJobs();
+
+        // a job waiting on its pipeline holds back the jobs reading its outputs in the same frame, reads of the
+        // previous frame see a cleared resource like on the first frame
+        if(bCompiled)
+        {
+            for(uint32_t iJob : renderGraph.getSchedule())
+            {
+                Render::CRenderGraph::Job const& job = renderGraph.getJobs()[iJob];
+                auto iter = maRenderJobs.find(job.mName);
+                if(iter == maRenderJobs.end())
+                {
+                    continue;
+                }
 
+                Render::CRenderJob* pRenderJob = iter->second.get();
+                pRenderJob->mapReadJobs.clear();
+                for(auto const& input : job.maInputs)
+                {
+                    auto readIter = maRenderJobs.find(renderGraph.getJobs()[input.miJob].mName);
+                    if(input.mType == Render::CRenderGraph::DependencyType::Read &&
+                        readIter != maRenderJobs.end() &&
+                        std::find(pRenderJob->mapReadJobs.begin(), pRenderJob->mapReadJobs.end(), readIter->second.get()) == pRenderJob->mapReadJobs.end())
+                    {
+                        pRenderJob->mapReadJobs.push_back(readIter->second.get());
+                    }
+                }
+            }
+        }
     }
 
     /*
@@ -1059,7 +1874,7 @@ namespace Render
         //wgpu::Texture& swapChainTexture = maRenderJobs["Bilateral Filter Cloud Graphics"]->mOutputImageAttachments["Bilateral Filtered Cloud Output"];
 
         //wgpu::Texture& swapChainTexture = maRenderJobs["Variance Bilateral Filter Indirect Lighting Graphics"]->mOutputImageAttachments["Filtered Indirect Diffuse Output"];
-        wgpu::Texture& swapChainTexture = maRenderJobs["TAA Graphics"]->mOutputImageAttachments["TAA Output"];
+        wgpu::Texture& swapChainTexture = maRenderJobs[mOutputJobName]->mOutputImageAttachments[mOutputAttachmentName];
         //wgpu::Texture& swapChainTexture = maRenderJobs["Final Composite Graphics"]->mOutputImageAttachments["Composited Output"];
 
         return swapChainTexture;
@@ -1106,8 +1921,8 @@ namespace Render
     {
         bool bRet = true;
 
-        //assert(maBuffers.find(bufferName) != maBuffers.end());
-        if(maBuffers.find(bufferName) == maBuffers.end())
+        //assert(maBuffers.contains(bufferName));
+        if(!maBuffers.contains(bufferName))
         {
             DEBUG_PRINTF("!!! can\'t find buffer \"%s\"\n",
                 bufferName.c_str()
@@ -1150,15 +1965,17 @@ namespace Render
     /*
     **
     */
-    void CRenderer::createTextureAtlas()
+    void CRenderer::createTextureAtlas(
+        wgpu::TextureFormat format,
+        uint32_t iMipLevelCount)
     {
         // diffuse texture atlas
-        wgpu::TextureFormat aViewFormats[] = {wgpu::TextureFormat::RGBA8Unorm};
+        wgpu::TextureFormat aViewFormats[] = {format};
         wgpu::TextureDescriptor textureDesc = {};
         textureDesc.usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding;
         textureDesc.dimension = wgpu::TextureDimension::e2D;
-        textureDesc.format = wgpu::TextureFormat::RGBA8Unorm;
-        textureDesc.mipLevelCount = 1;
+        textureDesc.format = format;
+        textureDesc.mipLevelCount = iMipLevelCount;
         textureDesc.sampleCount = 1;
         textureDesc.size.depthOrArrayLayers = 1;
         textureDesc.size.width = miAtlasImageWidth;
@@ -1168,6 +1985,8 @@ namespace Render
 
         maTextures["totalDiffuseTextures"] = mpDevice->CreateTexture(&textureDesc);
         mDiffuseTextureAtlas = maTextures["totalDiffuseTextures"];
+        mDiffuseTextureAtlasFormat = format;
+        miDiffuseTextureAtlasMipLevels = iMipLevelCount;
 
         wgpu::TextureViewDescriptor viewDesc = {};
         viewDesc.arrayLayerCount = 1;
@@ -1175,14 +1994,20 @@ namespace Render
         viewDesc.baseArrayLayer = 0;
         viewDesc.baseMipLevel = 0;
         viewDesc.dimension = wgpu::TextureViewDimension::e2D;
-        viewDesc.format = wgpu::TextureFormat::RGBA8Unorm;
+        viewDesc.format = format;
         viewDesc.label = "Diffuse Texture Atlas";
-        viewDesc.mipLevelCount = 1;
+        viewDesc.mipLevelCount = iMipLevelCount;
 #if !defined(__EMSCRIPTEN__)
         viewDesc.usage = wgpu::TextureUsage::CopyDst | wgpu::TextureUsage::TextureBinding;
 #endif // __EMSCRIPTEN__
         mDiffuseTextureAtlasView = mDiffuseTextureAtlas.CreateView(&viewDesc);
 
+        // info buffer survives re-creating the atlas with another format or mip count
+        if(maBuffers.contains("diffuseTextureAtlasInfoBuffer"))
+        {
+            return;
+        }
+
         wgpu::BufferDescriptor bufferDesc = {};
         bufferDesc.mappedAtCreation = false;
         bufferDesc.usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage;
@@ -1195,6 +2020,39 @@ namespace Render
         maBuffers["diffuseTextureAtlasInfoBuffer"].SetLabel("Diffuse Texture Atlas Info Buffer");
     }
 
+    /*
+    ** 2x2 box filter of an RGBA8 image, odd edges are clamped
+    */
+    static void downsampleImage(
+        std::vector<uint8_t>& acDest,
+        uint8_t const* pacSrc,
+        int32_t iSrcWidth,
+        int32_t iSrcHeight)
+    {
+        int32_t iDestWidth = (iSrcWidth > 1) ? iSrcWidth >> 1 : 1;
+        int32_t iDestHeight = (iSrcHeight > 1) ? iSrcHeight >> 1 : 1;
+        acDest.resize((size_t)iDestWidth * (size_t)iDestHeight * 4);
+        for(int32_t iY = 0; iY < iDestHeight; iY++)
+        {
+            int32_t iSrcY0 = (iY * 2 < iSrcHeight) ? iY * 2 : iSrcHeight - 1;
+            int32_t iSrcY1 = (iY * 2 + 1 < iSrcHeight) ? iY * 2 + 1 : iSrcHeight - 1;
+            for(int32_t iX = 0; iX < iDestWidth; iX++)
+            {
+                int32_t iSrcX0 = (iX * 2 < iSrcWidth) ? iX * 2 : iSrcWidth - 1;
+                int32_t iSrcX1 = (iX * 2 + 1 < iSrcWidth) ? iX * 2 + 1 : iSrcWidth - 1;
+                for(int32_t iComp = 0; iComp < 4; iComp++)
+                {
+                    uint32_t iSum =
+                        (uint32_t)pacSrc[((size_t)iSrcY0 * iSrcWidth + iSrcX0) * 4 + iComp] +
+                        (uint32_t)pacSrc[((size_t)iSrcY0 * iSrcWidth + iSrcX1) * 4 + iComp] +
+                        (uint32_t)pacSrc[((size_t)iSrcY1 * iSrcWidth + iSrcX0) * 4 + iComp] +
+                        (uint32_t)pacSrc[((size_t)iSrcY1 * iSrcWidth + iSrcX1) * 4 + iComp];
+                    acDest[((size_t)iY * iDestWidth + iX) * 4 + iComp] = (uint8_t)((iSum + 2) / 4);
+                }
+            }
+        }
+    }
+
     /*
     **
     */
@@ -1207,6 +2065,42 @@ namespace Render
             createTextureAtlas();
         }
 
+        // already packed and uploaded by loadCookedTextureAtlas
+        auto cookedSectionIter = maCookedTextureAtlasSections.find(meshFilePath);
+        if(cookedSectionIter != maCookedTextureAtlasSections.end())
+        {
+            maTextureAtlasInfo.insert(
+                maTextureAtlasInfo.end(),
+                cookedSectionIter->second.begin(),
+                cookedSectionIter->second.end());
+
+            mpDevice->GetQueue().WriteBuffer(
+                maBuffers["diffuseTextureAtlasInfoBuffer"],
+                0,
+                maTextureAtlasInfo.data(),
+                sizeof(TextureAtlasInfo) * (uint32_t)maTextureAtlasInfo.size()
+            );
+
+            DEBUG_PRINTF("\"%s\" %d textures from cooked atlas\n",
+                meshFilePath.c_str(),
+                (uint32_t)cookedSectionIter->second.size());
+
+            return;
+        }
+
+        // runtime packing writes RGBA8 texels, can't go into a block compressed atlas. setup only keeps the compressed
+        // atlas when it has every list of CreateDescriptor::maTextureListNames
+        if(mDiffuseTextureAtlasFormat != wgpu::TextureFormat::RGBA8Unorm)
+        {
+            DEBUG_PRINTF("!!! \"%s\" is not in the compressed cooked atlas and not in the create descriptor\'s texture lists, its textures are missing !!!\n",
+                meshFilePath.c_str());
+            assert(!"texture list missing from the compressed cooked atlas");
+            return;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        uint64_t iNumLoadedTexels = 0;
+
         std::vector<std::string> aDiffuseTextureNames;
         std::vector<std::string> aEmissiveTextureNames;
         std::vector<std::string> aSpecularTextureNames;
@@ -1292,14 +2186,48 @@ namespace Render
                 Loader::loadFileFree(acTextureNames);
 
                 int32_t iAtlasIndex = 0;
-                int32_t iX = 0, iY = 0;
-                int32_t iLargestHeight = 0;
+                int32_t iAlignment = 1 << (miDiffuseTextureAtlasMipLevels - 1);
+                int32_t iX = ((miAtlasShelfX + iAlignment - 1) / iAlignment) * iAlignment;
+                int32_t iY = ((miAtlasShelfY + iAlignment - 1) / iAlignment) * iAlignment;
+                int32_t iLargestHeight = miAtlasShelfHeight;
+
+                auto writeToAtlas = [&](
+                    void const* pData,
+                    int32_t iX,
+                    int32_t iY,
+                    int32_t iWidth,
+                    int32_t iHeight,
+                    uint32_t iMipLevel)
+                    {
+#if defined(__EMSCRIPTEN__)
+                        wgpu::TextureDataLayout layout = {};
+#else
+                        wgpu::TexelCopyBufferLayout layout = {};
+#endif // __EMSCRIPTEN__
+                        layout.bytesPerRow = iWidth * 4 * sizeof(char);
+                        layout.offset = 0;
+                        layout.rowsPerImage = iHeight;
+                        wgpu::Extent3D extent = {};
+                        extent.depthOrArrayLayers = 1;
+                        extent.width = iWidth;
+                        extent.height = iHeight;
 
-                if(maTextureAtlasInfo.size() > 0)
-                {
-                    iX = maTextureAtlasInfo[maTextureAtlasInfo.size() - 1].miTextureCoord.x + maTextureAtlasInfo[maTextureAtlasInfo.size() - 1].miImageWidth;
-                    iY = maTextureAtlasInfo[maTextureAtlasInfo.size() - 1].miTextureCoord.y;
-                }
+#if defined(__EMSCRIPTEN__)
+                        wgpu::ImageCopyTexture destination = {};
+#else 
+                        wgpu::TexelCopyTextureInfo destination = {};
+#endif // __EMSCRIPTEN__
+                        destination.aspect = wgpu::TextureAspect::All;
+                        destination.mipLevel = iMipLevel;
+                        destination.origin = {.x = (uint32_t)iX, .y = (uint32_t)iY, .z = 0};
+                        destination.texture = mDiffuseTextureAtlas;
+                        mpDevice->GetQueue().WriteTexture(
+                            &destination,
+                            pData,
+                            iWidth * iHeight * 4,
+                            &layout,
+                            &extent);
+                    };
 
                 auto copyToAtlas = [&](
                     int32_t& iX,
@@ -1307,7 +2235,6 @@ namespace Render
                     int32_t iAtlasImageWidth,
                     int32_t iAtlasImageHeight,
                     std::string const& textureName,
-                    wgpu::Texture& textureAtlas,
                     int32_t& iLargestHeight)
                     {
                         std::string parsedTextureName = dir + "/" + textureName;
@@ -1327,46 +2254,42 @@ namespace Render
 
                         if(pImageData)
                         {
+                            // keep every mip level of the image on whole texels of that level
+                            int32_t iPackedWidth = ((iImageWidth + iAlignment - 1) / iAlignment) * iAlignment;
+                            int32_t iPackedHeight = ((iImageHeight + iAlignment - 1) / iAlignment) * iAlignment;
 #if defined(__EMSCRIPTEN__)
-                            iLargestHeight = std::max(iLargestHeight, iImageHeight);
+                            iLargestHeight = std::max(iLargestHeight, iPackedHeight);
 #else
-                            iLargestHeight = max(iLargestHeight, iImageHeight);
+                            iLargestHeight = max(iLargestHeight, iPackedHeight);
 #endif // __EMSCRIPTEN__
-                            if(iX + iImageWidth >= iAtlasImageWidth)
+                            if(iX + iPackedWidth >= iAtlasImageWidth)
                             {
                                 iX = 0;
                                 iY += iLargestHeight;
                                 iLargestHeight = 0;
                             }
 
+                            writeToAtlas(pImageData, iX, iY, iImageWidth, iImageHeight, 0);
+
+                            // box filtered mips for the levels the cooked atlas brought in
+                            std::vector<uint8_t> acSrcMip, acDestMip;
+                            uint8_t const* pacSrcMip = pImageData;
+                            int32_t iMipWidth = iImageWidth, iMipHeight = iImageHeight;
+                            for(uint32_t iLevel = 1; iLevel < miDiffuseTextureAtlasMipLevels; iLevel++)
+                            {
+                                downsampleImage(acDestMip, pacSrcMip, iMipWidth, iMipHeight);
 #if defined(__EMSCRIPTEN__)
-                            wgpu::TextureDataLayout layout = {};
+                                iMipWidth = std::max(iMipWidth >> 1, 1);
+                                iMipHeight = std::max(iMipHeight >> 1, 1);
 #else
-                            wgpu::TexelCopyBufferLayout layout = {};
+                                iMipWidth = max(iMipWidth >> 1, 1);
+                                iMipHeight = max(iMipHeight >> 1, 1);
 #endif // __EMSCRIPTEN__
-                            layout.bytesPerRow = iImageWidth * 4 * sizeof(char);
-                            layout.offset = 0;
-                            layout.rowsPerImage = iImageHeight;
-                            wgpu::Extent3D extent = {};
-                            extent.depthOrArrayLayers = 1;
-                            extent.width = iImageWidth;
-                            extent.height = iImageHeight;
+                                writeToAtlas(acDestMip.data(), iX >> iLevel, iY >> iLevel, iMipWidth, iMipHeight, iLevel);
 
-#if defined(__EMSCRIPTEN__)
-                            wgpu::ImageCopyTexture destination = {};
-#else 
-                            wgpu::TexelCopyTextureInfo destination = {};
-#endif // __EMSCRIPTEN__
-                            destination.aspect = wgpu::TextureAspect::All;
-                            destination.mipLevel = 0;
-                            destination.origin = {.x = (uint32_t)iX, .y = (uint32_t)iY, .z = 0};
-                            destination.texture = textureAtlas;
-                            mpDevice->GetQueue().WriteTexture(
-                                &destination,
-                                pImageData,
-                                iImageWidth * iImageHeight * 4,
-                                &layout,
-                                &extent);
+                                acSrcMip.swap(acDestMip);
+                                pacSrcMip = acSrcMip.data();
+                            }
 
                             TextureAtlasInfo info = {};
                             info.miTextureCoord = uint2(iX, iY);
@@ -1376,7 +2299,8 @@ namespace Render
                             info.miImageHeight = iImageHeight;
                             maTextureAtlasInfo.push_back(info);
 
-                            iX += iImageWidth;
+                            iX += iPackedWidth;
+                            iNumLoadedTexels += (uint64_t)iImageWidth * (uint64_t)iImageHeight;
 
                             stbi_image_free(pImageData);
 
@@ -1393,11 +2317,14 @@ namespace Render
 
                 for(auto const& diffuseTextureName : aDiffuseTextureNames)
                 {
-                    copyToAtlas(iX, iY, miAtlasImageWidth, miAtlasImageHeight, diffuseTextureName, mDiffuseTextureAtlas, iLargestHeight);
+                    copyToAtlas(iX, iY, miAtlasImageWidth, miAtlasImageHeight, diffuseTextureName, iLargestHeight);
 
                     ++iAtlasIndex;
                 }
 
+                miAtlasShelfX = iX;
+                miAtlasShelfY = iY;
+                miAtlasShelfHeight = iLargestHeight;
             }
 
         }   // textures
@@ -1408,6 +2335,153 @@ namespace Render
             maTextureAtlasInfo.data(),
             sizeof(TextureAtlasInfo)* (uint32_t)maTextureAtlasInfo.size()
         );
+
+        // occupancy of the shelf packed rows so far, compare with the cooked atlas from tools/texture_atlas_baker
+        auto endTime = std::chrono::high_resolution_clock::now();
+        uint64_t iShelfArea = (uint64_t)miAtlasImageWidth * (uint64_t)(miAtlasShelfY + miAtlasShelfHeight);
+        DEBUG_PRINTF("\"%s\" decoded and packed %.2f MB of textures in %.2f ms, atlas rows used: %d occupancy: %.2f%%\n",
+            meshFilePath.c_str(),
+            float(double(iNumLoadedTexels * 4) / (1024.0 * 1024.0)),
+            float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001f,
+            miAtlasShelfY + miAtlasShelfHeight,
+            (iShelfArea > 0) ? float(double(iNumLoadedTexels) / double(iShelfArea)) * 100.0f : 0.0f);
+    }
+
+    /*
+    **
+    */
+    bool CRenderer::loadCookedTextureAtlas(
+        std::string const& filePath)
+    {
+        static_assert(sizeof(TextureAtlasInfo) == sizeof(TextureAtlasFileEntry));
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        if(maTextures.find("totalDiffuseTextures") == maTextures.end())
+        {
+            createTextureAtlas();
+        }
+
+        char* acFileContent = nullptr;
+        uint32_t iFileSize = Loader::loadFile(&acFileContent, filePath);
+        if(iFileSize < sizeof(TextureAtlasFileHeader))
+        {
+            DEBUG_PRINTF("!!! can\'t load cooked texture atlas \"%s\" !!!\n", filePath.c_str());
+            Loader::loadFileFree(acFileContent);
+            return false;
+        }
+
+        TextureAtlasFileHeader const* pHeader = (TextureAtlasFileHeader const*)acFileContent;
+        bool bValid = (
+            pHeader->miSignature == TEXTURE_ATLAS_FILE_SIGNATURE &&
+            pHeader->miVersion == TEXTURE_ATLAS_FILE_VERSION &&
+            pHeader->miAtlasWidth == (uint32_t)miAtlasImageWidth &&
+            pHeader->miUsedHeight <= (uint32_t)miAtlasImageHeight &&
+            (pHeader->miFormat == TEXTURE_ATLAS_FORMAT_RGBA8 || pHeader->miFormat == TEXTURE_ATLAS_FORMAT_BC7) &&
+            pHeader->miNumMipLevels >= 1 &&
+            pHeader->miNumMipLevels <= TEXTURE_ATLAS_MAX_MIP_LEVELS
+        );
+        for(uint32_t iLevel = 0; bValid && iLevel < pHeader->miNumMipLevels; iLevel++)
+        {
+            bValid = (pHeader->maMipLevels[iLevel].miDataOffset + pHeader->maMipLevels[iLevel].miDataSize <= (uint64_t)iFileSize);
+        }
+        if(!bValid)
+        {
+            DEBUG_PRINTF("!!! \"%s\" is not a cooked %d x %d texture atlas !!!\n",
+                filePath.c_str(),
+                miAtlasImageWidth,
+                miAtlasImageHeight);
+            Loader::loadFileFree(acFileContent);
+            return false;
+        }
+
+        // section and entry tables
+        TextureAtlasFileSection const* pSections = (TextureAtlasFileSection const*)(pHeader + 1);
+        TextureAtlasFileEntry const* pEntries = (TextureAtlasFileEntry const*)(pSections + pHeader->miNumSections);
+        for(uint32_t iSection = 0; iSection < pHeader->miNumSections; iSection++)
+        {
+            TextureAtlasFileSection const& section = pSections[iSection];
+            std::vector<TextureAtlasInfo>& aSectionInfo = maCookedTextureAtlasSections[std::string(section.macName)];
+            aSectionInfo.resize(section.miNumEntries);
+            memcpy(
+                aSectionInfo.data(),
+                pEntries + section.miStartEntry,
+                sizeof(TextureAtlasInfo) * section.miNumEntries);
+        }
+
+        // match the atlas texture to the cooked format and mip chain, render jobs pick it up in createRenderJobs
+        bool bBC7 = (pHeader->miFormat == TEXTURE_ATLAS_FORMAT_BC7);
+        wgpu::TextureFormat format = bBC7 ? wgpu::TextureFormat::BC7RGBAUnorm : wgpu::TextureFormat::RGBA8Unorm;
+        if(format != mDiffuseTextureAtlasFormat || pHeader->miNumMipLevels != miDiffuseTextureAtlasMipLevels)
+        {
+            createTextureAtlas(format, pHeader->miNumMipLevels);
+        }
+
+        // all the packed rows of each mip level in one upload
+        uint32_t iBlockSize = bBC7 ? 4 : 1;
+        uint32_t iBytesPerBlock = bBC7 ? 16 : 4;
+        for(uint32_t iLevel = 0; iLevel < pHeader->miNumMipLevels; iLevel++)
+        {
+            TextureAtlasFileMipLevel const& mipLevel = pHeader->maMipLevels[iLevel];
+            if(mipLevel.miHeight == 0 || mipLevel.miDataSize == 0)
+            {
+                continue;
+            }
+
+#if defined(__EMSCRIPTEN__)
+            wgpu::TextureDataLayout layout = {};
+#else
+            wgpu::TexelCopyBufferLayout layout = {};
+#endif // __EMSCRIPTEN__
+            layout.bytesPerRow = (mipLevel.miWidth / iBlockSize) * iBytesPerBlock;
+            layout.offset = 0;
+            layout.rowsPerImage = mipLevel.miHeight / iBlockSize;
+            wgpu::Extent3D extent = {};
+            extent.depthOrArrayLayers = 1;
+            extent.width = mipLevel.miWidth;
+            extent.height = mipLevel.miHeight;
+
+#if defined(__EMSCRIPTEN__)
+            wgpu::ImageCopyTexture destination = {};
+#else 
+            wgpu::TexelCopyTextureInfo destination = {};
+#endif // __EMSCRIPTEN__
+            destination.aspect = wgpu::TextureAspect::All;
+            destination.mipLevel = iLevel;
+            destination.origin = {.x = 0, .y = 0, .z = 0};
+            destination.texture = mDiffuseTextureAtlas;
+            mpDevice->GetQueue().WriteTexture(
+                &destination,
+                acFileContent + mipLevel.miDataOffset,
+                (size_t)mipLevel.miDataSize,
+                &layout,
+                &extent);
+        }
+
+        // textures not in the cooked atlas get shelf packed below it
+        miAtlasShelfX = 0;
+        miAtlasShelfY = (int32_t)pHeader->miUsedHeight;
+        miAtlasShelfHeight = 0;
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        DEBUG_PRINTF("loaded cooked %s texture atlas \"%s\" (%.2f MB, %d mip levels, %d sections, %d textures) in %.2f ms, rows used: %d occupancy: %.2f%%\n",
+            bBC7 ? "BC7" : "RGBA8",
+            filePath.c_str(),
+            float(double(iFileSize) / (1024.0 * 1024.0)),
+            pHeader->miNumMipLevels,
+            pHeader->miNumSections,
+            pHeader->miNumEntries,
+            float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001f,
+            pHeader->miUsedHeight,
+            (pHeader->miUsedHeight > 0) ? float(double(pHeader->miNumUsedTexels) / (double(pHeader->miAtlasWidth) * double(pHeader->miUsedHeight))) * 100.0f : 0.0f);
+
+        Loader::loadFileFree(acFileContent);
+
+#if defined(__EMSCRIPTEN__)
+        free(acFileContent);
+#endif // __EMSCRIPTEN__
+
+        return true;
     }
 
 }   // Render
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <render/render_job.h>
+#include <render/transient_allocator.h>
+#include <render/pipeline_cache.h>
+#include <render/shader_preprocessor.h>
+#include <render/record_scheduler.h>
+#include <render/resource_registry.h>
+#include <render/upload_ring.h>
 #include <webgpu/webgpu_cpp.h>
 #include <string>
 #include <map>
+#include <chrono>
 
 #include <math/mat4.h>
 
@@ -20,8 +27,14 @@ namespace Render
             uint32_t miScreenHeight;
             std::string mMeshFilePath;
             std::string mRenderJobPipelineFilePath;
+            std::string mCompiledRenderJobsFilePath;        // tools/render_graph_compiler --cache, the json if empty
+            std::string mCookedTextureAtlasFilePath;
+            std::string mCookedCompressedTextureAtlasFilePath;
+            std::vector<std::string> maTextureListNames;       // given to loadTexturesIntoAtlas, the compressed atlas has to have all of them
             wgpu::Sampler* mpSampler;
 
+            // jobs compile their pipelines in the background and are skipped until they're ready
+            bool mbAsyncPipelines = true;
         };
 
         struct DrawUpdateDescriptor
@@ -31,6 +44,11 @@ namespace Render
             float4x4 const* mpViewProjectionMatrix;
             float4x4 const* mpPrevViewProjectionMatrix;
 
+            // with the jitter of the frame, the view projection matrices when not set
+            float4x4 const* mpJitteredViewProjectionMatrix = nullptr;
+            float4x4 const* mpPrevJitteredViewProjectionMatrix = nullptr;
+            float2 mJitter = float2(0.0f, 0.0f);
+
             float3 const* mpCameraPosition;
             float3 const* mpCameraLookAt;
         };
@@ -55,6 +73,30 @@ namespace Render
             uint32_t            miPadding0;
         };
 
+        // how CRenderer::draw records the frame
+        enum class RecordingMode
+        {
+            SingleEncoder,          // uploads, jobs and read backs in one encoder and one command buffer
+            EncoderPerJob,          // an encoder and a command buffer per job
+            ParallelChunks,         // an encoder per chunk of jobs recorded on the scheduler's threads
+        };
+
+        typedef Render::CResourceRegistry<wgpu::Buffer>::Handle BufferHandle;
+        static constexpr BufferHandle kInvalidBufferHandle = Render::CResourceRegistry<wgpu::Buffer>::kInvalidHandle;
+
+        typedef Render::CResourceRegistry<Render::CRenderJob*>::Handle JobHandle;
+        static constexpr JobHandle kInvalidJobHandle = Render::CResourceRegistry<Render::CRenderJob*>::kInvalidHandle;
+
+        struct RecordStats
+        {
+            uint32_t            miNumEncoders = 0;
+            uint32_t            miNumPasses = 0;            // render and compute passes
+            uint32_t            miNumCommandBuffers = 0;
+            uint32_t            miNumSubmits = 0;
+            uint64_t            miCPUMicroseconds = 0;      // draw() up to the submit
+            uint32_t            miNumTriangles = 0;         // direct draws, the indirect ones are only known on the gpu
+        };
+
     public:
         CRenderer() = default;
         virtual ~CRenderer() = default;
@@ -83,6 +125,9 @@ namespace Render
             std::string const& meshFilePath, 
             std::string const& dir);
 
+        bool loadCookedTextureAtlas(
+            std::string const& filePath);
+
         inline void setExplosionMultiplier(float fMult)
         {
             mfExplosionMult = fMult;
@@ -115,9 +160,18 @@ namespace Render
             mCameraLookAt = cameraLookAt;
         }
 
-        inline void registerBuffer(std::string const& name, wgpu::Buffer& buffer)
+        // upper bound of the cluster culling draws, 0 leaves the static meshes to the whole mesh draws
+        inline void setMaxClusterDrawCalls(uint32_t iMaxDrawCalls)
+        {
+            miMaxClusterDrawCalls = iMaxDrawCalls;
+        }
+
+        // the handle stays the same when a buffer is registered again under the name
+        inline BufferHandle registerBuffer(std::string const& name, wgpu::Buffer& buffer)
         {
-            maBuffers[name] = buffer;
+            BufferHandle handle = maBuffers.add(name);
+            maBuffers.get(handle) = buffer;
+            return handle;
         }
 
         inline void registerTexture(std::string const& name, wgpu::Texture& texture)
@@ -130,6 +184,16 @@ namespace Render
             return maBuffers[name];
         }
 
+        inline wgpu::Buffer& getBuffer(BufferHandle handle)
+        {
+            return maBuffers.get(handle);
+        }
+
+        inline BufferHandle getBufferHandle(std::string const& name) const
+        {
+            return maBuffers.getHandle(name);
+        }
+
         inline void setGetVertexBufferNames(void(*pfn)(std::vector<std::string>&))
         {
             mpfnGetVertexBufferNames = pfn;
@@ -177,6 +241,52 @@ namespace Render
 
         inline std::vector<TextureAtlasInfo>& getTextureAtlasInfo() { return maTextureAtlasInfo; }
 
+        // per frame buffer update, packed into the upload ring and copied at the start of the next draw's submit
+        void queueBufferUpload(
+            wgpu::Buffer const& buffer,
+            uint64_t iOffset,
+            void const* pData,
+            uint64_t iSize);
+
+        inline CUploadRing::FrameStats const& getUploadStats() { return mLastUploadStats; }
+
+        inline void setRecordingMode(RecordingMode mode) { mRecordingMode = mode; }
+        inline RecordStats const& getRecordStats() { return mLastRecordStats; }
+
+        // static meshes the app moves every frame, like the ball and the bat. "Draw Static Meshes" jobs leave them out
+        // and "Draw Dynamic Meshes" jobs only draw them
+        void setDynamicMeshes(std::vector<uint32_t> const& aiMeshes);
+
+        // the app resolves the names of the jobs it updates every frame once. the handle stays the same when the jobs
+        // are created again, the functions below do nothing through the handle of a job that isn't in the job list
+        inline JobHandle getJobHandle(std::string const& jobName)
+        {
+            return maJobs.add(jobName);
+        }
+
+        // meshes of the job's set it draws, like the ones in a light view cascade, for "Draw Static Meshes" and
+        // "Draw Dynamic Meshes" jobs
+        void setJobMeshes(JobHandle job, std::vector<uint32_t> const& aiMeshes);
+
+        // a job with "Frames" runs for that many frames again, like a cached layer whose view moved
+        void invalidateJob(JobHandle job);
+
+        // of the job's direct draws the last frame
+        uint32_t getNumTriangles(JobHandle job);
+
+        // of the job's output textures, 0 for a job that isn't in the job list
+        uint2 getOutputSize(JobHandle job);
+
+        // render size over the screen size of the "Dynamic Resolution" jobs from the next frame on, they draw to the
+        // top left of their outputs and the output job takes them up to the screen size
+        inline void setRenderScale(float fScale) { mfRenderScale = fScale; }
+        inline float getRenderScale() { return mfRenderScale; }
+        uint2 getRenderSize();
+
+        // submit to done time of the last frame that came back, the gpu time of the frame when the queue had nothing
+        // else in it. 0 until the first one, the frame time doesn't go under the swap chain's interval with vsync
+        inline float getGPUMilliseconds() { return mfGPUMilliseconds; }
+
     public:
         struct MeshExtent
         {
@@ -188,7 +298,51 @@ namespace Render
 
     protected:
         void createRenderJobs(CreateDescriptor& desc);
-        void createTextureAtlas();
+        void createTextureAtlas(
+            wgpu::TextureFormat format = wgpu::TextureFormat::RGBA8Unorm,
+            uint32_t iMipLevelCount = 1);
+        void flushUploads(wgpu::CommandEncoder& commandEncoder);
+        uint32_t encodeRenderJob(
+            wgpu::CommandEncoder& commandEncoder,
+            Render::CRenderJob* pRenderJob);
+        void recordChunk(
+            uint32_t iChunk,
+            uint32_t iFirstJob,
+            uint32_t iNumJobs);
+
+        enum class CullingType
+        {
+            Mesh,
+            Cluster,
+        };
+
+        struct CullingJob
+        {
+            Render::CRenderJob*     mpRenderJob = nullptr;
+            wgpu::Buffer*           mpDrawCalls = nullptr;
+            wgpu::Buffer*           mpNumDrawCalls = nullptr;
+        };
+
+        bool isClusterCullingEnabled();
+        uint32_t getNumClusterDrawCalls(CullingJob const& cullingJob);
+        CullingJob const* getCullingJob(
+            CullingType culling,
+            Render::OcclusionPhase occlusionPhase);
+        void resolveCullingJobs();
+
+        inline Render::CRenderJob* getJob(JobHandle job)
+        {
+            return (job != kInvalidJobHandle) ? maJobs.get(job) : nullptr;
+        }
+        void resolveMeshBuffers();
+        void resolveMeshRanges();
+        void drawClusters(
+            wgpu::RenderPassEncoder& renderPassEncoder,
+            Render::CRenderJob* pRenderJob);
+        uint32_t drawMeshSet(
+            wgpu::RenderPassEncoder& renderPassEncoder,
+            Render::CRenderJob* pRenderJob,
+            bool bDynamicMeshes);
 
     protected:
         
@@ -197,13 +351,60 @@ namespace Render
         wgpu::Device* mpDevice;
 
         // TODO: move buffers output renderer
-        std::map<std::string, wgpu::Buffer>     maBuffers;
+        Render::CResourceRegistry<wgpu::Buffer> maBuffers;
         std::map<std::string, uint32_t>         maBufferSizes;
         std::map<std::string, std::unique_ptr<Render::CRenderJob>>   maRenderJobs;
         std::vector<std::string> maOrderedRenderJobs;
+        std::vector<Render::CRenderJob*>        mapOrderedRenderJobs;
+        Render::CResourceRegistry<Render::CRenderJob*>  maJobs;     // by the app's job handles, null when not created
+
+        // looked up at setup for the frame
+        BufferHandle                            miDefaultUniformBuffer = kInvalidBufferHandle;
+        BufferHandle                            miFullScreenTriangleVertexBuffer = kInvalidBufferHandle;
+        BufferHandle                            miFullScreenTriangleIndexBuffer = kInvalidBufferHandle;
+        CullingJob                              maCullingJobs[2][3];            // CullingType, OcclusionPhase
+        std::vector<BufferHandle>               maMeshVertexBuffers;
+        std::vector<BufferHandle>               maMeshIndexBuffers;
+        std::vector<BufferHandle>               maAnimMeshVertexBuffers;
+        std::vector<BufferHandle>               maAnimMeshIndexBuffers;
+        bool                                    mbMeshBuffersResolved = false;
+        std::vector<bool>                       mabDynamicMeshes;               // setDynamicMeshes, by mesh
+
+        // the app's index and vertex ranges, asked for on the main thread at the start of the frame so the recording
+        // threads only read them
+        std::vector<std::pair<uint32_t, uint32_t>>     maMeshIndexRanges;
+        std::vector<std::pair<uint32_t, uint32_t>>     maAnimMeshIndexRanges;
+        std::vector<std::pair<uint32_t, uint32_t>>     maAnimMeshVertexRanges;
+
+        // drawn to the swap chain, "Output Job" and "Output Attachment" of the job list
+        std::string                             mOutputJobName;
+        std::string                             mOutputAttachmentName;
+
+        // outputs of the jobs that share memory, one texture or buffer per slot of the allocator
+        Render::CTransientAllocator             mTransientAllocator;
+        std::vector<wgpu::Texture>              maTransientTextures;
+        std::vector<wgpu::Buffer>               maTransientBuffers;
+
+        // kept across creating the jobs again
+        Render::CPipelineCache                  mPipelineCache;
+        Render::CShaderPreprocessor             mShaderPreprocessor;
+
+        // time to the first frame and to the first frame with every job, from the start of setup()
+        std::chrono::time_point<std::chrono::high_resolution_clock>     mSetupStartTime;
+        bool                                    mbAllJobsReady = false;
 
         uint32_t                                miFrame = 0;
 
+        // of the "Dynamic Resolution" jobs, and the scale and jitter of the last frame
+        float                                   mfRenderScale = 1.0f;
+        float2                                  mPrevRenderScale = float2(1.0f, 1.0f);
+        float2                                  mPrevJitter = float2(0.0f, 0.0f);
+
+        // one frame's submitted work timed at a time
+        std::chrono::time_point<std::chrono::high_resolution_clock>     mGPUSubmitTime;
+        bool                                    mbTimingGPU = false;
+        float                                   mfGPUMilliseconds = 0.0f;
+
         struct MeshTriangleRange
         {
             uint32_t miStart;
@@ -222,6 +423,32 @@ namespace Render
         int32_t                                 miAtlasImageWidth;
         int32_t                                 miAtlasImageHeight;
 
+        // pre-packed entries from the cooked atlas, keyed by the mesh name given to loadTexturesIntoAtlas
+        std::map<std::string, std::vector<TextureAtlasInfo>>    maCookedTextureAtlasSections;
+
+        // shelf position for textures packed at runtime, starts below the cooked atlas rows
+        int32_t                                 miAtlasShelfX = 0;
+        int32_t                                 miAtlasShelfY = 0;
+        int32_t                                 miAtlasShelfHeight = 0;
+
+        // staging for the frame's queueBufferUpload calls, destinations index maUploadDestinations
+        CUploadRing                             mUploadRing;
+        std::vector<wgpu::Buffer>               maUploadDestinations;
+        wgpu::Buffer                            mUploadBuffer;
+        CUploadRing::FrameStats                 mLastUploadStats;
+
+        RecordingMode                           mRecordingMode = RecordingMode::SingleEncoder;
+        RecordStats                             mFrameRecordStats;
+        RecordStats                             mLastRecordStats;
+
+        // parallel recording, the enabled jobs of the frame as indices into maOrderedRenderJobs and the recording
+        // time of every job in microseconds
+        Render::CRecordScheduler                mRecordScheduler;
+        std::vector<uint32_t>                   maiFrameRecordJobs;
+        std::vector<uint64_t>                   maiJobRecordCosts;
+        std::vector<wgpu::CommandBuffer>        maChunkCommandBuffers;
+        std::vector<uint32_t>                   maiChunkNumPasses;
+
     protected:
         std::string                             mCaptureImageName = "";
         std::string                             mCaptureImageJobName = "";
@@ -231,6 +458,8 @@ namespace Render
         
         wgpu::Texture                           mDiffuseTextureAtlas;
         wgpu::TextureView                       mDiffuseTextureAtlasView;
+        wgpu::TextureFormat                     mDiffuseTextureAtlasFormat = wgpu::TextureFormat::RGBA8Unorm;
+        uint32_t                                miDiffuseTextureAtlasMipLevels = 1;
 
         std::map<std::string, wgpu::Texture>              maTextures;
         std::map<std::string, wgpu::TextureView>          maTextureViews;
@@ -247,6 +476,8 @@ namespace Render
 
         uint32_t*                               maiVisibilityFlags = nullptr;
 
+        uint32_t                                miMaxClusterDrawCalls = 0;
+
         float3                                  mCameraPosition;
         float3                                  mCameraLookAt;
 
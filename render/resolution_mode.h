@@ -0,0 +1,151 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+** resolution of a job, from its pipeline file
+**
+** "Resolution Scale"   scales the width and height of the job's texture outputs on top of their own ScaleWidth and
+**                      ScaleHeight, 0.5 is a quarter of the pixels
+** "Resolution Mode"    "Full" shades every pixel of the outputs. "Checkerboard" shades every other pixel, swapping
+**                      over every frame, and "Interleaved" one pixel of every "Interleave Size" square of pixels
+**                      (2 or 4), in bayer order over the frames. the pixels that aren't shaded keep what they had, the
+**                      job's outputs are loaded and kept from frame to frame, and the temporal accumulation after the
+**                      job fills them in
+**
+** the sparse modes set the RESOLUTION_MODE and RESOLUTION_INTERLEAVE override constants of the job's shader,
+** shaders/include/resolution-mode.shader has isPixelShaded. the functions below are the reference the tools check
+*/
+
+#define RESOLUTION_MODE_MIN_INTERLEAVE      2
+#define RESOLUTION_MODE_MAX_INTERLEAVE      4
+
+namespace Render
+{
+    enum class ResolutionMode : uint32_t
+    {
+        Full = 0,
+        Checkerboard,
+        Interleaved,
+    };
+
+    /*
+    ** false for a name that isn't one of the modes
+    */
+    inline bool getResolutionMode(
+        ResolutionMode& mode,
+        char const* szName)
+    {
+        static char const* saszNames[] = {"Full", "Checkerboard", "Interleaved"};
+        for(uint32_t i = 0; i < sizeof(saszNames) / sizeof(*saszNames); i++)
+        {
+            if(strcmp(szName, saszNames[i]) == 0)
+            {
+                mode = (ResolutionMode)i;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*
+    **
+    */
+    inline bool isValidInterleaveSize(uint32_t iInterleaveSize)
+    {
+        return (iInterleaveSize == 2 || iInterleaveSize == 4);
+    }
+
+    /*
+    ** of a texture output scaled by fScaleWidth and fScaleHeight, at least a pixel
+    */
+    inline void getTargetSize(
+        uint32_t* piTargetSize,
+        uint32_t iScreenWidth,
+        uint32_t iScreenHeight,
+        float fScaleWidth,
+        float fScaleHeight)
+    {
+        uint32_t iWidth = (uint32_t)((float)iScreenWidth * fScaleWidth);
+        uint32_t iHeight = (uint32_t)((float)iScreenHeight * fScaleHeight);
+        piTargetSize[0] = (iWidth > 0) ? iWidth : 1;
+        piTargetSize[1] = (iHeight > 0) ? iHeight : 1;
+    }
+
+    /*
+    ** frames until every pixel is shaded
+    */
+    inline uint32_t getResolutionModePeriod(
+        ResolutionMode mode,
+        uint32_t iInterleaveSize)
+    {
+        if(mode == ResolutionMode::Checkerboard)
+        {
+            return 2;
+        }
+        else if(mode == ResolutionMode::Interleaved)
+        {
+            return iInterleaveSize * iInterleaveSize;
+        }
+
+        return 1;
+    }
+
+    /*
+    ** order of the pixel in its square, the 2 x 2 bayer matrix
+    **      0 2
+    **      3 1
+    ** goes down to the 4 x 4 one with the 2 x 2 squares taking turns in the same order
+    */
+    inline uint32_t getBayerIndex(
+        uint32_t iX,
+        uint32_t iY,
+        uint32_t iInterleaveSize)
+    {
+        uint32_t iIndex = 0;
+        for(uint32_t iSize = 1; iSize < iInterleaveSize; iSize <<= 1)
+        {
+            iIndex = (iIndex << 2) | ((((iX ^ iY) & 1) << 1) + (iY & 1));
+            iX >>= 1;
+            iY >>= 1;
+        }
+
+        return iIndex;
+    }
+
+    /*
+    **
+    */
+    inline bool isPixelShaded(
+        uint32_t iX,
+        uint32_t iY,
+        uint32_t iFrame,
+        ResolutionMode mode,
+        uint32_t iInterleaveSize)
+    {
+        if(mode == ResolutionMode::Checkerboard)
+        {
+            return ((iX + iY + iFrame) & 1) == 0;
+        }
+        else if(mode == ResolutionMode::Interleaved)
+        {
+            uint32_t iPeriod = iInterleaveSize * iInterleaveSize;
+            return getBayerIndex(iX % iInterleaveSize, iY % iInterleaveSize, iInterleaveSize) == (iFrame % iPeriod);
+        }
+
+        return true;
+    }
+
+    /*
+    ** of the output pixels, shaded each frame
+    */
+    inline float getShadedFraction(
+        ResolutionMode mode,
+        uint32_t iInterleaveSize)
+    {
+        return 1.0f / (float)getResolutionModePeriod(mode, iInterleaveSize);
+    }
+
+}   // Render
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** named resources with dense handles. names are resolved to handles once at setup, the frame goes through the
+    ** handles without building strings or walking a tree. a resource registered again under the same name keeps its
+    ** handle, and references stay valid as resources are added
+    */
+    template<typename T>
+    class CResourceRegistry
+    {
+    public:
+        typedef uint32_t Handle;
+        static constexpr Handle kInvalidHandle = UINT32_MAX;
+
+    public:
+        // adds an empty resource for a new name like std::map::operator[]
+        inline T& operator[](std::string const& name)
+        {
+            return maResources[add(name)];
+        }
+
+        inline Handle add(std::string const& name)
+        {
+            auto iter = maHandles.find(name);
+            if(iter != maHandles.end())
+            {
+                return iter->second;
+            }
+
+            Handle handle = (Handle)maResources.size();
+            maHandles[name] = handle;
+            maNames.push_back(name);
+            maResources.emplace_back();
+
+            return handle;
+        }
+
+        inline Handle getHandle(std::string const& name) const
+        {
+            auto iter = maHandles.find(name);
+            return (iter != maHandles.end()) ? iter->second : kInvalidHandle;
+        }
+
+        inline bool contains(std::string const& name) const
+        {
+            return (maHandles.find(name) != maHandles.end());
+        }
+
+        inline T& get(Handle handle)
+        {
+            assert(handle < (Handle)maResources.size());
+            return maResources[handle];
+        }
+
+        inline std::string const& getName(Handle handle) const
+        {
+            assert(handle < (Handle)maNames.size());
+            return maNames[handle];
+        }
+
+        inline uint32_t size() const
+        {
+            return (uint32_t)maResources.size();
+        }
+
+    protected:
+        std::deque<T>                               maResources;
+        std::vector<std::string>                    maNames;
+        std::unordered_map<std::string, Handle>     maHandles;
+    };
+
+}   // Render
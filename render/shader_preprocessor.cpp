@@ -0,0 +1,649 @@
+#include <render/shader_preprocessor.h>
+
+#include <utils/LogPrint.h>
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace Render
+{
+    /*
+    ** #if expression, recursive descent from || down to the integers and names
+    */
+    struct Expression
+    {
+        char const*                                             mpCurr = nullptr;
+        std::unordered_map<std::string, std::string> const*     mpDefines = nullptr;
+        uint32_t                                                miDepth = 0;
+        bool                                                    mbError = false;
+
+        int64_t parseOr();
+        int64_t parseAnd();
+        int64_t parseEquality();
+        int64_t parseRelational();
+        int64_t parseUnary();
+        int64_t parsePrimary();
+
+        void skipSpaces()
+        {
+            while(*mpCurr == ' ' || *mpCurr == '\t')
+            {
+                ++mpCurr;
+            }
+        }
+
+        bool match(char const* szToken)
+        {
+            skipSpaces();
+            size_t iLength = strlen(szToken);
+            if(strncmp(mpCurr, szToken, iLength) == 0)
+            {
+                mpCurr += iLength;
+                return true;
+            }
+
+            return false;
+        }
+
+        std::string parseIdentifier()
+        {
+            skipSpaces();
+            char const* pStart = mpCurr;
+            while(isalnum(*mpCurr) || *mpCurr == '_')
+            {
+                ++mpCurr;
+            }
+
+            return std::string(pStart, mpCurr);
+        }
+    };
+
+    /*
+    **
+    */
+    static int64_t evaluate(
+        std::string const& expression,
+        std::unordered_map<std::string, std::string> const& aDefines,
+        uint32_t iDepth,
+        bool& bError)
+    {
+        // a define whose value names another define
+        if(iDepth > 16)
+        {
+            bError = true;
+            return 0;
+        }
+
+        Expression parser;
+        parser.mpCurr = expression.c_str();
+        parser.mpDefines = &aDefines;
+        parser.miDepth = iDepth;
+
+        int64_t iValue = parser.parseOr();
+        parser.skipSpaces();
+        bError = bError || parser.mbError || (*parser.mpCurr != '\0');
+
+        return iValue;
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parseOr()
+    {
+        int64_t iValue = parseAnd();
+        while(match("||"))
+        {
+            int64_t iRight = parseAnd();
+            iValue = (iValue != 0 || iRight != 0) ? 1 : 0;
+        }
+
+        return iValue;
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parseAnd()
+    {
+        int64_t iValue = parseEquality();
+        while(match("&&"))
+        {
+            int64_t iRight = parseEquality();
+            iValue = (iValue != 0 && iRight != 0) ? 1 : 0;
+        }
+
+        return iValue;
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parseEquality()
+    {
+        int64_t iValue = parseRelational();
+        for(;;)
+        {
+            if(match("=="))
+            {
+                iValue = (iValue == parseRelational()) ? 1 : 0;
+            }
+            else if(match("!="))
+            {
+                iValue = (iValue != parseRelational()) ? 1 : 0;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        return iValue;
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parseRelational()
+    {
+        int64_t iValue = parseUnary();
+        for(;;)
+        {
+            if(match("<="))
+            {
+                iValue = (iValue <= parseUnary()) ? 1 : 0;
+            }
+            else if(match(">="))
+            {
+                iValue = (iValue >= parseUnary()) ? 1 : 0;
+            }
+            else if(match("<"))
+            {
+                iValue = (iValue < parseUnary()) ? 1 : 0;
+            }
+            else if(match(">"))
+            {
+                iValue = (iValue > parseUnary()) ? 1 : 0;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        return iValue;
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parseUnary()
+    {
+        if(match("!"))
+        {
+            return (parseUnary() == 0) ? 1 : 0;
+        }
+        else if(match("-"))
+        {
+            return -parseUnary();
+        }
+
+        return parsePrimary();
+    }
+
+    /*
+    **
+    */
+    int64_t Expression::parsePrimary()
+    {
+        skipSpaces();
+        if(match("("))
+        {
+            int64_t iValue = parseOr();
+            if(!match(")"))
+            {
+                mbError = true;
+            }
+
+            return iValue;
+        }
+
+        if(isdigit(*mpCurr))
+        {
+            char* pEnd = nullptr;
+            int64_t iValue = strtoll(mpCurr, &pEnd, 0);
+            mpCurr = pEnd;
+            if(*mpCurr == 'u' || *mpCurr == 'i')
+            {
+                ++mpCurr;
+            }
+
+            return iValue;
+        }
+
+        std::string name = parseIdentifier();
+        if(name.empty())
+        {
+            mbError = true;
+            return 0;
+        }
+
+        if(name == "defined")
+        {
+            bool bParenthesis = match("(");
+            std::string definedName = parseIdentifier();
+            if(definedName.empty() || (bParenthesis && !match(")")))
+            {
+                mbError = true;
+            }
+
+            return (mpDefines->find(definedName) != mpDefines->end()) ? 1 : 0;
+        }
+
+        auto iter = mpDefines->find(name);
+        if(iter == mpDefines->end())
+        {
+            return 0;
+        }
+
+        return evaluate(iter->second, *mpDefines, miDepth + 1, mbError);
+    }
+
+    /*
+    ** identifiers that are defines replaced by their value
+    */
+    static void appendLine(
+        std::string& output,
+        std::string const& line,
+        std::unordered_map<std::string, std::string> const& aDefines)
+    {
+        if(aDefines.size() <= 0)
+        {
+            output += line;
+            output += '\n';
+            return;
+        }
+
+        uint32_t iNumChars = (uint32_t)line.size();
+        uint32_t iChar = 0;
+        while(iChar < iNumChars)
+        {
+            char cChar = line[iChar];
+            if(isalpha(cChar) || cChar == '_')
+            {
+                uint32_t iStart = iChar;
+                while(iChar < iNumChars && (isalnum(line[iChar]) || line[iChar] == '_'))
+                {
+                    ++iChar;
+                }
+
+                std::string identifier = line.substr(iStart, iChar - iStart);
+                auto iter = aDefines.find(identifier);
+                output += (iter != aDefines.end()) ? iter->second : identifier;
+            }
+            else if(isdigit(cChar))
+            {
+                // literals like 1e5f aren't identifiers
+                while(iChar < iNumChars && (isalnum(line[iChar]) || line[iChar] == '_' || line[iChar] == '.'))
+                {
+                    output += line[iChar];
+                    ++iChar;
+                }
+            }
+            else
+            {
+                output += cChar;
+                ++iChar;
+            }
+        }
+        output += '\n';
+    }
+
+    /*
+    **
+    */
+    void CShaderPreprocessor::setup(
+        LoadFileFunction pfnLoadFile,
+        void* pUserData)
+    {
+        mpfnLoadFile = pfnLoadFile;
+        mpUserData = pUserData;
+    }
+
+    /*
+    **
+    */
+    void CShaderPreprocessor::clear()
+    {
+        maFiles.clear();
+        maVariants.clear();
+        maErrors.clear();
+        mStats = Stats();
+    }
+
+    /*
+    **
+    */
+    std::string const* CShaderPreprocessor::preprocess(
+        std::string const& filePath,
+        Defines const& aDefines)
+    {
+        ++mStats.miNumRequested;
+
+        // same defines in any order are the same variant
+        Defines aSortedDefines = aDefines;
+        std::sort(aSortedDefines.begin(), aSortedDefines.end());
+        std::string key = filePath;
+        for(auto const& define : aSortedDefines)
+        {
+            key += '\n';
+            key += define.first;
+            key += '=';
+            key += define.second;
+        }
+
+        auto iter = maVariants.find(key);
+        if(iter != maVariants.end())
+        {
+            return &iter->second;
+        }
+
+        Context context;
+        for(auto const& define : aSortedDefines)
+        {
+            context.maDefines[define.first] = define.second;
+        }
+
+        if(!expand(context, filePath, 0))
+        {
+            return nullptr;
+        }
+
+        ++mStats.miNumPreprocessed;
+        mStats.miNumOutputBytes += context.mOutput.size();
+
+        std::string& variant = maVariants[key];
+        variant = std::move(context.mOutput);
+        return &variant;
+    }
+
+    /*
+    **
+    */
+    std::string const* CShaderPreprocessor::loadFile(std::string const& filePath)
+    {
+        auto iter = maFiles.find(filePath);
+        if(iter != maFiles.end())
+        {
+            return &iter->second;
+        }
+
+        assert(mpfnLoadFile != nullptr);
+        std::string content;
+        if(!mpfnLoadFile(content, filePath, mpUserData))
+        {
+            return nullptr;
+        }
+        ++mStats.miNumFilesLoaded;
+
+        std::string& file = maFiles[filePath];
+        file = std::move(content);
+        return &file;
+    }
+
+    /*
+    **
+    */
+    bool CShaderPreprocessor::expand(
+        Context& context,
+        std::string const& filePath,
+        uint32_t iDepth)
+    {
+        if(context.maIncluded.find(filePath) != context.maIncluded.end())
+        {
+            return true;
+        }
+        context.maIncluded.insert(filePath);
+
+        if(iDepth > 32)
+        {
+            addError(filePath, 0, "includes nested too deep");
+            return false;
+        }
+
+        std::string const* pContent = loadFile(filePath);
+        if(pContent == nullptr)
+        {
+            addError(filePath, 0, "can't load file");
+            return false;
+        }
+        mStats.miNumSourceBytes += pContent->size();
+
+        // #if nesting, lines are kept while every branch up the stack is taken
+        struct Branch
+        {
+            bool        mbActive = true;        // lines of this branch are kept
+            bool        mbTaken = false;        // a branch of this #if was kept
+            bool        mbParentActive = true;
+            bool        mbElse = false;
+        };
+        std::vector<Branch> aBranches;
+
+        std::string const& content = *pContent;
+        uint32_t iLine = 0;
+        size_t iLineStart = 0;
+        while(iLineStart < content.size())
+        {
+            size_t iLineEnd = content.find('\n', iLineStart);
+            if(iLineEnd == std::string::npos)
+            {
+                iLineEnd = content.size();
+            }
+            std::string line = content.substr(iLineStart, iLineEnd - iLineStart);
+            iLineStart = iLineEnd + 1;
+            ++iLine;
+
+            if(line.size() > 0 && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            bool bActive = (aBranches.size() <= 0 || aBranches.back().mbActive);
+
+            size_t iFirst = line.find_first_not_of(" \t");
+            if(iFirst == std::string::npos || line[iFirst] != '#')
+            {
+                if(bActive)
+                {
+                    appendLine(context.mOutput, line, context.maDefines);
+                }
+                continue;
+            }
+
+            // directive and the rest of the line
+            size_t iDirectiveEnd = line.find_first_of(" \t", iFirst);
+            std::string directive = line.substr(iFirst + 1, iDirectiveEnd - iFirst - 1);
+            std::string argument = (iDirectiveEnd != std::string::npos) ? line.substr(iDirectiveEnd) : "";
+            size_t iArgumentStart = argument.find_first_not_of(" \t");
+            argument = (iArgumentStart != std::string::npos) ? argument.substr(iArgumentStart) : "";
+            size_t iComment = argument.find("//");
+            if(iComment != std::string::npos)
+            {
+                argument = argument.substr(0, iComment);
+            }
+            size_t iArgumentEnd = argument.find_last_not_of(" \t");
+            argument = (iArgumentEnd != std::string::npos) ? argument.substr(0, iArgumentEnd + 1) : "";
+
+            if(directive == "ifdef" || directive == "ifndef" || directive == "if")
+            {
+                Branch branch;
+                branch.mbParentActive = bActive;
+                if(bActive)
+                {
+                    bool bError = false;
+                    bool bTrue = false;
+                    if(directive == "if")
+                    {
+                        bTrue = (evaluate(argument, context.maDefines, 0, bError) != 0);
+                    }
+                    else
+                    {
+                        bool bDefined = (context.maDefines.find(argument) != context.maDefines.end());
+                        bTrue = (directive == "ifdef") ? bDefined : !bDefined;
+                        bError = argument.empty();
+                    }
+
+                    if(bError)
+                    {
+                        addError(filePath, iLine, "bad #" + directive + " \"" + argument + "\"");
+                        return false;
+                    }
+
+                    branch.mbActive = bTrue;
+                    branch.mbTaken = bTrue;
+                }
+                else
+                {
+                    branch.mbActive = false;
+                    branch.mbTaken = true;
+                }
+                aBranches.push_back(branch);
+            }
+            else if(directive == "elif")
+            {
+                if(aBranches.size() <= 0 || aBranches.back().mbElse)
+                {
+                    addError(filePath, iLine, "#elif without #if");
+                    return false;
+                }
+
+                Branch& branch = aBranches.back();
+                if(branch.mbTaken || !branch.mbParentActive)
+                {
+                    branch.mbActive = false;
+                }
+                else
+                {
+                    bool bError = false;
+                    branch.mbActive = (evaluate(argument, context.maDefines, 0, bError) != 0);
+                    branch.mbTaken = branch.mbActive;
+                    if(bError)
+                    {
+                        addError(filePath, iLine, "bad #elif \"" + argument + "\"");
+                        return false;
+                    }
+                }
+            }
+            else if(directive == "else")
+            {
+                if(aBranches.size() <= 0 || aBranches.back().mbElse)
+                {
+                    addError(filePath, iLine, "#else without #if");
+                    return false;
+                }
+
+                Branch& branch = aBranches.back();
+                branch.mbActive = (branch.mbParentActive && !branch.mbTaken);
+                branch.mbTaken = true;
+                branch.mbElse = true;
+            }
+            else if(directive == "endif")
+            {
+                if(aBranches.size() <= 0)
+                {
+                    addError(filePath, iLine, "#endif without #if");
+                    return false;
+                }
+                aBranches.pop_back();
+            }
+            else if(!bActive)
+            {
+                continue;
+            }
+            else if(directive == "include")
+            {
+                if(argument.size() < 2 || argument.front() != '"' || argument.back() != '"')
+                {
+                    addError(filePath, iLine, "#include needs a \"file\"");
+                    return false;
+                }
+
+                if(!expand(context, argument.substr(1, argument.size() - 2), iDepth + 1))
+                {
+                    addError(filePath, iLine, "included from here");
+                    return false;
+                }
+            }
+            else if(directive == "define")
+            {
+                size_t iNameEnd = argument.find_first_of(" \t");
+                std::string name = argument.substr(0, iNameEnd);
+                std::string value = "1";
+                if(iNameEnd != std::string::npos)
+                {
+                    value = argument.substr(argument.find_first_not_of(" \t", iNameEnd));
+                }
+
+                if(name.empty())
+                {
+                    addError(filePath, iLine, "#define needs a name");
+                    return false;
+                }
+
+                context.maDefines[name] = value;
+            }
+            else if(directive == "undef")
+            {
+                context.maDefines.erase(argument);
+            }
+            else
+            {
+                addError(filePath, iLine, "unknown directive #" + directive);
+                return false;
+            }
+        }
+
+        if(aBranches.size() > 0)
+        {
+            addError(filePath, iLine, "#if without #endif");
+            return false;
+        }
+
+        return true;
+    }
+
+    /*
+    **
+    */
+    void CShaderPreprocessor::addError(
+        std::string const& filePath,
+        uint32_t iLine,
+        std::string const& error)
+    {
+        maErrors.push_back(filePath + "(" + std::to_string(iLine) + "): " + error);
+    }
+
+    /*
+    **
+    */
+    void CShaderPreprocessor::print() const
+    {
+        DEBUG_PRINTF("shader variants: %d requested, %d preprocessed from %d files\n",
+            mStats.miNumRequested,
+            mStats.miNumPreprocessed,
+            mStats.miNumFilesLoaded);
+        DEBUG_PRINTF("shader source: %lld bytes read, %lld bytes out\n",
+            (long long)mStats.miNumSourceBytes,
+            (long long)mStats.miNumOutputBytes);
+
+        for(auto const& error : maErrors)
+        {
+            DEBUG_PRINTF("shader error: %s\n", error.c_str());
+        }
+    }
+
+}   // Render
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** c style directives in the wgsl shaders, expanded before the shader module is created
+    **
+    ** #include "file"          from the shader directory, a file goes into a variant once however often it's included
+    ** #define NAME value       the identifier NAME is replaced by value in the lines after it, "#define NAME" is 1
+    ** #undef NAME
+    ** #ifdef, #ifndef, #if, #elif, #else, #endif
+    **                          lines of the branches not taken are dropped. #if takes integers, with or without the
+    **                          wgsl u and i suffix, names, defined(NAME), ! && || == != < <= > >= and parentheses,
+    **                          names that aren't defined are 0
+    **
+    ** a job's "Defines" are defined before the first line, "#ifndef NAME" gives a shader its own default. the expanded
+    ** variants are kept by file and defines, jobs with the same shader and defines get the same string and the
+    ** pipeline cache gives them the same module
+    **
+    ** no gpu objects, the dry run tool preprocesses every job's shader
+    */
+    class CShaderPreprocessor
+    {
+    public:
+        // shader file, filePath is relative to the shader directory
+        typedef bool (*LoadFileFunction)(std::string& content, std::string const& filePath, void* pUserData);
+
+        typedef std::vector<std::pair<std::string, std::string>> Defines;
+
+        struct Stats
+        {
+            uint32_t            miNumRequested = 0;         // jobs asking for a variant
+            uint32_t            miNumPreprocessed = 0;      // variants expanded
+            uint32_t            miNumFilesLoaded = 0;
+            uint64_t            miNumSourceBytes = 0;       // files as loaded, includes counted every time
+            uint64_t            miNumOutputBytes = 0;
+        };
+
+    public:
+        CShaderPreprocessor() = default;
+        virtual ~CShaderPreprocessor() = default;
+
+        void setup(
+            LoadFileFunction pfnLoadFile,
+            void* pUserData);
+
+        void clear();
+
+        // nullptr with getErrors() on a missing file or a bad directive, the string lives until clear()
+        std::string const* preprocess(
+            std::string const& filePath,
+            Defines const& aDefines);
+
+        void print() const;
+
+        inline Stats const& getStats() const
+        {
+            return mStats;
+        }
+
+        inline std::vector<std::string> const& getErrors() const
+        {
+            return maErrors;
+        }
+
+        inline uint32_t getNumVariants() const
+        {
+            return (uint32_t)maVariants.size();
+        }
+
+    protected:
+        // state of one variant being expanded
+        struct Context
+        {
+            std::unordered_map<std::string, std::string>        maDefines;
+            std::unordered_set<std::string>                     maIncluded;
+            std::string                                         mOutput;
+        };
+
+        std::string const* loadFile(std::string const& filePath);
+
+        bool expand(
+            Context& context,
+            std::string const& filePath,
+            uint32_t iDepth);
+
+        void addError(
+            std::string const& filePath,
+            uint32_t iLine,
+            std::string const& error);
+
+    protected:
+        LoadFileFunction                                        mpfnLoadFile = nullptr;
+        void*                                                   mpUserData = nullptr;
+
+        Stats                                                   mStats;
+        std::vector<std::string>                                maErrors;
+
+        std::unordered_map<std::string, std::string>            maFiles;
+        std::unordered_map<std::string, std::string>            maVariants;     // by file and sorted defines
+    };
+
+}   // Render
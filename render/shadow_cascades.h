@@ -0,0 +1,262 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+** orthographic light views of a directional light over slices of the camera's frustum, the matrices of
+** ShadowUniformData and the meshes the light views of the static meshes draw
+**
+** the slices split the camera's range clamped to the shadow near and far with the practical split scheme, the
+** logarithmic splits blended by mfSplitLambda with the uniform ones. a cascade is fitted to the bounding sphere of its
+** slice's corners, the sphere only depends on the split distances and the field of view so the cascade keeps its size
+** when the camera turns. its center is snapped to cells of miSnapTexels shadow map texels along the light axes and the
+** cascade is widened by a cell on either side to still hold the sphere, so the shadow map moves by whole texels and
+** only when the camera crosses a cell. the depth range reaches mfCasterDistance past the cascade towards the light for
+** the casters outside the slice
+**
+** the functions below are the reference the tools check, matrices are row major with column vectors like
+** computeFrustumPlanes in meshlet.h and the light axes are the ones makeViewMatrix builds looking down the light
+*/
+
+#define SHADOW_MAX_CASCADES                 4
+
+namespace Render
+{
+    struct ShadowCascadeDescriptor
+    {
+        float               mafLightDirection[3];   // towards the light, normalized
+        uint32_t            miNumCascades;
+        uint32_t            miShadowMapSize;        // texels a side
+        uint32_t            miSnapTexels;           // 1 snaps to texels, more keeps the cascade still for longer
+        float               mfNear;
+        float               mfFar;
+        float               mfSplitLambda;          // 0 uniform, 1 logarithmic
+        float               mfCasterDistance;
+    };
+
+    struct ShadowCascadeCamera
+    {
+        float               mafPosition[3];
+        float               mafLookDirection[3];    // normalized
+        float               mfFieldOfView;          // vertical, radians
+        float               mfAspectRatio;          // width over height
+        float               mfNear;
+        float               mfFar;
+    };
+
+    struct ShadowCascade
+    {
+        float               mfNearDistance;         // of the slice along the view direction
+        float               mfFarDistance;
+        float               mafSphere[4];           // center, radius
+        int32_t             maiSnappedCenter[3];    // in cells along the light axes
+        float               mafCenter[3];
+        float               mafLightAxes[3][3];     // right, up, towards the light
+        float               mfTexelSize;
+        float               mfSize;                 // width and height of the shadow map
+        float               mfCasterDistance;
+        float               mafViewProjection[16];
+    };
+
+    /*
+    ** iSplit 0 is fNear and iNumSplits is fFar
+    */
+    inline float getShadowCascadeSplit(
+        uint32_t iSplit,
+        uint32_t iNumSplits,
+        float fNear,
+        float fFar,
+        float fLambda)
+    {
+        if(iSplit >= iNumSplits)
+        {
+            return fFar;
+        }
+
+        float fPct = (float)iSplit / (float)iNumSplits;
+        float fLogarithmic = fNear * powf(fFar / fNear, fPct);
+        float fUniform = fNear + (fFar - fNear) * fPct;
+
+        return fLambda * fLogarithmic + (1.0f - fLambda) * fUniform;
+    }
+
+    /*
+    ** a slice between the distances dn and df has corners at (x, y, d) with |x| = d * t * a and |y| = d * t, t the
+    ** tangent of half the field of view and a the aspect ratio. the center of the smallest sphere through the near and
+    ** the far corners is on the view direction at z = (dn + df) * (1 + k) / 2 with k = t^2 * (1 + a^2), for long
+    ** slices that's past the far plane and the far plane's center is the center
+    */
+    inline void fitShadowCascades(
+        ShadowCascade* aCascades,
+        ShadowCascadeDescriptor const& desc,
+        ShadowCascadeCamera const& camera)
+    {
+        float const* pfLight = desc.mafLightDirection;
+        float fNear = (camera.mfNear > desc.mfNear) ? camera.mfNear : desc.mfNear;
+        float fFar = (camera.mfFar < desc.mfFar) ? camera.mfFar : desc.mfFar;
+        fFar = (fFar > fNear * 1.01f) ? fFar : fNear * 1.01f;
+
+        uint32_t iSnapTexels = (desc.miSnapTexels > 0) ? desc.miSnapTexels : 1;
+        uint32_t iNumCascades = (desc.miNumCascades < SHADOW_MAX_CASCADES) ? desc.miNumCascades : SHADOW_MAX_CASCADES;
+
+        // right = cross(up, -light), up = cross(-light, right)
+        float afUp[3] = {0.0f, 1.0f, 0.0f};
+        if(fabsf(pfLight[1]) >= 0.99f)
+        {
+            afUp[0] = 1.0f;
+            afUp[1] = 0.0f;
+        }
+        float afRight[3] =
+        {
+            afUp[2] * pfLight[1] - afUp[1] * pfLight[2],
+            afUp[0] * pfLight[2] - afUp[2] * pfLight[0],
+            afUp[1] * pfLight[0] - afUp[0] * pfLight[1],
+        };
+        float fRightLength = sqrtf(afRight[0] * afRight[0] + afRight[1] * afRight[1] + afRight[2] * afRight[2]);
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            afRight[i] /= fRightLength;
+        }
+        float afLightUp[3] =
+        {
+            pfLight[2] * afRight[1] - pfLight[1] * afRight[2],
+            pfLight[0] * afRight[2] - pfLight[2] * afRight[0],
+            pfLight[1] * afRight[0] - pfLight[0] * afRight[1],
+        };
+        float const* apfAxes[3] = {afRight, afLightUp, pfLight};
+
+        float fTangent = tanf(camera.mfFieldOfView * 0.5f);
+        float fK = fTangent * fTangent * (1.0f + camera.mfAspectRatio * camera.mfAspectRatio);
+        for(uint32_t iCascade = 0; iCascade < iNumCascades; iCascade++)
+        {
+            ShadowCascade& cascade = aCascades[iCascade];
+            float fNearDistance = getShadowCascadeSplit(iCascade, iNumCascades, fNear, fFar, desc.mfSplitLambda);
+            float fFarDistance = getShadowCascadeSplit(iCascade + 1, iNumCascades, fNear, fFar, desc.mfSplitLambda);
+
+            float fZ = (fNearDistance + fFarDistance) * (1.0f + fK) * 0.5f;
+            fZ = (fZ < fFarDistance) ? fZ : fFarDistance;
+            float fNearRadiusSquared = (fZ - fNearDistance) * (fZ - fNearDistance) + fNearDistance * fNearDistance * fK;
+            float fFarRadiusSquared = (fFarDistance - fZ) * (fFarDistance - fZ) + fFarDistance * fFarDistance * fK;
+            float fRadius = sqrtf((fNearRadiusSquared > fFarRadiusSquared) ? fNearRadiusSquared : fFarRadiusSquared);
+
+            // a cell of margin on either side for the snapped center
+            float fTexelSize = (fRadius * 2.0f) / (float)(desc.miShadowMapSize - iSnapTexels * 2);
+            float fCellSize = fTexelSize * (float)iSnapTexels;
+            float fSize = fTexelSize * (float)desc.miShadowMapSize;
+            float fHalfSize = fSize * 0.5f;
+
+            cascade.mfNearDistance = fNearDistance;
+            cascade.mfFarDistance = fFarDistance;
+            cascade.mfTexelSize = fTexelSize;
+            cascade.mfSize = fSize;
+            cascade.mfCasterDistance = desc.mfCasterDistance;
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                cascade.mafSphere[i] = camera.mafPosition[i] + camera.mafLookDirection[i] * fZ;
+            }
+            cascade.mafSphere[3] = fRadius;
+
+            float afEye[3] = {0.0f, 0.0f, 0.0f};
+            for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+            {
+                float const* pfAxis = apfAxes[iAxis];
+                float fDistance = cascade.mafSphere[0] * pfAxis[0] + cascade.mafSphere[1] * pfAxis[1] + cascade.mafSphere[2] * pfAxis[2];
+                cascade.maiSnappedCenter[iAxis] = (int32_t)floorf(fDistance / fCellSize + 0.5f);
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    cascade.mafLightAxes[iAxis][i] = pfAxis[i];
+                    afEye[i] += pfAxis[i] * ((float)cascade.maiSnappedCenter[iAxis] * fCellSize);
+                }
+            }
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                cascade.mafCenter[i] = afEye[i];
+                afEye[i] += pfLight[i] * fHalfSize;
+            }
+
+            // makeViewMatrix from the eye over the center down to it, then orthographicProjection over the width and
+            // from the casters in front of the eye to the far side of the cascade
+            float fDepthRange = fSize + desc.mfCasterDistance;
+            for(uint32_t iRow = 0; iRow < 3; iRow++)
+            {
+                float const* pfAxis = apfAxes[iRow];
+                float fScale = (iRow < 2) ? (1.0f / fHalfSize) : (-1.0f / fDepthRange);
+                float fEye = afEye[0] * pfAxis[0] + afEye[1] * pfAxis[1] + afEye[2] * pfAxis[2];
+                float* pfRow = cascade.mafViewProjection + iRow * 4;
+                pfRow[0] = pfAxis[0] * fScale;
+                pfRow[1] = pfAxis[1] * fScale;
+                pfRow[2] = pfAxis[2] * fScale;
+                pfRow[3] = (iRow < 2) ? (-fEye * fScale) : ((fEye + desc.mfCasterDistance) / fDepthRange);
+            }
+            float afLastRow[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                cascade.mafViewProjection[12 + i] = afLastRow[i];
+            }
+        }
+    }
+
+    /*
+    ** the world space box's extent along each light axis against the cascade's, width and height around the center
+    ** and from mfCasterDistance past the cascade towards the light down to its far side
+    */
+    inline bool isBoxInShadowCascade(
+        ShadowCascade const& cascade,
+        float const* pfMinPosition,
+        float const* pfMaxPosition)
+    {
+        float fHalfSize = cascade.mfSize * 0.5f;
+        float afExtent[3];
+        float afPosition[3];
+        for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+        {
+            float const* pfAxis = cascade.mafLightAxes[iAxis];
+            afExtent[iAxis] = 0.0f;
+            afPosition[iAxis] = 0.0f;
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                float fCenter = (pfMinPosition[i] + pfMaxPosition[i]) * 0.5f - cascade.mafCenter[i];
+                afExtent[iAxis] += fabsf((pfMaxPosition[i] - pfMinPosition[i]) * 0.5f * pfAxis[i]);
+                afPosition[iAxis] += fCenter * pfAxis[i];
+            }
+        }
+
+        return
+            fabsf(afPosition[0]) <= fHalfSize + afExtent[0] &&
+            fabsf(afPosition[1]) <= fHalfSize + afExtent[1] &&
+            afPosition[2] - afExtent[2] <= fHalfSize + cascade.mfCasterDistance &&
+            afPosition[2] + afExtent[2] >= -fHalfSize;
+    }
+
+    /*
+    ** pafExtents is the minimum then the maximum position of every mesh as float4, like the extents of
+    ** <mesh>-triangles.bin. meshes with pabSkip set are left out, paiMeshes gets the ones in the cascade
+    ** and their number is returned
+    */
+    inline uint32_t cullShadowCascade(
+        uint32_t* paiMeshes,
+        ShadowCascade const& cascade,
+        float const* pafExtents,
+        uint32_t iNumMeshes,
+        uint8_t const* pabSkip)
+    {
+        uint32_t iNumVisible = 0;
+        for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+        {
+            if(pabSkip != nullptr && pabSkip[iMesh])
+            {
+                continue;
+            }
+
+            float const* pfExtent = pafExtents + iMesh * 8;
+            if(isBoxInShadowCascade(cascade, pfExtent, pfExtent + 4))
+            {
+                paiMeshes[iNumVisible++] = iMesh;
+            }
+        }
+
+        return iNumVisible;
+    }
+
+}   // Render
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+** cooked texture atlas layout, written by tools/texture_atlas_baker and read by CRenderer::loadCookedTextureAtlas
+**
+** TextureAtlasFileHeader
+** TextureAtlasFileSection[miNumSections]
+** TextureAtlasFileEntry[miNumEntries]
+** mip levels, rows [0, miUsedHeight >> level) of each level as RGBA8 texels or BC7 blocks
+**
+** entries are padded and aligned to (block size << (mip levels - 1)) texels so every mip level of an entry
+** covers whole blocks and never shares a 2x2 footprint or a block with its neighbours
+*/
+
+#define TEXTURE_ATLAS_FILE_SIGNATURE        (('A') | ('T' << 8) | ('L' << 16) | ('S' << 24))
+#define TEXTURE_ATLAS_FILE_VERSION          2
+#define TEXTURE_ATLAS_SECTION_NAME_LENGTH   120
+#define TEXTURE_ATLAS_MAX_MIP_LEVELS        8
+
+namespace Render
+{
+    enum TextureAtlasFileFormat
+    {
+        TEXTURE_ATLAS_FORMAT_RGBA8 = 0,
+        TEXTURE_ATLAS_FORMAT_BC7,
+    };
+
+    struct TextureAtlasFileMipLevel
+    {
+        uint64_t            miDataOffset;
+        uint64_t            miDataSize;
+        uint32_t            miWidth;
+        uint32_t            miHeight;
+    };
+
+    struct TextureAtlasFileHeader
+    {
+        uint32_t            miSignature;
+        uint32_t            miVersion;
+        uint32_t            miAtlasWidth;
+        uint32_t            miAtlasHeight;
+        uint32_t            miUsedHeight;
+        uint32_t            miNumSections;
+        uint32_t            miNumEntries;
+        uint32_t            miFormat;
+        uint32_t            miNumMipLevels;
+        uint32_t            miPadding;
+        uint64_t            miNumUsedTexels;
+
+        TextureAtlasFileMipLevel    maMipLevels[TEXTURE_ATLAS_MAX_MIP_LEVELS];
+    };
+
+    // entries of one texture name list (<mesh>-texture-names.tex), in the order loadTexturesIntoAtlas appends them
+    struct TextureAtlasFileSection
+    {
+        char                macName[TEXTURE_ATLAS_SECTION_NAME_LENGTH];
+        uint32_t            miStartEntry;
+        uint32_t            miNumEntries;
+    };
+
+    // same layout as CRenderer::TextureAtlasInfo
+    struct TextureAtlasFileEntry
+    {
+        uint32_t            miX;
+        uint32_t            miY;
+        float               mfU;
+        float               mfV;
+        uint32_t            miTextureID;
+        uint32_t            miImageWidth;
+        uint32_t            miImageHeight;
+        uint32_t            miPadding0;
+    };
+
+}   // Render
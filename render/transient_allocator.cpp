@@ -0,0 +1,176 @@
+#include <render/transient_allocator.h>
+
+#include <utils/LogPrint.h>
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace Render
+{
+    /*
+    **
+    */
+    void CTransientAllocator::clear()
+    {
+        maResources.clear();
+        maSlots.clear();
+        maResourceIndices.clear();
+    }
+
+    /*
+    **
+    */
+    void CTransientAllocator::addResource(Resource const& resource)
+    {
+        assert(resource.miFirstUse <= resource.miLastUse);
+        assert(maResourceIndices.find(resource.mName) == maResourceIndices.end());
+
+        maResourceIndices[resource.mName] = (uint32_t)maResources.size();
+        maResources.push_back(resource);
+        maResources.back().miSlot = -1;
+    }
+
+    /*
+    ** a slot is free for a resource when its last user is scheduled before the resource's first write, the queue runs
+    ** the jobs in order so the next frame's early users can't overtake this frame's late ones
+    */
+    void CTransientAllocator::allocate()
+    {
+        maSlots.clear();
+
+        std::vector<uint32_t> aiSorted(maResources.size());
+        for(uint32_t i = 0; i < (uint32_t)aiSorted.size(); i++)
+        {
+            aiSorted[i] = i;
+        }
+        std::stable_sort(
+            aiSorted.begin(),
+            aiSorted.end(),
+            [&](uint32_t iLeft, uint32_t iRight)
+            {
+                return maResources[iLeft].miFirstUse < maResources[iRight].miFirstUse;
+            });
+
+        for(uint32_t iResource : aiSorted)
+        {
+            Resource& resource = maResources[iResource];
+
+            int32_t iSlot = -1;
+            if(!resource.mbPersistent)
+            {
+                for(uint32_t iCheck = 0; iCheck < (uint32_t)maSlots.size(); iCheck++)
+                {
+                    Slot const& slot = maSlots[iCheck];
+                    if(!slot.mbPersistent &&
+                        slot.mDescription == resource.mDescription &&
+                        slot.miLastUse < resource.miFirstUse)
+                    {
+                        iSlot = (int32_t)iCheck;
+                        break;
+                    }
+                }
+            }
+
+            if(iSlot < 0)
+            {
+                Slot slot;
+                slot.mDescription = resource.mDescription;
+                slot.miNumBytes = resource.miNumBytes;
+                slot.mbPersistent = resource.mbPersistent;
+                iSlot = (int32_t)maSlots.size();
+                maSlots.push_back(slot);
+            }
+
+            Slot& slot = maSlots[iSlot];
+            slot.miLastUse = resource.miLastUse;
+            ++slot.miNumResources;
+            resource.miSlot = iSlot;
+        }
+    }
+
+    /*
+    **
+    */
+    int32_t CTransientAllocator::getSlot(std::string const& name) const
+    {
+        auto iter = maResourceIndices.find(name);
+        if(iter == maResourceIndices.end())
+        {
+            return -1;
+        }
+
+        return maResources[iter->second].miSlot;
+    }
+
+    /*
+    **
+    */
+    uint64_t CTransientAllocator::getNumUnaliasedBytes() const
+    {
+        uint64_t iNumBytes = 0;
+        for(auto const& resource : maResources)
+        {
+            iNumBytes += resource.miNumBytes;
+        }
+
+        return iNumBytes;
+    }
+
+    /*
+    **
+    */
+    uint64_t CTransientAllocator::getNumAliasedBytes() const
+    {
+        uint64_t iNumBytes = 0;
+        for(auto const& slot : maSlots)
+        {
+            iNumBytes += slot.miNumBytes;
+        }
+
+        return iNumBytes;
+    }
+
+    /*
+    **
+    */
+    void CTransientAllocator::print() const
+    {
+        uint32_t iNumPersistent = (uint32_t)std::count_if(
+            maResources.begin(),
+            maResources.end(),
+            [](Resource const& resource)
+            {
+                return resource.mbPersistent;
+            });
+
+        DEBUG_PRINTF("%d outputs (%d persistent) in %d slots, %.2f MB before aliasing, %.2f MB after\n",
+            (uint32_t)maResources.size(),
+            iNumPersistent,
+            (uint32_t)maSlots.size(),
+            (double)getNumUnaliasedBytes() / (1024.0 * 1024.0),
+            (double)getNumAliasedBytes() / (1024.0 * 1024.0));
+
+        for(uint32_t iSlot = 0; iSlot < (uint32_t)maSlots.size(); iSlot++)
+        {
+            Slot const& slot = maSlots[iSlot];
+            if(slot.mbPersistent)
+            {
+                continue;
+            }
+
+            DEBUG_PRINTF("slot %d: %s, %.2f MB\n",
+                iSlot,
+                slot.mDescription.c_str(),
+                (double)slot.miNumBytes / (1024.0 * 1024.0));
+            for(auto const& resource : maResources)
+            {
+                if(resource.miSlot == (int32_t)iSlot)
+                {
+                    DEBUG_PRINTF("    %3d - %3d %s\n", resource.miFirstUse, resource.miLastUse, resource.mName.c_str());
+                }
+            }
+        }
+    }
+
+}   // Render
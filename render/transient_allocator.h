@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Render
+{
+    /*
+    ** outputs of the job list that are only needed from their first write to their last read in a frame share one
+    ** texture or buffer with outputs whose lifetimes don't overlap. webgpu can't place resources in a heap, so only
+    ** outputs with the same description (format, size, usage) share, and the whole texture or buffer is shared
+    **
+    ** no gpu objects, the renderer creates one texture or buffer per slot and the dry run tool reports the memory
+    */
+    class CTransientAllocator
+    {
+    public:
+        struct Resource
+        {
+            std::string         mName;                      // resource key of the render graph, "<job>/<attachment>"
+            std::string         mDescription;               // only resources with the same description share a slot
+            uint64_t            miNumBytes = 0;
+            uint32_t            miFirstUse = 0;             // schedule position of the first write
+            uint32_t            miLastUse = 0;              // and of the last read or write
+            bool                mbPersistent = false;       // read across frames, never shares its slot
+            int32_t             miSlot = -1;
+        };
+
+        struct Slot
+        {
+            std::string         mDescription;
+            uint64_t            miNumBytes = 0;
+            uint32_t            miLastUse = 0;
+            uint32_t            miNumResources = 0;
+            bool                mbPersistent = false;
+        };
+
+    public:
+        CTransientAllocator() = default;
+        virtual ~CTransientAllocator() = default;
+
+        void clear();
+
+        void addResource(Resource const& resource);
+
+        // first fit over the resources sorted by first use, optimal for intervals of the same description
+        void allocate();
+
+        // -1 for resources that weren't added
+        int32_t getSlot(std::string const& name) const;
+
+        // every resource in memory of its own, how the jobs kept their outputs before
+        uint64_t getNumUnaliasedBytes() const;
+
+        // one resource per slot
+        uint64_t getNumAliasedBytes() const;
+
+        void print() const;
+
+        inline std::vector<Resource> const& getResources() const
+        {
+            return maResources;
+        }
+
+        inline std::vector<Slot> const& getSlots() const
+        {
+            return maSlots;
+        }
+
+    protected:
+        std::vector<Resource>                   maResources;
+        std::vector<Slot>                       maSlots;
+        std::map<std::string, uint32_t>         maResourceIndices;
+    };
+
+}   // Render
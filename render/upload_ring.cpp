@@ -0,0 +1,96 @@
+#include <render/upload_ring.h>
+
+#include <assert.h>
+#include <string.h>
+
+namespace Render
+{
+    /*
+    **
+    */
+    void CUploadRing::beginFrame()
+    {
+        // keeps the capacity from the previous frames
+        macStaging.clear();
+        maCopyRegions.clear();
+        miNumWrites = 0;
+        miNumWrittenBytes = 0;
+    }
+
+    /*
+    **
+    */
+    void CUploadRing::write(
+        uint32_t iDestination,
+        uint64_t iDestOffset,
+        void const* pData,
+        uint64_t iSize)
+    {
+        assert(iDestOffset % UPLOAD_RING_ALIGNMENT == 0);
+        assert(iSize % UPLOAD_RING_ALIGNMENT == 0);
+
+        ++miNumWrites;
+        miNumWrittenBytes += iSize;
+
+        if(iSize == 0)
+        {
+            return;
+        }
+
+        // only the latest region of the destination can be reused, an earlier one may be overlapped by it
+        for(int32_t iRegion = (int32_t)maCopyRegions.size() - 1; iRegion >= 0; iRegion--)
+        {
+            CopyRegion& region = maCopyRegions[iRegion];
+            if(region.miDestination != iDestination)
+            {
+                continue;
+            }
+
+            // same range written again, last write wins
+            if(region.miDestOffset == iDestOffset && region.miSize == iSize)
+            {
+                memcpy(macStaging.data() + region.miStagingOffset, pData, iSize);
+                return;
+            }
+
+            // continues the last region in both the destination and the staging data
+            bool bLastRegion = (iRegion == (int32_t)maCopyRegions.size() - 1);
+            if(bLastRegion &&
+                region.miDestOffset + region.miSize == iDestOffset &&
+                region.miStagingOffset + region.miSize == (uint64_t)macStaging.size())
+            {
+                macStaging.insert(macStaging.end(), (uint8_t const*)pData, (uint8_t const*)pData + iSize);
+                region.miSize += iSize;
+                return;
+            }
+
+            break;
+        }
+
+        uint64_t iStagingOffset = (uint64_t)macStaging.size();
+        assert(iStagingOffset % UPLOAD_RING_ALIGNMENT == 0);
+        macStaging.insert(macStaging.end(), (uint8_t const*)pData, (uint8_t const*)pData + iSize);
+
+        CopyRegion region;
+        region.miDestination = iDestination;
+        region.miDestOffset = iDestOffset;
+        region.miStagingOffset = iStagingOffset;
+        region.miSize = iSize;
+        maCopyRegions.push_back(region);
+    }
+
+    /*
+    **
+    */
+    CUploadRing::FrameStats CUploadRing::getFrameStats() const
+    {
+        FrameStats stats;
+        stats.miNumWrites = miNumWrites;
+        stats.miNumCopies = (uint32_t)maCopyRegions.size();
+        stats.miNumWrittenBytes = miNumWrittenBytes;
+        stats.miNumUploadedBytes = (uint64_t)macStaging.size();
+
+        return stats;
+    }
+
+}   // Render
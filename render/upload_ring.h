@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#define UPLOAD_RING_ALIGNMENT       4
+
+namespace Render
+{
+    /*
+    ** per frame staging for small buffer updates
+    **
+    ** writes are packed back to back into one staging region that is reset every frame, the renderer uploads the
+    ** region with a single WriteBuffer and turns the copy regions into CopyBufferToBuffer commands at the start of
+    ** the frame's submit. a write that continues the previous one into the same buffer extends its copy region, a
+    ** write to exactly the same range as the latest region of a buffer replaces its bytes instead of adding a copy.
+    ** destinations are indices into a table owned by the caller, this class never touches the gpu.
+    */
+    class CUploadRing
+    {
+    public:
+        struct CopyRegion
+        {
+            uint32_t            miDestination;
+            uint64_t            miDestOffset;
+            uint64_t            miStagingOffset;
+            uint64_t            miSize;
+        };
+
+        struct FrameStats
+        {
+            uint32_t            miNumWrites = 0;            // write() calls
+            uint32_t            miNumCopies = 0;            // copy commands after merging
+            uint64_t            miNumWrittenBytes = 0;      // bytes handed to write()
+            uint64_t            miNumUploadedBytes = 0;     // staging bytes, replaced ranges are only uploaded once
+        };
+
+    public:
+        CUploadRing() = default;
+        virtual ~CUploadRing() = default;
+
+        void beginFrame();
+
+        // iDestOffset and iSize are multiples of UPLOAD_RING_ALIGNMENT, same as WriteBuffer
+        void write(
+            uint32_t iDestination,
+            uint64_t iDestOffset,
+            void const* pData,
+            uint64_t iSize);
+
+        inline uint8_t const* getStagingData() const
+        {
+            return macStaging.data();
+        }
+
+        inline uint64_t getStagingSize() const
+        {
+            return (uint64_t)macStaging.size();
+        }
+
+        inline std::vector<CopyRegion> const& getCopyRegions() const
+        {
+            return maCopyRegions;
+        }
+
+        FrameStats getFrameStats() const;
+
+    protected:
+        std::vector<uint8_t>                    macStaging;
+        std::vector<CopyRegion>                 maCopyRegions;
+
+        uint32_t                                miNumWrites = 0;
+        uint64_t                                miNumWrittenBytes = 0;
+    };
+
+}   // Render
@@ -1,3 +1,5 @@
+#include "include/default-uniform-data.shader"
+
 // -------------------------------------
 // Defines
 const EPS: f32 =               1e-6f;
@@ -246,33 +248,6 @@ struct FragmentOutput {
 	@location(1) sunLightOutput : vec4f,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 struct UniformData
 {
     mLastLightDirection: vec4<f32>,
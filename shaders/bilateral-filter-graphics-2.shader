@@ -1,31 +1,6 @@
-const PI: f32 = 3.14159f;
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
+#include "include/default-uniform-data.shader"
 
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
+const PI: f32 = 3.14159f;
 
 struct ConstantBufferData
 {
@@ -68,7 +43,8 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
     var output: VertexOutput;
     output.pos = vec4f(pos[i], 0.0f, 1.0f);
-    output.uv = uv[i];        
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
 
     return output;
 }
@@ -1,31 +1,6 @@
-const PI: f32 = 3.14159f;
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
+#include "include/default-uniform-data.shader"
 
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
+const PI: f32 = 3.14159f;
 
 struct ConstantBufferData
 {
@@ -1,36 +1,10 @@
+#include "include/default-uniform-data.shader"
+#include "include/resolution-mode.shader"
+
 const MAX_STEPS: i32 = 20;
 const DENSITY_MIN: f32 = -1.0f;
 const DENSITY_MAX: f32 = 1.0f;
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-
-    mInverseViewProjectionMatrix: mat4x4<f32>,
-};
-
 struct VertexInput 
 {
     @location(0) pos : vec4<f32>,
@@ -72,7 +46,8 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
     var output: VertexOutput;
     output.pos = vec4f(pos[i], 0.0f, 1.0f);
-    output.uv = uv[i];        
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
 
     return output;
 }
@@ -89,15 +64,16 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     //    in.uv.xy
     //);
 
-    let iCurrFrame: i32 = defaultUniformBuffer.miFrame / 16;
-    let iStep: i32 = defaultUniformBuffer.miFrame % 16;
-
     let motionVectorTextureSize: vec2<u32> = textureDimensions(skyMotionVectorTexture); 
     let textureSize: vec2<u32> = textureDimensions(prevCloudTexture);
     let screenCoord: vec2<i32> = vec2<i32>(
         i32(in.uv.x * f32(textureSize.x)),
         i32(in.uv.y * f32(textureSize.y)) 
     );
+    let screenUV: vec2<f32> = in.uv.xy / defaultUniformBuffer.mRenderScale.xy;
+
+    // same pixel of the last frame, drawn at the last frame's render scale
+    let lastScreenCoord: vec2<i32> = vec2<i32>(screenUV * defaultUniformBuffer.mRenderScale.zw * vec2<f32>(textureSize));
     
     let skyMotionVector: vec2<f32> = textureLoad(
         skyMotionVectorTexture,
@@ -116,7 +92,7 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     // TODO: fix prev screen coord, taking the delay tile build into account
     let prevColor: vec4<f32> = textureLoad(
         prevCloudTexture,
-        screenCoord,
+        lastScreenCoord,
         0
     );
 
@@ -128,19 +104,15 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
         uv
     );
 
-    let iTotalIndex: i32 = screenCoord.x + screenCoord.y * i32(textureSize.x);
-
-    //let iIndexX: i32 = screenCoord.x / (i32(textureSize.x) / 4);
-    //let iIndexY: i32 = screenCoord.y / (i32(textureSize.y) / 4);
-    //let iTotalIndex: i32 = iIndexY * 4 + iIndexX;
-    if(iTotalIndex % 16 != iStep)
+    // a pixel of every 4 x 4 a frame, "Resolution Mode" in the pipeline
+    if(!isPixelShaded(vec2<u32>(screenCoord), u32(defaultUniformBuffer.miFrame)))
     {
         output.mColor = prevColor;
 
         return output;
     }
 
-    var screenSpace: vec3<f32> = vec3<f32>(in.uv.xy * 2.0f - 1.0f, 1.0f);
+    var screenSpace: vec3<f32> = vec3<f32>(screenUV * 2.0f - 1.0f, 1.0f);
     screenSpace.y *= -1.0f;
     var worldPosition: vec4<f32> = vec4<f32>(screenSpace.xyz, 1.0f) * defaultUniformBuffer.mInverseViewProjectionMatrix;
     let fOneOverW: f32 = 1.0f / worldPosition.w;
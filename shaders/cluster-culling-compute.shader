@@ -0,0 +1,238 @@
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
+#include "include/occlusion-culling.shader"
+
+// Render::Meshlet, bounds are in model space
+struct Meshlet
+{
+    mSphere: vec4<f32>,
+    mConeApex: vec4<f32>,
+    mConeAxis: vec4<f32>,
+    miMesh: u32,
+    miIndexStart: u32,
+    miNumTriangles: u32,
+    miNumVertices: u32,
+};
+
+struct UniformData
+{
+    miNumMeshes: u32,
+    mfExplodeMultiplier: f32,
+    miClusterFlags: u32,
+};
+
+// normal cone test, only for passes that cull back faces
+const CLUSTER_FLAG_CULL_BACK_FACING = 1u;
+
+@group(0) @binding(0) var<storage, read_write> aDrawCalls: array<DrawIndexParam>;
+@group(0) @binding(1) var<storage, read_write> aNumDrawCalls: array<atomic<u32>>;
+@group(0) @binding(2) var<storage, read> afDepthPyramid: array<f32>;
+
+@group(1) @binding(0) var<storage, read> uniformBuffer: UniformData;
+@group(1) @binding(1) var<storage, read> aMeshlets: array<Meshlet>;
+@group(1) @binding(2) var<storage, read> aMeshLods: array<MeshLod>;
+@group(1) @binding(3) var<storage, read> aMeshExtents: array<MeshExtent>;
+@group(1) @binding(4) var<storage, read> aStaticMeshModelMatrices: array<mat4x4<f32>>;
+@group(1) @binding(5) var<storage, read> aiModelInstanceMap: array<ModelInstanceMap>;
+@group(1) @binding(6) var<storage, read> aiMeshVisibility: array<u32>;
+@group(1) @binding(7) var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+const iNumThreads = 64u;
+
+// visibility of the batch of meshlets the threads just tested
+var<workgroup> aiVisibleMeshlets: array<u32, iNumThreads>;
+
+/*
+** one workgroup per mesh instance, the threads test the meshlets of the model's level of detail 64 at a time and
+** the first thread merges runs of visible meshlets into one draw, they are next to each other in the index buffer
+*/
+@compute
+@workgroup_size(iNumThreads)
+fn cs_main(
+    @builtin(local_invocation_index) iLocalThreadIndex: u32,
+    @builtin(workgroup_id) workGroup: vec3<u32>)
+{
+    let iInstance: u32 = workGroup.x;
+    if(iInstance >= uniformBuffer.miNumMeshes)
+    {
+        return;
+    }
+
+    let iModel: u32 = aiModelInstanceMap[iInstance].miModel;
+    let modelMatrix: mat4x4<f32> = aStaticMeshModelMatrices[iInstance];
+
+    // whole instance first
+    let minPosition: vec3f = aMeshExtents[iModel].mMinPosition.xyz;
+    let maxPosition: vec3f = aMeshExtents[iModel].mMaxPosition.xyz;
+    let instanceSphere: vec4f = transformSphere(
+        vec4f((minPosition + maxPosition) * 0.5f, length(maxPosition - minPosition) * 0.5f),
+        modelMatrix);
+    if(isSphereOutsideFrustum(instanceSphere))
+    {
+        return;
+    }
+
+    // the instance tests of the mesh culling job of the same phase pick the instances, the late phase only has the
+    // ones that weren't drawn early and tests their meshlets against the depth pyramid
+    let iVisibility: u32 = aiMeshVisibility[iInstance] & (MESH_VISIBLE | MESH_DRAWN_EARLY);
+    if(OCCLUSION_PHASE == OCCLUSION_PHASE_EARLY && iVisibility != (MESH_VISIBLE | MESH_DRAWN_EARLY))
+    {
+        return;
+    }
+    if(OCCLUSION_PHASE == OCCLUSION_PHASE_LATE && iVisibility != MESH_VISIBLE)
+    {
+        return;
+    }
+    let bTestOcclusion: bool = (OCCLUSION_PHASE == OCCLUSION_PHASE_LATE);
+
+    let fScale: f32 = instanceSphere.w / max(length(maxPosition - minPosition) * 0.5f, 1.0e-6f);
+    let lod: MeshLod = aMeshLods[iModel * MESH_MAX_LODS + selectMeshLod(iModel, instanceSphere, fScale)];
+    let iMeshletStart: u32 = lod.miMeshletStart;
+    let iMeshletEnd: u32 = lod.miMeshletEnd;
+    let bCullBackFacing: bool = ((uniformBuffer.miClusterFlags & CLUSTER_FLAG_CULL_BACK_FACING) != 0u);
+    for(var iBatchStart: u32 = iMeshletStart; iBatchStart < iMeshletEnd; iBatchStart += iNumThreads)
+    {
+        let iMeshlet: u32 = iBatchStart + iLocalThreadIndex;
+        var iVisible: u32 = 0u;
+        if(iMeshlet < iMeshletEnd)
+        {
+            iVisible = select(1u, 0u, cullMeshlet(aMeshlets[iMeshlet], modelMatrix, bCullBackFacing, bTestOcclusion));
+        }
+        aiVisibleMeshlets[iLocalThreadIndex] = iVisible;
+
+        workgroupBarrier();
+
+        if(iLocalThreadIndex == 0u)
+        {
+            let iNumBatchMeshlets: u32 = min(iMeshletEnd - iBatchStart, iNumThreads);
+            var iRunStart: u32 = 0u;
+            var iRunIndexCount: u32 = 0u;
+            for(var i: u32 = 0u; i <= iNumBatchMeshlets; i++)
+            {
+                var bVisible: bool = false;
+                if(i < iNumBatchMeshlets)
+                {
+                    bVisible = (aiVisibleMeshlets[i] != 0u);
+                }
+
+                if(bVisible)
+                {
+                    if(iRunIndexCount == 0u)
+                    {
+                        iRunStart = i;
+                    }
+                    iRunIndexCount += aMeshlets[iBatchStart + i].miNumTriangles * 3u;
+                }
+                else if(iRunIndexCount > 0u)
+                {
+                    emitDraw(aMeshlets[iBatchStart + iRunStart].miIndexStart, iRunIndexCount, iInstance);
+                    iRunIndexCount = 0u;
+                }
+            }
+        }
+
+        workgroupBarrier();
+    }
+}
+
+/*
+** slots past the end of the draw call buffer are dropped, the count still goes up
+*/
+fn emitDraw(
+    iFirstIndex: u32,
+    iIndexCount: u32,
+    iInstance: u32)
+{
+    let iDrawCall: u32 = atomicAdd(&aNumDrawCalls[0], 1u);
+    if(iDrawCall >= arrayLength(&aDrawCalls))
+    {
+        return;
+    }
+
+    aDrawCalls[iDrawCall].miIndexCount = iIndexCount;
+    aDrawCalls[iDrawCall].miInstanceCount = 1u;
+    aDrawCalls[iDrawCall].miFirstIndex = iFirstIndex;
+    aDrawCalls[iDrawCall].miBaseVertex = 0;
+    aDrawCalls[iDrawCall].miFirstInstance = iInstance;
+}
+
+/*
+** same test as Render::cullMeshlet, after the bounds go to world space. the occlusion test takes the box around
+** the sphere
+*/
+fn cullMeshlet(
+    meshlet: Meshlet,
+    modelMatrix: mat4x4<f32>,
+    bCullBackFacing: bool,
+    bTestOcclusion: bool) -> bool
+{
+    let sphere: vec4f = transformSphere(meshlet.mSphere, modelMatrix);
+    if(isSphereOutsideFrustum(sphere))
+    {
+        return true;
+    }
+
+    if(bTestOcclusion && isBoxOccluded(sphere.xyz - sphere.w, sphere.xyz + sphere.w))
+    {
+        return true;
+    }
+
+    // cutoff of 1 is no cone
+    let fCutoff: f32 = meshlet.mConeAxis.w;
+    if(!bCullBackFacing || fCutoff >= 1.0f)
+    {
+        return false;
+    }
+
+    // cones assume uniform scale, the apex is behind every triangle and the axis is their average normal
+    let apex: vec3f = (vec4f(meshlet.mConeApex.xyz, 1.0f) * modelMatrix).xyz;
+    let axis: vec3f = normalize((vec4f(meshlet.mConeAxis.xyz, 0.0f) * modelMatrix).xyz);
+    let direction: vec3f = apex - defaultUniformBuffer.mCameraPosition.xyz;
+    return (dot(direction, axis) >= fCutoff * length(direction));
+}
+
+/*
+** radius grows by the largest axis scale of the matrix
+*/
+fn transformSphere(
+    sphere: vec4f,
+    modelMatrix: mat4x4<f32>) -> vec4f
+{
+    let center: vec4f = vec4f(sphere.xyz, 1.0f) * modelMatrix;
+    let fScaleX: f32 = length(vec3f(modelMatrix[0][0], modelMatrix[1][0], modelMatrix[2][0]));
+    let fScaleY: f32 = length(vec3f(modelMatrix[0][1], modelMatrix[1][1], modelMatrix[2][1]));
+    let fScaleZ: f32 = length(vec3f(modelMatrix[0][2], modelMatrix[1][2], modelMatrix[2][2]));
+    return vec4f(center.xyz, sphere.w * max(max(fScaleX, fScaleY), fScaleZ));
+}
+
+/*
+** left, right, bottom, top and near, same planes as mesh-culling-compute.shader
+*/
+fn isSphereOutsideFrustum(sphere: vec4f) -> bool
+{
+    for(var iPlane: u32 = 0u; iPlane < 5u; iPlane++)
+    {
+        let plane: vec4f = getFrustumPlane(iPlane / 2u, select(1.0f, -1.0f, (iPlane & 1u) != 0u));
+        if(dot(plane.xyz, sphere.xyz) + plane.w < -sphere.w)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+**
+*/
+fn getFrustumPlane(
+    iColumn: u32,
+    fMult: f32) -> vec4f
+{
+    let column: vec4<f32> = defaultUniformBuffer.mViewProjectionMatrix[iColumn];
+    let lastColumn: vec4<f32> = defaultUniformBuffer.mViewProjectionMatrix[3];
+    let plane: vec4f = column * fMult + lastColumn;
+    let fLength: f32 = length(plane.xyz);
+
+    return vec4f(plane.xyz / (fLength + 0.00001f), plane.w / (fLength + 0.00001f));
+}
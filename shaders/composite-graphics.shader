@@ -1,3 +1,5 @@
+#include "include/default-uniform-data.shader"
+
 struct VertexOutput 
 {
     @builtin(position) pos: vec4f,
@@ -8,33 +10,6 @@ struct FragmentOutput
     @location(0) mCompositeOutput: vec4<f32>,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 
 @group(0) @binding(0)
 var ambientOcclusionTexture: texture_2d<f32>;
@@ -1,3 +1,7 @@
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
+#include "include/vertex-dequantization.shader"
+
 const PI: f32 = 3.14159f;
 
 struct UniformData
@@ -5,33 +9,6 @@ struct UniformData
     miInstanceIndex: u32,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 struct Material
 {
     mDiffuse: vec4<f32>,
@@ -50,12 +27,6 @@ struct Range
     miEnd: i32
 };
 
-struct MeshExtent
-{
-    mMinPosition: vec4<f32>,
-    mMaxPosition: vec4<f32>,
-};
-
 struct SelectMeshInfo
 {
     miMeshID: u32,
@@ -100,19 +71,23 @@ var<storage, read> diffuseTextureAtlasInfoBuffer: array<TextureAtlasInfo>;
 var diffuseTextureAtlas: texture_2d<f32>;
 
 @group(1) @binding(8)
-var<uniform> defaultUniformBuffer: DefaultUniformData;
+var<storage, read> aVertexDequantization: array<VertexDequantization>;
 
 @group(1) @binding(9)
+var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+@group(1) @binding(10)
 var textureSampler: sampler;
 
 @group(2) @binding(0)
 var<storage> staticMeshUniformBuffer: UniformData;
 
+// PackedVertex, position xyz is quantized over the mesh extent and w is the mesh index
 struct VertexInput 
 {
-    @location(0) worldPosition : vec4<f32>,
-    @location(1) texCoord: vec4<f32>,
-    @location(2) normal : vec4<f32>
+    @location(0) quantizedPosition : vec4<u32>,
+    @location(1) texCoord: vec2<f32>,
+    @location(2) normal : vec2<f32>
 };
 struct VertexOutput 
 {
@@ -132,6 +107,27 @@ struct FragmentOutput
 };
 
 
+/*
+**
+*/
+fn dequantizePosition(quantizedPosition: vec4<u32>) -> vec3<f32>
+{
+    let dequantization: VertexDequantization = aVertexDequantization[quantizedPosition.w];
+    return dequantization.mOffset.xyz + vec3<f32>(quantizedPosition.xyz) * dequantization.mScale.xyz;
+}
+
+/*
+**
+*/
+fn decodeOctahedralNormal(encoded: vec2<f32>) -> vec3<f32>
+{
+    var normal: vec3<f32> = vec3<f32>(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    let fT: f32 = max(-normal.z, 0.0f);
+    normal.x += select(fT, -fT, normal.x >= 0.0f);
+    normal.y += select(fT, -fT, normal.y >= 0.0f);
+    return normalize(normal);
+}
+
 @vertex
 fn vs_main(in: VertexInput,
     @builtin(vertex_index) iVertexIndex: u32,
@@ -148,12 +144,7 @@ fn vs_main(in: VertexInput,
     // total mesh extent is at the very end of list
     let totalMeshExtent: MeshExtent = aMeshExtents[defaultUniformBuffer.miNumMeshes];
     let totalCenter: vec3f = (totalMeshExtent.mMaxPosition.xyz + totalMeshExtent.mMinPosition.xyz) * 0.5f;
-    var worldPosition: vec4<f32> = vec4<f32>(
-        in.worldPosition.x,
-        in.worldPosition.y,
-        in.worldPosition.z,
-        1.0f
-    );
+    var worldPosition: vec4<f32> = vec4<f32>(dequantizePosition(in.quantizedPosition), 1.0f);
     let staticMeshMatrix: mat4x4<f32> = aStaticMeshMatrices[iInstanceIndex];
 
     let totalMatrix: mat4x4<f32> = staticMeshMatrix * defaultUniformBuffer.mJitteredViewProjectionMatrix;
@@ -162,7 +153,7 @@ fn vs_main(in: VertexInput,
     rotationMatrix[0][3] = 0.0f;
     rotationMatrix[1][3] = 0.0f;
     rotationMatrix[2][3] = 0.0f;
-    var normal: vec4<f32> = in.normal * rotationMatrix;
+    var normal: vec4<f32> = vec4<f32>(decodeOctahedralNormal(in.normal), 1.0f) * rotationMatrix;
 
     out.pos = worldPosition * totalMatrix;
     out.worldPosition = vec4f(worldPosition.xyz, 1.0f) * staticMeshMatrix;
@@ -219,7 +210,8 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     // store depth and mesh id in worldPosition.w
     out.worldPosition.w = clamp(in.pos.z, 0.0f, 0.999f) + floor(in.worldPosition.w + 0.5f);
 
-    let currClipSpace: vec4<f32> = vec4<f32>(in.worldPosition.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
+    // without the jitter, the motion is of the surface and not of the samples
+    let currClipSpace: vec4<f32> = vec4<f32>(in.worldPosition.xyz, 1.0f) * defaultUniformBuffer.mViewProjectionMatrix;
     let prevClipSpace: vec4<f32> = vec4<f32>(in.worldPosition.xyz, 1.0f) * defaultUniformBuffer.mPrevViewProjectionMatrix;
 
     var currClipSpacePos: vec3<f32> = vec3<f32>(
@@ -257,9 +249,14 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     let lightDir: vec3f = normalize(vec3f(1.0f, -1.0f, 1.0f));
     let fDP: f32 = max(dot(normalXYZ, lightDir), 0.3f);
     
+    // uv derivatives have to come from uniform control flow and before the wrap above is applied
+    let uvDX: vec2f = dpdx(in.texCoord.xy);
+    let uvDY: vec2f = dpdy(in.texCoord.xy);
+
     var albedo: vec4<f32> = vec4f(1.0f, 1.0f, 1.0f, 1.0f);
     let iTextureID: u32 = aMaterials[iMesh].miAlbedoTextureID;
     let diffuseAtlasTextureSize: vec2u = textureDimensions(diffuseTextureAtlas);
+    let iNumAtlasMipLevels: u32 = textureNumLevels(diffuseTextureAtlas);
     if(iTextureID <= 100000u)
     {
         let textureAtlasInfo: TextureAtlasInfo = diffuseTextureAtlasInfoBuffer[iTextureID];
@@ -273,10 +270,16 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
             i32(textureUV.x * f32(diffuseAtlasTextureSize.x)),
             i32(textureUV.y * f32(diffuseAtlasTextureSize.y))
         );
+
+        // mip level from the texel footprint of the entry, the baker pads entries so lower levels don't bleed
+        let imageSize: vec2f = vec2f(f32(textureAtlasInfo.miImageWidth), f32(textureAtlasInfo.miImageHeight));
+        let fMaxTexelFootprint: f32 = max(length(uvDX * imageSize), length(uvDY * imageSize));
+        let iMipLevel: u32 = u32(clamp(floor(log2(max(fMaxTexelFootprint, 1.0f))), 0.0f, f32(iNumAtlasMipLevels - 1u)));
+
         albedo = textureLoad(
             diffuseTextureAtlas,
-            imageCoord,
-            0
+            imageCoord >> vec2u(iMipLevel, iMipLevel),
+            iMipLevel
         );
     }
 
@@ -0,0 +1,126 @@
+#include "include/default-uniform-data.shader"
+
+// a low resolution sample 1 / 64th of the camera distance away from the pixel counts half
+const kfDistanceWeightScale: f32 = 64.0f;
+
+@group(0) @binding(0)
+var worldPositionTexture: texture_2d<f32>;
+
+@group(0) @binding(1)
+var ambientOcclusionTexture: texture_2d<f32>;
+
+@group(0) @binding(2)
+var shadowTexture: texture_2d<f32>;
+
+@group(0) @binding(3)
+var indirectLightingTexture: texture_2d<f32>;
+
+@group(1) @binding(0)
+var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+@group(1) @binding(1)
+var textureSampler: sampler;
+
+struct VertexOutput
+{
+    @builtin(position) pos: vec4f,
+    @location(0) uv: vec2f,
+};
+struct FragmentOutput
+{
+    @location(0) mAmbientOcclusion: vec4<f32>,
+    @location(1) mShadow: vec4<f32>,
+    @location(2) mIndirectLighting: vec4<f32>,
+};
+
+@vertex
+fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
+{
+    const pos = array(vec2f(-1, 3), vec2f(-1, -1), vec2f(3, -1));
+    const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
+    var output: VertexOutput;
+    output.pos = vec4f(pos[i], 0.0f, 1.0f);
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
+
+    return output;
+}
+
+/*
+** the bilinear weights of the 4 low resolution samples around the pixel, each one scaled down by how far the world
+** position it was shaded at is from the pixel's relative to the camera distance, so the samples across an edge don't
+** bleed over it. the inputs have the same size
+*/
+@fragment
+fn fs_main(in: VertexOutput) -> FragmentOutput
+{
+    var out: FragmentOutput;
+
+    let worldPositionTextureSize: vec2<f32> = vec2<f32>(textureDimensions(worldPositionTexture));
+    let worldPosition: vec4<f32> = textureLoad(
+        worldPositionTexture,
+        vec2<i32>(in.uv * worldPositionTextureSize),
+        0
+    );
+
+    let lowResolutionSize: vec2<f32> = vec2<f32>(textureDimensions(ambientOcclusionTexture));
+    let lastCoord: vec2<i32> = max(
+        vec2<i32>(ceil(lowResolutionSize * defaultUniformBuffer.mRenderScale.xy)) - vec2<i32>(1, 1),
+        vec2<i32>(0, 0)
+    );
+    let samplePosition: vec2<f32> = in.uv * lowResolutionSize - 0.5f;
+    let baseCoord: vec2<i32> = vec2<i32>(floor(samplePosition));
+    let bilinear: vec2<f32> = samplePosition - floor(samplePosition);
+
+    let fCameraDistance: f32 = max(length(worldPosition.xyz - defaultUniformBuffer.mCameraPosition.xyz), 1.0e-4f);
+
+    var ambientOcclusion: vec4<f32> = vec4<f32>(0.0f, 0.0f, 0.0f, 0.0f);
+    var shadow: vec4<f32> = vec4<f32>(0.0f, 0.0f, 0.0f, 0.0f);
+    var indirectLighting: vec4<f32> = vec4<f32>(0.0f, 0.0f, 0.0f, 0.0f);
+    var fTotalWeight: f32 = 0.0f;
+    for(var i: i32 = 0; i < 4; i++)
+    {
+        let offset: vec2<i32> = vec2<i32>(i & 1, i >> 1);
+        let coord: vec2<i32> = clamp(baseCoord + offset, vec2<i32>(0, 0), lastCoord);
+
+        // the full resolution pixel the low resolution one was shaded from
+        let sampleUV: vec2<f32> = (vec2<f32>(coord) + 0.5f) / lowResolutionSize;
+        let sampleWorldPosition: vec4<f32> = textureLoad(
+            worldPositionTexture,
+            vec2<i32>(sampleUV * worldPositionTextureSize),
+            0
+        );
+        if(sampleWorldPosition.w <= 0.0f)
+        {
+            continue;
+        }
+
+        let fBilinearWeight: f32 =
+            mix(1.0f - bilinear.x, bilinear.x, f32(offset.x)) *
+            mix(1.0f - bilinear.y, bilinear.y, f32(offset.y));
+        let fRelativeDistance: f32 = length(sampleWorldPosition.xyz - worldPosition.xyz) / fCameraDistance;
+        let fWeight: f32 = fBilinearWeight / (1.0f + fRelativeDistance * kfDistanceWeightScale);
+
+        ambientOcclusion += textureLoad(ambientOcclusionTexture, coord, 0) * fWeight;
+        shadow += textureLoad(shadowTexture, coord, 0) * fWeight;
+        indirectLighting += textureLoad(indirectLightingTexture, coord, 0) * fWeight;
+        fTotalWeight += fWeight;
+    }
+
+    // sky, or none of the samples are on the pixel's surface
+    if(worldPosition.w <= 0.0f || fTotalWeight <= 1.0e-4f)
+    {
+        let nearestCoord: vec2<i32> = clamp(vec2<i32>(in.uv * lowResolutionSize), vec2<i32>(0, 0), lastCoord);
+        out.mAmbientOcclusion = textureLoad(ambientOcclusionTexture, nearestCoord, 0);
+        out.mShadow = textureLoad(shadowTexture, nearestCoord, 0);
+        out.mIndirectLighting = textureLoad(indirectLightingTexture, nearestCoord, 0);
+
+        return out;
+    }
+
+    out.mAmbientOcclusion = ambientOcclusion / fTotalWeight;
+    out.mShadow = shadow / fTotalWeight;
+    out.mIndirectLighting = indirectLighting / fTotalWeight;
+
+    return out;
+}
@@ -0,0 +1,82 @@
+#include "include/default-uniform-data.shader"
+
+// render/depth_pyramid.h
+const DEPTH_PYRAMID_WIDTH = 512u;
+const DEPTH_PYRAMID_HEIGHT = 256u;
+const DEPTH_PYRAMID_NUM_LEVELS = 5u;
+
+@group(0) @binding(0) var depthTexture: texture_2d<f32>;
+@group(0) @binding(1) var<storage, read_write> afDepthPyramid: array<f32>;
+@group(1) @binding(0) var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+const iTileSize = 16u;
+
+// farthest depths of the workgroup's tile at the level being reduced
+var<workgroup> afTileDepths: array<f32, 256>;
+
+/*
+** one workgroup per 16 x 16 tile of level 0, the coarser levels of the tile are reduced in workgroup memory down
+** to one texel at level 4. same as Render::buildDepthPyramid
+*/
+@compute
+@workgroup_size(iTileSize, iTileSize)
+fn cs_main(
+    @builtin(global_invocation_id) globalInvocation: vec3<u32>,
+    @builtin(local_invocation_id) localInvocation: vec3<u32>,
+    @builtin(workgroup_id) workGroup: vec3<u32>)
+{
+    // level 0 texels take every pixel they overlap, of the part of the depth the deferred jobs drew at the render
+    // scale
+    let depthSize: vec2<u32> = min(
+        vec2<u32>(vec2<f32>(textureDimensions(depthTexture)) * defaultUniformBuffer.mRenderScale.xy + 0.5f),
+        textureDimensions(depthTexture));
+    let pyramidSize: vec2<u32> = vec2<u32>(DEPTH_PYRAMID_WIDTH, DEPTH_PYRAMID_HEIGHT);
+    let startPixel: vec2<u32> = (globalInvocation.xy * depthSize) / pyramidSize;
+    var endPixel: vec2<u32> = ((globalInvocation.xy + 1u) * depthSize + pyramidSize - 1u) / pyramidSize;
+    endPixel = min(max(endPixel, startPixel + 1u), depthSize);
+
+    var fMaxDepth: f32 = 0.0f;
+    for(var iY: u32 = startPixel.y; iY < endPixel.y; iY++)
+    {
+        for(var iX: u32 = startPixel.x; iX < endPixel.x; iX++)
+        {
+            fMaxDepth = max(fMaxDepth, textureLoad(depthTexture, vec2<u32>(iX, iY), 0).x);
+        }
+    }
+
+    afDepthPyramid[globalInvocation.y * DEPTH_PYRAMID_WIDTH + globalInvocation.x] = fMaxDepth;
+    afTileDepths[localInvocation.y * iTileSize + localInvocation.x] = fMaxDepth;
+    workgroupBarrier();
+
+    var iLevelOffset: u32 = 0u;
+    var levelSize: vec2<u32> = pyramidSize;
+    var iLevelTileSize: u32 = iTileSize;
+    for(var iLevel: u32 = 1u; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+    {
+        iLevelOffset += levelSize.x * levelSize.y;
+        levelSize /= 2u;
+        iLevelTileSize /= 2u;
+
+        let bActive: bool = (localInvocation.x < iLevelTileSize && localInvocation.y < iLevelTileSize);
+        var fLevelDepth: f32 = 0.0f;
+        if(bActive)
+        {
+            let iPrev: u32 = localInvocation.y * 2u * iTileSize + localInvocation.x * 2u;
+            fLevelDepth = max(
+                max(afTileDepths[iPrev], afTileDepths[iPrev + 1u]),
+                max(afTileDepths[iPrev + iTileSize], afTileDepths[iPrev + iTileSize + 1u]));
+        }
+
+        workgroupBarrier();
+
+        if(bActive)
+        {
+            afTileDepths[localInvocation.y * iTileSize + localInvocation.x] = fLevelDepth;
+
+            let texel: vec2<u32> = workGroup.xy * iLevelTileSize + localInvocation.xy;
+            afDepthPyramid[iLevelOffset + texel.y * levelSize.x + texel.x] = fLevelDepth;
+        }
+
+        workgroupBarrier();
+    }
+}
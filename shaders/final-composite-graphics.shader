@@ -1,31 +1,6 @@
-const PI: f32 = 3.14159f;
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
+#include "include/default-uniform-data.shader"
 
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
+const PI: f32 = 3.14159f;
 
 @group(0) @binding(0)
 var diffuseLightingTexture: texture_2d<f32>;
@@ -83,7 +58,8 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
     var output: VertexOutput;
     output.pos = vec4f(pos[i], 0.0f, 1.0f);
-    output.uv = uv[i];        
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
 
     return output;
 }
@@ -148,9 +124,10 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     if(albedo.w <= 0.0f)
     {
         let invViewProjectionMatrix: mat4x4<f32> = invert(defaultUniformBuffer.mViewProjectionMatrix);
+        let screenUV: vec2<f32> = in.uv.xy / defaultUniformBuffer.mRenderScale.xy;
         var clipToWorld: vec4<f32> = vec4<f32>(
-            in.uv.x * 2.0f - 1.0f,
-            (1.0f - in.uv.y) * 2.0f - 1.0f,
+            screenUV.x * 2.0f - 1.0f,
+            (1.0f - screenUV.y) * 2.0f - 1.0f,
             1.0f, 
             1.0f) *
             invViewProjectionMatrix;
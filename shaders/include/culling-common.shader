@@ -0,0 +1,49 @@
+// drawIndexedIndirect arguments
+struct DrawIndexParam
+{
+    miIndexCount: u32,
+    miInstanceCount: u32,
+    miFirstIndex: u32,
+    miBaseVertex: i32,
+    miFirstInstance: u32,
+};
+
+// Render::MeshLod, MESH_MAX_LODS per mesh from the full one to the coarsest
+struct MeshLod
+{
+    miIndexStart: u32,
+    miNumIndices: u32,
+    miMeshletStart: u32,
+    miMeshletEnd: u32,
+    mfError: f32,
+    miPadding0: u32,
+    miPadding1: u32,
+    miPadding2: u32,
+};
+
+struct ModelInstanceMap
+{
+    miMeshInstance: u32,
+    miModel: u32,
+    miPadding0: u32,
+    miPadding1: u32,
+};
+
+// render/mesh_lod.h
+const MESH_MAX_LODS = 4u;
+const MESH_LOD_PIXEL_ERROR = 1.0f;
+
+// render/depth_pyramid.h
+const DEPTH_PYRAMID_WIDTH = 512u;
+const DEPTH_PYRAMID_HEIGHT = 256u;
+const DEPTH_PYRAMID_NUM_LEVELS = 5u;
+const DEPTH_PYRAMID_MAX_FOOTPRINT = 4u;
+
+// Render::OcclusionPhase
+const OCCLUSION_PHASE_NONE = 0u;
+const OCCLUSION_PHASE_EARLY = 1u;
+const OCCLUSION_PHASE_LATE = 2u;
+
+// meshVisibility bits, visible is from the last late phase, drawn early from this frame's early phase
+const MESH_VISIBLE = 1u;
+const MESH_DRAWN_EARLY = 2u;
@@ -0,0 +1,6 @@
+// model space bounds of a mesh
+struct MeshExtent
+{
+    mMinPosition: vec4<f32>,
+    mMaxPosition: vec4<f32>,
+};
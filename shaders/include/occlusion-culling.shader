@@ -0,0 +1,98 @@
+// selectMeshLod and isBoxOccluded of the culling shaders, they declare aMeshLods, afDepthPyramid and
+// defaultUniformBuffer
+
+#include "include/culling-common.shader"
+
+// the job's Render::OcclusionPhase, "Constants": { "OCCLUSION_PHASE": 1 } in its pipeline. the branches on it are
+// constant when the pipeline is compiled and the ones of the other phases are dropped
+override OCCLUSION_PHASE: u32 = OCCLUSION_PHASE_NONE;
+
+/*
+** same as Render::selectMeshLod, the coarsest level whose error is at most MESH_LOD_PIXEL_ERROR pixels at the
+** closest point of the instance's bounding sphere, in pixels of the render scale. fScale takes the error from model
+** to world space
+*/
+fn selectMeshLod(
+    iModel: u32,
+    sphere: vec4f,
+    fScale: f32) -> u32
+{
+    let fDistance: f32 = max(length(sphere.xyz - defaultUniformBuffer.mCameraPosition.xyz) - sphere.w, 1.0e-4f);
+    let fProjectionScale: f32 = f32(defaultUniformBuffer.miScreenHeight) * defaultUniformBuffer.mRenderScale.y * 0.5f * abs(defaultUniformBuffer.mProjectionMatrix[1][1]);
+    let fPixelsPerUnit: f32 = fScale * fProjectionScale / fDistance;
+
+    var iLod: u32 = 0u;
+    for(var i: u32 = 1u; i < MESH_MAX_LODS; i++)
+    {
+        if(aMeshLods[iModel * MESH_MAX_LODS + i].mfError * fPixelsPerUnit <= MESH_LOD_PIXEL_ERROR)
+        {
+            iLod = i;
+        }
+    }
+
+    return iLod;
+}
+
+/*
+** same as Render::isBoxOccluded, boxes crossing the near plane or off the screen are left to the frustum test
+*/
+fn isBoxOccluded(
+    minPosition: vec3f,
+    maxPosition: vec3f) -> bool
+{
+    var minUVZ: vec3f = vec3f(1.0e30f, 1.0e30f, 1.0e30f);
+    var maxUV: vec2f = vec2f(-1.0e30f, -1.0e30f);
+    for(var iCorner: u32 = 0u; iCorner < 8u; iCorner++)
+    {
+        let corner: vec3f = select(
+            minPosition,
+            maxPosition,
+            vec3<bool>((iCorner & 1u) != 0u, (iCorner & 2u) != 0u, (iCorner & 4u) != 0u));
+        let clipSpace: vec4f = vec4f(corner, 1.0f) * defaultUniformBuffer.mViewProjectionMatrix;
+        if(clipSpace.w <= 1.0e-5f)
+        {
+            return false;
+        }
+
+        let uvz: vec3f = vec3f(
+            (clipSpace.x / clipSpace.w) * 0.5f + 0.5f,
+            0.5f - (clipSpace.y / clipSpace.w) * 0.5f,
+            clipSpace.z / clipSpace.w);
+        minUVZ = min(minUVZ, uvz);
+        maxUV = max(maxUV, uvz.xy);
+    }
+
+    if(minUVZ.z <= 0.0f || maxUV.x < 0.0f || maxUV.y < 0.0f || minUVZ.x > 1.0f || minUVZ.y > 1.0f)
+    {
+        return false;
+    }
+
+    let pyramidSize: vec2u = vec2u(DEPTH_PYRAMID_WIDTH, DEPTH_PYRAMID_HEIGHT);
+    let minTexel: vec2u = min(vec2u(max(minUVZ.xy, vec2f(0.0f, 0.0f)) * vec2f(pyramidSize)), pyramidSize - 1u);
+    let maxTexel: vec2u = min(vec2u(min(maxUV, vec2f(1.0f, 1.0f)) * vec2f(pyramidSize)), pyramidSize - 1u);
+
+    var iLevelOffset: u32 = 0u;
+    for(var iLevel: u32 = 0u; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+    {
+        let iLevelWidth: u32 = DEPTH_PYRAMID_WIDTH >> iLevel;
+        let levelMin: vec2u = minTexel >> vec2u(iLevel, iLevel);
+        let levelMax: vec2u = maxTexel >> vec2u(iLevel, iLevel);
+        if(levelMax.x - levelMin.x < DEPTH_PYRAMID_MAX_FOOTPRINT && levelMax.y - levelMin.y < DEPTH_PYRAMID_MAX_FOOTPRINT)
+        {
+            var fMaxDepth: f32 = 0.0f;
+            for(var iY: u32 = levelMin.y; iY <= levelMax.y; iY++)
+            {
+                for(var iX: u32 = levelMin.x; iX <= levelMax.x; iX++)
+                {
+                    fMaxDepth = max(fMaxDepth, afDepthPyramid[iLevelOffset + iY * iLevelWidth + iX]);
+                }
+            }
+
+            return (minUVZ.z > fMaxDepth);
+        }
+
+        iLevelOffset += iLevelWidth * (DEPTH_PYRAMID_HEIGHT >> iLevel);
+    }
+
+    return false;
+}
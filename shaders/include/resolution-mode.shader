@@ -0,0 +1,40 @@
+// isPixelShaded in render/resolution_mode.h, the pixels of a job's outputs it shades this frame
+
+// "Resolution Mode" and "Interleave Size" of the job's pipeline, 0 full, 1 checkerboard and 2 interleaved. the
+// pipeline sets them for the sparse modes, the branches are constant when it's compiled
+override RESOLUTION_MODE: u32 = 0u;
+override RESOLUTION_INTERLEAVE: u32 = 2u;
+
+// order of the pixel in its square, the 2 x 2 bayer matrix going down to the 4 x 4 one
+fn getBayerIndex(coord: vec2<u32>) -> u32
+{
+    var iIndex: u32 = 0u;
+    var iX: u32 = coord.x;
+    var iY: u32 = coord.y;
+    for(var iSize: u32 = 1u; iSize < RESOLUTION_INTERLEAVE; iSize <<= 1u)
+    {
+        iIndex = (iIndex << 2u) | ((((iX ^ iY) & 1u) << 1u) + (iY & 1u));
+        iX >>= 1u;
+        iY >>= 1u;
+    }
+
+    return iIndex;
+}
+
+// coord is the pixel of the output, frame the one of the default uniform data
+fn isPixelShaded(
+    coord: vec2<u32>,
+    iFrame: u32) -> bool
+{
+    if(RESOLUTION_MODE == 1u)
+    {
+        return ((coord.x + coord.y + iFrame) & 1u) == 0u;
+    }
+    else if(RESOLUTION_MODE == 2u)
+    {
+        let iPeriod: u32 = RESOLUTION_INTERLEAVE * RESOLUTION_INTERLEAVE;
+        return getBayerIndex(coord % RESOLUTION_INTERLEAVE) == (iFrame % iPeriod);
+    }
+
+    return true;
+}
@@ -0,0 +1,6 @@
+// position = offset + quantized * scale, render/packed_vertex.h
+struct VertexDequantization
+{
+    mOffset: vec4<f32>,
+    mScale: vec4<f32>,
+};
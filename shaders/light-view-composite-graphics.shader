@@ -0,0 +1,83 @@
+#include "include/default-uniform-data.shader"
+
+struct VertexOutput
+{
+    @builtin(position) pos: vec4f,
+    @location(0) uv: vec2f,
+};
+struct FragmentOutput
+{
+    @location(0) clipSpacePosition : vec4<f32>,
+    @location(1) worldPosition: vec4<f32>,
+    @location(2) moment: vec4<f32>,
+};
+
+// cached light view of the static meshes, drawn again only when the cascade moves
+@group(0) @binding(0)
+var staticClipSpacePositionTexture: texture_2d<f32>;
+
+@group(0) @binding(1)
+var staticWorldPositionTexture: texture_2d<f32>;
+
+@group(0) @binding(2)
+var staticMomentTexture: texture_2d<f32>;
+
+// skinned meshes, ball and bat of this frame
+@group(0) @binding(3)
+var dynamicClipSpacePositionTexture: texture_2d<f32>;
+
+@group(0) @binding(4)
+var dynamicWorldPositionTexture: texture_2d<f32>;
+
+@group(0) @binding(5)
+var dynamicMomentTexture: texture_2d<f32>;
+
+@group(1) @binding(0)
+var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+@group(1) @binding(1)
+var textureSampler: sampler;
+
+@vertex
+fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
+{
+    const pos = array(vec2f(-1, 3), vec2f(-1, -1), vec2f(3, -1));
+    const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
+    var output: VertexOutput;
+    output.pos = vec4f(pos[i], 0.0f, 1.0f);
+    output.uv = uv[i];
+
+    return output;
+}
+
+/*
+** the closer of the two layers to the light, a texel nothing was drawn to has world position w 0 from the clear
+*/
+@fragment
+fn fs_main(in: VertexOutput) -> FragmentOutput
+{
+    var out: FragmentOutput;
+
+    let coord: vec2i = vec2i(in.pos.xy);
+    let staticWorldPosition: vec4<f32> = textureLoad(staticWorldPositionTexture, coord, 0);
+    let dynamicWorldPosition: vec4<f32> = textureLoad(dynamicWorldPositionTexture, coord, 0);
+    let staticClipSpacePosition: vec4<f32> = textureLoad(staticClipSpacePositionTexture, coord, 0);
+    let dynamicClipSpacePosition: vec4<f32> = textureLoad(dynamicClipSpacePositionTexture, coord, 0);
+
+    let bDynamic: bool = (dynamicWorldPosition.w > 0.0f &&
+        (staticWorldPosition.w <= 0.0f || dynamicClipSpacePosition.z <= staticClipSpacePosition.z));
+    if(bDynamic)
+    {
+        out.clipSpacePosition = dynamicClipSpacePosition;
+        out.worldPosition = dynamicWorldPosition;
+        out.moment = textureLoad(dynamicMomentTexture, coord, 0);
+    }
+    else
+    {
+        out.clipSpacePosition = staticClipSpacePosition;
+        out.worldPosition = staticWorldPosition;
+        out.moment = textureLoad(staticMomentTexture, coord, 0);
+    }
+
+    return out;
+}
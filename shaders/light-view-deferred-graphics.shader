@@ -1,3 +1,6 @@
+#include "include/default-uniform-data.shader"
+#include "include/vertex-dequantization.shader"
+
 const PI: f32 = 3.14159f;
 
 struct StaticMeshModelUniform
@@ -8,33 +11,6 @@ struct StaticMeshModelUniform
     mExtraInfo: vec4<f32>,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 struct UniformData
 {
     maLightViewProjectionMatrices: array<mat4x4<f32>, 3>,
@@ -56,16 +32,20 @@ var<storage, read> aStaticMeshMatrices: array<mat4x4<f32>>;
 var<uniform> constantBuffer: ConstantBufferData;
 
 @group(1) @binding(3)
-var<uniform> defaultUniformBuffer: DefaultUniformData;
+var<storage, read> aVertexDequantization: array<VertexDequantization>;
 
 @group(1) @binding(4)
+var<uniform> defaultUniformBuffer: DefaultUniformData;
+
+@group(1) @binding(5)
 var textureSampler: sampler;
 
+// PackedVertex, position xyz is quantized over the mesh extent and w is the mesh index
 struct VertexInput 
 {
-    @location(0) worldPosition : vec4<f32>,
-    @location(1) texCoord: vec4<f32>,
-    @location(2) normal : vec4<f32>
+    @location(0) quantizedPosition : vec4<u32>,
+    @location(1) texCoord: vec2<f32>,
+    @location(2) normal : vec2<f32>
 };
 struct VertexOutput 
 {
@@ -80,23 +60,27 @@ struct FragmentOutput
     @location(2) moment: vec4<f32>,
 };
 
+/*
+**
+*/
+fn dequantizePosition(quantizedPosition: vec4<u32>) -> vec3<f32>
+{
+    let dequantization: VertexDequantization = aVertexDequantization[quantizedPosition.w];
+    return dequantization.mOffset.xyz + vec3<f32>(quantizedPosition.xyz) * dequantization.mScale.xyz;
+}
+
 @vertex
 fn vs_main(in: VertexInput,
     @builtin(vertex_index) iVertexIndex: u32) -> VertexOutput 
 {
     var out: VertexOutput;
     
-    let iMesh: u32 = u32(ceil(in.texCoord.z - 0.5f));
+    let iMesh: u32 = in.quantizedPosition.w;
 
     let iCascade: u32 = u32(floor(constantBuffer.mCascadePartition - 0.5f));
 
     // total mesh extent is at the very end of list
-     var worldPosition: vec4<f32> = vec4<f32>(
-        in.worldPosition.x,
-        in.worldPosition.y,
-        in.worldPosition.z,
-        1.0f
-    );
+    var worldPosition: vec4<f32> = vec4<f32>(dequantizePosition(in.quantizedPosition), 1.0f);
     let staticMeshMatrix: mat4x4<f32> = aStaticMeshMatrices[iMesh];
     let totalMatrix: mat4x4<f32> = staticMeshMatrix * uniformBuffer.maLightViewProjectionMatrices[iCascade];
     out.pos = worldPosition * totalMatrix;
@@ -1,31 +1,7 @@
-const PI: f32 = 3.14159f;
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
 
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
+const PI: f32 = 3.14159f;
 
 struct Material
 {
@@ -45,12 +21,6 @@ struct Range
     miEnd: i32
 };
 
-struct MeshExtent
-{
-    mMinPosition: vec4<f32>,
-    mMaxPosition: vec4<f32>,
-};
-
 struct SelectMeshInfo
 {
     miMeshID: u32,
@@ -94,11 +64,12 @@ var textureSampler: sampler;
 @group(2) @binding(0)
 var<storage> animMeshUniformBuffer: AnimMeshModelUniform;
 
+// SkinnedVertex written by skin-mesh-compute.shader
 struct VertexInput 
 {
-    @location(0) worldPosition : vec4<f32>,
-    @location(1) texCoord: vec4<f32>,
-    @location(2) normal : vec4<f32>
+    @location(0) worldPosition : vec3<f32>,
+    @location(1) normal : vec2<f32>,
+    @location(2) texCoord: vec2<f32>
 };
 struct VertexOutput 
 {
@@ -1,58 +1,6 @@
-struct DrawIndexParam
-{
-    miIndexCount: u32,
-    miInstanceCount: u32,
-    miFirstIndex: u32,
-    miBaseVertex: i32,
-    miFirstInstance: u32,
-};
-
-struct MeshExtent
-{
-    mMinPosition: vec4<f32>,
-    mMaxPosition: vec4<f32>,
-};
-
-struct Range
-{
-    miStart: u32,
-    miEnd: u32,
-};
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
-struct ModelInstanceMap
-{
-    miMeshInstance: u32,
-    miModel: u32,
-    miPadding0: u32,
-    miPadding1: u32,
-};
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
+#include "include/occlusion-culling.shader"
 
 struct UniformData
 {
@@ -63,21 +11,15 @@ struct UniformData
 @group(0) @binding(0) var<storage, read_write> aDrawCalls: array<DrawIndexParam>;
 @group(0) @binding(1) var<storage, read_write> aNumDrawCalls: array<atomic<u32>>;
 @group(0) @binding(2) var<storage, read_write> aiVisibleMeshID: array<u32>;
-//@group(0) @binding(3) depthTexture0: texture_2d<f32>;
-//@group(0) @binding(4) depthTexture1: texture_2d<f32>;
-//@group(0) @binding(5) depthTexture2: texture_2d<f32>;
-//@group(0) @binding(6) depthTexture3: texture_2d<f32>;
-//@group(0) @binding(7) depthTexture4: texture_2d<f32>;
-//@group(0) @binding(8) depthTexture5: texture_2d<f32>;
-//@group(0) @binding(9) depthTexture6: texture_2d<f32>;
-//@group(0) @binding(10) depthTexture7: texture_2d<f32>;
+@group(0) @binding(3) var<storage, read> afDepthPyramid: array<f32>;
 
 @group(1) @binding(0) var<storage, read> uniformBuffer: UniformData;
-@group(1) @binding(1) var<storage, read> aMeshTriangleIndexRanges: array<Range>;
+@group(1) @binding(1) var<storage, read> aMeshLods: array<MeshLod>;
 @group(1) @binding(2) var<storage, read> aMeshExtents: array<MeshExtent>;
 @group(1) @binding(3) var<storage, read> aStaticMeshModelMatrices: array<mat4x4<f32>>;
 @group(1) @binding(4) var<storage, read> aiModelInstanceMap: array<ModelInstanceMap>;
-@group(1) @binding(5) var<uniform> defaultUniformBuffer: DefaultUniformData;
+@group(1) @binding(5) var<storage, read_write> aiMeshVisibility: array<u32>;
+@group(1) @binding(6) var<uniform> defaultUniformBuffer: DefaultUniformData;
 
 const iNumThreads = 256u;
 
@@ -110,13 +52,6 @@ fn cs_main(
     var maxPos: vec4<f32> = vec4<f32>(aMeshExtents[iMeshModelIndex].mMaxPosition.xyz, 1.0f) * aStaticMeshModelMatrices[iMesh];
     let meshCenter = (minPos.xyz + maxPos.xyz) * 0.5f;
 
-    // check bbox against the depth pyramid
-    let bOccluded: bool = cullBBoxDepth(
-        minPos.xyz,
-        maxPos.xyz,
-        iMeshModelIndex
-    );
-
     var bInside: bool = cullBBox(
         minPos.xyz,
         maxPos.xyz,
@@ -135,9 +70,37 @@ fn cs_main(
     aDrawCalls[iMesh].miFirstInstance = 0u;
 
     aiVisibleMeshID[iMesh] = 0u;
-    let iNumIndices: u32 = aMeshTriangleIndexRanges[iMeshModelIndex].miEnd - aMeshTriangleIndexRanges[iMeshModelIndex].miStart;
-    let iIndexAddressOffset: u32 = aMeshTriangleIndexRanges[iMeshModelIndex].miStart;
-    if(bInside && !bOccluded && iNumIndices > 0)
+
+    // level of detail from the sphere around the model space extent, scaled by the largest axis of the matrix
+    let modelMatrix: mat4x4<f32> = aStaticMeshModelMatrices[iMesh];
+    let fScale: f32 = max(max(
+        length(vec3f(modelMatrix[0][0], modelMatrix[1][0], modelMatrix[2][0])),
+        length(vec3f(modelMatrix[0][1], modelMatrix[1][1], modelMatrix[2][1]))),
+        length(vec3f(modelMatrix[0][2], modelMatrix[1][2], modelMatrix[2][2])));
+    let fModelRadius: f32 = length(aMeshExtents[iMeshModelIndex].mMaxPosition.xyz - aMeshExtents[iMeshModelIndex].mMinPosition.xyz) * 0.5f;
+    let iLod: u32 = selectMeshLod(iMeshModelIndex, vec4f(meshCenter, fModelRadius * fScale), fScale);
+    let lod: MeshLod = aMeshLods[iMeshModelIndex * MESH_MAX_LODS + iLod];
+    let iNumIndices: u32 = lod.miNumIndices;
+    let iIndexAddressOffset: u32 = lod.miIndexStart;
+
+    // the early phase draws what was visible last frame, the late phase tests everything against the depth pyramid
+    // of the early pass and draws what turned visible since
+    var bVisible: bool = bInside;
+    if(OCCLUSION_PHASE == OCCLUSION_PHASE_EARLY)
+    {
+        let iVisibility: u32 = aiMeshVisibility[iMesh] & MESH_VISIBLE;
+        bVisible = bInside && iVisibility != 0u;
+        aiMeshVisibility[iMesh] = iVisibility | select(0u, MESH_DRAWN_EARLY, bVisible);
+    }
+    else if(OCCLUSION_PHASE == OCCLUSION_PHASE_LATE)
+    {
+        let iDrawnEarly: u32 = aiMeshVisibility[iMesh] & MESH_DRAWN_EARLY;
+        let bUnoccluded: bool = bInside && !isInstanceOccluded(iMeshModelIndex, modelMatrix);
+        aiMeshVisibility[iMesh] = iDrawnEarly | select(0u, MESH_VISIBLE, bUnoccluded);
+        bVisible = bUnoccluded && iDrawnEarly == 0u;
+    }
+
+    if(bVisible && iNumIndices > 0)
     {
         aDrawCalls[iMesh].miIndexCount = iNumIndices;
         aDrawCalls[iMesh].miInstanceCount = 1u;
@@ -256,129 +219,21 @@ fn cullBBox(
     return (fCount0 > -8.0f && fCount1 > -8.0f && fCount2 > -8.0f && fCount3 > -8.0f && fCount4 > -8.0f);  
 }
 
-
-//////
-fn cullBBoxDepth(
-    minPosition: vec3f,
-    maxPosition: vec3f,
-    iMesh: u32) -> bool
+/*
+** world space box around the model space extent, each axis of the matrix adds its share of the half extent
+*/
+fn isInstanceOccluded(
+    iModel: u32,
+    modelMatrix: mat4x4<f32>) -> bool
 {
-    return false;
-
-    // NOTE: z pyramid textures didn't all in account of all pixels, just the 4 adjacent ones when down scaling
-    // scale to pow(2) size to fix this?
-
-    //let v0: vec3f = vec3f(minPosition.x, minPosition.y, minPosition.z);
-    //let v1: vec3f = vec3f(maxPosition.x, minPosition.y, minPosition.z);
-    //let v2: vec3f = vec3f(minPosition.x, minPosition.y, maxPosition.z);
-    //let v3: vec3f = vec3f(maxPosition.x, minPosition.y, maxPosition.z);
-//
-    //let v4: vec3f = vec3f(minPosition.x, maxPosition.y, minPosition.z);
-    //let v5: vec3f = vec3f(maxPosition.x, maxPosition.y, minPosition.z);
-    //let v6: vec3f = vec3f(minPosition.x, maxPosition.y, maxPosition.z);
-    //let v7: vec3f = vec3f(maxPosition.x, maxPosition.y, maxPosition.z);
-//
-    //let xform0: vec4f = vec4f(v0.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform1: vec4f = vec4f(v1.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform2: vec4f = vec4f(v2.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform3: vec4f = vec4f(v3.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-//
-    //let xform4: vec4f = vec4f(v4.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform5: vec4f = vec4f(v5.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform6: vec4f = vec4f(v6.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-    //let xform7: vec4f = vec4f(v7.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
-//
-    //let xyz0:vec3f  = xform0.xyz / xform0.w;
-    //let xyz1:vec3f  = xform1.xyz / xform1.w;
-    //let xyz2:vec3f  = xform2.xyz / xform2.w;
-    //let xyz3:vec3f  = xform3.xyz / xform3.w;
-//
-    //let xyz4:vec3f  = xform4.xyz / xform4.w;
-    //let xyz5:vec3f  = xform5.xyz / xform5.w;
-    //let xyz6:vec3f  = xform6.xyz / xform6.w;
-    //let xyz7:vec3f  = xform7.xyz / xform7.w;
-//
-    //var minXYZ: vec3f = min(min(min(min(min(min(min(xyz0, xyz1), xyz2), xyz3), xyz4), xyz5), xyz6), xyz7);
-    //var maxXYZ: vec3f = max(max(max(max(max(max(max(xyz0, xyz1), xyz2), xyz3), xyz4), xyz5), xyz6), xyz7);
-    //minXYZ = vec3f(minXYZ.x * 0.5f + 0.5f, minXYZ.y * 0.5f + 0.5f, minXYZ.z);
-    //maxXYZ = vec3f(maxXYZ.x * 0.5f + 0.5f, maxXYZ.y * 0.5f + 0.5f, maxXYZ.z);
-//
-    //minXYZ.x = clamp(minXYZ.x, 0.0f, 1.0f);
-    //minXYZ.y = clamp(minXYZ.y, 0.0f, 1.0f);
-    //maxXYZ.x = clamp(maxXYZ.x, 0.0f, 1.0f);
-    //maxXYZ.y = clamp(maxXYZ.y, 0.0f, 1.0f);
-//
-    //if (maxXYZ.z > 1.0f)
-    //{
-    //    minXYZ.z = 0.0f;
-    //}
-//
-    //let fMinDepth: f32 = minXYZ.z;
-    //let fAspectRatio: f32 = f32(defaultUniformBuffer.miScreenHeight) / f32(defaultUniformBuffer.miScreenWidth);
-    //let diffXY: vec2f = abs(maxXYZ.xy - minXYZ.xy);
-    //let fMaxComp: f32 = max(diffXY.x, diffXY.y * fAspectRatio) * 512.0f; // compute LOD from 1 to 8
-    //let iLOD: u32 = min(u32(log2(fMaxComp)), 8u);
-    //var uv: vec2f = vec2f(maxXYZ.xy + minXYZ.xy) * 0.5f;
-    //uv.y = 1.0f - uv.y;
-    //uv = clamp(uv, vec2f(0.0f, 0.0f), vec2f(1.0f, 1.0f));
-    //var fSampleDepth: f32 = 0.0f;
-//
-    //if (iLOD == 0u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture0.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture0[screenCoord].x;
-    //}
-    //else if (iLOD == 1u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture1.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture1[screenCoord].x;
-    //}
-    //else if (iLOD == 2u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture2.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture2[screenCoord].x;
-    //}
-    //else if (iLOD == 3u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture3.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture3[screenCoord].x;
-    //}
-    //else if (iLOD == 4u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture4.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture4[screenCoord].x;
-    //}
-    //else if (iLOD == 5u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture5.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture5[screenCoord].x;
-    //}
-    //else if (iLOD == 6u)
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture6.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture6[screenCoord].x;
-    //}
-    //else
-    //{
-    //    var textureSize: uint2;
-    //    depthTexture7.GetDimensions(textureSize.x, textureSize.y);
-    //    let screenCoord: uint2 = uint2(u32(uv.x * f32(textureSize.x)), u32(uv.y * f32(textureSize.y)));
-    //    fSampleDepth = depthTexture7[screenCoord].x;
-    //}
-
-    //return (fMinDepth > fSampleDepth);
-}
\ No newline at end of file
+    let minPosition: vec3f = aMeshExtents[iModel].mMinPosition.xyz;
+    let maxPosition: vec3f = aMeshExtents[iModel].mMaxPosition.xyz;
+    let center: vec3f = (vec4f((minPosition + maxPosition) * 0.5f, 1.0f) * modelMatrix).xyz;
+    let halfExtent: vec3f = (maxPosition - minPosition) * 0.5f;
+    let worldHalfExtent: vec3f = vec3f(
+        dot(halfExtent, abs(modelMatrix[0].xyz)),
+        dot(halfExtent, abs(modelMatrix[1].xyz)),
+        dot(halfExtent, abs(modelMatrix[2].xyz)));
+
+    return isBoxOccluded(center - worldHalfExtent, center + worldHalfExtent);
+}
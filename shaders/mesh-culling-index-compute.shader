@@ -1,17 +1,6 @@
-struct DrawIndexParam
-{
-    miIndexCount: u32,
-    miInstanceCount: u32,
-    miFirstIndex: u32,
-    miBaseVertex: i32,
-    miFirstInstance: u32,
-};
-
-struct MeshExtent
-{
-    mMinPosition: vec4<f32>,
-    mMaxPosition: vec4<f32>,
-};
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
+#include "include/culling-common.shader"
 
 struct Range
 {
@@ -19,41 +8,6 @@ struct Range
     miEnd: u32,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
-struct ModelInstanceMap
-{
-    miMeshInstance: u32,
-    miModel: u32,
-    miPadding0: u32,
-    miPadding1: u32,
-};
-
 struct UniformData
 {
     miNumMeshes: u32,
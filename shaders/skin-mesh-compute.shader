@@ -1,46 +1,33 @@
+#include "include/default-uniform-data.shader"
+#include "include/vertex-dequantization.shader"
+
 struct Range
 {
     miStart: u32,
     miEnd: u32,
 };
 
-struct DefaultUniformData
+struct UniformData
 {
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
+    maiNumMeshVertices: array<vec4<u32>, 16>,
 };
 
-struct UniformData
+// render/packed_vertex.h
+struct PackedVertex
 {
-    maiNumMeshVertices: array<vec4<u32>, 16>,
+    miPositionXY: u32,
+    miPositionZMesh: u32,
+    miTexCoord: u32,
+    miNormal: u32,
 };
 
-struct Vertex
+struct SkinnedVertex
 {
-    mPosition : vec4<f32>,
-    mTexCoord: vec4<f32>,
-    mNormal : vec4<f32>
+    mfPositionX: f32,
+    mfPositionY: f32,
+    mfPositionZ: f32,
+    miNormal: u32,
+    miTexCoord: u32,
 };
 
 struct MeshInstanceVertexRange
@@ -53,10 +40,10 @@ struct MeshInstanceVertexRange
 };
 
 @group(0) @binding(0)
-var<storage, read_write> aXFormVertices: array<Vertex>;
+var<storage, read_write> aXFormVertices: array<SkinnedVertex>;
 
 @group(1) @binding(0)
-var<storage, read> aOrigVertexBuffer: array<Vertex>; 
+var<storage, read> aOrigVertexBuffer: array<PackedVertex>; 
 
 @group(1) @binding(1)
 var<storage> aiJointInfluenceIndices: array<u32>;
@@ -76,8 +63,37 @@ var<storage, read> aMeshInstanceVertexRanges: array<MeshInstanceVertexRange>;
 @group(1) @binding(6)
 var<storage, read> uniformBuffer: UniformData;
 
+@group(1) @binding(7)
+var<storage, read> aVertexDequantization: array<VertexDequantization>;
+
 const iNumThreads: u32 = 256u;
 
+/*
+**
+*/
+fn decodeOctahedralNormal(encoded: vec2<f32>) -> vec3<f32>
+{
+    var normal: vec3<f32> = vec3<f32>(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    let fT: f32 = max(-normal.z, 0.0f);
+    normal.x += select(fT, -fT, normal.x >= 0.0f);
+    normal.y += select(fT, -fT, normal.y >= 0.0f);
+    return normalize(normal);
+}
+
+/*
+**
+*/
+fn encodeOctahedralNormal(normal: vec3<f32>) -> vec2<f32>
+{
+    let projected: vec3<f32> = normal / max(abs(normal.x) + abs(normal.y) + abs(normal.z), 1.0e-8f);
+    var encoded: vec2<f32> = projected.xy;
+    if(projected.z < 0.0f)
+    {
+        encoded = (vec2<f32>(1.0f) - abs(projected.yx)) * select(vec2<f32>(-1.0f), vec2<f32>(1.0f), projected.xy >= vec2<f32>(0.0f));
+    }
+    return encoded;
+}
+
 @compute
 @workgroup_size(iNumThreads)
 fn cs_main(
@@ -127,8 +143,16 @@ fn cs_main(
     var xformMatrix2: mat4x4<f32> = aJointAnimationTotalMatrices[aiJointInfluence[2]];
     var xformMatrix3: mat4x4<f32> = aJointAnimationTotalMatrices[aiJointInfluence[3]];
 
+    // dequantize with the mesh model's extent
+    let packedVertex: PackedVertex = aOrigVertexBuffer[iVertexIndex];
+    let dequantization: VertexDequantization = aVertexDequantization[iMesh];
+    let quantizedPosition: vec3<f32> = vec3<f32>(
+        f32(packedVertex.miPositionXY & 0xffffu),
+        f32(packedVertex.miPositionXY >> 16u),
+        f32(packedVertex.miPositionZMesh & 0xffffu));
+
     // skinned position
-    let position: vec4<f32> = aOrigVertexBuffer[iVertexIndex].mPosition;
+    let position: vec4<f32> = vec4<f32>(dequantization.mOffset.xyz + quantizedPosition * dequantization.mScale.xyz, 1.0f);
     let skinnedPos: vec4<f32> = 
         position * xformMatrix0 * afJointInfluenceWeight[0] +
         position * xformMatrix1 * afJointInfluenceWeight[1] + 
@@ -136,7 +160,7 @@ fn cs_main(
         position * xformMatrix3 * afJointInfluenceWeight[3];
     
     // skinned normal
-    let normal: vec4<f32> = aOrigVertexBuffer[iVertexIndex].mNormal;
+    let normal: vec4<f32> = vec4<f32>(decodeOctahedralNormal(unpack2x16snorm(packedVertex.miNormal)), 1.0f);
     let skinnedNormal: vec4<f32> = 
         normal * xformMatrix0 * afJointInfluenceWeight[0] +
         normal * xformMatrix1 * afJointInfluenceWeight[1] + 
@@ -144,9 +168,11 @@ fn cs_main(
         normal * xformMatrix3 * afJointInfluenceWeight[3];
 
     // save out
-    aXFormVertices[iOutputVertexIndex].mPosition = skinnedPos;
-    aXFormVertices[iOutputVertexIndex].mNormal = skinnedNormal;
-    aXFormVertices[iOutputVertexIndex].mTexCoord = aOrigVertexBuffer[iVertexIndex].mTexCoord;
+    aXFormVertices[iOutputVertexIndex].mfPositionX = skinnedPos.x;
+    aXFormVertices[iOutputVertexIndex].mfPositionY = skinnedPos.y;
+    aXFormVertices[iOutputVertexIndex].mfPositionZ = skinnedPos.z;
+    aXFormVertices[iOutputVertexIndex].miNormal = pack2x16snorm(encodeOctahedralNormal(skinnedNormal.xyz));
+    aXFormVertices[iOutputVertexIndex].miTexCoord = packedVertex.miTexCoord;
 }
 
 
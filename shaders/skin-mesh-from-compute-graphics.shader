@@ -1,31 +1,7 @@
-const PI: f32 = 3.14159f;
-
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
+#include "include/default-uniform-data.shader"
+#include "include/mesh-extent.shader"
 
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
+const PI: f32 = 3.14159f;
 
 struct Material
 {
@@ -45,12 +21,6 @@ struct Range
     miEnd: i32
 };
 
-struct MeshExtent
-{
-    mMinPosition: vec4<f32>,
-    mMaxPosition: vec4<f32>,
-};
-
 struct SelectMeshInfo
 {
     miMeshID: u32,
@@ -78,11 +48,13 @@ struct AnimMeshModelUniform
     mExtraInfo: vec4<f32>,
 };
 
-struct Vertex
+struct SkinnedVertex
 {
-    mPosition: vec4<f32>,
-    mTexCoord: vec4<f32>,
-    mNormal: vec4<f32>,
+    mfPositionX: f32,
+    mfPositionY: f32,
+    mfPositionZ: f32,
+    miNormal: u32,
+    miTexCoord: u32,
 };
 
 struct MeshVertexRange
@@ -92,7 +64,7 @@ struct MeshVertexRange
 };
 
 @group(0) @binding(0)
-var<storage, read> previousSkinMeshVertices: array<Vertex>;
+var<storage, read> previousSkinMeshVertices: array<SkinnedVertex>;
 
 @group(1) @binding(0)
 var<storage> aMaterials: array<Material>;
@@ -118,11 +90,12 @@ var textureSampler: sampler;
 @group(2) @binding(0)
 var<storage> animMeshUniformBuffer: AnimMeshModelUniform;
 
+// SkinnedVertex written by skin-mesh-compute.shader
 struct VertexInput 
 {
-    @location(0) worldPosition : vec4<f32>,
-    @location(1) texCoord: vec4<f32>,
-    @location(2) normal : vec4<f32>
+    @location(0) worldPosition : vec3<f32>,
+    @location(1) normal : vec2<f32>,
+    @location(2) texCoord: vec2<f32>
 };
 struct VertexOutput 
 {
@@ -142,6 +115,18 @@ struct FragmentOutput
     @location(5) mMask: vec4<f32>,
 };
 
+/*
+**
+*/
+fn decodeOctahedralNormal(encoded: vec2<f32>) -> vec3<f32>
+{
+    var normal: vec3<f32> = vec3<f32>(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    let fT: f32 = max(-normal.z, 0.0f);
+    normal.x += select(fT, -fT, normal.x >= 0.0f);
+    normal.y += select(fT, -fT, normal.y >= 0.0f);
+    return normalize(normal);
+}
+
 @vertex
 fn vs_main(in: VertexInput,
     @builtin(vertex_index) iVertexIndex: u32,
@@ -157,7 +142,7 @@ fn vs_main(in: VertexInput,
     rotationMatrix[0][3] = 0.0f;
     rotationMatrix[1][3] = 0.0f;
     rotationMatrix[2][3] = 0.0f;
-    var normal: vec4<f32> = in.normal * rotationMatrix;
+    var normal: vec4<f32> = vec4<f32>(decodeOctahedralNormal(in.normal), 1.0f) * rotationMatrix;
 
     out.pos = vec4<f32>(in.worldPosition.xyz * 10.0f, 1.0f) * totalMatrix;
     out.worldPosition = vec4<f32>(in.worldPosition.xyz * 10.0f, 1.0f) * animMeshMatrix;
@@ -166,7 +151,8 @@ fn vs_main(in: VertexInput,
 
     let iVertexRange: u32 = aMeshVertexRanges[iInstanceIndex].miStart;
 
-    let prevVertexPosition: vec4<f32> = vec4<f32>(previousSkinMeshVertices[iVertexIndex].mPosition.xyz * 10.0f, 1.0f) * animMeshMatrix;
+    let prevVertex: SkinnedVertex = previousSkinMeshVertices[iVertexIndex];
+    let prevVertexPosition: vec4<f32> = vec4<f32>(vec3<f32>(prevVertex.mfPositionX, prevVertex.mfPositionY, prevVertex.mfPositionZ) * 10.0f, 1.0f) * animMeshMatrix;
     out.prevVertexPosition = prevVertexPosition;
 
     return out;
@@ -216,7 +202,8 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
     // store depth and mesh id in worldPosition.w
     out.worldPosition.w = clamp(in.pos.z, 0.0f, 0.999f) + floor(in.worldPosition.w + 0.5f);
 
-    let currClipSpace: vec4<f32> = vec4<f32>(in.worldPosition.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
+    // without the jitter, the motion is of the surface and not of the samples
+    let currClipSpace: vec4<f32> = vec4<f32>(in.worldPosition.xyz, 1.0f) * defaultUniformBuffer.mViewProjectionMatrix;
     let prevClipSpace: vec4<f32> = vec4<f32>(in.prevVertexPosition.xyz, 1.0f) * defaultUniformBuffer.mPrevViewProjectionMatrix;
 
     var currClipSpacePos: vec3<f32> = vec3<f32>(
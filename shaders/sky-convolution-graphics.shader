@@ -1,3 +1,5 @@
+#include "include/default-uniform-data.shader"
+
 const UINT32_MAX: u32 = 1000000;
 const FLT_MAX: f32 = 1.0e+10;
 const PI: f32 = 3.14159f;
@@ -44,33 +46,6 @@ struct SVGFFilterResult
     mMoments: vec3<f32>,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 @group(0) @binding(0)
 var skyTexture: texture_2d<f32>;
 
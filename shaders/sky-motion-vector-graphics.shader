@@ -1,36 +1,9 @@
+#include "include/default-uniform-data.shader"
+
 const MAX_STEPS: i32 = 20;
 const DENSITY_MIN: f32 = -1.0f;
 const DENSITY_MAX: f32 = 1.0f;
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-
-    mInverseViewProjectionMatrix: mat4x4<f32>,
-};
-
 struct VertexInput 
 {
     @location(0) pos : vec4<f32>,
@@ -63,7 +36,8 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
     var output: VertexOutput;
     output.pos = vec4f(pos[i], 0.0f, 1.0f);
-    output.uv = uv[i];        
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
 
     return output;
 }
@@ -79,6 +53,7 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
         i32(in.uv.x * f32(textureSize.x)),
         i32(in.uv.y * f32(textureSize.y))
     );
+    let screenUV: vec2<f32> = in.uv.xy / defaultUniformBuffer.mRenderScale.xy;
     let albedo: vec4<f32> = textureLoad(
         albedoTexture,
         screenCoord,
@@ -87,7 +62,7 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
 
     if(albedo.w <= 0.0f)
     {
-        var clipSpacePos: vec3<f32> = vec3<f32>(in.uv.xy * 2.0f - 1.0f, 1.0f);
+        var clipSpacePos: vec3<f32> = vec3<f32>(screenUV * 2.0f - 1.0f, 1.0f);
         clipSpacePos.y *= -1.0f;
         
         var worldPosition: vec4<f32> = vec4<f32>(clipSpacePos.xyz, 1.0f) * defaultUniformBuffer.mInverseViewProjectionMatrix;
@@ -96,7 +71,7 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
         worldPosition.y *= fOneOverW;
         worldPosition.z *= fOneOverW;
 
-        var currClipSpace: vec4<f32> = vec4<f32>(worldPosition.xyz, 1.0f) * defaultUniformBuffer.mJitteredViewProjectionMatrix;
+        var currClipSpace: vec4<f32> = vec4<f32>(worldPosition.xyz, 1.0f) * defaultUniformBuffer.mViewProjectionMatrix;
         var prevClipSpace: vec4<f32> = vec4<f32>(worldPosition.xyz, 1.0f) * defaultUniformBuffer.mPrevViewProjectionMatrix;
 
         let fCurrOneOverW: f32 = 1.0f / currClipSpace.w;
@@ -108,9 +83,10 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
         prevClipSpace.y *= fPrevOneOverW;
         prevClipSpace.z *= fPrevOneOverW;
 
+        // in screen uv like the motion vectors of the meshes
         output.mMotionVector = vec4<f32>(
-            prevClipSpace.x - currClipSpace.x,
-            prevClipSpace.y - currClipSpace.y,
+            (prevClipSpace.x - currClipSpace.x) * 0.5f,
+            (currClipSpace.y - prevClipSpace.y) * 0.5f,
             0.0f,
             1.0f
         );
@@ -1,33 +1,8 @@
+#include "include/default-uniform-data.shader"
+
 const FLT_MAX: f32 = 1000000.0f;
 const NUM_HISTORY: f32 = 20.0f;
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 @group(0) @binding(0) 
 var worldPositionTexture: texture_2d<f32>;
 
@@ -69,101 +44,92 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     return output;
 }
 
+/*
+** takes the jittered samples of the jobs drawn at the render scale up to the output size. the render pixels around
+** the output pixel are weighted by their distance to it, a sample at render pixel i was taken at i + 0.5 - jitter in
+** render pixels. the history of the output pixel is clamped to the neighbourhood of the samples and gets less of the
+** current samples the farther away they are, all of them when it came from off the screen
+*/
 @fragment
 fn fs_main(in: VertexOutput) -> FragmentOutput 
 {
     var out: FragmentOutput;
 
-    let textureSize: vec2<u32> = textureDimensions(radianceTexture);
-    let fOneOverWidth: f32 = 1.0f / f32(textureSize.x);
-    let fOneOverHeight: f32 = 1.0f / f32(textureSize.y);
+    let outputSize: vec2<f32> = vec2<f32>(textureDimensions(prevRadianceTexture));
+    let renderSize: vec2<f32> = vec2<f32>(textureDimensions(radianceTexture)) * defaultUniformBuffer.mRenderScale.xy;
+    let maxRenderCoord: vec2<i32> = vec2<i32>(renderSize + 0.5f) - 1;
 
-    let uv: vec2<f32> = vec2<f32>(
-        in.uv.x,
-        in.uv.y
-    );
+    // clip space y is up, texture y is down
+    let jitter: vec2<f32> = defaultUniformBuffer.mJitter.xy * vec2<f32>(0.5f, -0.5f) * renderSize;
+    let samplePosition: vec2<f32> = in.uv.xy * renderSize + jitter;
+    let centerCoord: vec2<i32> = vec2<i32>(floor(samplePosition));
 
-    var motionVector: vec4<f32> = textureSample(
-        motionVectorTexture,
-        textureSampler,
-        uv
-    );
-    //motionVector = motionVector * 2.0f - 1.0f;
-    let prevUV: vec2<f32> = uv.xy - motionVector.xy;
-
-    var iSampleSize: i32 = 1;
     var minRadiance: vec3<f32> = vec3<f32>(FLT_MAX, FLT_MAX, FLT_MAX);
     var maxRadiance: vec3<f32> = vec3<f32>(-FLT_MAX, -FLT_MAX, -FLT_MAX);
     var totalRadiance: vec3<f32> = vec3<f32>(0.0f, 0.0f, 0.0f);
-    var totalPrevRadiance: vec3<f32> = vec3<f32>(0.0f, 0.0f, 0.0f);
-    var fTotalPrevWeight: f32 = 0.0f;
-    for(var iY: i32 = -iSampleSize; iY <= iSampleSize; iY++)
+    var fTotalWeight: f32 = 0.0f;
+    var fMaxWeight: f32 = 0.0f;
+    for(var iY: i32 = -1; iY <= 1; iY++)
     {
-        for(var iX: i32 = -iSampleSize; iX <= iSampleSize; iX++)
+        for(var iX: i32 = -1; iX <= 1; iX++)
         {
-            let sampleScreenCoord: vec2<i32> = vec2<i32>(
-                i32(uv.x * f32(textureSize.x)) + iX,
-                i32(uv.y * f32(textureSize.y)) + iY
-            );
-
-            let offset: vec2<f32> = vec2<f32>(
-                f32(iX) * fOneOverWidth,
-                f32(iY) * fOneOverHeight
-            );
-
-            let sampleUV: vec2<f32> = uv + offset;
+            let sampleCoord: vec2<i32> = clamp(centerCoord + vec2<i32>(iX, iY), vec2<i32>(0, 0), maxRenderCoord);
             let sampleRadiance: vec3<f32> = textureLoad(
                 radianceTexture, 
-                sampleScreenCoord,
+                sampleCoord,
                 0
             ).xyz;
 
-            totalRadiance += sampleRadiance;
+            // gaussian close to blackman-harris over the distance in render pixels
+            let sampleDistance: vec2<f32> = vec2<f32>(sampleCoord) + 0.5f - samplePosition;
+            let fWeight: f32 = exp(-2.29f * dot(sampleDistance, sampleDistance));
+            totalRadiance += sampleRadiance * fWeight;
+            fTotalWeight += fWeight;
+            fMaxWeight = max(fMaxWeight, fWeight);
 
             minRadiance = min(sampleRadiance, minRadiance);
             maxRadiance = max(sampleRadiance, maxRadiance);
         }
     }
+    let radiance: vec3<f32> = totalRadiance / max(fTotalWeight, 1.0e-5f);
 
-    let screenCoord: vec2<i32> = vec2<i32>(
-        i32(uv.x * f32(textureSize.x)),
-        i32(uv.y * f32(textureSize.y))
-    );
-    let prevScreenCoord: vec2<i32> = vec2<i32>(
-        i32((uv.x + motionVector.x) * f32(textureSize.x)),
-        i32((uv.y + motionVector.y) * f32(textureSize.y))
-    );
-
-
-    let radiance: vec4<f32> = textureLoad(
+    let centerRadiance: vec4<f32> = textureLoad(
         radianceTexture,
-        screenCoord,
+        clamp(centerCoord, vec2<i32>(0, 0), maxRenderCoord),
+        0
+    );
+    let motionVector: vec4<f32> = textureLoad(
+        motionVectorTexture,
+        clamp(vec2<i32>(in.uv.xy * renderSize), vec2<i32>(0, 0), maxRenderCoord),
         0
     );
+
+    // the history is at the output size
+    let prevUV: vec2<f32> = in.uv.xy + motionVector.xy;
+    let prevScreenCoord: vec2<i32> = vec2<i32>(prevUV * outputSize);
     let prevRadiance: vec3<f32> = textureLoad(
         prevRadianceTexture,
-        prevScreenCoord,
+        clamp(prevScreenCoord, vec2<i32>(0, 0), vec2<i32>(outputSize) - 1),
         0
     ).xyz;
-    let fPadding: f32 = 0.03f;
-    //var lerpOutput: vec3<f32> = mix(
-    //    //clamp(prevRadiance, minRadiance, maxRadiance),
-    //    prevRadiance,
-    //    radiance.xyz,
-    //    (1.0f / NUM_HISTORY)
-    //);
-
     let clampedPrevRadiance: vec3<f32> = clamp(prevRadiance, minRadiance, maxRadiance);
 
-    let fOneOverNumHistory: f32 = 1.0f / NUM_HISTORY;
-    let lerpOutput: vec3<f32> = 
-        clampedPrevRadiance * (1.0f - fOneOverNumHistory) + 
-        radiance.xyz * fOneOverNumHistory;
+    var fBlend: f32 = min(fMaxWeight * 2.0f / NUM_HISTORY, 1.0f);
+    if(prevUV.x < 0.0f || prevUV.y < 0.0f || prevUV.x >= 1.0f || prevUV.y >= 1.0f)
+    {
+        fBlend = 1.0f;
+    }
+
+    let lerpOutput: vec3<f32> = mix(
+        clampedPrevRadiance,
+        radiance,
+        fBlend
+    );
         
     out.mOutput.x = lerpOutput.x;
     out.mOutput.y = lerpOutput.y;
     out.mOutput.z = lerpOutput.z;
-    out.mOutput.w = radiance.w;
+    out.mOutput.w = centerRadiance.w;
 
     return out;
 }
\ No newline at end of file
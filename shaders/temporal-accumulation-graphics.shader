@@ -1,3 +1,5 @@
+#include "include/default-uniform-data.shader"
+
 const UINT32_MAX: u32 = 1000000;
 const FLT_MAX: f32 = 1.0e+10;
 const PI: f32 = 3.14159f;
@@ -45,33 +47,6 @@ struct SVGFFilterResult
     mMoments: vec3<f32>,
 };
 
-struct DefaultUniformData
-{
-    miScreenWidth: i32,
-    miScreenHeight: i32,
-    miFrame: i32,
-    miNumMeshes: u32,
-
-    mfRand0: f32,
-    mfRand1: f32,
-    mfRand2: f32,
-    mfRand3: f32,
-
-    mViewProjectionMatrix: mat4x4<f32>,
-    mPrevViewProjectionMatrix: mat4x4<f32>,
-    mViewMatrix: mat4x4<f32>,
-    mProjectionMatrix: mat4x4<f32>,
-
-    mJitteredViewProjectionMatrix: mat4x4<f32>,
-    mPrevJitteredViewProjectionMatrix: mat4x4<f32>,
-
-    mCameraPosition: vec4<f32>,
-    mCameraLookDir: vec4<f32>,
-
-    mLightRadiance: vec4<f32>,
-    mLightDirection: vec4<f32>,
-};
-
 @group(0) @binding(0)
 var motionVectorTexture: texture_2d<f32>;
 
@@ -103,7 +78,8 @@ fn vs_main(@builtin(vertex_index) i : u32) -> VertexOutput
     const uv = array(vec2f(0, -1), vec2f(0, 1), vec2f(2, 1));
     var output: VertexOutput;
     output.pos = vec4f(pos[i], 0.0f, 1.0f);
-    output.uv = uv[i];        
+    // top left of the outputs at the render scale, "Dynamic Resolution" in the job list
+    output.uv = uv[i] * defaultUniformBuffer.mRenderScale.xy;
 
     return output;
 }
@@ -124,7 +100,8 @@ fn fs_main(in: VertexOutput) -> FragmentOutput
         screenCoord,
         0
     );
-    let backProjectedUV: vec2<f32> = in.uv.xy + motionVector.xy;
+    // the motion vector is in screen uv, the last frame was drawn at its own render scale
+    let backProjectedUV: vec2<f32> = (in.uv.xy / defaultUniformBuffer.mRenderScale.xy + motionVector.xy) * defaultUniformBuffer.mRenderScale.zw;
     let backProjectedScreenCoord: vec2<i32> = vec2<i32>(
         i32(backProjectedUV.x * f32(motionVectorTextureSize.x)),
         i32(backProjectedUV.y * f32(motionVectorTextureSize.y))
@@ -0,0 +1,373 @@
+#include "cook_cache.h"
+
+#include <cstring>
+#include <cinttypes>
+#include <filesystem>
+
+#include <utils/LogPrint.h>
+
+/*
+**
+*/
+bool CCookCache::init(std::string const& cacheDirectory)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mCacheDirectory = cacheDirectory;
+    maAssetKeys.clear();
+    mbDirty = false;
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(mCacheDirectory, errorCode);
+    if(!std::filesystem::is_directory(mCacheDirectory))
+    {
+        DEBUG_PRINTF("!!! can\'t create cook cache directory \"%s\" !!!\n", mCacheDirectory.c_str());
+        return false;
+    }
+
+    // asset name <tab> key
+    std::string indexFilePath = mCacheDirectory + "/index.txt";
+    FILE* fp = fopen(indexFilePath.c_str(), "rb");
+    if(fp)
+    {
+        char szLine[4096];
+        while(fgets(szLine, sizeof(szLine), fp))
+        {
+            char* pcTab = strrchr(szLine, '\t');
+            if(pcTab == nullptr)
+            {
+                continue;
+            }
+
+            *pcTab = '\0';
+            maAssetKeys[szLine] = strtoull(pcTab + 1, nullptr, 16);
+        }
+        fclose(fp);
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+void CCookCache::save()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if(!mbDirty)
+    {
+        return;
+    }
+
+    std::string indexFilePath = mCacheDirectory + "/index.txt";
+    FILE* fp = fopen(indexFilePath.c_str(), "wb");
+    if(fp == nullptr)
+    {
+        DEBUG_PRINTF("!!! can\'t write \"%s\" !!!\n", indexFilePath.c_str());
+        return;
+    }
+
+    for(auto const& keyValue : maAssetKeys)
+    {
+        fprintf(fp, "%s\t%016" PRIx64 "\n", keyValue.first.c_str(), keyValue.second);
+    }
+    fclose(fp);
+
+    mbDirty = false;
+}
+
+/*
+**
+*/
+uint64_t CCookCache::hashBytes(
+    void const* pData,
+    uint64_t iSize,
+    uint64_t iHash)
+{
+    // fnv-1a over 8 byte words with a fold of the high bits, then the remaining bytes
+    uint8_t const* pacData = (uint8_t const*)pData;
+    uint64_t iNumWords = iSize / sizeof(uint64_t);
+    for(uint64_t i = 0; i < iNumWords; i++)
+    {
+        uint64_t iWord = 0;
+        memcpy(&iWord, pacData + i * sizeof(uint64_t), sizeof(uint64_t));
+        iHash = (iHash ^ iWord) * 0x100000001b3ull;
+        iHash ^= (iHash >> 32);
+    }
+
+    for(uint64_t i = iNumWords * sizeof(uint64_t); i < iSize; i++)
+    {
+        iHash = (iHash ^ (uint64_t)pacData[i]) * 0x100000001b3ull;
+    }
+
+    return iHash;
+}
+
+/*
+**
+*/
+bool CCookCache::hashFile(
+    uint64_t& iHash,
+    std::string const& filePath)
+{
+    FILE* fp = fopen(filePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> acBuffer(1 << 20);
+    uint64_t iTotalSize = 0;
+    for(;;)
+    {
+        size_t iRead = fread(acBuffer.data(), 1, acBuffer.size(), fp);
+        if(iRead == 0)
+        {
+            break;
+        }
+
+        iHash = hashBytes(acBuffer.data(), iRead, iHash);
+        iTotalSize += iRead;
+    }
+    fclose(fp);
+
+    iHash = hashBytes(&iTotalSize, sizeof(iTotalSize), iHash);
+
+    return true;
+}
+
+/*
+**
+*/
+uint64_t CCookCache::computeKey(
+    std::vector<std::string> const& aSourceFilePaths,
+    std::string const& converterVersion,
+    std::string const& options)
+{
+    uint64_t iHash = hashBytes(converterVersion.c_str(), converterVersion.length());
+    iHash = hashBytes(options.c_str(), options.length(), iHash);
+    for(auto const& sourceFilePath : aSourceFilePaths)
+    {
+        // file name but not the directory, a moved asset folder still hits the cache
+        std::string fileName = std::filesystem::path(sourceFilePath).filename().string();
+        iHash = hashBytes(fileName.c_str(), fileName.length() + 1, iHash);
+        if(!hashFile(iHash, sourceFilePath))
+        {
+            DEBUG_PRINTF("!!! can\'t read source \"%s\" !!!\n", sourceFilePath.c_str());
+            return 0;
+        }
+    }
+
+    // 0 is reserved for failure
+    return (iHash == 0) ? 1 : iHash;
+}
+
+/*
+**
+*/
+CCookCache::Result CCookCache::lookup(
+    std::string const& assetName,
+    std::string const& outputDirectory,
+    uint64_t iKey)
+{
+    if(iKey == 0)
+    {
+        return RESULT_MISS;
+    }
+
+    std::vector<OutputFile> aOutputs;
+    if(!readObjectOutputs(aOutputs, iKey))
+    {
+        return RESULT_MISS;
+    }
+
+    // outputs on disk already came from this key
+    bool bRecorded = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto iter = maAssetKeys.find(assetName);
+        bRecorded = (iter != maAssetKeys.end() && iter->second == iKey);
+    }
+    if(bRecorded)
+    {
+        bool bOutputsIntact = true;
+        for(auto const& output : aOutputs)
+        {
+            std::string outputFilePath = outputDirectory + "/" + output.mFilePath;
+
+            std::error_code errorCode;
+            uint64_t iSize = (uint64_t)std::filesystem::file_size(outputFilePath, errorCode);
+            uint64_t iContentHash = 0xcbf29ce484222325ull;
+            if(errorCode || iSize != output.miSize || !hashFile(iContentHash, outputFilePath) || iContentHash != output.miContentHash)
+            {
+                bOutputsIntact = false;
+                break;
+            }
+        }
+
+        if(bOutputsIntact)
+        {
+            return RESULT_UP_TO_DATE;
+        }
+    }
+
+    // copy the cooked outputs back into the asset's output directory
+    std::string objectDirectory = getObjectDirectory(iKey);
+    for(uint32_t i = 0; i < (uint32_t)aOutputs.size(); i++)
+    {
+        std::filesystem::path outputPath = std::filesystem::path(outputDirectory) / aOutputs[i].mFilePath;
+        std::string cachedFilePath = objectDirectory + "/" + std::to_string(i) + "-" + outputPath.filename().string();
+
+        std::error_code errorCode;
+        if(outputPath.has_parent_path())
+        {
+            std::filesystem::create_directories(outputPath.parent_path(), errorCode);
+        }
+        std::filesystem::copy_file(cachedFilePath, outputPath, std::filesystem::copy_options::overwrite_existing, errorCode);
+        if(errorCode)
+        {
+            DEBUG_PRINTF("!!! can\'t restore \"%s\" from \"%s\": %s !!!\n",
+                outputPath.string().c_str(),
+                cachedFilePath.c_str(),
+                errorCode.message().c_str());
+            return RESULT_MISS;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        maAssetKeys[assetName] = iKey;
+        mbDirty = true;
+    }
+
+    return RESULT_RESTORED;
+}
+
+/*
+**
+*/
+bool CCookCache::store(
+    std::string const& assetName,
+    std::string const& outputDirectory,
+    uint64_t iKey,
+    std::vector<std::string> const& aOutputFilePaths)
+{
+    if(iKey == 0)
+    {
+        return false;
+    }
+
+    std::string objectDirectory = getObjectDirectory(iKey);
+    std::error_code errorCode;
+    std::filesystem::create_directories(objectDirectory, errorCode);
+
+    std::filesystem::path outputDirectoryPath = std::filesystem::absolute(outputDirectory, errorCode).lexically_normal();
+
+    std::vector<OutputFile> aOutputs;
+    for(uint32_t i = 0; i < (uint32_t)aOutputFilePaths.size(); i++)
+    {
+        std::filesystem::path outputPath = std::filesystem::absolute(aOutputFilePaths[i], errorCode).lexically_normal();
+        std::filesystem::path relativePath = outputPath.lexically_relative(outputDirectoryPath);
+        if(relativePath.empty() || *relativePath.begin() == "..")
+        {
+            DEBUG_PRINTF("!!! \"%s\" isn\'t in the output directory \"%s\" !!!\n",
+                aOutputFilePaths[i].c_str(),
+                outputDirectory.c_str());
+            return false;
+        }
+
+        std::string cachedFilePath = objectDirectory + "/" + std::to_string(i) + "-" + outputPath.filename().string();
+        std::filesystem::copy_file(outputPath, cachedFilePath, std::filesystem::copy_options::overwrite_existing, errorCode);
+        if(errorCode)
+        {
+            DEBUG_PRINTF("!!! can\'t cache \"%s\": %s !!!\n",
+                aOutputFilePaths[i].c_str(),
+                errorCode.message().c_str());
+            return false;
+        }
+
+        OutputFile output;
+        output.miSize = (uint64_t)std::filesystem::file_size(outputPath, errorCode);
+        output.miContentHash = 0xcbf29ce484222325ull;
+        hashFile(output.miContentHash, outputPath.string());
+        output.mFilePath = relativePath.generic_string();
+        aOutputs.push_back(output);
+    }
+
+    // written last so a partially stored object is never found
+    std::string outputListFilePath = objectDirectory + "/outputs.txt";
+    FILE* fp = fopen(outputListFilePath.c_str(), "wb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+    for(auto const& output : aOutputs)
+    {
+        fprintf(fp, "%" PRIu64 "\t%016" PRIx64 "\t%s\n", output.miSize, output.miContentHash, output.mFilePath.c_str());
+    }
+    fclose(fp);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        maAssetKeys[assetName] = iKey;
+        mbDirty = true;
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+std::string CCookCache::getObjectDirectory(uint64_t iKey) const
+{
+    char szKey[32];
+    snprintf(szKey, sizeof(szKey), "%016" PRIx64, iKey);
+
+    return mCacheDirectory + "/" + szKey;
+}
+
+/*
+**
+*/
+bool CCookCache::readObjectOutputs(
+    std::vector<OutputFile>& aOutputs,
+    uint64_t iKey) const
+{
+    std::string outputListFilePath = getObjectDirectory(iKey) + "/outputs.txt";
+    FILE* fp = fopen(outputListFilePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+
+    // size <tab> content hash <tab> path relative to the output directory
+    char szLine[4096];
+    while(fgets(szLine, sizeof(szLine), fp))
+    {
+        char* pcTab = strchr(szLine, '\t');
+        char* pcPathTab = (pcTab != nullptr) ? strchr(pcTab + 1, '\t') : nullptr;
+        if(pcPathTab == nullptr)
+        {
+            // written before the content hash, cook it again
+            aOutputs.clear();
+            break;
+        }
+
+        size_t iLength = strlen(pcPathTab + 1);
+        while(iLength > 0 && (pcPathTab[iLength] == '\n' || pcPathTab[iLength] == '\r'))
+        {
+            pcPathTab[iLength--] = '\0';
+        }
+
+        OutputFile output;
+        output.miSize = strtoull(szLine, nullptr, 10);
+        output.miContentHash = strtoull(pcTab + 1, nullptr, 16);
+        output.mFilePath = std::string(pcPathTab + 1);
+        aOutputs.push_back(output);
+    }
+    fclose(fp);
+
+    return aOutputs.size() > 0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/*
+** content addressed cache of cooked converter outputs
+**
+** key = hash(converter version, options, name and content of every source file)
+** the outputs cooked for a key are copied to <cache directory>/<key>/ so a source that is unchanged, or changed
+** back to something cooked before, gets its outputs restored instead of converted again
+**
+** <cache directory>/index.txt          asset name and the key its outputs on disk were cooked from
+** <cache directory>/<key>/outputs.txt  size, content hash and path of each output relative to the asset's output
+**                                      directory, stored next to it as <index>-<file name>
+**
+** outputs are restored into the output directory of the asset looked up, a moved or copied asset gets its own outputs
+*/
+class CCookCache
+{
+public:
+    enum Result
+    {
+        RESULT_UP_TO_DATE = 0,
+        RESULT_RESTORED,
+        RESULT_MISS,
+    };
+
+    struct OutputFile
+    {
+        uint64_t            miSize = 0;
+        uint64_t            miContentHash = 0;
+        std::string         mFilePath;
+    };
+
+public:
+    CCookCache() = default;
+    virtual ~CCookCache() = default;
+
+    bool init(std::string const& cacheDirectory);
+    void save();
+
+    static uint64_t hashBytes(
+        void const* pData,
+        uint64_t iSize,
+        uint64_t iHash = 0xcbf29ce484222325ull);
+
+    static bool hashFile(
+        uint64_t& iHash,
+        std::string const& filePath);
+
+    // 0 when a source file can't be read
+    uint64_t computeKey(
+        std::vector<std::string> const& aSourceFilePaths,
+        std::string const& converterVersion,
+        std::string const& options);
+
+    // RESULT_UP_TO_DATE when the outputs in outputDirectory are from this key, RESULT_RESTORED when they were copied back from the cache
+    Result lookup(
+        std::string const& assetName,
+        std::string const& outputDirectory,
+        uint64_t iKey);
+
+    // copy the freshly cooked outputs, all under outputDirectory, into the cache and record them for the asset
+    bool store(
+        std::string const& assetName,
+        std::string const& outputDirectory,
+        uint64_t iKey,
+        std::vector<std::string> const& aOutputFilePaths);
+
+protected:
+    std::string getObjectDirectory(uint64_t iKey) const;
+
+    bool readObjectOutputs(
+        std::vector<OutputFile>& aOutputs,
+        uint64_t iKey) const;
+
+protected:
+    std::mutex                              mMutex;
+    std::string                             mCacheDirectory;
+    std::map<std::string, uint64_t>         maAssetKeys;
+    bool                                    mbDirty = false;
+};
@@ -0,0 +1,409 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+/*
+**
+*/
+void CMeshOptimizer::buildAdjacency(
+    std::vector<uint32_t> const& aiIndices,
+    uint32_t iNumVertices)
+{
+    maiAdjacencyOffsets.assign(iNumVertices + 1, 0);
+    for(uint32_t iIndex : aiIndices)
+    {
+        ++maiAdjacencyOffsets[iIndex + 1];
+    }
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        maiAdjacencyOffsets[iVertex + 1] += maiAdjacencyOffsets[iVertex];
+    }
+
+    // counting sort of the triangles by vertex, offsets are shifted back by one entry after the fill
+    maiAdjacentTriangles.resize(aiIndices.size());
+    for(uint32_t i = 0; i < (uint32_t)aiIndices.size(); i++)
+    {
+        maiAdjacentTriangles[maiAdjacencyOffsets[aiIndices[i]]++] = i / 3;
+    }
+    for(uint32_t iVertex = iNumVertices; iVertex > 0; iVertex--)
+    {
+        maiAdjacencyOffsets[iVertex] = maiAdjacencyOffsets[iVertex - 1];
+    }
+    maiAdjacencyOffsets[0] = 0;
+}
+
+/*
+**
+*/
+uint32_t CMeshOptimizer::updateCache(
+    uint32_t const* paiTriangle,
+    uint32_t iCacheSize)
+{
+    uint32_t iNumMisses = 0;
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        uint32_t iVertex = paiTriangle[i];
+        if(miCacheTime - maiCacheTimestamps[iVertex] > iCacheSize)
+        {
+            maiCacheTimestamps[iVertex] = miCacheTime++;
+            ++iNumMisses;
+        }
+    }
+
+    return iNumMisses;
+}
+
+/*
+**
+*/
+void CMeshOptimizer::optimizeVertexCache(
+    std::vector<uint32_t>& aiIndices,
+    uint32_t iNumVertices,
+    uint32_t iCacheSize)
+{
+    assert(aiIndices.size() % 3 == 0);
+
+    uint32_t iNumTriangles = (uint32_t)(aiIndices.size() / 3);
+    maiHardClusterStarts.clear();
+    if(iNumTriangles == 0)
+    {
+        return;
+    }
+
+    buildAdjacency(aiIndices, iNumVertices);
+
+    // triangles left to emit per vertex
+    std::vector<uint32_t> aiLiveTriangles(iNumVertices);
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        aiLiveTriangles[iVertex] = maiAdjacencyOffsets[iVertex + 1] - maiAdjacencyOffsets[iVertex];
+    }
+
+    std::vector<bool> abEmitted(iNumTriangles, false);
+    std::vector<uint32_t> aiDeadEnds;
+    std::vector<uint32_t> aiCandidates;
+    std::vector<uint32_t> aiOutput;
+    aiOutput.reserve(aiIndices.size());
+
+    maiCacheTimestamps.assign(iNumVertices, 0);
+    miCacheTime = iCacheSize + 1;
+
+    uint32_t iCursor = 0;
+    uint32_t iFanVertex = aiIndices[0];
+    maiHardClusterStarts.push_back(0);
+    for(;;)
+    {
+        // emit the remaining triangles around the fan vertex
+        aiCandidates.clear();
+        for(uint32_t iAdjacent = maiAdjacencyOffsets[iFanVertex]; iAdjacent < maiAdjacencyOffsets[iFanVertex + 1]; iAdjacent++)
+        {
+            uint32_t iTriangle = maiAdjacentTriangles[iAdjacent];
+            if(abEmitted[iTriangle])
+            {
+                continue;
+            }
+
+            uint32_t const* paiTriangle = aiIndices.data() + iTriangle * 3;
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                uint32_t iVertex = paiTriangle[i];
+                aiOutput.push_back(iVertex);
+                aiDeadEnds.push_back(iVertex);
+                aiCandidates.push_back(iVertex);
+                --aiLiveTriangles[iVertex];
+                if(miCacheTime - maiCacheTimestamps[iVertex] > iCacheSize)
+                {
+                    maiCacheTimestamps[iVertex] = miCacheTime++;
+                }
+            }
+            abEmitted[iTriangle] = true;
+        }
+
+        // next fan is the candidate that stays in the cache the longest while it's being finished
+        uint32_t iNextVertex = UINT32_MAX;
+        int32_t iBestPriority = -1;
+        for(uint32_t iVertex : aiCandidates)
+        {
+            if(aiLiveTriangles[iVertex] == 0)
+            {
+                continue;
+            }
+
+            int32_t iPriority = 0;
+            uint32_t iAge = miCacheTime - maiCacheTimestamps[iVertex];
+            if(iAge + 2 * aiLiveTriangles[iVertex] <= iCacheSize)
+            {
+                iPriority = (int32_t)iAge;
+            }
+
+            if(iPriority > iBestPriority)
+            {
+                iBestPriority = iPriority;
+                iNextVertex = iVertex;
+            }
+        }
+
+        if(iNextVertex == UINT32_MAX)
+        {
+            // dead end, go back to a recently used vertex with triangles left or the next one in input order
+            while(!aiDeadEnds.empty() && iNextVertex == UINT32_MAX)
+            {
+                uint32_t iVertex = aiDeadEnds.back();
+                aiDeadEnds.pop_back();
+                if(aiLiveTriangles[iVertex] > 0)
+                {
+                    iNextVertex = iVertex;
+                }
+            }
+
+            while(iNextVertex == UINT32_MAX && iCursor < iNumVertices)
+            {
+                if(aiLiveTriangles[iCursor] > 0)
+                {
+                    iNextVertex = iCursor;
+                }
+                ++iCursor;
+            }
+
+            if(iNextVertex == UINT32_MAX)
+            {
+                break;
+            }
+
+            maiHardClusterStarts.push_back((uint32_t)(aiOutput.size() / 3));
+        }
+
+        iFanVertex = iNextVertex;
+    }
+
+    assert(aiOutput.size() == aiIndices.size());
+    aiIndices.swap(aiOutput);
+}
+
+/*
+**
+*/
+void CMeshOptimizer::optimizeOverdraw(
+    std::vector<uint32_t>& aiIndices,
+    float const* pafPositions,
+    uint32_t iPositionStride,
+    uint32_t iNumVertices,
+    float fThreshold,
+    uint32_t iCacheSize)
+{
+    uint32_t iNumTriangles = (uint32_t)(aiIndices.size() / 3);
+    if(iNumTriangles == 0)
+    {
+        return;
+    }
+
+    // hard clusters from the last vertex cache pass, the whole mesh otherwise
+    std::vector<uint32_t> aiHardClusterStarts = maiHardClusterStarts;
+    if(aiHardClusterStarts.empty() || aiHardClusterStarts.back() >= iNumTriangles)
+    {
+        aiHardClusterStarts.assign(1, 0);
+    }
+    aiHardClusterStarts.push_back(iNumTriangles);
+
+    maiCacheTimestamps.assign(iNumVertices, 0);
+    miCacheTime = iCacheSize + 1;
+
+    // split the hard clusters where the miss rate so far is close enough to the cluster's, cache starts cold in each
+    std::vector<uint32_t> aiClusterStarts;
+    for(uint32_t iHardCluster = 0; iHardCluster + 1 < (uint32_t)aiHardClusterStarts.size(); iHardCluster++)
+    {
+        uint32_t iStart = aiHardClusterStarts[iHardCluster];
+        uint32_t iEnd = aiHardClusterStarts[iHardCluster + 1];
+
+        miCacheTime += iCacheSize + 1;
+        uint32_t iNumClusterMisses = 0;
+        for(uint32_t iTriangle = iStart; iTriangle < iEnd; iTriangle++)
+        {
+            iNumClusterMisses += updateCache(aiIndices.data() + iTriangle * 3, iCacheSize);
+        }
+        float fMaxACMR = fThreshold * float(iNumClusterMisses) / float(iEnd - iStart);
+
+        miCacheTime += iCacheSize + 1;
+        uint32_t iClusterStart = iStart;
+        uint32_t iNumMisses = 0;
+        aiClusterStarts.push_back(iStart);
+        for(uint32_t iTriangle = iStart; iTriangle < iEnd; iTriangle++)
+        {
+            iNumMisses += updateCache(aiIndices.data() + iTriangle * 3, iCacheSize);
+            if(iTriangle + 1 < iEnd && float(iNumMisses) <= fMaxACMR * float(iTriangle + 1 - iClusterStart))
+            {
+                iClusterStart = iTriangle + 1;
+                iNumMisses = 0;
+                aiClusterStarts.push_back(iClusterStart);
+                miCacheTime += iCacheSize + 1;
+            }
+        }
+    }
+    aiClusterStarts.push_back(iNumTriangles);
+
+    uint32_t iNumClusters = (uint32_t)aiClusterStarts.size() - 1;
+    if(iNumClusters <= 1)
+    {
+        return;
+    }
+
+    // area weighted centroid and normal per cluster
+    auto getPosition = [&](uint32_t iVertex, uint32_t iComponent)
+        {
+            return pafPositions[(uint64_t)iVertex * iPositionStride + iComponent];
+        };
+
+    std::vector<float> afClusterCentroids(iNumClusters * 3, 0.0f);
+    std::vector<float> afClusterNormals(iNumClusters * 3, 0.0f);
+    std::vector<float> afClusterAreas(iNumClusters, 0.0f);
+    float afMeshCentroid[3] = {0.0f, 0.0f, 0.0f};
+    float fMeshArea = 0.0f;
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        for(uint32_t iTriangle = aiClusterStarts[iCluster]; iTriangle < aiClusterStarts[iCluster + 1]; iTriangle++)
+        {
+            uint32_t const* paiTriangle = aiIndices.data() + iTriangle * 3;
+            float afEdge0[3], afEdge1[3], afCenter[3];
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                float fP0 = getPosition(paiTriangle[0], i);
+                float fP1 = getPosition(paiTriangle[1], i);
+                float fP2 = getPosition(paiTriangle[2], i);
+                afEdge0[i] = fP1 - fP0;
+                afEdge1[i] = fP2 - fP0;
+                afCenter[i] = (fP0 + fP1 + fP2) / 3.0f;
+            }
+
+            float afNormal[3] =
+            {
+                afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1],
+                afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2],
+                afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0],
+            };
+            float fArea = sqrtf(afNormal[0] * afNormal[0] + afNormal[1] * afNormal[1] + afNormal[2] * afNormal[2]);
+
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                afClusterCentroids[iCluster * 3 + i] += afCenter[i] * fArea;
+                afClusterNormals[iCluster * 3 + i] += afNormal[i];
+                afMeshCentroid[i] += afCenter[i] * fArea;
+            }
+            afClusterAreas[iCluster] += fArea;
+            fMeshArea += fArea;
+        }
+    }
+
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        afMeshCentroid[i] = (fMeshArea > 0.0f) ? afMeshCentroid[i] / fMeshArea : 0.0f;
+    }
+
+    // clusters facing away from the center are more likely to be occluded by the ones facing towards it
+    std::vector<float> afSortKeys(iNumClusters);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        float* pfNormal = afClusterNormals.data() + iCluster * 3;
+        float fLength = sqrtf(pfNormal[0] * pfNormal[0] + pfNormal[1] * pfNormal[1] + pfNormal[2] * pfNormal[2]);
+        float fOneOverArea = (afClusterAreas[iCluster] > 0.0f) ? 1.0f / afClusterAreas[iCluster] : 0.0f;
+        float fOneOverLength = (fLength > 0.0f) ? 1.0f / fLength : 0.0f;
+
+        float fKey = 0.0f;
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            float fCentroid = afClusterCentroids[iCluster * 3 + i] * fOneOverArea;
+            fKey += (fCentroid - afMeshCentroid[i]) * pfNormal[i] * fOneOverLength;
+        }
+        afSortKeys[iCluster] = fKey;
+    }
+
+    std::vector<uint32_t> aiClusterOrder(iNumClusters);
+    for(uint32_t iCluster = 0; iCluster < iNumClusters; iCluster++)
+    {
+        aiClusterOrder[iCluster] = iCluster;
+    }
+    std::stable_sort(
+        aiClusterOrder.begin(),
+        aiClusterOrder.end(),
+        [&afSortKeys](uint32_t iLeft, uint32_t iRight)
+        {
+            return afSortKeys[iLeft] > afSortKeys[iRight];
+        });
+
+    std::vector<uint32_t> aiOutput;
+    aiOutput.reserve(aiIndices.size());
+    for(uint32_t iCluster : aiClusterOrder)
+    {
+        aiOutput.insert(
+            aiOutput.end(),
+            aiIndices.begin() + (uint64_t)aiClusterStarts[iCluster] * 3,
+            aiIndices.begin() + (uint64_t)aiClusterStarts[iCluster + 1] * 3);
+    }
+    aiIndices.swap(aiOutput);
+    maiHardClusterStarts.clear();
+}
+
+/*
+**
+*/
+void CMeshOptimizer::optimizeVertexFetch(
+    std::vector<uint32_t>& aiRemap,
+    std::vector<uint32_t>& aiIndices,
+    uint32_t iNumVertices)
+{
+    aiRemap.assign(iNumVertices, UINT32_MAX);
+
+    uint32_t iNextVertex = 0;
+    for(auto& iIndex : aiIndices)
+    {
+        if(aiRemap[iIndex] == UINT32_MAX)
+        {
+            aiRemap[iIndex] = iNextVertex++;
+        }
+        iIndex = aiRemap[iIndex];
+    }
+
+    for(auto& iNewIndex : aiRemap)
+    {
+        if(iNewIndex == UINT32_MAX)
+        {
+            iNewIndex = iNextVertex++;
+        }
+    }
+}
+
+/*
+**
+*/
+CMeshOptimizer::VertexCacheStats CMeshOptimizer::analyzeVertexCache(
+    std::vector<uint32_t> const& aiIndices,
+    uint32_t iNumVertices,
+    uint32_t iCacheSize)
+{
+    VertexCacheStats stats;
+    stats.miNumTriangles = (uint32_t)(aiIndices.size() / 3);
+
+    maiCacheTimestamps.assign(iNumVertices, 0);
+    miCacheTime = iCacheSize + 1;
+
+    std::vector<bool> abReferenced(iNumVertices, false);
+    for(uint32_t iTriangle = 0; iTriangle < stats.miNumTriangles; iTriangle++)
+    {
+        uint32_t const* paiTriangle = aiIndices.data() + iTriangle * 3;
+        stats.miNumTransformed += updateCache(paiTriangle, iCacheSize);
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            if(!abReferenced[paiTriangle[i]])
+            {
+                abReferenced[paiTriangle[i]] = true;
+                ++stats.miNumVertices;
+            }
+        }
+    }
+
+    stats.mfACMR = (stats.miNumTriangles > 0) ? float(stats.miNumTransformed) / float(stats.miNumTriangles) : 0.0f;
+    stats.mfATVR = (stats.miNumVertices > 0) ? float(stats.miNumTransformed) / float(stats.miNumVertices) : 0.0f;
+
+    return stats;
+}
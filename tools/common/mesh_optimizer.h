@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#define MESH_OPTIMIZER_CACHE_SIZE           16
+#define MESH_OPTIMIZER_OVERDRAW_THRESHOLD   1.05f
+
+/*
+** index and vertex order optimization for cooked meshes, shared by the converters
+**
+** optimizeVertexCache  tipsify (sander, nehab, barczak 2007), fans around the most recently cached vertex and
+**                      jumps to a dead end vertex or the next unfinished one when the fan runs out
+** optimizeOverdraw     cuts the tipsify order into clusters at its jumps and again wherever the cache miss rate
+**                      so far is within the threshold of the cluster's, then sorts the clusters to draw the ones
+**                      facing away from the mesh center first. the miss rate grows by at most the threshold
+** optimizeVertexFetch  renumbers the vertices in the order the triangles first use them, the vertex data is moved
+**                      with remapVertices
+** analyzeVertexCache   fifo cache simulation, acmr = transformed vertices per triangle, atvr = per vertex (1 is best)
+**
+** indices are per mesh, 0 to iNumVertices - 1. an instance keeps scratch memory between calls, use one per thread
+*/
+class CMeshOptimizer
+{
+public:
+    struct VertexCacheStats
+    {
+        uint32_t            miNumTriangles = 0;
+        uint32_t            miNumVertices = 0;          // referenced by the triangles
+        uint32_t            miNumTransformed = 0;       // cache misses
+        float               mfACMR = 0.0f;
+        float               mfATVR = 0.0f;
+    };
+
+public:
+    CMeshOptimizer() = default;
+    virtual ~CMeshOptimizer() = default;
+
+    void optimizeVertexCache(
+        std::vector<uint32_t>& aiIndices,
+        uint32_t iNumVertices,
+        uint32_t iCacheSize = MESH_OPTIMIZER_CACHE_SIZE);
+
+    // pafPositions: xyz at every iPositionStride floats, run after optimizeVertexCache
+    void optimizeOverdraw(
+        std::vector<uint32_t>& aiIndices,
+        float const* pafPositions,
+        uint32_t iPositionStride,
+        uint32_t iNumVertices,
+        float fThreshold = MESH_OPTIMIZER_OVERDRAW_THRESHOLD,
+        uint32_t iCacheSize = MESH_OPTIMIZER_CACHE_SIZE);
+
+    // aiRemap: new index of each old vertex, unreferenced vertices go after the referenced ones
+    void optimizeVertexFetch(
+        std::vector<uint32_t>& aiRemap,
+        std::vector<uint32_t>& aiIndices,
+        uint32_t iNumVertices);
+
+    VertexCacheStats analyzeVertexCache(
+        std::vector<uint32_t> const& aiIndices,
+        uint32_t iNumVertices,
+        uint32_t iCacheSize = MESH_OPTIMIZER_CACHE_SIZE);
+
+    // moves iNumElementsPerVertex elements of every vertex to its remapped position
+    template<typename T>
+    static void remapVertices(
+        std::vector<T>& aVertices,
+        std::vector<uint32_t> const& aiRemap,
+        uint32_t iNumElementsPerVertex = 1)
+    {
+        std::vector<T> aRemapped(aVertices.size());
+        for(uint32_t iVertex = 0; iVertex < (uint32_t)aiRemap.size(); iVertex++)
+        {
+            for(uint32_t iElement = 0; iElement < iNumElementsPerVertex; iElement++)
+            {
+                aRemapped[(uint64_t)aiRemap[iVertex] * iNumElementsPerVertex + iElement] =
+                    aVertices[(uint64_t)iVertex * iNumElementsPerVertex + iElement];
+            }
+        }
+        aVertices.swap(aRemapped);
+    }
+
+protected:
+    void buildAdjacency(
+        std::vector<uint32_t> const& aiIndices,
+        uint32_t iNumVertices);
+
+    // number of vertices of the triangle that missed the cache
+    uint32_t updateCache(
+        uint32_t const* paiTriangle,
+        uint32_t iCacheSize);
+
+protected:
+    // vertex to triangle adjacency, triangles of vertex v are maiAdjacentTriangles[maiAdjacencyOffsets[v] ...]
+    std::vector<uint32_t>       maiAdjacencyOffsets;
+    std::vector<uint32_t>       maiAdjacentTriangles;
+
+    // triangle index where each hard cluster of the last optimizeVertexCache starts
+    std::vector<uint32_t>       maiHardClusterStarts;
+
+    // fifo simulation, miCacheTime is bumped for every vertex put in the cache
+    std::vector<uint32_t>       maiCacheTimestamps;
+    uint32_t                    miCacheTime = 0;
+};
@@ -0,0 +1,614 @@
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+// open edge planes against the area weighted triangle planes, higher keeps borders straighter
+#define MESH_SIMPLIFIER_BORDER_WEIGHT       2.0
+
+// sign, exponent and 2 mantissa bits of the collapse costs, costs are positive so the sign bucket is never used
+#define MESH_SIMPLIFIER_SORT_BITS           11
+#define MESH_SIMPLIFIER_SORT_BUCKETS        (1 << MESH_SIMPLIFIER_SORT_BITS)
+
+/*
+**
+*/
+void CMeshSimplifier::init(
+    std::vector<uint32_t> const& aiIndices,
+    float const* pafPositions,
+    uint32_t iPositionStride,
+    uint32_t iNumVertices)
+{
+    assert(aiIndices.size() % 3 == 0);
+
+    mpafPositions = pafPositions;
+    miPositionStride = iPositionStride;
+    miNumVertices = iNumVertices;
+    mfError = 0.0f;
+
+    weldPositions();
+
+    // triangles that are already degenerate go first, they would only get in the way of the topology checks
+    maiIndices.clear();
+    maiIndices.reserve(aiIndices.size());
+    for(uint32_t i = 0; i < (uint32_t)aiIndices.size(); i += 3)
+    {
+        uint32_t iPosition0 = maiVertexPositions[aiIndices[i]];
+        uint32_t iPosition1 = maiVertexPositions[aiIndices[i + 1]];
+        uint32_t iPosition2 = maiVertexPositions[aiIndices[i + 2]];
+        if(iPosition0 != iPosition1 && iPosition0 != iPosition2 && iPosition1 != iPosition2)
+        {
+            maiIndices.insert(maiIndices.end(), aiIndices.begin() + i, aiIndices.begin() + i + 3);
+        }
+    }
+
+    maiVertexRemap.resize(iNumVertices);
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        maiVertexRemap[iVertex] = iVertex;
+    }
+
+    uint32_t iNumPositions = (uint32_t)maiPositionVertices.size();
+    macPositionFlags.assign(iNumPositions, 0);
+    maiPositionStamps.assign(iNumPositions, 0);
+    miCurrStamp = 0;
+    maiNeighbourStamps.assign(iNumPositions, 0);
+    miNeighbourStamp = 0;
+
+    classifyPositions();
+    computeQuadrics();
+}
+
+/*
+**
+*/
+float CMeshSimplifier::simplify(
+    uint32_t iTargetNumIndices,
+    float fMaxError)
+{
+    double fMaxCost = (double)fMaxError * (double)fMaxError;
+    while(maiIndices.size() > iTargetNumIndices)
+    {
+        buildAdjacency();
+
+        // every directed edge of the triangles collapses its start onto its end, the other direction of an inside
+        // edge comes from the triangle across it. open edges only go one way
+        maCollapses.clear();
+        for(uint32_t i = 0; i < (uint32_t)maiIndices.size(); i++)
+        {
+            uint32_t iFrom = maiVertexPositions[maiIndices[i]];
+            uint32_t iTo = maiVertexPositions[maiIndices[(i % 3 == 2) ? i - 2 : i + 1]];
+            if(macPositionFlags[iFrom] & POSITION_LOCKED)
+            {
+                continue;
+            }
+
+            double fWeight = maQuadrics[iFrom].mfWeight + maQuadrics[iTo].mfWeight;
+            double fCost = (evaluate(maQuadrics[iFrom], getPosition(iTo)) + evaluate(maQuadrics[iTo], getPosition(iTo))) / std::max(fWeight, 1.0e-30);
+            if(fCost <= fMaxCost)
+            {
+                maCollapses.push_back({iFrom, iTo, (float)fCost});
+            }
+        }
+
+        sortCollapses();
+
+        // positions around a collapse are touched for the rest of the pass, the checks of the ones after it
+        // were done on the triangles from before
+        uint32_t iNumTrianglesToRemove = (uint32_t)(maiIndices.size() - iTargetNumIndices + 2) / 3;
+        uint32_t iNumTrianglesRemoved = 0;
+        uint32_t iNumCollapses = 0;
+        ++miCurrStamp;
+        for(uint32_t iCollapse : maiCollapseOrder)
+        {
+            Collapse const& collapse = maCollapses[iCollapse];
+            if(iNumTrianglesRemoved >= iNumTrianglesToRemove)
+            {
+                break;
+            }
+
+            if(maiPositionStamps[collapse.miFrom] == miCurrStamp ||
+                maiPositionStamps[collapse.miTo] == miCurrStamp ||
+                !canCollapse(collapse.miFrom, collapse.miTo))
+            {
+                continue;
+            }
+
+            for(uint32_t i = 0; i < (uint32_t)maiCollapseVertices.size(); i += 2)
+            {
+                maiVertexRemap[maiCollapseVertices[i]] = maiCollapseVertices[i + 1];
+            }
+
+            Quadric& to = maQuadrics[collapse.miTo];
+            Quadric const& from = maQuadrics[collapse.miFrom];
+            for(uint32_t i = 0; i < 10; i++)
+            {
+                to.mafA[i] += from.mafA[i];
+            }
+            to.mfWeight += from.mfWeight;
+
+            for(uint32_t iAdjacency = maiAdjacencyOffsets[collapse.miFrom]; iAdjacency < maiAdjacencyOffsets[collapse.miFrom + 1]; iAdjacency++)
+            {
+                uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+                bool bHasTo = false;
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    uint32_t iPosition = maiVertexPositions[paiTriangle[i]];
+                    maiPositionStamps[iPosition] = miCurrStamp;
+                    bHasTo = bHasTo || (iPosition == collapse.miTo);
+                }
+                iNumTrianglesRemoved += bHasTo ? 1 : 0;
+            }
+
+            mfError = std::max(mfError, sqrtf(collapse.mfCost));
+            ++iNumCollapses;
+        }
+
+        if(iNumCollapses == 0)
+        {
+            break;
+        }
+
+        // collapsed vertices move to their targets, the triangles across the collapsed edges are gone
+        uint32_t iNumIndices = 0;
+        for(uint32_t i = 0; i < (uint32_t)maiIndices.size(); i += 3)
+        {
+            uint32_t aiTriangle[3] =
+            {
+                maiVertexRemap[maiIndices[i]],
+                maiVertexRemap[maiIndices[i + 1]],
+                maiVertexRemap[maiIndices[i + 2]],
+            };
+            uint32_t iPosition0 = maiVertexPositions[aiTriangle[0]];
+            uint32_t iPosition1 = maiVertexPositions[aiTriangle[1]];
+            uint32_t iPosition2 = maiVertexPositions[aiTriangle[2]];
+            if(iPosition0 == iPosition1 || iPosition0 == iPosition2 || iPosition1 == iPosition2)
+            {
+                continue;
+            }
+
+            maiIndices[iNumIndices++] = aiTriangle[0];
+            maiIndices[iNumIndices++] = aiTriangle[1];
+            maiIndices[iNumIndices++] = aiTriangle[2];
+        }
+        maiIndices.resize(iNumIndices);
+    }
+
+    return mfError;
+}
+
+/*
+** counting sort on the top bits of the costs, the exponent and 2 bits of mantissa. costs within 25% of each other
+** keep the triangle order, which is as good as exact for picking the cheap collapses and a lot faster
+*/
+void CMeshSimplifier::sortCollapses()
+{
+    uint32_t aiBucketStarts[MESH_SIMPLIFIER_SORT_BUCKETS + 1] = {};
+    auto getBucket = [](float fCost)
+        {
+            uint32_t iBits = 0;
+            memcpy(&iBits, &fCost, sizeof(iBits));
+            return (iBits >> (32 - MESH_SIMPLIFIER_SORT_BITS)) & (MESH_SIMPLIFIER_SORT_BUCKETS - 1);
+        };
+
+    for(Collapse const& collapse : maCollapses)
+    {
+        ++aiBucketStarts[getBucket(collapse.mfCost) + 1];
+    }
+    for(uint32_t iBucket = 0; iBucket < MESH_SIMPLIFIER_SORT_BUCKETS; iBucket++)
+    {
+        aiBucketStarts[iBucket + 1] += aiBucketStarts[iBucket];
+    }
+
+    maiCollapseOrder.resize(maCollapses.size());
+    for(uint32_t iCollapse = 0; iCollapse < (uint32_t)maCollapses.size(); iCollapse++)
+    {
+        maiCollapseOrder[aiBucketStarts[getBucket(maCollapses[iCollapse].mfCost)]++] = iCollapse;
+    }
+}
+
+/*
+** vertices with bit exact positions share one, the sort keeps the lowest vertex of each first
+*/
+void CMeshSimplifier::weldPositions()
+{
+    std::vector<uint32_t> aiOrder(miNumVertices);
+    for(uint32_t iVertex = 0; iVertex < miNumVertices; iVertex++)
+    {
+        aiOrder[iVertex] = iVertex;
+    }
+
+    auto comparePositions = [&](uint32_t iLeft, uint32_t iRight)
+        {
+            return memcmp(
+                mpafPositions + (uint64_t)iLeft * miPositionStride,
+                mpafPositions + (uint64_t)iRight * miPositionStride,
+                sizeof(float) * 3);
+        };
+    std::sort(
+        aiOrder.begin(),
+        aiOrder.end(),
+        [&](uint32_t iLeft, uint32_t iRight)
+        {
+            int32_t iCompare = comparePositions(iLeft, iRight);
+            return (iCompare != 0) ? (iCompare < 0) : (iLeft < iRight);
+        });
+
+    maiVertexPositions.resize(miNumVertices);
+    maiPositionVertices.clear();
+    for(uint32_t i = 0; i < miNumVertices; i++)
+    {
+        if(i == 0 || comparePositions(aiOrder[i - 1], aiOrder[i]) != 0)
+        {
+            maiPositionVertices.push_back(aiOrder[i]);
+        }
+        maiVertexPositions[aiOrder[i]] = (uint32_t)maiPositionVertices.size() - 1;
+    }
+}
+
+/*
+** an edge without its opposite is open, one that shows up more than once in the same direction or has more than
+** one opposite is non-manifold. collapses keep the surface manifold, so this is only done for the full mesh
+*/
+void CMeshSimplifier::classifyPositions()
+{
+    maiEdges.clear();
+    maiEdges.reserve(maiIndices.size());
+    for(uint32_t i = 0; i < (uint32_t)maiIndices.size(); i++)
+    {
+        uint64_t iPosition0 = maiVertexPositions[maiIndices[i]];
+        uint64_t iPosition1 = maiVertexPositions[maiIndices[(i % 3 == 2) ? i - 2 : i + 1]];
+        maiEdges.push_back((iPosition0 << 32) | iPosition1);
+    }
+    std::sort(maiEdges.begin(), maiEdges.end());
+
+    for(uint32_t i = 0; i < (uint32_t)maiEdges.size(); i++)
+    {
+        uint32_t iPosition0 = (uint32_t)(maiEdges[i] >> 32);
+        uint32_t iPosition1 = (uint32_t)(maiEdges[i] & 0xffffffff);
+
+        uint64_t iOpposite = ((uint64_t)iPosition1 << 32) | iPosition0;
+        auto range = std::equal_range(maiEdges.begin(), maiEdges.end(), iOpposite);
+        uint8_t iFlag = 0;
+        if(range.first == range.second)
+        {
+            iFlag = POSITION_BORDER;
+        }
+        if(range.second - range.first > 1 || (i > 0 && maiEdges[i - 1] == maiEdges[i]))
+        {
+            iFlag = POSITION_LOCKED;
+        }
+
+        macPositionFlags[iPosition0] |= iFlag;
+        macPositionFlags[iPosition1] |= iFlag;
+    }
+}
+
+/*
+**
+*/
+void CMeshSimplifier::computeQuadrics()
+{
+    maQuadrics.assign(maiPositionVertices.size(), Quadric());
+    for(uint32_t i = 0; i < (uint32_t)maiIndices.size(); i += 3)
+    {
+        uint32_t aiPositions[3];
+        double aafPositions[3][3];
+        for(uint32_t iCorner = 0; iCorner < 3; iCorner++)
+        {
+            aiPositions[iCorner] = maiVertexPositions[maiIndices[i + iCorner]];
+            float const* pfPosition = getPosition(aiPositions[iCorner]);
+            for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+            {
+                aafPositions[iCorner][iAxis] = (double)pfPosition[iAxis];
+            }
+        }
+
+        double afEdge0[3], afEdge1[3];
+        for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+        {
+            afEdge0[iAxis] = aafPositions[1][iAxis] - aafPositions[0][iAxis];
+            afEdge1[iAxis] = aafPositions[2][iAxis] - aafPositions[0][iAxis];
+        }
+        double afNormal[3] =
+        {
+            afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1],
+            afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2],
+            afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0],
+        };
+        double fLength = sqrt(afNormal[0] * afNormal[0] + afNormal[1] * afNormal[1] + afNormal[2] * afNormal[2]);
+        if(fLength <= 0.0)
+        {
+            continue;
+        }
+        for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+        {
+            afNormal[iAxis] /= fLength;
+        }
+
+        double afPlane[4] =
+        {
+            afNormal[0],
+            afNormal[1],
+            afNormal[2],
+            -(afNormal[0] * aafPositions[0][0] + afNormal[1] * aafPositions[0][1] + afNormal[2] * aafPositions[0][2]),
+        };
+        for(uint32_t iCorner = 0; iCorner < 3; iCorner++)
+        {
+            addPlane(maQuadrics[aiPositions[iCorner]], afPlane, fLength * 0.5);
+        }
+
+        // plane through an open edge, perpendicular to the triangle
+        for(uint32_t iCorner = 0; iCorner < 3; iCorner++)
+        {
+            uint32_t iNext = (iCorner + 1) % 3;
+            if(!(macPositionFlags[aiPositions[iCorner]] & macPositionFlags[aiPositions[iNext]] & POSITION_BORDER) ||
+                !isOpenEdge(aiPositions[iCorner], aiPositions[iNext]))
+            {
+                continue;
+            }
+
+            double afEdge[3];
+            for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+            {
+                afEdge[iAxis] = aafPositions[iNext][iAxis] - aafPositions[iCorner][iAxis];
+            }
+            double fEdgeLengthSquared = afEdge[0] * afEdge[0] + afEdge[1] * afEdge[1] + afEdge[2] * afEdge[2];
+            double afBorderNormal[3] =
+            {
+                afEdge[1] * afNormal[2] - afEdge[2] * afNormal[1],
+                afEdge[2] * afNormal[0] - afEdge[0] * afNormal[2],
+                afEdge[0] * afNormal[1] - afEdge[1] * afNormal[0],
+            };
+            double fBorderLength = sqrt(afBorderNormal[0] * afBorderNormal[0] + afBorderNormal[1] * afBorderNormal[1] + afBorderNormal[2] * afBorderNormal[2]);
+            if(fBorderLength <= 0.0)
+            {
+                continue;
+            }
+
+            double afBorderPlane[4];
+            for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+            {
+                afBorderPlane[iAxis] = afBorderNormal[iAxis] / fBorderLength;
+            }
+            afBorderPlane[3] = -(afBorderPlane[0] * aafPositions[iCorner][0] + afBorderPlane[1] * aafPositions[iCorner][1] + afBorderPlane[2] * aafPositions[iCorner][2]);
+
+            addPlane(maQuadrics[aiPositions[iCorner]], afBorderPlane, fEdgeLengthSquared * MESH_SIMPLIFIER_BORDER_WEIGHT);
+            addPlane(maQuadrics[aiPositions[iNext]], afBorderPlane, fEdgeLengthSquared * MESH_SIMPLIFIER_BORDER_WEIGHT);
+        }
+    }
+}
+
+/*
+**
+*/
+void CMeshSimplifier::buildAdjacency()
+{
+    uint32_t iNumPositions = (uint32_t)maiPositionVertices.size();
+    maiAdjacencyOffsets.assign(iNumPositions + 1, 0);
+    for(uint32_t iIndex : maiIndices)
+    {
+        ++maiAdjacencyOffsets[maiVertexPositions[iIndex] + 1];
+    }
+    for(uint32_t iPosition = 0; iPosition < iNumPositions; iPosition++)
+    {
+        maiAdjacencyOffsets[iPosition + 1] += maiAdjacencyOffsets[iPosition];
+    }
+
+    // counting sort like CMeshOptimizer::buildAdjacency
+    maiAdjacentTriangles.resize(maiIndices.size());
+    for(uint32_t i = 0; i < (uint32_t)maiIndices.size(); i++)
+    {
+        maiAdjacentTriangles[maiAdjacencyOffsets[maiVertexPositions[maiIndices[i]]]++] = i / 3;
+    }
+    for(uint32_t iPosition = iNumPositions; iPosition > 0; iPosition--)
+    {
+        maiAdjacencyOffsets[iPosition] = maiAdjacencyOffsets[iPosition - 1];
+    }
+    maiAdjacencyOffsets[0] = 0;
+}
+
+/*
+**
+*/
+bool CMeshSimplifier::isOpenEdge(
+    uint32_t iPosition0,
+    uint32_t iPosition1) const
+{
+    bool bForward = std::binary_search(maiEdges.begin(), maiEdges.end(), ((uint64_t)iPosition0 << 32) | iPosition1);
+    bool bBackward = std::binary_search(maiEdges.begin(), maiEdges.end(), ((uint64_t)iPosition1 << 32) | iPosition0);
+    return (bForward != bBackward);
+}
+
+/*
+**
+*/
+bool CMeshSimplifier::canCollapse(
+    uint32_t iFrom,
+    uint32_t iTo)
+{
+    if(macPositionFlags[iFrom] & POSITION_LOCKED)
+    {
+        return false;
+    }
+
+    uint32_t iAdjacencyStart = maiAdjacencyOffsets[iFrom];
+    uint32_t iAdjacencyEnd = maiAdjacencyOffsets[iFrom + 1];
+
+    // the triangles across the edge pair up the vertices on each side of a seam
+    maiCollapseVertices.clear();
+    uint32_t iNumEdgeTriangles = 0;
+    for(uint32_t iAdjacency = iAdjacencyStart; iAdjacency < iAdjacencyEnd; iAdjacency++)
+    {
+        uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+        uint32_t iFromVertex = UINT32_MAX, iToVertex = UINT32_MAX;
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t iPosition = maiVertexPositions[paiTriangle[i]];
+            iFromVertex = (iPosition == iFrom) ? paiTriangle[i] : iFromVertex;
+            iToVertex = (iPosition == iTo) ? paiTriangle[i] : iToVertex;
+        }
+        if(iToVertex == UINT32_MAX)
+        {
+            continue;
+        }
+
+        ++iNumEdgeTriangles;
+        bool bPaired = false;
+        for(uint32_t i = 0; i < (uint32_t)maiCollapseVertices.size(); i += 2)
+        {
+            bPaired = bPaired || (maiCollapseVertices[i] == iFromVertex);
+        }
+        if(!bPaired)
+        {
+            maiCollapseVertices.push_back(iFromVertex);
+            maiCollapseVertices.push_back(iToVertex);
+        }
+    }
+
+    // border positions only slide along an open edge, one with a single triangle
+    if((macPositionFlags[iFrom] & POSITION_BORDER) && iNumEdgeTriangles != 1)
+    {
+        return false;
+    }
+
+    // a vertex of the from position with no partner across the edge would take the other side's uvs and normal
+    for(uint32_t iAdjacency = iAdjacencyStart; iAdjacency < iAdjacencyEnd; iAdjacency++)
+    {
+        uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            if(maiVertexPositions[paiTriangle[i]] != iFrom)
+            {
+                continue;
+            }
+
+            bool bPaired = false;
+            for(uint32_t iPair = 0; iPair < (uint32_t)maiCollapseVertices.size(); iPair += 2)
+            {
+                bPaired = bPaired || (maiCollapseVertices[iPair] == paiTriangle[i]);
+            }
+            if(!bPaired)
+            {
+                return false;
+            }
+        }
+    }
+
+    // link condition, the only positions next to both ends are the third corners of the triangles across the edge,
+    // anything else would pinch the surface into a non-manifold edge
+    miNeighbourStamp += 2;
+    for(uint32_t iAdjacency = iAdjacencyStart; iAdjacency < iAdjacencyEnd; iAdjacency++)
+    {
+        uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            maiNeighbourStamps[maiVertexPositions[paiTriangle[i]]] = miNeighbourStamp;
+        }
+    }
+
+    uint32_t iNumSharedNeighbours = 0;
+    for(uint32_t iAdjacency = maiAdjacencyOffsets[iTo]; iAdjacency < maiAdjacencyOffsets[iTo + 1]; iAdjacency++)
+    {
+        uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t iPosition = maiVertexPositions[paiTriangle[i]];
+            if(iPosition != iFrom && iPosition != iTo && maiNeighbourStamps[iPosition] == miNeighbourStamp)
+            {
+                // counted once
+                maiNeighbourStamps[iPosition] = miNeighbourStamp + 1;
+                ++iNumSharedNeighbours;
+            }
+        }
+    }
+    if(iNumSharedNeighbours > iNumEdgeTriangles)
+    {
+        return false;
+    }
+
+    // the triangles that stay must not turn over
+    float const* pfTo = getPosition(iTo);
+    for(uint32_t iAdjacency = iAdjacencyStart; iAdjacency < iAdjacencyEnd; iAdjacency++)
+    {
+        uint32_t const* paiTriangle = &maiIndices[maiAdjacentTriangles[iAdjacency] * 3];
+        float const* apfBefore[3];
+        float const* apfAfter[3];
+        bool bHasTo = false;
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t iPosition = maiVertexPositions[paiTriangle[i]];
+            bHasTo = bHasTo || (iPosition == iTo);
+            apfBefore[i] = getPosition(iPosition);
+            apfAfter[i] = (iPosition == iFrom) ? pfTo : apfBefore[i];
+        }
+        if(bHasTo)
+        {
+            continue;
+        }
+
+        auto getNormal = [](double* afNormal, float const* const* apfCorners)
+            {
+                double afEdge0[3], afEdge1[3];
+                for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+                {
+                    afEdge0[iAxis] = (double)apfCorners[1][iAxis] - (double)apfCorners[0][iAxis];
+                    afEdge1[iAxis] = (double)apfCorners[2][iAxis] - (double)apfCorners[0][iAxis];
+                }
+                afNormal[0] = afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1];
+                afNormal[1] = afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2];
+                afNormal[2] = afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0];
+            };
+        double afBefore[3], afAfter[3];
+        getNormal(afBefore, apfBefore);
+        getNormal(afAfter, apfAfter);
+        if(afBefore[0] * afAfter[0] + afBefore[1] * afAfter[1] + afBefore[2] * afAfter[2] <= 0.0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+void CMeshSimplifier::addPlane(
+    Quadric& quadric,
+    double const* pafPlane,
+    double fWeight)
+{
+    double fA = pafPlane[0], fB = pafPlane[1], fC = pafPlane[2], fD = pafPlane[3];
+    quadric.mafA[0] += fWeight * fA * fA;
+    quadric.mafA[1] += fWeight * fA * fB;
+    quadric.mafA[2] += fWeight * fA * fC;
+    quadric.mafA[3] += fWeight * fA * fD;
+    quadric.mafA[4] += fWeight * fB * fB;
+    quadric.mafA[5] += fWeight * fB * fC;
+    quadric.mafA[6] += fWeight * fB * fD;
+    quadric.mafA[7] += fWeight * fC * fC;
+    quadric.mafA[8] += fWeight * fC * fD;
+    quadric.mafA[9] += fWeight * fD * fD;
+    quadric.mfWeight += fWeight;
+}
+
+/*
+** v^t Q v with v = (x, y, z, 1), the weighted sum of squared distances to the quadric's planes
+*/
+double CMeshSimplifier::evaluate(
+    Quadric const& quadric,
+    float const* pfPosition)
+{
+    double fX = pfPosition[0], fY = pfPosition[1], fZ = pfPosition[2];
+    double const* pafA = quadric.mafA;
+    double fResult =
+        pafA[0] * fX * fX + 2.0 * pafA[1] * fX * fY + 2.0 * pafA[2] * fX * fZ + 2.0 * pafA[3] * fX +
+        pafA[4] * fY * fY + 2.0 * pafA[5] * fY * fZ + 2.0 * pafA[6] * fY +
+        pafA[7] * fZ * fZ + 2.0 * pafA[8] * fZ +
+        pafA[9];
+
+    return std::max(fResult, 0.0);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+** quadric error metric simplification (garland, heckbert 1997) for the mesh levels of detail, shared by the converters
+**
+** quadrics     every position gets the area weighted plane quadrics of its triangles, open edges add a plane through
+**              the edge perpendicular to its triangle so borders keep their outline
+** collapses    edges collapse onto one of their existing vertices, so the levels are index lists over the full mesh's
+**              vertices. each pass buckets the candidate collapses by cost and takes the cheapest ones whose
+**              neighbourhoods don't overlap, until the target is reached or the cost goes over the error limit
+** topology     runs on welded positions, vertices split for uvs or normals collapse together only along their seam.
+**              border vertices only move along the border, non-manifold edges are locked. collapses that flip a
+**              triangle are skipped
+**
+** the error is the square root of the weighted mean squared distance to the original planes, in position units.
+** simplify continues from the previous call, so one init gives the whole chain of levels with errors measured
+** against the full mesh. an instance keeps scratch memory between calls, use one per thread
+*/
+class CMeshSimplifier
+{
+public:
+    CMeshSimplifier() = default;
+    virtual ~CMeshSimplifier() = default;
+
+    // indices are per mesh, 0 to iNumVertices - 1. pafPositions: xyz at every iPositionStride floats
+    void init(
+        std::vector<uint32_t> const& aiIndices,
+        float const* pafPositions,
+        uint32_t iPositionStride,
+        uint32_t iNumVertices);
+
+    // returns the error of the simplified mesh, which can stop above the target
+    float simplify(
+        uint32_t iTargetNumIndices,
+        float fMaxError);
+
+    std::vector<uint32_t> const& getIndices() const
+    {
+        return maiIndices;
+    }
+
+protected:
+    // symmetric 4x4, a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+    struct Quadric
+    {
+        double          mafA[10] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        double          mfWeight = 0.0;
+    };
+
+    struct Collapse
+    {
+        uint32_t        miFrom;                 // positions
+        uint32_t        miTo;
+        float           mfCost;                 // squared error
+    };
+
+    enum PositionFlags : uint8_t
+    {
+        POSITION_BORDER = 1,
+        POSITION_LOCKED = 2,
+    };
+
+    void weldPositions();
+
+    void classifyPositions();
+
+    void computeQuadrics();
+
+    // fills maiCollapseOrder with maCollapses from cheapest to most expensive
+    void sortCollapses();
+
+    void buildAdjacency();
+
+    bool isOpenEdge(
+        uint32_t iPosition0,
+        uint32_t iPosition1) const;
+
+    // fills maiCollapseVertices with the render vertex each of the from position's ones moves to
+    bool canCollapse(
+        uint32_t iFrom,
+        uint32_t iTo);
+
+    float const* getPosition(uint32_t iPosition) const
+    {
+        return mpafPositions + (uint64_t)maiPositionVertices[iPosition] * miPositionStride;
+    }
+
+    static void addPlane(
+        Quadric& quadric,
+        double const* pafPlane,
+        double fWeight);
+
+    static double evaluate(
+        Quadric const& quadric,
+        float const* pfPosition);
+
+protected:
+    std::vector<uint32_t>       maiIndices;
+    float const*                mpafPositions = nullptr;
+    uint32_t                    miPositionStride = 0;
+    uint32_t                    miNumVertices = 0;
+    float                       mfError = 0.0f;
+
+    // welded position per vertex, and one vertex per position to read it from
+    std::vector<uint32_t>       maiVertexPositions;
+    std::vector<uint32_t>       maiPositionVertices;
+    std::vector<uint8_t>        macPositionFlags;
+    std::vector<Quadric>        maQuadrics;
+
+    // directed edges of the full mesh between positions as from << 32 | to, sorted
+    std::vector<uint64_t>       maiEdges;
+
+    // position to triangle adjacency, triangles of position p are maiAdjacentTriangles[maiAdjacencyOffsets[p] ...]
+    std::vector<uint32_t>       maiAdjacencyOffsets;
+    std::vector<uint32_t>       maiAdjacentTriangles;
+
+    std::vector<Collapse>       maCollapses;
+    std::vector<uint32_t>       maiCollapseOrder;
+    std::vector<uint32_t>       maiVertexRemap;
+
+    // positions around the collapses of the current pass have its stamp
+    std::vector<uint32_t>       maiPositionStamps;
+    uint32_t                    miCurrStamp = 0;
+
+    // neighbours of the from position in the link condition check, shared ones are bumped to the next stamp
+    std::vector<uint32_t>       maiNeighbourStamps;
+    uint32_t                    miNeighbourStamp = 0;
+
+    // from, to vertex pairs of the collapse canCollapse checked last
+    std::vector<uint32_t>       maiCollapseVertices;
+};
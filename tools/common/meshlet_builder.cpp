@@ -0,0 +1,287 @@
+#include "meshlet_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// normals this close to or past 90 degrees from the axis leave no useful cone
+#define MESHLET_CONE_MIN_DP                 0.1f
+
+/*
+**
+*/
+static inline float dot3(float const* pfA, float const* pfB)
+{
+    return pfA[0] * pfB[0] + pfA[1] * pfB[1] + pfA[2] * pfB[2];
+}
+
+/*
+**
+*/
+void CMeshletBuilder::build(
+    std::vector<Render::Meshlet>& aMeshlets,
+    uint32_t const* paiIndices,
+    uint32_t iNumIndices,
+    uint32_t iIndexStart,
+    uint32_t iMesh,
+    float const* pafPositions,
+    uint32_t iPositionStride,
+    uint32_t iMaxVertices,
+    uint32_t iMaxTriangles)
+{
+    assert(iNumIndices % 3 == 0);
+    assert(iMaxVertices >= 3 && iMaxTriangles >= 1);
+
+    uint32_t iNumTriangles = iNumIndices / 3;
+    if(iNumTriangles == 0)
+    {
+        return;
+    }
+
+    uint32_t iMaxIndex = *std::max_element(paiIndices, paiIndices + iNumIndices);
+    if(maiVertexStamps.size() <= iMaxIndex)
+    {
+        maiVertexStamps.resize(iMaxIndex + 1, 0);
+    }
+
+    Render::Meshlet meshlet = {};
+    uint32_t iFirstTriangle = 0;
+    ++miCurrStamp;
+    maiMeshletVertices.clear();
+
+    auto finishMeshlet = [&]()
+        {
+            meshlet.miMesh = iMesh;
+            meshlet.miIndexStart = iIndexStart + iFirstTriangle * 3;
+            meshlet.miNumVertices = (uint32_t)maiMeshletVertices.size();
+            computeBounds(meshlet, paiIndices + iFirstTriangle * 3, pafPositions, iPositionStride);
+            aMeshlets.push_back(meshlet);
+        };
+
+    for(uint32_t iTriangle = 0; iTriangle < iNumTriangles; iTriangle++)
+    {
+        uint32_t const* paiTriangle = paiIndices + iTriangle * 3;
+
+        // corners not in the meshlet yet, repeated corners of degenerate triangles count once
+        auto countNewVertices = [&]()
+            {
+                uint32_t iNumNew = 0;
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    bool bRepeated = (i > 0 && paiTriangle[i] == paiTriangle[0]) || (i > 1 && paiTriangle[i] == paiTriangle[1]);
+                    if(!bRepeated && maiVertexStamps[paiTriangle[i]] != miCurrStamp)
+                    {
+                        ++iNumNew;
+                    }
+                }
+                return iNumNew;
+            };
+
+        uint32_t iNumNewVertices = countNewVertices();
+        if(meshlet.miNumTriangles > 0 &&
+            (maiMeshletVertices.size() + iNumNewVertices > iMaxVertices || meshlet.miNumTriangles + 1 > iMaxTriangles))
+        {
+            finishMeshlet();
+
+            meshlet = {};
+            iFirstTriangle = iTriangle;
+            ++miCurrStamp;
+            maiMeshletVertices.clear();
+        }
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t iVertex = paiTriangle[i];
+            if(maiVertexStamps[iVertex] != miCurrStamp)
+            {
+                maiVertexStamps[iVertex] = miCurrStamp;
+                maiMeshletVertices.push_back(iVertex);
+            }
+        }
+        ++meshlet.miNumTriangles;
+    }
+
+    finishMeshlet();
+}
+
+/*
+**
+*/
+void CMeshletBuilder::computeBounds(
+    Render::Meshlet& meshlet,
+    uint32_t const* paiIndices,
+    float const* pafPositions,
+    uint32_t iPositionStride)
+{
+    auto getPosition = [&](uint32_t iVertex)
+        {
+            return pafPositions + (uint64_t)iVertex * iPositionStride;
+        };
+
+    // farthest pair of the min and max vertices along x, y and z seeds the sphere
+    uint32_t aiMin[3], aiMax[3];
+    for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+    {
+        aiMin[iAxis] = aiMax[iAxis] = maiMeshletVertices[0];
+    }
+    for(uint32_t iVertex : maiMeshletVertices)
+    {
+        float const* pfPosition = getPosition(iVertex);
+        for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+        {
+            aiMin[iAxis] = (pfPosition[iAxis] < getPosition(aiMin[iAxis])[iAxis]) ? iVertex : aiMin[iAxis];
+            aiMax[iAxis] = (pfPosition[iAxis] > getPosition(aiMax[iAxis])[iAxis]) ? iVertex : aiMax[iAxis];
+        }
+    }
+
+    float fLargestDistanceSquared = -1.0f;
+    float afCenter[3] = {0.0f, 0.0f, 0.0f};
+    float fRadius = 0.0f;
+    for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+    {
+        float const* pfMin = getPosition(aiMin[iAxis]);
+        float const* pfMax = getPosition(aiMax[iAxis]);
+        float afDiff[3] = {pfMax[0] - pfMin[0], pfMax[1] - pfMin[1], pfMax[2] - pfMin[2]};
+        float fDistanceSquared = dot3(afDiff, afDiff);
+        if(fDistanceSquared > fLargestDistanceSquared)
+        {
+            fLargestDistanceSquared = fDistanceSquared;
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                afCenter[i] = (pfMin[i] + pfMax[i]) * 0.5f;
+            }
+            fRadius = sqrtf(fDistanceSquared) * 0.5f;
+        }
+    }
+
+    // ritter growth, then the radius is set to the farthest vertex so every vertex is inside after rounding
+    for(uint32_t iVertex : maiMeshletVertices)
+    {
+        float const* pfPosition = getPosition(iVertex);
+        float afDiff[3] = {pfPosition[0] - afCenter[0], pfPosition[1] - afCenter[1], pfPosition[2] - afCenter[2]};
+        float fDistance = sqrtf(dot3(afDiff, afDiff));
+        if(fDistance > fRadius)
+        {
+            float fNewRadius = (fRadius + fDistance) * 0.5f;
+            float fShift = (fNewRadius - fRadius) / fDistance;
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                afCenter[i] += afDiff[i] * fShift;
+            }
+            fRadius = fNewRadius;
+        }
+    }
+
+    fRadius = 0.0f;
+    for(uint32_t iVertex : maiMeshletVertices)
+    {
+        float const* pfPosition = getPosition(iVertex);
+        float afDiff[3] = {pfPosition[0] - afCenter[0], pfPosition[1] - afCenter[1], pfPosition[2] - afCenter[2]};
+        fRadius = std::max(fRadius, sqrtf(dot3(afDiff, afDiff)));
+    }
+
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        meshlet.mafSphere[i] = afCenter[i];
+        meshlet.mafConeApex[i] = afCenter[i];
+        meshlet.mafConeAxis[i] = 0.0f;
+    }
+    meshlet.mafSphere[3] = fRadius;
+    meshlet.mafConeApex[3] = 0.0f;
+    meshlet.mafConeAxis[3] = 1.0f;
+
+    // unit triangle normals, degenerate triangles don't rasterize and keep a zero normal that is skipped
+    mafTriangleNormals.assign(meshlet.miNumTriangles * 3, 0.0f);
+    float afAxis[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t iNumNormals = 0;
+    for(uint32_t iTriangle = 0; iTriangle < meshlet.miNumTriangles; iTriangle++)
+    {
+        float const* pfP0 = getPosition(paiIndices[iTriangle * 3]);
+        float const* pfP1 = getPosition(paiIndices[iTriangle * 3 + 1]);
+        float const* pfP2 = getPosition(paiIndices[iTriangle * 3 + 2]);
+        float afEdge0[3] = {pfP1[0] - pfP0[0], pfP1[1] - pfP0[1], pfP1[2] - pfP0[2]};
+        float afEdge1[3] = {pfP2[0] - pfP0[0], pfP2[1] - pfP0[1], pfP2[2] - pfP0[2]};
+        float afNormal[3] =
+        {
+            afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1],
+            afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2],
+            afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0],
+        };
+        float fLength = sqrtf(dot3(afNormal, afNormal));
+        if(fLength <= 0.0f)
+        {
+            continue;
+        }
+
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            mafTriangleNormals[iTriangle * 3 + i] = afNormal[i] / fLength;
+            afAxis[i] += afNormal[i] / fLength;
+        }
+        ++iNumNormals;
+    }
+
+    float fAxisLength = sqrtf(dot3(afAxis, afAxis));
+    if(iNumNormals == 0 || fAxisLength <= 0.0f)
+    {
+        return;
+    }
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        afAxis[i] /= fAxisLength;
+    }
+
+    float fMinDP = 1.0f;
+    for(uint32_t iTriangle = 0; iTriangle < meshlet.miNumTriangles; iTriangle++)
+    {
+        float const* pfNormal = &mafTriangleNormals[iTriangle * 3];
+        if(dot3(pfNormal, pfNormal) > 0.0f)
+        {
+            fMinDP = std::min(fMinDP, dot3(pfNormal, afAxis));
+        }
+    }
+    if(fMinDP <= MESHLET_CONE_MIN_DP)
+    {
+        return;
+    }
+
+    // the apex is at center - axis * t, behind the plane of a triangle with normal n through p0 when
+    // t >= dot(center - p0, n) / dot(axis, n)
+    float fMaxT = 0.0f;
+    for(uint32_t iTriangle = 0; iTriangle < meshlet.miNumTriangles; iTriangle++)
+    {
+        float const* pfNormal = &mafTriangleNormals[iTriangle * 3];
+        if(dot3(pfNormal, pfNormal) <= 0.0f)
+        {
+            continue;
+        }
+
+        float const* pfP0 = getPosition(paiIndices[iTriangle * 3]);
+        float afToCenter[3] = {afCenter[0] - pfP0[0], afCenter[1] - pfP0[1], afCenter[2] - pfP0[2]};
+        fMaxT = std::max(fMaxT, dot3(afToCenter, pfNormal) / dot3(afAxis, pfNormal));
+    }
+
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        meshlet.mafConeApex[i] = afCenter[i] - afAxis[i] * fMaxT;
+        meshlet.mafConeAxis[i] = afAxis[i];
+    }
+    meshlet.mafConeAxis[3] = sqrtf(1.0f - fMinDP * fMinDP);
+}
+
+/*
+**
+*/
+CMeshletBuilder::Stats CMeshletBuilder::analyze(std::vector<Render::Meshlet> const& aMeshlets)
+{
+    Stats stats;
+    stats.miNumMeshlets = (uint32_t)aMeshlets.size();
+    for(auto const& meshlet : aMeshlets)
+    {
+        stats.miNumTriangles += meshlet.miNumTriangles;
+        stats.miNumVertices += meshlet.miNumVertices;
+        stats.miNumConeMeshlets += (meshlet.mafConeAxis[3] < 1.0f) ? 1 : 0;
+    }
+
+    return stats;
+}
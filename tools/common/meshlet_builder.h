@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <render/meshlet.h>
+
+/*
+** splits cooked meshes into Render::Meshlet clusters, shared by the converters
+**
+** build        walks the triangles in index order and starts a new meshlet when the next triangle would go over the
+**              vertex or triangle limit. run after CMeshOptimizer, whose order keeps neighbouring triangles together,
+**              so the meshlets are compact and the index buffer doesn't have to be reordered
+** bounds       ritter sphere seeded with the farthest pair of the axis extremes. the cone axis is the average of the
+**              triangle normals, the apex is the point on the axis behind the sphere center that is behind every
+**              triangle's plane. meshlets with a normal spread close to or past 90 degrees get a cutoff of 1
+**
+** indices are into pafPositions, an instance keeps scratch memory between calls, use one per thread
+*/
+class CMeshletBuilder
+{
+public:
+    struct Stats
+    {
+        uint32_t            miNumMeshlets = 0;
+        uint32_t            miNumTriangles = 0;
+        uint32_t            miNumVertices = 0;          // sum over the meshlets, shared vertices count once per meshlet
+        uint32_t            miNumConeMeshlets = 0;      // with a cutoff under 1
+    };
+
+public:
+    CMeshletBuilder() = default;
+    virtual ~CMeshletBuilder() = default;
+
+    // appends the meshlets of one mesh whose indices start at iIndexStart in the index buffer
+    void build(
+        std::vector<Render::Meshlet>& aMeshlets,
+        uint32_t const* paiIndices,
+        uint32_t iNumIndices,
+        uint32_t iIndexStart,
+        uint32_t iMesh,
+        float const* pafPositions,
+        uint32_t iPositionStride,
+        uint32_t iMaxVertices = MESHLET_MAX_VERTICES,
+        uint32_t iMaxTriangles = MESHLET_MAX_TRIANGLES);
+
+    static Stats analyze(std::vector<Render::Meshlet> const& aMeshlets);
+
+protected:
+    void computeBounds(
+        Render::Meshlet& meshlet,
+        uint32_t const* paiIndices,
+        float const* pafPositions,
+        uint32_t iPositionStride);
+
+protected:
+    // meshlet stamp per vertex, a vertex is in the current meshlet when its stamp is miCurrStamp
+    std::vector<uint32_t>       maiVertexStamps;
+    uint32_t                    miCurrStamp = 0;
+
+    // unique vertices of the meshlet the bounds are computed for
+    std::vector<uint32_t>       maiMeshletVertices;
+
+    // xyz per triangle of that meshlet, zero for degenerate ones
+    std::vector<float>          mafTriangleNormals;
+};
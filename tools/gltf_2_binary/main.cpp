@@ -6,6 +6,13 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -20,6 +27,12 @@
 
 #include <rapidjson/document.h>
 
+#include <common/cook_cache.h>
+#include <common/mesh_optimizer.h>
+
+// bump when the output format or conversion changes, invalidates the cook cache
+#define GLTF_2_BINARY_VERSION "gltf_2_binary 2"
+
 struct AnimFrame
 {
     float           mfTime;
@@ -66,6 +79,30 @@ struct OutputMaterialInfo
     uint32_t            miRoughnessMetallicTextureID = UINT32_MAX;
 };
 
+struct ConvertJob
+{
+    std::string         mDirectory;
+    std::string         mAnimationName;
+    std::string         mCharacterName;
+    std::string         mJointMappingFileName;
+};
+
+void convertGLTF(
+    std::vector<std::string>& aOutputFilePaths,
+    std::string const& dir,
+    std::string const& baseSrcName,
+    std::string const& baseDstName,
+    std::string const& jointMappingFileName);
+
+void getGLTFSourceFiles(
+    std::vector<std::string>& aSourceFilePaths,
+    std::string const& dir,
+    std::string const& baseName);
+
+bool readManifest(
+    std::vector<ConvertJob>& aJobs,
+    std::string const& manifestFilePath);
+
 void saveMatrices(
     std::string const& dir,
     std::string const& baseName,
@@ -85,6 +122,70 @@ void traverseRig(
     std::map<uint32_t, std::string>& aJointMapping,
     uint32_t iStack);
 
+/*
+** vertex cache, overdraw and vertex fetch order for the meshes, the attributes and joint influences of each vertex
+** move with it. prints the acmr and atvr before and after
+*/
+void optimizeMeshes(
+    std::vector<std::vector<float3>>& aaMeshPositions,
+    std::vector<std::vector<float3>>& aaMeshNormals,
+    std::vector<std::vector<float2>>& aaMeshTexCoords,
+    std::vector<std::vector<uint32_t>>& aaiMeshTriangleIndices,
+    std::vector<std::vector<uint32_t>>& aaaiJointInfluences,
+    std::vector<std::vector<float>>& aaafJointWeights)
+{
+    CMeshOptimizer optimizer;
+    std::vector<uint32_t> aiRemap;
+    for(uint32_t i = 0; i < (uint32_t)aaMeshPositions.size(); i++)
+    {
+        std::vector<uint32_t>& aiIndices = aaiMeshTriangleIndices[i];
+        uint32_t iNumVertices = (uint32_t)aaMeshPositions[i].size();
+        if(iNumVertices == 0 || aiIndices.size() % 3 != 0)
+        {
+            continue;
+        }
+
+        CMeshOptimizer::VertexCacheStats before = optimizer.analyzeVertexCache(aiIndices, iNumVertices);
+        optimizer.optimizeVertexCache(aiIndices, iNumVertices);
+        optimizer.optimizeOverdraw(
+            aiIndices,
+            &aaMeshPositions[i][0].x,
+            (uint32_t)(sizeof(float3) / sizeof(float)),
+            iNumVertices);
+        optimizer.optimizeVertexFetch(aiRemap, aiIndices, iNumVertices);
+        CMeshOptimizer::VertexCacheStats after = optimizer.analyzeVertexCache(aiIndices, iNumVertices);
+
+        CMeshOptimizer::remapVertices(aaMeshPositions[i], aiRemap);
+        if(i < aaMeshNormals.size() && aaMeshNormals[i].size() == iNumVertices)
+        {
+            CMeshOptimizer::remapVertices(aaMeshNormals[i], aiRemap);
+        }
+        if(i < aaMeshTexCoords.size() && aaMeshTexCoords[i].size() == iNumVertices)
+        {
+            CMeshOptimizer::remapVertices(aaMeshTexCoords[i], aiRemap);
+        }
+
+        // 4 joints per vertex
+        if(i < aaaiJointInfluences.size() && aaaiJointInfluences[i].size() == iNumVertices * 4)
+        {
+            CMeshOptimizer::remapVertices(aaaiJointInfluences[i], aiRemap, 4);
+        }
+        if(i < aaafJointWeights.size() && aaafJointWeights[i].size() == iNumVertices * 4)
+        {
+            CMeshOptimizer::remapVertices(aaafJointWeights[i], aiRemap, 4);
+        }
+
+        DEBUG_PRINTF("mesh %d: %d triangles, %d entry cache acmr %.3f -> %.3f atvr %.3f -> %.3f\n",
+            i,
+            after.miNumTriangles,
+            MESH_OPTIMIZER_CACHE_SIZE,
+            before.mfACMR,
+            after.mfACMR,
+            before.mfATVR,
+            after.mfATVR);
+    }
+}
+
 /*
 **
 */
@@ -640,6 +741,14 @@ void loadGLTF(
 
     }   // animation 
 
+    optimizeMeshes(
+        aaMeshPositions,
+        aaMeshNormals,
+        aaMeshTexCoords,
+        aaiMeshTriangleIndices,
+        aaaiJointInfluences,
+        aaafJointWeights);
+
     uint32_t iNumMeshes = (uint32_t)aaMeshPositions.size();
     uint32_t iNumAnimations = (uint32_t)aaGlobalInverseBindMatrices.size();
    
@@ -2193,6 +2302,10 @@ if(iTest > 0)
 
 /*
 **
+** gltf_2_binary [--manifest <file>] [--cache <directory>] [--threads <count>] [--force] [<directory> <animation gltf> <character gltf> <joint mapping json>]
+**
+** gltf names are without extension, each manifest line has the same four fields separated by spaces,
+** blank lines and lines starting with # are skipped
 */
 int main(int argc, char** argv)
 {
@@ -2201,9 +2314,152 @@ int main(int argc, char** argv)
     printOptions.mbDisplayTime = false;
     DEBUG_PRINTF_SET_OPTIONS(printOptions);
 
-    std::string dir = "D:\\test\\github-projects\\test_assets";
-    //std::string baseSrcName = "spider-man-bind-new-rig-pitching-2";
-    std::string baseSrcName = "spider-man-bind-new-rig-ik-batting-with-bat";
+    std::vector<ConvertJob> aJobs;
+    std::vector<std::string> aArgs;
+    std::string cacheDirectory = ".cook-cache";
+    uint32_t iNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool bForce = false;
+    for(int32_t iArg = 1; iArg < argc; iArg++)
+    {
+        std::string arg = argv[iArg];
+        if(arg == "--manifest" && iArg + 1 < argc)
+        {
+            if(!readManifest(aJobs, argv[++iArg]))
+            {
+                DEBUG_PRINTF("!!! can\'t read manifest \"%s\" !!!\n", argv[iArg]);
+                return 1;
+            }
+        }
+        else if(arg == "--cache" && iArg + 1 < argc)
+        {
+            cacheDirectory = argv[++iArg];
+        }
+        else if(arg == "--threads" && iArg + 1 < argc)
+        {
+            iNumThreads = std::max((uint32_t)atoi(argv[++iArg]), 1u);
+        }
+        else if(arg == "--force")
+        {
+            bForce = true;
+        }
+        else
+        {
+            aArgs.push_back(arg);
+        }
+    }
+
+    if(aArgs.size() == 4)
+    {
+        ConvertJob job;
+        job.mDirectory = aArgs[0];
+        job.mAnimationName = aArgs[1];
+        job.mCharacterName = aArgs[2];
+        job.mJointMappingFileName = aArgs[3];
+        aJobs.push_back(job);
+    }
+    else if(aArgs.size() > 0 || aJobs.size() <= 0)
+    {
+        DEBUG_PRINTF("usage: gltf_2_binary [--manifest <file>] [--cache <directory>] [--threads <count>] [--force] [<directory> <animation gltf> <character gltf> <joint mapping json>]\n");
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    CCookCache cookCache;
+    cookCache.init(cacheDirectory);
+
+    // jobs sharing an animation write the same animation outputs, run those one at a time
+    std::map<std::string, std::mutex> aAnimationMutexes;
+    for(auto const& job : aJobs)
+    {
+        aAnimationMutexes[job.mDirectory + "/" + job.mAnimationName];
+    }
+
+    std::atomic<uint32_t> iNextJob(0);
+    std::atomic<uint32_t> aiNumResults[3] = {0, 0, 0};
+    auto processJobs = [&]()
+        {
+            for(;;)
+            {
+                uint32_t iJob = iNextJob++;
+                if(iJob >= (uint32_t)aJobs.size())
+                {
+                    break;
+                }
+
+                ConvertJob const& job = aJobs[iJob];
+                std::lock_guard<std::mutex> lock(aAnimationMutexes[job.mDirectory + "/" + job.mAnimationName]);
+
+                std::error_code errorCode;
+                std::string assetName = 
+                    std::filesystem::absolute(job.mDirectory, errorCode).string() + "/" + 
+                    job.mCharacterName + "-" + job.mAnimationName;
+
+                std::vector<std::string> aSourceFilePaths;
+                getGLTFSourceFiles(aSourceFilePaths, job.mDirectory, job.mAnimationName);
+                getGLTFSourceFiles(aSourceFilePaths, job.mDirectory, job.mCharacterName);
+                aSourceFilePaths.push_back(job.mDirectory + "/" + job.mJointMappingFileName);
+                uint64_t iKey = cookCache.computeKey(
+                    aSourceFilePaths, 
+                    GLTF_2_BINARY_VERSION, 
+                    job.mAnimationName + " " + job.mCharacterName);
+
+                CCookCache::Result result = bForce ? CCookCache::RESULT_MISS : cookCache.lookup(assetName, job.mDirectory, iKey);
+                if(result == CCookCache::RESULT_MISS)
+                {
+                    std::vector<std::string> aOutputFilePaths;
+                    convertGLTF(
+                        aOutputFilePaths,
+                        job.mDirectory,
+                        job.mAnimationName,
+                        job.mCharacterName,
+                        job.mJointMappingFileName);
+                    cookCache.store(assetName, job.mDirectory, iKey, aOutputFilePaths);
+                }
+                else
+                {
+                    DEBUG_PRINTF("\"%s\" %s\n", assetName.c_str(), (result == CCookCache::RESULT_UP_TO_DATE) ? "is up to date" : "restored from cook cache");
+                }
+
+                ++aiNumResults[result];
+            }
+        };
+
+    std::vector<std::thread> aThreads;
+    iNumThreads = std::min(iNumThreads, (uint32_t)aJobs.size());
+    for(uint32_t i = 0; i < iNumThreads; i++)
+    {
+        aThreads.emplace_back(processJobs);
+    }
+    for(auto& thread : aThreads)
+    {
+        thread.join();
+    }
+
+    cookCache.save();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    DEBUG_PRINTF("%d assets on %d threads: %d converted, %d up to date, %d restored from cache in %.2f ms\n",
+        (uint32_t)aJobs.size(),
+        iNumThreads,
+        aiNumResults[CCookCache::RESULT_MISS].load(),
+        aiNumResults[CCookCache::RESULT_UP_TO_DATE].load(),
+        aiNumResults[CCookCache::RESULT_RESTORED].load(),
+        float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001f);
+
+    return 0;
+}
+
+/*
+**
+*/
+void convertGLTF(
+    std::vector<std::string>& aOutputFilePaths,
+    std::string const& dir,
+    std::string const& baseSrcName,
+    std::string const& baseDstName,
+    std::string const& jointMappingFileName)
+{
     std::string srcGTLFFilePath = dir + "/" + baseSrcName + ".gltf";
     std::string srcWADFilePath = dir + "/" + baseSrcName + ".wad";
 
@@ -2388,9 +2644,6 @@ int main(int argc, char** argv)
     std::vector<std::string>        aDstEmissiveImageURI;
     std::vector<uint32_t>           aiDstMeshMaterialID;
 
-    std::string baseDstName = "chun-li-rotated-2-texture";
-    //std::string baseDstName = "ryu";
-
     std::string dstGLTFFilePath = dir + "/" + baseDstName + ".gltf";
     std::string dstWADFilePath = dir + "/" + baseDstName + ".wad";
     loadGLTF(
@@ -2541,7 +2794,7 @@ int main(int argc, char** argv)
             aaSrcJoints[0],
 
             dir,
-            "chun-li-joint-mapping.json",
+            jointMappingFileName,
 
             aSrcLocalBindMatrices,
             aDstLocalBindMatrices,
@@ -2576,7 +2829,7 @@ int main(int argc, char** argv)
             fTime,
 
             dir,
-            "chun-li-joint-mapping.json",
+            jointMappingFileName,
             
             aSrcGlobalAnimatedJointMatrices,
             aaSrcGlobalBindMatrices[0]
@@ -2734,7 +2987,107 @@ int main(int argc, char** argv)
         DEBUG_PRINTF("wrote to %s\n", filePath.c_str());
     }
 
-    return 0;
+    std::string srcBasePath = dir + "/" + baseSrcName;
+    std::string dstBasePath = dir + "/" + baseDstName;
+    aOutputFilePaths =
+    {
+        srcWADFilePath,
+        srcBasePath + "-local-bind-matrices.bin",
+        srcBasePath + "-global-bind-matrices.bin",
+        srcBasePath + "-inverse-global-bind-matrices.bin",
+        srcBasePath + "-bat-global-transform-matrices.bin",
+        dstWADFilePath,
+        dstBasePath + "-local-bind-matrices.bin",
+        dstBasePath + "-global-bind-matrices.bin",
+        dstBasePath + "-inverse-global-bind-matrices.bin",
+        dstBasePath + "-" + baseSrcName + "-matching-animation-frames.anm",
+        dstBasePath + ".mat",
+        dstBasePath + ".mid",
+        dstBasePath + "-texture-names.tex",
+    };
+}
+
+/*
+**
+*/
+void getGLTFSourceFiles(
+    std::vector<std::string>& aSourceFilePaths,
+    std::string const& dir,
+    std::string const& baseName)
+{
+    // the gltf and the external buffers it references, images aren't read by the conversion
+    std::string gltfFilePath = dir + "/" + baseName + ".gltf";
+    aSourceFilePaths.push_back(gltfFilePath);
+
+    FILE* fp = fopen(gltfFilePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return;
+    }
+    fseek(fp, 0, SEEK_END);
+    size_t iFileSize = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    std::vector<char> acFileContent(iFileSize + 1, 0);
+    fread(acFileContent.data(), sizeof(char), iFileSize, fp);
+    fclose(fp);
+
+    rapidjson::Document doc;
+    doc.Parse(acFileContent.data());
+    if(doc.HasParseError() || !doc.IsObject() || !doc.HasMember("buffers") || !doc["buffers"].IsArray())
+    {
+        return;
+    }
+
+    for(auto const& buffer : doc["buffers"].GetArray())
+    {
+        if(!buffer.IsObject() || !buffer.HasMember("uri") || !buffer["uri"].IsString())
+        {
+            continue;
+        }
+
+        std::string uri = buffer["uri"].GetString();
+        if(uri.rfind("data:", 0) != 0)
+        {
+            aSourceFilePaths.push_back(dir + "/" + uri);
+        }
+    }
+}
+
+/*
+**
+*/
+bool readManifest(
+    std::vector<ConvertJob>& aJobs,
+    std::string const& manifestFilePath)
+{
+    FILE* fp = fopen(manifestFilePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+
+    // <directory> <animation gltf> <character gltf> <joint mapping json>
+    char szLine[4096];
+    while(fgets(szLine, sizeof(szLine), fp))
+    {
+        std::istringstream lineStream(szLine);
+        ConvertJob job;
+        if(!(lineStream >> job.mDirectory) || job.mDirectory[0] == '#')
+        {
+            continue;
+        }
+
+        if(!(lineStream >> job.mAnimationName >> job.mCharacterName >> job.mJointMappingFileName))
+        {
+            DEBUG_PRINTF("!!! skipping manifest line \"%s\" !!!\n", szLine);
+            continue;
+        }
+
+        aJobs.push_back(job);
+    }
+    fclose(fp);
+
+    return true;
 }
 
 /*
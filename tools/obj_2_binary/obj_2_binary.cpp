@@ -1,17 +1,37 @@
 
 
 #include <cstdint>
+#include <cinttypes>
 #include <string>
 #include <vector>
 #include <cassert>
 #include <sstream>
 #include <mutex>
+#include <condition_variable>
 #include <map>
+#include <cfloat>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <array>
 
 #include <filesystem>
 
 #include <math/vec.h>
+#include <math/mat4.h>
 #include <utils/LogPrint.h>
+#include <common/cook_cache.h>
+#include <common/mesh_optimizer.h>
+#include <common/meshlet_builder.h>
+#include <common/mesh_simplifier.h>
+#include <render/mesh_file.h>
+#include <render/packed_vertex.h>
+#include <render/meshlet.h>
+#include <render/mesh_lod.h>
+
+#include "vertex_weld.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image/stb_image.h>
@@ -24,12 +44,40 @@
 
 #define POSITION_MULT 10.0
 
+// bump when the output format or conversion changes, invalidates the cook cache
+#define OBJ_2_BINARY_VERSION "obj_2_binary 7"
+
 #if defined(__APPLE__)
 #define FLT_MAX __FLT_MAX__
 #endif // __APPLE__ 
 
 std::mutex gMutex;
 
+// threads for the work inside one asset (shape welding), split from --threads across the assets converted at once
+uint32_t giNumWorkerThreads = 1;
+
+// 0 welds bit exact duplicates only
+float gfWeldTolerance = 0.0f;
+
+// position, normal, uv per face corner
+#define NUM_WELD_ATTRIBUTES 8
+
+// vertex cache, overdraw and vertex fetch order of each mesh, --no-optimize keeps the obj face order
+bool gbOptimizeMeshes = true;
+
+// 16 byte PackedVertex with a per mesh dequantization chunk, --float-vertices writes the 48 byte Vertex instead
+bool gbPackVertices = true;
+
+// levels of detail per mesh counting the full one, --lods 1 writes the full meshes only
+uint32_t giNumLods = MESH_MAX_LODS;
+
+// every level aims for half the triangles of the one before. the simplifier stops at an error of
+// LOD_MAX_RELATIVE_ERROR times the mesh's bounding radius, a level that keeps more than LOD_MIN_REDUCTION of the
+// triangles before it ends the chain
+#define LOD_TRIANGLE_RATIO 0.5f
+#define LOD_MAX_RELATIVE_ERROR 0.05f
+#define LOD_MIN_REDUCTION 0.8f
+
 struct Face
 {
     uint32_t                                    miIndex = UINT32_MAX;
@@ -88,14 +136,141 @@ struct MeshExtent
     vec4            mMaxPosition;
 };
 
+struct OutputChunk
+{
+    uint32_t            miType;
+    uint32_t            miAlignment;
+    uint32_t            miElementSize;
+    uint32_t            miNumElements;
+    void const*         mpData;
+};
+
+// levels 1 and up of a mesh, indices into maTotalVertices like the full mesh's
+struct MeshLodChain
+{
+    std::vector<std::vector<uint32_t>>  maaiIndices;
+    std::vector<float>                  mafErrors;
+};
+
+struct WeldedShape
+{
+    std::vector<Vertex>         maVertices;
+    std::vector<uint32_t>       maiIndices;
+    float3                      mMinPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+    float3                      mMaxPosition = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+};
+
+// one obj file going through the parse, weld and merge stages of loadOBJDirectory
+struct OBJFileJob
+{
+    std::string                         mPath;
+    std::string                         mBaseName;
+    tinyobj::attrib_t                   mAttrib;
+    std::vector<tinyobj::shape_t>       maShapes;
+    std::vector<tinyobj::material_t>    maMaterials;
+    std::vector<WeldedShape>            maWeldedShapes;
+    bool                                mbParsed = false;
+    uint32_t                            miNextShape = 0;
+    uint32_t                            miNumWeldedShapes = 0;
+};
+
+// everything convertOBJ writes out, meshes in file name then shape order
+struct OBJMeshes
+{
+    std::map<std::string, std::vector<uint32_t>>    maMeshInstanceIndices;
+    std::vector<Vertex>                             maTotalVertices;
+    std::vector<std::vector<uint32_t>>              maaiTriangleVertexIndices;
+    std::vector<MeshLodChain>                       maMeshLodChains;
+    std::vector<MeshExtent>                         maMeshExtents;
+    std::vector<float3>                             maMeshCenters;
+    std::vector<float3>                             maMeshBBoxes;
+    std::vector<uint32_t>                           maiMeshVertexStarts;
+    std::vector<std::string>                        maMeshNames;
+    std::vector<uint32_t>                           maiMeshMaterialIDs;
+    std::vector<OBJMaterialInfo>                    maMeshMaterials;
+    float3                                          mTotalMinPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+    float3                                          mTotalMaxPosition = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    uint64_t                                        miNumWeldInputVertices = 0;
+};
+
+bool writeChunkedFile(
+    std::string const& fullPath,
+    std::vector<OutputChunk> const& aChunks);
+
+void runWorkers(
+    uint32_t iNumThreads,
+    std::function<void(uint32_t)> const& worker);
+
+void expandShapeAttributes(
+    std::vector<float>& afAttributes,
+    float3& minPosition,
+    float3& maxPosition,
+    tinyobj::attrib_t const& attrib,
+    tinyobj::shape_t const& shape);
+
+void weldShape(
+    WeldedShape& weldedShape,
+    CVertexWelder& welder,
+    tinyobj::attrib_t const& attrib,
+    tinyobj::shape_t const& shape);
+
+void loadOBJDirectory(
+    OBJMeshes& meshes,
+    std::string const& directory,
+    uint32_t iNumThreads);
+
+void mergeOBJFile(
+    OBJMeshes& meshes,
+    OBJFileJob& job);
+
+void optimizeMeshes(
+    OBJMeshes& meshes,
+    uint32_t iNumThreads);
+
+void buildMeshLods(
+    OBJMeshes& meshes,
+    uint32_t iNumThreads);
+
+void weldWithStringKeys(
+    std::vector<uint32_t>& aiUniqueVertices,
+    std::vector<uint32_t>& aiRemap,
+    std::vector<float> const& afAttributes,
+    uint32_t iShape);
+
+int benchmarkWeld(
+    std::string const& fullPath,
+    uint32_t iNumIterations);
+
+int benchmarkThreads(
+    std::string const& fullPath);
+
+int benchmarkMeshlets(
+    std::string const& fullPath,
+    uint32_t iNumIterations);
+
+void buildMeshlets(
+    std::vector<Render::Meshlet>& aMeshlets,
+    std::vector<MeshRange>& aMeshletRanges,
+    std::vector<Vertex> const& aTotalVertices,
+    std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices,
+    uint32_t iFirstIndex,
+    uint32_t iNumThreads);
+
 
 void outputVerticesAndTriangles(
     std::vector<Vertex> const& aTotalVertices,
     std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices,
+    std::vector<MeshLodChain> const& aMeshLodChains,
     std::vector<MeshExtent> const& aMeshExtents,
     std::string const& directory,
     std::string const& baseName);
 
+bool packVertices(
+    std::vector<Render::PackedVertex>& aPackedVertices,
+    std::vector<Render::VertexDequantization>& aDequantization,
+    std::vector<Vertex> const& aTotalVertices,
+    uint32_t iNumMeshes);
+
 void outputTrianglePositionsAndTriangles(
     std::vector<float4> const& aTrianglePositions,
     std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices,
@@ -129,262 +304,335 @@ void outputMeshMaterialIDs(
 
 void convertNormalImages(std::string const& directory);
 
+size_t parseInputPath(
+    std::string& directory,
+    std::string& baseName,
+    std::string const& fullPath);
+
+void getOBJSourceFiles(
+    std::vector<std::string>& aSourceFilePaths,
+    std::string const& directory);
 
+bool convertOBJ(
+    std::vector<std::string>& aOutputFilePaths,
+    std::string const& fullPath);
+
+bool readManifest(
+    std::vector<std::string>& aEntries,
+    std::string const& manifestFilePath);
+
+/*
+**
+** obj_2_binary [--manifest <file>] [--cache <directory>] [--threads <count>] [--force] [--weld-tolerance <distance>] [--no-optimize] [--float-vertices] [--lods <count>] [<obj file or directory> ...]
+** obj_2_binary --benchmark-weld <obj file or directory> [iterations]
+** obj_2_binary --benchmark-threads <obj file or directory>
+**
+** each manifest line is an obj file or directory, blank lines and lines starting with # are skipped
+*/
 int main(int argc, char* argv[])
 {
-    std::string fullPath = argv[1];
-    auto iter = fullPath.rfind("\\");
-    if(iter == std::string::npos)
-    {
-        iter = fullPath.rfind("/");
-    }
-    std::string directory = fullPath.substr(0, iter);
-    std::string fileName = fullPath.substr(iter + 1);
-    auto extensionIter = fileName.rfind(".obj");
-    
-    std::string baseName = ""; 
-    if(extensionIter == std::string::npos)
+    std::vector<std::string> aInputPaths;
+    std::string cacheDirectory = ".cook-cache";
+    uint32_t iNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool bForce = false;
+    std::string benchmarkPath = "";
+    std::string threadBenchmarkPath = "";
+    std::string meshletBenchmarkPath = "";
+    uint32_t iNumBenchmarkIterations = 1;
+    for(int32_t iArg = 1; iArg < argc; iArg++)
     {
-        if(iter == fullPath.size() - 1)
+        std::string arg = argv[iArg];
+        if(arg == "--manifest" && iArg + 1 < argc)
         {
-            iter = fullPath.rfind("\\", iter - 1);
+            if(!readManifest(aInputPaths, argv[++iArg]))
+            {
+                DEBUG_PRINTF("!!! can\'t read manifest \"%s\" !!!\n", argv[iArg]);
+                return 1;
+            }
         }
-        
-        baseName = fileName.substr(0, iter);
-        directory = fullPath;
-    }
-    else
-    {
-        baseName = fileName.substr(0, extensionIter);
-    }
-    
-    auto encodeToMapString = [&](Vertex const& v, uint32_t iMeshIndex)
+        else if(arg == "--cache" && iArg + 1 < argc)
         {
-            Vertex copy = v;
-            copy.mPosition.x *= 100.0f;
-            copy.mPosition.y *= 100.0f;
-            copy.mPosition.z *= 100.0f;
-
-            std::ostringstream oss;
-            oss << copy.mPosition.x << "_" << copy.mPosition.y << "_" << copy.mPosition.z << "_" <<
-                copy.mNormal.x << "_" << copy.mNormal.y << "_" << copy.mNormal.z << "_" <<
-                copy.mUV.x << "_" << copy.mUV.y << "_" << iMeshIndex;
-
-            return oss.str();
-        };
-
-    std::map<std::string, std::vector<uint32_t>> aMeshInstanceIndices;
-
-    std::vector<Vertex> aTotalVertices;
-    std::map<std::string, uint32_t> aTotalVertexMap;
-    std::vector<std::vector<uint32_t>> aaiTriangleVertexIndices;
-    std::vector<MeshExtent> aMeshExtents;
-    std::vector<float3> aMeshCenters;
-    std::vector<float3> aMeshBBoxes;
-    std::vector<std::string> aMeshNames;
-    std::vector<uint32_t> aiMeshMaterialIDs;
-    std::vector<OBJMaterialInfo> aMeshMaterials;
-
-    float3 totalMinPos = float3(FLT_MAX, FLT_MAX, FLT_MAX);
-    float3 totalMaxPos = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-
-    for(auto const& entry : std::filesystem::directory_iterator(directory))
-    {
-        std::string path = entry.path().string().c_str();
-
-        std::string fileName = path.substr(iter + 1);
-        auto extensionIter = fileName.rfind(".obj");
-        if(extensionIter == std::string::npos)
+            cacheDirectory = argv[++iArg];
+        }
+        else if(arg == "--threads" && iArg + 1 < argc)
         {
-            continue;
+            iNumThreads = std::max((uint32_t)atoi(argv[++iArg]), 1u);
         }
-
-        std::string baseName = fileName.substr(0, extensionIter);
-
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-        std::string warn, err;
-
-        bool ret = tinyobj::LoadObj(
-            &attrib, 
-            &shapes, 
-            &materials, 
-            &warn, 
-            &err, 
-            path.c_str(),
-            directory.c_str());
-
-        // Access loaded data
-        for(size_t s = 0; s < shapes.size(); s++)
+        else if(arg == "--force")
         {
-            std::ostringstream partNameStringStream;
-            partNameStringStream << baseName << "-" << "shape" << s;
-            aMeshNames.push_back(partNameStringStream.str());
-
-            OBJMaterialInfo material = {};
-            if(materials.size() > 0)
+            bForce = true;
+        }
+        else if(arg == "--weld-tolerance" && iArg + 1 < argc)
+        {
+            gfWeldTolerance = std::max((float)atof(argv[++iArg]), 0.0f);
+        }
+        else if(arg == "--no-optimize")
+        {
+            gbOptimizeMeshes = false;
+        }
+        else if(arg == "--float-vertices")
+        {
+            gbPackVertices = false;
+        }
+        else if(arg == "--lods" && iArg + 1 < argc)
+        {
+            giNumLods = std::clamp((uint32_t)atoi(argv[++iArg]), 1u, (uint32_t)MESH_MAX_LODS);
+        }
+        else if(arg == "--benchmark-weld" && iArg + 1 < argc)
+        {
+            benchmarkPath = argv[++iArg];
+            if(iArg + 1 < argc && argv[iArg + 1][0] != '-')
             {
-                int32_t iMaterialID = shapes[s].mesh.material_ids[0];
-
-                material.mDiffuse = float4(
-                    (float)materials[iMaterialID].diffuse[0], 
-                    (float)materials[iMaterialID].diffuse[0], 
-                    (float)materials[iMaterialID].diffuse[0], 1.0f);
-
-                material.mSpecular = float4(
-                    (float)materials[iMaterialID].specular[0],
-                    (float)materials[iMaterialID].specular[0],
-                    (float)materials[iMaterialID].specular[0], 1.0f);
-
-                material.mEmissive = float4(
-                    (float)materials[iMaterialID].emission[0],
-                    (float)materials[iMaterialID].emission[0],
-                    (float)materials[iMaterialID].emission[0], 1.0f);
-
-                material.mAlbedoTexturePath = materials[iMaterialID].diffuse_texname;
-                material.mEmissiveTexturePath = materials[iMaterialID].emissive_texname;
-                material.mSpecularTexturePath = materials[iMaterialID].specular_texname;
-                material.mNormalTexturePath = materials[iMaterialID].normal_texname;
+                iNumBenchmarkIterations = std::max((uint32_t)atoi(argv[++iArg]), 1u);
             }
-            else 
+        }
+        else if(arg == "--benchmark-threads" && iArg + 1 < argc)
+        {
+            threadBenchmarkPath = argv[++iArg];
+        }
+        else if(arg == "--benchmark-meshlets" && iArg + 1 < argc)
+        {
+            meshletBenchmarkPath = argv[++iArg];
+            if(iArg + 1 < argc && argv[iArg + 1][0] != '-')
             {
-                float fRed = float(rand() % 255) / 255.0f;
-                float fGreen = float(rand() % 255) / 255.0f;
-                float fBlue = float(rand() % 255) / 255.0f;
-                material.mDiffuse = float4(fRed, fGreen, fBlue, 1.0f);
+                iNumBenchmarkIterations = std::max((uint32_t)atoi(argv[++iArg]), 1u);
             }
+        }
+        else
+        {
+            aInputPaths.push_back(arg);
+        }
+    }
 
-            aMeshMaterials.push_back(material);
-            aiMeshMaterialIDs.push_back((uint32_t)aMeshMaterials.size() - 1);
+    if(benchmarkPath.length() > 0)
+    {
+        giNumWorkerThreads = iNumThreads;
+        return benchmarkWeld(benchmarkPath, iNumBenchmarkIterations);
+    }
 
-            std::vector<Vertex> aVertices;
-            std::vector<uint32_t> aiVertexIndices;
+    if(threadBenchmarkPath.length() > 0)
+    {
+        giNumWorkerThreads = iNumThreads;
+        return benchmarkThreads(threadBenchmarkPath);
+    }
 
-            float3 maxPosition = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-            float3 minPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+    if(meshletBenchmarkPath.length() > 0)
+    {
+        giNumWorkerThreads = iNumThreads;
+        return benchmarkMeshlets(meshletBenchmarkPath, iNumBenchmarkIterations);
+    }
 
-            // Loop over faces(polygon)
-            size_t index_offset = 0;
-            for(size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++)
-            {
-                int fv = shapes[s].mesh.num_face_vertices[f];
+    if(aInputPaths.size() <= 0)
+    {
+        DEBUG_PRINTF("usage: obj_2_binary [--manifest <file>] [--cache <directory>] [--threads <count>] [--force] [--weld-tolerance <distance>] [--no-optimize] [--float-vertices] [--lods <count>] [<obj file or directory> ...]\n");
+        DEBUG_PRINTF("       obj_2_binary --benchmark-weld <obj file or directory> [iterations] [--threads <count>] [--weld-tolerance <distance>]\n");
+        DEBUG_PRINTF("       obj_2_binary --benchmark-threads <obj file or directory> [--threads <max count>]\n");
+        DEBUG_PRINTF("       obj_2_binary --benchmark-meshlets <obj file or directory> [iterations] [--no-optimize]\n");
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
 
-                // Loop over vertices in the face.
-                for(size_t v = 0; v < fv; v++)
+    CCookCache cookCache;
+    cookCache.init(cacheDirectory);
+
+    std::string options = "position mult " + std::to_string(POSITION_MULT) + " weld tolerance " + std::to_string(gfWeldTolerance);
+    options += gbOptimizeMeshes ? " optimized" : "";
+    options += gbPackVertices ? " packed vertices" : "";
+    options += " lods " + std::to_string(giNumLods);
+
+    std::atomic<uint32_t> iNextInput(0);
+    std::atomic<uint32_t> aiNumResults[3] = {0, 0, 0};
+    std::atomic<uint32_t> iNumFailed(0);
+    auto processInputs = [&]()
+        {
+            for(;;)
+            {
+                uint32_t iInput = iNextInput++;
+                if(iInput >= (uint32_t)aInputPaths.size())
                 {
-                    // access to vertex
-                    tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
+                    break;
+                }
 
-                    float vx = float(attrib.vertices[3 * idx.vertex_index + 0] * POSITION_MULT);
-                    float vy = float(attrib.vertices[3 * idx.vertex_index + 1] * POSITION_MULT);
-                    float vz = float(attrib.vertices[3 * idx.vertex_index + 2] * POSITION_MULT);
+                std::string const& fullPath = aInputPaths[iInput];
+                std::string directory = "", baseName = "";
+                parseInputPath(directory, baseName, fullPath);
 
-                    float nx = 0.0f;
-                    float ny = 0.0f;
-                    float nz = 0.0f;
+                std::error_code errorCode;
+                std::string assetName = std::filesystem::absolute(fullPath, errorCode).string();
 
-                    float tx = 0.0f;
-                    float ty = 0.0f;
+                std::vector<std::string> aSourceFilePaths;
+                getOBJSourceFiles(aSourceFilePaths, directory);
+                uint64_t iKey = cookCache.computeKey(aSourceFilePaths, OBJ_2_BINARY_VERSION, options);
 
-                    // Check if normals and texcoords are loaded
-                    if(idx.normal_index >= 0)
-                    {
-                        nx = attrib.normals[3 * idx.normal_index + 0];
-                        ny = attrib.normals[3 * idx.normal_index + 1];
-                        nz = attrib.normals[3 * idx.normal_index + 2];
-                        // Use normal data
-                    }
-                    if(idx.texcoord_index >= 0)
+                CCookCache::Result result = bForce ? CCookCache::RESULT_MISS : cookCache.lookup(assetName, directory, iKey);
+                if(result == CCookCache::RESULT_MISS)
+                {
+                    std::vector<std::string> aOutputFilePaths;
+                    if(!convertOBJ(aOutputFilePaths, fullPath))
                     {
-                        tx = attrib.texcoords[2 * idx.texcoord_index + 0];
-                        ty = attrib.texcoords[2 * idx.texcoord_index + 1];
-                        // Use texture coordinate data
+                        ++iNumFailed;
+                        continue;
                     }
+                    cookCache.store(assetName, directory, iKey, aOutputFilePaths);
+                }
+                else
+                {
+                    DEBUG_PRINTF("\"%s\" %s\n", fullPath.c_str(), (result == CCookCache::RESULT_UP_TO_DATE) ? "is up to date" : "restored from cook cache");
+                }
 
-                    // Process vertex data (e.g., store in your data structures
-                    Vertex vertex;
-                    vertex.mPosition = float4(vx, vy, vz, (float)aMeshExtents.size());
-                    vertex.mNormal = float4(nx, ny, nz, 1.0f);
-                    vertex.mUV = float4(tx, ty, (float)aMeshExtents.size(), 1.0f);
+                ++aiNumResults[result];
+            }
+        };
 
-                    totalMinPos = fminf(totalMinPos, float3(vx, vy, vz));
-                    totalMaxPos = fmaxf(totalMaxPos, float3(vx, vy, vz));
+    std::vector<std::thread> aThreads;
+    uint32_t iNumTotalThreads = iNumThreads;
+    iNumThreads = std::min(iNumThreads, (uint32_t)aInputPaths.size());
+    giNumWorkerThreads = std::max(iNumTotalThreads / iNumThreads, 1u);
+    for(uint32_t i = 0; i < iNumThreads; i++)
+    {
+        aThreads.emplace_back(processInputs);
+    }
+    for(auto& thread : aThreads)
+    {
+        thread.join();
+    }
 
-                    std::string mapString = encodeToMapString(vertex, (uint32_t)s);
-                    auto iter = aTotalVertexMap.find(mapString);
-                    if(iter == aTotalVertexMap.end())
-                    {
-                        aVertices.push_back(vertex);
-                        uint32_t iVertexIndex = (uint32_t)aTotalVertices.size();
-                        aTotalVertexMap[mapString] = iVertexIndex;
-                        aiVertexIndices.push_back(iVertexIndex);
+    cookCache.save();
 
-                        aTotalVertices.push_back(vertex);
-                    }
-                    else
-                    {
-                        uint32_t iVertexIndex = aTotalVertexMap[mapString];
-
-#if defined(_DEBUG)
-                        Vertex const& checkV = aTotalVertices[iVertexIndex];
-                        float3 diffPos = checkV.mPosition - vertex.mPosition;
-                        float3 diffNorm = checkV.mNormal - vertex.mNormal;
-                        float fDP0 = dot(diffPos, diffPos);
-                        float fDP1 = dot(diffNorm, diffNorm);
-                        assert(fDP0 <= 0.0001f && fDP1 <= 0.0001f);
-#endif // #if 0
-
-                        aiVertexIndices.push_back(iVertexIndex);
-                    }
-                    
-                    minPosition = fminf(float3(vx, vy, vz), minPosition);
-                    maxPosition = fmaxf(float3(vx, vy, vz), maxPosition);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    DEBUG_PRINTF("%d assets on %d threads: %d converted, %d up to date, %d restored from cache, %d failed in %.2f ms\n",
+        (uint32_t)aInputPaths.size(),
+        iNumThreads,
+        aiNumResults[CCookCache::RESULT_MISS].load(),
+        aiNumResults[CCookCache::RESULT_UP_TO_DATE].load(),
+        aiNumResults[CCookCache::RESULT_RESTORED].load(),
+        iNumFailed.load(),
+        float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001f);
 
-                }   // for vertex
+    return (iNumFailed > 0) ? 1 : 0;
+}
 
-                index_offset += fv;
+/*
+**
+*/
+size_t parseInputPath(
+    std::string& directory,
+    std::string& baseName,
+    std::string const& fullPath)
+{
+    auto iter = fullPath.rfind("\\");
+    if(iter == std::string::npos)
+    {
+        iter = fullPath.rfind("/");
+    }
+    directory = fullPath.substr(0, iter);
+    std::string fileName = fullPath.substr(iter + 1);
+    auto extensionIter = fileName.rfind(".obj");
+    
+    baseName = ""; 
+    if(extensionIter == std::string::npos)
+    {
+        if(iter == fullPath.size() - 1)
+        {
+            iter = fullPath.rfind("\\", iter - 1);
+        }
+        
+        baseName = fileName.substr(0, iter);
+        directory = fullPath;
+    }
+    else
+    {
+        baseName = fileName.substr(0, extensionIter);
+    }
 
-            }   // for face
+    return iter;
+}
 
-            assert(aiVertexIndices.size() % 3 == 0);
-            aaiTriangleVertexIndices.push_back(aiVertexIndices);
+/*
+**
+*/
+void getOBJSourceFiles(
+    std::vector<std::string>& aSourceFilePaths,
+    std::string const& directory)
+{
+    // every obj in the directory is converted, tinyobj pulls in their mtl files from the same directory
+    std::error_code errorCode;
+    for(auto const& entry : std::filesystem::directory_iterator(directory, errorCode))
+    {
+        std::string extension = entry.path().extension().string();
+        if(extension == ".obj" || extension == ".mtl")
+        {
+            aSourceFilePaths.push_back(entry.path().string());
+        }
+    }
 
-            MeshExtent meshExtent;
-            meshExtent.mMinPosition = float4(minPosition.x, minPosition.y, minPosition.z, 1.0f);
-            meshExtent.mMaxPosition = float4(maxPosition.x, maxPosition.y, maxPosition.z, 1.0f);
+    std::sort(aSourceFilePaths.begin(), aSourceFilePaths.end());
+}
 
-            aMeshExtents.push_back(meshExtent);
+/*
+**
+*/
+bool readManifest(
+    std::vector<std::string>& aEntries,
+    std::string const& manifestFilePath)
+{
+    FILE* fp = fopen(manifestFilePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
 
-            float3 center = (maxPosition + minPosition) * 0.5f;
-            aMeshCenters.push_back(center);
+    char szLine[4096];
+    while(fgets(szLine, sizeof(szLine), fp))
+    {
+        std::string line = szLine;
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        line.erase(0, line.find_first_not_of(" \t"));
+        if(line.length() <= 0 || line[0] == '#')
+        {
+            continue;
+        }
 
-            float3 bbox = maxPosition - minPosition;
-            aMeshBBoxes.push_back(bbox);
+        aEntries.push_back(line);
+    }
+    fclose(fp);
 
-            {
-                std::stringstream meshInstanceStringStream;
-                meshInstanceStringStream << bbox.x << "_" << bbox.y << "_" << bbox.z << "_" << aiVertexIndices.size();
-                std::string mapEntryName = meshInstanceStringStream.str();
-                aMeshInstanceIndices[mapEntryName].push_back((uint32_t)aMeshBBoxes.size() - 1);
-                
-            }
+    return true;
+}
 
-//if(s <= 10)
-//{
-//    break;
-//}
 
-        }   // for shape = 0 to num shapes
-    
-        DEBUG_PRINTF("added \"%s\" num meshes %d total num meshes: %d\n", 
-            baseName.c_str(), 
-            shapes.size(),
-            aMeshBBoxes.size());
+/*
+**
+*/
+bool convertOBJ(
+    std::vector<std::string>& aOutputFilePaths,
+    std::string const& fullPath)
+{
+    std::string directory = "", baseName = "";
+    parseInputPath(directory, baseName, fullPath);
 
-//break;
+    OBJMeshes meshes;
+    loadOBJDirectory(meshes, directory, giNumWorkerThreads);
+    if(gbOptimizeMeshes)
+    {
+        optimizeMeshes(meshes, giNumWorkerThreads);
+    }
+    if(giNumLods > 1)
+    {
+        buildMeshLods(meshes, giNumWorkerThreads);
+    }
 
-    }   // tiny obj
+    std::map<std::string, std::vector<uint32_t>>& aMeshInstanceIndices = meshes.maMeshInstanceIndices;
+    std::vector<Vertex>& aTotalVertices = meshes.maTotalVertices;
+    std::vector<std::vector<uint32_t>>& aaiTriangleVertexIndices = meshes.maaiTriangleVertexIndices;
+    std::vector<MeshExtent>& aMeshExtents = meshes.maMeshExtents;
+    std::vector<float3>& aMeshCenters = meshes.maMeshCenters;
+    std::vector<float3>& aMeshBBoxes = meshes.maMeshBBoxes;
+    std::vector<uint32_t>& aiMeshMaterialIDs = meshes.maiMeshMaterialIDs;
+    std::vector<OBJMaterialInfo>& aMeshMaterials = meshes.maMeshMaterials;
+    float3 const& totalMinPos = meshes.mTotalMinPosition;
+    float3 const& totalMaxPos = meshes.mTotalMaxPosition;
 
     // total mesh extent
     MeshExtent meshExtent;
@@ -466,6 +714,7 @@ int main(int argc, char* argv[])
     outputVerticesAndTriangles(
         aTotalVertices,
         aaiTriangleVertexIndices,
+        meshes.maMeshLodChains,
         aMeshExtents,
         directory,
         baseName);
@@ -499,59 +748,1126 @@ int main(int argc, char* argv[])
         aMeshRanges,
         aTestMeshExtents,
         loadFullPath);
+
+    std::string outputBasePath = directory + "/" + baseName;
+    aOutputFilePaths = 
+    {
+        outputBasePath + ".mat",
+        outputBasePath + "-mesh-instance-ids.bin",
+        outputBasePath + "-mesh-instance-positions.bin",
+        outputBasePath + "-mesh-instance-bboxes.bin",
+        outputBasePath + "-triangles.bin",
+        outputBasePath + "-triangle-positions.bin",
+        outputBasePath + ".mid",
+    };
+
+    return true;
 }
 
 /*
 **
 */
-void outputMeshMaterialIDs(
-    std::vector<uint32_t> const& aiMeshMaterialIDs,
-    std::string const& directory,
-    std::string const& baseName)
+void runWorkers(
+    uint32_t iNumThreads,
+    std::function<void(uint32_t)> const& worker)
 {
-    std::string fullPath = directory + "/" + baseName + ".mid";
-    FILE* fp = fopen(fullPath.c_str(), "wb");
-    fwrite(aiMeshMaterialIDs.data(), sizeof(uint32_t), aiMeshMaterialIDs.size(), fp);
-    fclose(fp);
+    // calling thread is worker 0
+    std::vector<std::thread> aThreads;
+    for(uint32_t iThread = 1; iThread < iNumThreads; iThread++)
+    {
+        aThreads.emplace_back(worker, iThread);
+    }
+    worker(0);
+    for(auto& thread : aThreads)
+    {
+        thread.join();
+    }
 }
 
 /*
 **
 */
-std::vector<std::string> split(const char* str, char c = ' ')
+void expandShapeAttributes(
+    std::vector<float>& afAttributes,
+    float3& minPosition,
+    float3& maxPosition,
+    tinyobj::attrib_t const& attrib,
+    tinyobj::shape_t const& shape)
 {
-    std::vector<std::string> result;
-    do
+    // face corners are stored back to back, NUM_WELD_ATTRIBUTES floats each
+    afAttributes.resize(shape.mesh.indices.size() * NUM_WELD_ATTRIBUTES);
+    float* pfAttribute = afAttributes.data();
+    for(tinyobj::index_t const& idx : shape.mesh.indices)
     {
-        const char* begin = str;
+        float vx = float(attrib.vertices[3 * idx.vertex_index + 0] * POSITION_MULT);
+        float vy = float(attrib.vertices[3 * idx.vertex_index + 1] * POSITION_MULT);
+        float vz = float(attrib.vertices[3 * idx.vertex_index + 2] * POSITION_MULT);
 
-        while(*str != c && *str)
-            str++;
+        float nx = 0.0f;
+        float ny = 0.0f;
+        float nz = 0.0f;
 
-        result.push_back(std::string(begin, str));
-    } while(0 != *str++);
+        float tx = 0.0f;
+        float ty = 0.0f;
 
-    return result;
+        // Check if normals and texcoords are loaded
+        if(idx.normal_index >= 0)
+        {
+            nx = attrib.normals[3 * idx.normal_index + 0];
+            ny = attrib.normals[3 * idx.normal_index + 1];
+            nz = attrib.normals[3 * idx.normal_index + 2];
+        }
+        if(idx.texcoord_index >= 0)
+        {
+            tx = attrib.texcoords[2 * idx.texcoord_index + 0];
+            ty = attrib.texcoords[2 * idx.texcoord_index + 1];
+        }
+
+        *pfAttribute++ = vx; *pfAttribute++ = vy; *pfAttribute++ = vz;
+        *pfAttribute++ = nx; *pfAttribute++ = ny; *pfAttribute++ = nz;
+        *pfAttribute++ = tx; *pfAttribute++ = ty;
+
+        minPosition = fminf(float3(vx, vy, vz), minPosition);
+        maxPosition = fmaxf(float3(vx, vy, vz), maxPosition);
+    }
 }
 
 /*
 **
 */
-void getPositionRange(
-    std::vector<uint32_t>& ret,
-    std::vector<std::vector<vec3>> const& aaPositions)
+void weldShape(
+    WeldedShape& weldedShape,
+    CVertexWelder& welder,
+    tinyobj::attrib_t const& attrib,
+    tinyobj::shape_t const& shape)
 {
-    uint32_t iPositionLength = (uint32_t)aaPositions.size();
-    ret.resize(2);
-    ret[0] = ret[1] = 0;
-
-    uint32_t iNumPositions = 0;
-    for(uint32_t i = 0; i < iPositionLength; i++)
+    std::vector<float> afAttributes;
+    expandShapeAttributes(
+        afAttributes,
+        weldedShape.mMinPosition,
+        weldedShape.mMaxPosition,
+        attrib,
+        shape);
+
+    std::vector<uint32_t> aiUniqueVertices;
+    welder.setTolerance(gfWeldTolerance);
+    welder.weld(
+        aiUniqueVertices,
+        weldedShape.maiIndices,
+        afAttributes.data(),
+        NUM_WELD_ATTRIBUTES,
+        (uint32_t)shape.mesh.indices.size());
+
+    // first occurrence of each unique vertex, the mesh index in position.w and uv.z is filled in by mergeOBJFile
+    weldedShape.maVertices.resize(aiUniqueVertices.size());
+    for(uint32_t i = 0; i < (uint32_t)aiUniqueVertices.size(); i++)
     {
-        iNumPositions += (uint32_t)aaPositions[i].size();
-        if(i == iPositionLength - 2)
-        {
-            ret[0] = iNumPositions;
+        float const* pfAttribute = afAttributes.data() + (uint64_t)aiUniqueVertices[i] * NUM_WELD_ATTRIBUTES;
+
+        Vertex& vertex = weldedShape.maVertices[i];
+        vertex.mPosition = float4(pfAttribute[0], pfAttribute[1], pfAttribute[2], 0.0f);
+        vertex.mNormal = float4(pfAttribute[3], pfAttribute[4], pfAttribute[5], 1.0f);
+        vertex.mUV = float4(pfAttribute[6], pfAttribute[7], 0.0f, 1.0f);
+    }
+}
+
+/*
+** parses the obj files and welds their shapes on iNumThreads threads while the calling thread merges finished files
+** in file name order. at most iNumThreads + 1 files are parsed and not merged yet, merged files are freed right away.
+*/
+void loadOBJDirectory(
+    OBJMeshes& meshes,
+    std::string const& directory,
+    uint32_t iNumThreads)
+{
+    std::vector<std::string> aOBJFilePaths;
+    std::error_code errorCode;
+    for(auto const& entry : std::filesystem::directory_iterator(directory, errorCode))
+    {
+        if(entry.path().extension().string() == ".obj")
+        {
+            aOBJFilePaths.push_back(entry.path().string());
+        }
+    }
+    std::sort(aOBJFilePaths.begin(), aOBJFilePaths.end());
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    uint32_t iNumFiles = (uint32_t)aOBJFilePaths.size();
+    std::vector<OBJFileJob> aJobs(iNumFiles);
+    for(uint32_t i = 0; i < iNumFiles; i++)
+    {
+        aJobs[i].mPath = aOBJFilePaths[i];
+        aJobs[i].mBaseName = std::filesystem::path(aOBJFilePaths[i]).stem().string();
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t iNextFileToParse = 0;
+    uint32_t iNumMergedFiles = 0;
+    uint32_t iMaxFilesInFlight = iNumThreads + 1;
+
+    auto worker = [&]()
+        {
+            CVertexWelder welder;
+            welder.setTolerance(gfWeldTolerance);
+            std::unique_lock<std::mutex> lock(mutex);
+            for(;;)
+            {
+                // welding the oldest parsed file first lets the merge move on and free it
+                OBJFileJob* pJob = nullptr;
+                uint32_t iShape = 0;
+                for(uint32_t iFile = iNumMergedFiles; iFile < iNextFileToParse; iFile++)
+                {
+                    OBJFileJob& job = aJobs[iFile];
+                    if(job.mbParsed && job.miNextShape < (uint32_t)job.maShapes.size())
+                    {
+                        pJob = &job;
+                        iShape = job.miNextShape++;
+                        break;
+                    }
+                }
+
+                if(pJob != nullptr)
+                {
+                    lock.unlock();
+                    weldShape(
+                        pJob->maWeldedShapes[iShape],
+                        welder,
+                        pJob->mAttrib,
+                        pJob->maShapes[iShape]);
+                    lock.lock();
+
+                    ++pJob->miNumWeldedShapes;
+                    condition.notify_all();
+                    continue;
+                }
+
+                if(iNextFileToParse < iNumFiles && iNextFileToParse - iNumMergedFiles < iMaxFilesInFlight)
+                {
+                    OBJFileJob& job = aJobs[iNextFileToParse++];
+                    lock.unlock();
+
+                    std::string warn, err;
+                    tinyobj::LoadObj(
+                        &job.mAttrib,
+                        &job.maShapes,
+                        &job.maMaterials,
+                        &warn,
+                        &err,
+                        job.mPath.c_str(),
+                        directory.c_str());
+                    job.maWeldedShapes.resize(job.maShapes.size());
+
+                    lock.lock();
+                    job.mbParsed = true;
+                    condition.notify_all();
+                    continue;
+                }
+
+                if(iNumMergedFiles >= iNumFiles)
+                {
+                    break;
+                }
+
+                condition.wait(lock);
+            }
+        };
+
+    std::vector<std::thread> aThreads;
+    for(uint32_t iThread = 0; iThread < iNumThreads; iThread++)
+    {
+        aThreads.emplace_back(worker);
+    }
+
+    // merge in file order as the files finish, keeps the output independent of the thread count
+    for(uint32_t iFile = 0; iFile < iNumFiles; iFile++)
+    {
+        OBJFileJob& job = aJobs[iFile];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(
+                lock,
+                [&job]()
+                {
+                    return job.mbParsed && job.miNumWeldedShapes == (uint32_t)job.maShapes.size();
+                });
+        }
+
+        mergeOBJFile(meshes, job);
+        job = OBJFileJob();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++iNumMergedFiles;
+        condition.notify_all();
+    }
+
+    for(auto& thread : aThreads)
+    {
+        thread.join();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+    DEBUG_PRINTF("loaded %d obj files, %" PRIu64 " vertices welded to %" PRIu64 " on %d threads in %.2f ms (%.2f M vertices/s)\n",
+        iNumFiles,
+        meshes.miNumWeldInputVertices,
+        (uint64_t)meshes.maTotalVertices.size(),
+        iNumThreads,
+        fMilliseconds,
+        double(meshes.miNumWeldInputVertices) / (std::max(fMilliseconds, 0.001) * 1000.0));
+}
+
+/*
+**
+*/
+void mergeOBJFile(
+    OBJMeshes& meshes,
+    OBJFileJob& job)
+{
+    std::vector<tinyobj::shape_t> const& shapes = job.maShapes;
+    std::vector<tinyobj::material_t> const& materials = job.maMaterials;
+    for(size_t s = 0; s < shapes.size(); s++)
+    {
+        std::ostringstream partNameStringStream;
+        partNameStringStream << job.mBaseName << "-" << "shape" << s;
+        meshes.maMeshNames.push_back(partNameStringStream.str());
+
+        OBJMaterialInfo material = {};
+        if(materials.size() > 0)
+        {
+            int32_t iMaterialID = shapes[s].mesh.material_ids[0];
+
+            material.mDiffuse = float4(
+                (float)materials[iMaterialID].diffuse[0], 
+                (float)materials[iMaterialID].diffuse[0], 
+                (float)materials[iMaterialID].diffuse[0], 1.0f);
+
+            material.mSpecular = float4(
+                (float)materials[iMaterialID].specular[0],
+                (float)materials[iMaterialID].specular[0],
+                (float)materials[iMaterialID].specular[0], 1.0f);
+
+            material.mEmissive = float4(
+                (float)materials[iMaterialID].emission[0],
+                (float)materials[iMaterialID].emission[0],
+                (float)materials[iMaterialID].emission[0], 1.0f);
+
+            material.mAlbedoTexturePath = materials[iMaterialID].diffuse_texname;
+            material.mEmissiveTexturePath = materials[iMaterialID].emissive_texname;
+            material.mSpecularTexturePath = materials[iMaterialID].specular_texname;
+            material.mNormalTexturePath = materials[iMaterialID].normal_texname;
+        }
+        else 
+        {
+            float fRed = float(rand() % 255) / 255.0f;
+            float fGreen = float(rand() % 255) / 255.0f;
+            float fBlue = float(rand() % 255) / 255.0f;
+            material.mDiffuse = float4(fRed, fGreen, fBlue, 1.0f);
+        }
+
+        meshes.maMeshMaterials.push_back(material);
+        meshes.maiMeshMaterialIDs.push_back((uint32_t)meshes.maMeshMaterials.size() - 1);
+
+        // vertex indices move past the vertices of the previous shapes
+        WeldedShape& weldedShape = job.maWeldedShapes[s];
+        meshes.miNumWeldInputVertices += weldedShape.maiIndices.size();
+
+        uint32_t iMeshIndex = (uint32_t)meshes.maMeshExtents.size();
+        uint32_t iVertexOffset = (uint32_t)meshes.maTotalVertices.size();
+        meshes.maiMeshVertexStarts.push_back(iVertexOffset);
+        for(auto& iVertexIndex : weldedShape.maiIndices)
+        {
+            iVertexIndex += iVertexOffset;
+        }
+        for(auto& vertex : weldedShape.maVertices)
+        {
+            vertex.mPosition.w = (float)iMeshIndex;
+            vertex.mUV.z = (float)iMeshIndex;
+        }
+        meshes.maTotalVertices.insert(meshes.maTotalVertices.end(), weldedShape.maVertices.begin(), weldedShape.maVertices.end());
+
+        float3 const& minPosition = weldedShape.mMinPosition;
+        float3 const& maxPosition = weldedShape.mMaxPosition;
+        meshes.mTotalMinPosition = fminf(meshes.mTotalMinPosition, minPosition);
+        meshes.mTotalMaxPosition = fmaxf(meshes.mTotalMaxPosition, maxPosition);
+
+        uint32_t iNumIndices = (uint32_t)weldedShape.maiIndices.size();
+        assert(iNumIndices % 3 == 0);
+        meshes.maaiTriangleVertexIndices.push_back(std::move(weldedShape.maiIndices));
+
+        MeshExtent meshExtent;
+        meshExtent.mMinPosition = float4(minPosition.x, minPosition.y, minPosition.z, 1.0f);
+        meshExtent.mMaxPosition = float4(maxPosition.x, maxPosition.y, maxPosition.z, 1.0f);
+        meshes.maMeshExtents.push_back(meshExtent);
+
+        float3 center = (maxPosition + minPosition) * 0.5f;
+        meshes.maMeshCenters.push_back(center);
+
+        float3 bbox = maxPosition - minPosition;
+        meshes.maMeshBBoxes.push_back(bbox);
+
+        {
+            std::stringstream meshInstanceStringStream;
+            meshInstanceStringStream << bbox.x << "_" << bbox.y << "_" << bbox.z << "_" << iNumIndices;
+            std::string mapEntryName = meshInstanceStringStream.str();
+            meshes.maMeshInstanceIndices[mapEntryName].push_back((uint32_t)meshes.maMeshBBoxes.size() - 1);
+        }
+
+        weldedShape = WeldedShape();
+
+    }   // for shape = 0 to num shapes
+
+    DEBUG_PRINTF("added \"%s\" num meshes %d total num meshes: %d\n", 
+        job.mBaseName.c_str(), 
+        (uint32_t)shapes.size(),
+        (uint32_t)meshes.maMeshBBoxes.size());
+}
+
+/*
+** reorders the triangles of every mesh for the post transform cache and overdraw, then its vertices in the order
+** the triangles fetch them. meshes own disjoint vertex ranges so they are optimized on their own, in parallel
+*/
+void optimizeMeshes(
+    OBJMeshes& meshes,
+    uint32_t iNumThreads)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    uint32_t iNumMeshes = (uint32_t)meshes.maaiTriangleVertexIndices.size();
+    assert(meshes.maiMeshVertexStarts.size() == iNumMeshes);
+    std::vector<CMeshOptimizer::VertexCacheStats> aBefore(iNumMeshes), aAfter(iNumMeshes);
+
+    std::atomic<uint32_t> iNextMesh(0);
+    runWorkers(
+        iNumThreads,
+        [&](uint32_t)
+        {
+            CMeshOptimizer optimizer;
+            std::vector<uint32_t> aiRemap;
+            for(uint32_t iMesh = iNextMesh++; iMesh < iNumMeshes; iMesh = iNextMesh++)
+            {
+                uint32_t iVertexStart = meshes.maiMeshVertexStarts[iMesh];
+                uint32_t iVertexEnd = (iMesh + 1 < iNumMeshes) ? meshes.maiMeshVertexStarts[iMesh + 1] : (uint32_t)meshes.maTotalVertices.size();
+                uint32_t iNumVertices = iVertexEnd - iVertexStart;
+                if(iNumVertices == 0)
+                {
+                    continue;
+                }
+
+                std::vector<uint32_t>& aiIndices = meshes.maaiTriangleVertexIndices[iMesh];
+                for(auto& iIndex : aiIndices)
+                {
+                    iIndex -= iVertexStart;
+                }
+
+                std::vector<Vertex> aVertices(
+                    meshes.maTotalVertices.begin() + iVertexStart,
+                    meshes.maTotalVertices.begin() + iVertexEnd);
+
+                aBefore[iMesh] = optimizer.analyzeVertexCache(aiIndices, iNumVertices);
+                optimizer.optimizeVertexCache(aiIndices, iNumVertices);
+                optimizer.optimizeOverdraw(
+                    aiIndices,
+                    &aVertices[0].mPosition.x,
+                    (uint32_t)(sizeof(Vertex) / sizeof(float)),
+                    iNumVertices);
+                optimizer.optimizeVertexFetch(aiRemap, aiIndices, iNumVertices);
+                aAfter[iMesh] = optimizer.analyzeVertexCache(aiIndices, iNumVertices);
+
+                CMeshOptimizer::remapVertices(aVertices, aiRemap);
+                std::copy(aVertices.begin(), aVertices.end(), meshes.maTotalVertices.begin() + iVertexStart);
+                for(auto& iIndex : aiIndices)
+                {
+                    iIndex += iVertexStart;
+                }
+            }
+        });
+
+    auto sumStats = [](std::vector<CMeshOptimizer::VertexCacheStats> const& aStats)
+        {
+            CMeshOptimizer::VertexCacheStats total;
+            for(auto const& stats : aStats)
+            {
+                total.miNumTriangles += stats.miNumTriangles;
+                total.miNumVertices += stats.miNumVertices;
+                total.miNumTransformed += stats.miNumTransformed;
+            }
+            total.mfACMR = (total.miNumTriangles > 0) ? float(total.miNumTransformed) / float(total.miNumTriangles) : 0.0f;
+            total.mfATVR = (total.miNumVertices > 0) ? float(total.miNumTransformed) / float(total.miNumVertices) : 0.0f;
+            return total;
+        };
+    CMeshOptimizer::VertexCacheStats before = sumStats(aBefore);
+    CMeshOptimizer::VertexCacheStats after = sumStats(aAfter);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+    DEBUG_PRINTF("optimized %d meshes, %d triangles in %.2f ms, %d entry cache acmr %.3f -> %.3f atvr %.3f -> %.3f\n",
+        iNumMeshes,
+        after.miNumTriangles,
+        fMilliseconds,
+        MESH_OPTIMIZER_CACHE_SIZE,
+        before.mfACMR,
+        after.mfACMR,
+        before.mfATVR,
+        after.mfATVR);
+}
+
+/*
+** coarser levels of every mesh from one simplifier run each, so the errors are all against the full mesh. the
+** levels share the full mesh's vertices and get their own vertex cache order
+*/
+void buildMeshLods(
+    OBJMeshes& meshes,
+    uint32_t iNumThreads)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    uint32_t iNumMeshes = (uint32_t)meshes.maaiTriangleVertexIndices.size();
+    assert(meshes.maiMeshVertexStarts.size() == iNumMeshes);
+    meshes.maMeshLodChains.assign(iNumMeshes, MeshLodChain());
+
+    std::atomic<uint32_t> iNextMesh(0);
+    runWorkers(
+        iNumThreads,
+        [&](uint32_t)
+        {
+            CMeshSimplifier simplifier;
+            CMeshOptimizer optimizer;
+            std::vector<uint32_t> aiIndices;
+            for(uint32_t iMesh = iNextMesh++; iMesh < iNumMeshes; iMesh = iNextMesh++)
+            {
+                uint32_t iVertexStart = meshes.maiMeshVertexStarts[iMesh];
+                uint32_t iVertexEnd = (iMesh + 1 < iNumMeshes) ? meshes.maiMeshVertexStarts[iMesh + 1] : (uint32_t)meshes.maTotalVertices.size();
+                uint32_t iNumVertices = iVertexEnd - iVertexStart;
+                if(iNumVertices == 0)
+                {
+                    continue;
+                }
+
+                aiIndices = meshes.maaiTriangleVertexIndices[iMesh];
+                for(auto& iIndex : aiIndices)
+                {
+                    iIndex -= iVertexStart;
+                }
+
+                float3 minPosition = float3(meshes.maMeshExtents[iMesh].mMinPosition);
+                float3 maxPosition = float3(meshes.maMeshExtents[iMesh].mMaxPosition);
+                float fMaxError = length(maxPosition - minPosition) * 0.5f * LOD_MAX_RELATIVE_ERROR;
+
+                simplifier.init(
+                    aiIndices,
+                    &meshes.maTotalVertices[iVertexStart].mPosition.x,
+                    (uint32_t)(sizeof(Vertex) / sizeof(float)),
+                    iNumVertices);
+
+                MeshLodChain& chain = meshes.maMeshLodChains[iMesh];
+                uint32_t iNumPrevIndices = (uint32_t)aiIndices.size();
+                for(uint32_t iLod = 1; iLod < giNumLods; iLod++)
+                {
+                    uint32_t iTargetNumIndices = (uint32_t)(float(iNumPrevIndices / 3) * LOD_TRIANGLE_RATIO) * 3;
+                    float fError = simplifier.simplify(iTargetNumIndices, fMaxError);
+
+                    std::vector<uint32_t> const& aiLodIndices = simplifier.getIndices();
+                    if(aiLodIndices.size() == 0 || float(aiLodIndices.size()) > float(iNumPrevIndices) * LOD_MIN_REDUCTION)
+                    {
+                        break;
+                    }
+                    iNumPrevIndices = (uint32_t)aiLodIndices.size();
+
+                    chain.maaiIndices.push_back(aiLodIndices);
+                    chain.mafErrors.push_back(fError);
+                    std::vector<uint32_t>& aiLevelIndices = chain.maaiIndices.back();
+                    if(gbOptimizeMeshes)
+                    {
+                        optimizer.optimizeVertexCache(aiLevelIndices, iNumVertices);
+                    }
+                    for(auto& iIndex : aiLevelIndices)
+                    {
+                        iIndex += iVertexStart;
+                    }
+                }
+            }
+        });
+
+    // triangles per level over all the meshes, a mesh whose chain ended early counts its last level
+    std::array<uint64_t, MESH_MAX_LODS> aiNumLodTriangles = {};
+    uint32_t iNumFullChains = 0;
+    float fLargestRelativeError = 0.0f;
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        MeshLodChain const& chain = meshes.maMeshLodChains[iMesh];
+        uint64_t iNumTriangles = meshes.maaiTriangleVertexIndices[iMesh].size() / 3;
+        for(uint32_t iLod = 0; iLod < giNumLods; iLod++)
+        {
+            if(iLod > 0 && iLod <= (uint32_t)chain.maaiIndices.size())
+            {
+                iNumTriangles = chain.maaiIndices[iLod - 1].size() / 3;
+            }
+            aiNumLodTriangles[iLod] += iNumTriangles;
+        }
+
+        iNumFullChains += (chain.maaiIndices.size() + 1 == giNumLods) ? 1 : 0;
+        if(chain.mafErrors.size() > 0)
+        {
+            float fRadius = length(float3(meshes.maMeshExtents[iMesh].mMaxPosition) - float3(meshes.maMeshExtents[iMesh].mMinPosition)) * 0.5f;
+            fLargestRelativeError = std::max(fLargestRelativeError, chain.mafErrors.back() / std::max(fRadius, 1.0e-6f));
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+    std::string levels = "";
+    for(uint32_t iLod = 0; iLod < giNumLods; iLod++)
+    {
+        char szLevel[64];
+        snprintf(szLevel, sizeof(szLevel), " %" PRIu64 " (%.1f%%)",
+            aiNumLodTriangles[iLod],
+            (aiNumLodTriangles[0] > 0) ? 100.0 * double(aiNumLodTriangles[iLod]) / double(aiNumLodTriangles[0]) : 0.0);
+        levels += szLevel;
+    }
+    DEBUG_PRINTF("simplified %d meshes in %.2f ms on %d threads, %.2f M triangles/s, %d with all %d levels, largest error %.2f%% of the radius, triangles per level:%s\n",
+        iNumMeshes,
+        fMilliseconds,
+        iNumThreads,
+        double(aiNumLodTriangles[0]) / (std::max(fMilliseconds, 1.0e-3) * 1000.0),
+        iNumFullChains,
+        giNumLods,
+        fLargestRelativeError * 100.0f,
+        levels.c_str());
+}
+
+/*
+** meshlets of every mesh in mesh order, aMeshletRanges are [start, end) into aMeshlets per mesh. the meshes' indices
+** are back to back in the index buffer from iFirstIndex
+*/
+void buildMeshlets(
+    std::vector<Render::Meshlet>& aMeshlets,
+    std::vector<MeshRange>& aMeshletRanges,
+    std::vector<Vertex> const& aTotalVertices,
+    std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices,
+    uint32_t iFirstIndex,
+    uint32_t iNumThreads)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    uint32_t iNumMeshes = (uint32_t)aaiTriangleVertexIndices.size();
+    std::vector<uint32_t> aiIndexStarts(iNumMeshes);
+    uint32_t iIndexStart = iFirstIndex;
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        aiIndexStarts[iMesh] = iIndexStart;
+        iIndexStart += (uint32_t)aaiTriangleVertexIndices[iMesh].size();
+    }
+
+    std::vector<std::vector<Render::Meshlet>> aaMeshMeshlets(iNumMeshes);
+    std::atomic<uint32_t> iNextMesh(0);
+    runWorkers(
+        iNumThreads,
+        [&](uint32_t)
+        {
+            CMeshletBuilder builder;
+            for(uint32_t iMesh = iNextMesh++; iMesh < iNumMeshes; iMesh = iNextMesh++)
+            {
+                std::vector<uint32_t> const& aiIndices = aaiTriangleVertexIndices[iMesh];
+                builder.build(
+                    aaMeshMeshlets[iMesh],
+                    aiIndices.data(),
+                    (uint32_t)aiIndices.size(),
+                    aiIndexStarts[iMesh],
+                    iMesh,
+                    &aTotalVertices[0].mPosition.x,
+                    (uint32_t)(sizeof(Vertex) / sizeof(float)));
+            }
+        });
+
+    aMeshlets.clear();
+    aMeshletRanges.resize(iNumMeshes);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        aMeshletRanges[iMesh].miStart = (uint32_t)aMeshlets.size();
+        aMeshlets.insert(aMeshlets.end(), aaMeshMeshlets[iMesh].begin(), aaMeshMeshlets[iMesh].end());
+        aMeshletRanges[iMesh].miEnd = (uint32_t)aMeshlets.size();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+    CMeshletBuilder::Stats stats = CMeshletBuilder::analyze(aMeshlets);
+    DEBUG_PRINTF("built %d meshlets in %.2f ms, %.1f vertices %.1f triangles per meshlet, %d with a normal cone\n",
+        stats.miNumMeshlets,
+        fMilliseconds,
+        (stats.miNumMeshlets > 0) ? float(stats.miNumVertices) / float(stats.miNumMeshlets) : 0.0f,
+        (stats.miNumMeshlets > 0) ? float(stats.miNumTriangles) / float(stats.miNumMeshlets) : 0.0f,
+        stats.miNumConeMeshlets);
+}
+
+/*
+** meshlet build time, checks of the limits and bounds, then the cpu reference of cluster-culling-compute.shader
+** against whole mesh culling from random cameras around the model
+*/
+int benchmarkMeshlets(
+    std::string const& fullPath,
+    uint32_t iNumIterations)
+{
+    std::string directory = "", baseName = "";
+    parseInputPath(directory, baseName, fullPath);
+
+    OBJMeshes meshes;
+    loadOBJDirectory(meshes, directory, giNumWorkerThreads);
+    if(gbOptimizeMeshes)
+    {
+        optimizeMeshes(meshes, giNumWorkerThreads);
+    }
+
+    std::vector<Vertex> const& aTotalVertices = meshes.maTotalVertices;
+    std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices = meshes.maaiTriangleVertexIndices;
+    uint32_t iNumMeshes = (uint32_t)aaiTriangleVertexIndices.size();
+    if(iNumMeshes == 0)
+    {
+        DEBUG_PRINTF("!!! no obj meshes in \"%s\" !!!\n", directory.c_str());
+        return 1;
+    }
+
+    std::vector<Render::Meshlet> aMeshlets;
+    std::vector<MeshRange> aMeshletRanges;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+    {
+        buildMeshlets(aMeshlets, aMeshletRanges, aTotalVertices, aaiTriangleVertexIndices, 0, 1);
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+
+    uint64_t iNumTotalTriangles = 0;
+    for(auto const& aiIndices : aaiTriangleVertexIndices)
+    {
+        iNumTotalTriangles += aiIndices.size() / 3;
+    }
+    DEBUG_PRINTF("%d meshes, %" PRIu64 " triangles, meshlets built in %.2f ms on 1 thread, %.2f M triangles/s\n",
+        iNumMeshes,
+        iNumTotalTriangles,
+        fMilliseconds / double(iNumIterations),
+        double(iNumTotalTriangles) * double(iNumIterations) / (fMilliseconds * 1000.0));
+
+    auto getPosition = [&](uint32_t iVertex)
+        {
+            return &aTotalVertices[iVertex].mPosition.x;
+        };
+
+    // limits, every triangle in exactly one meshlet and every vertex inside its meshlet's sphere
+    uint32_t iNumErrors = 0;
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        uint32_t iIndexStart = aMeshletRanges[iMesh].miStart < aMeshletRanges[iMesh].miEnd ? aMeshlets[aMeshletRanges[iMesh].miStart].miIndexStart : 0;
+        uint32_t iNumMeshTriangles = 0;
+        for(uint32_t iMeshlet = aMeshletRanges[iMesh].miStart; iMeshlet < aMeshletRanges[iMesh].miEnd; iMeshlet++)
+        {
+            Render::Meshlet const& meshlet = aMeshlets[iMeshlet];
+            iNumErrors += (meshlet.miMesh != iMesh || meshlet.miIndexStart != iIndexStart + iNumMeshTriangles * 3) ? 1 : 0;
+            iNumErrors += (meshlet.miNumVertices > MESHLET_MAX_VERTICES || meshlet.miNumTriangles > MESHLET_MAX_TRIANGLES) ? 1 : 0;
+
+            uint32_t const* paiIndices = aaiTriangleVertexIndices[iMesh].data() + iNumMeshTriangles * 3;
+            for(uint32_t i = 0; i < meshlet.miNumTriangles * 3; i++)
+            {
+                float3 diff = float3(getPosition(paiIndices[i])[0], getPosition(paiIndices[i])[1], getPosition(paiIndices[i])[2]) -
+                    float3(meshlet.mafSphere[0], meshlet.mafSphere[1], meshlet.mafSphere[2]);
+                iNumErrors += (length(diff) > meshlet.mafSphere[3] * 1.0001f + 1.0e-6f) ? 1 : 0;
+            }
+            iNumMeshTriangles += meshlet.miNumTriangles;
+        }
+        iNumErrors += (iNumMeshTriangles * 3 != (uint32_t)aaiTriangleVertexIndices[iMesh].size()) ? 1 : 0;
+    }
+
+    // random cameras outside and inside the model looking at a point in it
+    float3 const& totalMin = meshes.mTotalMinPosition;
+    float3 const& totalMax = meshes.mTotalMaxPosition;
+    float3 totalCenter = (totalMin + totalMax) * 0.5f;
+    float3 totalSize = totalMax - totalMin;
+    float fSize = std::max(std::max(totalSize.x, totalSize.y), totalSize.z);
+    float fFar = fSize * 4.0f + 1.0f;
+    auto randomPoint = [&](float fScale)
+        {
+            return totalCenter + float3(fSize, fSize, fSize) * float3(
+                (float(rand()) / float(RAND_MAX) - 0.5f) * fScale,
+                (float(rand()) / float(RAND_MAX) - 0.5f) * fScale,
+                (float(rand()) / float(RAND_MAX) - 0.5f) * fScale);
+        };
+
+    uint32_t const iNumCameras = 256;
+    std::vector<float3> aCameraPositions(iNumCameras);
+    std::vector<std::array<std::array<float, 4>, MESHLET_NUM_FRUSTUM_PLANES>> aaaFrustumPlanes(iNumCameras);
+    srand(0);
+    for(uint32_t iCamera = 0; iCamera < iNumCameras; iCamera++)
+    {
+        aCameraPositions[iCamera] = randomPoint(2.0f);
+        float3 lookAt = randomPoint(0.5f);
+        float4x4 viewMatrix = makeViewMatrix(aCameraPositions[iCamera], lookAt, float3(0.0f, 1.0f, 0.0f));
+        float4x4 projectionMatrix = perspectiveProjection(3.14159f / 3.0f, 1920, 1080, fFar, 0.1f);
+        float4x4 viewProjectionMatrix = projectionMatrix * viewMatrix;
+        Render::computeFrustumPlanes((float (*)[4])aaaFrustumPlanes[iCamera].data(), viewProjectionMatrix.mafEntries);
+    }
+
+    // a back facing cone has to mean every triangle of the meshlet faces away
+    for(uint32_t iCamera = 0; iCamera < iNumCameras; iCamera++)
+    {
+        float const* pfCameraPosition = &aCameraPositions[iCamera].x;
+        for(auto const& meshlet : aMeshlets)
+        {
+            if(!Render::isMeshletBackFacing(meshlet, pfCameraPosition))
+            {
+                continue;
+            }
+
+            uint32_t const* paiIndices = aaiTriangleVertexIndices[meshlet.miMesh].data() + (meshlet.miIndexStart - aMeshlets[aMeshletRanges[meshlet.miMesh].miStart].miIndexStart);
+            for(uint32_t iTriangle = 0; iTriangle < meshlet.miNumTriangles; iTriangle++)
+            {
+                float3 p0 = float3(getPosition(paiIndices[iTriangle * 3])[0], getPosition(paiIndices[iTriangle * 3])[1], getPosition(paiIndices[iTriangle * 3])[2]);
+                float3 p1 = float3(getPosition(paiIndices[iTriangle * 3 + 1])[0], getPosition(paiIndices[iTriangle * 3 + 1])[1], getPosition(paiIndices[iTriangle * 3 + 1])[2]);
+                float3 p2 = float3(getPosition(paiIndices[iTriangle * 3 + 2])[0], getPosition(paiIndices[iTriangle * 3 + 2])[1], getPosition(paiIndices[iTriangle * 3 + 2])[2]);
+                float3 normal = cross(p1 - p0, p2 - p0);
+                float fLength = length(normal);
+                if(fLength > 0.0f && dot(normal / fLength, aCameraPositions[iCamera] - p0) > 1.0e-4f * length(aCameraPositions[iCamera] - p0))
+                {
+                    ++iNumErrors;
+                }
+            }
+        }
+    }
+
+    // whole meshes against the sphere around their extent, what mesh-culling-compute.shader keeps, then meshlets
+    std::vector<float> afMeshSpheres(iNumMeshes * 4);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        float3 minPosition = float3(meshes.maMeshExtents[iMesh].mMinPosition);
+        float3 maxPosition = float3(meshes.maMeshExtents[iMesh].mMaxPosition);
+        float3 center = (minPosition + maxPosition) * 0.5f;
+        afMeshSpheres[iMesh * 4] = center.x;
+        afMeshSpheres[iMesh * 4 + 1] = center.y;
+        afMeshSpheres[iMesh * 4 + 2] = center.z;
+        afMeshSpheres[iMesh * 4 + 3] = length(maxPosition - center);
+    }
+
+    uint64_t aiNumVisibleTriangles[3] = {0, 0, 0};
+    uint64_t iNumMeshletTests = 0;
+    startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+    {
+        aiNumVisibleTriangles[0] = aiNumVisibleTriangles[1] = aiNumVisibleTriangles[2] = 0;
+        iNumMeshletTests = 0;
+        for(uint32_t iCamera = 0; iCamera < iNumCameras; iCamera++)
+        {
+            float const (*pafPlanes)[4] = (float const (*)[4])aaaFrustumPlanes[iCamera].data();
+            float const* pfCameraPosition = &aCameraPositions[iCamera].x;
+            for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+            {
+                if(Render::isSphereOutsideFrustum(&afMeshSpheres[iMesh * 4], pafPlanes))
+                {
+                    continue;
+                }
+                aiNumVisibleTriangles[0] += aaiTriangleVertexIndices[iMesh].size() / 3;
+
+                for(uint32_t iMeshlet = aMeshletRanges[iMesh].miStart; iMeshlet < aMeshletRanges[iMesh].miEnd; iMeshlet++)
+                {
+                    Render::Meshlet const& meshlet = aMeshlets[iMeshlet];
+                    ++iNumMeshletTests;
+                    if(Render::cullMeshlet(meshlet, pafPlanes, pfCameraPosition, false))
+                    {
+                        continue;
+                    }
+                    aiNumVisibleTriangles[1] += meshlet.miNumTriangles;
+                    aiNumVisibleTriangles[2] += Render::isMeshletBackFacing(meshlet, pfCameraPosition) ? 0 : meshlet.miNumTriangles;
+                }
+            }
+        }
+    }
+    endTime = std::chrono::high_resolution_clock::now();
+    fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+
+    uint64_t iNumCameraTriangles = iNumTotalTriangles * iNumCameras;
+    DEBUG_PRINTF("%d cameras, triangles drawn: %.1f%% whole meshes, %.1f%% meshlet frustum culling, %.1f%% with normal cones\n",
+        iNumCameras,
+        100.0 * double(aiNumVisibleTriangles[0]) / double(std::max(iNumCameraTriangles, (uint64_t)1)),
+        100.0 * double(aiNumVisibleTriangles[1]) / double(std::max(iNumCameraTriangles, (uint64_t)1)),
+        100.0 * double(aiNumVisibleTriangles[2]) / double(std::max(iNumCameraTriangles, (uint64_t)1)));
+    DEBUG_PRINTF("cpu reference culling %.2f us per camera, %.2f ns per meshlet\n",
+        fMilliseconds * 1.0e3 / double(iNumIterations * iNumCameras),
+        fMilliseconds * 1.0e6 / double(std::max(iNumMeshletTests * iNumIterations, (uint64_t)1)));
+    DEBUG_PRINTF("meshlet bounds %s, %d errors\n", (iNumErrors == 0) ? "valid" : "INVALID", iNumErrors);
+
+    return (iNumErrors == 0) ? 0 : 1;
+}
+
+/*
+** the welding this tool did before CVertexWelder, printed attributes as std::map keys. reference for --benchmark-weld
+*/
+void weldWithStringKeys(
+    std::vector<uint32_t>& aiUniqueVertices,
+    std::vector<uint32_t>& aiRemap,
+    std::vector<float> const& afAttributes,
+    uint32_t iShape)
+{
+    std::map<std::string, uint32_t> aVertexMap;
+    uint32_t iNumVertices = (uint32_t)(afAttributes.size() / NUM_WELD_ATTRIBUTES);
+    aiUniqueVertices.clear();
+    aiRemap.resize(iNumVertices);
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        float const* pfAttribute = afAttributes.data() + (uint64_t)iVertex * NUM_WELD_ATTRIBUTES;
+
+        std::ostringstream oss;
+        oss << pfAttribute[0] * 100.0f << "_" << pfAttribute[1] * 100.0f << "_" << pfAttribute[2] * 100.0f << "_" <<
+            pfAttribute[3] << "_" << pfAttribute[4] << "_" << pfAttribute[5] << "_" <<
+            pfAttribute[6] << "_" << pfAttribute[7] << "_" << iShape;
+
+        auto iter = aVertexMap.find(oss.str());
+        if(iter == aVertexMap.end())
+        {
+            aVertexMap[oss.str()] = (uint32_t)aiUniqueVertices.size();
+            aiRemap[iVertex] = (uint32_t)aiUniqueVertices.size();
+            aiUniqueVertices.push_back(iVertex);
+        }
+        else
+        {
+            aiRemap[iVertex] = iter->second;
+        }
+    }
+}
+
+/*
+** vertices welded per second with the string keys, CVertexWelder on one thread and on --threads threads
+*/
+int benchmarkWeld(
+    std::string const& fullPath,
+    uint32_t iNumIterations)
+{
+    std::string directory = "", baseName = "";
+    size_t iter = parseInputPath(directory, baseName, fullPath);
+
+    std::vector<std::vector<float>> aafShapeAttributes;
+    uint64_t iNumVertices = 0;
+    for(auto const& entry : std::filesystem::directory_iterator(directory))
+    {
+        std::string path = entry.path().string();
+        if(path.substr(iter + 1).rfind(".obj") == std::string::npos)
+        {
+            continue;
+        }
+
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), directory.c_str());
+        for(auto const& shape : shapes)
+        {
+            float3 minPosition = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+            float3 maxPosition = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            aafShapeAttributes.emplace_back();
+            expandShapeAttributes(aafShapeAttributes.back(), minPosition, maxPosition, attrib, shape);
+            iNumVertices += shape.mesh.indices.size();
+        }
+    }
+
+    uint32_t iNumShapes = (uint32_t)aafShapeAttributes.size();
+    if(iNumShapes == 0)
+    {
+        DEBUG_PRINTF("!!! no obj shapes in \"%s\" !!!\n", directory.c_str());
+        return 1;
+    }
+
+    std::vector<std::vector<uint32_t>> aaiReferenceUnique(iNumShapes), aaiReferenceRemap(iNumShapes);
+    std::vector<std::vector<uint32_t>> aaiUnique(iNumShapes), aaiRemap(iNumShapes);
+    std::vector<CVertexWelder> aWelders(giNumWorkerThreads);
+
+    auto runHashWeld = [&](uint32_t iNumThreads)
+        {
+            std::atomic<uint32_t> iNextShape(0);
+            runWorkers(
+                iNumThreads,
+                [&](uint32_t iThread)
+                {
+                    aWelders[iThread].setTolerance(gfWeldTolerance);
+                    for(uint32_t iShape = iNextShape++; iShape < iNumShapes; iShape = iNextShape++)
+                    {
+                        aWelders[iThread].weld(
+                            aaiUnique[iShape],
+                            aaiRemap[iShape],
+                            aafShapeAttributes[iShape].data(),
+                            NUM_WELD_ATTRIBUTES,
+                            (uint32_t)(aafShapeAttributes[iShape].size() / NUM_WELD_ATTRIBUTES));
+                    }
+                });
+        };
+
+    auto report = [&](char const* szName, std::chrono::high_resolution_clock::time_point startTime)
+        {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+            DEBUG_PRINTF("%-24s %10.2f ms %10.2f M vertices/s\n",
+                szName,
+                fMilliseconds / double(iNumIterations),
+                double(iNumVertices) * double(iNumIterations) / (fMilliseconds * 1000.0));
+        };
+
+    DEBUG_PRINTF("%d shapes, %" PRIu64 " vertices, %d iterations, weld tolerance %f\n", iNumShapes, iNumVertices, iNumIterations, gfWeldTolerance);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+    {
+        for(uint32_t iShape = 0; iShape < iNumShapes; iShape++)
+        {
+            weldWithStringKeys(aaiReferenceUnique[iShape], aaiReferenceRemap[iShape], aafShapeAttributes[iShape], iShape);
+        }
+    }
+    report("string keys", startTime);
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+    {
+        runHashWeld(1);
+    }
+    report("hash, 1 thread", startTime);
+
+    if(giNumWorkerThreads > 1)
+    {
+        char szName[64];
+        snprintf(szName, sizeof(szName), "hash, %d threads", giNumWorkerThreads);
+        startTime = std::chrono::high_resolution_clock::now();
+        for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+        {
+            runHashWeld(giNumWorkerThreads);
+        }
+        report(szName, startTime);
+    }
+
+    // the string keys also weld values that print the same with 6 digits, only those shapes can differ
+    uint32_t iNumIdentical = 0;
+    uint64_t iNumReferenceUnique = 0, iNumUnique = 0;
+    for(uint32_t iShape = 0; iShape < iNumShapes; iShape++)
+    {
+        iNumReferenceUnique += aaiReferenceUnique[iShape].size();
+        iNumUnique += aaiUnique[iShape].size();
+        if(aaiReferenceUnique[iShape] == aaiUnique[iShape] && aaiReferenceRemap[iShape] == aaiRemap[iShape])
+        {
+            ++iNumIdentical;
+        }
+    }
+    DEBUG_PRINTF("unique vertices: %" PRIu64 " string keys, %" PRIu64 " hash, %d of %d shapes identical\n",
+        iNumReferenceUnique,
+        iNumUnique,
+        iNumIdentical,
+        iNumShapes);
+
+    return 0;
+}
+
+/*
+** load time of the whole directory with 1, 2, 4 ... up to --threads threads, the merged meshes have to match
+*/
+int benchmarkThreads(
+    std::string const& fullPath)
+{
+    std::string directory = "", baseName = "";
+    parseInputPath(directory, baseName, fullPath);
+
+    std::vector<uint32_t> aiThreadCounts;
+    for(uint32_t iNumThreads = 1; iNumThreads < giNumWorkerThreads; iNumThreads <<= 1)
+    {
+        aiThreadCounts.push_back(iNumThreads);
+    }
+    aiThreadCounts.push_back(std::max(giNumWorkerThreads, 1u));
+
+    std::vector<Vertex> aReferenceVertices;
+    uint64_t iNumReferenceIndices = 0;
+    bool bMatching = true;
+    for(uint32_t iNumThreads : aiThreadCounts)
+    {
+        // same random material colours for every run
+        srand(0);
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        OBJMeshes meshes;
+        loadOBJDirectory(meshes, directory, iNumThreads);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        double fMilliseconds = double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001;
+
+        uint64_t iNumIndices = 0;
+        for(auto const& aiIndices : meshes.maaiTriangleVertexIndices)
+        {
+            iNumIndices += aiIndices.size();
+        }
+
+        if(iNumThreads == aiThreadCounts[0])
+        {
+            aReferenceVertices = meshes.maTotalVertices;
+            iNumReferenceIndices = iNumIndices;
+        }
+        else if(iNumIndices != iNumReferenceIndices ||
+            meshes.maTotalVertices.size() != aReferenceVertices.size() ||
+            memcmp(meshes.maTotalVertices.data(), aReferenceVertices.data(), aReferenceVertices.size() * sizeof(Vertex)) != 0)
+        {
+            bMatching = false;
+        }
+
+        DEBUG_PRINTF("%2d threads %10.2f ms %d meshes\n", iNumThreads, fMilliseconds, (uint32_t)meshes.maMeshBBoxes.size());
+    }
+
+    DEBUG_PRINTF("merged vertices %s across thread counts\n", bMatching ? "identical" : "DIFFERENT");
+
+    return bMatching ? 0 : 1;
+}
+
+/*
+**
+*/
+void outputMeshMaterialIDs(
+    std::vector<uint32_t> const& aiMeshMaterialIDs,
+    std::string const& directory,
+    std::string const& baseName)
+{
+    std::string fullPath = directory + "/" + baseName + ".mid";
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    fwrite(aiMeshMaterialIDs.data(), sizeof(uint32_t), aiMeshMaterialIDs.size(), fp);
+    fclose(fp);
+}
+
+/*
+**
+*/
+std::vector<std::string> split(const char* str, char c = ' ')
+{
+    std::vector<std::string> result;
+    do
+    {
+        const char* begin = str;
+
+        while(*str != c && *str)
+            str++;
+
+        result.push_back(std::string(begin, str));
+    } while(0 != *str++);
+
+    return result;
+}
+
+/*
+**
+*/
+void getPositionRange(
+    std::vector<uint32_t>& ret,
+    std::vector<std::vector<vec3>> const& aaPositions)
+{
+    uint32_t iPositionLength = (uint32_t)aaPositions.size();
+    ret.resize(2);
+    ret[0] = ret[1] = 0;
+
+    uint32_t iNumPositions = 0;
+    for(uint32_t i = 0; i < iPositionLength; i++)
+    {
+        iNumPositions += (uint32_t)aaPositions[i].size();
+        if(i == iPositionLength - 2)
+        {
+            ret[0] = iNumPositions;
         }
     }
 
@@ -564,6 +1880,7 @@ void getPositionRange(
 void outputVerticesAndTriangles(
     std::vector<Vertex> const& aTotalVertices,
     std::vector<std::vector<uint32_t>> const& aaiTriangleVertexIndices,
+    std::vector<MeshLodChain> const& aMeshLodChains,
     std::vector<MeshExtent> const& aMeshExtents,
     std::string const& directory,
     std::string const& baseName)
@@ -581,7 +1898,6 @@ void outputVerticesAndTriangles(
         range.miEnd = iCurrStart;
         aMeshTriangleRanges[i] = range;
     }
-    uint32_t iTriangleRangeSize = (uint32_t)aMeshTriangleRanges.size() * sizeof(MeshRange);
 
     uint32_t iNumTotalVertices = (uint32_t)aTotalVertices.size();
     uint32_t iVertexSize = (uint32_t)sizeof(Vertex);
@@ -594,34 +1910,286 @@ void outputVerticesAndTriangles(
         iNumTotalTriangles += iNumTriangles;
     }
 
-    uint32_t iTriangleStartOffset = iNumTotalVertices * iVertexSize + iTriangleRangeSize + sizeof(uint32_t) * 5 + iNumMeshes * sizeof(MeshExtent);
-
-    FILE* fp = fopen(fullPath.c_str(), "wb");
-    fwrite(&iNumMeshes, sizeof(uint32_t), 1, fp);
-    fwrite(&iNumTotalVertices, sizeof(uint32_t), 1, fp);
-    fwrite(&iNumTotalTriangles, sizeof(uint32_t), 1, fp);
-    fwrite(&iVertexSize, sizeof(uint32_t), 1, fp);
-    fwrite(&iTriangleStartOffset, sizeof(uint32_t), 1, fp);
-    fwrite(aMeshTriangleRanges.data(), sizeof(MeshRange), aMeshTriangleRanges.size(), fp);
-
     // mesh extents
     assert(aMeshExtents.size() == iNumMeshes + 1);
-    fwrite(aMeshExtents.data(), sizeof(MeshExtent), iNumMeshes + 1, fp);
 
     // vertices and triangle indices
     assert(aaiTriangleVertexIndices.size() == iNumMeshes);
-    fwrite(aTotalVertices.data(), sizeof(Vertex), aTotalVertices.size(), fp);
-
+    std::vector<uint32_t> aiTotalTriangleVertexIndices;
+    aiTotalTriangleVertexIndices.reserve(iNumTotalTriangles * 3);
     for(uint32_t i = 0; i < aaiTriangleVertexIndices.size(); i++)
     {
-        fwrite(aaiTriangleVertexIndices[i].data(), sizeof(uint32_t), aaiTriangleVertexIndices[i].size(), fp);
+        aiTotalTriangleVertexIndices.insert(
+            aiTotalTriangleVertexIndices.end(),
+            aaiTriangleVertexIndices[i].begin(),
+            aaiTriangleVertexIndices[i].end());
     }
 
-    fclose(fp);
+    std::vector<Render::Meshlet> aMeshlets;
+    std::vector<MeshRange> aMeshletRanges;
+    buildMeshlets(aMeshlets, aMeshletRanges, aTotalVertices, aaiTriangleVertexIndices, 0, giNumWorkerThreads);
+
+    // full meshes are level 0, the coarser levels' indices and meshlets go after them one level at a time.
+    // meshes whose chain ended early repeat their last level
+    std::vector<Render::MeshLod> aMeshLods(iNumMeshes * MESH_MAX_LODS);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        Render::MeshLod& lod = aMeshLods[iMesh * MESH_MAX_LODS];
+        lod = {};
+        lod.miIndexStart = aMeshTriangleRanges[iMesh].miStart;
+        lod.miNumIndices = aMeshTriangleRanges[iMesh].miEnd - aMeshTriangleRanges[iMesh].miStart;
+        lod.miMeshletStart = aMeshletRanges[iMesh].miStart;
+        lod.miMeshletEnd = aMeshletRanges[iMesh].miEnd;
+        lod.mfError = 0.0f;
+    }
+    for(uint32_t iLod = 1; iLod < MESH_MAX_LODS; iLod++)
+    {
+        std::vector<std::vector<uint32_t>> aaiLodIndices(iNumMeshes);
+        for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+        {
+            if(iMesh < (uint32_t)aMeshLodChains.size() && iLod <= (uint32_t)aMeshLodChains[iMesh].maaiIndices.size())
+            {
+                aaiLodIndices[iMesh] = aMeshLodChains[iMesh].maaiIndices[iLod - 1];
+            }
+        }
+
+        uint32_t iFirstIndex = (uint32_t)aiTotalTriangleVertexIndices.size();
+        std::vector<Render::Meshlet> aLodMeshlets;
+        std::vector<MeshRange> aLodMeshletRanges;
+        uint32_t iNumLodIndices = 0;
+        for(auto const& aiIndices : aaiLodIndices)
+        {
+            iNumLodIndices += (uint32_t)aiIndices.size();
+        }
+        if(iNumLodIndices > 0)
+        {
+            buildMeshlets(aLodMeshlets, aLodMeshletRanges, aTotalVertices, aaiLodIndices, iFirstIndex, giNumWorkerThreads);
+        }
+
+        uint32_t iFirstMeshlet = (uint32_t)aMeshlets.size();
+        for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+        {
+            Render::MeshLod& lod = aMeshLods[iMesh * MESH_MAX_LODS + iLod];
+            if(aaiLodIndices[iMesh].size() == 0)
+            {
+                lod = aMeshLods[iMesh * MESH_MAX_LODS + iLod - 1];
+                continue;
+            }
+
+            lod = {};
+            lod.miIndexStart = (uint32_t)aiTotalTriangleVertexIndices.size();
+            lod.miNumIndices = (uint32_t)aaiLodIndices[iMesh].size();
+            lod.miMeshletStart = iFirstMeshlet + aLodMeshletRanges[iMesh].miStart;
+            lod.miMeshletEnd = iFirstMeshlet + aLodMeshletRanges[iMesh].miEnd;
+            lod.mfError = aMeshLodChains[iMesh].mafErrors[iLod - 1];
+            aiTotalTriangleVertexIndices.insert(
+                aiTotalTriangleVertexIndices.end(),
+                aaiLodIndices[iMesh].begin(),
+                aaiLodIndices[iMesh].end());
+        }
+        aMeshlets.insert(aMeshlets.end(), aLodMeshlets.begin(), aLodMeshlets.end());
+    }
+
+    std::vector<OutputChunk> aChunks =
+    {
+        {Render::MESH_FILE_CHUNK_TRIANGLE_RANGES, MESH_FILE_CHUNK_ALIGNMENT, (uint32_t)sizeof(MeshRange), iNumMeshes, aMeshTriangleRanges.data()},
+        {Render::MESH_FILE_CHUNK_EXTENTS, MESH_FILE_CHUNK_ALIGNMENT, (uint32_t)sizeof(MeshExtent), iNumMeshes + 1, aMeshExtents.data()},
+        {Render::MESH_FILE_CHUNK_INDICES, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(uint32_t), (uint32_t)aiTotalTriangleVertexIndices.size(), aiTotalTriangleVertexIndices.data()},
+    };
+
+    std::vector<Render::PackedVertex> aPackedVertices;
+    std::vector<Render::VertexDequantization> aDequantization;
+    if(gbPackVertices && packVertices(aPackedVertices, aDequantization, aTotalVertices, iNumMeshes))
+    {
+        aChunks.push_back({Render::MESH_FILE_CHUNK_PACKED_VERTICES, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(Render::PackedVertex), iNumTotalVertices, aPackedVertices.data()});
+        aChunks.push_back({Render::MESH_FILE_CHUNK_DEQUANTIZATION, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(Render::VertexDequantization), iNumMeshes, aDequantization.data()});
+
+        // bounds are from the float positions, the spheres grow by the quantization error to hold the packed ones
+        for(auto& meshlet : aMeshlets)
+        {
+            float fErrorSquared = 0.0f;
+            for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+            {
+                float fError = Render::getPackedPositionErrorBound(aDequantization[meshlet.miMesh], iAxis);
+                fErrorSquared += fError * fError;
+            }
+            meshlet.mafSphere[3] += sqrtf(fErrorSquared);
+        }
+    }
+    else
+    {
+        aChunks.push_back({Render::MESH_FILE_CHUNK_VERTICES, MESH_FILE_GPU_CHUNK_ALIGNMENT, iVertexSize, iNumTotalVertices, aTotalVertices.data()});
+    }
+
+    aChunks.push_back({Render::MESH_FILE_CHUNK_MESHLETS, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(Render::Meshlet), (uint32_t)aMeshlets.size(), aMeshlets.data()});
+    aChunks.push_back({Render::MESH_FILE_CHUNK_MESHLET_RANGES, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(MeshRange), iNumMeshes, aMeshletRanges.data()});
+    aChunks.push_back({Render::MESH_FILE_CHUNK_LODS, MESH_FILE_GPU_CHUNK_ALIGNMENT, (uint32_t)sizeof(Render::MeshLod), iNumMeshes * MESH_MAX_LODS, aMeshLods.data()});
+    writeChunkedFile(fullPath, aChunks);
 
     DEBUG_PRINTF("wrote to %s num meshes: %d\n", fullPath.c_str(), (int32_t)aaiTriangleVertexIndices.size());
 }
 
+/*
+** quantize every mesh over the extent of its vertices, the mesh index is in position.w. checks the round trip of
+** each vertex against the error bounds, false falls back to float vertices
+*/
+bool packVertices(
+    std::vector<Render::PackedVertex>& aPackedVertices,
+    std::vector<Render::VertexDequantization>& aDequantization,
+    std::vector<Vertex> const& aTotalVertices,
+    uint32_t iNumMeshes)
+{
+    if(iNumMeshes > PACKED_VERTEX_MAX_MESHES)
+    {
+        DEBUG_PRINTF("!!! %d meshes don't fit the packed vertex mesh index, writing float vertices !!!\n", iNumMeshes);
+        return false;
+    }
+
+    std::vector<float3> aMinPositions(iNumMeshes, float3(FLT_MAX, FLT_MAX, FLT_MAX));
+    std::vector<float3> aMaxPositions(iNumMeshes, float3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+    for(Vertex const& vertex : aTotalVertices)
+    {
+        uint32_t iMesh = (uint32_t)vertex.mPosition.w;
+        assert(iMesh < iNumMeshes);
+        aMinPositions[iMesh] = fminf(aMinPositions[iMesh], float3(vertex.mPosition));
+        aMaxPositions[iMesh] = fmaxf(aMaxPositions[iMesh], float3(vertex.mPosition));
+    }
+
+    aDequantization.resize(iNumMeshes);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+    {
+        if(aMinPositions[iMesh].x > aMaxPositions[iMesh].x)
+        {
+            aMinPositions[iMesh] = aMaxPositions[iMesh] = float3(0.0f, 0.0f, 0.0f);
+        }
+        Render::computeVertexDequantization(aDequantization[iMesh], &aMinPositions[iMesh].x, &aMaxPositions[iMesh].x);
+    }
+
+    float fMaxPositionError = 0.0f, fMaxNormalError = 0.0f, fMaxTexCoordError = 0.0f;
+    uint32_t iNumOutOfBounds = 0;
+    aPackedVertices.resize(aTotalVertices.size());
+    for(uint32_t iVertex = 0; iVertex < (uint32_t)aTotalVertices.size(); iVertex++)
+    {
+        Vertex const& vertex = aTotalVertices[iVertex];
+        uint32_t iMesh = (uint32_t)vertex.mPosition.w;
+        Render::VertexDequantization const& dequantization = aDequantization[iMesh];
+
+        // degenerate normals decode to +z, leave them out of the check
+        float3 normal = float3(vertex.mNormal);
+        float fNormalLength = length(normal);
+        normal = (fNormalLength > 0.0f) ? normal / fNormalLength : float3(0.0f, 0.0f, 1.0f);
+
+        Render::PackedVertex& packedVertex = aPackedVertices[iVertex];
+        Render::packVertex(packedVertex, &vertex.mPosition.x, &vertex.mUV.x, &normal.x, iMesh, dequantization);
+
+        float afPosition[3], afTexCoord[2], afNormal[3];
+        uint32_t iDecodedMesh = 0;
+        Render::unpackVertex(afPosition, afTexCoord, afNormal, iDecodedMesh, packedVertex, dequantization);
+
+        bool bInBounds = (iDecodedMesh == iMesh);
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            float fError = fabsf(afPosition[i] - (&vertex.mPosition.x)[i]);
+            fMaxPositionError = std::max(fMaxPositionError, fError);
+            bInBounds = bInBounds && (fError <= Render::getPackedPositionErrorBound(dequantization, i));
+        }
+
+        for(uint32_t i = 0; i < 2; i++)
+        {
+            float fError = fabsf(afTexCoord[i] - (&vertex.mUV.x)[i]);
+            fMaxTexCoordError = std::max(fMaxTexCoordError, fError);
+            bInBounds = bInBounds && (fError <= Render::getPackedTexCoordErrorBound((&vertex.mUV.x)[i]));
+        }
+
+        if(fNormalLength > 0.0f)
+        {
+            float fError = length(float3(afNormal[0], afNormal[1], afNormal[2]) - normal);
+            fMaxNormalError = std::max(fMaxNormalError, fError);
+            bInBounds = bInBounds && (fError <= PACKED_VERTEX_NORMAL_ERROR_BOUND);
+        }
+
+        iNumOutOfBounds += bInBounds ? 0 : 1;
+    }
+
+    DEBUG_PRINTF("packed %d vertices %lld -> %lld bytes, max error position %.7f normal %.7f uv %.7f\n",
+        (int32_t)aTotalVertices.size(),
+        (long long)(aTotalVertices.size() * sizeof(Vertex)),
+        (long long)(aTotalVertices.size() * sizeof(Render::PackedVertex) + aDequantization.size() * sizeof(Render::VertexDequantization)),
+        fMaxPositionError,
+        fMaxNormalError,
+        fMaxTexCoordError);
+
+    if(iNumOutOfBounds > 0)
+    {
+        DEBUG_PRINTF("!!! %d packed vertices are past the error bounds !!!\n", iNumOutOfBounds);
+        assert(iNumOutOfBounds == 0);
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+bool writeChunkedFile(
+    std::string const& fullPath,
+    std::vector<OutputChunk> const& aChunks)
+{
+    // table of contents right after the header, chunk data at aligned offsets after that
+    std::vector<Render::MeshFileChunk> aTableOfContents(aChunks.size());
+    uint64_t iCurrOffset = sizeof(Render::MeshFileHeader) + sizeof(Render::MeshFileChunk) * aChunks.size();
+    for(uint32_t i = 0; i < (uint32_t)aChunks.size(); i++)
+    {
+        OutputChunk const& chunk = aChunks[i];
+        Render::MeshFileChunk& entry = aTableOfContents[i];
+        memset(&entry, 0, sizeof(entry));
+
+        iCurrOffset = ((iCurrOffset + chunk.miAlignment - 1) / chunk.miAlignment) * chunk.miAlignment;
+        entry.miType = chunk.miType;
+        entry.miAlignment = chunk.miAlignment;
+        entry.miElementSize = chunk.miElementSize;
+        entry.miNumElements = chunk.miNumElements;
+        entry.miOffset = iCurrOffset;
+        entry.miSize = (uint64_t)chunk.miElementSize * (uint64_t)chunk.miNumElements;
+        entry.miChecksum = Render::computeMeshFileChecksum(chunk.mpData, entry.miSize);
+
+        iCurrOffset += entry.miSize;
+    }
+
+    Render::MeshFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.miSignature = MESH_FILE_SIGNATURE;
+    header.miVersion = MESH_FILE_VERSION;
+    header.miNumChunks = (uint32_t)aChunks.size();
+    header.miTableChecksum = Render::computeMeshFileChecksum(aTableOfContents.data(), sizeof(Render::MeshFileChunk) * aTableOfContents.size());
+    header.miFileSize = iCurrOffset;
+
+    FILE* fp = fopen(fullPath.c_str(), "wb");
+    if(fp == nullptr)
+    {
+        DEBUG_PRINTF("!!! can\'t write \"%s\" !!!\n", fullPath.c_str());
+        return false;
+    }
+
+    fwrite(&header, sizeof(header), 1, fp);
+    fwrite(aTableOfContents.data(), sizeof(Render::MeshFileChunk), aTableOfContents.size(), fp);
+
+    uint8_t acPadding[MESH_FILE_GPU_CHUNK_ALIGNMENT] = {0};
+    uint64_t iWritten = sizeof(Render::MeshFileHeader) + sizeof(Render::MeshFileChunk) * aChunks.size();
+    for(uint32_t i = 0; i < (uint32_t)aChunks.size(); i++)
+    {
+        Render::MeshFileChunk const& entry = aTableOfContents[i];
+        assert(entry.miOffset - iWritten <= sizeof(acPadding));
+        fwrite(acPadding, 1, entry.miOffset - iWritten, fp);
+        fwrite(aChunks[i].mpData, 1, entry.miSize, fp);
+        iWritten = entry.miOffset + entry.miSize;
+    }
+
+    fclose(fp);
+
+    return true;
+}
+
 /*
 **
 */
@@ -696,12 +2264,6 @@ void test(
     std::vector<MeshExtent>& aMeshExtents,
     std::string const& fullPath)
 {
-    uint32_t iNumMeshes = 0;
-    uint32_t iNumTotalVertices = 0;
-    uint32_t iNumTotalTriangles = 0;
-    uint32_t iVertexSize = 0;
-    uint32_t iTriangleStartOffset = 0;
-
     FILE* fp = fopen(fullPath.c_str(), "rb");
     auto directoryEnd = fullPath.find_last_of("/");
     if(directoryEnd == std::string::npos)
@@ -713,38 +2275,119 @@ void test(
     auto baseNameEnd = fileName.find_last_of(".");
     std::string baseName = fileName.substr(0, baseNameEnd);
 
-    uint64_t iFileSize = (uint64_t)fseek(fp, 0, SEEK_END);
-    fseek(fp, (long)iFileSize - 8, SEEK_SET);
-    float fTest = 0.0f;
-    fread(&fTest, sizeof(float), 1, fp);
+    fseek(fp, 0, SEEK_END);
+    uint64_t iFileSize = (uint64_t)ftell(fp);
     fseek(fp, 0, SEEK_SET);
+    std::vector<uint8_t> acFileData(iFileSize);
+    fread(acFileData.data(), 1, iFileSize, fp);
+    fclose(fp);
 
-    fread(&iNumMeshes, sizeof(uint32_t), 1, fp);
-    fread(&iNumTotalVertices, sizeof(uint32_t), 1, fp);
-    fread(&iNumTotalTriangles, sizeof(uint32_t), 1, fp);
-    fread(&iVertexSize, sizeof(uint32_t), 1, fp);
-    fread(&iTriangleStartOffset, sizeof(uint32_t), 1, fp);
+    Render::MeshFileHeader const* pHeader = (Render::MeshFileHeader const*)acFileData.data();
+    assert(iFileSize >= sizeof(Render::MeshFileHeader));
+    assert(pHeader->miSignature == MESH_FILE_SIGNATURE);
+    assert(pHeader->miVersion == MESH_FILE_VERSION);
+    assert(pHeader->miFileSize == iFileSize);
+
+    Render::MeshFileChunk const* aTableOfContents = (Render::MeshFileChunk const*)(pHeader + 1);
+    assert(pHeader->miTableChecksum == Render::computeMeshFileChecksum(aTableOfContents, sizeof(Render::MeshFileChunk) * pHeader->miNumChunks));
+
+    // check every chunk and copy out the ones the verification needs
+    std::vector<uint32_t> aiTotalTriangleVertexIndices;
+    std::vector<Render::PackedVertex> aPackedVertices;
+    std::vector<Render::VertexDequantization> aDequantization;
+    std::vector<Render::MeshLod> aMeshLods;
+    uint32_t iNumMeshlets = 0;
+    for(uint32_t iChunk = 0; iChunk < pHeader->miNumChunks; iChunk++)
+    {
+        Render::MeshFileChunk const& chunk = aTableOfContents[iChunk];
+        assert(chunk.miOffset % chunk.miAlignment == 0);
+        assert(chunk.miOffset + chunk.miSize <= iFileSize);
 
-    aMeshRanges.resize(iNumMeshes);
-    fread(aMeshRanges.data(), sizeof(MeshRange), iNumMeshes, fp);
+        uint8_t const* pChunkData = acFileData.data() + chunk.miOffset;
+        assert(chunk.miChecksum == Render::computeMeshFileChecksum(pChunkData, chunk.miSize));
+        if(chunk.miType == Render::MESH_FILE_CHUNK_TRIANGLE_RANGES)
+        {
+            aMeshRanges.resize(chunk.miNumElements);
+            memcpy(aMeshRanges.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_EXTENTS)
+        {
+            aMeshExtents.resize(chunk.miNumElements);            // last mesh extent is the overall mesh
+            memcpy(aMeshExtents.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_VERTICES)
+        {
+            assert(chunk.miElementSize == sizeof(Vertex));
+            aTotalVertices.resize(chunk.miNumElements);
+            memcpy(aTotalVertices.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_INDICES)
+        {
+            aiTotalTriangleVertexIndices.resize(chunk.miNumElements);
+            memcpy(aiTotalTriangleVertexIndices.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_PACKED_VERTICES)
+        {
+            assert(chunk.miElementSize == sizeof(Render::PackedVertex));
+            aPackedVertices.resize(chunk.miNumElements);
+            memcpy(aPackedVertices.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_DEQUANTIZATION)
+        {
+            assert(chunk.miElementSize == sizeof(Render::VertexDequantization));
+            aDequantization.resize(chunk.miNumElements);
+            memcpy(aDequantization.data(), pChunkData, chunk.miSize);
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_MESHLETS)
+        {
+            iNumMeshlets = chunk.miNumElements;
+        }
+        else if(chunk.miType == Render::MESH_FILE_CHUNK_LODS)
+        {
+            assert(chunk.miElementSize == sizeof(Render::MeshLod));
+            aMeshLods.resize(chunk.miNumElements);
+            memcpy(aMeshLods.data(), pChunkData, chunk.miSize);
+        }
+    }
 
-    aMeshExtents.resize(iNumMeshes + 1);            // last mesh extent is the overall mesh
-    fread(aMeshExtents.data(), sizeof(MeshExtent), iNumMeshes + 1, fp);
+    // levels go from the full mesh to the coarsest, each inside the index and meshlet chunks
+    assert(aMeshLods.size() == aMeshRanges.size() * MESH_MAX_LODS);
+    for(uint32_t i = 0; i < (uint32_t)aMeshLods.size(); i++)
+    {
+        Render::MeshLod const& lod = aMeshLods[i];
+        assert(lod.miIndexStart + lod.miNumIndices <= aiTotalTriangleVertexIndices.size());
+        assert(lod.miMeshletStart <= lod.miMeshletEnd && lod.miMeshletEnd <= iNumMeshlets);
+        assert(i % MESH_MAX_LODS == 0 || (lod.mfError >= aMeshLods[i - 1].mfError && lod.miNumIndices <= aMeshLods[i - 1].miNumIndices));
+    }
 
-    aTotalVertices.resize(iNumTotalVertices);
-    fread(aTotalVertices.data(), sizeof(Vertex), iNumTotalVertices, fp);
+    // decode packed vertices for the debug obj
+    if(aPackedVertices.size() > 0)
+    {
+        aTotalVertices.resize(aPackedVertices.size());
+        for(uint32_t iVertex = 0; iVertex < (uint32_t)aPackedVertices.size(); iVertex++)
+        {
+            Render::PackedVertex const& packedVertex = aPackedVertices[iVertex];
+            assert(packedVertex.miMesh < aDequantization.size());
+
+            Vertex& vertex = aTotalVertices[iVertex];
+            uint32_t iMesh = 0;
+            Render::unpackVertex(&vertex.mPosition.x, &vertex.mUV.x, &vertex.mNormal.x, iMesh, packedVertex, aDequantization[packedVertex.miMesh]);
+            vertex.mPosition.w = vertex.mUV.z = (float)iMesh;
+            vertex.mUV.w = 0.0f;
+            vertex.mNormal.w = 1.0f;
+        }
+    }
 
+    uint32_t iNumMeshes = (uint32_t)aMeshRanges.size();
     for(uint32_t i = 0; i < iNumMeshes; i++)
     {
         MeshRange const& range = aMeshRanges[i];
-        uint32_t iNumTriangleIndices = range.miEnd - range.miStart;
-        std::vector<uint32_t> aiTriangles(iNumTriangleIndices);
-        fread(aiTriangles.data(), sizeof(uint32_t), iNumTriangleIndices, fp);
+        std::vector<uint32_t> aiTriangles(
+            aiTotalTriangleVertexIndices.begin() + range.miStart,
+            aiTotalTriangleVertexIndices.begin() + range.miEnd);
         aaiTriangleVertexIndices.push_back(aiTriangles);
     }
 
-    fclose(fp);
-
     DEBUG_PRINTF("output verifcation obj meshes: \"%s\"\n, num meshes: %d\n", fullPath.c_str(), iNumMeshes);
 
     std::vector<uint32_t> aiMeshes;
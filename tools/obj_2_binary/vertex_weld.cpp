@@ -0,0 +1,111 @@
+#include "vertex_weld.h"
+
+#include <cmath>
+#include <cstring>
+#include <cassert>
+
+/*
+**
+*/
+static uint32_t hashKey(
+    uint32_t const* paiKey,
+    uint32_t iNumWords)
+{
+    // fnv-1a over the words with a murmur3 finalizer, the low bits pick the slot
+    uint32_t iHash = 0x811c9dc5u;
+    for(uint32_t i = 0; i < iNumWords; i++)
+    {
+        iHash = (iHash ^ paiKey[i]) * 0x01000193u;
+    }
+
+    iHash ^= iHash >> 16;
+    iHash *= 0x85ebca6bu;
+    iHash ^= iHash >> 13;
+    iHash *= 0xc2b2ae35u;
+    iHash ^= iHash >> 16;
+
+    return iHash;
+}
+
+/*
+**
+*/
+void CVertexWelder::makeKey(
+    uint32_t* paiKey,
+    float const* pafAttributes,
+    uint32_t iNumAttributes) const
+{
+    if(mfTolerance <= 0.0f)
+    {
+        memcpy(paiKey, pafAttributes, sizeof(float) * iNumAttributes);
+        return;
+    }
+
+    float fOneOverTolerance = 1.0f / mfTolerance;
+    for(uint32_t i = 0; i < iNumAttributes; i++)
+    {
+        int64_t iQuantized = (int64_t)floor((double)pafAttributes[i] * (double)fOneOverTolerance + 0.5);
+        paiKey[i] = (uint32_t)iQuantized;
+    }
+}
+
+/*
+**
+*/
+void CVertexWelder::weld(
+    std::vector<uint32_t>& aiUniqueVertices,
+    std::vector<uint32_t>& aiRemap,
+    float const* pafAttributes,
+    uint32_t iNumAttributes,
+    uint32_t iNumVertices)
+{
+    assert(iNumAttributes <= 16);
+
+    aiUniqueVertices.clear();
+    aiRemap.resize(iNumVertices);
+
+    // at most half full
+    uint32_t iNumSlots = 16;
+    while(iNumSlots < iNumVertices * 2)
+    {
+        iNumSlots <<= 1;
+    }
+    uint32_t iSlotMask = iNumSlots - 1;
+    maiSlots.assign(iNumSlots, 0);
+    maiSlotHashes.resize(iNumSlots);
+    maiKeys.clear();
+
+    uint32_t aiKey[16];
+    for(uint32_t iVertex = 0; iVertex < iNumVertices; iVertex++)
+    {
+        makeKey(aiKey, pafAttributes + (uint64_t)iVertex * iNumAttributes, iNumAttributes);
+        uint32_t iHash = hashKey(aiKey, iNumAttributes);
+
+        // linear probe until the key or an empty slot
+        uint32_t iSlot = iHash & iSlotMask;
+        for(;;)
+        {
+            uint32_t iEntry = maiSlots[iSlot];
+            if(iEntry == 0)
+            {
+                uint32_t iUniqueVertex = (uint32_t)aiUniqueVertices.size();
+                maiSlots[iSlot] = iUniqueVertex + 1;
+                maiSlotHashes[iSlot] = iHash;
+                maiKeys.insert(maiKeys.end(), aiKey, aiKey + iNumAttributes);
+                aiUniqueVertices.push_back(iVertex);
+                aiRemap[iVertex] = iUniqueVertex;
+                break;
+            }
+
+            uint32_t iUniqueVertex = iEntry - 1;
+            if(maiSlotHashes[iSlot] == iHash &&
+                memcmp(maiKeys.data() + (uint64_t)iUniqueVertex * iNumAttributes, aiKey, sizeof(uint32_t) * iNumAttributes) == 0)
+            {
+                aiRemap[iVertex] = iUniqueVertex;
+                break;
+            }
+
+            iSlot = (iSlot + 1) & iSlotMask;
+        }
+    }
+}
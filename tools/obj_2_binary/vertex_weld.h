@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+** vertex welding with an open addressing hash table keyed on the attribute bits
+**
+** with a tolerance of 0 attributes have to match bit for bit (-0 and 0 are different, same as the old printed
+** keys), otherwise every attribute is snapped to a multiple of the tolerance before hashing. unique vertices keep
+** the order of their first occurrence, so for exact duplicates the result matches welding with any ordered map.
+*/
+class CVertexWelder
+{
+public:
+    CVertexWelder() = default;
+    virtual ~CVertexWelder() = default;
+
+    inline void setTolerance(float fTolerance)
+    {
+        mfTolerance = fTolerance;
+    }
+
+    // pafAttributes holds iNumAttributes floats per input vertex
+    // aiUniqueVertices: input vertex of each unique vertex, aiRemap: unique vertex of each input vertex
+    void weld(
+        std::vector<uint32_t>& aiUniqueVertices,
+        std::vector<uint32_t>& aiRemap,
+        float const* pafAttributes,
+        uint32_t iNumAttributes,
+        uint32_t iNumVertices);
+
+protected:
+    void makeKey(
+        uint32_t* paiKey,
+        float const* pafAttributes,
+        uint32_t iNumAttributes) const;
+
+protected:
+    float                       mfTolerance = 0.0f;
+
+    // reused across calls
+    std::vector<uint32_t>       maiSlots;           // unique vertex + 1, 0 is empty
+    std::vector<uint32_t>       maiSlotHashes;
+    std::vector<uint32_t>       maiKeys;            // iNumAttributes words per unique vertex
+};
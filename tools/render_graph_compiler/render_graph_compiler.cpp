@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utils/LogPrint.h>
+#include <render/render_graph.h>
+#include <render/render_job_descriptions.h>
+#include <render/transient_allocator.h>
+#include <render/record_scheduler.h>
+#include <render/resource_registry.h>
+#include <render/shader_preprocessor.h>
+#include <render/resolution_mode.h>
+
+#include <rapidjson/document.h>
+
+/*
+**
+*/
+static bool loadTextFile(
+    std::string& content,
+    std::string const& filePath)
+{
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+
+    return true;
+}
+
+/*
+** stands in for a command encoder, keeps the jobs recorded into it and the thread that recorded them
+*/
+struct MockEncoder
+{
+    std::vector<uint32_t>       maiJobs;
+    std::thread::id             mThreadID;
+};
+
+/*
+** records the schedule on the scheduler's threads into mock encoders and checks that submitting them in chunk order
+** gives the schedule back. mesh passes are costed higher like they record more draws
+*/
+static bool dryRunRecording(
+    Render::CRenderGraph const& renderGraph,
+    uint32_t iNumThreads)
+{
+    struct RecordInfo
+    {
+        std::vector<MockEncoder>            maEncoders;
+    };
+
+    std::vector<uint64_t> aiCosts;
+    for(uint32_t iJob : renderGraph.getSchedule())
+    {
+        std::string const& passType = renderGraph.getJobs()[iJob].mPassType;
+        aiCosts.push_back((passType == "Draw Meshes" || passType == "Draw Animated Meshes" || passType == "Draw Static Meshes" ||
+            passType == "Draw Dynamic Meshes") ? 8 : 1);
+    }
+
+    Render::CRecordScheduler scheduler;
+    scheduler.setup(iNumThreads);
+
+    bool bInOrder = true;
+    uint32_t const kiNumFrames = 16;
+    for(uint32_t iFrame = 0; iFrame < kiNumFrames; iFrame++)
+    {
+        RecordInfo recordInfo;
+        recordInfo.maEncoders.resize(scheduler.split(aiCosts).size());
+        scheduler.record(
+            [](uint32_t iChunk, uint32_t iFirstJob, uint32_t iNumJobs, void* pUserData)
+            {
+                MockEncoder& encoder = ((RecordInfo*)pUserData)->maEncoders[iChunk];
+                encoder.mThreadID = std::this_thread::get_id();
+                for(uint32_t iJob = iFirstJob; iJob < iFirstJob + iNumJobs; iJob++)
+                {
+                    encoder.maiJobs.push_back(iJob);
+                }
+            },
+            &recordInfo);
+
+        std::vector<uint32_t> aiSubmitted;
+        for(auto const& encoder : recordInfo.maEncoders)
+        {
+            aiSubmitted.insert(aiSubmitted.end(), encoder.maiJobs.begin(), encoder.maiJobs.end());
+        }
+        for(uint32_t i = 0; i < (uint32_t)aiCosts.size(); i++)
+        {
+            bInOrder = (bInOrder && i < (uint32_t)aiSubmitted.size() && aiSubmitted[i] == i);
+        }
+        bInOrder = (bInOrder && aiSubmitted.size() == aiCosts.size());
+    }
+
+    DEBUG_PRINTF("recording on %d threads, %d chunks, submitted in schedule order over %d frames: %s\n",
+        scheduler.getNumThreads(),
+        (uint32_t)scheduler.getChunks().size(),
+        kiNumFrames,
+        bInOrder ? "yes" : "NO");
+    for(auto const& chunk : scheduler.getChunks())
+    {
+        DEBUG_PRINTF("    %3d - %3d cost %lld\n",
+            chunk.miFirstJob,
+            chunk.miFirstJob + chunk.miNumJobs - 1,
+            (long long)chunk.miCost);
+    }
+
+    return bInOrder;
+}
+
+/*
+** stands in for a gpu buffer
+*/
+struct MockBuffer
+{
+    uint64_t                    miID = 0;
+};
+
+/*
+** stands in for a render job, its outputs by attachment name
+*/
+struct MockRenderJob
+{
+    std::string                             mName;
+    std::string                             mPassType;
+    Render::JobType                         mType = Render::JobType::Graphics;
+    Render::OcclusionPhase                  mOcclusionPhase = Render::OcclusionPhase::None;
+    uint32_t                                miNumFrames = 0;
+    bool                                    mbEnabled = true;
+    std::string                             mPassLabel;
+    std::map<std::string, MockBuffer>       maOutputs;
+};
+
+/*
+** cpu time of the lookups the renderer and the app do in a frame of the schedule, by name through std::map like the
+** frame loop used to and through handles resolved at setup. only the lookups are timed, no gpu work
+*/
+static void benchmarkFrameLookups(Render::CRenderGraph const& renderGraph)
+{
+    uint32_t const kiNumMeshes = 16;
+    uint32_t const kiNumFrames = 20000;
+
+    char const* aszAppBufferNames[] =
+    {
+        "total-joint-global-animation-matrices",
+        "animMeshModelUniforms",
+        "staticMeshModelMatrices",
+        "meshCullingUniformBuffer",
+        "lightingUniformBuffer",
+    };
+
+    // same jobs and buffers in both
+    std::map<std::string, std::unique_ptr<MockRenderJob>> aRenderJobs;
+    std::vector<std::string> aOrderedRenderJobs;
+    std::map<std::string, MockBuffer> aBuffers;
+    Render::CResourceRegistry<MockBuffer> bufferRegistry;
+    uint64_t iID = 0;
+    auto addBuffer = [&](std::string const& name)
+    {
+        aBuffers[name].miID = ++iID;
+        bufferRegistry[name].miID = iID;
+    };
+
+    std::vector<std::string> aMeshVertexBufferNames, aMeshIndexBufferNames;
+    for(uint32_t iMesh = 0; iMesh < kiNumMeshes; iMesh++)
+    {
+        aMeshVertexBufferNames.push_back("mesh-vertex-buffer-" + std::to_string(iMesh));
+        aMeshIndexBufferNames.push_back("mesh-index-buffer-" + std::to_string(iMesh));
+        addBuffer(aMeshVertexBufferNames.back());
+        addBuffer(aMeshIndexBufferNames.back());
+    }
+    addBuffer("default-uniform-buffer");
+    addBuffer("full-screen-triangle-vertex-buffer");
+    addBuffer("full-screen-triangle-index-buffer");
+    for(char const* szName : aszAppBufferNames)
+    {
+        addBuffer(szName);
+    }
+
+    for(uint32_t iJob : renderGraph.getSchedule())
+    {
+        Render::CRenderGraph::Job const& job = renderGraph.getJobs()[iJob];
+        auto pRenderJob = std::make_unique<MockRenderJob>();
+        pRenderJob->mName = job.mName;
+        pRenderJob->mPassType = job.mPassType;
+        pRenderJob->mType = job.mType;
+        pRenderJob->mOcclusionPhase = job.mOcclusionPhase;
+        pRenderJob->miNumFrames = job.miNumFrames;
+        pRenderJob->mPassLabel = job.mName + ((job.mType == Render::JobType::Compute) ? " Render Encoder" : " Render Pass Encoder");
+        for(auto const& write : job.maWrites)
+        {
+            pRenderJob->maOutputs[write.substr(write.find('/') + 1)].miID = ++iID;
+        }
+        aOrderedRenderJobs.push_back(job.mName);
+        aRenderJobs[job.mName] = std::move(pRenderJob);
+    }
+
+    // resolved at setup
+    std::vector<MockRenderJob*> apOrderedRenderJobs;
+    for(auto const& name : aOrderedRenderJobs)
+    {
+        apOrderedRenderJobs.push_back(aRenderJobs[name].get());
+    }
+    MockBuffer* aapCullingDrawCalls[3] = {nullptr, nullptr, nullptr};
+    for(uint32_t iPhase = 0; iPhase < 3; iPhase++)
+    {
+        auto iter = aRenderJobs.find(Render::CRenderGraph::getCullingJobName("Mesh", (Render::OcclusionPhase)iPhase));
+        if(iter != aRenderJobs.end() && iter->second->maOutputs.find("Draw Calls") != iter->second->maOutputs.end())
+        {
+            aapCullingDrawCalls[iPhase] = &iter->second->maOutputs["Draw Calls"];
+        }
+    }
+    std::vector<Render::CResourceRegistry<MockBuffer>::Handle> aiMeshVertexBuffers, aiMeshIndexBuffers, aiAppBuffers;
+    for(uint32_t iMesh = 0; iMesh < kiNumMeshes; iMesh++)
+    {
+        aiMeshVertexBuffers.push_back(bufferRegistry.getHandle(aMeshVertexBufferNames[iMesh]));
+        aiMeshIndexBuffers.push_back(bufferRegistry.getHandle(aMeshIndexBufferNames[iMesh]));
+    }
+    for(char const* szName : aszAppBufferNames)
+    {
+        aiAppBuffers.push_back(bufferRegistry.getHandle(szName));
+    }
+    auto iDefaultUniformBuffer = bufferRegistry.getHandle("default-uniform-buffer");
+    auto iFullScreenTriangleVertexBuffer = bufferRegistry.getHandle("full-screen-triangle-vertex-buffer");
+    auto iFullScreenTriangleIndexBuffer = bufferRegistry.getHandle("full-screen-triangle-index-buffer");
+
+    // sum of the ids so the lookups aren't optimized away
+    uint64_t iByNameSum = 0, iByHandleSum = 0;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iFrame = 0; iFrame < kiNumFrames; iFrame++)
+    {
+        for(char const* szName : aszAppBufferNames)
+        {
+            std::string bufferName = szName;
+            iByNameSum += aBuffers[bufferName].miID;
+        }
+        iByNameSum += aBuffers["default-uniform-buffer"].miID;
+        if(aRenderJobs.find("Mesh Culling Compute") != aRenderJobs.end())
+        {
+            iByNameSum += aRenderJobs["Mesh Culling Compute"]->maOutputs["Draw Calls"].miID;
+        }
+        for(auto& renderJob : aRenderJobs)
+        {
+            iByNameSum += (renderJob.second->miNumFrames > 0 && iFrame >= renderJob.second->miNumFrames) ? 1 : 0;
+        }
+
+        for(uint32_t iJob = 0; iJob < (uint32_t)aOrderedRenderJobs.size(); iJob++)
+        {
+            MockRenderJob* pRenderJob = aRenderJobs[aOrderedRenderJobs[iJob]].get();
+            std::string label = pRenderJob->mName + ((pRenderJob->mType == Render::JobType::Compute) ? " Render Encoder" : " Render Pass Encoder");
+            iByNameSum += label.size();
+
+            if(pRenderJob->mPassType == "Draw Meshes")
+            {
+                auto iter = aRenderJobs.find(Render::CRenderGraph::getCullingJobName("Mesh", pRenderJob->mOcclusionPhase));
+                if(iter != aRenderJobs.end())
+                {
+                    iByNameSum += iter->second->maOutputs["Draw Calls"].miID;
+                }
+                std::vector<std::string> aVertexBufferNames = aMeshVertexBufferNames;
+                std::vector<std::string> aIndexBufferNames = aMeshIndexBufferNames;
+                for(uint32_t iMesh = 0; iMesh < kiNumMeshes; iMesh++)
+                {
+                    iByNameSum += aBuffers[aVertexBufferNames[iMesh]].miID + aBuffers[aIndexBufferNames[iMesh]].miID;
+                }
+            }
+            else if(pRenderJob->mPassType == "Full Triangle")
+            {
+                iByNameSum += aBuffers["full-screen-triangle-index-buffer"].miID + aBuffers["full-screen-triangle-vertex-buffer"].miID;
+            }
+            else if(pRenderJob->mType == Render::JobType::Compute &&
+                pRenderJob->maOutputs.find("Cluster Draw Calls") != pRenderJob->maOutputs.end())
+            {
+                iByNameSum += pRenderJob->maOutputs["Cluster Draw Calls"].miID;
+            }
+        }
+    }
+    auto midTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iFrame = 0; iFrame < kiNumFrames; iFrame++)
+    {
+        for(auto iHandle : aiAppBuffers)
+        {
+            iByHandleSum += bufferRegistry.get(iHandle).miID;
+        }
+        iByHandleSum += bufferRegistry.get(iDefaultUniformBuffer).miID;
+        if(aapCullingDrawCalls[0] != nullptr)
+        {
+            iByHandleSum += aapCullingDrawCalls[0]->miID;
+        }
+        for(MockRenderJob* pRenderJob : apOrderedRenderJobs)
+        {
+            iByHandleSum += (pRenderJob->miNumFrames > 0 && iFrame >= pRenderJob->miNumFrames) ? 1 : 0;
+        }
+
+        for(MockRenderJob* pRenderJob : apOrderedRenderJobs)
+        {
+            iByHandleSum += pRenderJob->mPassLabel.size();
+
+            if(pRenderJob->mPassType == "Draw Meshes")
+            {
+                MockBuffer const* pDrawCalls = aapCullingDrawCalls[(uint32_t)pRenderJob->mOcclusionPhase];
+                if(pDrawCalls != nullptr)
+                {
+                    iByHandleSum += pDrawCalls->miID;
+                }
+                for(uint32_t iMesh = 0; iMesh < kiNumMeshes; iMesh++)
+                {
+                    iByHandleSum += bufferRegistry.get(aiMeshVertexBuffers[iMesh]).miID + bufferRegistry.get(aiMeshIndexBuffers[iMesh]).miID;
+                }
+            }
+            else if(pRenderJob->mPassType == "Full Triangle")
+            {
+                iByHandleSum += bufferRegistry.get(iFullScreenTriangleIndexBuffer).miID + bufferRegistry.get(iFullScreenTriangleVertexBuffer).miID;
+            }
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    double fByNameMicroseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(midTime - startTime).count() * 0.001 / (double)kiNumFrames;
+    double fByHandleMicroseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - midTime).count() * 0.001 / (double)kiNumFrames;
+    DEBUG_PRINTF("frame lookups of %d jobs, %d meshes: %.3f us by name, %.3f us by handle (%llu %llu)\n",
+        (uint32_t)aOrderedRenderJobs.size(),
+        kiNumMeshes,
+        fByNameMicroseconds,
+        fByHandleMicroseconds,
+        (unsigned long long)(iByNameSum & 0xff),
+        (unsigned long long)(iByHandleSum & 0xff));
+}
+
+/*
+** share of the screen's pixels the jobs with a resolution scale or mode shade a frame, with the size of their first
+** output
+*/
+static void printResolutionModes(
+    Render::CRenderJobDescriptions const& descriptions,
+    uint32_t iScreenWidth,
+    uint32_t iScreenHeight)
+{
+    for(Render::CRenderJobDescriptions::Job const& job : descriptions.getJobs())
+    {
+        auto output = std::find_if(
+            job.maAttachments.begin(),
+            job.maAttachments.end(),
+            [](Render::CRenderJobDescriptions::Attachment const& attachment)
+            {
+                return attachment.mType == "TextureOutput";
+            });
+        if(job.mType == Render::JobType::Copy || output == job.maAttachments.end() ||
+           (job.mfResolutionScale == 1.0f && job.mResolutionMode == Render::ResolutionMode::Full))
+        {
+            continue;
+        }
+
+        uint32_t aiTargetSize[2];
+        Render::getTargetSize(aiTargetSize, iScreenWidth, iScreenHeight, output->mfScaleWidth, output->mfScaleHeight);
+        float fShaded = ((float)aiTargetSize[0] * (float)aiTargetSize[1]) / ((float)iScreenWidth * (float)iScreenHeight) *
+            Render::getShadedFraction(job.mResolutionMode, job.miInterleaveSize);
+        DEBUG_PRINTF("resolution modes: \"%s\" %d x %d, mode %d, shades %.4f of the pixels a frame\n",
+            job.mName.c_str(),
+            aiTargetSize[0],
+            aiTargetSize[1],
+            (uint32_t)job.mResolutionMode,
+            fShaded);
+    }
+}
+
+/*
+** preprocesses the shader of every live job with its "Defines" like CRenderJob::createPipeline, the shaders are in
+** the shaders directory next to the job list's directory and have to declare the job's constants. jobs with the same
+** variant share a shader module, and a pipeline too when their "Constants" are the same
+*/
+static bool dryRunShaders(
+    Render::CRenderGraph const& renderGraph,
+    Render::CRenderJobDescriptions const& descriptions,
+    std::string const& directory)
+{
+    std::string shaderDirectory = directory + "../shaders/";
+
+    Render::CShaderPreprocessor preprocessor;
+    preprocessor.setup(
+        [](std::string& content, std::string const& filePath, void* pUserData)
+        {
+            std::string const& shaderDirectory = *(std::string const*)pUserData;
+            return loadTextFile(content, shaderDirectory + filePath);
+        },
+        &shaderDirectory);
+
+    bool bPassed = true;
+    uint32_t iNumJobs = 0;
+    std::set<std::string const*> aVariants;
+    std::set<std::pair<std::string const*, std::string>> aSpecializations;
+    for(uint32_t iJob : renderGraph.getSchedule())
+    {
+        Render::CRenderJobDescriptions::Job const& job = descriptions.getJobs()[iJob];
+        if(job.mType == Render::JobType::Copy)
+        {
+            continue;
+        }
+
+        // the constants only tell the pipelines apart
+        std::string constants;
+        for(auto const& constant : job.maConstants)
+        {
+            constants += constant.first + "=" + std::to_string(constant.second) + " ";
+        }
+
+        std::string const* pShaderCode = preprocessor.preprocess(job.mShader, job.maDefines);
+        if(pShaderCode == nullptr)
+        {
+            DEBUG_PRINTF("!!! \"%s\" shader \"%s\" doesn't preprocess !!!\n",
+                job.mName.c_str(),
+                job.mShader.c_str());
+            bPassed = false;
+            continue;
+        }
+
+        // wgsl has no #, a directive left behind would fail the shader module
+        std::istringstream stream(*pShaderCode);
+        std::string line;
+        while(std::getline(stream, line))
+        {
+            size_t iFirst = line.find_first_not_of(" \t");
+            if(iFirst != std::string::npos && line[iFirst] == '#')
+            {
+                DEBUG_PRINTF("!!! \"%s\" has \"%s\" left !!!\n",
+                    job.mName.c_str(),
+                    line.c_str());
+                bPassed = false;
+                break;
+            }
+        }
+
+        // a constant the shader doesn't declare fails the pipeline, the sparse resolution modes need
+        // include/resolution-mode.shader
+        for(auto const& constant : job.maConstants)
+        {
+            if(pShaderCode->find("override " + constant.first) == std::string::npos)
+            {
+                DEBUG_PRINTF("!!! \"%s\" shader \"%s\" has no override constant %s !!!\n",
+                    job.mName.c_str(),
+                    job.mShader.c_str(),
+                    constant.first.c_str());
+                bPassed = false;
+            }
+        }
+
+        ++iNumJobs;
+        aVariants.insert(pShaderCode);
+        aSpecializations.insert(std::make_pair(pShaderCode, constants));
+    }
+
+    for(auto const& error : preprocessor.getErrors())
+    {
+        DEBUG_PRINTF("shader error: %s\n", error.c_str());
+    }
+
+    Render::CShaderPreprocessor::Stats const& stats = preprocessor.getStats();
+    DEBUG_PRINTF("shaders: %d jobs, %d variants from %d files, %d specializations with constants\n",
+        iNumJobs,
+        (uint32_t)aVariants.size(),
+        stats.miNumFilesLoaded,
+        (uint32_t)aSpecializations.size());
+    DEBUG_PRINTF("shaders: %d variants asked for, %d preprocessed, %lld bytes read into %lld bytes of wgsl\n",
+        stats.miNumRequested,
+        stats.miNumPreprocessed,
+        (long long)stats.miNumSourceBytes,
+        (long long)stats.miNumOutputBytes);
+
+    return bPassed;
+}
+
+/*
+** with bWrite, writes the compiled job list the renderer reads instead of the json. otherwise checks that the one
+** there is from the same json. either way it has to read back to the same records, and the start up parsing is timed:
+** the json like the renderer used to parse it, the job list twice and every pipeline file once for the render graph and
+** once for each CRenderJob create step, the json parsed once into the descriptions, and the compiled job list
+*/
+static bool checkCompiledJobList(
+    Render::CRenderJobDescriptions const& descriptions,
+    std::string const& jobListFile,
+    std::string const& directory,
+    std::string const& compiledFilePath,
+    bool bWrite)
+{
+    std::vector<uint8_t> acCompiled;
+    descriptions.write(acCompiled);
+
+    if(bWrite)
+    {
+        std::ofstream file(compiledFilePath, std::ios::out | std::ios::binary);
+        file.write((char const*)acCompiled.data(), acCompiled.size());
+        if(!file.good())
+        {
+            DEBUG_PRINTF("!!! can't write \"%s\" !!!\n", compiledFilePath.c_str());
+            return false;
+        }
+        DEBUG_PRINTF("wrote \"%s\", %d bytes\n", compiledFilePath.c_str(), (uint32_t)acCompiled.size());
+    }
+
+    std::string compiledFile;
+    if(!loadTextFile(compiledFile, compiledFilePath))
+    {
+        DEBUG_PRINTF("no compiled job list \"%s\", the renderer parses the json\n", compiledFilePath.c_str());
+        return true;
+    }
+
+    Render::CRenderJobDescriptions readDescriptions;
+    if(!readDescriptions.read(compiledFile.data(), compiledFile.size()))
+    {
+        DEBUG_PRINTF("!!! \"%s\": %s !!!\n", compiledFilePath.c_str(), readDescriptions.getErrors().back().c_str());
+        return false;
+    }
+
+    if(readDescriptions.getSourceHash() != descriptions.getSourceHash())
+    {
+        DEBUG_PRINTF("!!! \"%s\" is out of date, run with --cache to compile it again !!!\n", compiledFilePath.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> acReadBack;
+    readDescriptions.write(acReadBack);
+    if(acReadBack != acCompiled)
+    {
+        DEBUG_PRINTF("!!! \"%s\" doesn't read back to the same job descriptions !!!\n", compiledFilePath.c_str());
+        return false;
+    }
+
+    // files the way the renderer went through them, copy jobs only load theirs in setCopyAttachments, twice
+    uint32_t const kiNumRuns = 50;
+    std::vector<std::string> aOldFilePaths = {"", ""};
+    for(Render::CRenderJobDescriptions::Job const& job : descriptions.getJobs())
+    {
+        uint32_t iNumParses = (job.mType == Render::JobType::Copy) ? 3 : 4;
+        for(uint32_t i = 0; i < iNumParses; i++)
+        {
+            aOldFilePaths.push_back(job.mPipeline);
+        }
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iRun = 0; iRun < kiNumRuns; iRun++)
+    {
+        for(std::string const& filePath : aOldFilePaths)
+        {
+            std::string content;
+            if(filePath.length() > 0)
+            {
+                loadTextFile(content, directory + filePath);
+            }
+            else
+            {
+                content = jobListFile;
+            }
+            rapidjson::Document doc;
+            doc.Parse(content.c_str());
+        }
+    }
+    double fOldMS = double(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count()) * 0.001 / (double)kiNumRuns;
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iRun = 0; iRun < kiNumRuns; iRun++)
+    {
+        Render::CRenderJobDescriptions jsonDescriptions;
+        jsonDescriptions.compile(
+            jobListFile.c_str(),
+            [](std::string& content, std::string const& filePath, void* pUserData)
+            {
+                std::string const& directory = *(std::string const*)pUserData;
+                return loadTextFile(content, directory + filePath);
+            },
+            (void*)&directory);
+    }
+    double fJsonMS = double(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count()) * 0.001 / (double)kiNumRuns;
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for(uint32_t iRun = 0; iRun < kiNumRuns; iRun++)
+    {
+        std::string content;
+        loadTextFile(content, compiledFilePath);
+        readDescriptions.read(content.data(), content.size());
+    }
+    double fCompiledMS = double(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - startTime).count()) * 0.001 / (double)kiNumRuns;
+
+    DEBUG_PRINTF("\"%s\" is up to date, %d jobs in %d bytes\n",
+        compiledFilePath.c_str(),
+        (uint32_t)readDescriptions.getJobs().size(),
+        (uint32_t)compiledFile.size());
+    DEBUG_PRINTF("job descriptions: %.3f ms as the renderer parsed them before (%d json parses), %.3f ms parsing the json once, %.3f ms from the compiled file (1 read)\n",
+        fOldMS,
+        (uint32_t)aOldFilePaths.size(),
+        fJsonMS,
+        fCompiledMS);
+
+    return true;
+}
+
+/*
+** dry run of the render graph the renderer compiles at start up, pipeline files are next to the job list like in
+** render-jobs, the memory of the outputs is for a screen of the given size, 1024x1024 like the app's by default,
+** recording is split over the given number of threads, 4 by default
+*/
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> aArgs;
+    std::string compiledFilePath;
+    bool bWriteCompiled = false;
+    bool bBenchmark = false;
+    for(int32_t iArg = 1; iArg < argc; iArg++)
+    {
+        if(std::string(argv[iArg]) == "--cache" && iArg + 1 < argc)
+        {
+            compiledFilePath = argv[++iArg];
+            bWriteCompiled = true;
+            continue;
+        }
+        else if(std::string(argv[iArg]) == "--benchmark")
+        {
+            bBenchmark = true;
+            continue;
+        }
+        aArgs.push_back(argv[iArg]);
+    }
+
+    if(aArgs.size() < 1)
+    {
+        DEBUG_PRINTF("usage: render_graph_compiler <render jobs file> [screen width] [screen height] [recording threads] [--cache <compiled file>] [--benchmark]\n");
+        return 1;
+    }
+
+    std::string jobListFilePath = aArgs[0];
+    uint32_t iScreenWidth = (aArgs.size() >= 2) ? (uint32_t)atoi(aArgs[1].c_str()) : 1024;
+    uint32_t iScreenHeight = (aArgs.size() >= 3) ? (uint32_t)atoi(aArgs[2].c_str()) : 1024;
+    uint32_t iNumRecordThreads = (aArgs.size() >= 4) ? (uint32_t)atoi(aArgs[3].c_str()) : 4;
+    std::string jobListFile;
+    if(!loadTextFile(jobListFile, jobListFilePath))
+    {
+        DEBUG_PRINTF("!!! can't open \"%s\" !!!\n", jobListFilePath.c_str());
+        return 1;
+    }
+
+    std::string directory = "";
+    size_t iSeparator = jobListFilePath.find_last_of("/\\");
+    if(iSeparator != std::string::npos)
+    {
+        directory = jobListFilePath.substr(0, iSeparator + 1);
+    }
+
+    // the compiled job list is next to the json, <job list>.rjb
+    if(compiledFilePath.length() == 0)
+    {
+        compiledFilePath = jobListFilePath.substr(0, jobListFilePath.find_last_of('.')) + ".rjb";
+    }
+
+    Render::CRenderJobDescriptions descriptions;
+    bool bCompiled = descriptions.compile(
+        jobListFile.c_str(),
+        [](std::string& content, std::string const& filePath, void* pUserData)
+        {
+            std::string const& directory = *(std::string const*)pUserData;
+            return loadTextFile(content, directory + filePath);
+        },
+        &directory);
+    for(auto const& error : descriptions.getErrors())
+    {
+        DEBUG_PRINTF("error: %s\n", error.c_str());
+    }
+
+    Render::CRenderGraph renderGraph;
+    if(bCompiled)
+    {
+        bCompiled = renderGraph.compile(descriptions);
+        renderGraph.print();
+    }
+
+    if(bCompiled)
+    {
+        Render::CTransientAllocator transientAllocator;
+        renderGraph.addTransientResources(transientAllocator, iScreenWidth, iScreenHeight);
+        transientAllocator.allocate();
+        transientAllocator.print();
+
+        bCompiled = dryRunRecording(renderGraph, iNumRecordThreads);
+
+        if(bBenchmark)
+        {
+            benchmarkFrameLookups(renderGraph);
+        }
+
+        printResolutionModes(descriptions, iScreenWidth, iScreenHeight);
+        bCompiled = dryRunShaders(renderGraph, descriptions, directory) && bCompiled;
+        bCompiled = checkCompiledJobList(descriptions, jobListFile, directory, compiledFilePath, bWriteCompiled) && bCompiled;
+    }
+
+    return bCompiled ? 0 : 1;
+}
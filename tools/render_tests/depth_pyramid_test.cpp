@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+#include <sstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <render/depth_pyramid.h>
+
+#include "render_test.h"
+
+#include <rapidjson/document.h>
+
+/*
+**
+*/
+static bool loadTextFile(
+    std::string& content,
+    std::string const& filePath)
+{
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+
+    return true;
+}
+
+/*
+** shaders/depth-pyramid-compute.shader against Render::buildDepthPyramid. the shader's pyramid size, level count and
+** tile size have to be the header's and its buffer in depth-pyramid-compute.json the whole pyramid. its workgroups,
+** one per 16 x 16 tile of level 0 over a 32 x 16 dispatch reducing the tile down to level 4, are run on the cpu over
+** made up depth at a few screen sizes and render scales and have to give the reference's pyramid. boxes
+** isBoxOccluded culls against it are never in front of any pixel of the depth under them
+*/
+static void checkDepthPyramid(
+    CTestResult& result,
+    std::string const& rootDirectory)
+{
+    std::string shader;
+    uint32_t iTileSize = 0;
+    if(!loadTextFile(shader, rootDirectory + "shaders/depth-pyramid-compute.shader"))
+    {
+        result.fail("can\'t open depth-pyramid-compute.shader");
+    }
+    else
+    {
+        auto getConstant = [&shader](char const* szName)
+        {
+            size_t iStart = shader.find(std::string("const ") + szName + " = ");
+            return (iStart == std::string::npos) ? 0 : (uint32_t)atoi(shader.c_str() + iStart + strlen(szName) + 9);
+        };
+        iTileSize = getConstant("iTileSize");
+        if(getConstant("DEPTH_PYRAMID_WIDTH") != DEPTH_PYRAMID_WIDTH ||
+           getConstant("DEPTH_PYRAMID_HEIGHT") != DEPTH_PYRAMID_HEIGHT ||
+           getConstant("DEPTH_PYRAMID_NUM_LEVELS") != DEPTH_PYRAMID_NUM_LEVELS)
+        {
+            result.fail("shader constants aren\'t the ones of depth_pyramid.h");
+        }
+        if(iTileSize != (1u << (DEPTH_PYRAMID_NUM_LEVELS - 1)) || iTileSize * iTileSize > 256 ||
+           DEPTH_PYRAMID_WIDTH % iTileSize != 0 || DEPTH_PYRAMID_HEIGHT % iTileSize != 0 ||
+           shader.find("@workgroup_size(iTileSize, iTileSize)") == std::string::npos)
+        {
+            result.fail("tile size %d doesn\'t reduce to the last level", iTileSize);
+        }
+    }
+
+    std::string pipeline;
+    rapidjson::Document doc;
+    if(!loadTextFile(pipeline, rootDirectory + "render-jobs/depth-pyramid-compute.json") ||
+       doc.Parse(pipeline.c_str()).HasParseError() || !doc.HasMember("Attachments"))
+    {
+        result.fail("can\'t read depth-pyramid-compute.json");
+    }
+    else
+    {
+        bool bFound = false;
+        for(auto const& attachment : doc["Attachments"].GetArray())
+        {
+            if(attachment.HasMember("Size") && std::string(attachment["Name"].GetString()) == "Depth Pyramid")
+            {
+                bFound = (attachment["Size"].GetUint() == Render::getDepthPyramidLevelOffset(DEPTH_PYRAMID_NUM_LEVELS) * sizeof(float));
+            }
+        }
+        if(!bFound)
+        {
+            result.fail("\"Depth Pyramid\" buffer isn\'t the size of the pyramid");
+        }
+    }
+
+    if(iTileSize == 0 || !result.passed())
+    {
+        return;
+    }
+
+    // cs_main of the shader, every workgroup's invocations in lock step between the barriers
+    auto runShader = [iTileSize](
+        std::vector<float>& afPyramid,
+        std::vector<float> const& afDepthTexture,
+        uint32_t iTextureWidth,
+        uint32_t iTextureHeight,
+        float fRenderScale)
+    {
+        uint32_t const aiPyramidSize[2] = {DEPTH_PYRAMID_WIDTH, DEPTH_PYRAMID_HEIGHT};
+        uint32_t const aiTextureSize[2] = {iTextureWidth, iTextureHeight};
+        uint32_t aiDepthSize[2];
+        for(uint32_t i = 0; i < 2; i++)
+        {
+            aiDepthSize[i] = std::min((uint32_t)((float)aiTextureSize[i] * fRenderScale + 0.5f), aiTextureSize[i]);
+        }
+
+        std::vector<float> afTileDepths(256);
+        std::vector<float> afLevelDepths(iTileSize * iTileSize);
+        for(uint32_t iGroupY = 0; iGroupY < DEPTH_PYRAMID_HEIGHT / iTileSize; iGroupY++)
+        {
+            for(uint32_t iGroupX = 0; iGroupX < DEPTH_PYRAMID_WIDTH / iTileSize; iGroupX++)
+            {
+                for(uint32_t iLocal = 0; iLocal < iTileSize * iTileSize; iLocal++)
+                {
+                    uint32_t aiGlobal[2] = {iGroupX * iTileSize + iLocal % iTileSize, iGroupY * iTileSize + iLocal / iTileSize};
+                    uint32_t aiStart[2], aiEnd[2];
+                    for(uint32_t i = 0; i < 2; i++)
+                    {
+                        aiStart[i] = (aiGlobal[i] * aiDepthSize[i]) / aiPyramidSize[i];
+                        aiEnd[i] = ((aiGlobal[i] + 1) * aiDepthSize[i] + aiPyramidSize[i] - 1) / aiPyramidSize[i];
+                        aiEnd[i] = std::min(std::max(aiEnd[i], aiStart[i] + 1), aiDepthSize[i]);
+                    }
+
+                    float fMaxDepth = 0.0f;
+                    for(uint32_t iY = aiStart[1]; iY < aiEnd[1]; iY++)
+                    {
+                        for(uint32_t iX = aiStart[0]; iX < aiEnd[0]; iX++)
+                        {
+                            fMaxDepth = std::max(fMaxDepth, afDepthTexture[iY * iTextureWidth + iX]);
+                        }
+                    }
+
+                    afPyramid[aiGlobal[1] * DEPTH_PYRAMID_WIDTH + aiGlobal[0]] = fMaxDepth;
+                    afTileDepths[(iLocal / iTileSize) * iTileSize + iLocal % iTileSize] = fMaxDepth;
+                }
+
+                uint32_t iLevelOffset = 0;
+                uint32_t aiLevelSize[2] = {DEPTH_PYRAMID_WIDTH, DEPTH_PYRAMID_HEIGHT};
+                uint32_t iLevelTileSize = iTileSize;
+                for(uint32_t iLevel = 1; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+                {
+                    iLevelOffset += aiLevelSize[0] * aiLevelSize[1];
+                    aiLevelSize[0] /= 2;
+                    aiLevelSize[1] /= 2;
+                    iLevelTileSize /= 2;
+
+                    for(uint32_t iLocal = 0; iLocal < iTileSize * iTileSize; iLocal++)
+                    {
+                        uint32_t iLocalX = iLocal % iTileSize, iLocalY = iLocal / iTileSize;
+                        if(iLocalX < iLevelTileSize && iLocalY < iLevelTileSize)
+                        {
+                            uint32_t iPrev = iLocalY * 2 * iTileSize + iLocalX * 2;
+                            afLevelDepths[iLocal] = std::max(
+                                std::max(afTileDepths[iPrev], afTileDepths[iPrev + 1]),
+                                std::max(afTileDepths[iPrev + iTileSize], afTileDepths[iPrev + iTileSize + 1]));
+                        }
+                    }
+
+                    // workgroupBarrier()
+                    for(uint32_t iLocal = 0; iLocal < iTileSize * iTileSize; iLocal++)
+                    {
+                        uint32_t iLocalX = iLocal % iTileSize, iLocalY = iLocal / iTileSize;
+                        if(iLocalX < iLevelTileSize && iLocalY < iLevelTileSize)
+                        {
+                            afTileDepths[iLocalY * iTileSize + iLocalX] = afLevelDepths[iLocal];
+
+                            uint32_t iTexelX = iGroupX * iLevelTileSize + iLocalX, iTexelY = iGroupY * iLevelTileSize + iLocalY;
+                            afPyramid[iLevelOffset + iTexelY * aiLevelSize[0] + iTexelX] = afLevelDepths[iLocal];
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    uint32_t iSeed = 1;
+    auto random = [&iSeed]()
+    {
+        iSeed = iSeed * 1664525u + 1013904223u;
+        return (float)(iSeed >> 8) / 16777216.0f;
+    };
+
+    // right handed, looking down -z, depth 0 at the near plane and 1 at the far one
+    float const kfNear = 0.1f, kfFar = 100.0f;
+    auto getDepth = [kfNear, kfFar](float fDistance)
+    {
+        return (kfFar * (fDistance - kfNear)) / (fDistance * (kfFar - kfNear));
+    };
+
+    struct Test
+    {
+        uint32_t            miTextureWidth;
+        uint32_t            miTextureHeight;
+        float               mfRenderScale;
+    };
+    Test const aTests[] =
+    {
+        {1024, 1024, 1.0f},
+        {1366, 768, 1.0f},
+        {1920, 1080, 0.6667f},
+        {300, 200, 1.0f},           // under the pyramid size, texels share pixels
+    };
+    uint32_t const kiNumBoxes = 20000;
+    for(Test const& test : aTests)
+    {
+        uint32_t iWidth = std::min((uint32_t)((float)test.miTextureWidth * test.mfRenderScale + 0.5f), test.miTextureWidth);
+        uint32_t iHeight = std::min((uint32_t)((float)test.miTextureHeight * test.mfRenderScale + 0.5f), test.miTextureHeight);
+
+        // rectangles over the far plane, the closest one wins. the part of the texture past the render scale is
+        // left over from bigger frames and mustn't be read
+        std::vector<float> afDepthTexture(test.miTextureWidth * test.miTextureHeight, 0.0f);
+        std::vector<float> afDepth(iWidth * iHeight, 1.0f);
+        for(uint32_t iRectangle = 0; iRectangle < 60; iRectangle++)
+        {
+            uint32_t iStartX = (uint32_t)(random() * (float)iWidth), iStartY = (uint32_t)(random() * (float)iHeight);
+            uint32_t iEndX = std::min(iStartX + 1 + (uint32_t)(random() * (float)iWidth * 0.4f), iWidth);
+            uint32_t iEndY = std::min(iStartY + 1 + (uint32_t)(random() * (float)iHeight * 0.4f), iHeight);
+            float fDepth = getDepth(1.0f + random() * 30.0f);
+            for(uint32_t iY = iStartY; iY < iEndY; iY++)
+            {
+                for(uint32_t iX = iStartX; iX < iEndX; iX++)
+                {
+                    afDepth[iY * iWidth + iX] = std::min(afDepth[iY * iWidth + iX], fDepth);
+                }
+            }
+        }
+        for(uint32_t iY = 0; iY < test.miTextureHeight; iY++)
+        {
+            for(uint32_t iX = 0; iX < test.miTextureWidth; iX++)
+            {
+                afDepthTexture[iY * test.miTextureWidth + iX] = (iX < iWidth && iY < iHeight) ? afDepth[iY * iWidth + iX] : 2.0f;
+            }
+        }
+
+        std::vector<float> afReference(Render::getDepthPyramidLevelOffset(DEPTH_PYRAMID_NUM_LEVELS), -1.0f);
+        std::vector<float> afShader(afReference.size(), -1.0f);
+        Render::buildDepthPyramid(afReference.data(), afDepth.data(), iWidth, iHeight);
+        runShader(afShader, afDepthTexture, test.miTextureWidth, test.miTextureHeight, test.mfRenderScale);
+        for(uint32_t iLevel = 0; iLevel < DEPTH_PYRAMID_NUM_LEVELS; iLevel++)
+        {
+            uint32_t iStart = Render::getDepthPyramidLevelOffset(iLevel), iEnd = Render::getDepthPyramidLevelOffset(iLevel + 1);
+            if(!std::equal(afReference.begin() + iStart, afReference.begin() + iEnd, afShader.begin() + iStart))
+            {
+                result.fail("%d x %d level %d isn\'t the reference\'s", iWidth, iHeight, iLevel);
+            }
+        }
+
+        // row major, column vectors
+        float fTangent = tanf(3.14159f * 0.25f * 0.5f);
+        float fAspectRatio = (float)iWidth / (float)iHeight;
+        float const afViewProjection[16] =
+        {
+            1.0f / (fTangent * fAspectRatio), 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f / fTangent, 0.0f, 0.0f,
+            0.0f, 0.0f, kfFar / (kfNear - kfFar), (kfNear * kfFar) / (kfNear - kfFar),
+            0.0f, 0.0f, -1.0f, 0.0f,
+        };
+
+        uint32_t iNumOccluded = 0;
+        for(uint32_t iBox = 0; iBox < kiNumBoxes; iBox++)
+        {
+            float fDistance = 2.0f + random() * 60.0f;
+            float afCenter[3] =
+            {
+                (random() * 2.4f - 1.2f) * fDistance * fTangent * fAspectRatio,
+                (random() * 2.4f - 1.2f) * fDistance * fTangent,
+                -fDistance,
+            };
+            float fHalfSize = 0.02f + random() * random() * 3.0f;
+            float afMinPosition[3], afMaxPosition[3];
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                afMinPosition[i] = afCenter[i] - fHalfSize * (0.25f + random());
+                afMaxPosition[i] = afCenter[i] + fHalfSize * (0.25f + random());
+            }
+
+            if(!Render::isBoxOccluded(afReference.data(), afMinPosition, afMaxPosition, afViewProjection))
+            {
+                continue;
+            }
+            ++iNumOccluded;
+
+            // pixel centers in the box's screen rectangle, all of them have to be in front of its closest corner
+            float afMinUVZ[3] = {1.0e30f, 1.0e30f, 1.0e30f};
+            float afMaxUV[2] = {-1.0e30f, -1.0e30f};
+            for(uint32_t iCorner = 0; iCorner < 8; iCorner++)
+            {
+                float afCorner[3] =
+                {
+                    (iCorner & 1) ? afMaxPosition[0] : afMinPosition[0],
+                    (iCorner & 2) ? afMaxPosition[1] : afMinPosition[1],
+                    (iCorner & 4) ? afMaxPosition[2] : afMinPosition[2],
+                };
+                float fW = -afCorner[2];
+                float afUVZ[3] =
+                {
+                    (afViewProjection[0] * afCorner[0] / fW) * 0.5f + 0.5f,
+                    0.5f - (afViewProjection[5] * afCorner[1] / fW) * 0.5f,
+                    (afViewProjection[10] * afCorner[2] + afViewProjection[11]) / fW,
+                };
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    afMinUVZ[i] = std::min(afMinUVZ[i], afUVZ[i]);
+                }
+                for(uint32_t i = 0; i < 2; i++)
+                {
+                    afMaxUV[i] = std::max(afMaxUV[i], afUVZ[i]);
+                }
+            }
+
+            int32_t iStartX = std::max((int32_t)ceilf(afMinUVZ[0] * (float)iWidth - 0.5f), 0);
+            int32_t iEndX = std::min((int32_t)floorf(afMaxUV[0] * (float)iWidth - 0.5f), (int32_t)iWidth - 1);
+            int32_t iStartY = std::max((int32_t)ceilf(afMinUVZ[1] * (float)iHeight - 0.5f), 0);
+            int32_t iEndY = std::min((int32_t)floorf(afMaxUV[1] * (float)iHeight - 0.5f), (int32_t)iHeight - 1);
+            bool bVisible = false;
+            for(int32_t iY = iStartY; iY <= iEndY && !bVisible; iY++)
+            {
+                for(int32_t iX = iStartX; iX <= iEndX; iX++)
+                {
+                    if(afDepth[iY * iWidth + iX] >= afMinUVZ[2])
+                    {
+                        bVisible = true;
+                        break;
+                    }
+                }
+            }
+            if(bVisible)
+            {
+                result.fail("%d x %d box %d is visible but occluded", iWidth, iHeight, iBox);
+            }
+        }
+
+        // occluding nothing would pass the above too
+        if(iNumOccluded == 0)
+        {
+            result.fail("%d x %d culls none of the boxes", iWidth, iHeight);
+        }
+
+        DEBUG_PRINTF("depth pyramid: %d x %d of %d x %d, %d of %d boxes occluded\n",
+            iWidth,
+            iHeight,
+            test.miTextureWidth,
+            test.miTextureHeight,
+            iNumOccluded,
+            kiNumBoxes);
+    }
+}
+
+/*
+** the shader and pipeline file are read from the repo directory given by ctest
+*/
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        DEBUG_PRINTF("usage: depth_pyramid_test <repo directory>\n");
+        return 1;
+    }
+
+    CTestResult result("depth pyramid");
+    checkDepthPyramid(result, std::string(argv[1]) + "/");
+    return result.finish();
+}
@@ -0,0 +1,193 @@
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#include <render/dynamic_resolution.h>
+
+#include "render_test.h"
+
+/*
+** the camera jitter and the render scale controller of the app's dynamic resolution. the jitter of every scale stays
+** within half a render pixel, averages out to the pixel center over its phases and puts a sample in every output pixel.
+** the controller runs over frame times of a fixed part and a part going with the pixel count and has to settle at a
+** scale in the thresholds, or at the minimum when even that is over, and come back up to the maximum when the load goes
+*/
+static void checkDynamicResolution(CTestResult& result)
+{
+    uint32_t const kiOutputWidth = 1920;
+    uint32_t const kiOutputHeight = 1080;
+    float const afScales[] = {1.0f, 0.875f, 0.75f, 0.6667f, 0.5f, 0.33f};
+    for(float fScale : afScales)
+    {
+        uint32_t aiRenderSize[2];
+        Render::getRenderSize(aiRenderSize, kiOutputWidth, kiOutputHeight, fScale);
+        uint32_t iNumPhases = Render::getJitterPhaseCount(fScale);
+
+        // in render pixels
+        std::vector<float> afJitter(iNumPhases * 2);
+        float afMean[2] = {0.0f, 0.0f};
+        for(uint32_t iFrame = 0; iFrame < iNumPhases; iFrame++)
+        {
+            float afClipSpace[2];
+            Render::getJitterOffset(afClipSpace, iFrame, iNumPhases, aiRenderSize[0], aiRenderSize[1]);
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                afJitter[iFrame * 2 + i] = afClipSpace[i] * 0.5f * (float)aiRenderSize[i];
+                afMean[i] += afJitter[iFrame * 2 + i] / (float)iNumPhases;
+                if(fabsf(afJitter[iFrame * 2 + i]) > 0.5f)
+                {
+                    result.fail("scale %.4f jitter past half a pixel", fScale);
+                }
+            }
+
+            float afNext[2];
+            Render::getJitterOffset(afNext, iFrame + iNumPhases, iNumPhases, aiRenderSize[0], aiRenderSize[1]);
+            if(afNext[0] != afClipSpace[0] || afNext[1] != afClipSpace[1])
+            {
+                result.fail("scale %.4f jitter not repeating over the phases", fScale);
+            }
+
+            for(uint32_t iPrev = 0; iPrev < iFrame; iPrev++)
+            {
+                if(fabsf(afJitter[iPrev * 2] - afJitter[iFrame * 2]) < 1.0e-4f &&
+                   fabsf(afJitter[iPrev * 2 + 1] - afJitter[iFrame * 2 + 1]) < 1.0e-4f)
+                {
+                    result.fail("scale %.4f same jitter twice", fScale);
+                }
+            }
+        }
+        if(fabsf(afMean[0]) > 1.0f / (float)iNumPhases || fabsf(afMean[1]) > 1.0f / (float)iNumPhases)
+        {
+            result.fail("scale %.4f jitter not centered", fScale);
+        }
+
+        // samples of all the phases in the output pixels of a corner of the screen
+        uint32_t const kiBlockSize = 16;
+        float fOutputPerRender = (float)kiOutputWidth / (float)aiRenderSize[0];
+        std::vector<uint8_t> abCovered(kiBlockSize * kiBlockSize, 0);
+        uint32_t iNumRenderPixels = (uint32_t)ceilf((float)kiBlockSize / fOutputPerRender) + 1;
+        for(uint32_t iFrame = 0; iFrame < iNumPhases; iFrame++)
+        {
+            for(uint32_t iY = 0; iY < iNumRenderPixels; iY++)
+            {
+                for(uint32_t iX = 0; iX < iNumRenderPixels; iX++)
+                {
+                    uint32_t iOutputX = (uint32_t)(((float)iX + 0.5f + afJitter[iFrame * 2]) * fOutputPerRender);
+                    uint32_t iOutputY = (uint32_t)(((float)iY + 0.5f + afJitter[iFrame * 2 + 1]) * fOutputPerRender);
+                    if(iOutputX < kiBlockSize && iOutputY < kiBlockSize)
+                    {
+                        abCovered[iOutputY * kiBlockSize + iOutputX] = 1;
+                    }
+                }
+            }
+        }
+        for(uint8_t bCovered : abCovered)
+        {
+            if(!bCovered)
+            {
+                result.fail("scale %.4f output pixel without samples", fScale);
+                break;
+            }
+        }
+
+        DEBUG_PRINTF("dynamic resolution: scale %.4f %d x %d, %d phases, mean jitter (%.4f, %.4f)\n",
+            fScale,
+            aiRenderSize[0],
+            aiRenderSize[1],
+            iNumPhases,
+            afMean[0],
+            afMean[1]);
+    }
+
+    struct Load
+    {
+        float                                   mfFixedMilliseconds;
+        float                                   mfFullResolutionMilliseconds;
+    };
+    std::vector<Load> const aLoads =
+    {
+        {4.0f, 6.0f},
+        {4.0f, 20.0f},
+        {2.0f, 30.0f},
+        {10.0f, 40.0f},
+        {4.0f, 6.0f},
+    };
+
+    Render::DynamicResolutionDescriptor desc;
+    Render::DynamicResolutionState state;
+    Render::resetDynamicResolution(state, desc);
+    uint32_t const kiNumFrames = 900;
+    uint32_t iRandom = 1;
+    for(uint32_t iLoad = 0; iLoad < (uint32_t)aLoads.size(); iLoad++)
+    {
+        Load const& load = aLoads[iLoad];
+        auto getFrameMilliseconds = [&load](float fScale)
+        {
+            return load.mfFixedMilliseconds + load.mfFullResolutionMilliseconds * fScale * fScale;
+        };
+
+        uint32_t iStartChanges = state.miNumChanges;
+        uint32_t iSettledChanges = 0;
+        float fMinScale = 0.0f;
+        float fMaxScale = 0.0f;
+        for(uint32_t iFrame = 0; iFrame < kiNumFrames; iFrame++)
+        {
+            // 5 percent of noise
+            iRandom = iRandom * 1664525u + 1013904223u;
+            float fNoise = ((float)(iRandom >> 8) / (float)(1u << 24) - 0.5f) * 0.1f;
+            float fScale = Render::updateDynamicResolution(state, desc, getFrameMilliseconds(state.mfScale) * (1.0f + fNoise));
+            if(fScale < desc.mfMinScale || fScale > desc.mfMaxScale)
+            {
+                result.fail("scale %.4f out of range", fScale);
+            }
+            if(iFrame == kiNumFrames / 2)
+            {
+                iSettledChanges = state.miNumChanges;
+                fMinScale = fScale;
+                fMaxScale = fScale;
+            }
+            if(iFrame >= kiNumFrames / 2)
+            {
+                fMinScale = (fScale < fMinScale) ? fScale : fMinScale;
+                fMaxScale = (fScale > fMaxScale) ? fScale : fMaxScale;
+            }
+        }
+
+        float fScale = state.mfScale;
+        float fMilliseconds = getFrameMilliseconds(fScale);
+        float fUpper = desc.mfTargetMilliseconds * desc.mfUpperThreshold;
+        float fLower = desc.mfTargetMilliseconds * desc.mfLowerThreshold;
+        if(fMilliseconds > fUpper && fScale > desc.mfMinScale)
+        {
+            result.fail("scale %.4f over the target", fScale);
+        }
+        if(fMilliseconds < fLower && fScale < desc.mfMaxScale)
+        {
+            result.fail("scale %.4f under the target", fScale);
+        }
+        if(state.miNumChanges != iSettledChanges || fMinScale != fMaxScale)
+        {
+            result.fail("scale %.4f not settled", fScale);
+        }
+        if(state.miNumChanges - iStartChanges > 10)
+        {
+            result.fail("scale %.4f too many changes", fScale);
+        }
+
+        DEBUG_PRINTF("dynamic resolution: load %d settled at scale %.4f, %.2f ms, %d changes\n",
+            iLoad,
+            fScale,
+            fMilliseconds,
+            state.miNumChanges - iStartChanges);
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("dynamic resolution");
+    checkDynamicResolution(result);
+    return result.finish();
+}
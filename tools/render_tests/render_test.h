@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <utils/LogPrint.h>
+
+/*
+** pass or fail of a test program of the render code. every failed check prints what went wrong with the subsystem's
+** name and the program returns finish() to ctest
+*/
+class CTestResult
+{
+public:
+    CTestResult(char const* szName) : mszName(szName) {}
+
+    void fail(char const* szFormat, ...)
+    {
+        char acMessage[512];
+        va_list args;
+        va_start(args, szFormat);
+        vsnprintf(acMessage, sizeof(acMessage), szFormat, args);
+        va_end(args);
+
+        DEBUG_PRINTF("!!! %s: %s !!!\n", mszName, acMessage);
+        mbPassed = false;
+    }
+
+    inline bool passed() const
+    {
+        return mbPassed;
+    }
+
+    int finish() const
+    {
+        DEBUG_PRINTF("%s %s\n", mszName, mbPassed ? "pass" : "FAIL");
+        return mbPassed ? 0 : 1;
+    }
+
+protected:
+    char const*         mszName;
+    bool                mbPassed = true;
+};
@@ -0,0 +1,250 @@
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <render/render_job_descriptions.h>
+#include <render/resolution_mode.h>
+
+#include "render_test.h"
+
+/*
+** in memory job list and pipeline files for checkResolutionModes(), the job name is the pipeline file
+*/
+static std::map<std::string, std::string> const saTestPipelineFiles =
+{
+    {"full.json",
+        "{\"Shader\": \"a.shader\", \"Attachments\": ["
+        "{\"Name\": \"Output\", \"Type\": \"TextureOutput\", \"Format\": \"rgba16float\"}]}"},
+    {"half.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Scale\": 0.5, \"Constants\": {\"OTHER\": 3}, \"Attachments\": ["
+        "{\"Name\": \"Output\", \"Type\": \"TextureOutput\", \"Format\": \"rgba16float\", \"ScaleWidth\": 0.5, \"ScaleHeight\": 1.0},"
+        "{\"Name\": \"Buffer\", \"Type\": \"BufferOutput\", \"Size\": 256},"
+        "{\"Name\": \"Output\", \"Type\": \"TextureInput\", \"ParentJobName\": \"full.json\"}]}"},
+    {"checkerboard.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Mode\": \"Checkerboard\", \"Attachments\": []}"},
+    {"interleaved.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Scale\": 0.5, \"Resolution Mode\": \"Interleaved\", \"Interleave Size\": 4, \"Attachments\": []}"},
+    {"bad-scale.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Scale\": 0, \"Attachments\": []}"},
+    {"bad-scale-over.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Scale\": 1.5, \"Attachments\": []}"},
+    {"bad-scale-type.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Scale\": \"half\", \"Attachments\": []}"},
+    {"bad-mode.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Mode\": \"Quarter\", \"Attachments\": []}"},
+    {"bad-interleave.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Mode\": \"Interleaved\", \"Interleave Size\": 3, \"Attachments\": []}"},
+    {"bad-constant.json",
+        "{\"Shader\": \"a.shader\", \"Resolution Mode\": \"Checkerboard\", \"Constants\": {\"RESOLUTION_MODE\": 2}, \"Attachments\": []}"},
+};
+
+/*
+** "Resolution Scale", "Resolution Mode" and "Interleave Size" of pipeline files compiled from memory, good ones and
+** each bad value on its own, through the compiled job list and back. the target sizes of the scaled outputs and every
+** pixel shaded once over the frames of each mode
+*/
+static void checkResolutionModes(CTestResult& result)
+{
+    auto compile = [](Render::CRenderJobDescriptions& descriptions, std::vector<std::string> const& aPipelines)
+    {
+        std::string jobList = "{\"Jobs\": [";
+        for(uint32_t i = 0; i < (uint32_t)aPipelines.size(); i++)
+        {
+            jobList += std::string((i > 0) ? ", " : "") +
+                "{\"Name\": \"" + aPipelines[i] + "\", \"Type\": \"Graphics\", \"PassType\": \"Full Triangle\", \"Pipeline\": \"" + aPipelines[i] + "\"}";
+        }
+        jobList += "]}";
+
+        return descriptions.compile(
+            jobList.c_str(),
+            [](std::string& content, std::string const& filePath, void*)
+            {
+                auto iter = saTestPipelineFiles.find(filePath);
+                if(iter == saTestPipelineFiles.end())
+                {
+                    return false;
+                }
+                content = iter->second;
+                return true;
+            },
+            nullptr);
+    };
+
+    Render::CRenderJobDescriptions descriptions;
+    if(!compile(descriptions, {"full.json", "half.json", "checkerboard.json", "interleaved.json"}))
+    {
+        for(auto const& error : descriptions.getErrors())
+        {
+            result.fail("%s", error.c_str());
+        }
+    }
+    else
+    {
+        // and read back from the compiled job list
+        std::vector<uint8_t> acCompiled;
+        descriptions.write(acCompiled);
+        Render::CRenderJobDescriptions readDescriptions;
+        if(!readDescriptions.read(acCompiled.data(), (uint64_t)acCompiled.size()))
+        {
+            result.fail("compiled job list doesn't read back");
+        }
+
+        for(Render::CRenderJobDescriptions const* pDescriptions : {&descriptions, &readDescriptions})
+        {
+            std::vector<Render::CRenderJobDescriptions::Job> const& aJobs = pDescriptions->getJobs();
+            if(aJobs.size() != 4)
+            {
+                result.fail("not all the jobs are there");
+                continue;
+            }
+
+            Render::CRenderJobDescriptions::Job const& full = aJobs[0];
+            if(full.mfResolutionScale != 1.0f || full.mResolutionMode != Render::ResolutionMode::Full ||
+               full.maConstants.size() != 0 || full.maAttachments[0].mfScaleWidth != 1.0f)
+            {
+                result.fail("a pipeline without the keys isn't full resolution");
+            }
+
+            // only the texture outputs are scaled, on top of their own scale
+            Render::CRenderJobDescriptions::Job const& half = aJobs[1];
+            if(half.mfResolutionScale != 0.5f || half.mResolutionMode != Render::ResolutionMode::Full || half.maConstants.size() != 1 ||
+               half.maAttachments[0].mfScaleWidth != 0.25f || half.maAttachments[0].mfScaleHeight != 0.5f ||
+               half.maAttachments[1].miSize != 256 || half.maAttachments[2].mfScaleWidth != 1.0f)
+            {
+                result.fail("\"Resolution Scale\" isn't applied to the texture outputs");
+            }
+
+            struct Mode
+            {
+                uint32_t                        miJob;
+                Render::ResolutionMode          mMode;
+                uint32_t                        miInterleaveSize;
+            };
+            for(Mode const& mode : {Mode{2, Render::ResolutionMode::Checkerboard, 2}, Mode{3, Render::ResolutionMode::Interleaved, 4}})
+            {
+                Render::CRenderJobDescriptions::Job const& job = aJobs[mode.miJob];
+                std::vector<std::pair<std::string, double>> const aExpected =
+                {
+                    {"RESOLUTION_MODE", (double)mode.mMode},
+                    {"RESOLUTION_INTERLEAVE", (double)mode.miInterleaveSize},
+                };
+                if(job.mResolutionMode != mode.mMode || job.miInterleaveSize != mode.miInterleaveSize || job.maConstants != aExpected)
+                {
+                    result.fail("\"%s\" doesn't have its mode and constants", job.mName.c_str());
+                }
+            }
+        }
+    }
+
+    for(auto const& pipeline : saTestPipelineFiles)
+    {
+        if(pipeline.first.find("bad-") != 0)
+        {
+            continue;
+        }
+
+        Render::CRenderJobDescriptions badDescriptions;
+        if(compile(badDescriptions, {pipeline.first}) || badDescriptions.getErrors().size() != 1)
+        {
+            result.fail("\"%s\" isn't one error", pipeline.first.c_str());
+        }
+        else
+        {
+            DEBUG_PRINTF("resolution modes: %s\n", badDescriptions.getErrors().front().c_str());
+        }
+    }
+
+    // at least a pixel, never over the screen
+    uint32_t const aaiScreenSizes[][2] = {{1920, 1080}, {1024, 1024}, {1366, 768}, {3, 5}, {1, 1}};
+    float const afScales[] = {1.0f, 0.75f, 0.5f, 0.25f, 0.5f * 0.5f, 0.1f};
+    for(auto const& aiScreenSize : aaiScreenSizes)
+    {
+        for(float fScale : afScales)
+        {
+            uint32_t aiTargetSize[2];
+            Render::getTargetSize(aiTargetSize, aiScreenSize[0], aiScreenSize[1], fScale, fScale * 0.5f);
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                float fAxisScale = (i == 0) ? fScale : fScale * 0.5f;
+                uint32_t iExpected = (uint32_t)((float)aiScreenSize[i] * fAxisScale);
+                iExpected = (iExpected > 0) ? iExpected : 1;
+                if(aiTargetSize[i] != iExpected || aiTargetSize[i] > aiScreenSize[i])
+                {
+                    result.fail("target size %d of %d at %f", aiTargetSize[i], aiScreenSize[i], fAxisScale);
+                }
+            }
+        }
+    }
+
+    // every pixel once over the period, the same number of them each frame, away from the origin too
+    struct Mode
+    {
+        Render::ResolutionMode                  mMode;
+        uint32_t                                miInterleaveSize;
+    };
+    Mode const aModes[] =
+    {
+        {Render::ResolutionMode::Full, 2},
+        {Render::ResolutionMode::Checkerboard, 2},
+        {Render::ResolutionMode::Interleaved, 2},
+        {Render::ResolutionMode::Interleaved, 4},
+    };
+    uint32_t const kiBlockSize = 8;
+    uint32_t const kaiOrigin[2] = {13, 6};
+    for(Mode const& mode : aModes)
+    {
+        uint32_t iPeriod = Render::getResolutionModePeriod(mode.mMode, mode.miInterleaveSize);
+        std::vector<uint32_t> aiNumShaded(kiBlockSize * kiBlockSize, 0);
+        for(uint32_t iFrame = 7; iFrame < 7 + iPeriod; iFrame++)
+        {
+            uint32_t iNumShaded = 0;
+            for(uint32_t iY = 0; iY < kiBlockSize; iY++)
+            {
+                for(uint32_t iX = 0; iX < kiBlockSize; iX++)
+                {
+                    if(Render::isPixelShaded(kaiOrigin[0] + iX, kaiOrigin[1] + iY, iFrame, mode.mMode, mode.miInterleaveSize))
+                    {
+                        ++aiNumShaded[iY * kiBlockSize + iX];
+                        ++iNumShaded;
+                    }
+                }
+            }
+
+            float fFraction = (float)iNumShaded / (float)(kiBlockSize * kiBlockSize);
+            if(fFraction != Render::getShadedFraction(mode.mMode, mode.miInterleaveSize))
+            {
+                result.fail("mode %d shades %f of the pixels", (uint32_t)mode.mMode, fFraction);
+            }
+        }
+
+        for(uint32_t iNumShaded : aiNumShaded)
+        {
+            if(iNumShaded != 1)
+            {
+                result.fail("mode %d shades a pixel %d times", (uint32_t)mode.mMode, iNumShaded);
+                break;
+            }
+        }
+    }
+
+    // the diagonal of the 2 x 2 square first
+    uint32_t const kaaiBayerOrder[4][2] = {{0, 0}, {1, 1}, {1, 0}, {0, 1}};
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        if(Render::getBayerIndex(kaaiBayerOrder[i][0], kaaiBayerOrder[i][1], 2) != i)
+        {
+            result.fail("bayer order");
+        }
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("resolution modes");
+    checkResolutionModes(result);
+    return result.finish();
+}
@@ -0,0 +1,126 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <render/shader_preprocessor.h>
+
+#include "render_test.h"
+
+/*
+** in memory files for checkShaderDirectives()
+*/
+static std::map<std::string, std::string> const saTestShaderFiles =
+{
+    {"a.shader",
+        "#include \"b.shader\"\n"
+        "#include \"b.shader\"\n"
+        "#ifndef PHASE\n"
+        "#define PHASE 0u\n"
+        "#endif\n"
+        "#if PHASE == 1 && defined(EXTRA)\n"
+        "early extra\n"
+        "#elif PHASE == 1\n"
+        "early\n"
+        "#elif (PHASE >= 2) || !defined(EXTRA)\n"
+        "  #ifdef EXTRA\n"
+        "late extra\n"
+        "  #else\n"
+        "other PHASE\n"
+        "  #endif\n"
+        "#else\n"
+        "none\n"
+        "#endif\n"},
+    {"b.shader",
+        "#include \"a.shader\"\n"
+        "struct B { PHASEx: u32, };\n"},
+    {"bad.shader",
+        "#if PHASE ==\n"
+        "#endif\n"},
+};
+
+/*
+** the directives of the shader preprocessor on in memory files, including a file twice and files including each
+** other, nested branches, job defines over the shader's defaults and a bad #if
+*/
+static void checkShaderDirectives(CTestResult& result)
+{
+    Render::CShaderPreprocessor preprocessor;
+    preprocessor.setup(
+        [](std::string& content, std::string const& filePath, void*)
+        {
+            auto iter = saTestShaderFiles.find(filePath);
+            if(iter == saTestShaderFiles.end())
+            {
+                return false;
+            }
+            content = iter->second;
+            return true;
+        },
+        nullptr);
+
+    struct Test
+    {
+        std::string                             mFile;
+        Render::CShaderPreprocessor::Defines    maDefines;
+        char const*                             mszExpected;        // nullptr for an error
+    };
+    std::vector<Test> const aTests =
+    {
+        {"a.shader", {}, "struct B { PHASEx: u32, };\nother 0u\n"},
+        {"a.shader", {{"PHASE", "1"}}, "struct B { PHASEx: u32, };\nearly\n"},
+        {"a.shader", {{"PHASE", "1u"}, {"EXTRA", "1"}}, "struct B { PHASEx: u32, };\nearly extra\n"},
+        {"a.shader", {{"EXTRA", "1"}, {"PHASE", "2"}}, "struct B { PHASEx: u32, };\nlate extra\n"},
+        {"a.shader", {{"EXTRA", ""}}, "struct B { PHASEx: u32, };\nnone\n"},
+        {"bad.shader", {}, nullptr},
+        {"missing.shader", {}, nullptr},
+    };
+
+    for(Test const& test : aTests)
+    {
+        std::string const* pOutput = preprocessor.preprocess(test.mFile, test.maDefines);
+        bool bTestPassed = (test.mszExpected == nullptr) ?
+            (pOutput == nullptr) :
+            (pOutput != nullptr && *pOutput == test.mszExpected);
+
+        // asking again gives the cached variant, the same defines in another order too
+        Render::CShaderPreprocessor::Defines aReversedDefines(test.maDefines.rbegin(), test.maDefines.rend());
+        if(pOutput != nullptr && preprocessor.preprocess(test.mFile, aReversedDefines) != pOutput)
+        {
+            bTestPassed = false;
+        }
+
+        if(!bTestPassed)
+        {
+            result.fail("\"%s\" with %d defines gives \"%s\"",
+                test.mFile.c_str(),
+                (uint32_t)test.maDefines.size(),
+                (pOutput != nullptr) ? pOutput->c_str() : "an error");
+        }
+    }
+
+    // the errors have the file and line
+    if(preprocessor.getErrors().size() <= 0 || preprocessor.getErrors().front() != "bad.shader(1): bad #if \"PHASE ==\"")
+    {
+        result.fail("unexpected errors");
+    }
+
+    // 5 variants of a.shader, the two bad ones aren't kept
+    Render::CShaderPreprocessor::Stats const& stats = preprocessor.getStats();
+    if(stats.miNumPreprocessed != 5 || stats.miNumRequested != 12 || stats.miNumFilesLoaded != 3)
+    {
+        result.fail("%d variants from %d requests and %d files",
+            stats.miNumPreprocessed,
+            stats.miNumRequested,
+            stats.miNumFilesLoaded);
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("shader directives");
+    checkShaderDirectives(result);
+    return result.finish();
+}
@@ -0,0 +1,314 @@
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#include <render/shadow_cascades.h>
+
+#include "render_test.h"
+
+/*
+** the light view cascades of the app's light over cameras looking around the field, with texel snapping and with the
+** app's cells of 32 texels. the slice corners are in their cascade's bounding sphere and shadow map, a world position
+** only moves by whole texels in the shadow map when the camera moves, the cascade sizes don't change when the camera
+** turns, and the culling keeps every box with a point in a cascade and drops boxes away from it
+*/
+static void checkShadowCascades(CTestResult& result)
+{
+    struct Test
+    {
+        float                                   mafPosition[3];
+        float                                   mafLookAt[3];
+        float                                   mfAspectRatio;
+        uint32_t                                miSnapTexels;
+    };
+    std::vector<Test> const aTests =
+    {
+        {{0.0f, 1.8f, 3.0f}, {0.0f, 1.0f, -18.44f}, 16.0f / 9.0f, 1},
+        {{0.0f, 1.8f, 3.0f}, {0.0f, 1.0f, -18.44f}, 16.0f / 9.0f, 32},
+        {{12.0f, 20.0f, -40.0f}, {-30.0f, 0.0f, -100.0f}, 1.0f, 32},
+        {{-3.5f, 1.2f, -60.0f}, {40.0f, 8.0f, -61.0f}, 0.5f, 8},
+    };
+
+    uint32_t const kiShadowMapSize = 1024;
+    float const kfEpsilon = 1.0e-3f;
+
+    auto makeCamera = [](float const* pfPosition, float const* pfLookAt, float fAspectRatio)
+    {
+        Render::ShadowCascadeCamera camera;
+        float fLength = 0.0f;
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            camera.mafPosition[i] = pfPosition[i];
+            camera.mafLookDirection[i] = pfLookAt[i] - pfPosition[i];
+            fLength += camera.mafLookDirection[i] * camera.mafLookDirection[i];
+        }
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            camera.mafLookDirection[i] /= sqrtf(fLength);
+        }
+        camera.mfFieldOfView = 3.14159f * 0.15f;
+        camera.mfAspectRatio = fAspectRatio;
+        camera.mfNear = 0.01f;
+        camera.mfFar = 500.0f;
+        return camera;
+    };
+
+    // corners of the slice, near plane then far plane
+    auto getSliceCorners = [](float (*pafCorners)[3], Render::ShadowCascadeCamera const& camera, float fNearDistance, float fFarDistance)
+    {
+        float const* pfLook = camera.mafLookDirection;
+        float afRight[3] = {-pfLook[2], 0.0f, pfLook[0]};
+        float fRightLength = sqrtf(afRight[0] * afRight[0] + afRight[2] * afRight[2]);
+        afRight[0] /= fRightLength;
+        afRight[2] /= fRightLength;
+        float afUp[3] =
+        {
+            afRight[1] * pfLook[2] - afRight[2] * pfLook[1],
+            afRight[2] * pfLook[0] - afRight[0] * pfLook[2],
+            afRight[0] * pfLook[1] - afRight[1] * pfLook[0],
+        };
+
+        float fTangent = tanf(camera.mfFieldOfView * 0.5f);
+        for(uint32_t iCorner = 0; iCorner < 8; iCorner++)
+        {
+            float fDistance = (iCorner < 4) ? fNearDistance : fFarDistance;
+            float fHalfHeight = fDistance * fTangent * ((iCorner & 2) ? -1.0f : 1.0f);
+            float fHalfWidth = fDistance * fTangent * camera.mfAspectRatio * ((iCorner & 1) ? -1.0f : 1.0f);
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                pafCorners[iCorner][i] = camera.mafPosition[i] + pfLook[i] * fDistance + afRight[i] * fHalfWidth + afUp[i] * fHalfHeight;
+            }
+        }
+    };
+
+    auto project = [](float* pfClipSpace, Render::ShadowCascade const& cascade, float const* pfPosition)
+    {
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            float const* pfRow = cascade.mafViewProjection + i * 4;
+            pfClipSpace[i] = pfRow[0] * pfPosition[0] + pfRow[1] * pfPosition[1] + pfRow[2] * pfPosition[2] + pfRow[3];
+        }
+    };
+
+    auto isInShadowMap = [](float const* pfClipSpace)
+    {
+        return
+            fabsf(pfClipSpace[0]) <= 1.0f && fabsf(pfClipSpace[1]) <= 1.0f &&
+            pfClipSpace[2] >= 0.0f && pfClipSpace[2] <= 1.0f;
+    };
+
+    // a grid of extents over the field, min and max position as float4
+    std::vector<float> afExtents;
+    for(int32_t iZ = -16; iZ <= 4; iZ++)
+    {
+        for(int32_t iX = -10; iX <= 10; iX++)
+        {
+            float afMin[4] = {(float)iX * 8.0f, -1.0f + (float)((iX + iZ) & 3), (float)iZ * 8.0f, 1.0f};
+            float afMax[4] = {afMin[0] + 3.0f, afMin[1] + 2.0f + (float)(iZ & 1) * 6.0f, afMin[2] + 5.0f, 1.0f};
+            afExtents.insert(afExtents.end(), afMin, afMin + 4);
+            afExtents.insert(afExtents.end(), afMax, afMax + 4);
+        }
+    }
+    uint32_t iNumMeshes = (uint32_t)afExtents.size() / 8;
+    std::vector<uint8_t> abSkip(iNumMeshes, 0);
+    for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh += 7)
+    {
+        abSkip[iMesh] = 1;
+    }
+
+    for(uint32_t iTest = 0; iTest < (uint32_t)aTests.size(); iTest++)
+    {
+        Test const& test = aTests[iTest];
+
+        Render::ShadowCascadeDescriptor desc;
+        float fLightLength = sqrtf(0.3f * 0.3f + 1.0f);
+        desc.mafLightDirection[0] = 0.3f / fLightLength;
+        desc.mafLightDirection[1] = 1.0f / fLightLength;
+        desc.mafLightDirection[2] = 0.0f;
+        desc.miNumCascades = 3;
+        desc.miShadowMapSize = kiShadowMapSize;
+        desc.miSnapTexels = test.miSnapTexels;
+        desc.mfNear = 1.0f;
+        desc.mfFar = 150.0f;
+        desc.mfSplitLambda = 0.75f;
+        desc.mfCasterDistance = 50.0f;
+
+        Render::ShadowCascadeCamera camera = makeCamera(test.mafPosition, test.mafLookAt, test.mfAspectRatio);
+        Render::ShadowCascade aCascades[SHADOW_MAX_CASCADES];
+        Render::fitShadowCascades(aCascades, desc, camera);
+
+        // the camera a quarter texel of the finest cascade over and turned
+        float fMove = aCascades[0].mfTexelSize * 0.25f;
+        float afMovedPosition[3] = {test.mafPosition[0] + fMove, test.mafPosition[1] + fMove * 0.5f, test.mafPosition[2] - fMove};
+        float afMovedLookAt[3] = {test.mafLookAt[0] + 7.0f, test.mafLookAt[1] - 2.0f, test.mafLookAt[2] + 5.0f};
+        Render::ShadowCascadeCamera movedCamera = makeCamera(afMovedPosition, afMovedLookAt, test.mfAspectRatio);
+        Render::ShadowCascade aMovedCascades[SHADOW_MAX_CASCADES];
+        Render::fitShadowCascades(aMovedCascades, desc, movedCamera);
+
+        float fPrevDistance = desc.mfNear;
+        for(uint32_t iCascade = 0; iCascade < desc.miNumCascades; iCascade++)
+        {
+            Render::ShadowCascade const& cascade = aCascades[iCascade];
+            Render::ShadowCascade const& movedCascade = aMovedCascades[iCascade];
+
+            // practical splits from the shadow near to the shadow far, between the uniform and the logarithmic ones
+            float fPct = (float)(iCascade + 1) / (float)desc.miNumCascades;
+            float fUniform = desc.mfNear + (desc.mfFar - desc.mfNear) * fPct;
+            float fLogarithmic = desc.mfNear * powf(desc.mfFar / desc.mfNear, fPct);
+            if(fabsf(cascade.mfNearDistance - fPrevDistance) > kfEpsilon ||
+                cascade.mfFarDistance > fUniform + kfEpsilon ||
+                cascade.mfFarDistance < fLogarithmic - kfEpsilon ||
+                (iCascade + 1 == desc.miNumCascades && fabsf(cascade.mfFarDistance - desc.mfFar) > kfEpsilon))
+            {
+                result.fail("test %d cascade %d splits", iTest, iCascade);
+            }
+            fPrevDistance = cascade.mfFarDistance;
+
+            float aafCorners[8][3];
+            getSliceCorners(aafCorners, camera, cascade.mfNearDistance, cascade.mfFarDistance);
+            for(uint32_t iCorner = 0; iCorner < 8; iCorner++)
+            {
+                float const* pfCorner = aafCorners[iCorner];
+                float afDiff[3] =
+                {
+                    pfCorner[0] - cascade.mafSphere[0],
+                    pfCorner[1] - cascade.mafSphere[1],
+                    pfCorner[2] - cascade.mafSphere[2],
+                };
+                if(sqrtf(afDiff[0] * afDiff[0] + afDiff[1] * afDiff[1] + afDiff[2] * afDiff[2]) > cascade.mafSphere[3] * (1.0f + kfEpsilon))
+                {
+                    result.fail("test %d cascade %d corner outside of the bounding sphere", iTest, iCascade);
+                }
+
+                float afClipSpace[4];
+                project(afClipSpace, cascade, pfCorner);
+                if(!isInShadowMap(afClipSpace))
+                {
+                    result.fail("test %d cascade %d corner outside of the shadow map", iTest, iCascade);
+                }
+
+                if(!Render::isBoxInShadowCascade(cascade, pfCorner, pfCorner))
+                {
+                    result.fail("test %d cascade %d corner culled", iTest, iCascade);
+                }
+            }
+
+            if(movedCascade.mfSize != cascade.mfSize)
+            {
+                result.fail("test %d cascade %d size changes with the view direction", iTest, iCascade);
+            }
+
+            // a world position lands on the same spot of a texel in both shadow maps
+            float afPosition[3] = {3.0f, 0.5f, -20.0f};
+            float afClipSpace[4];
+            float afMovedClipSpace[4];
+            project(afClipSpace, cascade, afPosition);
+            project(afMovedClipSpace, movedCascade, afPosition);
+            for(uint32_t i = 0; i < 2; i++)
+            {
+                float fTexels = (afMovedClipSpace[i] - afClipSpace[i]) * 0.5f * (float)kiShadowMapSize;
+                if(fabsf(fTexels - roundf(fTexels)) > 0.01f)
+                {
+                    result.fail("test %d cascade %d moves by part of a texel", iTest, iCascade);
+                }
+            }
+
+            // boxes along the light axes from the cascade's center, by half sizes past its edge
+            float fHalfSize = cascade.mfSize * 0.5f;
+            struct Box
+            {
+                float       mafOffset[3];       // right, up, towards the light
+                bool        mbVisible;
+            };
+            Box const aBoxes[] =
+            {
+                {{0.0f, 0.0f, 0.0f}, true},
+                {{fHalfSize * 0.9f, -fHalfSize * 0.9f, 0.0f}, true},
+                {{fHalfSize + 2.0f, 0.0f, 0.0f}, false},
+                {{0.0f, -fHalfSize - 2.0f, 0.0f}, false},
+                {{0.0f, 0.0f, fHalfSize + desc.mfCasterDistance * 0.5f}, true},
+                {{0.0f, 0.0f, fHalfSize + desc.mfCasterDistance + 2.0f}, false},
+                {{0.0f, 0.0f, -fHalfSize - 2.0f}, false},
+            };
+            for(Box const& box : aBoxes)
+            {
+                float afMin[3];
+                float afMax[3];
+                for(uint32_t i = 0; i < 3; i++)
+                {
+                    float fCenter = cascade.mafCenter[i];
+                    for(uint32_t iAxis = 0; iAxis < 3; iAxis++)
+                    {
+                        fCenter += cascade.mafLightAxes[iAxis][i] * box.mafOffset[iAxis];
+                    }
+                    afMin[i] = fCenter - 0.5f;
+                    afMax[i] = fCenter + 0.5f;
+                }
+                if(Render::isBoxInShadowCascade(cascade, afMin, afMax) != box.mbVisible)
+                {
+                    result.fail("test %d cascade %d %s", iTest, iCascade, box.mbVisible ? "box in the cascade culled" : "box away from the cascade kept");
+                }
+            }
+
+            // every extent with a corner or its center in the shadow map is kept, the skipped ones never are
+            std::vector<uint32_t> aiMeshes(iNumMeshes);
+            uint32_t iNumVisible = Render::cullShadowCascade(aiMeshes.data(), cascade, afExtents.data(), iNumMeshes, abSkip.data());
+            std::vector<bool> abVisible(iNumMeshes, false);
+            for(uint32_t i = 0; i < iNumVisible; i++)
+            {
+                abVisible[aiMeshes[i]] = true;
+            }
+            for(uint32_t iMesh = 0; iMesh < iNumMeshes; iMesh++)
+            {
+                if(abSkip[iMesh])
+                {
+                    if(abVisible[iMesh])
+                    {
+                        result.fail("test %d cascade %d skipped mesh kept", iTest, iCascade);
+                    }
+                    continue;
+                }
+
+                float const* pfMin = afExtents.data() + iMesh * 8;
+                float const* pfMax = pfMin + 4;
+                bool bInside = false;
+                for(uint32_t iPoint = 0; iPoint < 9; iPoint++)
+                {
+                    float afPoint[3];
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        afPoint[i] = (iPoint == 8) ? (pfMin[i] + pfMax[i]) * 0.5f : (((iPoint >> i) & 1) ? pfMax[i] : pfMin[i]);
+                    }
+                    float afPointClipSpace[4];
+                    project(afPointClipSpace, cascade, afPoint);
+                    bInside = bInside || isInShadowMap(afPointClipSpace);
+                }
+
+                if(bInside && !abVisible[iMesh])
+                {
+                    result.fail("test %d cascade %d mesh in the shadow map culled", iTest, iCascade);
+                }
+            }
+
+            DEBUG_PRINTF("shadow cascades: test %d cascade %d %.2f to %.2f, %.2f wide, %.4f texels, %d of %d meshes\n",
+                iTest,
+                iCascade,
+                cascade.mfNearDistance,
+                cascade.mfFarDistance,
+                cascade.mfSize,
+                cascade.mfTexelSize,
+                iNumVisible,
+                iNumMeshes);
+        }
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("shadow cascades");
+    checkShadowCascades(result);
+    return result.finish();
+}
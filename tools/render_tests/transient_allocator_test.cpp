@@ -0,0 +1,123 @@
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <render/transient_allocator.h>
+
+#include "render_test.h"
+
+/*
+** slots of the transient allocator for made up lifetimes. outputs of the same description share when one is last used
+** before the other's first write, not when they overlap or the last use is the first write, persistent outputs never
+** share and the aliased memory is one resource per slot
+*/
+static void checkTransientAllocator(CTestResult& result)
+{
+    uint64_t const kiTextureBytes = 1024 * 1024 * 8;
+    uint64_t const kiBufferBytes = 1 << 20;
+    std::string const kTexture = "rgba16float 1024 x 1024";
+    std::string const kBuffer = "buffer 1048576";
+
+    struct Lifetime
+    {
+        char const*         mszName;
+        bool                mbTexture;
+        uint32_t            miFirstUse;
+        uint32_t            miLastUse;
+        bool                mbPersistent;
+    };
+    Lifetime const aLifetimes[] =
+    {
+        {"A", true, 0, 2, false},
+        {"B", true, 3, 5, false},           // after A
+        {"C", true, 5, 7, false},           // first write on B's last use
+        {"D", true, 1, 4, false},           // over A and B
+        {"E", false, 8, 9, false},          // after all of them, different description
+        {"P", true, 10, 11, true},
+        {"Q", true, 12, 13, false},         // after the persistent P, in A's slot
+        {"R", true, 14, 15, true},          // free slots of its description, still on its own
+    };
+
+    Render::CTransientAllocator allocator;
+    for(Lifetime const& lifetime : aLifetimes)
+    {
+        Render::CTransientAllocator::Resource resource;
+        resource.mName = lifetime.mszName;
+        resource.mDescription = lifetime.mbTexture ? kTexture : kBuffer;
+        resource.miNumBytes = lifetime.mbTexture ? kiTextureBytes : kiBufferBytes;
+        resource.miFirstUse = lifetime.miFirstUse;
+        resource.miLastUse = lifetime.miLastUse;
+        resource.mbPersistent = lifetime.mbPersistent;
+        allocator.addResource(resource);
+    }
+    allocator.allocate();
+
+    auto share = [&allocator](char const* szLeft, char const* szRight)
+    {
+        return allocator.getSlot(szLeft) == allocator.getSlot(szRight);
+    };
+    if(!share("A", "B"))
+    {
+        result.fail("disjoint lifetimes don't share");
+    }
+    if(share("B", "C"))
+    {
+        result.fail("last use on the first write shares");
+    }
+    if(share("A", "D") || share("B", "D"))
+    {
+        result.fail("overlapping lifetimes share");
+    }
+    if(share("C", "E") || share("A", "E"))
+    {
+        result.fail("different descriptions share");
+    }
+    if(share("P", "A") || share("P", "Q") || share("R", "A") || share("R", "D") || share("R", "Q"))
+    {
+        result.fail("a persistent output shares");
+    }
+    if(!share("Q", "A"))
+    {
+        result.fail("a slot free again isn't reused");
+    }
+    if(allocator.getSlot("X") != -1)
+    {
+        result.fail("slot of an output that wasn't added");
+    }
+
+    // whatever the order, no two lifetimes in a slot overlap
+    std::vector<Render::CTransientAllocator::Resource> const& aResources = allocator.getResources();
+    for(uint32_t i = 0; i < (uint32_t)aResources.size(); i++)
+    {
+        for(uint32_t j = i + 1; j < (uint32_t)aResources.size(); j++)
+        {
+            if(aResources[i].miSlot == aResources[j].miSlot &&
+               aResources[i].miFirstUse <= aResources[j].miLastUse &&
+               aResources[j].miFirstUse <= aResources[i].miLastUse)
+            {
+                result.fail("%s and %s overlap in slot %d", aResources[i].mName.c_str(), aResources[j].mName.c_str(), aResources[i].miSlot);
+            }
+        }
+    }
+
+    // {A B Q} {D C} {E} {P} {R}
+    if(allocator.getSlots().size() != 5 ||
+       allocator.getNumAliasedBytes() != kiTextureBytes * 4 + kiBufferBytes ||
+       allocator.getNumUnaliasedBytes() != kiTextureBytes * 7 + kiBufferBytes)
+    {
+        result.fail("%d slots, %llu bytes aliased of %llu",
+            (uint32_t)allocator.getSlots().size(),
+            (unsigned long long)allocator.getNumAliasedBytes(),
+            (unsigned long long)allocator.getNumUnaliasedBytes());
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("transient allocator");
+    checkTransientAllocator(result);
+    return result.finish();
+}
@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include <render/upload_ring.h>
+
+#include "render_test.h"
+
+/*
+** the upload ring's packing of made up buffer updates. a write continuing the last region of its buffer extends it,
+** one to the same range as the latest region of its buffer replaces its bytes and anything else adds a region in
+** order. the copies stay aligned and every frame packs from the start of the staging data again, in the memory of
+** the frames before
+*/
+static void checkUploadRing(CTestResult& result)
+{
+    std::vector<uint32_t> aiData(64);
+    for(uint32_t i = 0; i < (uint32_t)aiData.size(); i++)
+    {
+        aiData[i] = 0x1000 + i;
+    }
+
+    auto checkRegion = [&](Render::CUploadRing const& uploadRing, uint32_t iRegion, Render::CUploadRing::CopyRegion const& expected, uint32_t const* piExpectedData)
+    {
+        std::vector<Render::CUploadRing::CopyRegion> const& aRegions = uploadRing.getCopyRegions();
+        if(iRegion >= (uint32_t)aRegions.size())
+        {
+            result.fail("region %d missing", iRegion);
+            return;
+        }
+
+        Render::CUploadRing::CopyRegion const& region = aRegions[iRegion];
+        if(region.miDestination != expected.miDestination || region.miDestOffset != expected.miDestOffset ||
+           region.miStagingOffset != expected.miStagingOffset || region.miSize != expected.miSize)
+        {
+            result.fail("region %d is buffer %d offset %llu from %llu, %llu bytes",
+                iRegion,
+                region.miDestination,
+                (unsigned long long)region.miDestOffset,
+                (unsigned long long)region.miStagingOffset,
+                (unsigned long long)region.miSize);
+            return;
+        }
+
+        if(region.miStagingOffset + region.miSize > uploadRing.getStagingSize() ||
+           memcmp(uploadRing.getStagingData() + region.miStagingOffset, piExpectedData, region.miSize) != 0)
+        {
+            result.fail("region %d staging data", iRegion);
+        }
+    };
+
+    Render::CUploadRing uploadRing;
+    uint8_t const* pacStaging = nullptr;
+    for(uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        uploadRing.beginFrame();
+        if(uploadRing.getStagingSize() != 0 || uploadRing.getCopyRegions().size() != 0 || uploadRing.getFrameStats().miNumWrites != 0)
+        {
+            result.fail("frame %d doesn't start empty", iFrame);
+        }
+
+        // buffer 0 [0, 16) and [16, 24) merge
+        uploadRing.write(0, 0, &aiData[0], 16);
+        uploadRing.write(0, 16, &aiData[4], 8);
+
+        // buffer 1 [64, 80) twice, the second one replaces the first
+        uploadRing.write(1, 64, &aiData[16], 16);
+        uploadRing.write(1, 64, &aiData[20], 16);
+
+        // buffer 0 continues at 24 but its region isn't the last one in the staging data
+        uploadRing.write(0, 24, &aiData[6], 4);
+
+        // overlaps buffer 0's latest region without the same range, a region of its own after it
+        uploadRing.write(0, 20, &aiData[32], 8);
+
+        // nothing to copy
+        uploadRing.write(2, 0, &aiData[0], 0);
+
+        checkRegion(uploadRing, 0, {0, 0, 0, 24}, &aiData[0]);
+        checkRegion(uploadRing, 1, {1, 64, 24, 16}, &aiData[20]);
+        checkRegion(uploadRing, 2, {0, 24, 40, 4}, &aiData[6]);
+        checkRegion(uploadRing, 3, {0, 20, 44, 8}, &aiData[32]);
+        if(uploadRing.getCopyRegions().size() != 4)
+        {
+            result.fail("%d regions", (uint32_t)uploadRing.getCopyRegions().size());
+        }
+
+        for(Render::CUploadRing::CopyRegion const& region : uploadRing.getCopyRegions())
+        {
+            if(region.miDestOffset % UPLOAD_RING_ALIGNMENT != 0 || region.miStagingOffset % UPLOAD_RING_ALIGNMENT != 0 ||
+               region.miSize % UPLOAD_RING_ALIGNMENT != 0)
+            {
+                result.fail("copy not aligned");
+            }
+        }
+
+        Render::CUploadRing::FrameStats stats = uploadRing.getFrameStats();
+        if(stats.miNumWrites != 7 || stats.miNumCopies != 4 || stats.miNumWrittenBytes != 68 || stats.miNumUploadedBytes != 52 ||
+           uploadRing.getStagingSize() != 52)
+        {
+            result.fail("stats %d writes, %d copies, %llu bytes written, %llu uploaded",
+                stats.miNumWrites,
+                stats.miNumCopies,
+                (unsigned long long)stats.miNumWrittenBytes,
+                (unsigned long long)stats.miNumUploadedBytes);
+        }
+
+        // the same frame again packs into the memory of the last one
+        if(iFrame > 0 && uploadRing.getStagingData() != pacStaging)
+        {
+            result.fail("frame %d staging data moved", iFrame);
+        }
+        pacStaging = uploadRing.getStagingData();
+    }
+}
+
+/*
+**
+*/
+int main()
+{
+    CTestResult result("upload ring");
+    checkUploadRing(result);
+    return result.finish();
+}
@@ -0,0 +1,426 @@
+#include "bc7_encoder.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace BC7
+{
+    static uint32_t const saiWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    struct BitWriter
+    {
+        uint64_t        maiBits[2] = {0, 0};
+        uint32_t        miPosition = 0;
+
+        void write(uint32_t iValue, uint32_t iNumBits)
+        {
+            for(uint32_t i = 0; i < iNumBits; i++)
+            {
+                uint64_t iBit = (iValue >> i) & 1;
+                maiBits[miPosition >> 6] |= (iBit << (miPosition & 63));
+                ++miPosition;
+            }
+        }
+    };
+
+    struct BitReader
+    {
+        uint64_t        maiBits[2] = {0, 0};
+        uint32_t        miPosition = 0;
+
+        uint32_t read(uint32_t iNumBits)
+        {
+            uint32_t iRet = 0;
+            for(uint32_t i = 0; i < iNumBits; i++)
+            {
+                uint32_t iBit = (uint32_t)((maiBits[miPosition >> 6] >> (miPosition & 63)) & 1);
+                iRet |= (iBit << i);
+                ++miPosition;
+            }
+
+            return iRet;
+        }
+    };
+
+    /*
+    **
+    */
+    static inline uint32_t interpolate(uint32_t iEndpoint0, uint32_t iEndpoint1, uint32_t iWeight)
+    {
+        return ((64 - iWeight) * iEndpoint0 + iWeight * iEndpoint1 + 32) >> 6;
+    }
+
+    /*
+    ** 7 bit endpoint plus p-bit, pick the p-bit with the least error, opaque blocks keep p-bit 1 so alpha stays 255
+    */
+    static void quantizeEndpoint(
+        uint32_t* aiColor7,
+        uint32_t& iPBit,
+        float const* afEndpoint,
+        bool bOpaque)
+    {
+        float fBestError = FLT_MAX;
+        for(uint32_t iP = (bOpaque ? 1 : 0); iP < 2; iP++)
+        {
+            uint32_t aiCandidate[4];
+            float fError = 0.0f;
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                float fValue = std::clamp(afEndpoint[i], 0.0f, 255.0f);
+                int32_t iColor7 = std::clamp((int32_t)std::lround((fValue - float(iP)) * 0.5f), 0, 127);
+                aiCandidate[i] = (uint32_t)iColor7;
+                float fDiff = float((iColor7 << 1) | iP) - fValue;
+                fError += fDiff * fDiff;
+            }
+
+            if(fError < fBestError)
+            {
+                fBestError = fError;
+                iPBit = iP;
+                memcpy(aiColor7, aiCandidate, sizeof(aiCandidate));
+            }
+        }
+    }
+
+    /*
+    ** choose the closest palette entry for every texel, returns total squared error
+    */
+    static uint32_t findIndices(
+        uint32_t* aiIndices,
+        uint8_t const* pacTexels,
+        uint32_t const* aiEndpoint0,
+        uint32_t const* aiEndpoint1)
+    {
+        uint32_t aaiPalette[16][4];
+        for(uint32_t i = 0; i < 16; i++)
+        {
+            for(uint32_t iChannel = 0; iChannel < 4; iChannel++)
+            {
+                aaiPalette[i][iChannel] = interpolate(aiEndpoint0[iChannel], aiEndpoint1[iChannel], saiWeights4[i]);
+            }
+        }
+
+        uint32_t iTotalError = 0;
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            uint8_t const* pTexel = pacTexels + iTexel * 4;
+            uint32_t iBestError = UINT32_MAX;
+            for(uint32_t i = 0; i < 16; i++)
+            {
+                uint32_t iError = 0;
+                for(uint32_t iChannel = 0; iChannel < 4; iChannel++)
+                {
+                    int32_t iDiff = (int32_t)aaiPalette[i][iChannel] - (int32_t)pTexel[iChannel];
+                    iError += (uint32_t)(iDiff * iDiff);
+                }
+
+                if(iError < iBestError)
+                {
+                    iBestError = iError;
+                    aiIndices[iTexel] = i;
+                }
+            }
+
+            iTotalError += iBestError;
+        }
+
+        return iTotalError;
+    }
+
+    /*
+    **
+    */
+    static uint32_t fitEndpoints(
+        uint32_t* aiColor0,
+        uint32_t* aiColor1,
+        uint32_t& iP0,
+        uint32_t& iP1,
+        uint32_t* aiIndices,
+        uint8_t const* pacTexels,
+        float const* afEndpoint0,
+        float const* afEndpoint1,
+        bool bOpaque)
+    {
+        quantizeEndpoint(aiColor0, iP0, afEndpoint0, bOpaque);
+        quantizeEndpoint(aiColor1, iP1, afEndpoint1, bOpaque);
+
+        uint32_t aiEndpoint0[4], aiEndpoint1[4];
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            aiEndpoint0[i] = (aiColor0[i] << 1) | iP0;
+            aiEndpoint1[i] = (aiColor1[i] << 1) | iP1;
+        }
+
+        return findIndices(aiIndices, pacTexels, aiEndpoint0, aiEndpoint1);
+    }
+
+    /*
+    **
+    */
+    void encodeBlock(
+        uint8_t* pDest,
+        uint8_t const* pacTexels)
+    {
+        bool bOpaque = true;
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            bOpaque = bOpaque && (pacTexels[iTexel * 4 + 3] == 255);
+        }
+
+        // principal axis of the block's colors
+        float afMean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                afMean[i] += float(pacTexels[iTexel * 4 + i]);
+            }
+        }
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            afMean[i] /= 16.0f;
+        }
+
+        float aafCovariance[4][4] = {};
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            float afDiff[4];
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                afDiff[i] = float(pacTexels[iTexel * 4 + i]) - afMean[i];
+            }
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    aafCovariance[i][j] += afDiff[i] * afDiff[j];
+                }
+            }
+        }
+
+        float afAxis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        for(uint32_t iIteration = 0; iIteration < 8; iIteration++)
+        {
+            float afNewAxis[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    afNewAxis[i] += aafCovariance[i][j] * afAxis[j];
+                }
+            }
+
+            float fLength = sqrtf(afNewAxis[0] * afNewAxis[0] + afNewAxis[1] * afNewAxis[1] + afNewAxis[2] * afNewAxis[2] + afNewAxis[3] * afNewAxis[3]);
+            if(fLength < 1.0e-6f)
+            {
+                break;
+            }
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                afAxis[i] = afNewAxis[i] / fLength;
+            }
+        }
+
+        float fMinT = FLT_MAX, fMaxT = -FLT_MAX;
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            float fT = 0.0f;
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                fT += (float(pacTexels[iTexel * 4 + i]) - afMean[i]) * afAxis[i];
+            }
+            fMinT = std::min(fMinT, fT);
+            fMaxT = std::max(fMaxT, fT);
+        }
+
+        float afEndpoint0[4], afEndpoint1[4];
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            afEndpoint0[i] = afMean[i] + afAxis[i] * fMinT;
+            afEndpoint1[i] = afMean[i] + afAxis[i] * fMaxT;
+        }
+
+        uint32_t aiColor0[4], aiColor1[4], iP0 = 0, iP1 = 0;
+        uint32_t aiIndices[16];
+        uint32_t iError = fitEndpoints(aiColor0, aiColor1, iP0, iP1, aiIndices, pacTexels, afEndpoint0, afEndpoint1, bOpaque);
+
+        // least squares refit of the endpoints with the chosen indices
+        if(iError > 0)
+        {
+            float fAA = 0.0f, fAB = 0.0f, fBB = 0.0f;
+            float afAX[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            float afBX[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+            {
+                float fB = float(saiWeights4[aiIndices[iTexel]]) / 64.0f;
+                float fA = 1.0f - fB;
+                fAA += fA * fA;
+                fAB += fA * fB;
+                fBB += fB * fB;
+                for(uint32_t i = 0; i < 4; i++)
+                {
+                    afAX[i] += fA * float(pacTexels[iTexel * 4 + i]);
+                    afBX[i] += fB * float(pacTexels[iTexel * 4 + i]);
+                }
+            }
+
+            float fDeterminant = fAA * fBB - fAB * fAB;
+            if(fabsf(fDeterminant) > 1.0e-6f)
+            {
+                float afRefit0[4], afRefit1[4];
+                for(uint32_t i = 0; i < 4; i++)
+                {
+                    afRefit0[i] = (fBB * afAX[i] - fAB * afBX[i]) / fDeterminant;
+                    afRefit1[i] = (fAA * afBX[i] - fAB * afAX[i]) / fDeterminant;
+                }
+
+                uint32_t aiRefitColor0[4], aiRefitColor1[4], iRefitP0 = 0, iRefitP1 = 0;
+                uint32_t aiRefitIndices[16];
+                uint32_t iRefitError = fitEndpoints(aiRefitColor0, aiRefitColor1, iRefitP0, iRefitP1, aiRefitIndices, pacTexels, afRefit0, afRefit1, bOpaque);
+                if(iRefitError < iError)
+                {
+                    memcpy(aiColor0, aiRefitColor0, sizeof(aiColor0));
+                    memcpy(aiColor1, aiRefitColor1, sizeof(aiColor1));
+                    memcpy(aiIndices, aiRefitIndices, sizeof(aiIndices));
+                    iP0 = iRefitP0;
+                    iP1 = iRefitP1;
+                }
+            }
+        }
+
+        // anchor texel index has an implied 0 high bit, swap the endpoints if needed
+        if(aiIndices[0] & 8)
+        {
+            std::swap(aiColor0, aiColor1);
+            std::swap(iP0, iP1);
+            for(uint32_t i = 0; i < 16; i++)
+            {
+                aiIndices[i] = 15 - aiIndices[i];
+            }
+        }
+
+        BitWriter writer;
+        writer.write(1 << 6, 7);
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            writer.write(aiColor0[i], 7);
+            writer.write(aiColor1[i], 7);
+        }
+        writer.write(iP0, 1);
+        writer.write(iP1, 1);
+        writer.write(aiIndices[0], 3);
+        for(uint32_t i = 1; i < 16; i++)
+        {
+            writer.write(aiIndices[i], 4);
+        }
+
+        memcpy(pDest, writer.maiBits, 16);
+    }
+
+    /*
+    **
+    */
+    void decodeBlock(
+        uint8_t* pacTexels,
+        uint8_t const* pBlock)
+    {
+        BitReader reader;
+        memcpy(reader.maiBits, pBlock, 16);
+
+        if(reader.read(7) != (1 << 6))
+        {
+            // only mode 6 is written by encodeBlock
+            for(uint32_t i = 0; i < 16; i++)
+            {
+                pacTexels[i * 4] = 255; pacTexels[i * 4 + 1] = 0; pacTexels[i * 4 + 2] = 255; pacTexels[i * 4 + 3] = 255;
+            }
+            return;
+        }
+
+        uint32_t aiEndpoint0[4], aiEndpoint1[4];
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            aiEndpoint0[i] = reader.read(7);
+            aiEndpoint1[i] = reader.read(7);
+        }
+        uint32_t iP0 = reader.read(1);
+        uint32_t iP1 = reader.read(1);
+        for(uint32_t i = 0; i < 4; i++)
+        {
+            aiEndpoint0[i] = (aiEndpoint0[i] << 1) | iP0;
+            aiEndpoint1[i] = (aiEndpoint1[i] << 1) | iP1;
+        }
+
+        for(uint32_t iTexel = 0; iTexel < 16; iTexel++)
+        {
+            uint32_t iIndex = reader.read((iTexel == 0) ? 3 : 4);
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                pacTexels[iTexel * 4 + i] = (uint8_t)interpolate(aiEndpoint0[i], aiEndpoint1[i], saiWeights4[iIndex]);
+            }
+        }
+    }
+
+    /*
+    **
+    */
+    void encodeImage(
+        uint8_t* pDest,
+        uint8_t const* pacImage,
+        uint32_t iWidth,
+        uint32_t iHeight,
+        uint32_t iImageRowPitch)
+    {
+        uint32_t iNumBlocksX = iWidth / 4;
+        uint32_t iNumBlocksY = iHeight / 4;
+        for(uint32_t iBlockY = 0; iBlockY < iNumBlocksY; iBlockY++)
+        {
+            for(uint32_t iBlockX = 0; iBlockX < iNumBlocksX; iBlockX++)
+            {
+                uint8_t aacTexels[16 * 4];
+                for(uint32_t iY = 0; iY < 4; iY++)
+                {
+                    memcpy(
+                        aacTexels + iY * 16,
+                        pacImage + (size_t)(iBlockY * 4 + iY) * iImageRowPitch + (size_t)iBlockX * 16,
+                        16);
+                }
+
+                encodeBlock(pDest + ((size_t)iBlockY * iNumBlocksX + iBlockX) * 16, aacTexels);
+            }
+        }
+    }
+
+    /*
+    **
+    */
+    void decodeImage(
+        uint8_t* pacImage,
+        uint8_t const* pBlocks,
+        uint32_t iWidth,
+        uint32_t iHeight)
+    {
+        uint32_t iNumBlocksX = iWidth / 4;
+        uint32_t iNumBlocksY = iHeight / 4;
+        for(uint32_t iBlockY = 0; iBlockY < iNumBlocksY; iBlockY++)
+        {
+            for(uint32_t iBlockX = 0; iBlockX < iNumBlocksX; iBlockX++)
+            {
+                uint8_t aacTexels[16 * 4];
+                decodeBlock(aacTexels, pBlocks + ((size_t)iBlockY * iNumBlocksX + iBlockX) * 16);
+                for(uint32_t iY = 0; iY < 4; iY++)
+                {
+                    memcpy(
+                        pacImage + ((size_t)(iBlockY * 4 + iY) * iWidth + (size_t)iBlockX * 4) * 4,
+                        aacTexels + iY * 16,
+                        16);
+                }
+            }
+        }
+    }
+
+}   // BC7
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+** BC7 encoding with mode 6 only (one subset, 7.7.7.7 endpoints with a p-bit each, 4 bit indices).
+** Covers color and alpha in one block, which is all the diffuse atlas needs.
+*/
+namespace BC7
+{
+    // 4x4 RGBA8 texels, row major, to one 16 byte block
+    void encodeBlock(
+        uint8_t* pDest,
+        uint8_t const* pacTexels);
+
+    void decodeBlock(
+        uint8_t* pacTexels,
+        uint8_t const* pBlock);
+
+    // iWidth and iHeight must be multiples of 4, blocks are written row major
+    void encodeImage(
+        uint8_t* pDest,
+        uint8_t const* pacImage,
+        uint32_t iWidth,
+        uint32_t iHeight,
+        uint32_t iImageRowPitch);
+
+    void decodeImage(
+        uint8_t* pacImage,
+        uint8_t const* pBlocks,
+        uint32_t iWidth,
+        uint32_t iHeight);
+
+}   // BC7
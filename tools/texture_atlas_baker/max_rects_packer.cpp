@@ -0,0 +1,205 @@
+#include "max_rects_packer.h"
+
+#include <algorithm>
+#include <climits>
+
+/*
+**
+*/
+void CMaxRectsPacker::init(int32_t iWidth, int32_t iHeight)
+{
+    miWidth = iWidth;
+    miHeight = iHeight;
+    miUsedArea = 0;
+
+    maUsedRects.clear();
+    maFreeRects.clear();
+
+    Rect rect;
+    rect.miWidth = iWidth;
+    rect.miHeight = iHeight;
+    maFreeRects.push_back(rect);
+}
+
+/*
+**
+*/
+bool CMaxRectsPacker::insert(
+    Rect& ret,
+    int32_t iWidth,
+    int32_t iHeight)
+{
+    // bottom left rule, lowest top edge then leftmost, keeps the used height (rows stored and uploaded) small
+    int32_t iBestTop = INT32_MAX;
+    int32_t iBestX = INT32_MAX;
+    int32_t iBestIndex = -1;
+    for(uint32_t i = 0; i < (uint32_t)maFreeRects.size(); i++)
+    {
+        Rect const& freeRect = maFreeRects[i];
+        if(freeRect.miWidth < iWidth || freeRect.miHeight < iHeight)
+        {
+            continue;
+        }
+
+        int32_t iTop = freeRect.miY + iHeight;
+        if(iTop < iBestTop || (iTop == iBestTop && freeRect.miX < iBestX))
+        {
+            iBestTop = iTop;
+            iBestX = freeRect.miX;
+            iBestIndex = (int32_t)i;
+        }
+    }
+
+    if(iBestIndex < 0)
+    {
+        return false;
+    }
+
+    Rect usedRect;
+    usedRect.miX = maFreeRects[iBestIndex].miX;
+    usedRect.miY = maFreeRects[iBestIndex].miY;
+    usedRect.miWidth = iWidth;
+    usedRect.miHeight = iHeight;
+
+    // split every free rectangle that overlaps the placed one
+    std::vector<Rect> aNewFreeRects;
+    for(uint32_t i = 0; i < (uint32_t)maFreeRects.size();)
+    {
+        if(splitFreeRect(aNewFreeRects, maFreeRects[i], usedRect))
+        {
+            maFreeRects[i] = maFreeRects.back();
+            maFreeRects.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    maFreeRects.insert(maFreeRects.end(), aNewFreeRects.begin(), aNewFreeRects.end());
+    pruneFreeRects();
+
+    maUsedRects.push_back(usedRect);
+    miUsedArea += (uint64_t)iWidth * (uint64_t)iHeight;
+
+    ret = usedRect;
+
+    return true;
+}
+
+/*
+**
+*/
+int32_t CMaxRectsPacker::getUsedHeight() const
+{
+    int32_t iUsedHeight = 0;
+    for(auto const& rect : maUsedRects)
+    {
+        iUsedHeight = std::max(iUsedHeight, rect.miY + rect.miHeight);
+    }
+
+    return iUsedHeight;
+}
+
+/*
+**
+*/
+float CMaxRectsPacker::getOccupancy() const
+{
+    int32_t iUsedHeight = getUsedHeight();
+    if(iUsedHeight <= 0 || miWidth <= 0)
+    {
+        return 0.0f;
+    }
+
+    return float(double(miUsedArea) / (double(miWidth) * double(iUsedHeight)));
+}
+
+/*
+**
+*/
+bool CMaxRectsPacker::splitFreeRect(
+    std::vector<Rect>& aNewFreeRects,
+    Rect const& freeRect,
+    Rect const& usedRect)
+{
+    if(usedRect.miX >= freeRect.miX + freeRect.miWidth || usedRect.miX + usedRect.miWidth <= freeRect.miX ||
+       usedRect.miY >= freeRect.miY + freeRect.miHeight || usedRect.miY + usedRect.miHeight <= freeRect.miY)
+    {
+        return false;
+    }
+
+    // top and bottom remainders
+    if(usedRect.miX < freeRect.miX + freeRect.miWidth && usedRect.miX + usedRect.miWidth > freeRect.miX)
+    {
+        if(usedRect.miY > freeRect.miY && usedRect.miY < freeRect.miY + freeRect.miHeight)
+        {
+            Rect newRect = freeRect;
+            newRect.miHeight = usedRect.miY - newRect.miY;
+            aNewFreeRects.push_back(newRect);
+        }
+
+        if(usedRect.miY + usedRect.miHeight < freeRect.miY + freeRect.miHeight)
+        {
+            Rect newRect = freeRect;
+            newRect.miY = usedRect.miY + usedRect.miHeight;
+            newRect.miHeight = freeRect.miY + freeRect.miHeight - (usedRect.miY + usedRect.miHeight);
+            aNewFreeRects.push_back(newRect);
+        }
+    }
+
+    // left and right remainders
+    if(usedRect.miY < freeRect.miY + freeRect.miHeight && usedRect.miY + usedRect.miHeight > freeRect.miY)
+    {
+        if(usedRect.miX > freeRect.miX && usedRect.miX < freeRect.miX + freeRect.miWidth)
+        {
+            Rect newRect = freeRect;
+            newRect.miWidth = usedRect.miX - newRect.miX;
+            aNewFreeRects.push_back(newRect);
+        }
+
+        if(usedRect.miX + usedRect.miWidth < freeRect.miX + freeRect.miWidth)
+        {
+            Rect newRect = freeRect;
+            newRect.miX = usedRect.miX + usedRect.miWidth;
+            newRect.miWidth = freeRect.miX + freeRect.miWidth - (usedRect.miX + usedRect.miWidth);
+            aNewFreeRects.push_back(newRect);
+        }
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+void CMaxRectsPacker::pruneFreeRects()
+{
+    auto contains = [](Rect const& a, Rect const& b)
+    {
+        return b.miX >= a.miX && b.miY >= a.miY &&
+            b.miX + b.miWidth <= a.miX + a.miWidth &&
+            b.miY + b.miHeight <= a.miY + a.miHeight;
+    };
+
+    for(uint32_t i = 0; i < (uint32_t)maFreeRects.size(); i++)
+    {
+        for(uint32_t j = i + 1; j < (uint32_t)maFreeRects.size();)
+        {
+            if(contains(maFreeRects[j], maFreeRects[i]))
+            {
+                maFreeRects.erase(maFreeRects.begin() + i);
+                --i;
+                break;
+            }
+
+            if(contains(maFreeRects[i], maFreeRects[j]))
+            {
+                maFreeRects.erase(maFreeRects.begin() + j);
+            }
+            else
+            {
+                ++j;
+            }
+        }
+    }
+}
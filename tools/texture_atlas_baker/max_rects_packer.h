@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+** max rects bin packer, bottom left placement, no rotation since the shaders don't handle rotated atlas entries
+*/
+class CMaxRectsPacker
+{
+public:
+    struct Rect
+    {
+        int32_t         miX = 0;
+        int32_t         miY = 0;
+        int32_t         miWidth = 0;
+        int32_t         miHeight = 0;
+    };
+
+public:
+    CMaxRectsPacker() = default;
+    virtual ~CMaxRectsPacker() = default;
+
+    void init(int32_t iWidth, int32_t iHeight);
+
+    bool insert(
+        Rect& ret,
+        int32_t iWidth,
+        int32_t iHeight);
+
+    // bottom of the lowest placed rectangle, only these rows need to be stored and uploaded
+    int32_t getUsedHeight() const;
+
+    // used area over width * used height
+    float getOccupancy() const;
+
+protected:
+    bool splitFreeRect(
+        std::vector<Rect>& aNewFreeRects,
+        Rect const& freeRect,
+        Rect const& usedRect);
+
+    void pruneFreeRects();
+
+protected:
+    int32_t                 miWidth = 0;
+    int32_t                 miHeight = 0;
+    uint64_t                miUsedArea = 0;
+
+    std::vector<Rect>       maFreeRects;
+    std::vector<Rect>       maUsedRects;
+};
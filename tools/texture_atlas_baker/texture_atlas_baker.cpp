@@ -0,0 +1,646 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+#include <utils/LogPrint.h>
+#include <render/texture_atlas_file.h>
+
+#include "max_rects_packer.h"
+#include "bc7_encoder.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image/stb_image.h>
+
+struct SourceImage
+{
+    std::string         mFilePath;
+    uint32_t            miSection = 0;
+    uint32_t            miEntry = 0;
+    int32_t             miWidth = 0;
+    int32_t             miHeight = 0;
+    int32_t             miPackedWidth = 0;
+    int32_t             miPackedHeight = 0;
+    stbi_uc*            mpImageData = nullptr;
+};
+
+struct MipLevel
+{
+    uint32_t                miWidth = 0;
+    uint32_t                miHeight = 0;
+    std::vector<uint8_t>    macData;
+};
+
+bool readDiffuseTextureNames(
+    std::vector<std::string>& aDiffuseTextureNames,
+    std::string const& textureNameFilePath);
+
+void buildMipChain(
+    std::vector<MipLevel>& aMipLevels,
+    uint32_t iNumMipLevels);
+
+void encodeBC7MipChain(
+    std::vector<MipLevel>& aBC7MipLevels,
+    std::vector<MipLevel> const& aMipLevels);
+
+bool writeAtlasFile(
+    std::string const& filePath,
+    Render::TextureAtlasFileHeader header,
+    std::vector<Render::TextureAtlasFileSection> const& aSections,
+    std::vector<Render::TextureAtlasFileEntry> const& aEntries,
+    std::vector<MipLevel> const& aMipLevels);
+
+int benchmarkBC7(
+    std::string const& imageFilePath,
+    uint32_t iNumIterations);
+
+/*
+**
+** texture_atlas_baker [options] <output atlas> <atlas size> <texture name list (.tex)> <texture directory> [<texture name list> <texture directory> ...]
+**
+** options:
+**    --mips <count>        mip levels to store, default 4
+**    --padding <texels>    edge clamped border around each texture, default 4
+**    --bc7                 also write <output atlas name>-bc7<extension> with BC7 blocks
+**    --benchmark <image> [iterations]    time BC7 encoding of one image and report throughput and PSNR
+**
+** list the texture name files in the order the app calls loadTexturesIntoAtlas with them
+*/
+int main(int argc, char* argv[])
+{
+    uint32_t iNumMipLevels = 4;
+    int32_t iPadding = 4;
+    bool bBC7 = false;
+    std::vector<std::string> aArgs;
+    for(int32_t iArg = 1; iArg < argc; iArg++)
+    {
+        std::string arg = argv[iArg];
+        if(arg == "--mips" && iArg + 1 < argc)
+        {
+            iNumMipLevels = (uint32_t)atoi(argv[++iArg]);
+        }
+        else if(arg == "--padding" && iArg + 1 < argc)
+        {
+            iPadding = atoi(argv[++iArg]);
+        }
+        else if(arg == "--bc7")
+        {
+            bBC7 = true;
+        }
+        else if(arg == "--benchmark" && iArg + 1 < argc)
+        {
+            std::string imageFilePath = argv[++iArg];
+            uint32_t iNumIterations = (iArg + 1 < argc) ? (uint32_t)atoi(argv[iArg + 1]) : 0;
+            return benchmarkBC7(imageFilePath, (iNumIterations > 0) ? iNumIterations : 5);
+        }
+        else
+        {
+            aArgs.push_back(arg);
+        }
+    }
+
+    if(aArgs.size() < 4 || aArgs.size() % 2 != 0 || iNumMipLevels < 1 || iNumMipLevels > TEXTURE_ATLAS_MAX_MIP_LEVELS || iPadding < 0)
+    {
+        DEBUG_PRINTF("usage: texture_atlas_baker [--mips <count>] [--padding <texels>] [--bc7] <output atlas> <atlas size> <texture name list> <texture directory> [<texture name list> <texture directory> ...]\n");
+        DEBUG_PRINTF("       texture_atlas_baker --benchmark <image> [iterations]\n");
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::string outputFilePath = aArgs[0];
+    int32_t iAtlasSize = atoi(aArgs[1].c_str());
+    assert(iAtlasSize > 0);
+
+    // every mip level of a packed rectangle has to start and end on a (block) texel boundary
+    int32_t iAlignment = (bBC7 ? 4 : 1) << (iNumMipLevels - 1);
+    if(iAtlasSize % iAlignment != 0)
+    {
+        DEBUG_PRINTF("!!! atlas size %d is not a multiple of %d needed for %d mip levels !!!\n", iAtlasSize, iAlignment, iNumMipLevels);
+        return 1;
+    }
+
+    // gather the diffuse textures of every texture name list, each list is a section in the cooked atlas
+    std::vector<Render::TextureAtlasFileSection> aSections;
+    std::vector<SourceImage> aSourceImages;
+    for(uint32_t iArg = 2; iArg < (uint32_t)aArgs.size(); iArg += 2)
+    {
+        std::string textureNameFilePath = aArgs[iArg];
+        std::string textureDirectory = aArgs[iArg + 1];
+        std::vector<std::string> aDiffuseTextureNames;
+        if(!readDiffuseTextureNames(aDiffuseTextureNames, textureNameFilePath))
+        {
+            DEBUG_PRINTF("!!! can\'t read \"%s\" !!!\n", textureNameFilePath.c_str());
+            return 1;
+        }
+
+        // section name is what gets passed to loadTexturesIntoAtlas
+        auto iter = textureNameFilePath.find_last_of("/\\");
+        std::string sectionName = (iter == std::string::npos) ? textureNameFilePath : textureNameFilePath.substr(iter + 1);
+        auto suffixIter = sectionName.rfind("-texture-names.tex");
+        if(suffixIter != std::string::npos)
+        {
+            sectionName = sectionName.substr(0, suffixIter);
+        }
+        assert(sectionName.length() < TEXTURE_ATLAS_SECTION_NAME_LENGTH);
+
+        Render::TextureAtlasFileSection section = {};
+        strncpy(section.macName, sectionName.c_str(), TEXTURE_ATLAS_SECTION_NAME_LENGTH - 1);
+        section.miStartEntry = (uint32_t)aSourceImages.size();
+        section.miNumEntries = (uint32_t)aDiffuseTextureNames.size();
+
+        for(uint32_t i = 0; i < (uint32_t)aDiffuseTextureNames.size(); i++)
+        {
+            SourceImage image;
+            image.mFilePath = textureDirectory + "/" + aDiffuseTextureNames[i];
+            image.miSection = (uint32_t)aSections.size();
+            image.miEntry = i;
+            aSourceImages.push_back(image);
+        }
+
+        aSections.push_back(section);
+    }
+
+    // decode
+    for(auto& image : aSourceImages)
+    {
+        int32_t iComp = 0;
+        image.mpImageData = stbi_load(image.mFilePath.c_str(), &image.miWidth, &image.miHeight, &iComp, 4);
+        if(image.mpImageData == nullptr)
+        {
+            DEBUG_PRINTF("!!! Can\'t load \"%s\", leaving an empty entry !!!\n", image.mFilePath.c_str());
+            image.miWidth = image.miHeight = 0;
+        }
+    }
+
+    auto decodeTime = std::chrono::high_resolution_clock::now();
+
+    // pack largest first
+    std::vector<uint32_t> aiPackOrder(aSourceImages.size());
+    for(uint32_t i = 0; i < (uint32_t)aiPackOrder.size(); i++)
+    {
+        aiPackOrder[i] = i;
+    }
+    std::stable_sort(
+        aiPackOrder.begin(),
+        aiPackOrder.end(),
+        [&](uint32_t iLeft, uint32_t iRight)
+        {
+            SourceImage const& left = aSourceImages[iLeft];
+            SourceImage const& right = aSourceImages[iRight];
+            int32_t iLeftMaxSide = std::max(left.miWidth, left.miHeight);
+            int32_t iRightMaxSide = std::max(right.miWidth, right.miHeight);
+            if(iLeftMaxSide != iRightMaxSide)
+            {
+                return iLeftMaxSide > iRightMaxSide;
+            }
+
+            return left.miWidth * left.miHeight > right.miWidth * right.miHeight;
+        }
+    );
+
+    std::vector<Render::TextureAtlasFileEntry> aEntries(aSourceImages.size());
+    CMaxRectsPacker packer;
+    packer.init(iAtlasSize, iAtlasSize);
+    uint64_t iNumUsedTexels = 0;
+    for(uint32_t iImage : aiPackOrder)
+    {
+        SourceImage& image = aSourceImages[iImage];
+
+        Render::TextureAtlasFileEntry& entry = aEntries[iImage];
+        entry = {};
+        entry.miTextureID = image.miEntry;
+        if(image.mpImageData == nullptr)
+        {
+            continue;
+        }
+
+        // padded with clamped edge texels so bilinear taps and downsampled mips don't pull in the neighbours
+        image.miPackedWidth = ((image.miWidth + iPadding * 2 + iAlignment - 1) / iAlignment) * iAlignment;
+        image.miPackedHeight = ((image.miHeight + iPadding * 2 + iAlignment - 1) / iAlignment) * iAlignment;
+
+        CMaxRectsPacker::Rect rect;
+        if(!packer.insert(rect, image.miPackedWidth, image.miPackedHeight))
+        {
+            DEBUG_PRINTF("!!! atlas %d x %d is full, can\'t fit \"%s\" (%d x %d) !!!\n",
+                iAtlasSize,
+                iAtlasSize,
+                image.mFilePath.c_str(),
+                image.miWidth,
+                image.miHeight);
+            return 1;
+        }
+        assert(rect.miX % iAlignment == 0 && rect.miY % iAlignment == 0);
+
+        entry.miX = (uint32_t)(rect.miX + iPadding);
+        entry.miY = (uint32_t)(rect.miY + iPadding);
+        entry.mfU = float(entry.miX) / float(iAtlasSize);
+        entry.mfV = float(entry.miY) / float(iAtlasSize);
+        entry.miImageWidth = (uint32_t)image.miWidth;
+        entry.miImageHeight = (uint32_t)image.miHeight;
+
+        iNumUsedTexels += (uint64_t)image.miWidth * (uint64_t)image.miHeight;
+    }
+
+    auto packTime = std::chrono::high_resolution_clock::now();
+
+    // only the rows up to the lowest placed image are stored, rectangles are aligned so the used height is too
+    uint32_t iUsedHeight = (uint32_t)packer.getUsedHeight();
+    assert(iUsedHeight % (uint32_t)iAlignment == 0);
+
+    std::vector<MipLevel> aMipLevels(1);
+    aMipLevels[0].miWidth = (uint32_t)iAtlasSize;
+    aMipLevels[0].miHeight = iUsedHeight;
+    aMipLevels[0].macData.resize((size_t)iAtlasSize * (size_t)iUsedHeight * 4, 0);
+    uint8_t* pacAtlasImage = aMipLevels[0].macData.data();
+    for(uint32_t i = 0; i < (uint32_t)aSourceImages.size(); i++)
+    {
+        SourceImage& image = aSourceImages[i];
+        if(image.mpImageData == nullptr)
+        {
+            continue;
+        }
+
+        Render::TextureAtlasFileEntry const& entry = aEntries[i];
+        int32_t iRectX = (int32_t)entry.miX - iPadding;
+        int32_t iRectY = (int32_t)entry.miY - iPadding;
+        for(int32_t iY = 0; iY < image.miPackedHeight; iY++)
+        {
+            int32_t iSrcY = std::clamp(iY - iPadding, 0, image.miHeight - 1);
+            uint8_t const* pacSrcRow = image.mpImageData + (size_t)iSrcY * (size_t)image.miWidth * 4;
+            uint8_t* pacDestRow = pacAtlasImage + ((size_t)(iRectY + iY) * (size_t)iAtlasSize + (size_t)iRectX) * 4;
+            for(int32_t iX = 0; iX < image.miPackedWidth; iX++)
+            {
+                int32_t iSrcX = std::clamp(iX - iPadding, 0, image.miWidth - 1);
+                memcpy(pacDestRow + (size_t)iX * 4, pacSrcRow + (size_t)iSrcX * 4, 4);
+            }
+        }
+
+        stbi_image_free(image.mpImageData);
+        image.mpImageData = nullptr;
+    }
+
+    buildMipChain(aMipLevels, iNumMipLevels);
+
+    auto composeTime = std::chrono::high_resolution_clock::now();
+
+    Render::TextureAtlasFileHeader header = {};
+    header.miSignature = TEXTURE_ATLAS_FILE_SIGNATURE;
+    header.miVersion = TEXTURE_ATLAS_FILE_VERSION;
+    header.miAtlasWidth = (uint32_t)iAtlasSize;
+    header.miAtlasHeight = (uint32_t)iAtlasSize;
+    header.miUsedHeight = iUsedHeight;
+    header.miNumSections = (uint32_t)aSections.size();
+    header.miNumEntries = (uint32_t)aEntries.size();
+    header.miNumMipLevels = iNumMipLevels;
+    header.miNumUsedTexels = iNumUsedTexels;
+
+    header.miFormat = Render::TEXTURE_ATLAS_FORMAT_RGBA8;
+    if(!writeAtlasFile(outputFilePath, header, aSections, aEntries, aMipLevels))
+    {
+        return 1;
+    }
+
+    uint64_t iRGBA8Size = 0;
+    for(auto const& mipLevel : aMipLevels)
+    {
+        iRGBA8Size += mipLevel.macData.size();
+    }
+
+    // compressed variant next to the uncompressed one, the renderer picks it when the device has BC support
+    uint64_t iBC7Size = 0;
+    std::string bc7FilePath;
+    auto encodeStartTime = std::chrono::high_resolution_clock::now();
+    if(bBC7)
+    {
+        std::vector<MipLevel> aBC7MipLevels;
+        encodeBC7MipChain(aBC7MipLevels, aMipLevels);
+        for(auto const& mipLevel : aBC7MipLevels)
+        {
+            iBC7Size += mipLevel.macData.size();
+        }
+
+        auto extensionIter = outputFilePath.rfind(".");
+        bc7FilePath = (extensionIter == std::string::npos) ?
+            outputFilePath + "-bc7" :
+            outputFilePath.substr(0, extensionIter) + "-bc7" + outputFilePath.substr(extensionIter);
+
+        header.miFormat = Render::TEXTURE_ATLAS_FORMAT_BC7;
+        if(!writeAtlasFile(bc7FilePath, header, aSections, aEntries, aBC7MipLevels))
+        {
+            return 1;
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    float fOccupancy = (iUsedHeight > 0) ? float(double(iNumUsedTexels) / (double(iAtlasSize) * double(iUsedHeight))) : 0.0f;
+    DEBUG_PRINTF("wrote to %s\n", outputFilePath.c_str());
+    DEBUG_PRINTF("%d textures in %d sections, atlas %d x %d, used height %d, %d mip levels, padding %d, occupancy %.2f%% (%.2f%% of full atlas)\n",
+        (uint32_t)aEntries.size(),
+        (uint32_t)aSections.size(),
+        iAtlasSize,
+        iAtlasSize,
+        iUsedHeight,
+        iNumMipLevels,
+        iPadding,
+        fOccupancy * 100.0f,
+        float(double(iNumUsedTexels) / (double(iAtlasSize) * double(iAtlasSize))) * 100.0f);
+    DEBUG_PRINTF("RGBA8 %.2f MB\n", float(double(iRGBA8Size) / (1024.0 * 1024.0)));
+    if(bBC7)
+    {
+        DEBUG_PRINTF("wrote to %s\n", bc7FilePath.c_str());
+        DEBUG_PRINTF("BC7 %.2f MB (%.2fx smaller), encode %.2f ms\n",
+            float(double(iBC7Size) / (1024.0 * 1024.0)),
+            float(double(iRGBA8Size) / double(std::max(iBC7Size, (uint64_t)1))),
+            float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - encodeStartTime).count()) * 0.001f);
+    }
+    DEBUG_PRINTF("decode %.2f ms, pack %.2f ms, compose and mips %.2f ms, total %.2f ms\n",
+        float(std::chrono::duration_cast<std::chrono::microseconds>(decodeTime - startTime).count()) * 0.001f,
+        float(std::chrono::duration_cast<std::chrono::microseconds>(packTime - decodeTime).count()) * 0.001f,
+        float(std::chrono::duration_cast<std::chrono::microseconds>(composeTime - packTime).count()) * 0.001f,
+        float(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 0.001f);
+
+    return 0;
+}
+
+/*
+**
+*/
+bool readDiffuseTextureNames(
+    std::vector<std::string>& aDiffuseTextureNames,
+    std::string const& textureNameFilePath)
+{
+    FILE* fp = fopen(textureNameFilePath.c_str(), "rb");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    uint64_t iFileSize = (uint64_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    std::vector<char> acFileContent((size_t)iFileSize + 1, 0);
+    fread(acFileContent.data(), sizeof(char), (size_t)iFileSize, fp);
+    fclose(fp);
+
+    uint32_t iDiffuseSignature = ('D') | ('F' << 8) | ('S' << 16) | ('E' << 24);
+
+    // same parsing and extension handling as CRenderer::loadTexturesIntoAtlas
+    char const* pcChar = acFileContent.data();
+    char const* pcEnd = pcChar + iFileSize;
+    for(uint32_t iType = 0; iType < 4; iType++)
+    {
+        if(pcChar + sizeof(uint32_t) * 2 > pcEnd)
+        {
+            break;
+        }
+
+        uint32_t iSignature = 0, iNumTextures = 0;
+        memcpy(&iSignature, pcChar, sizeof(uint32_t));
+        memcpy(&iNumTextures, pcChar + sizeof(uint32_t), sizeof(uint32_t));
+        pcChar += sizeof(uint32_t) * 2;
+
+        for(uint32_t i = 0; i < iNumTextures && pcChar < pcEnd; i++)
+        {
+            std::string convertedName = std::string(pcChar);
+            pcChar += convertedName.length() + 1;
+
+            auto iter = convertedName.find_last_of("/\\");
+            std::string baseName = (iter == std::string::npos) ? convertedName : convertedName.substr(iter + 1);
+            iter = baseName.rfind(".");
+            std::string noExtension = baseName.substr(0, iter);
+            std::string oldFileExtension = (iter == std::string::npos) ? "" : baseName.substr(iter);
+
+            if(oldFileExtension != ".jpeg" && oldFileExtension != ".png" && oldFileExtension != ".jpg")
+            {
+                noExtension += ".png";
+            }
+            else
+            {
+                noExtension += oldFileExtension;
+            }
+
+            if(iSignature == iDiffuseSignature)
+            {
+                aDiffuseTextureNames.push_back(noExtension);
+            }
+        }
+
+        if(pcChar >= pcEnd)
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+/*
+**
+*/
+void buildMipChain(
+    std::vector<MipLevel>& aMipLevels,
+    uint32_t iNumMipLevels)
+{
+    // 2x2 box filter over the whole used region, rectangles are aligned to 1 << (mips - 1) so no footprint straddles two entries
+    for(uint32_t iLevel = 1; iLevel < iNumMipLevels; iLevel++)
+    {
+        MipLevel const& src = aMipLevels[iLevel - 1];
+        MipLevel dest;
+        dest.miWidth = std::max(src.miWidth >> 1, 1u);
+        dest.miHeight = std::max(src.miHeight >> 1, 1u);
+        dest.macData.resize((size_t)dest.miWidth * (size_t)dest.miHeight * 4);
+        for(uint32_t iY = 0; iY < dest.miHeight; iY++)
+        {
+            uint32_t iSrcY0 = std::min(iY * 2, src.miHeight - 1);
+            uint32_t iSrcY1 = std::min(iY * 2 + 1, src.miHeight - 1);
+            for(uint32_t iX = 0; iX < dest.miWidth; iX++)
+            {
+                uint32_t iSrcX0 = std::min(iX * 2, src.miWidth - 1);
+                uint32_t iSrcX1 = std::min(iX * 2 + 1, src.miWidth - 1);
+                for(uint32_t iComp = 0; iComp < 4; iComp++)
+                {
+                    uint32_t iSum =
+                        src.macData[((size_t)iSrcY0 * src.miWidth + iSrcX0) * 4 + iComp] +
+                        src.macData[((size_t)iSrcY0 * src.miWidth + iSrcX1) * 4 + iComp] +
+                        src.macData[((size_t)iSrcY1 * src.miWidth + iSrcX0) * 4 + iComp] +
+                        src.macData[((size_t)iSrcY1 * src.miWidth + iSrcX1) * 4 + iComp];
+                    dest.macData[((size_t)iY * dest.miWidth + iX) * 4 + iComp] = (uint8_t)((iSum + 2) / 4);
+                }
+            }
+        }
+
+        aMipLevels.push_back(std::move(dest));
+    }
+}
+
+/*
+**
+*/
+void encodeBC7MipChain(
+    std::vector<MipLevel>& aBC7MipLevels,
+    std::vector<MipLevel> const& aMipLevels)
+{
+    uint32_t iNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    aBC7MipLevels.resize(aMipLevels.size());
+    for(uint32_t iLevel = 0; iLevel < (uint32_t)aMipLevels.size(); iLevel++)
+    {
+        MipLevel const& src = aMipLevels[iLevel];
+        MipLevel& dest = aBC7MipLevels[iLevel];
+        dest.miWidth = src.miWidth;
+        dest.miHeight = src.miHeight;
+        assert(src.miWidth % 4 == 0 && src.miHeight % 4 == 0);
+
+        // 16 bytes per 4x4 block, bands of block rows are encoded on separate threads
+        uint32_t iNumBlocksX = src.miWidth / 4;
+        uint32_t iNumBlockRows = src.miHeight / 4;
+        dest.macData.resize((size_t)iNumBlocksX * (size_t)iNumBlockRows * 16);
+
+        uint32_t iBlockRowsPerThread = (iNumBlockRows + iNumThreads - 1) / iNumThreads;
+        std::vector<std::thread> aThreads;
+        for(uint32_t iStartRow = 0; iStartRow < iNumBlockRows; iStartRow += iBlockRowsPerThread)
+        {
+            uint32_t iNumRows = std::min(iBlockRowsPerThread, iNumBlockRows - iStartRow);
+            aThreads.emplace_back(
+                BC7::encodeImage,
+                dest.macData.data() + (size_t)iStartRow * iNumBlocksX * 16,
+                src.macData.data() + (size_t)iStartRow * 4 * src.miWidth * 4,
+                src.miWidth,
+                iNumRows * 4,
+                src.miWidth * 4);
+        }
+
+        for(auto& thread : aThreads)
+        {
+            thread.join();
+        }
+    }
+}
+
+/*
+**
+*/
+bool writeAtlasFile(
+    std::string const& filePath,
+    Render::TextureAtlasFileHeader header,
+    std::vector<Render::TextureAtlasFileSection> const& aSections,
+    std::vector<Render::TextureAtlasFileEntry> const& aEntries,
+    std::vector<MipLevel> const& aMipLevels)
+{
+    assert(aMipLevels.size() <= TEXTURE_ATLAS_MAX_MIP_LEVELS);
+
+    uint64_t iDataOffset =
+        sizeof(Render::TextureAtlasFileHeader) +
+        sizeof(Render::TextureAtlasFileSection) * aSections.size() +
+        sizeof(Render::TextureAtlasFileEntry) * aEntries.size();
+    header.miNumMipLevels = (uint32_t)aMipLevels.size();
+    for(uint32_t iLevel = 0; iLevel < (uint32_t)aMipLevels.size(); iLevel++)
+    {
+        header.maMipLevels[iLevel].miDataOffset = iDataOffset;
+        header.maMipLevels[iLevel].miDataSize = aMipLevels[iLevel].macData.size();
+        header.maMipLevels[iLevel].miWidth = aMipLevels[iLevel].miWidth;
+        header.maMipLevels[iLevel].miHeight = aMipLevels[iLevel].miHeight;
+        iDataOffset += aMipLevels[iLevel].macData.size();
+    }
+
+    FILE* fp = fopen(filePath.c_str(), "wb");
+    if(fp == nullptr)
+    {
+        DEBUG_PRINTF("!!! can\'t open \"%s\" for writing !!!\n", filePath.c_str());
+        return false;
+    }
+    fwrite(&header, sizeof(header), 1, fp);
+    fwrite(aSections.data(), sizeof(Render::TextureAtlasFileSection), aSections.size(), fp);
+    fwrite(aEntries.data(), sizeof(Render::TextureAtlasFileEntry), aEntries.size(), fp);
+    for(auto const& mipLevel : aMipLevels)
+    {
+        fwrite(mipLevel.macData.data(), sizeof(uint8_t), mipLevel.macData.size(), fp);
+    }
+    fclose(fp);
+
+    return true;
+}
+
+/*
+**
+*/
+int benchmarkBC7(
+    std::string const& imageFilePath,
+    uint32_t iNumIterations)
+{
+    int32_t iWidth = 0, iHeight = 0, iComp = 0;
+    stbi_uc* pImageData = stbi_load(imageFilePath.c_str(), &iWidth, &iHeight, &iComp, 4);
+    if(pImageData == nullptr)
+    {
+        DEBUG_PRINTF("!!! can\'t load \"%s\" !!!\n", imageFilePath.c_str());
+        return 1;
+    }
+
+    // crop to whole blocks
+    MipLevel image;
+    image.miWidth = (uint32_t)iWidth & ~3u;
+    image.miHeight = (uint32_t)iHeight & ~3u;
+    if(image.miWidth == 0 || image.miHeight == 0)
+    {
+        DEBUG_PRINTF("!!! \"%s\" is smaller than one block !!!\n", imageFilePath.c_str());
+        stbi_image_free(pImageData);
+        return 1;
+    }
+    image.macData.resize((size_t)image.miWidth * (size_t)image.miHeight * 4);
+    for(uint32_t iY = 0; iY < image.miHeight; iY++)
+    {
+        memcpy(
+            image.macData.data() + (size_t)iY * image.miWidth * 4,
+            pImageData + (size_t)iY * (size_t)iWidth * 4,
+            (size_t)image.miWidth * 4);
+    }
+    stbi_image_free(pImageData);
+
+    std::vector<MipLevel> aMipLevels(1);
+    aMipLevels[0] = image;
+
+    std::vector<MipLevel> aBC7MipLevels;
+    double fBestSeconds = 1.0e30;
+    for(uint32_t iIteration = 0; iIteration < iNumIterations; iIteration++)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        encodeBC7MipChain(aBC7MipLevels, aMipLevels);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        fBestSeconds = std::min(fBestSeconds, double(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()) * 1.0e-6);
+    }
+
+    std::vector<uint8_t> acDecoded(image.macData.size());
+    BC7::decodeImage(acDecoded.data(), aBC7MipLevels[0].macData.data(), image.miWidth, image.miHeight);
+
+    // rgb and alpha psnr against the source
+    double afSquaredError[2] = {0.0, 0.0};
+    for(size_t i = 0; i < image.macData.size(); i++)
+    {
+        double fDiff = double(image.macData[i]) - double(acDecoded[i]);
+        afSquaredError[(i % 4 == 3) ? 1 : 0] += fDiff * fDiff;
+    }
+    double fNumTexels = double(image.miWidth) * double(image.miHeight);
+    double fRGBMSE = afSquaredError[0] / (fNumTexels * 3.0);
+    double fAlphaMSE = afSquaredError[1] / fNumTexels;
+    double fRGBPSNR = (fRGBMSE > 0.0) ? 10.0 * log10(255.0 * 255.0 / fRGBMSE) : 99.0;
+    double fAlphaPSNR = (fAlphaMSE > 0.0) ? 10.0 * log10(255.0 * 255.0 / fAlphaMSE) : 99.0;
+
+    DEBUG_PRINTF("%s %d x %d, best of %d: %.2f ms, %.2f Mtexels/s, %.2f MB/s in, %.2f MB out\n",
+        imageFilePath.c_str(),
+        image.miWidth,
+        image.miHeight,
+        iNumIterations,
+        float(fBestSeconds * 1000.0),
+        float(fNumTexels / fBestSeconds * 1.0e-6),
+        float(double(image.macData.size()) / fBestSeconds / (1024.0 * 1024.0)),
+        float(double(aBC7MipLevels[0].macData.size()) / (1024.0 * 1024.0)));
+    DEBUG_PRINTF("psnr rgb %.2f dB, alpha %.2f dB\n", float(fRGBPSNR), float(fAlphaPSNR));
+
+    return 0;
+}